@@ -19,6 +19,7 @@
 #define _ST_HPC_PPL_NN_ENGINES_X86_ENGINE_OPTIONS_H_
 
 #include "ppl/nn/common/common.h"
+#include "ppl/common/types.h"
 #include "ppl/nn/engines/x86/options.h"
 #include <stdint.h>
 
@@ -26,6 +27,13 @@ namespace ppl { namespace nn { namespace x86 {
 
 struct PPLNN_PUBLIC EngineOptions final {
     uint32_t mm_policy = MM_COMPACT;
+    uint32_t dynamic_tuning_level = TUNING_OFF;
+    /**
+       DATATYPE_FLOAT32 or DATATYPE_BFLOAT16. convs and fcs run in bfloat16 with float32 accumulation if
+       DATATYPE_BFLOAT16 is set and avx512 is available. activations stay in bfloat16 between them when only
+       reshape-like ops are in between. other ops always run in float32.
+    */
+    uint32_t forward_precision = ppl::common::DATATYPE_FLOAT32;
 };
 
 }}} // namespace ppl::nn::x86
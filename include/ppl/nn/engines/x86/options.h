@@ -42,6 +42,40 @@ enum {
     */
     ENGINE_CONF_DISABLE_AVX_FMA3 = 1,
 
+    /**
+       @brief exports algorithms selected by timing to `algo_file` after graph optimization. the file can be
+       imported by `ENGINE_CONF_IMPORT_ALGORITHMS` on machines with the same cpu and thread count.
+
+       @note example:
+       @code{.cpp}
+       x86_engine->Configure(ENGINE_CONF_EXPORT_ALGORITHMS, algo_file);
+       @endcode
+    */
+    ENGINE_CONF_EXPORT_ALGORITHMS = 2,
+
+    /**
+       @brief imports algorithms from a file generated by `ENGINE_CONF_EXPORT_ALGORITHMS`. imported results
+       are used even if `dynamic_tuning_level` is `TUNING_OFF`.
+
+       @note example:
+       @code{.cpp}
+       x86_engine->Configure(ENGINE_CONF_IMPORT_ALGORITHMS, algo_file);
+       @endcode
+    */
+    ENGINE_CONF_IMPORT_ALGORITHMS = 3,
+
+    /**
+       @param json_str a json string(const char*) containing quantization information. convs and fcs whose
+       inputs have per-tensor `tensor_max` and `tensor_min` run in int8 unless their `data_type` is set to
+       `FLOAT32`.
+
+       @note example:
+       @code{.cpp}
+       x86_engine->Configure(ENGINE_CONF_SET_QUANT_INFO, json_str);
+       @endcode
+    */
+    ENGINE_CONF_SET_QUANT_INFO = 4,
+
     /** max value */
     ENGINE_CONF_MAX,
 };
@@ -53,13 +87,91 @@ enum {
 
     /** most recently used first, will use more memory */
     MM_MRU = 1,
+
+    /**
+       buffers are planned in a single arena according to the allocations of the first run. following
+       runs do not call any allocator. for runtimes whose input shapes never change.
+    */
+    MM_STATIC_PLAN = 2,
+};
+
+/** @brief dynamic tuning level */
+enum {
+    /** select algorithms by heuristics */
+    TUNING_OFF = 0,
+
+    /**
+       benchmark all supported algorithms of each conv with its input shape during graph optimization and
+       select the fastest one. input shapes should be fixed.
+    */
+    TUNING_SELECT_ALGO = 1,
 };
 
 /** @brief options for x86::DeviceContext::Configure() */
 enum {
-    /** @brief memory defragmentation. make sure that device is not used when performing defragmentations. */
+    /**
+       @brief memory defragmentation. make sure that device is not used when performing defragmentations.
+       unused blocks are released and the shared tmp buffer will be reallocated when it is needed next time.
+       not supported by `MM_STATIC_PLAN`.
+    */
     DEV_CONF_MEM_DEFRAG = 0,
 
+    /**
+       @brief gets statistics of the static memory plan. only valid when `mm_policy` is `MM_STATIC_PLAN`.
+       planned bytes is 0 if the plan is not built yet(before the second run) or abandoned.
+
+       @note example:
+       @code{.cpp}
+       uint64_t planned_bytes, allocated_bytes;
+       float fragmentation_ratio;
+       dev->Configure(DEV_CONF_GET_MEM_PLAN_INFO, &planned_bytes, &fragmentation_ratio, &allocated_bytes);
+       @endcode
+       `fragmentation_ratio` is (planned_bytes - max_live_bytes) / planned_bytes and `allocated_bytes` is
+       the total bytes allocated by this device, including the arena.
+    */
+    DEV_CONF_GET_MEM_PLAN_INFO = 1,
+
+    /**
+       @brief gets bytes reclaimed by the last `DEV_CONF_MEM_DEFRAG`.
+
+       @note example:
+       @code{.cpp}
+       uint64_t reclaimed_bytes;
+       dev->Configure(DEV_CONF_GET_DEFRAG_RECLAIMED_BYTES, &reclaimed_bytes);
+       @endcode
+    */
+    DEV_CONF_GET_DEFRAG_RECLAIMED_BYTES = 2,
+
+    /**
+       @brief sets the max number of OpenMP threads used by the runtime owning this device. 0 means no
+       limitation. threads are divided evenly among kernels running concurrently.
+
+       @note example:
+       @code{.cpp}
+       uint32_t num_threads = 8;
+       dev->Configure(DEV_CONF_SET_OMP_THREADS, num_threads);
+       @endcode
+    */
+    DEV_CONF_SET_OMP_THREADS = 3,
+
+    /**
+       @brief binds OpenMP threads of the runtime owning this device to `cores`. the number of threads is set
+       to `num_cores` unless it is set by `DEV_CONF_SET_OMP_THREADS`. threads are pinned to one core each if
+       kernels run one by one, otherwise they can run on any of `cores`. `num_cores` = 0 disables binding
+       of threads started afterwards. linux only.
+
+       @note example:
+       @code{.cpp}
+       // runtime i runs on cores [8 * i, 8 * (i + 1))
+       int32_t cores[8];
+       for (int32_t c = 0; c < 8; ++c) {
+           cores[c] = 8 * i + c;
+       }
+       dev->Configure(DEV_CONF_SET_CORE_SET, cores, 8u);
+       @endcode
+    */
+    DEV_CONF_SET_CORE_SET = 4,
+
     DEV_CONF_MAX,
 };
 
@@ -31,6 +31,8 @@ struct PPLNN_PUBLIC KernelProfilingInfo final {
     std::string type;
     uint64_t exec_microseconds;
     uint32_t exec_count;
+    /** number of executions in which shape inference is skipped. see `RUNTIME_CONF_SET_RESHAPE_CACHE`. */
+    uint32_t reshape_cache_hit_count;
 };
 
 struct PPLNN_PUBLIC ProfilingStatistics final {
@@ -34,6 +34,56 @@ enum {
     */
     RUNTIME_CONF_SET_KERNEL_PROFILING_FLAG = 0,
 
+    /**
+       @brief args: uint32_t, number of worker threads.
+       kernels whose inputs are ready are dispatched to `n` worker threads so that independent branches of the graph
+       run concurrently. 0 or 1 switches back to the default sequential scheduler.
+       @note all engines used by this runtime must support concurrent execution. cores are shared by kernels
+       running at the same time, e.g. OpenMP threads of the x86 engine are divided evenly.
+    */
+    RUNTIME_CONF_SET_PARALLEL_SCHEDULING = 1,
+
+    /**
+       @brief args: const char* output_name, const char* input_name.
+       binds a graph output to a graph input as a persistent state, e.g. `Y_h` to `initial_h` of a streaming RNN.
+       buffers of the two tensors are swapped on the device at the beginning of the next Run(), so the state never
+       goes through the host between calls. the output still holds the result of the last Run() until then.
+       @note the bound input is managed by the runtime. it only needs to be filled before the first Run() of a
+       stream, or can be cleared by `RUNTIME_CONF_RESET_STATE`.
+    */
+    RUNTIME_CONF_BIND_STATE = 2,
+
+    /**
+       @brief args: const char* input_name, or nullptr for all bound states.
+       fills the bound input with zeros and drops the state produced by the last Run(). usually called when a new
+       stream starts.
+    */
+    RUNTIME_CONF_RESET_STATE = 3,
+
+    /**
+       @brief args: true/false.
+       kernels skip shape inference and restore output shapes of the last Run() if shapes of their inputs(and values
+       of inputs read by shape inference like `shape` of Reshape) are not changed. kernels whose output shapes depend
+       on values of other inputs(NonZero, NonMaxSuppression) are never cached. hit counts can be retrieved from
+       profiling statistics.
+       @note only kernels of engines supporting it(x86 for now) are affected.
+    */
+    RUNTIME_CONF_SET_RESHAPE_CACHE = 4,
+
+    /**
+       @brief args: uint32_t, max number of events to be kept. 0 stops tracing.
+       records a timeline of kernel executions, memory operations of devices, tmp buffer sizes and data conversions
+       in a ring buffer, which is shared by all runtimes. oldest events are dropped when it is full.
+       @note kernel executions are recorded only when `RUNTIME_CONF_SET_KERNEL_PROFILING_FLAG` is enabled.
+    */
+    RUNTIME_CONF_SET_TRACING = 5,
+
+    /**
+       @brief args: const char* filename.
+       saves recorded events in the chrome trace event format, which can be opened by chrome://tracing or perfetto.
+    */
+    RUNTIME_CONF_SAVE_TRACE = 6,
+
     RUNTIME_CONF_MAX,
 };
 
@@ -60,6 +110,13 @@ public:
     */
     virtual Tensor* GetInputTensor(uint32_t idx) const = 0;
 
+    /**
+       @brief get the data format in which kernels consuming input `idx` work, e.g. the blocked format of convolutions.
+       filling the input in this format(by `Tensor::ConvertFromHostImage()` for example) saves a reorder in `Run()`.
+       @return the current data format of the input if its consumers do not agree on one.
+    */
+    virtual ppl::common::dataformat_t GetInputPreferredDataFormat(uint32_t idx) const = 0;
+
     /**
        @brief run the model with given inputs.
        @note input data must be filled via the returned value of `GetInputTensor()`
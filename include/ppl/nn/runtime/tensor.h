@@ -59,6 +59,16 @@ public:
     /** @brief convert tensor's data from `dst` with shape `dst_desc` */
     virtual ppl::common::RetCode ConvertFromHost(const void* src, const TensorShape& src_desc) = 0;
 
+    /**
+       @brief normalize uint8 images in NHWC order from host and convert them to this tensor in one pass:
+       data[n, c, h, w] = (src[n, h, w, c] - mean[c]) * scale[c]
+       @param mean per-channel values to be subtracted. nullptr means zeros.
+       @param scale per-channel factors, usually 1 / std. nullptr means ones.
+       @note this tensor MUST be float32 with dims in NCHW order, and its buffer MUST be allocated. set its data format
+       to the one returned by `Runtime::GetInputPreferredDataFormat()` to save a reorder during `Run()`.
+    */
+    virtual ppl::common::RetCode ConvertFromHostImage(const uint8_t* src, const float* mean, const float* scale) = 0;
+
     /** @brief get context of the underlying `Device` */
     virtual DeviceContext* GetDeviceContext() const = 0;
 
@@ -24,6 +24,8 @@
 namespace ppl { namespace nn { namespace python {
 
 struct PyNdArray final {
+    /** points to memory owned by others if not nullptr, otherwise `data` is used */
+    void* ptr = nullptr;
     std::vector<char> data;
     ppl::common::datatype_t data_type = ppl::common::DATATYPE_UNKNOWN;
     std::vector<int64_t> dims;
@@ -40,7 +40,9 @@ void RegisterTensorShape(pybind11::module* m) {
                  shape.Reshape(dims);
              })
         .def("GetDataType", &TensorShape::GetDataType)
+        .def("SetDataType", &TensorShape::SetDataType)
         .def("GetDataFormat", &TensorShape::GetDataFormat)
+        .def("SetDataFormat", &TensorShape::SetDataFormat)
         .def("IsScalar", &TensorShape::IsScalar);
 }
 
@@ -31,11 +31,34 @@ static RetCode GenericSetOption(Engine* engine, uint32_t option, const pybind11:
     return engine->Configure(option);
 }
 
+static RetCode SetAlgoFile(Engine* engine, uint32_t option, const pybind11::args& args) {
+    if (args.size() != 1) {
+        LOG(ERROR) << "expected for 1 parameter but got [" << args.size() << "].";
+        return RC_INVALID_VALUE;
+    }
+
+    auto fname = args[0].cast<string>();
+    return engine->Configure(option, fname.c_str());
+}
+
+static RetCode SetQuantInfo(Engine* engine, uint32_t option, const pybind11::args& args) {
+    if (args.size() != 1) {
+        LOG(ERROR) << "expected for 1 parameter but got [" << args.size() << "].";
+        return RC_INVALID_VALUE;
+    }
+
+    auto json_str = args[0].cast<string>();
+    return engine->Configure(option, json_str.c_str());
+}
+
 typedef RetCode (*ConfigFunc)(Engine*, uint32_t option, const pybind11::args& args);
 
 static const map<uint32_t, ConfigFunc> g_opt2func = {
     {x86::ENGINE_CONF_DISABLE_AVX512, GenericSetOption},
     {x86::ENGINE_CONF_DISABLE_AVX_FMA3, GenericSetOption},
+    {x86::ENGINE_CONF_EXPORT_ALGORITHMS, SetAlgoFile},
+    {x86::ENGINE_CONF_IMPORT_ALGORITHMS, SetAlgoFile},
+    {x86::ENGINE_CONF_SET_QUANT_INFO, SetQuantInfo},
 };
 
 void RegisterX86Engine(pybind11::module* m) {
@@ -56,6 +79,9 @@ void RegisterX86Engine(pybind11::module* m) {
 
     m->attr("ENGINE_CONF_DISABLE_AVX512") = (uint32_t)x86::ENGINE_CONF_DISABLE_AVX512;
     m->attr("ENGINE_CONF_DISABLE_AVX_FMA3") = (uint32_t)x86::ENGINE_CONF_DISABLE_AVX_FMA3;
+    m->attr("ENGINE_CONF_EXPORT_ALGORITHMS") = (uint32_t)x86::ENGINE_CONF_EXPORT_ALGORITHMS;
+    m->attr("ENGINE_CONF_IMPORT_ALGORITHMS") = (uint32_t)x86::ENGINE_CONF_IMPORT_ALGORITHMS;
+    m->attr("ENGINE_CONF_SET_QUANT_INFO") = (uint32_t)x86::ENGINE_CONF_SET_QUANT_INFO;
 }
 
 }}} // namespace ppl::nn::python
@@ -23,10 +23,16 @@ namespace ppl { namespace nn { namespace python {
 void RegisterX86EngineOptions(pybind11::module* m) {
     pybind11::class_<x86::EngineOptions>(*m, "EngineOptions")
         .def(pybind11::init<>())
-        .def_readwrite("mm_policy", &x86::EngineOptions::mm_policy);
+        .def_readwrite("mm_policy", &x86::EngineOptions::mm_policy)
+        .def_readwrite("dynamic_tuning_level", &x86::EngineOptions::dynamic_tuning_level)
+        .def_readwrite("forward_precision", &x86::EngineOptions::forward_precision);
 
     m->attr("MM_COMPACT") = (uint32_t)x86::MM_COMPACT;
     m->attr("MM_MRU") = (uint32_t)x86::MM_MRU;
+    m->attr("MM_STATIC_PLAN") = (uint32_t)x86::MM_STATIC_PLAN;
+
+    m->attr("TUNING_OFF") = (uint32_t)x86::TUNING_OFF;
+    m->attr("TUNING_SELECT_ALGO") = (uint32_t)x86::TUNING_SELECT_ALGO;
 }
 
 }}} // namespace ppl::nn::python
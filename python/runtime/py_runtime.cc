@@ -33,22 +33,35 @@ void RegisterRuntime(pybind11::module* m) {
              [](const PyRuntime& runtime) -> uint32_t {
                  return runtime.ptr->GetInputCount();
              })
-        .def("GetInputTensor",
-             [](const PyRuntime& runtime, uint32_t idx) -> PyTensor {
-                 return PyTensor(runtime.ptr->GetInputTensor(idx));
-             })
-        .def("Run",
-             [](const PyRuntime& runtime) -> RetCode {
-                 return runtime.ptr->Run();
+        // tensors are owned by the runtime, which is kept alive until the returned tensor is released
+        .def(
+            "GetInputTensor",
+            [](const PyRuntime& runtime, uint32_t idx) -> PyTensor {
+                return PyTensor(runtime.ptr->GetInputTensor(idx));
+            },
+            pybind11::keep_alive<0, 1>())
+        .def("GetInputPreferredDataFormat",
+             [](const PyRuntime& runtime, uint32_t idx) -> dataformat_t {
+                 return runtime.ptr->GetInputPreferredDataFormat(idx);
              })
+        // other python threads can run during inference
+        .def(
+            "Run",
+            [](const PyRuntime& runtime) -> RetCode {
+                return runtime.ptr->Run();
+            },
+            pybind11::call_guard<pybind11::gil_scoped_release>())
         .def("GetOutputCount",
              [](const PyRuntime& runtime) -> uint32_t {
                  return runtime.ptr->GetOutputCount();
              })
-        .def("GetOutputTensor",
-             [](const PyRuntime& runtime, uint32_t idx) -> PyTensor {
-                 return PyTensor(runtime.ptr->GetOutputTensor(idx));
-             })
+        // tensors are owned by the runtime, which is kept alive until the returned tensor is released
+        .def(
+            "GetOutputTensor",
+            [](const PyRuntime& runtime, uint32_t idx) -> PyTensor {
+                return PyTensor(runtime.ptr->GetOutputTensor(idx));
+            },
+            pybind11::keep_alive<0, 1>())
         .def("GetDeviceContextCount",
              [](const PyRuntime& runtime) -> uint32_t {
                  return runtime.ptr->GetDeviceContextCount();
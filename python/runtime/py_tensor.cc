@@ -18,6 +18,8 @@
 #include "py_tensor.h"
 #include "../common/py_device_context.h"
 #include "ppl/nn/common/logger.h"
+#include "pybind11/stl.h"
+#include <cstring> // strcmp
 #include <map>
 using namespace std;
 using namespace ppl::common;
@@ -71,7 +73,10 @@ RetCode PyTensor::ConvertFromHost(const pybind11::buffer& b) {
         return status;
     }
 
-    status = tensor_->ConvertFromHost(info.ptr, src_shape);
+    {
+        pybind11::gil_scoped_release release;
+        status = tensor_->ConvertFromHost(info.ptr, src_shape);
+    }
     if (status != RC_SUCCESS) {
         LOG(ERROR) << "copy data to tensor[" << tensor_->GetName() << "] failed: " << GetRetCodeStr(status);
         return status;
@@ -80,12 +85,48 @@ RetCode PyTensor::ConvertFromHost(const pybind11::buffer& b) {
     return RC_SUCCESS;
 }
 
-PyNdArray PyTensor::ConvertToHost(datatype_t data_type, dataformat_t data_format) const {
-    PyNdArray arr;
-    if (tensor_->GetShape()->GetBytesExcludingPadding() == 0) {
-        return arr;
+RetCode PyTensor::ConvertFromHostImage(const pybind11::buffer& img, const vector<float>& mean,
+                                       const vector<float>& scale) {
+    pybind11::buffer_info info = img.request();
+    if (info.format != "B" || info.ndim != 4) {
+        LOG(ERROR) << "image must be a 4-D uint8 array in NHWC order.";
+        return RC_INVALID_VALUE;
+    }
+
+    const int64_t channels = info.shape[3];
+    if ((!mean.empty() && (int64_t)mean.size() != channels) ||
+        (!scale.empty() && (int64_t)scale.size() != channels)) {
+        LOG(ERROR) << "size of mean[" << mean.size() << "] or scale[" << scale.size()
+                   << "] mismatches channels of image[" << channels << "]";
+        return RC_INVALID_VALUE;
+    }
+
+    auto shape = tensor_->GetShape();
+    shape->Reshape({info.shape[0], channels, info.shape[1], info.shape[2]});
+    shape->SetDataType(DATATYPE_FLOAT32);
+
+    auto status = tensor_->ReallocBuffer();
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "realloc buffer of [" << shape->GetBytesIncludingPadding()
+                   << "] bytes failed when setting data for tensor[" << tensor_->GetName()
+                   << "]: " << GetRetCodeStr(status);
+        return status;
     }
 
+    {
+        pybind11::gil_scoped_release release;
+        status = tensor_->ConvertFromHostImage((const uint8_t*)info.ptr, mean.empty() ? nullptr : mean.data(),
+                                               scale.empty() ? nullptr : scale.data());
+    }
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "copy image to tensor[" << tensor_->GetName() << "] failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    return RC_SUCCESS;
+}
+
+TensorShape PyTensor::GetHostShape(datatype_t data_type, dataformat_t data_format) const {
     TensorShape dst_shape = *tensor_->GetShape();
     if (data_type != DATATYPE_UNKNOWN) {
         dst_shape.SetDataType(data_type);
@@ -93,29 +134,120 @@ PyNdArray PyTensor::ConvertToHost(datatype_t data_type, dataformat_t data_format
     if (data_format != DATAFORMAT_UNKNOWN) {
         dst_shape.SetDataFormat(data_format);
     }
+    return dst_shape;
+}
+
+static void FillNdArrayInfo(const TensorShape& shape, PyNdArray* arr) {
+    arr->data_type = shape.GetDataType();
+
+    auto dim_count = shape.GetRealDimCount();
+
+    arr->dims.resize(dim_count);
+    for (uint32_t i = 0; i < dim_count; ++i) {
+        arr->dims[i] = shape.GetDim(i);
+    }
+
+    arr->strides.resize(dim_count);
+    for (uint32_t i = 1; i < dim_count; ++i) {
+        arr->strides[i - 1] = shape.GetBytesFromDimesionExcludingPadding(i);
+    }
+    arr->strides[dim_count - 1] = GetSizeOfDataType(shape.GetDataType());
+}
+
+PyNdArray PyTensor::ConvertToHost(datatype_t data_type, dataformat_t data_format) const {
+    PyNdArray arr;
+    if (tensor_->GetShape()->GetBytesExcludingPadding() == 0) {
+        return arr;
+    }
+
+    TensorShape dst_shape = GetHostShape(data_type, data_format);
 
-    arr.data.resize(dst_shape.GetBytesExcludingPadding());
-    auto status = tensor_->ConvertToHost(arr.data.data(), dst_shape);
+    RetCode status;
+    {
+        pybind11::gil_scoped_release release;
+        arr.data.resize(dst_shape.GetBytesExcludingPadding());
+        status = tensor_->ConvertToHost(arr.data.data(), dst_shape);
+    }
     if (status != RC_SUCCESS) {
         LOG(ERROR) << "copy data of tensor[" << tensor_->GetName() << "] to host failed: " << GetRetCodeStr(status);
+        arr.data.clear();
         return arr;
     }
 
-    arr.data_type = dst_shape.GetDataType();
+    FillNdArrayInfo(dst_shape, &arr);
+    return arr;
+}
 
-    auto dim_count = dst_shape.GetRealDimCount();
+RetCode PyTensor::ConvertToHostBuffer(const pybind11::buffer& b) const {
+    pybind11::buffer_info info = b.request(true);
 
-    arr.dims.resize(dim_count);
-    for (uint32_t i = 0; i < dim_count; ++i) {
-        arr.dims[i] = dst_shape.GetDim(i);
+    auto ref = g_format2datatype.find(info.format);
+    if (ref == g_format2datatype.end()) {
+        LOG(ERROR) << "unsupported data format[\"" << info.format << "\"]";
+        return RC_UNSUPPORTED;
     }
 
-    arr.strides.resize(dim_count);
-    for (uint32_t i = 1; i < dim_count; ++i) {
-        arr.strides[i - 1] = dst_shape.GetBytesFromDimesionExcludingPadding(i);
+    // only c-contiguous buffers are supported
+    pybind11::ssize_t expected_stride = info.itemsize;
+    for (pybind11::ssize_t i = info.ndim - 1; i >= 0; --i) {
+        if (info.strides[i] != expected_stride) {
+            LOG(ERROR) << "buffer for tensor[" << tensor_->GetName() << "] is not c-contiguous.";
+            return RC_INVALID_VALUE;
+        }
+        expected_stride *= info.shape[i];
     }
-    arr.strides[dim_count - 1] = GetSizeOfDataType(dst_shape.GetDataType());
 
+    TensorShape dst_shape = GetHostShape(ref->second, DATAFORMAT_NDARRAY);
+    const uint64_t bytes = dst_shape.GetBytesExcludingPadding();
+    if ((uint64_t)(info.size * info.itemsize) != bytes) {
+        LOG(ERROR) << "buffer size[" << info.size * info.itemsize << "] mismatches size of tensor["
+                   << tensor_->GetName() << "] which is [" << bytes << "] bytes.";
+        return RC_INVALID_VALUE;
+    }
+    if (bytes == 0) {
+        return RC_SUCCESS;
+    }
+
+    RetCode status;
+    {
+        pybind11::gil_scoped_release release;
+        status = tensor_->ConvertToHost(info.ptr, dst_shape);
+    }
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "copy data of tensor[" << tensor_->GetName() << "] to host failed: " << GetRetCodeStr(status);
+    }
+    return status;
+}
+
+static bool IsHostDevice(const DeviceContext* dev) {
+    static const char* host_types[] = {"x86", "cpu", "arm", "riscv"};
+    if (!dev) {
+        return false;
+    }
+    for (uint32_t i = 0; i < sizeof(host_types) / sizeof(host_types[0]); ++i) {
+        if (strcmp(dev->GetType(), host_types[i]) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+PyNdArray PyTensor::ConvertToHostView(datatype_t data_type, dataformat_t data_format) const {
+    auto shape = tensor_->GetShape();
+    TensorShape dst_shape = GetHostShape(data_type, data_format);
+
+    const bool need_conversion = (dst_shape.GetDataType() != shape->GetDataType() ||
+                                  dst_shape.GetDataFormat() != shape->GetDataFormat() ||
+                                  shape->GetDataFormat() != DATAFORMAT_NDARRAY ||
+                                  shape->GetBytesIncludingPadding() != shape->GetBytesExcludingPadding());
+    if (need_conversion || !IsHostDevice(tensor_->GetDeviceContext()) || !tensor_->GetBufferPtr() ||
+        shape->GetBytesExcludingPadding() == 0) {
+        return ConvertToHost(data_type, data_format);
+    }
+
+    PyNdArray arr;
+    arr.ptr = tensor_->GetBufferPtr();
+    FillNdArrayInfo(dst_shape, &arr);
     return arr;
 }
 
@@ -140,8 +272,21 @@ void RegisterTensor(pybind11::module* m) {
         .def("GetName", &PyTensor::GetName, pybind11::return_value_policy::reference)
         .def("GetShape", &PyTensor::GetConstShape, pybind11::return_value_policy::reference)
         .def("ConvertFromHost", &PyTensor::ConvertFromHost)
+        // set data format to `Runtime.GetInputPreferredDataFormat()` first to save a reorder
+        .def("ConvertFromHostImage", &PyTensor::ConvertFromHostImage, pybind11::arg("img"),
+             pybind11::arg("mean") = std::vector<float>(), pybind11::arg("scale") = std::vector<float>())
         // use original data type and format if `datatype` or `dataformat` are unknown
         .def("ConvertToHost", &PyTensor::ConvertToHost, pybind11::return_value_policy::move,
+             pybind11::arg("datatype") = (ppl::common::datatype_t)ppl::common::DATATYPE_UNKNOWN,
+             pybind11::arg("dataformat") = (ppl::common::dataformat_t)ppl::common::DATAFORMAT_NDARRAY)
+        // writes to a c-contiguous buffer whose size matches the tensor, e.g. a preallocated numpy array
+        .def("ConvertToHostBuffer", &PyTensor::ConvertToHostBuffer)
+        /*
+          aliases the tensor's buffer if no conversion is needed. the returned array keeps the tensor, and thus the
+          runtime, alive, but its contents are overwritten or invalidated by the next `Run()`.
+        */
+        .def("ConvertToHostView", &PyTensor::ConvertToHostView, pybind11::return_value_policy::move,
+             pybind11::keep_alive<0, 1>(),
              pybind11::arg("datatype") = (ppl::common::datatype_t)ppl::common::DATATYPE_UNKNOWN,
              pybind11::arg("dataformat") = (ppl::common::dataformat_t)ppl::common::DATAFORMAT_NDARRAY);
 }
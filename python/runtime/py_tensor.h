@@ -21,6 +21,7 @@
 #include "../common/py_ndarray.h"
 #include "ppl/nn/runtime/tensor.h"
 #include "pybind11/pybind11.h"
+#include <vector>
 
 namespace ppl { namespace nn { namespace python {
 
@@ -39,8 +40,18 @@ public:
         return *tensor_->GetShape();
     }
     ppl::common::RetCode ConvertFromHost(const pybind11::buffer&);
+    /** `img` is an uint8 array in NHWC order. data type of this tensor will be changed to float32. */
+    ppl::common::RetCode ConvertFromHostImage(const pybind11::buffer& img, const std::vector<float>& mean,
+                                              const std::vector<float>& scale);
     /** passing unknown means to use original type and format */
     PyNdArray ConvertToHost(ppl::common::datatype_t, ppl::common::dataformat_t) const;
+    /** converts to ndarray data in `b` whose format decides the data type */
+    ppl::common::RetCode ConvertToHostBuffer(const pybind11::buffer& b) const;
+    /** same as `ConvertToHost()` but aliases the underlying buffer if it can be read by host without conversion */
+    PyNdArray ConvertToHostView(ppl::common::datatype_t, ppl::common::dataformat_t) const;
+
+private:
+    TensorShape GetHostShape(ppl::common::datatype_t, ppl::common::dataformat_t) const;
 
 private:
     Tensor* tensor_;
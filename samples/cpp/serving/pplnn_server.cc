@@ -0,0 +1,625 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+/*
+  pplnn_server loads a model once, creates `--runtime-num` runtimes sharing constants and serves requests
+  from an in-process queue. requests are batched along dim 0 dynamically: a runtime takes the first pending
+  request and waits at most `--max-delay-us` for more requests until `--max-batch` samples are collected.
+
+  requests are generated by a built-in load generator, either in a closed loop(`--clients` clients, each of
+  which sends the next request after the previous one is finished) or in an open loop(`--qps` > 0).
+  latency percentiles and throughput are reported at the end.
+*/
+
+#include "ppl/nn/models/onnx/runtime_builder_factory.h"
+#include "ppl/nn/engines/x86/engine_factory.h"
+#include "ppl/nn/engines/x86/options.h"
+#include "ppl/nn/engines/x86/ops.h"
+#include "ppl/nn/common/logger.h"
+#include "ppl/nn/utils/commit.h"
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <memory>
+#include <random>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <future>
+#include <atomic>
+#include <algorithm>
+#include <condition_variable>
+using namespace ppl::nn;
+using namespace ppl::common;
+using namespace std;
+
+/* -------------------------------------------------------------------------- */
+
+#include "simple_flags.h"
+
+Define_bool_opt("--help", g_flag_help, false, "show these help information");
+Define_bool_opt("--version", g_flag_version, false, "show version info");
+
+Define_string_opt("--onnx-model", g_flag_onnx_model, "", "onnx model file");
+Define_string_opt("--in-shapes", g_flag_input_shapes, "",
+                  "shapes of input tensors of one request. dim 0 is the batch size of a request."
+                  " dims are separated by underline, inputs are separated by comma. example:"
+                  " 1_3_224_224,1_10");
+
+Define_string_opt("--mm-policy", g_flag_mm_policy, "mem",
+                  "\"perf\" => better performance, or \"mem\" => less memory usage");
+Define_bool_opt("--disable-avx512", g_flag_disable_avx512, false, "disable avx512 feature");
+Define_uint32_opt("--omp-threads-per-runtime", g_flag_omp_threads_per_runtime, 0,
+                  "max OpenMP threads used by each runtime. 0 means no limitation");
+Define_uint32_opt("--cores-per-runtime", g_flag_cores_per_runtime, 0,
+                  "bind runtime i to cores [k * i, k * (i + 1)) if k > 0. linux only");
+
+Define_uint32_opt("--runtime-num", g_flag_runtime_num, 1, "number of runtimes serving requests concurrently");
+Define_uint32_opt("--max-batch", g_flag_max_batch, 8, "max number of samples in one batch");
+Define_uint32_opt("--max-delay-us", g_flag_max_delay_us, 1000,
+                  "max time in microseconds a request waits for other requests to form a batch");
+
+Define_uint32_opt("--requests", g_flag_requests, 1000, "number of requests to send");
+Define_uint32_opt("--clients", g_flag_clients, 8, "number of clients in closed loop mode");
+Define_uint32_opt("--qps", g_flag_qps, 0, "send requests in a fixed rate(open loop) if it is greater than 0");
+Define_uint32_opt("--warmup-iterations", g_flag_warmup_iterations, 1, "warmup iterations of each runtime");
+
+/* -------------------------------------------------------------------------- */
+
+typedef chrono::steady_clock Clock;
+
+struct Request final {
+    /** input data in ndarray. dim 0 of each input is `batch`. */
+    const vector<string>* inputs = nullptr;
+    int64_t batch = 1;
+    Clock::time_point enqueue_ts;
+    Clock::time_point finish_ts;
+    /** output data in ndarray */
+    vector<string> outputs;
+    promise<RetCode> done;
+};
+
+class RequestQueue final {
+public:
+    void Push(Request* req) {
+        {
+            lock_guard<mutex> lck(mtx_);
+            req->enqueue_ts = Clock::now();
+            requests_.push_back(req);
+        }
+        cond_.notify_one();
+    }
+
+    /**
+       @brief pops requests with at most `max_batch` samples in total. waits for more requests until
+       `max_delay_us` microseconds passed since the first request was pushed.
+       @return false if the queue is closed and empty.
+    */
+    bool PopBatch(int64_t max_batch, uint32_t max_delay_us, vector<Request*>* batch) {
+        batch->clear();
+
+        unique_lock<mutex> lck(mtx_);
+        cond_.wait(lck, [this]() -> bool {
+            return (closed_ || !requests_.empty());
+        });
+        if (requests_.empty()) {
+            return false;
+        }
+
+        auto deadline = requests_.front()->enqueue_ts + chrono::microseconds(max_delay_us);
+        int64_t total = 0;
+        while (true) {
+            while (!requests_.empty() && (batch->empty() || total + requests_.front()->batch <= max_batch)) {
+                total += requests_.front()->batch;
+                batch->push_back(requests_.front());
+                requests_.pop_front();
+            }
+            // stops if the batch is full or the next request cannot be put into this batch
+            if (total >= max_batch || closed_ || !requests_.empty()) {
+                break;
+            }
+            bool has_more = cond_.wait_until(lck, deadline, [this]() -> bool {
+                return (closed_ || !requests_.empty());
+            });
+            if (!has_more) {
+                break;
+            }
+        }
+
+        // wakes up other runtimes if there are still pending requests
+        if (!requests_.empty()) {
+            cond_.notify_one();
+        }
+        return true;
+    }
+
+    void Close() {
+        {
+            lock_guard<mutex> lck(mtx_);
+            closed_ = true;
+        }
+        cond_.notify_all();
+    }
+
+private:
+    bool closed_ = false;
+    deque<Request*> requests_;
+    mutex mtx_;
+    condition_variable cond_;
+};
+
+/* -------------------------------------------------------------------------- */
+
+static void SplitString(const string& str, char delim, vector<string>* res) {
+    string::size_type begin = 0;
+    while (begin <= str.size()) {
+        auto end = str.find(delim, begin);
+        if (end == string::npos) {
+            end = str.size();
+        }
+        res->push_back(str.substr(begin, end - begin));
+        begin = end + 1;
+    }
+}
+
+static bool ParseInputShapes(const string& shape_str, vector<vector<int64_t>>* input_shapes) {
+    vector<string> shape_list;
+    SplitString(shape_str, ',', &shape_list);
+    for (auto x = shape_list.begin(); x != shape_list.end(); ++x) {
+        vector<string> dim_list;
+        SplitString(*x, '_', &dim_list);
+
+        vector<int64_t> shape;
+        for (auto d = dim_list.begin(); d != dim_list.end(); ++d) {
+            if (d->empty()) {
+                LOG(ERROR) << "illegal shape[" << *x << "] in option '--in-shapes'";
+                return false;
+            }
+            shape.push_back(atol(d->c_str()));
+        }
+        input_shapes->push_back(shape);
+    }
+    return true;
+}
+
+// generates random input data of one request
+static bool GenerateRequestInputs(Runtime* runtime, const vector<vector<int64_t>>& input_shapes,
+                                  vector<TensorShape>* sample_shapes, vector<string>* inputs) {
+    std::default_random_engine eng;
+    std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
+
+    for (uint32_t i = 0; i < runtime->GetInputCount(); ++i) {
+        auto t = runtime->GetInputTensor(i);
+        TensorShape shape = *t->GetShape();
+        shape.SetDataFormat(DATAFORMAT_NDARRAY);
+        if (!input_shapes.empty()) {
+            shape.Reshape(input_shapes[i]);
+        } else if (shape.GetDimCount() > 0) {
+            shape.SetDim(0, 1);
+        }
+
+        if (shape.GetDimCount() == 0) {
+            LOG(ERROR) << "input[" << t->GetName() << "] has no batch dim.";
+            return false;
+        }
+        for (uint32_t j = 0; j < shape.GetDimCount(); ++j) {
+            if (shape.GetDim(j) <= 0) {
+                LOG(ERROR) << "shape of input[" << t->GetName() << "] is not fixed. use `--in-shapes` to specify it.";
+                return false;
+            }
+        }
+
+        string data(shape.GetBytesExcludingPadding(), '\0');
+        if (shape.GetDataType() == DATATYPE_FLOAT32) {
+            auto ptr = (float*)data.data();
+            for (uint64_t j = 0; j < shape.GetElementsExcludingPadding(); ++j) {
+                ptr[j] = dis(eng);
+            }
+        }
+
+        sample_shapes->push_back(shape);
+        inputs->push_back(std::move(data));
+    }
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+struct WorkerStat final {
+    uint64_t run_count = 0;
+    uint64_t sample_count = 0;
+    double run_ms = 0.0;
+};
+
+class Worker final {
+public:
+    Worker(Runtime* runtime, const vector<TensorShape>* sample_shapes)
+        : runtime_(runtime), sample_shapes_(sample_shapes) {}
+
+    /** @brief runs `reqs` in one batch and sets their outputs */
+    RetCode RunBatch(const vector<Request*>& reqs) {
+        int64_t total = 0;
+        for (auto r = reqs.begin(); r != reqs.end(); ++r) {
+            total += (*r)->batch;
+        }
+
+        for (uint32_t i = 0; i < runtime_->GetInputCount(); ++i) {
+            auto t = runtime_->GetInputTensor(i);
+            TensorShape src_desc = sample_shapes_->at(i);
+            const uint64_t bytes_per_sample = src_desc.GetBytesExcludingPadding() / src_desc.GetDim(0);
+            src_desc.SetDim(0, total);
+
+            buffer_.resize(src_desc.GetBytesExcludingPadding());
+            char* cursor = (char*)buffer_.data();
+            for (auto r = reqs.begin(); r != reqs.end(); ++r) {
+                auto& data = (*r)->inputs->at(i);
+                memcpy(cursor, data.data(), (*r)->batch * bytes_per_sample);
+                cursor += (*r)->batch * bytes_per_sample;
+            }
+
+            t->GetShape()->Reshape(src_desc.GetDims(), src_desc.GetDimCount());
+            auto status = t->ReallocBuffer();
+            if (status != RC_SUCCESS) {
+                LOG(ERROR) << "ReallocBuffer for tensor[" << t->GetName() << "] failed: " << GetRetCodeStr(status);
+                return status;
+            }
+            status = t->ConvertFromHost(buffer_.data(), src_desc);
+            if (status != RC_SUCCESS) {
+                LOG(ERROR) << "set tensor[" << t->GetName() << "] content failed: " << GetRetCodeStr(status);
+                return status;
+            }
+        }
+
+        auto begin_ts = Clock::now();
+        auto status = runtime_->Run();
+        auto end_ts = Clock::now();
+        if (status != RC_SUCCESS) {
+            LOG(ERROR) << "Run() failed: " << GetRetCodeStr(status);
+            return status;
+        }
+
+        stat_.run_count += 1;
+        stat_.sample_count += total;
+        stat_.run_ms += chrono::duration_cast<chrono::microseconds>(end_ts - begin_ts).count() / 1000.0;
+
+        for (auto r = reqs.begin(); r != reqs.end(); ++r) {
+            (*r)->outputs.resize(runtime_->GetOutputCount());
+        }
+
+        for (uint32_t i = 0; i < runtime_->GetOutputCount(); ++i) {
+            auto t = runtime_->GetOutputTensor(i);
+            TensorShape dst_desc = *t->GetShape();
+            dst_desc.SetDataFormat(DATAFORMAT_NDARRAY);
+            if (dst_desc.GetDimCount() == 0 || dst_desc.GetDim(0) != total) {
+                LOG(ERROR) << "dim 0 of output[" << t->GetName() << "] is not the batch size[" << total << "]";
+                return RC_INVALID_VALUE;
+            }
+
+            buffer_.resize(dst_desc.GetBytesExcludingPadding());
+            status = t->ConvertToHost((void*)buffer_.data(), dst_desc);
+            if (status != RC_SUCCESS) {
+                LOG(ERROR) << "convert data of tensor[" << t->GetName() << "] failed: " << GetRetCodeStr(status);
+                return status;
+            }
+
+            const uint64_t bytes_per_sample = buffer_.size() / total;
+            const char* cursor = buffer_.data();
+            for (auto r = reqs.begin(); r != reqs.end(); ++r) {
+                (*r)->outputs[i].assign(cursor, (*r)->batch * bytes_per_sample);
+                cursor += (*r)->batch * bytes_per_sample;
+            }
+        }
+
+        return RC_SUCCESS;
+    }
+
+    void Serve(RequestQueue* queue) {
+        vector<Request*> reqs;
+        while (queue->PopBatch(g_flag_max_batch, g_flag_max_delay_us, &reqs)) {
+            auto status = RunBatch(reqs);
+            auto finish_ts = Clock::now();
+            for (auto r = reqs.begin(); r != reqs.end(); ++r) {
+                (*r)->finish_ts = finish_ts;
+                (*r)->done.set_value(status);
+            }
+        }
+    }
+
+    const WorkerStat& GetStat() const {
+        return stat_;
+    }
+    void ClearStat() {
+        stat_ = WorkerStat();
+    }
+
+private:
+    Runtime* runtime_;
+    const vector<TensorShape>* sample_shapes_;
+    string buffer_;
+    WorkerStat stat_;
+};
+
+/* -------------------------------------------------------------------------- */
+
+static Engine* CreateX86Engine() {
+    x86::EngineOptions options;
+    if (g_flag_mm_policy == "perf") {
+        options.mm_policy = x86::MM_MRU;
+    } else if (g_flag_mm_policy == "mem") {
+        options.mm_policy = x86::MM_COMPACT;
+    }
+
+    x86::RegisterBuiltinOpImpls();
+    auto x86_engine = x86::EngineFactory::Create(options);
+    if (x86_engine && g_flag_disable_avx512) {
+        x86_engine->Configure(x86::ENGINE_CONF_DISABLE_AVX512);
+    }
+    return x86_engine;
+}
+
+// limits threads of runtime `idx` so that runtimes do not oversubscribe cores
+static bool ConfigureThreads(Runtime* runtime, uint32_t idx) {
+    vector<int32_t> cores(g_flag_cores_per_runtime);
+    for (uint32_t i = 0; i < g_flag_cores_per_runtime; ++i) {
+        cores[i] = g_flag_cores_per_runtime * idx + i;
+    }
+
+    for (uint32_t i = 0; i < runtime->GetDeviceContextCount(); ++i) {
+        auto dev = runtime->GetDeviceContext(i);
+        if (string(dev->GetType()) != "x86") {
+            continue;
+        }
+        if (g_flag_omp_threads_per_runtime > 0) {
+            auto status = dev->Configure(x86::DEV_CONF_SET_OMP_THREADS, g_flag_omp_threads_per_runtime);
+            if (status != RC_SUCCESS) {
+                LOG(ERROR) << "set omp threads of runtime[" << idx << "] failed: " << GetRetCodeStr(status);
+                return false;
+            }
+        }
+        if (!cores.empty()) {
+            auto status = dev->Configure(x86::DEV_CONF_SET_CORE_SET, cores.data(), (uint32_t)cores.size());
+            if (status != RC_SUCCESS) {
+                LOG(ERROR) << "set core set of runtime[" << idx << "] failed: " << GetRetCodeStr(status);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static double Percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    auto idx = (uint64_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[idx];
+}
+
+int main(int argc, char* argv[]) {
+    simple_flags::parse_args(argc, argv);
+    if (!simple_flags::get_unknown_flags().empty()) {
+        string content;
+        for (auto it : simple_flags::get_unknown_flags()) {
+            content += "'" + it + "', ";
+        }
+        content.resize(content.size() - 2); // remove last ', '
+        content.append(".");
+        LOG(ERROR) << "unknown option(s): " << content.c_str();
+        return -1;
+    }
+
+    if (g_flag_help) {
+        simple_flags::print_args_info();
+        return 0;
+    }
+    fprintf(stdout, "ppl.nn version: [%d.%d.%d], commit: [%s]\n", PPLNN_VERSION_MAJOR, PPLNN_VERSION_MINOR,
+            PPLNN_VERSION_PATCH, GetCommitString());
+    if (g_flag_version) {
+        return 0;
+    }
+
+    if (g_flag_onnx_model.empty()) {
+        LOG(ERROR) << "`--onnx-model` is required.";
+        return -1;
+    }
+    if (g_flag_runtime_num == 0 || g_flag_max_batch == 0 || g_flag_requests == 0) {
+        LOG(ERROR) << "`--runtime-num`, `--max-batch` and `--requests` should be greater than 0.";
+        return -1;
+    }
+
+    unique_ptr<Engine> engine(CreateX86Engine());
+    if (!engine) {
+        LOG(ERROR) << "create x86 engine failed.";
+        return -1;
+    }
+
+    auto builder = unique_ptr<onnx::RuntimeBuilder>(onnx::RuntimeBuilderFactory::Create());
+    if (!builder) {
+        LOG(ERROR) << "create RuntimeBuilder failed.";
+        return -1;
+    }
+
+    Engine* engine_ptrs[] = {engine.get()};
+    auto status = builder->Init(g_flag_onnx_model.c_str(), engine_ptrs, 1);
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "init OnnxRuntimeBuilder failed: " << GetRetCodeStr(status);
+        return -1;
+    }
+    status = builder->Preprocess();
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "onnx preprocess failed: " << GetRetCodeStr(status);
+        return -1;
+    }
+
+    // constants are shared by all runtimes created by the same builder
+    vector<unique_ptr<Runtime>> runtimes(g_flag_runtime_num);
+    for (uint32_t i = 0; i < g_flag_runtime_num; ++i) {
+        runtimes[i].reset(builder->CreateRuntime());
+        if (!runtimes[i]) {
+            LOG(ERROR) << "create runtime[" << i << "] failed.";
+            return -1;
+        }
+        if (!ConfigureThreads(runtimes[i].get(), i)) {
+            return -1;
+        }
+    }
+
+    vector<vector<int64_t>> input_shapes;
+    if (!g_flag_input_shapes.empty()) {
+        if (!ParseInputShapes(g_flag_input_shapes, &input_shapes)) {
+            return -1;
+        }
+        if (input_shapes.size() != runtimes[0]->GetInputCount()) {
+            LOG(ERROR) << "the number of input shapes [" << input_shapes.size() << "] != required input count ["
+                       << runtimes[0]->GetInputCount() << "]";
+            return -1;
+        }
+    }
+
+    vector<TensorShape> sample_shapes;
+    vector<string> request_inputs;
+    if (!GenerateRequestInputs(runtimes[0].get(), input_shapes, &sample_shapes, &request_inputs)) {
+        return -1;
+    }
+    const int64_t request_batch = sample_shapes[0].GetDim(0);
+    for (auto s = sample_shapes.begin(); s != sample_shapes.end(); ++s) {
+        if (s->GetDim(0) != request_batch) {
+            LOG(ERROR) << "dim 0 of all inputs should be the same.";
+            return -1;
+        }
+    }
+
+    vector<unique_ptr<Worker>> workers(g_flag_runtime_num);
+    for (uint32_t i = 0; i < g_flag_runtime_num; ++i) {
+        workers[i].reset(new Worker(runtimes[i].get(), &sample_shapes));
+    }
+
+    LOG(INFO) << "runtimes: " << g_flag_runtime_num << ", max batch: " << g_flag_max_batch
+              << ", max delay: " << g_flag_max_delay_us << " us, request batch: " << request_batch;
+
+    // warmup with full batches
+    const uint32_t warmup_requests = std::max<int64_t>(1, g_flag_max_batch / request_batch);
+    for (uint32_t i = 0; i < g_flag_runtime_num; ++i) {
+        vector<Request> reqs(warmup_requests);
+        vector<Request*> req_ptrs;
+        for (auto r = reqs.begin(); r != reqs.end(); ++r) {
+            r->inputs = &request_inputs;
+            r->batch = request_batch;
+            req_ptrs.push_back(&(*r));
+        }
+        for (uint32_t j = 0; j < g_flag_warmup_iterations; ++j) {
+            status = workers[i]->RunBatch(req_ptrs);
+            if (status != RC_SUCCESS) {
+                LOG(ERROR) << "warmup failed: " << GetRetCodeStr(status);
+                return -1;
+            }
+        }
+        workers[i]->ClearStat();
+    }
+
+    RequestQueue queue;
+    vector<thread> serving_threads;
+    for (uint32_t i = 0; i < g_flag_runtime_num; ++i) {
+        serving_threads.emplace_back(&Worker::Serve, workers[i].get(), &queue);
+    }
+
+    vector<Request> requests(g_flag_requests);
+    for (auto r = requests.begin(); r != requests.end(); ++r) {
+        r->inputs = &request_inputs;
+        r->batch = request_batch;
+    }
+
+    auto begin_ts = Clock::now();
+    atomic<uint32_t> failed_count(0);
+    if (g_flag_qps > 0) {
+        vector<future<RetCode>> results;
+        results.reserve(requests.size());
+        const auto interval = chrono::nanoseconds(1000000000ULL / g_flag_qps);
+        for (uint32_t i = 0; i < requests.size(); ++i) {
+            this_thread::sleep_until(begin_ts + interval * i);
+            results.push_back(requests[i].done.get_future());
+            queue.Push(&requests[i]);
+        }
+        for (auto r = results.begin(); r != results.end(); ++r) {
+            if (r->get() != RC_SUCCESS) {
+                ++failed_count;
+            }
+        }
+    } else {
+        atomic<uint32_t> next_request(0);
+        vector<thread> clients;
+        for (uint32_t i = 0; i < std::max(1u, g_flag_clients); ++i) {
+            clients.emplace_back([&requests, &queue, &next_request, &failed_count]() -> void {
+                while (true) {
+                    auto idx = next_request.fetch_add(1);
+                    if (idx >= requests.size()) {
+                        break;
+                    }
+                    auto result = requests[idx].done.get_future();
+                    queue.Push(&requests[idx]);
+                    if (result.get() != RC_SUCCESS) {
+                        ++failed_count;
+                    }
+                }
+            });
+        }
+        for (auto c = clients.begin(); c != clients.end(); ++c) {
+            c->join();
+        }
+    }
+    auto end_ts = Clock::now();
+
+    queue.Close();
+    for (auto t = serving_threads.begin(); t != serving_threads.end(); ++t) {
+        t->join();
+    }
+
+    vector<double> latencies;
+    latencies.reserve(requests.size());
+    for (auto r = requests.begin(); r != requests.end(); ++r) {
+        latencies.push_back(chrono::duration_cast<chrono::microseconds>(r->finish_ts - r->enqueue_ts).count() /
+                            1000.0);
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    WorkerStat total_stat;
+    for (auto w = workers.begin(); w != workers.end(); ++w) {
+        auto& stat = (*w)->GetStat();
+        total_stat.run_count += stat.run_count;
+        total_stat.sample_count += stat.sample_count;
+        total_stat.run_ms += stat.run_ms;
+    }
+
+    const double duration_s = chrono::duration_cast<chrono::microseconds>(end_ts - begin_ts).count() / 1000000.0;
+    LOG(INFO) << "requests: " << requests.size() << ", failed: " << failed_count.load()
+              << ", duration: " << duration_s << " s";
+    LOG(INFO) << "throughput: " << requests.size() / duration_s << " requests/s, "
+              << total_stat.sample_count / duration_s << " samples/s";
+    LOG(INFO) << "latency(ms): p50 " << Percentile(latencies, 0.5) << ", p90 " << Percentile(latencies, 0.9)
+              << ", p99 " << Percentile(latencies, 0.99) << ", max " << latencies.back();
+    if (total_stat.run_count > 0) {
+        LOG(INFO) << "runs: " << total_stat.run_count << ", avg batch: "
+                  << (double)total_stat.sample_count / total_stat.run_count
+                  << ", avg run cost: " << total_stat.run_ms / total_stat.run_count << " ms";
+    }
+
+    return (failed_count.load() == 0) ? 0 : -1;
+}
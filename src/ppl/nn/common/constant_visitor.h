@@ -31,6 +31,14 @@ public:
     virtual uint64_t CalcTotalBytes(uint64_t alignment = 0) const = 0;
     virtual ppl::common::RetCode ForEach(const std::function<ppl::common::RetCode(const ir::Edge*, const void*, uint64_t,
                                                                                   const TensorShape&)>&) const = 0;
+
+    /**
+       @brief whether data passed to callbacks of `ForEach()` is read-only and stays valid until the
+       runtime graph is destroyed, which means it can be referred to directly instead of being copied.
+    */
+    virtual bool IsDataPersistent() const {
+        return false;
+    }
 };
 
 }} // namespace ppl::nn
@@ -0,0 +1,64 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "ppl/nn/common/data_converter.h"
+#include "ppl/nn/common/logger.h"
+#include <vector>
+using namespace std;
+using namespace ppl::common;
+
+namespace ppl { namespace nn {
+
+RetCode DataConverter::ConvertFromHostImage(BufferDesc* dst, const TensorShape& dst_desc, const uint8_t* src,
+                                            const float* mean, const float* scale) const {
+    if (dst_desc.GetDataType() != DATATYPE_FLOAT32) {
+        LOG(ERROR) << "unsupported data type[" << GetDataTypeStr(dst_desc.GetDataType()) << "] of image.";
+        return RC_UNSUPPORTED;
+    }
+    if (dst_desc.GetDimCount() < 2) {
+        LOG(ERROR) << "image must have at least 2 dims, but got [" << dst_desc.GetDimCount() << "].";
+        return RC_INVALID_VALUE;
+    }
+
+    const int64_t batch = dst_desc.GetDim(0);
+    const int64_t channels = dst_desc.GetDim(1);
+    const uint64_t elem_count = dst_desc.GetElementsExcludingPadding();
+    if (elem_count == 0) {
+        return RC_SUCCESS;
+    }
+    const int64_t X = elem_count / batch / channels;
+
+    vector<float> tmp(elem_count);
+    for (int64_t b = 0; b < batch; ++b) {
+        for (int64_t c = 0; c < channels; ++c) {
+            const float m = mean ? mean[c] : 0.0f;
+            const float s = scale ? scale[c] : 1.0f;
+            const uint8_t* lsrc = src + b * X * channels + c;
+            float* ldst = tmp.data() + (b * channels + c) * X;
+            for (int64_t x = 0; x < X; ++x) {
+                ldst[x] = ((float)lsrc[x * channels] - m) * s;
+            }
+        }
+    }
+
+    TensorShape src_desc(dst_desc);
+    src_desc.SetDataFormat(DATAFORMAT_NDARRAY);
+    return ConvertFromHost(dst, dst_desc, tmp.data(), src_desc);
+}
+
+}} // namespace ppl::nn
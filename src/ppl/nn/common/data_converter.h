@@ -57,6 +57,19 @@ public:
     */
     virtual ppl::common::RetCode Convert(BufferDesc* dst, const TensorShape& dst_desc, const BufferDesc& src,
                                          const TensorShape& src_desc) const = 0;
+
+    /**
+       @brief normalize uint8 channel-last images from `src` and convert them to `dst` described by `dst_desc` in one
+       pass: dst[n, c, ...] = (src[n, ..., c] - mean[c]) * scale[c]
+       @param dst points to data area of a device
+       @param dst_desc shape of `dst`. dims are in NCHW order and data type MUST be float32.
+       @param src points to cpu memory in NHWC order
+       @param mean per-channel values to be subtracted. nullptr means zeros.
+       @param scale per-channel factors, usually 1 / std. nullptr means ones.
+       @note the default implementation normalizes `src` into a temporary fp32 ndarray and calls `ConvertFromHost()`.
+    */
+    virtual ppl::common::RetCode ConvertFromHostImage(BufferDesc* dst, const TensorShape& dst_desc, const uint8_t* src,
+                                                      const float* mean, const float* scale) const;
 };
 
 }} // namespace ppl::nn
@@ -43,6 +43,10 @@ public:
         auto diff = std::chrono::duration_cast<std::chrono::microseconds>(end_ts_ - begin_ts_);
         return diff.count();
     }
+    uint64_t GetExecutionBeginTime() const override final {
+        auto ts = std::chrono::duration_cast<std::chrono::microseconds>(begin_ts_.time_since_epoch());
+        return ts.count();
+    }
 
 private:
     std::chrono::time_point<std::chrono::system_clock> begin_ts_;
@@ -15,11 +15,12 @@
 // specific language governing permissions and limitations
 // under the License.
 
-#include "ppl/nn/common/tensor_buffer_info.h"
+#include "ppl/nn/common/buffer_info.h"
 #include "ppl/nn/runtime/runtime_impl.h"
 #include "ppl/nn/engines/common/onnx/loop_kernel.h"
 #include "ppl/nn/engines/utils.h"
 #include "ppl/nn/utils/generic_cpu_device.h"
+#include "ppl/nn/utils/destructor.h"
 #include "ppl/nn/common/logger.h"
 using namespace std;
 using namespace ppl::common;
@@ -30,8 +31,7 @@ template <typename T>
 void DummyDeleter(T*) {}
 
 RetCode LoopKernel::SetExecutionInfo(const shared_ptr<ir::GraphTopo>& topo, const RuntimeGraphInfo* info,
-                                     const RuntimeAuxInfo* aux_info, const RuntimeInitInfo* init_info,
-                                     LoopConcatOutputFunc func) {
+                                     const RuntimeAuxInfo* aux_info, const RuntimeInitInfo* init_info) {
     auto status =
         subgraph_.Init(topo, shared_ptr<const RuntimeGraphInfo>(info, DummyDeleter<const RuntimeGraphInfo>),
                        shared_ptr<const RuntimeAuxInfo>(aux_info, DummyDeleter<const RuntimeAuxInfo>), *init_info);
@@ -40,7 +40,6 @@ RetCode LoopKernel::SetExecutionInfo(const shared_ptr<ir::GraphTopo>& topo, cons
         return status;
     }
 
-    concat_output_func_ = func;
     return RC_SUCCESS;
 }
 
@@ -66,54 +65,181 @@ static inline RetCode GetKeepGoing(const KernelExecContext& ctx, bool* keep_goin
     return RC_SUCCESS;
 }
 
+/*
+  scan outputs of all iterations are written into one buffer which grows geometrically, so that the number of
+  allocations is O(log(iterations)) and the buffer can be handed over to the loop's output directly. from the second
+  iteration on, the subgraph's scan output is bound to its slot in the buffer before Run(), so that its producer writes
+  there directly and data is only copied when the buffer grows.
+*/
+struct ScanOutputInfo final {
+    BufferInfo buffer;
+    TensorShape iter_shape; // shape of each iteration's output
+    uint64_t iter_bytes = 0;
+    uint64_t count = 0; // number of iterations stored in `buffer`
+    uint64_t capacity = 0;
+    TensorImpl* bound_tensor = nullptr; // subgraph output bound to a slot of `buffer`
+    void* bound_addr = nullptr; // slot bound before the current Run()
+};
+
 struct LoopInfo final {
     LoopInfo(const KernelExecContext& ctx) {
         loop_carried_dep_num = ctx.GetInputCount() - 2; // N
         scan_output_num = ctx.GetOutputCount() - loop_carried_dep_num; // K
-        intermediate_outputs.resize(scan_output_num);
+        scan_outputs.resize(scan_output_num);
     }
 
     uint32_t loop_carried_dep_num;
     uint32_t scan_output_num;
-    vector<vector<TensorBufferInfo>> intermediate_outputs;
+    vector<ScanOutputInfo> scan_outputs;
 };
 
+static bool IsSameShape(const TensorShape& a, const TensorShape& b) {
+    if (a.GetDataType() != b.GetDataType() || a.GetDataFormat() != b.GetDataFormat() ||
+        a.GetDimCount() != b.GetDimCount()) {
+        return false;
+    }
+    for (uint32_t i = 0; i < a.GetDimCount(); ++i) {
+        if (a.GetDim(i) != b.GetDim(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static RetCode GrowScanOutput(const char* name, ScanOutputInfo* info) {
+    auto device = info->buffer.GetDevice();
+    const uint64_t new_capacity = (info->capacity == 0) ? 4 : info->capacity * 2;
+
+    BufferDesc new_buffer;
+    auto status = device->Realloc(new_capacity * info->iter_bytes, &new_buffer);
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "alloc [" << new_capacity * info->iter_bytes << "] bytes for scan output[" << name
+                   << "] failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    if (info->count > 0) {
+        status = device->Copy(&new_buffer, info->buffer.GetBufferDesc(), info->count * info->iter_bytes);
+        if (status != RC_SUCCESS) {
+            LOG(ERROR) << "copy data of scan output[" << name << "] failed: " << GetRetCodeStr(status);
+            device->Free(&new_buffer);
+            return status;
+        }
+    }
+
+    info->buffer.SetBuffer(new_buffer, device, true);
+    info->capacity = new_capacity;
+    return RC_SUCCESS;
+}
+
+static RetCode AppendScanOutput(const TensorImpl& src, ScanOutputInfo* info) {
+    auto device = src.GetDevice();
+    auto& src_shape = *src.GetShape();
+
+    void* bound_addr = info->bound_addr;
+    info->bound_addr = nullptr;
+
+    if (info->count == 0) {
+        info->buffer.SetDevice(device);
+        info->iter_shape = src_shape;
+        info->iter_bytes = src_shape.GetBytesIncludingPadding();
+    } else if (device != info->buffer.GetDevice() || !IsSameShape(src_shape, info->iter_shape)) {
+        LOG(ERROR) << "shape or device of scan output[" << src.GetName() << "] changes in iteration[" << info->count
+                   << "]";
+        return RC_INVALID_VALUE;
+    }
+
+    if (bound_addr && src.GetBufferPtr() == bound_addr) { // written in place
+        ++info->count;
+        return RC_SUCCESS;
+    }
+
+    if (info->count == info->capacity) {
+        auto status = GrowScanOutput(src.GetName(), info);
+        if (status != RC_SUCCESS) {
+            return status;
+        }
+    }
+
+    BufferDesc dst = info->buffer.GetBufferDesc();
+    dst.addr = (char*)(dst.addr) + info->count * info->iter_bytes;
+    auto status = device->Copy(&dst, src.GetBufferDesc(), info->iter_bytes);
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "copy data from tensor[" << src.GetName() << "] failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    ++info->count;
+    return RC_SUCCESS;
+}
+
 static RetCode SaveSubgraphOutputs(RuntimeImpl* subgraph, LoopInfo* info) {
     for (uint32_t i = 0; i < info->scan_output_num; ++i) {
         auto scan_output = subgraph->GetOutputTensorImpl(info->loop_carried_dep_num + i + 1); // +1 for skipping `cond`
+        auto status = AppendScanOutput(*scan_output, &info->scan_outputs[i]);
+        if (status != RC_SUCCESS) {
+            return status;
+        }
+    }
 
-        TensorBufferInfo output_buffer;
-        if (scan_output->IsBufferOwner()) {
-            output_buffer.Reshape(*scan_output->GetShape());
-            output_buffer.SetBuffer(scan_output->GetBufferDesc(), scan_output->GetDevice(), true);
-            scan_output->DetachBuffer();
-        } else {
-            auto device = scan_output->GetDevice();
+    return RC_SUCCESS;
+}
 
-            output_buffer.SetDevice(scan_output->GetDevice());
-            output_buffer.Reshape(*scan_output->GetShape());
-            auto status = output_buffer.ReallocBuffer();
-            if (status != RC_SUCCESS) {
-                LOG(ERROR) << "alloc buffer for tensor[" << scan_output->GetName()
-                           << "] failed: " << GetRetCodeStr(status);
-                return status;
-            }
+/*
+  a scan output can be bound to a slot only if it is produced by a node of the subgraph and is not used as another
+  output, whose buffer may be swapped or handed over.
+*/
+static bool CanBindScanOutput(const RuntimeImpl& subgraph, uint32_t output_idx) {
+    auto tensor = subgraph.GetOutputTensorImpl(output_idx);
+    if (tensor->GetEdge()->GetProducer() == INVALID_NODEID) {
+        return false;
+    }
+    for (uint32_t i = 0; i < subgraph.GetOutputCount(); ++i) {
+        if (i != output_idx && subgraph.GetOutputTensorImpl(i) == tensor) {
+            return false;
+        }
+    }
+    return true;
+}
 
-            status =
-                device->Copy(&output_buffer.GetBufferDesc(), scan_output->GetBufferDesc(), *scan_output->GetShape());
+static RetCode BindScanOutputs(RuntimeImpl* subgraph, LoopInfo* info) {
+    for (uint32_t i = 0; i < info->scan_output_num; ++i) {
+        auto& scan_output = info->scan_outputs[i];
+        const uint32_t output_idx = info->loop_carried_dep_num + i + 1; // +1 for skipping `cond`
+        if (scan_output.count == 0 || scan_output.iter_bytes == 0 || !CanBindScanOutput(*subgraph, output_idx)) {
+            continue;
+        }
+
+        auto tensor = subgraph->GetOutputTensorImpl(output_idx);
+        if (scan_output.count == scan_output.capacity) {
+            auto status = GrowScanOutput(tensor->GetName(), &scan_output);
             if (status != RC_SUCCESS) {
-                LOG(ERROR) << "copy data from tensor[" << scan_output->GetName()
-                           << "] failed: " << GetRetCodeStr(status);
                 return status;
             }
         }
 
-        info->intermediate_outputs[i].emplace_back(std::move(output_buffer));
+        BufferDesc slot = scan_output.buffer.GetBufferDesc();
+        slot.addr = (char*)(slot.addr) + scan_output.count * scan_output.iter_bytes;
+        tensor->FreeBuffer();
+        tensor->SetBufferView(slot, scan_output.buffer.GetDevice(), scan_output.iter_bytes);
+        scan_output.bound_tensor = tensor;
+        scan_output.bound_addr = slot.addr;
     }
 
     return RC_SUCCESS;
 }
 
+// slots must not be referenced by subgraph outputs after the buffer is handed over or freed
+static void UnbindScanOutputs(LoopInfo* info) {
+    for (auto x = info->scan_outputs.begin(); x != info->scan_outputs.end(); ++x) {
+        if (x->bound_tensor && !x->bound_tensor->IsBufferOwner()) {
+            x->bound_tensor->DetachBuffer();
+        }
+        x->bound_tensor = nullptr;
+        x->bound_addr = nullptr;
+    }
+}
+
 static RetCode UpdateSubgraphInputs(int64_t trip_count, RuntimeImpl* subgraph,
                                     utils::GenericCpuDevice* tmp_cpu_device) {
     auto trip_count_tensor = subgraph->GetInputTensorImpl(0);
@@ -135,7 +261,13 @@ static RetCode UpdateSubgraphInputs(int64_t trip_count, RuntimeImpl* subgraph,
         auto src = subgraph->GetOutputTensorImpl(i - 1);
         *dst->GetShape() = *src->GetShape();
         if (dst->GetDevice() == src->GetDevice()) {
+            // ping-pong: buffer of the last iteration's input is reused by the next output instead of being freed
+            const bool is_dst_owner = dst->IsBufferOwner();
+            auto dst_buffer = dst->DetachBuffer();
             dst->TransferBufferFrom(src);
+            if (is_dst_owner && dst_buffer.addr) {
+                src->SetBuffer(dst_buffer, dst->GetDevice(), true);
+            }
         } else {
             auto status = utils::CopyTensorBuffer(*src, dst, tmp_cpu_device);
             if (status != RC_SUCCESS) {
@@ -270,11 +402,10 @@ static RetCode SetOutputsFromInputs(const LoopInfo& info, const string& loop_ker
     return RC_SUCCESS;
 }
 
-static RetCode SetOutputsFromSubgraph(const LoopInfo& info, Device* kernel_dev, Device* tmp_cpu_device,
-                                      LoopConcatOutputFunc concat_output_func, RuntimeImpl* subgraph,
-                                      KernelExecContext* ctx) {
+static RetCode SetOutputsFromSubgraph(LoopInfo* info, Device* kernel_dev, Device* tmp_cpu_device,
+                                      RuntimeImpl* subgraph, KernelExecContext* ctx) {
     // copy loop carried deps from subgraph's output
-    for (uint32_t i = 0; i < info.loop_carried_dep_num; ++i) {
+    for (uint32_t i = 0; i < info->loop_carried_dep_num; ++i) {
         auto src = subgraph->GetOutputTensorImpl(i + 1);
         auto dst = ctx->GetOutput<TensorImpl>(i);
 
@@ -290,31 +421,36 @@ static RetCode SetOutputsFromSubgraph(const LoopInfo& info, Device* kernel_dev,
         }
     }
 
-    for (uint32_t i = info.loop_carried_dep_num; i < ctx->GetOutputCount(); ++i) {
-        auto dst = ctx->GetOutput<TensorImpl>(i);
-
-        auto& outputs = info.intermediate_outputs[i];
-        auto& output_shape = *outputs[i].GetShape();
-
-        vector<int64_t> dims(1 + output_shape.GetDimCount());
-        dims[0] = outputs.size();
-        for (uint32_t j = 0; j < output_shape.GetDimCount(); ++j) {
-            dims[j + 1] = output_shape.GetDim(j);
+    for (uint32_t i = 0; i < info->scan_output_num; ++i) {
+        auto dst = ctx->GetOutput<TensorImpl>(info->loop_carried_dep_num + i);
+        auto& scan_output = info->scan_outputs[i];
+        auto& iter_shape = scan_output.iter_shape;
+
+        vector<int64_t> dims(1 + iter_shape.GetDimCount());
+        dims[0] = scan_output.count;
+        for (uint32_t j = 0; j < iter_shape.GetDimCount(); ++j) {
+            dims[j + 1] = iter_shape.GetDim(j);
         }
 
         auto dst_shape = dst->GetShape();
-        dst_shape->SetDataType(output_shape.GetDataType());
-        dst_shape->SetDataFormat(output_shape.GetDataFormat());
+        dst_shape->SetDataType(iter_shape.GetDataType());
+        dst_shape->SetDataFormat(iter_shape.GetDataFormat());
         dst_shape->Reshape(dims.data(), dims.size());
 
-        auto status = dst->ReallocBuffer();
-        if (status != RC_SUCCESS) {
-            LOG(ERROR) << "ReallocBuffer for tensor[" << dst->GetName() << "] failed: " << GetRetCodeStr(status);
-            return status;
+        const uint64_t bytes = scan_output.count * scan_output.iter_bytes;
+        auto scan_device = scan_output.buffer.GetDevice();
+        dst->SetDevice(kernel_dev);
+        if (kernel_dev == scan_device && dst_shape->GetBytesIncludingPadding() == bytes) {
+            // hands over the buffer without copying
+            dst->SetBuffer(scan_output.buffer.DetachBuffer(), scan_device, true);
+            continue;
         }
 
-        status = concat_output_func(outputs, &dst->GetBufferDesc());
+        TensorShape src_shape(*dst_shape);
+        auto status =
+            utils::CopyBuffer(scan_output.buffer.GetBufferDesc(), src_shape, scan_device, dst, tmp_cpu_device);
         if (status != RC_SUCCESS) {
+            LOG(ERROR) << "copy scan output to tensor[" << dst->GetName() << "] failed: " << GetRetCodeStr(status);
             return status;
         }
     }
@@ -358,6 +494,9 @@ RetCode LoopKernel::DoExecute(KernelExecContext* ctx) {
     }
 
     LoopInfo loop_info(*ctx);
+    utils::Destructor __unbind_guard([&loop_info]() -> void {
+        UnbindScanOutputs(&loop_info);
+    });
     utils::GenericCpuDevice tmp_cpu_device;
 
     bool keep_going;
@@ -384,14 +523,20 @@ RetCode LoopKernel::DoExecute(KernelExecContext* ctx) {
     int64_t trip_count = 0;
     while (trip_count < max_trip_count && keep_going) {
         if (trip_count != 0) {
+            // scan outputs may alias subgraph inputs or loop carried outputs, which are changed by updating inputs
+            status = SaveSubgraphOutputs(&subgraph_, &loop_info);
+            if (status != RC_SUCCESS) {
+                LOG(ERROR) << "SaveSubgraphOutputs failed: " << GetRetCodeStr(status);
+                return status;
+            }
             status = UpdateSubgraphInputs(trip_count, &subgraph_, &tmp_cpu_device);
             if (status != RC_SUCCESS) {
                 LOG(ERROR) << "UpdateSubgraphInputs failed: " << GetRetCodeStr(status);
                 return status;
             }
-            status = SaveSubgraphOutputs(&subgraph_, &loop_info);
+            status = BindScanOutputs(&subgraph_, &loop_info);
             if (status != RC_SUCCESS) {
-                LOG(ERROR) << "SaveSubgraphOutputs failed: " << GetRetCodeStr(status);
+                LOG(ERROR) << "BindScanOutputs failed: " << GetRetCodeStr(status);
                 return status;
             }
         }
@@ -417,8 +562,12 @@ RetCode LoopKernel::DoExecute(KernelExecContext* ctx) {
             return status;
         }
     } else {
-        SaveSubgraphOutputs(&subgraph_, &loop_info);
-        status = SetOutputsFromSubgraph(loop_info, device, &tmp_cpu_device, concat_output_func_, &subgraph_, ctx);
+        status = SaveSubgraphOutputs(&subgraph_, &loop_info);
+        if (status != RC_SUCCESS) {
+            LOG(ERROR) << "SaveSubgraphOutputs failed: " << GetRetCodeStr(status);
+            return status;
+        }
+        status = SetOutputsFromSubgraph(&loop_info, device, &tmp_cpu_device, &subgraph_, ctx);
         if (status != RC_SUCCESS) {
             LOG(ERROR) << "SetOutputsFromSubgraph of loop kernel[" << GetName()
                        << "] failed: " << GetRetCodeStr(status);
@@ -23,20 +23,17 @@
 
 namespace ppl { namespace nn { namespace onnx {
 
-typedef ppl::common::RetCode (*LoopConcatOutputFunc)(const std::vector<TensorBufferInfo>&, BufferDesc*);
-
 class LoopKernel final : public common::CommonKernelImpl {
 public:
     LoopKernel(const ir::Node* node) : CommonKernelImpl(node) {}
     ppl::common::RetCode SetExecutionInfo(const std::shared_ptr<ir::GraphTopo>&, const RuntimeGraphInfo*,
-                                          const RuntimeAuxInfo*, const RuntimeInitInfo*, LoopConcatOutputFunc func);
+                                          const RuntimeAuxInfo*, const RuntimeInitInfo*);
 
 protected:
     ppl::common::RetCode DoExecute(KernelExecContext*) override;
 
 private:
     RuntimeImpl subgraph_;
-    LoopConcatOutputFunc concat_output_func_;
 };
 
 }}} // namespace ppl::nn::onnx
@@ -33,7 +33,7 @@ class LoopOp final {
 public:
     LoopOp(const ir::Node* node) : node_(node) {}
     ~LoopOp();
-    ppl::common::RetCode Init(const utils::SharedResource&, ppl::nn::onnx::LoopParam*, LoopConcatOutputFunc);
+    ppl::common::RetCode Init(const utils::SharedResource&, ppl::nn::onnx::LoopParam*);
     KernelImpl* CreateKernelImpl() const;
 
 private:
@@ -42,7 +42,6 @@ private:
     RuntimeGraphInfo graph_info_;
     RuntimeAuxInfo aux_info_;
     RuntimeInitInfo init_info_;
-    LoopConcatOutputFunc concat_output_func_;
     std::vector<std::unique_ptr<EngineImpl>> engines_;
 };
 
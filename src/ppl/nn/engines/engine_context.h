@@ -38,6 +38,14 @@ public:
     /** @brief returns the `Device` instance used by this `Runtime` */
     virtual Device* GetDevice() = 0;
 
+    /**
+       @brief tells this context that at most `n` kernels may be executed at the same time.
+       @return RC_UNSUPPORTED if the device cannot be shared by kernels running concurrently.
+    */
+    virtual ppl::common::RetCode SetMaxConcurrentKernels(uint32_t n) {
+        return (n > 1) ? ppl::common::RC_UNSUPPORTED : ppl::common::RC_SUCCESS;
+    }
+
     /** @brief called before Scheduler::Run(). */
     virtual ppl::common::RetCode BeforeRun(const ir::GraphTopo*, RuntimeGraphResource*) {
         return ppl::common::RC_SUCCESS;
@@ -181,23 +181,33 @@ RetCode LoadConstants(const ir::Graph& graph, Device* device, map<edgeid_t, Runt
     return RC_SUCCESS;
 }
 
-RetCode LoadConstants(const ConstantVisitor& visitor, Device* dev, map<edgeid_t, BufferInfo>* eid2info) {
-    return visitor.ForEach(
-        [eid2info, dev](const ir::Edge* edge, const void* data, uint64_t size, const TensorShape& shape) -> RetCode {
-            BufferInfo info;
+RetCode LoadConstants(const ConstantVisitor& visitor, Device* dev, map<edgeid_t, BufferInfo>* eid2info,
+                      uint64_t zero_copy_alignment) {
+    const bool zero_copy = (zero_copy_alignment > 0 && visitor.IsDataPersistent());
+    return visitor.ForEach([eid2info, dev, zero_copy, zero_copy_alignment](const ir::Edge* edge, const void* data,
+                                                                           uint64_t size,
+                                                                           const TensorShape& shape) -> RetCode {
+        BufferInfo info;
+        if (zero_copy && ((uintptr_t)data % zero_copy_alignment == 0) && size >= shape.GetBytesIncludingPadding()) {
+            BufferDesc buf(const_cast<void*>(data));
+            buf.desc = size;
+            info.SetDevice(dev);
+            info.SetBuffer(buf);
+        } else {
             auto status = utils::GenericLoadConstant(data, size, shape, dev, &info);
             if (status != RC_SUCCESS) {
                 LOG(ERROR) << "load constant failed: " << GetRetCodeStr(status);
                 return status;
             }
+        }
 
-            auto ret_pair = eid2info->emplace(edge->GetId(), std::move(info));
-            if (!ret_pair.second) {
-                LOG(ERROR) << "constant[" << edge->GetName() << "] already exists.";
-                return RC_EXISTS;
-            }
-            return RC_SUCCESS;
-        });
+        auto ret_pair = eid2info->emplace(edge->GetId(), std::move(info));
+        if (!ret_pair.second) {
+            LOG(ERROR) << "constant[" << edge->GetName() << "] already exists.";
+            return RC_EXISTS;
+        }
+        return RC_SUCCESS;
+    });
 }
 
 }}} // namespace ppl::nn::utils
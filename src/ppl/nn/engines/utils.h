@@ -46,7 +46,13 @@ static inline ppl::common::RetCode CopyTensorBuffer(const TensorImpl& src, Tenso
 ppl::common::RetCode LoadConstants(const ir::Graph&, Device*, std::map<edgeid_t, RuntimeConstantInfo>*,
                                    const std::set<edgeid_t>* = nullptr);
 
-ppl::common::RetCode LoadConstants(const ConstantVisitor&, Device*, std::map<edgeid_t, BufferInfo>*);
+/**
+   @param zero_copy_alignment if it is not 0 and `ConstantVisitor::IsDataPersistent()` returns true, constants
+   whose data are aligned to `zero_copy_alignment` refer to data of the visitor directly instead of being copied.
+   only for devices that share memory with host and need no layout transforms for constants.
+*/
+ppl::common::RetCode LoadConstants(const ConstantVisitor&, Device*, std::map<edgeid_t, BufferInfo>*,
+                                   uint64_t zero_copy_alignment = 0);
 
 ppl::common::RetCode GenericLoadConstant(const void* data, uint64_t size, const TensorShape& shape, Device* device,
                                          RuntimeConstantInfo* info, bool omit_data = false);
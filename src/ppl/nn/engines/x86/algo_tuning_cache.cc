@@ -0,0 +1,145 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "ppl/nn/engines/x86/algo_tuning_cache.h"
+#include "ppl/nn/engines/x86/pmx/serialization_utils.h"
+#include "ppl/nn/utils/buffer_data_stream.h"
+#include "ppl/nn/utils/utils.h"
+#include "ppl/nn/common/logger.h"
+#include <sstream>
+#include <fstream>
+using namespace std;
+using namespace ppl::common;
+using namespace ppl::kernel::x86;
+
+namespace ppl { namespace nn { namespace x86 {
+
+/*
+  file format:
+  version(uint32) | count(uint64) | [key(uint64 length + chars) | conv2d_fp32_algo_info] * count
+*/
+static const uint32_t ALGO_TUNING_CACHE_VERSION = 1;
+
+string AlgoTuningCache::GenConv2dKey(isa_t isa, const conv2d_fp32_param& param, const TensorShape& src_shape,
+                                     uint32_t num_threads) {
+    ostringstream oss;
+    oss << "conv2d:isa=" << isa << ",k=" << param.kernel_h << "x" << param.kernel_w << ",s=" << param.stride_h << "x"
+        << param.stride_w << ",d=" << param.dilation_h << "x" << param.dilation_w << ",p=" << param.pad_h << "x"
+        << param.pad_w << ",c=" << param.channels << ",oc=" << param.num_output << ",g=" << param.group
+        << ",f=" << param.fuse_flag << ",src=";
+    for (uint32_t i = 0; i < src_shape.GetDimCount(); ++i) {
+        oss << (i == 0 ? "" : "x") << src_shape.GetDim(i);
+    }
+    oss << "@" << GetDataFormatStr(src_shape.GetDataFormat()) << ",t=" << num_threads;
+    return oss.str();
+}
+
+bool AlgoTuningCache::FindConv2dAlgo(const string& key, conv2d_fp32_algo_info* info) const {
+    lock_guard<mutex> lck(mtx_);
+    auto ref = conv2d_algos_.find(key);
+    if (ref == conv2d_algos_.end()) {
+        return false;
+    }
+    *info = ref->second;
+    return true;
+}
+
+void AlgoTuningCache::InsertConv2dAlgo(const string& key, const conv2d_fp32_algo_info& info) {
+    lock_guard<mutex> lck(mtx_);
+    conv2d_algos_[key] = info;
+}
+
+RetCode AlgoTuningCache::Import(const char* file) {
+    string buf;
+    auto status = utils::ReadFileContent(file, &buf);
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "read algorithm file[" << file << "] failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    DataReader reader(buf.data(), buf.size());
+
+    uint32_t version = 0;
+    uint64_t count = 0;
+    if (reader.ReadPod(&version) != RC_SUCCESS || reader.ReadPod(&count) != RC_SUCCESS) {
+        LOG(ERROR) << "invalid algorithm file[" << file << "].";
+        return RC_INVALID_VALUE;
+    }
+    if (version != ALGO_TUNING_CACHE_VERSION) {
+        LOG(ERROR) << "unsupported algorithm file version[" << version << "], expected ["
+                   << ALGO_TUNING_CACHE_VERSION << "]";
+        return RC_UNSUPPORTED;
+    }
+
+    map<string, conv2d_fp32_algo_info> algos;
+    for (uint64_t i = 0; i < count; ++i) {
+        string key;
+        conv2d_fp32_algo_info info;
+        if (reader.ReadString(&key) != RC_SUCCESS || reader.ReadPod(&info) != RC_SUCCESS) {
+            LOG(ERROR) << "read entry[" << i << "] of algorithm file[" << file << "] failed.";
+            return RC_INVALID_VALUE;
+        }
+        algos[key] = info;
+    }
+
+    lock_guard<mutex> lck(mtx_);
+    for (auto it = algos.begin(); it != algos.end(); ++it) {
+        conv2d_algos_[it->first] = it->second;
+    }
+
+    LOG(INFO) << "[" << count << "] algorithms are imported from [" << file << "]";
+    return RC_SUCCESS;
+}
+
+RetCode AlgoTuningCache::Export(const char* file) const {
+    utils::BufferDataStream ds;
+
+    {
+        lock_guard<mutex> lck(mtx_);
+        auto status = WritePod(ALGO_TUNING_CACHE_VERSION, &ds);
+        if (status != RC_SUCCESS) {
+            return status;
+        }
+        status = WritePod((uint64_t)conv2d_algos_.size(), &ds);
+        if (status != RC_SUCCESS) {
+            return status;
+        }
+        for (auto it = conv2d_algos_.begin(); it != conv2d_algos_.end(); ++it) {
+            status = WriteString(it->first, &ds);
+            if (status != RC_SUCCESS) {
+                return status;
+            }
+            status = WritePod(it->second, &ds);
+            if (status != RC_SUCCESS) {
+                return status;
+            }
+        }
+    }
+
+    ofstream ofs(file, ios_base::out | ios_base::binary | ios_base::trunc);
+    if (!ofs.is_open()) {
+        LOG(ERROR) << "open algorithm file[" << file << "] failed.";
+        return RC_OTHER_ERROR;
+    }
+    ofs.write((const char*)ds.GetData(), ds.GetSize());
+    ofs.close();
+
+    return RC_SUCCESS;
+}
+
+}}} // namespace ppl::nn::x86
@@ -0,0 +1,56 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#ifndef _ST_HPC_PPL_NN_ENGINES_X86_ALGO_TUNING_CACHE_H_
+#define _ST_HPC_PPL_NN_ENGINES_X86_ALGO_TUNING_CACHE_H_
+
+#include "ppl/common/retcode.h"
+#include "ppl/nn/common/tensor_shape.h"
+#include "ppl/kernel/x86/fp32/conv2d.h"
+#include <string>
+#include <mutex>
+#include <map>
+
+namespace ppl { namespace nn { namespace x86 {
+
+/**
+   @class AlgoTuningCache
+   @brief algorithms selected by timing, which can be exported to a file and imported on other machines of
+   the same kind to skip tuning.
+*/
+class AlgoTuningCache final {
+public:
+    /** @brief results are only valid with the same isa, param, input shape and number of threads */
+    static std::string GenConv2dKey(ppl::common::isa_t isa, const ppl::kernel::x86::conv2d_fp32_param& param,
+                                    const TensorShape& src_shape, uint32_t num_threads);
+
+    bool FindConv2dAlgo(const std::string& key, ppl::kernel::x86::conv2d_fp32_algo_info* info) const;
+    void InsertConv2dAlgo(const std::string& key, const ppl::kernel::x86::conv2d_fp32_algo_info& info);
+
+    /** @brief merges results in `file` into this cache. existing entries are overwritten. */
+    ppl::common::RetCode Import(const char* file);
+    ppl::common::RetCode Export(const char* file) const;
+
+private:
+    mutable std::mutex mtx_;
+    std::map<std::string, ppl::kernel::x86::conv2d_fp32_algo_info> conv2d_algos_;
+};
+
+}}} // namespace ppl::nn::x86
+
+#endif
@@ -102,4 +102,21 @@ RetCode X86DataConverter::ConvertFromHost(BufferDesc* dst, const TensorShape& ds
     return Convert(dst, dst_desc, BufferDesc(const_cast<void*>(src)), src_desc);
 }
 
+RetCode X86DataConverter::ConvertFromHostImage(BufferDesc* dst, const TensorShape& dst_desc, const uint8_t* src,
+                                               const float* mean, const float* scale) const {
+    if (dst_desc.GetDataType() == DATATYPE_FLOAT32 && dst_desc.GetDimCount() >= 3) {
+        if (dst_desc.GetDataFormat() == DATAFORMAT_N16CX) {
+            if (MayUseISA(ISA_X86_AVX)) {
+                return ppl::kernel::x86::reorder_nxc_u8_n16cx_fp32_avx(&dst_desc, src, mean, scale,
+                                                                       (float*)(dst->addr));
+            } else {
+                return ppl::kernel::x86::reorder_nxc_u8_n16cx_fp32(&dst_desc, src, mean, scale, (float*)(dst->addr));
+            }
+        } else if (dst_desc.GetDataFormat() == DATAFORMAT_NDARRAY) {
+            return ppl::kernel::x86::reorder_nxc_u8_ndarray_fp32(&dst_desc, src, mean, scale, (float*)(dst->addr));
+        }
+    }
+    return DataConverter::ConvertFromHostImage(dst, dst_desc, src, mean, scale);
+}
+
 }}} // namespace ppl::nn::x86
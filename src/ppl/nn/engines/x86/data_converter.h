@@ -43,6 +43,9 @@ public:
     ppl::common::RetCode Convert(BufferDesc* dst, const TensorShape& dst_desc, const BufferDesc& src,
                                  const TensorShape& src_desc) const override;
 
+    ppl::common::RetCode ConvertFromHostImage(BufferDesc* dst, const TensorShape& dst_desc, const uint8_t* src,
+                                              const float* mean, const float* scale) const override;
+
 private:
     bool MayUseISA(uint32_t flag) const {
         return !!(isa_ & flag);
@@ -22,7 +22,9 @@
 #include "ppl/nn/engines/x86/optimizer/opt_kernel_creator_manager.h"
 #include "ppl/nn/engines/x86/optimizer/opt_graph.h"
 #include "ppl/nn/engines/x86/engine_factory.h"
+#include "ppl/nn/engines/x86/pmx/serialization_utils.h"
 #include "ppl/nn/engines/utils.h"
+#include "ppl/nn/quantization/quant_param_parser.h"
 #include "ppl/nn/common/logger.h"
 #include "ppl/kernel/x86/common/simd_tools.h"
 #include "ppl/kernel/x86/common/general_include.h"
@@ -32,7 +34,10 @@ using namespace ppl::common;
 
 namespace ppl { namespace nn { namespace x86 {
 
-X86Engine::X86Engine() : EngineImpl("x86"), device_(X86_DEFAULT_ALIGNMENT, ppl::common::GetCpuISA()) {
+X86Engine::X86Engine()
+    : EngineImpl("x86")
+    , device_(X86_DEFAULT_ALIGNMENT, ppl::common::GetCpuISA())
+    , algo_cache_(make_shared<AlgoTuningCache>()) {
     if (OptKernelCreatorManager::GetInstance()->GetSize() == 0) {
         LOG(WARNING) << "Empty op implementation set. Did you forget to call `ppl::nn::x86::RegisterBuiltinOpImpls()` "
                         "before creating x86 engines?";
@@ -46,6 +51,12 @@ X86Engine::X86Engine() : EngineImpl("x86"), device_(X86_DEFAULT_ALIGNMENT, ppl::
 }
 
 RetCode X86Engine::Init(const EngineOptions& options) {
+    if (options.forward_precision != DATATYPE_FLOAT32 && options.forward_precision != DATATYPE_BFLOAT16) {
+        LOG(ERROR) << "x86 engine only supports float32 and bfloat16 forward precision, but got ["
+                   << GetDataTypeStr(options.forward_precision) << "].";
+        return RC_UNSUPPORTED;
+    }
+
     options_ = options;
     return RC_SUCCESS;
 }
@@ -67,12 +78,20 @@ RetCode X86Engine::DoOptimize(const utils::SharedResource& resource, ir::Graph*
         return status;
     }
 
-    status = opt_graph.DoOptimize(resource, &device_);
+    status = opt_graph.DoOptimize(resource, &device_, options_, algo_cache_.get(), &quant_info_);
     if (status != RC_SUCCESS) {
         LOG(ERROR) << "OptGraph DoOptimize failed: " << GetRetCodeStr(status);
         return status;
     }
 
+    if (!export_algo_file_.empty()) {
+        status = algo_cache_->Export(export_algo_file_.c_str());
+        if (status != RC_SUCCESS) {
+            LOG(ERROR) << "export algorithms to [" << export_algo_file_ << "] failed: " << GetRetCodeStr(status);
+            return status;
+        }
+    }
+
     return RC_SUCCESS;
 }
 
@@ -137,12 +156,18 @@ RetCode X86Engine::ProcessGraph(const utils::SharedResource& resource, ir::Graph
 }
 
 EngineImpl* X86Engine::Create() {
-    return static_cast<EngineImpl*>(EngineFactory::Create(options_));
+    auto engine = static_cast<X86Engine*>(EngineFactory::Create(options_));
+    if (engine) {
+        engine->algo_cache_ = algo_cache_;
+        engine->quant_info_ = quant_info_;
+    }
+    return engine;
 }
 
 #ifdef PPLNN_ENABLE_PMX_MODEL
 RetCode X86Engine::LoadConstants(const ConstantVisitor& visitor, map<edgeid_t, BufferInfo>* eid2info) {
-    return utils::LoadConstants(visitor, &device_, eid2info);
+    // constants of pmx models are already in formats required by kernels
+    return utils::LoadConstants(visitor, &device_, eid2info, X86_DEFAULT_ALIGNMENT);
 }
 
 OptKernel* X86Engine::CreateOptKernel(const ir::Node* node) const {
@@ -160,8 +185,55 @@ OptKernel* X86Engine::CreateOptKernel(const ir::Node* node) const {
         return nullptr;
     }
 
+    // opt kernels restore packed weights with the allocator of `device_`
+    opt_kernel->SetDevice(const_cast<X86Device*>(&device_));
+
     return opt_kernel;
 }
+
+/*
+  engine data only contains the version and the isa used to optimize the model, because algorithms and packed
+  weights saved in op data are only valid with the same isa.
+  the version is also increased when layouts of op data change. version 2 adds int8/bf16 params of conv and
+  gemm, packed B of matmul and packed weights of n16cx convtranspose.
+*/
+static const uint32_t X86_ENGINE_DATA_VERSION = 2;
+
+RetCode X86Engine::SerializeData(const pmx::SerializationContext&, utils::DataStream* ds) const {
+    auto status = WritePod(X86_ENGINE_DATA_VERSION, ds);
+    if (status != RC_SUCCESS) {
+        return status;
+    }
+    return WritePod(device_.GetISA(), ds);
+}
+
+RetCode X86Engine::DeserializeData(const void* base, uint64_t size) {
+    DataReader reader(base, size);
+
+    uint32_t version = 0;
+    isa_t isa = 0;
+    if (reader.ReadPod(&version) != RC_SUCCESS || reader.ReadPod(&isa) != RC_SUCCESS) {
+        LOG(ERROR) << "read engine data failed.";
+        return RC_INVALID_VALUE;
+    }
+
+    if (version != X86_ENGINE_DATA_VERSION) {
+        LOG(ERROR) << "unsupported engine data version[" << version << "], expected [" << X86_ENGINE_DATA_VERSION
+                   << "]";
+        return RC_UNSUPPORTED;
+    }
+
+    if ((isa & device_.GetISA()) != isa) {
+        LOG(ERROR) << "model is optimized with isa[" << isa << "], which is not supported by this engine(isa["
+                   << device_.GetISA() << "]). please regenerate the model on this machine.";
+        return RC_UNSUPPORTED;
+    }
+
+    // kernels without pre-selected algorithms should also use the same isa
+    device_.SetISA(isa);
+
+    return RC_SUCCESS;
+}
 #endif
 
 /* -------------------------------------------------------------------------- */
@@ -183,9 +255,49 @@ RetCode X86Engine::DisableAVXFMA3(X86Engine* engine, va_list) {
     return RC_SUCCESS;
 }
 
+RetCode X86Engine::ExportAlgorithms(X86Engine* engine, va_list args) {
+    auto algo_file = va_arg(args, const char*);
+    if (!algo_file) {
+        LOG(ERROR) << "empty algorithm filename.";
+        return RC_INVALID_VALUE;
+    }
+    engine->export_algo_file_ = algo_file;
+    return RC_SUCCESS;
+}
+
+RetCode X86Engine::ImportAlgorithms(X86Engine* engine, va_list args) {
+    auto algo_file = va_arg(args, const char*);
+    if (!algo_file) {
+        LOG(WARNING) << "empty algorithm filename. do nothing.";
+        return RC_SUCCESS;
+    }
+    return engine->algo_cache_->Import(algo_file);
+}
+
+RetCode X86Engine::SetQuantInfo(X86Engine* engine, va_list args) {
+    auto json_str = va_arg(args, const char*);
+    if (!json_str) {
+        LOG(ERROR) << "empty quantization info string.";
+        return RC_INVALID_VALUE;
+    }
+
+    auto status = QuantParamParser::ParseBuffer(json_str, &engine->quant_info_);
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "parse quantization info failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    LOG(DEBUG) << "quant tensor size: " << engine->quant_info_.tensor_params.size()
+               << ", quant node size: " << engine->quant_info_.node_params.size();
+    return RC_SUCCESS;
+}
+
 X86Engine::ConfHandlerFunc X86Engine::conf_handlers_[] = {
-    X86Engine::DisableAVX512,
-    X86Engine::DisableAVXFMA3,
+    X86Engine::DisableAVX512, // ENGINE_CONF_DISABLE_AVX512
+    X86Engine::DisableAVXFMA3, // ENGINE_CONF_DISABLE_AVX_FMA3
+    X86Engine::ExportAlgorithms, // ENGINE_CONF_EXPORT_ALGORITHMS
+    X86Engine::ImportAlgorithms, // ENGINE_CONF_IMPORT_ALGORITHMS
+    X86Engine::SetQuantInfo, // ENGINE_CONF_SET_QUANT_INFO
 };
 
 RetCode X86Engine::Configure(uint32_t option, ...) {
@@ -21,6 +21,9 @@
 #include "ppl/nn/engines/engine_impl.h"
 #include "ppl/nn/engines/x86/x86_device.h"
 #include "ppl/nn/engines/x86/engine_options.h"
+#include "ppl/nn/engines/x86/algo_tuning_cache.h"
+#include "ppl/nn/quantization/quant_param_info.h"
+#include <memory>
 
 namespace ppl { namespace nn { namespace x86 {
 
@@ -37,12 +40,8 @@ public:
 #ifdef PPLNN_ENABLE_PMX_MODEL
     ppl::common::RetCode LoadConstants(const ConstantVisitor&, std::map<edgeid_t, BufferInfo>*) override;
     OptKernel* CreateOptKernel(const ir::Node*) const override;
-    ppl::common::RetCode SerializeData(const pmx::SerializationContext&, utils::DataStream*) const override {
-        return ppl::common::RC_UNSUPPORTED;
-    }
-    ppl::common::RetCode DeserializeData(const void*, uint64_t) override {
-        return ppl::common::RC_UNSUPPORTED;
-    }
+    ppl::common::RetCode SerializeData(const pmx::SerializationContext&, utils::DataStream*) const override;
+    ppl::common::RetCode DeserializeData(const void*, uint64_t) override;
 #endif
 
 private:
@@ -57,6 +56,9 @@ private:
      */
     static ppl::common::RetCode DisableAVX512(X86Engine*, va_list);
     static ppl::common::RetCode DisableAVXFMA3(X86Engine*, va_list);
+    static ppl::common::RetCode ExportAlgorithms(X86Engine*, va_list);
+    static ppl::common::RetCode ImportAlgorithms(X86Engine*, va_list);
+    static ppl::common::RetCode SetQuantInfo(X86Engine*, va_list);
 
     typedef ppl::common::RetCode (*ConfHandlerFunc)(X86Engine*, va_list);
     static ConfHandlerFunc conf_handlers_[ENGINE_CONF_MAX];
@@ -64,6 +66,12 @@ private:
 private:
     X86Device device_;
     EngineOptions options_;
+
+    // shared with engines created by Create() for subgraphs
+    std::shared_ptr<AlgoTuningCache> algo_cache_;
+    std::string export_algo_file_;
+
+    QuantParamInfo quant_info_;
 };
 
 }}} // namespace ppl::nn::x86
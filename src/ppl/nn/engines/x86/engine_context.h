@@ -37,6 +37,14 @@ public:
         return "x86";
     }
 
+    ppl::common::RetCode SetMaxConcurrentKernels(uint32_t n) override {
+        return device_.SetMaxConcurrentKernels(n);
+    }
+
+    ppl::common::RetCode BeforeRun(const ir::GraphTopo*, RuntimeGraphResource*) override {
+        return device_.BeforeRun();
+    }
+
 private:
     RuntimeX86Device device_;
 };
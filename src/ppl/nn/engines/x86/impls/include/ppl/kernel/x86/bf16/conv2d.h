@@ -0,0 +1,134 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#ifndef __ST_PPL_KERNEL_X86_BF16_CONV2D_H_
+#define __ST_PPL_KERNEL_X86_BF16_CONV2D_H_
+
+#include "ppl/kernel/x86/common/general_include.h"
+#include "ppl/kernel/x86/bf16/gemm.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+struct conv2d_bf16_param {
+    int64_t kernel_h;
+    int64_t kernel_w;
+    int64_t stride_h;
+    int64_t stride_w;
+    int64_t pad_h;
+    int64_t pad_w;
+    int64_t dilation_h;
+    int64_t dilation_w;
+    int64_t group;
+    int64_t channels;
+    int64_t num_output;
+    gemm_post_t post;
+};
+
+/*
+  conv2d of ndarray bf16 input and bf16 weight accumulated in float32, implemented by im2col + gemm_bf16.
+  output is float32 or bf16 in ndarray.
+*/
+
+uint64_t conv2d_bf16_get_packed_weight_bytes(
+    const conv2d_bf16_param &param);
+
+// converts and packs fp32 weight [num_output][channels / group][kernel_h][kernel_w]
+ppl::common::RetCode conv2d_bf16_pack_weight(
+    const conv2d_bf16_param &param,
+    const float *weight,
+    uint16_t *packed_weight);
+
+uint64_t conv2d_bf16_get_temp_buffer_bytes(
+    const conv2d_bf16_param &param,
+    const ppl::nn::TensorShape *dst_shape);
+
+// dst_type: DATATYPE_FLOAT32 or DATATYPE_BFLOAT16
+ppl::common::RetCode conv2d_bf16(
+    const ppl::common::isa_t isa,
+    const conv2d_bf16_param &param,
+    const ppl::nn::TensorShape *src_shape,
+    const uint16_t *src,
+    const uint16_t *packed_weight,
+    const float *bias,
+    const ppl::nn::TensorShape *dst_shape,
+    void *temp_buffer,
+    void *dst);
+
+/*
+  direct conv2d of n16cx bf16 input, no temp buffer is needed. pairs of input channels are interleaved in packed
+  weight, so that the (ic, ic + 1) pair of one pixel is broadcasted to a whole vdpbf16ps. only supports group == 1.
+  output is float32 or bf16 in n16cx, whose padded channels are zeros.
+*/
+
+bool conv2d_n16cx_bf16_is_supported(
+    const conv2d_bf16_param &param);
+
+uint64_t conv2d_n16cx_bf16_get_packed_weight_bytes(
+    const conv2d_bf16_param &param);
+
+// converts and packs fp32 weight [num_output][channels][kernel_h][kernel_w]
+ppl::common::RetCode conv2d_n16cx_bf16_pack_weight(
+    const conv2d_bf16_param &param,
+    const float *weight,
+    uint16_t *packed_weight);
+
+// dst_type: DATATYPE_FLOAT32 or DATATYPE_BFLOAT16
+ppl::common::RetCode conv2d_n16cx_bf16(
+    const ppl::common::isa_t isa,
+    const conv2d_bf16_param &param,
+    const ppl::nn::TensorShape *src_shape,
+    const uint16_t *src,
+    const uint16_t *packed_weight,
+    const float *bias,
+    const ppl::nn::TensorShape *dst_shape,
+    void *dst);
+
+ppl::common::RetCode conv2d_n16cx_bf16_ref(
+    const conv2d_bf16_param &param,
+    const ppl::nn::TensorShape *src_shape,
+    const uint16_t *src,
+    const uint16_t *packed_weight,
+    const float *bias,
+    const ppl::nn::TensorShape *dst_shape,
+    void *dst);
+
+#ifdef PPL_USE_X86_AVX512
+ppl::common::RetCode conv2d_n16cx_bf16_avx512(
+    const conv2d_bf16_param &param,
+    const ppl::nn::TensorShape *src_shape,
+    const uint16_t *src,
+    const uint16_t *packed_weight,
+    const float *bias,
+    const ppl::nn::TensorShape *dst_shape,
+    void *dst);
+#endif
+
+#ifdef PPL_USE_X86_AVX512_BF16
+ppl::common::RetCode conv2d_n16cx_bf16_avx512_bf16(
+    const conv2d_bf16_param &param,
+    const ppl::nn::TensorShape *src_shape,
+    const uint16_t *src,
+    const uint16_t *packed_weight,
+    const float *bias,
+    const ppl::nn::TensorShape *dst_shape,
+    void *dst);
+#endif
+
+}}}; // namespace ppl::kernel::x86
+
+#endif
@@ -0,0 +1,117 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#ifndef __ST_PPL_KERNEL_X86_BF16_GEMM_H_
+#define __ST_PPL_KERNEL_X86_BF16_GEMM_H_
+
+#include "ppl/kernel/x86/common/general_include.h"
+#include "ppl/kernel/x86/common/gemm_common.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+/*
+  gemm of bf16 weights A(M x K) and bf16 activations B(K x N) accumulated in float32, which is the core of
+  bf16 conv2d and fc:
+
+    C[m, n] = post(sum_k(A[m, k] * B[k, n]) + bias[m])
+
+  C is float32 or bf16. layouts are the same as gemm_s8u8 except that pairs of k are interleaved, so that
+  2 products are accumulated by one vdpbf16ps(avx512-bf16). without avx512-bf16 the pairs are expanded
+  to float32 by shifting and accumulated by fma.
+*/
+
+typedef int32_t gemm_bf16_layout_t;
+class gemm_bf16_layout {
+public:
+    static const gemm_bf16_layout_t ROW_A  = 0;
+    static const gemm_bf16_layout_t LANE_A = 1;
+};
+
+// K is padded to multiple of GEMM_BF16_K_ALIGN with zeros
+const int64_t GEMM_BF16_K_ALIGN = 2;
+// ld of operands packed in lanes should be multiple of GEMM_BF16_LANE_ALIGN
+const int64_t GEMM_BF16_LANE_ALIGN = 32;
+
+struct gemm_bf16_param {
+    gemm_bf16_layout_t layout;
+    const uint16_t *packed_a;
+    // ROW_A: [div_up(K, 2)][ldb][2], LANE_A: [N][ldb]
+    const uint16_t *packed_b;
+    const float *bias; // optional
+    int64_t M;
+    int64_t N;
+    int64_t K;
+    int64_t ldb;
+    int64_t ldc;
+    gemm_post_t post;
+    ppl::common::datatype_t c_type; // DATATYPE_FLOAT32 or DATATYPE_BFLOAT16
+    void *C;
+};
+
+uint64_t gemm_bf16_get_packed_a_bytes(
+    const gemm_bf16_layout_t layout,
+    const int64_t M,
+    const int64_t K);
+
+// converts fp32 A [M][lda] to bf16 and packs it
+ppl::common::RetCode gemm_bf16_pack_a(
+    const gemm_bf16_layout_t layout,
+    const float *A,
+    const int64_t M,
+    const int64_t K,
+    const int64_t lda,
+    uint16_t *packed_a);
+
+uint64_t gemm_bf16_get_packed_b_bytes(
+    const gemm_bf16_layout_t layout,
+    const int64_t N,
+    const int64_t K);
+
+// packs transposed B [N][ldb](rows of fc input, for example). returns the ld of packed_b in `packed_ldb`.
+ppl::common::RetCode gemm_bf16_pack_b_trans(
+    const gemm_bf16_layout_t layout,
+    const uint16_t *B,
+    const int64_t N,
+    const int64_t K,
+    const int64_t ldb,
+    uint16_t *packed_b,
+    int64_t *packed_ldb);
+
+ppl::common::RetCode gemm_bf16(
+    const ppl::common::isa_t isa,
+    const gemm_bf16_param &param);
+
+ppl::common::RetCode gemm_bf16_ref(
+    const gemm_bf16_param &param);
+
+#ifdef PPL_USE_X86_AVX512
+ppl::common::RetCode gemm_bf16_avx512(
+    const gemm_bf16_param &param);
+#endif
+
+#ifdef PPL_USE_X86_AVX512_BF16
+// avx512-bf16 is not reported by ppl::common::GetCpuISA()
+bool gemm_bf16_has_avx512_bf16();
+
+ppl::common::RetCode gemm_bf16_avx512_bf16(
+    const gemm_bf16_param &param);
+#endif
+
+}}}; // namespace ppl::kernel::x86
+
+#endif
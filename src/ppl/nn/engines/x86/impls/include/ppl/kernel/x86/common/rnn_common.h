@@ -35,6 +35,7 @@ class rnn_num_gate {
 public:
     static const int64_t LSTM = 4;
     static const int64_t GRU  = 3;
+    static const int64_t RNN  = 1;
 };
 
 }}}; // namespace ppl::kernel::x86
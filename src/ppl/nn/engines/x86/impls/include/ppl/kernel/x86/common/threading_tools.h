@@ -31,8 +31,19 @@ namespace ppl { namespace kernel { namespace x86 {
 */
 void set_omp_core_binding(const int32_t *cores, const int32_t num_cores, const int32_t mode);
 
+/*
+    binds threads of the OpenMP team started by the calling thread to `cores`.
+    pin_threads:
+        true: thread i runs on cores[i % num_cores] only
+        false: every thread can run on any core in `cores`
+*/
+void set_omp_core_affinity(const int32_t *cores, const int32_t num_cores, const bool pin_threads);
+
 int32_t get_omp_max_threads();
 
+// only affects parallel regions started by the calling thread
+void set_omp_max_threads(const int32_t num_threads);
+
 template<typename T1, typename T2>
 void parallel_task_distribution_1d(
     const T1 thread_id,
@@ -19,6 +19,7 @@
 #define __ST_PPL_KERNEL_X86_FP32_CONV2D_H_
 
 #include <string>
+#include <vector>
 
 #include "ppl/kernel/x86/common/general_include.h"
 #include "ppl/kernel/x86/common/conv_common.h"
@@ -348,6 +349,9 @@ class conv2d_algo_selector {
 public:
     static conv2d_fp32_algo_info select_algo(const ppl::common::dataformat_t src_format, const conv2d_fp32_param &param, const ppl::common::isa_t isa_flags);
     static conv2d_fp32_manager *gen_algo(const conv2d_fp32_param &param, const conv2d_fp32_algo_info &algo_info, ppl::common::Allocator *allocator);
+    // candidates for timing based selection. the first one is always the result of select_algo().
+    // algorithms taking ndarray input are excluded if src_format is not ndarray, because extra reorders are needed.
+    static std::vector<conv2d_fp32_algo_info> get_supported_algos(const ppl::common::dataformat_t src_format, const conv2d_fp32_param &param, const ppl::common::isa_t isa_flags);
 };
 
 }}}; // namespace ppl::kernel::x86
@@ -19,9 +19,67 @@
 #define __ST_PPL_KERNEL_X86_FP32_CONV_TRANSPOSE_H_
 
 #include "ppl/kernel/x86/common/general_include.h"
+#include "ppl/kernel/x86/common/conv_common.h"
 
 namespace ppl { namespace kernel { namespace x86 {
 
+struct conv_transpose_n16cx_fp32_param {
+    int64_t kernel_h;
+    int64_t kernel_w;
+    int64_t stride_h;
+    int64_t stride_w;
+    int64_t pad_h;
+    int64_t pad_w;
+    int64_t channels;
+    int64_t num_output;
+    conv_fuse_flag_t fuse_flag; // NONE, RELU or RELU6
+};
+
+/*
+  conv_transpose2d of n16cx fp32 input and output, group = 1 and dilation = 1 only.
+  output pixels of each (oh % stride_h, ow % stride_w) phase are a stride-1 convolution of the input with a
+  flipped subset of the kernel taps, so every phase is computed by the n16cx direct conv2d micro-kernels
+  without col2im.
+*/
+
+bool conv_transpose_n16cx_fp32_is_supported(
+    const ppl::common::isa_t isa,
+    const conv_transpose_n16cx_fp32_param &param);
+
+uint64_t conv_transpose_n16cx_fp32_get_packed_weight_bytes(
+    const conv_transpose_n16cx_fp32_param &param);
+
+// packs weight [channels][num_output][kernel_h][kernel_w] and bias [num_output](may be nullptr)
+ppl::common::RetCode conv_transpose_n16cx_fp32_pack_weight(
+    const conv_transpose_n16cx_fp32_param &param,
+    const float *weight,
+    const float *bias,
+    float *packed_weight);
+
+uint64_t conv_transpose_n16cx_fp32_get_buffer_bytes(
+    const conv_transpose_n16cx_fp32_param &param,
+    const ppl::nn::TensorShape *dst_shape);
+
+#ifdef PPL_USE_X86_AVX512
+ppl::common::RetCode conv_transpose_n16cx_fp32_avx512(
+    const conv_transpose_n16cx_fp32_param &param,
+    const ppl::nn::TensorShape *src_shape,
+    const float *src,
+    const float *packed_weight,
+    const ppl::nn::TensorShape *dst_shape,
+    void *temp_buffer,
+    float *dst);
+#endif
+
+ppl::common::RetCode conv_transpose_n16cx_fp32_fma(
+    const conv_transpose_n16cx_fp32_param &param,
+    const ppl::nn::TensorShape *src_shape,
+    const float *src,
+    const float *packed_weight,
+    const ppl::nn::TensorShape *dst_shape,
+    void *temp_buffer,
+    float *dst);
+
 #ifdef PPL_USE_X86_AVX512
 int64_t conv_transpose_ndarray_fp32_avx512_get_buffer_bytes(
     const int32_t batch,
@@ -0,0 +1,114 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef __ST_PPL_KERNEL_X86_FP32_FUSED_ELEMENTWISE_H_
+#define __ST_PPL_KERNEL_X86_FP32_FUSED_ELEMENTWISE_H_
+
+#include "ppl/kernel/x86/common/general_include.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+enum fused_elementwise_opcode_t {
+    // binary
+    FUSED_ELEMENTWISE_ADD = 0,
+    FUSED_ELEMENTWISE_SUB = 1,
+    FUSED_ELEMENTWISE_MUL = 2,
+    FUSED_ELEMENTWISE_DIV = 3,
+    FUSED_ELEMENTWISE_MAX = 4,
+    FUSED_ELEMENTWISE_MIN = 5,
+    // unary
+    FUSED_ELEMENTWISE_RELU    = 16,
+    FUSED_ELEMENTWISE_SIGMOID = 17,
+    FUSED_ELEMENTWISE_TANH    = 18,
+    FUSED_ELEMENTWISE_EXP     = 19,
+    FUSED_ELEMENTWISE_ERF     = 20,
+    FUSED_ELEMENTWISE_ABS     = 21,
+    FUSED_ELEMENTWISE_NEG     = 22,
+    FUSED_ELEMENTWISE_SQRT    = 23,
+};
+
+/*
+    an instruction of the expression. values [0, num_src) are sources and value (num_src + i) is the result
+    of the i-th instruction. the result of the last instruction is written to dst.
+    src1 is ignored by unary instructions.
+*/
+struct fused_elementwise_inst_t {
+    int32_t opcode;
+    int32_t src0;
+    int32_t src1;
+};
+
+inline bool fused_elementwise_is_binary(const int32_t opcode)
+{
+    return opcode < FUSED_ELEMENTWISE_RELU;
+}
+
+// a tile buffer for live intermediate results of each thread
+uint64_t fused_elementwise_fp32_get_buffer_bytes(
+    const fused_elementwise_inst_t *insts,
+    const int32_t num_src,
+    const int32_t num_insts);
+
+/*
+    src_is_scalar[i]: src[i] has only one element, which is broadcasted to length
+    elements are processed tile by tile so that intermediate results stay in cache.
+*/
+ppl::common::RetCode fused_elementwise_fp32(
+    const int64_t length,
+    const float **src,
+    const bool *src_is_scalar,
+    const int32_t num_src,
+    const fused_elementwise_inst_t *insts,
+    const int32_t num_insts,
+    void *temp_buffer,
+    float *dst);
+
+ppl::common::RetCode fused_elementwise_fp32_sse(
+    const int64_t length,
+    const float **src,
+    const bool *src_is_scalar,
+    const int32_t num_src,
+    const fused_elementwise_inst_t *insts,
+    const int32_t num_insts,
+    void *temp_buffer,
+    float *dst);
+
+ppl::common::RetCode fused_elementwise_fp32_fma(
+    const int64_t length,
+    const float **src,
+    const bool *src_is_scalar,
+    const int32_t num_src,
+    const fused_elementwise_inst_t *insts,
+    const int32_t num_insts,
+    void *temp_buffer,
+    float *dst);
+
+#ifdef PPL_USE_X86_AVX512
+ppl::common::RetCode fused_elementwise_fp32_avx512(
+    const int64_t length,
+    const float **src,
+    const bool *src_is_scalar,
+    const int32_t num_src,
+    const fused_elementwise_inst_t *insts,
+    const int32_t num_insts,
+    void *temp_buffer,
+    float *dst);
+#endif
+
+}}}; // namespace ppl::kernel::x86
+
+#endif
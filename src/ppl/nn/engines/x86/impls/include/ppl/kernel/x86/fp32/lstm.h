@@ -73,6 +73,33 @@ ppl::common::RetCode lstm_fp32_fma(
     float *Y_h,
     float *Y_c);
 
+#ifdef PPL_USE_X86_AVX512
+uint64_t lstm_fp32_avx512_get_buffer_bytes(
+    const ppl::nn::TensorShape *X_shape,
+    const rnn_direction_t direction,
+    const int64_t hidden_size,
+    const bool has_Y,
+    const bool has_Y_h,
+    const bool has_Y_c);
+
+ppl::common::RetCode lstm_fp32_avx512(
+    const ppl::nn::TensorShape *X_shape,
+    const float *X,
+    const float *X_weight,
+    const float *R_weight,
+    const float *P_weight,
+    const float *bias,
+    const int32_t *sequence_lens,
+    const float *initial_h,
+    const float *initial_c,
+    const rnn_direction_t direction,
+    const int64_t hidden_size,
+    void *temp_buffer,
+    float *Y,
+    float *Y_h,
+    float *Y_c);
+#endif
+
 }}}; // namespace ppl::kernel::x86
 
-#endif //! __ST_PPL_KERNEL_X86_FP32_GEMM_H_
+#endif //! __ST_PPL_KERNEL_X86_FP32_LSTM_H_
@@ -37,6 +37,30 @@ common::RetCode matmul_ndarray_fp32(
     void *temp_buffer,
     float *dst);
 
+// for constant src1 whose dims are [K, N] or [K](N = 1), with leading 1s allowed.
+// src1 is packed once in the layout of gemm_fp32 and reused for all rows of src0.
+uint64_t matmul_ndarray_fp32_get_packed_b_bytes(
+    const ppl::common::isa_t isa_flag,
+    const int64_t N,
+    const int64_t K);
+
+common::RetCode matmul_ndarray_fp32_pack_b(
+    const ppl::common::isa_t isa_flag,
+    const float *src1,
+    const int64_t N,
+    const int64_t K,
+    float *packed_src1);
+
+// all batch dims of src0 are folded into M. isa_flag must be the same as the one used for packing.
+common::RetCode matmul_ndarray_packed_b_fp32(
+    const ppl::nn::TensorShape *src0_shape,
+    const float *src0,
+    const float *packed_src1,
+    const int64_t N,
+    const int64_t K,
+    const ppl::common::isa_t isa_flag,
+    float *dst);
+
 }}}; // namespace ppl::kernel::x86
 
 #endif //! __ST_PPL_KERNEL_X86_FP32_MATMUL_H_
@@ -31,6 +31,35 @@ ppl::common::RetCode mmcv_nms_ndarray_fp32(
         int64_t *dst,
         int64_t *num_boxes_out);
 
+// see nms_ndarray_fp32_avx() for `use_bitmask`, results are the same as mmcv_nms_ndarray_fp32()
+uint64_t mmcv_nms_ndarray_fp32_get_buffer_bytes(
+        const uint32_t num_boxes_in,
+        const bool use_bitmask);
+
+#ifdef PPL_USE_X86_AVX512
+ppl::common::RetCode mmcv_nms_ndarray_fp32_avx512(
+        const float *boxes,
+        const float *scores,
+        const uint32_t num_boxes_in,
+        const float iou_threshold,
+        const int64_t offset,
+        const bool use_bitmask,
+        void *temp_buffer,
+        int64_t *dst,
+        int64_t *num_boxes_out);
+#endif
+
+ppl::common::RetCode mmcv_nms_ndarray_fp32_avx(
+        const float *boxes,
+        const float *scores,
+        const uint32_t num_boxes_in,
+        const float iou_threshold,
+        const int64_t offset,
+        const bool use_bitmask,
+        void *temp_buffer,
+        int64_t *dst,
+        int64_t *num_boxes_out);
+
 }}}; // namespace ppl::kernel::x86
 
 #endif //! __ST_PPL_KERNEL_X86_FP32_MMCV_NMS_H_
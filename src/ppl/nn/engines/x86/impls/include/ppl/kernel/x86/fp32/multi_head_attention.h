@@ -0,0 +1,110 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef __ST_PPL_KERNEL_X86_FP32_MULTI_HEAD_ATTENTION_H_
+#define __ST_PPL_KERNEL_X86_FP32_MULTI_HEAD_ATTENTION_H_
+
+#include "ppl/kernel/x86/common/general_include.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+// returns false if unfused gemms and softmax run faster with `isa`, which is the case for fma and avx512
+bool multi_head_attention_fp32_is_profitable(
+    const ppl::common::isa_t isa);
+
+// keys and values packed head by head, and a tile buffer of each thread
+uint64_t multi_head_attention_fp32_get_buffer_bytes(
+    const int64_t batch,
+    const int64_t seqlen_kv,
+    const int64_t num_heads,
+    const int64_t head_dim);
+
+/*
+    dst = softmax(q * k^T * scale + mask) * v for each head, without materializing the attention matrix.
+    keys and values are packed head by head, then processed tile by tile and softmax is computed online.
+
+    q:    [batch, seqlen_q, num_heads * head_dim]
+    k, v: [batch, seqlen_kv, num_heads * head_dim]
+    mask: additive mask of keys, [batch, seqlen_kv]. mask_batch_stride is 0 if all batches share the same mask.
+          can be nullptr.
+    dst:  [batch, seqlen_q, num_heads * head_dim]
+*/
+ppl::common::RetCode multi_head_attention_fp32(
+    const float *q,
+    const float *k,
+    const float *v,
+    const float *mask,
+    const int64_t batch,
+    const int64_t seqlen_q,
+    const int64_t seqlen_kv,
+    const int64_t num_heads,
+    const int64_t head_dim,
+    const int64_t mask_batch_stride,
+    const float scale,
+    void *temp_buffer,
+    float *dst);
+
+ppl::common::RetCode multi_head_attention_fp32_sse(
+    const float *q,
+    const float *k,
+    const float *v,
+    const float *mask,
+    const int64_t batch,
+    const int64_t seqlen_q,
+    const int64_t seqlen_kv,
+    const int64_t num_heads,
+    const int64_t head_dim,
+    const int64_t mask_batch_stride,
+    const float scale,
+    void *temp_buffer,
+    float *dst);
+
+ppl::common::RetCode multi_head_attention_fp32_fma(
+    const float *q,
+    const float *k,
+    const float *v,
+    const float *mask,
+    const int64_t batch,
+    const int64_t seqlen_q,
+    const int64_t seqlen_kv,
+    const int64_t num_heads,
+    const int64_t head_dim,
+    const int64_t mask_batch_stride,
+    const float scale,
+    void *temp_buffer,
+    float *dst);
+
+#ifdef PPL_USE_X86_AVX512
+ppl::common::RetCode multi_head_attention_fp32_avx512(
+    const float *q,
+    const float *k,
+    const float *v,
+    const float *mask,
+    const int64_t batch,
+    const int64_t seqlen_q,
+    const int64_t seqlen_kv,
+    const int64_t num_heads,
+    const int64_t head_dim,
+    const int64_t mask_batch_stride,
+    const float scale,
+    void *temp_buffer,
+    float *dst);
+#endif
+
+}}}; // namespace ppl::kernel::x86
+
+#endif
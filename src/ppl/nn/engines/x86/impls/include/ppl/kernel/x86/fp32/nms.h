@@ -35,6 +35,61 @@ ppl::common::RetCode nms_ndarray_fp32(
     int64_t *dst,
     int64_t *num_boxes_out);
 
+/*
+  parallel nms: (batch, class) pairs are processed by different threads and iou of one box is computed
+  against blocks of boxes with simd. boxes whose score is not greater than `score_threshold` are dropped
+  before sorting, and only the `topk` highest of them are sorted if `topk` > 0.
+  with `use_bitmask`, pairs are processed one by one while the suppression bitmask of all candidates of a
+  pair is computed by all threads, which suits few classes with many boxes.
+  results are the same as nms_ndarray_fp32() if `topk` <= 0.
+*/
+bool nms_ndarray_fp32_bitmask_is_preferred(
+    const uint32_t batch,
+    const uint32_t num_classes,
+    const int64_t num_candidates);
+
+// only depends on shapes, so the buffer fits any max_output_boxes_per_batch_per_class
+uint64_t nms_ndarray_fp32_get_buffer_bytes(
+    const uint32_t num_boxes_in,
+    const uint32_t batch,
+    const uint32_t num_classes,
+    const int64_t topk,
+    const bool use_bitmask);
+
+#ifdef PPL_USE_X86_AVX512
+ppl::common::RetCode nms_ndarray_fp32_avx512(
+    const float *boxes,
+    const float *scores,
+    const uint32_t num_boxes_in,
+    const uint32_t batch,
+    const uint32_t num_classes,
+    const bool center_point_box,
+    const int64_t max_output_boxes_per_batch_per_class,
+    const float iou_threshold,
+    const float score_threshold,
+    const int64_t topk,
+    const bool use_bitmask,
+    void *temp_buffer,
+    int64_t *dst,
+    int64_t *num_boxes_out);
+#endif
+
+ppl::common::RetCode nms_ndarray_fp32_avx(
+    const float *boxes,
+    const float *scores,
+    const uint32_t num_boxes_in,
+    const uint32_t batch,
+    const uint32_t num_classes,
+    const bool center_point_box,
+    const int64_t max_output_boxes_per_batch_per_class,
+    const float iou_threshold,
+    const float score_threshold,
+    const int64_t topk,
+    const bool use_bitmask,
+    void *temp_buffer,
+    int64_t *dst,
+    int64_t *num_boxes_out);
+
 }}}; // namespace ppl::kernel::x86
 
 #endif //! __ST_PPL_KERNEL_X86_FP32_NMS_H_
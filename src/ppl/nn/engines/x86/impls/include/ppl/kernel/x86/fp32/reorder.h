@@ -69,6 +69,29 @@ ppl::common::RetCode reorder_n16cx_nxc_fp32(
     const float *src,
     float *dst);
 
+// dst[n, c, x] = (src[n, x, c] - mean[c]) * scale[c]. `dst_shape` is the NCHW shape of dst.
+// `mean` and `scale` may be nullptr, which means 0 and 1.
+ppl::common::RetCode reorder_nxc_u8_n16cx_fp32_avx(
+    const ppl::nn::TensorShape *dst_shape,
+    const uint8_t *src,
+    const float *mean,
+    const float *scale,
+    float *dst);
+
+ppl::common::RetCode reorder_nxc_u8_n16cx_fp32(
+    const ppl::nn::TensorShape *dst_shape,
+    const uint8_t *src,
+    const float *mean,
+    const float *scale,
+    float *dst);
+
+ppl::common::RetCode reorder_nxc_u8_ndarray_fp32(
+    const ppl::nn::TensorShape *dst_shape,
+    const uint8_t *src,
+    const float *mean,
+    const float *scale,
+    float *dst);
+
 ppl::common::RetCode reorder_ndarray_n8cx_fp32(
     const ppl::nn::TensorShape *src_shape,
     const float *src,
@@ -0,0 +1,86 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#ifndef __ST_PPL_KERNEL_X86_INT8_CONV2D_H_
+#define __ST_PPL_KERNEL_X86_INT8_CONV2D_H_
+
+#include "ppl/kernel/x86/common/general_include.h"
+#include "ppl/kernel/x86/int8/gemm.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+struct conv2d_int8_param {
+    int64_t kernel_h;
+    int64_t kernel_w;
+    int64_t stride_h;
+    int64_t stride_w;
+    int64_t pad_h;
+    int64_t pad_w;
+    int64_t dilation_h;
+    int64_t dilation_w;
+    int64_t group;
+    int64_t channels;
+    int64_t num_output;
+    gemm_post_t post;
+};
+
+/*
+  quantized conv2d of ndarray uint8 input and int8 weight(quantized per output channel), implemented by
+  im2col + gemm_s8u8. output is float32 or requantized uint8 in ndarray.
+*/
+
+uint64_t conv2d_int8_get_packed_weight_bytes(
+    const conv2d_int8_param &param);
+
+// quantizes and packs fp32 weight [num_output][channels / group][kernel_h][kernel_w].
+// w_scale and w_sum are of num_output elements.
+ppl::common::RetCode conv2d_int8_quantize_pack_weight(
+    const ppl::common::isa_t isa,
+    const conv2d_int8_param &param,
+    const float *weight,
+    int8_t *packed_weight,
+    float *w_scale,
+    int32_t *w_sum);
+
+uint64_t conv2d_int8_get_temp_buffer_bytes(
+    const conv2d_int8_param &param,
+    const ppl::nn::TensorShape *dst_shape);
+
+/*
+  scale: w_scale * src_scale of each output channel
+  dst_type: DATATYPE_FLOAT32, or DATATYPE_UINT8 which is requantized by dst_scale and dst_zero_point
+*/
+ppl::common::RetCode conv2d_int8(
+    const ppl::common::isa_t isa,
+    const conv2d_int8_param &param,
+    const ppl::nn::TensorShape *src_shape,
+    const uint8_t *src,
+    const int32_t src_zero_point,
+    const int8_t *packed_weight,
+    const int32_t *w_sum,
+    const float *scale,
+    const float *bias,
+    const ppl::nn::TensorShape *dst_shape,
+    const float dst_scale,
+    const int32_t dst_zero_point,
+    void *temp_buffer,
+    void *dst);
+
+}}}; // namespace ppl::kernel::x86
+
+#endif
@@ -0,0 +1,127 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#ifndef __ST_PPL_KERNEL_X86_INT8_GEMM_H_
+#define __ST_PPL_KERNEL_X86_INT8_GEMM_H_
+
+#include "ppl/kernel/x86/common/general_include.h"
+#include "ppl/kernel/x86/common/gemm_common.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+/*
+  gemm of int8 weights A(M x K) and uint8 activations B(K x N), which is the core of quantized conv2d and fc:
+
+    C[m, n] = post(scale[m] * (sum_k(A[m, k] * B[k, n]) - b_zero_point * a_sum[m]) + bias[m])
+
+  A is quantized symmetrically per row(output channel) and B is quantized asymmetrically per tensor.
+  C is float32, or uint8 requantized by c_scale and c_zero_point.
+
+  one operand is broadcast along "rows" and the other one is loaded as vectors along "lanes" in [K / 4][ld][4]
+  blocks so that 4 products can be accumulated by one vpdpbusd(avx512-vnni) or vpmaddubsw + vpmaddwd(avx2):
+    ROW_A:  rows of C are m and lanes are n, C is [M][ldc]. used by conv2d whose N is large.
+    LANE_A: rows of C are n and lanes are m, C is [N][ldc]. used by fc whose N(batch) is usually small.
+*/
+
+typedef int32_t gemm_s8u8_layout_t;
+class gemm_s8u8_layout {
+public:
+    static const gemm_s8u8_layout_t ROW_A  = 0;
+    static const gemm_s8u8_layout_t LANE_A = 1;
+};
+
+// K is padded to multiple of GEMM_S8U8_K_ALIGN with zeros
+const int64_t GEMM_S8U8_K_ALIGN = 4;
+// ld of operands packed in lanes should be multiple of GEMM_S8U8_LANE_ALIGN
+const int64_t GEMM_S8U8_LANE_ALIGN = 32;
+
+struct gemm_s8u8_param {
+    gemm_s8u8_layout_t layout;
+    const int8_t *packed_a;
+    // ROW_A: [div_up(K, 4)][ldb][4], LANE_A: [N][ldb]
+    const uint8_t *packed_b;
+    const float *scale;
+    const float *bias; // optional
+    const int32_t *a_sum;
+    int64_t M;
+    int64_t N;
+    int64_t K;
+    int64_t ldb;
+    int64_t ldc;
+    int32_t b_zero_point;
+    gemm_post_t post;
+    ppl::common::datatype_t c_type; // DATATYPE_FLOAT32 or DATATYPE_UINT8
+    float c_scale;
+    int32_t c_zero_point;
+    void *C;
+};
+
+// max abs value of quantized A. vpmaddubsw saturates to int16, so that A is 7-bit without vnni.
+int32_t gemm_s8u8_get_a_max_value(
+    const ppl::common::isa_t isa);
+
+uint64_t gemm_s8u8_get_packed_a_bytes(
+    const gemm_s8u8_layout_t layout,
+    const int64_t M,
+    const int64_t K);
+
+// quantizes fp32 A [M][lda] per row and packs it. a_scale and a_sum are of M elements.
+ppl::common::RetCode gemm_s8u8_quantize_pack_a(
+    const ppl::common::isa_t isa,
+    const gemm_s8u8_layout_t layout,
+    const float *A,
+    const int64_t M,
+    const int64_t K,
+    const int64_t lda,
+    int8_t *packed_a,
+    float *a_scale,
+    int32_t *a_sum);
+
+uint64_t gemm_s8u8_get_packed_b_bytes(
+    const gemm_s8u8_layout_t layout,
+    const int64_t N,
+    const int64_t K);
+
+// packs transposed B [N][ldb](rows of fc input, for example). returns the ld of packed_b in `packed_ldb`.
+ppl::common::RetCode gemm_s8u8_pack_b_trans(
+    const gemm_s8u8_layout_t layout,
+    const uint8_t *B,
+    const int64_t N,
+    const int64_t K,
+    const int64_t ldb,
+    uint8_t *packed_b,
+    int64_t *packed_ldb);
+
+ppl::common::RetCode gemm_s8u8(
+    const ppl::common::isa_t isa,
+    const gemm_s8u8_param &param);
+
+ppl::common::RetCode gemm_s8u8_ref(
+    const gemm_s8u8_param &param);
+
+ppl::common::RetCode gemm_s8u8_avx2(
+    const gemm_s8u8_param &param);
+
+#ifdef PPL_USE_X86_AVX512_VNNI
+ppl::common::RetCode gemm_s8u8_avx512_vnni(
+    const gemm_s8u8_param &param);
+#endif
+
+}}}; // namespace ppl::kernel::x86
+
+#endif
@@ -0,0 +1,35 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef __ST_PPL_KERNEL_X86_BF16_BF16_AVX512_BF16_TOOLS_H_
+#define __ST_PPL_KERNEL_X86_BF16_BF16_AVX512_BF16_TOOLS_H_
+
+#include <immintrin.h>
+
+namespace ppl { namespace kernel { namespace x86 {
+
+// same as bf16_avx512_fma_dot but by one vdpbf16ps, only for sources compiled with avx512-bf16
+struct bf16_avx512_dpbf16_dot {
+    static inline __m512 dot(const __m512 acc, const __m512i a, const __m512i b)
+    {
+        return _mm512_dpbf16_ps(acc, (__m512bh)a, (__m512bh)b);
+    }
+};
+
+}}}; // namespace ppl::kernel::x86
+
+#endif
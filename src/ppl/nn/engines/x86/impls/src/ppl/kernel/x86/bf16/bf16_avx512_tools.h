@@ -0,0 +1,60 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#ifndef __ST_PPL_KERNEL_X86_BF16_BF16_AVX512_TOOLS_H_
+#define __ST_PPL_KERNEL_X86_BF16_BF16_AVX512_TOOLS_H_
+
+#include <immintrin.h>
+
+namespace ppl { namespace kernel { namespace x86 {
+
+// rounds to nearest even with avx512f only, same as cvt_fp32_bf16_scalar()
+inline __m256i cvt_fp32_bf16_avx512(const __m512 x)
+{
+    const __m512i u     = _mm512_castps_si512(x);
+    const __m512i lsb   = _mm512_and_si512(_mm512_srli_epi32(u, 16), _mm512_set1_epi32(1));
+    __m512i r           = _mm512_add_epi32(u, _mm512_add_epi32(lsb, _mm512_set1_epi32(0x7fff)));
+    const __mmask16 nan = _mm512_cmp_ps_mask(x, x, _CMP_UNORD_Q);
+    r                   = _mm512_mask_or_epi32(r, nan, u, _mm512_set1_epi32(0x400000));
+    return _mm512_cvtepi32_epi16(_mm512_srli_epi32(r, 16));
+}
+
+inline __m512 cvt_bf16_fp32_avx512(const __m256i x)
+{
+    return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(x), 16));
+}
+
+/*
+  accumulates products of 16 pairs of bf16 in `a` and `b` into the 16 float32 lanes of `acc` without avx512-bf16.
+  pairs are expanded to float32: the lower one is shifted left and the higher one is masked.
+*/
+struct bf16_avx512_fma_dot {
+    static inline __m512 dot(const __m512 acc, const __m512i a, const __m512i b)
+    {
+        const __m512i hi_mask = _mm512_set1_epi32((int32_t)0xffff0000);
+        const __m512 a_lo     = _mm512_castsi512_ps(_mm512_slli_epi32(a, 16));
+        const __m512 a_hi     = _mm512_castsi512_ps(_mm512_and_si512(a, hi_mask));
+        const __m512 b_lo     = _mm512_castsi512_ps(_mm512_slli_epi32(b, 16));
+        const __m512 b_hi     = _mm512_castsi512_ps(_mm512_and_si512(b, hi_mask));
+        return _mm512_fmadd_ps(a_hi, b_hi, _mm512_fmadd_ps(a_lo, b_lo, acc));
+    }
+};
+
+}}}; // namespace ppl::kernel::x86
+
+#endif
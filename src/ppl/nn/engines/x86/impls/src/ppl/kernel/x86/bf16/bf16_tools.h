@@ -0,0 +1,49 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#ifndef __ST_PPL_KERNEL_X86_BF16_BF16_TOOLS_H_
+#define __ST_PPL_KERNEL_X86_BF16_BF16_TOOLS_H_
+
+#include <string.h>
+
+#include "ppl/kernel/x86/common/internal_include.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+inline uint16_t cvt_fp32_bf16_scalar(const float x)
+{
+    uint32_t u;
+    memcpy(&u, &x, sizeof(u));
+    if ((u & 0x7fffffff) > 0x7f800000) {
+        return (uint16_t)((u >> 16) | 0x40); // keeps nan quiet
+    }
+    u += 0x7fff + ((u >> 16) & 1);
+    return (uint16_t)(u >> 16);
+}
+
+inline float cvt_bf16_fp32_scalar(const uint16_t x)
+{
+    const uint32_t u = (uint32_t)x << 16;
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+}}}; // namespace ppl::kernel::x86
+
+#endif
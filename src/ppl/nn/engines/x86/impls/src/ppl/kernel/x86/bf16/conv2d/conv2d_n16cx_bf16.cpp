@@ -0,0 +1,161 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <string.h>
+
+#include "ppl/kernel/x86/bf16/conv2d/conv2d_n16cx_bf16_common.h"
+
+#ifdef PPL_USE_X86_AVX512_BF16
+#include "ppl/kernel/x86/bf16/gemm.h"
+#endif
+
+namespace ppl { namespace kernel { namespace x86 {
+
+bool conv2d_n16cx_bf16_is_supported(
+    const conv2d_bf16_param &param)
+{
+    return param.group == 1;
+}
+
+uint64_t conv2d_n16cx_bf16_get_packed_weight_bytes(
+    const conv2d_bf16_param &param)
+{
+    const int64_t ch_blk = CONV2D_N16CX_BF16_CH_BLK;
+    return round_up(param.num_output, ch_blk) * round_up(param.channels, ch_blk) *
+           param.kernel_h * param.kernel_w * sizeof(uint16_t);
+}
+
+ppl::common::RetCode conv2d_n16cx_bf16_pack_weight(
+    const conv2d_bf16_param &param,
+    const float *weight,
+    uint16_t *packed_weight)
+{
+    if (!conv2d_n16cx_bf16_is_supported(param)) {
+        return ppl::common::RC_UNSUPPORTED;
+    }
+
+    const int64_t ch_blk    = CONV2D_N16CX_BF16_CH_BLK;
+    const int64_t ic_pair   = CONV2D_N16CX_BF16_IC_PAIR;
+    const int64_t kernel_hw = param.kernel_h * param.kernel_w;
+
+    memset(packed_weight, 0, conv2d_n16cx_bf16_get_packed_weight_bytes(param));
+
+    PRAGMA_OMP_PARALLEL_FOR()
+    for (int64_t oc = 0; oc < param.num_output; ++oc) {
+        for (int64_t ic = 0; ic < param.channels; ++ic) {
+            const int64_t icr      = ic % ch_blk;
+            uint16_t *l_weight     = packed_weight + conv2d_n16cx_bf16_weight_offset(param, oc / ch_blk, ic / ch_blk) +
+                                     (icr / ic_pair) * ch_blk * ic_pair + (oc % ch_blk) * ic_pair + icr % ic_pair;
+            const float *l_src     = weight + (oc * param.channels + ic) * kernel_hw;
+            for (int64_t k = 0; k < kernel_hw; ++k) {
+                l_weight[k * ch_blk * ch_blk] = cvt_fp32_bf16_scalar(l_src[k]);
+            }
+        }
+    }
+
+    return ppl::common::RC_SUCCESS;
+}
+
+ppl::common::RetCode conv2d_n16cx_bf16_ref(
+    const conv2d_bf16_param &param,
+    const ppl::nn::TensorShape *src_shape,
+    const uint16_t *src,
+    const uint16_t *packed_weight,
+    const float *bias,
+    const ppl::nn::TensorShape *dst_shape,
+    void *dst)
+{
+    const int64_t ch_blk   = CONV2D_N16CX_BF16_CH_BLK;
+    const int64_t ic_pair  = CONV2D_N16CX_BF16_IC_PAIR;
+    const int64_t batch    = src_shape->GetDim(0);
+    const int64_t src_h    = src_shape->GetDim(2);
+    const int64_t src_w    = src_shape->GetDim(3);
+    const int64_t dst_h    = dst_shape->GetDim(2);
+    const int64_t dst_w    = dst_shape->GetDim(3);
+    const int64_t ic_blks  = div_up(param.channels, ch_blk);
+    const int64_t oc_blks  = div_up(param.num_output, ch_blk);
+    const auto dst_type    = dst_shape->GetDataType();
+
+#ifdef PPL_USE_X86_OMP_COLLAPSE
+    PRAGMA_OMP_PARALLEL_FOR_COLLAPSE(3)
+#endif
+    for (int64_t b = 0; b < batch; ++b) {
+        for (int64_t ocb = 0; ocb < oc_blks; ++ocb) {
+#ifndef PPL_USE_X86_OMP_COLLAPSE
+            PRAGMA_OMP_PARALLEL_FOR()
+#endif
+            for (int64_t oh = 0; oh < dst_h; ++oh) {
+                for (int64_t ow = 0; ow < dst_w; ++ow) {
+                    for (int64_t ocr = 0; ocr < ch_blk; ++ocr) {
+                        float acc = 0.0f;
+                        for (int64_t ic = 0; ic < param.channels; ++ic) {
+                            const int64_t icr       = ic % ch_blk;
+                            const uint16_t *l_src   = src + (b * ic_blks + ic / ch_blk) * src_h * src_w * ch_blk + icr;
+                            const uint16_t *l_weight = packed_weight + conv2d_n16cx_bf16_weight_offset(param, ocb, ic / ch_blk) +
+                                                       (icr / ic_pair) * ch_blk * ic_pair + ocr * ic_pair + icr % ic_pair;
+                            for (int64_t kh = 0; kh < param.kernel_h; ++kh) {
+                                const int64_t ih = oh * param.stride_h - param.pad_h + kh * param.dilation_h;
+                                if (ih < 0 || ih >= src_h) continue;
+                                for (int64_t kw = 0; kw < param.kernel_w; ++kw) {
+                                    const int64_t iw = ow * param.stride_w - param.pad_w + kw * param.dilation_w;
+                                    if (iw < 0 || iw >= src_w) continue;
+                                    acc += cvt_bf16_fp32_scalar(l_src[(ih * src_w + iw) * ch_blk]) *
+                                           cvt_bf16_fp32_scalar(l_weight[(kh * param.kernel_w + kw) * ch_blk * ch_blk]);
+                                }
+                            }
+                        }
+                        const int64_t offset = (((b * oc_blks + ocb) * dst_h + oh) * dst_w + ow) * ch_blk + ocr;
+                        conv2d_n16cx_bf16_store_scalar(param, bias, ocb * ch_blk + ocr, dst_type, acc, dst, offset);
+                    }
+                }
+            }
+        }
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+ppl::common::RetCode conv2d_n16cx_bf16(
+    const ppl::common::isa_t isa,
+    const conv2d_bf16_param &param,
+    const ppl::nn::TensorShape *src_shape,
+    const uint16_t *src,
+    const uint16_t *packed_weight,
+    const float *bias,
+    const ppl::nn::TensorShape *dst_shape,
+    void *dst)
+{
+    if (!conv2d_n16cx_bf16_is_supported(param)) {
+        return ppl::common::RC_UNSUPPORTED;
+    }
+    const auto dst_type = dst_shape->GetDataType();
+    if (dst_type != ppl::common::DATATYPE_FLOAT32 && dst_type != ppl::common::DATATYPE_BFLOAT16) {
+        return ppl::common::RC_UNSUPPORTED;
+    }
+#ifdef PPL_USE_X86_AVX512_BF16
+    if ((isa & ppl::common::ISA_X86_AVX512) && gemm_bf16_has_avx512_bf16()) {
+        return conv2d_n16cx_bf16_avx512_bf16(param, src_shape, src, packed_weight, bias, dst_shape, dst);
+    }
+#endif
+#ifdef PPL_USE_X86_AVX512
+    if (isa & ppl::common::ISA_X86_AVX512) {
+        return conv2d_n16cx_bf16_avx512(param, src_shape, src, packed_weight, bias, dst_shape, dst);
+    }
+#endif
+    return conv2d_n16cx_bf16_ref(param, src_shape, src, packed_weight, bias, dst_shape, dst);
+}
+
+}}}; // namespace ppl::kernel::x86
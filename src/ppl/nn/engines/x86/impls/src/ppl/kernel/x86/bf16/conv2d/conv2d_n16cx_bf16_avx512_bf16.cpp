@@ -0,0 +1,36 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/kernel/x86/bf16/conv2d/conv2d_n16cx_bf16_avx512_kernel.h"
+#include "ppl/kernel/x86/bf16/bf16_avx512_bf16_tools.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+ppl::common::RetCode conv2d_n16cx_bf16_avx512_bf16(
+    const conv2d_bf16_param &param,
+    const ppl::nn::TensorShape *src_shape,
+    const uint16_t *src,
+    const uint16_t *packed_weight,
+    const float *bias,
+    const ppl::nn::TensorShape *dst_shape,
+    void *dst)
+{
+    return conv2d_n16cx_bf16_avx512_common<bf16_avx512_dpbf16_dot>(
+        param, src_shape, src, packed_weight, bias, dst_shape, dst);
+}
+
+}}}; // namespace ppl::kernel::x86
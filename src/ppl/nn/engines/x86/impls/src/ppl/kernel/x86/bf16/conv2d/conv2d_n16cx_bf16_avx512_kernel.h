@@ -0,0 +1,282 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef __ST_PPL_KERNEL_X86_BF16_CONV2D_CONV2D_N16CX_BF16_AVX512_KERNEL_H_
+#define __ST_PPL_KERNEL_X86_BF16_CONV2D_CONV2D_N16CX_BF16_AVX512_KERNEL_H_
+
+#include <immintrin.h>
+
+#include "ppl/kernel/x86/bf16/conv2d/conv2d_n16cx_bf16_common.h"
+#include "ppl/kernel/x86/bf16/bf16_avx512_tools.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+/*
+  microkernels shared by conv2d_n16cx_bf16_avx512 and conv2d_n16cx_bf16_avx512_bf16. one microkernel computes
+  W_LEN pixels of one output row for OC_REGS blocks of 16 output channels. `dot_t` is bf16_avx512_fma_dot or
+  bf16_avx512_dpbf16_dot.
+*/
+
+const int64_t CONV2D_N16CX_BF16_AVX512_OC_REGS = 2;
+const int64_t CONV2D_N16CX_BF16_AVX512_W_BLK   = 12;
+
+struct conv2d_n16cx_bf16_avx512_kernel_param {
+    const uint16_t *src; // first pixel of the first (kh, kw) in the window
+    const uint16_t *weight; // first (kh, kw) in the window of the first oc block
+    const float *bias; // first oc of the first oc block, nullptr if there is no bias
+    void *dst;
+    int64_t kh_len;
+    int64_t kw_len;
+    int64_t ic_blks;
+    int64_t ic_tail; // channels of the last ic block
+    int64_t src_icb_stride;
+    int64_t src_kh_stride;
+    int64_t src_kw_stride;
+    int64_t src_sw_stride;
+    int64_t weight_icb_stride;
+    int64_t weight_kh_stride;
+    int64_t weight_ocb_stride;
+    int64_t dst_ocb_stride;
+    int64_t oc_valid; // valid channels from the first oc
+    gemm_post_t post;
+    ppl::common::datatype_t dst_type;
+};
+
+template <typename dot_t, int64_t OC_REGS, int64_t W_LEN>
+static inline void conv2d_n16cx_bf16_avx512_pairs(
+    const uint16_t *src,
+    const int64_t src_sw_stride,
+    const uint16_t *weight,
+    const int64_t weight_ocb_stride,
+    const int64_t pairs,
+    const bool odd,
+    __m512 acc[][CONV2D_N16CX_BF16_AVX512_OC_REGS])
+{
+    const int64_t ch_blk  = CONV2D_N16CX_BF16_CH_BLK;
+    const int64_t ic_pair = CONV2D_N16CX_BF16_IC_PAIR;
+
+    for (int64_t p = 0; p < pairs; ++p) {
+        const __m512i zmm_w0 = _mm512_loadu_si512((const __m512i *)(weight + p * ch_blk * ic_pair));
+        __m512i zmm_w1;
+        if (OC_REGS > 1) zmm_w1 = _mm512_loadu_si512((const __m512i *)(weight + weight_ocb_stride + p * ch_blk * ic_pair));
+        for (int64_t x = 0; x < W_LEN; ++x) {
+            const __m512i zmm_s = _mm512_set1_epi32(*(const int32_t *)(src + x * src_sw_stride + p * ic_pair));
+            acc[x][0]           = dot_t::dot(acc[x][0], zmm_w0, zmm_s);
+            if (OC_REGS > 1) acc[x][1] = dot_t::dot(acc[x][1], zmm_w1, zmm_s);
+        }
+    }
+    // the higher half of the last pair is a padded channel which may not be zero
+    if (odd) {
+        const __m512i zmm_w0 = _mm512_loadu_si512((const __m512i *)(weight + pairs * ch_blk * ic_pair));
+        __m512i zmm_w1;
+        if (OC_REGS > 1) zmm_w1 = _mm512_loadu_si512((const __m512i *)(weight + weight_ocb_stride + pairs * ch_blk * ic_pair));
+        for (int64_t x = 0; x < W_LEN; ++x) {
+            const __m512i zmm_s = _mm512_set1_epi32((int32_t)src[x * src_sw_stride + pairs * ic_pair]);
+            acc[x][0]           = dot_t::dot(acc[x][0], zmm_w0, zmm_s);
+            if (OC_REGS > 1) acc[x][1] = dot_t::dot(acc[x][1], zmm_w1, zmm_s);
+        }
+    }
+}
+
+template <typename dot_t, int64_t OC_REGS, int64_t W_LEN>
+static void conv2d_n16cx_bf16_avx512_kernel(
+    const conv2d_n16cx_bf16_avx512_kernel_param &kp)
+{
+    const int64_t ch_blk  = CONV2D_N16CX_BF16_CH_BLK;
+    const int64_t ic_pair = CONV2D_N16CX_BF16_IC_PAIR;
+
+    __m512 acc[W_LEN][CONV2D_N16CX_BF16_AVX512_OC_REGS];
+    for (int64_t x = 0; x < W_LEN; ++x) {
+        acc[x][0] = _mm512_setzero_ps();
+        if (OC_REGS > 1) acc[x][1] = _mm512_setzero_ps();
+    }
+
+    const int64_t weight_kw_stride = ch_blk * ch_blk;
+    for (int64_t icb = 0; icb < kp.ic_blks; ++icb) {
+        const int64_t ic_len  = icb == kp.ic_blks - 1 ? kp.ic_tail : ch_blk;
+        const int64_t pairs   = ic_len / ic_pair;
+        const bool odd        = ic_len % ic_pair != 0;
+        const uint16_t *l_src = kp.src + icb * kp.src_icb_stride;
+        const uint16_t *l_wgt = kp.weight + icb * kp.weight_icb_stride;
+        for (int64_t kh = 0; kh < kp.kh_len; ++kh) {
+            for (int64_t kw = 0; kw < kp.kw_len; ++kw) {
+                conv2d_n16cx_bf16_avx512_pairs<dot_t, OC_REGS, W_LEN>(
+                    l_src + kh * kp.src_kh_stride + kw * kp.src_kw_stride, kp.src_sw_stride,
+                    l_wgt + kh * kp.weight_kh_stride + kw * weight_kw_stride, kp.weight_ocb_stride,
+                    pairs, odd, acc);
+            }
+        }
+    }
+
+    const __m512 zmm_zero = _mm512_setzero_ps();
+    const __m512 zmm_six  = _mm512_set1_ps(6.0f);
+    for (int64_t r = 0; r < OC_REGS; ++r) {
+        // padded channels of the last oc block get zero bias and stay zero
+        __m512 zmm_bias = zmm_zero;
+        if (kp.bias) {
+            const int64_t valid  = min<int64_t>(kp.oc_valid - r * ch_blk, ch_blk);
+            const __mmask16 mask = (__mmask16)((1u << valid) - 1);
+            zmm_bias             = _mm512_maskz_loadu_ps(mask, kp.bias + r * ch_blk);
+        }
+        for (int64_t x = 0; x < W_LEN; ++x) {
+            __m512 zmm_y = _mm512_add_ps(acc[x][r], zmm_bias);
+            if (kp.post & (gemm_post::RELU6 | gemm_post::RELU)) zmm_y = _mm512_max_ps(zmm_y, zmm_zero);
+            if (kp.post & gemm_post::RELU6) zmm_y = _mm512_min_ps(zmm_y, zmm_six);
+
+            const int64_t offset = r * kp.dst_ocb_stride + x * ch_blk;
+            if (kp.dst_type == ppl::common::DATATYPE_BFLOAT16) {
+                _mm256_storeu_si256((__m256i *)((uint16_t *)kp.dst + offset), cvt_fp32_bf16_avx512(zmm_y));
+            } else {
+                _mm512_storeu_ps((float *)kp.dst + offset, zmm_y);
+            }
+        }
+    }
+}
+
+typedef void (*conv2d_n16cx_bf16_avx512_kernel_func_t)(const conv2d_n16cx_bf16_avx512_kernel_param &);
+
+template <typename dot_t, int64_t OC_REGS>
+struct conv2d_n16cx_bf16_avx512_kernel_table {
+    static const conv2d_n16cx_bf16_avx512_kernel_func_t table[CONV2D_N16CX_BF16_AVX512_W_BLK];
+};
+
+template <typename dot_t, int64_t OC_REGS>
+const conv2d_n16cx_bf16_avx512_kernel_func_t
+    conv2d_n16cx_bf16_avx512_kernel_table<dot_t, OC_REGS>::table[CONV2D_N16CX_BF16_AVX512_W_BLK] = {
+        conv2d_n16cx_bf16_avx512_kernel<dot_t, OC_REGS, 1>,
+        conv2d_n16cx_bf16_avx512_kernel<dot_t, OC_REGS, 2>,
+        conv2d_n16cx_bf16_avx512_kernel<dot_t, OC_REGS, 3>,
+        conv2d_n16cx_bf16_avx512_kernel<dot_t, OC_REGS, 4>,
+        conv2d_n16cx_bf16_avx512_kernel<dot_t, OC_REGS, 5>,
+        conv2d_n16cx_bf16_avx512_kernel<dot_t, OC_REGS, 6>,
+        conv2d_n16cx_bf16_avx512_kernel<dot_t, OC_REGS, 7>,
+        conv2d_n16cx_bf16_avx512_kernel<dot_t, OC_REGS, 8>,
+        conv2d_n16cx_bf16_avx512_kernel<dot_t, OC_REGS, 9>,
+        conv2d_n16cx_bf16_avx512_kernel<dot_t, OC_REGS, 10>,
+        conv2d_n16cx_bf16_avx512_kernel<dot_t, OC_REGS, 11>,
+        conv2d_n16cx_bf16_avx512_kernel<dot_t, OC_REGS, 12>,
+};
+
+// first valid kernel index of an output pixel starting at `i0`
+inline int64_t conv2d_n16cx_bf16_k_start(const int64_t i0, const int64_t dilation)
+{
+    return i0 >= 0 ? 0 : div_up(-i0, dilation);
+}
+
+// end of valid kernel indices of an output pixel starting at `i0`
+inline int64_t conv2d_n16cx_bf16_k_end(const int64_t i0, const int64_t dilation, const int64_t kernel, const int64_t src_len)
+{
+    return i0 >= src_len ? 0 : min(kernel, div_up(src_len - i0, dilation));
+}
+
+template <typename dot_t>
+static ppl::common::RetCode conv2d_n16cx_bf16_avx512_common(
+    const conv2d_bf16_param &param,
+    const ppl::nn::TensorShape *src_shape,
+    const uint16_t *src,
+    const uint16_t *packed_weight,
+    const float *bias,
+    const ppl::nn::TensorShape *dst_shape,
+    void *dst)
+{
+    const int64_t ch_blk    = CONV2D_N16CX_BF16_CH_BLK;
+    const int64_t oc_regs   = CONV2D_N16CX_BF16_AVX512_OC_REGS;
+    const int64_t w_blk     = CONV2D_N16CX_BF16_AVX512_W_BLK;
+    const int64_t batch     = src_shape->GetDim(0);
+    const int64_t src_h     = src_shape->GetDim(2);
+    const int64_t src_w     = src_shape->GetDim(3);
+    const int64_t dst_h     = dst_shape->GetDim(2);
+    const int64_t dst_w     = dst_shape->GetDim(3);
+    const int64_t ic_blks   = div_up(param.channels, ch_blk);
+    const int64_t oc_blks   = div_up(param.num_output, ch_blk);
+    const int64_t oc_groups = div_up(oc_blks, oc_regs);
+    const int64_t dst_elem  = ppl::common::GetSizeOfDataType(dst_shape->GetDataType());
+
+    // output pixels in [ow_start, ow_end) have their whole kernel windows in the source row
+    const int64_t ow_start  = min(dst_w, div_up(param.pad_w, param.stride_w));
+    const int64_t last_iw   = src_w - 1 + param.pad_w - (param.kernel_w - 1) * param.dilation_w;
+    const int64_t ow_end    = max(ow_start, min(dst_w, last_iw < 0 ? 0 : last_iw / param.stride_w + 1));
+
+    conv2d_n16cx_bf16_avx512_kernel_param base;
+    base.ic_blks           = ic_blks;
+    base.ic_tail           = param.channels - (ic_blks - 1) * ch_blk;
+    base.src_icb_stride    = src_h * src_w * ch_blk;
+    base.src_kh_stride     = param.dilation_h * src_w * ch_blk;
+    base.src_kw_stride     = param.dilation_w * ch_blk;
+    base.src_sw_stride     = param.stride_w * ch_blk;
+    base.weight_icb_stride = param.kernel_h * param.kernel_w * ch_blk * ch_blk;
+    base.weight_kh_stride  = param.kernel_w * ch_blk * ch_blk;
+    base.weight_ocb_stride = ic_blks * base.weight_icb_stride;
+    base.dst_ocb_stride    = dst_h * dst_w * ch_blk;
+    base.post              = param.post;
+    base.dst_type          = dst_shape->GetDataType();
+
+#ifdef PPL_USE_X86_OMP_COLLAPSE
+    PRAGMA_OMP_PARALLEL_FOR_COLLAPSE(3)
+#endif
+    for (int64_t b = 0; b < batch; ++b) {
+        for (int64_t ocg = 0; ocg < oc_groups; ++ocg) {
+#ifndef PPL_USE_X86_OMP_COLLAPSE
+            PRAGMA_OMP_PARALLEL_FOR()
+#endif
+            for (int64_t oh = 0; oh < dst_h; ++oh) {
+                const int64_t ocb      = ocg * oc_regs;
+                const int64_t regs     = min(oc_regs, oc_blks - ocb);
+                const int64_t ih0      = oh * param.stride_h - param.pad_h;
+                const int64_t kh_start = conv2d_n16cx_bf16_k_start(ih0, param.dilation_h);
+                const int64_t kh_end   = conv2d_n16cx_bf16_k_end(ih0, param.dilation_h, param.kernel_h, src_h);
+                const conv2d_n16cx_bf16_avx512_kernel_func_t *table =
+                    regs == 2 ? conv2d_n16cx_bf16_avx512_kernel_table<dot_t, 2>::table
+                              : conv2d_n16cx_bf16_avx512_kernel_table<dot_t, 1>::table;
+
+                conv2d_n16cx_bf16_avx512_kernel_param kp = base;
+                kp.kh_len   = max<int64_t>(kh_end - kh_start, 0);
+                kp.bias     = bias ? bias + ocb * ch_blk : nullptr;
+                kp.oc_valid = param.num_output - ocb * ch_blk;
+
+                const uint16_t *l_src = src + b * ic_blks * base.src_icb_stride + (ih0 + kh_start * param.dilation_h) * src_w * ch_blk;
+                const uint16_t *l_wgt = packed_weight + conv2d_n16cx_bf16_weight_offset(param, ocb, 0) + kh_start * base.weight_kh_stride;
+                uint8_t *l_dst        = (uint8_t *)dst + (((b * oc_blks + ocb) * dst_h + oh) * dst_w * ch_blk) * dst_elem;
+
+                int64_t ow = 0;
+                while (ow < dst_w) {
+                    int64_t ow_len = 1;
+                    int64_t kw_start = 0, kw_end = param.kernel_w;
+                    const int64_t iw0 = ow * param.stride_w - param.pad_w;
+                    if (ow >= ow_start && ow < ow_end) {
+                        ow_len = min(ow_end - ow, w_blk);
+                    } else {
+                        kw_start = conv2d_n16cx_bf16_k_start(iw0, param.dilation_w);
+                        kw_end   = conv2d_n16cx_bf16_k_end(iw0, param.dilation_w, param.kernel_w, src_w);
+                    }
+                    kp.kw_len = max<int64_t>(kw_end - kw_start, 0);
+                    kp.src    = l_src + (iw0 + kw_start * param.dilation_w) * ch_blk;
+                    kp.weight = l_wgt + kw_start * ch_blk * ch_blk;
+                    kp.dst    = l_dst + ow * ch_blk * dst_elem;
+                    table[ow_len - 1](kp);
+                    ow += ow_len;
+                }
+            }
+        }
+    }
+
+    return ppl::common::RC_SUCCESS;
+}
+
+}}}; // namespace ppl::kernel::x86
+
+#endif
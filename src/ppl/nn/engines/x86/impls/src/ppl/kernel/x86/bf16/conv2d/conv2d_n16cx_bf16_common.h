@@ -0,0 +1,73 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef __ST_PPL_KERNEL_X86_BF16_CONV2D_CONV2D_N16CX_BF16_COMMON_H_
+#define __ST_PPL_KERNEL_X86_BF16_CONV2D_CONV2D_N16CX_BF16_COMMON_H_
+
+#include "ppl/kernel/x86/bf16/bf16_tools.h"
+#include "ppl/kernel/x86/bf16/conv2d.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+// channels of one n16cx block
+const int64_t CONV2D_N16CX_BF16_CH_BLK = 16;
+// bf16 interleaved in one dword of packed weight
+const int64_t CONV2D_N16CX_BF16_IC_PAIR = 2;
+
+/*
+  packed weight: [oc / 16][ic / 16][kernel_h][kernel_w][8 ic pairs][16 oc][2 ic], padded channels are zeros.
+  returns the offset of one (oc, ic) block, whose [kernel_h][kernel_w][8][16][2] are contiguous.
+*/
+inline int64_t conv2d_n16cx_bf16_weight_offset(
+    const conv2d_bf16_param &param,
+    const int64_t ocb,
+    const int64_t icb)
+{
+    const int64_t ch_blk   = CONV2D_N16CX_BF16_CH_BLK;
+    const int64_t ic_blks  = div_up(param.channels, ch_blk);
+    const int64_t blk_size = param.kernel_h * param.kernel_w * ch_blk * ch_blk;
+    return (ocb * ic_blks + icb) * blk_size;
+}
+
+// applies bias and activation of one element. n16cx padded channels are set to zeros.
+inline void conv2d_n16cx_bf16_store_scalar(
+    const conv2d_bf16_param &param,
+    const float *bias,
+    const int64_t oc,
+    const ppl::common::datatype_t dst_type,
+    float y,
+    void *dst,
+    const int64_t offset)
+{
+    if (oc >= param.num_output) {
+        y = 0.0f;
+    } else {
+        if (bias) y += bias[oc];
+        if (param.post & (gemm_post::RELU6 | gemm_post::RELU)) y = max(y, 0.0f);
+        if (param.post & gemm_post::RELU6) y = min(y, 6.0f);
+    }
+
+    if (dst_type == ppl::common::DATATYPE_BFLOAT16) {
+        ((uint16_t *)dst)[offset] = cvt_fp32_bf16_scalar(y);
+    } else {
+        ((float *)dst)[offset] = y;
+    }
+}
+
+}}}; // namespace ppl::kernel::x86
+
+#endif
@@ -0,0 +1,80 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "ppl/kernel/x86/bf16/bf16_tools.h"
+#include "ppl/kernel/x86/bf16/cvt.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+ppl::common::RetCode cvt_fp32_bf16_ref(
+    const ppl::nn::TensorShape *src_shape,
+    const float *src,
+    uint16_t *dst)
+{
+    const int64_t n_elem = src_shape->GetElementsIncludingPadding();
+
+    PRAGMA_OMP_PARALLEL_FOR()
+    for (int64_t i = 0; i < n_elem; ++i) {
+        dst[i] = cvt_fp32_bf16_scalar(src[i]);
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+ppl::common::RetCode cvt_bf16_fp32_ref(
+    const ppl::nn::TensorShape *src_shape,
+    const uint16_t *src,
+    float *dst)
+{
+    const int64_t n_elem = src_shape->GetElementsIncludingPadding();
+
+    PRAGMA_OMP_PARALLEL_FOR()
+    for (int64_t i = 0; i < n_elem; ++i) {
+        dst[i] = cvt_bf16_fp32_scalar(src[i]);
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+ppl::common::RetCode cvt_fp32_bf16(
+    const ppl::common::isa_t isa,
+    const ppl::nn::TensorShape *src_shape,
+    const float *src,
+    uint16_t *dst)
+{
+#ifdef PPL_USE_X86_AVX512
+    if (isa & ppl::common::ISA_X86_AVX512) {
+        return cvt_fp32_bf16_avx512(src_shape, src, dst);
+    }
+#endif
+    return cvt_fp32_bf16_ref(src_shape, src, dst);
+}
+
+ppl::common::RetCode cvt_bf16_fp32(
+    const ppl::common::isa_t isa,
+    const ppl::nn::TensorShape *src_shape,
+    const uint16_t *src,
+    float *dst)
+{
+#ifdef PPL_USE_X86_AVX512
+    if (isa & ppl::common::ISA_X86_AVX512) {
+        return cvt_bf16_fp32_avx512(src_shape, src, dst);
+    }
+#endif
+    return cvt_bf16_fp32_ref(src_shape, src, dst);
+}
+
+}}}; // namespace ppl::kernel::x86
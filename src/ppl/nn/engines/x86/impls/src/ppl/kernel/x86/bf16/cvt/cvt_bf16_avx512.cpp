@@ -0,0 +1,72 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "ppl/kernel/x86/bf16/bf16_tools.h"
+#include "ppl/kernel/x86/bf16/bf16_avx512_tools.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+ppl::common::RetCode cvt_fp32_bf16_avx512(
+    const ppl::nn::TensorShape *src_shape,
+    const float *src,
+    uint16_t *dst)
+{
+    const int64_t n_elem        = src_shape->GetElementsIncludingPadding();
+    const int64_t simd_w        = 16;
+    const int64_t unroll_n      = 4 * simd_w;
+    const int64_t unroll_n_body = round(n_elem, unroll_n);
+
+    if (unroll_n_body) {
+        PRAGMA_OMP_PARALLEL_FOR()
+        for (int64_t n = 0; n < unroll_n_body; n += unroll_n) {
+            for (int64_t u = 0; u < unroll_n; u += simd_w) {
+                _mm256_storeu_si256((__m256i *)(dst + n + u), cvt_fp32_bf16_avx512(_mm512_loadu_ps(src + n + u)));
+            }
+        }
+    }
+    for (int64_t n = unroll_n_body; n < n_elem; ++n) {
+        dst[n] = cvt_fp32_bf16_scalar(src[n]);
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+ppl::common::RetCode cvt_bf16_fp32_avx512(
+    const ppl::nn::TensorShape *src_shape,
+    const uint16_t *src,
+    float *dst)
+{
+    const int64_t n_elem        = src_shape->GetElementsIncludingPadding();
+    const int64_t simd_w        = 16;
+    const int64_t unroll_n      = 4 * simd_w;
+    const int64_t unroll_n_body = round(n_elem, unroll_n);
+
+    if (unroll_n_body) {
+        PRAGMA_OMP_PARALLEL_FOR()
+        for (int64_t n = 0; n < unroll_n_body; n += unroll_n) {
+            for (int64_t u = 0; u < unroll_n; u += simd_w) {
+                _mm512_storeu_ps(dst + n + u, cvt_bf16_fp32_avx512(_mm256_loadu_si256((const __m256i *)(src + n + u))));
+            }
+        }
+    }
+    for (int64_t n = unroll_n_body; n < n_elem; ++n) {
+        dst[n] = cvt_bf16_fp32_scalar(src[n]);
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+}}}; // namespace ppl::kernel::x86
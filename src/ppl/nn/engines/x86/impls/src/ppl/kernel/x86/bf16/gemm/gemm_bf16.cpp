@@ -0,0 +1,182 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <string.h>
+
+#include "ppl/kernel/x86/bf16/gemm/gemm_bf16_common.h"
+
+#ifdef PPL_USE_X86_AVX512_BF16
+#include <cpuid.h>
+#endif
+
+namespace ppl { namespace kernel { namespace x86 {
+
+#ifdef PPL_USE_X86_AVX512_BF16
+bool gemm_bf16_has_avx512_bf16()
+{
+    static const bool has_avx512_bf16 = []() -> bool {
+        uint32_t eax, ebx, ecx, edx;
+        if (!__get_cpuid_count(7, 1, &eax, &ebx, &ecx, &edx)) {
+            return false;
+        }
+        return (eax & (1u << 5)) != 0;
+    }();
+    return has_avx512_bf16;
+}
+#endif
+
+uint64_t gemm_bf16_get_packed_a_bytes(
+    const gemm_bf16_layout_t layout,
+    const int64_t M,
+    const int64_t K)
+{
+    if (layout == gemm_bf16_layout::ROW_A) {
+        return M * gemm_bf16_get_kp(K) * sizeof(uint16_t);
+    }
+    return round_up(M, GEMM_BF16_LANE_ALIGN) * gemm_bf16_get_kp(K) * sizeof(uint16_t);
+}
+
+ppl::common::RetCode gemm_bf16_pack_a(
+    const gemm_bf16_layout_t layout,
+    const float *A,
+    const int64_t M,
+    const int64_t K,
+    const int64_t lda,
+    uint16_t *packed_a)
+{
+    const int64_t Kp = gemm_bf16_get_kp(K);
+    const int64_t Ml = round_up(M, GEMM_BF16_LANE_ALIGN);
+
+    memset(packed_a, 0, gemm_bf16_get_packed_a_bytes(layout, M, K));
+
+    PRAGMA_OMP_PARALLEL_FOR()
+    for (int64_t m = 0; m < M; ++m) {
+        const float *a = A + m * lda;
+        for (int64_t k = 0; k < K; ++k) {
+            if (layout == gemm_bf16_layout::ROW_A) {
+                packed_a[m * Kp + k] = cvt_fp32_bf16_scalar(a[k]);
+            } else {
+                packed_a[((k / GEMM_BF16_K_ALIGN) * Ml + m) * GEMM_BF16_K_ALIGN + k % GEMM_BF16_K_ALIGN] =
+                    cvt_fp32_bf16_scalar(a[k]);
+            }
+        }
+    }
+
+    return ppl::common::RC_SUCCESS;
+}
+
+uint64_t gemm_bf16_get_packed_b_bytes(
+    const gemm_bf16_layout_t layout,
+    const int64_t N,
+    const int64_t K)
+{
+    if (layout == gemm_bf16_layout::ROW_A) {
+        return gemm_bf16_get_kp(K) * round_up(N, GEMM_BF16_LANE_ALIGN) * sizeof(uint16_t);
+    }
+    return N * gemm_bf16_get_kp(K) * sizeof(uint16_t);
+}
+
+ppl::common::RetCode gemm_bf16_pack_b_trans(
+    const gemm_bf16_layout_t layout,
+    const uint16_t *B,
+    const int64_t N,
+    const int64_t K,
+    const int64_t ldb,
+    uint16_t *packed_b,
+    int64_t *packed_ldb)
+{
+    const int64_t Kp = gemm_bf16_get_kp(K);
+
+    if (layout == gemm_bf16_layout::ROW_A) {
+        const int64_t Nl = round_up(N, GEMM_BF16_LANE_ALIGN);
+        memset(packed_b, 0, Kp * Nl * sizeof(uint16_t));
+        PRAGMA_OMP_PARALLEL_FOR()
+        for (int64_t n = 0; n < N; ++n) {
+            for (int64_t k = 0; k < K; ++k) {
+                packed_b[((k / GEMM_BF16_K_ALIGN) * Nl + n) * GEMM_BF16_K_ALIGN + k % GEMM_BF16_K_ALIGN] = B[n * ldb + k];
+            }
+        }
+        *packed_ldb = Nl;
+    } else {
+        PRAGMA_OMP_PARALLEL_FOR()
+        for (int64_t n = 0; n < N; ++n) {
+            memcpy(packed_b + n * Kp, B + n * ldb, K * sizeof(uint16_t));
+            memset(packed_b + n * Kp + K, 0, (Kp - K) * sizeof(uint16_t));
+        }
+        *packed_ldb = Kp;
+    }
+
+    return ppl::common::RC_SUCCESS;
+}
+
+ppl::common::RetCode gemm_bf16_ref(
+    const gemm_bf16_param &param)
+{
+    const bool row_a  = param.layout == gemm_bf16_layout::ROW_A;
+    const int64_t Kp  = gemm_bf16_get_kp(param.K);
+    const int64_t Ml  = round_up(param.M, GEMM_BF16_LANE_ALIGN);
+    const int64_t R   = gemm_bf16_get_rows(param);
+    const int64_t L   = gemm_bf16_get_lanes(param);
+    const int64_t K_A = GEMM_BF16_K_ALIGN;
+
+#ifdef PPL_USE_X86_OMP_COLLAPSE
+    PRAGMA_OMP_PARALLEL_FOR_COLLAPSE(2)
+#endif
+    for (int64_t r = 0; r < R; ++r) {
+#ifndef PPL_USE_X86_OMP_COLLAPSE
+        PRAGMA_OMP_PARALLEL_FOR()
+#endif
+        for (int64_t l = 0; l < L; ++l) {
+            const int64_t m = row_a ? r : l;
+            const int64_t n = row_a ? l : r;
+            float acc       = 0.0f;
+            for (int64_t k = 0; k < param.K; ++k) {
+                const uint16_t a = row_a ? param.packed_a[m * Kp + k] : param.packed_a[((k / K_A) * Ml + m) * K_A + k % K_A];
+                const uint16_t b = row_a ? param.packed_b[((k / K_A) * param.ldb + n) * K_A + k % K_A] : param.packed_b[n * param.ldb + k];
+                acc += cvt_bf16_fp32_scalar(a) * cvt_bf16_fp32_scalar(b);
+            }
+            gemm_bf16_store_scalar(param, r, l, acc);
+        }
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+ppl::common::RetCode gemm_bf16(
+    const ppl::common::isa_t isa,
+    const gemm_bf16_param &param)
+{
+    if (param.M <= 0 || param.N <= 0) {
+        return ppl::common::RC_SUCCESS;
+    }
+    if (param.c_type != ppl::common::DATATYPE_FLOAT32 && param.c_type != ppl::common::DATATYPE_BFLOAT16) {
+        return ppl::common::RC_UNSUPPORTED;
+    }
+#ifdef PPL_USE_X86_AVX512_BF16
+    if ((isa & ppl::common::ISA_X86_AVX512) && gemm_bf16_has_avx512_bf16()) {
+        return gemm_bf16_avx512_bf16(param);
+    }
+#endif
+#ifdef PPL_USE_X86_AVX512
+    if (isa & ppl::common::ISA_X86_AVX512) {
+        return gemm_bf16_avx512(param);
+    }
+#endif
+    return gemm_bf16_ref(param);
+}
+
+}}}; // namespace ppl::kernel::x86
@@ -0,0 +1,204 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#ifndef __ST_PPL_KERNEL_X86_BF16_GEMM_GEMM_BF16_AVX512_KERNEL_H_
+#define __ST_PPL_KERNEL_X86_BF16_GEMM_GEMM_BF16_AVX512_KERNEL_H_
+
+#include <immintrin.h>
+
+#include "ppl/kernel/x86/bf16/gemm/gemm_bf16_common.h"
+#include "ppl/kernel/x86/bf16/bf16_avx512_tools.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+/*
+  microkernels shared by gemm_bf16_avx512 and gemm_bf16_avx512_bf16. `dot_t` is bf16_avx512_fma_dot or
+  bf16_avx512_dpbf16_dot, which accumulates products of 16 pairs of bf16 in `lane` and `row` into the 16 float32
+  lanes of `acc`:
+
+    static __m512 dot(__m512 acc, __m512i lane, __m512i row);
+*/
+
+const int64_t GEMM_BF16_AVX512_ROW_BLK  = 6;
+const int64_t GEMM_BF16_AVX512_LANE_BLK = 32;
+const int64_t GEMM_BF16_AVX512_SIMD_W   = 16;
+
+template <typename dot_t, int64_t ROWS>
+static inline void gemm_bf16_avx512_kernel(
+    const uint16_t *row_src,
+    const int64_t row_stride,
+    const uint16_t *lane_src,
+    const int64_t lane_stride,
+    const int64_t Kq,
+    __m512 acc[][2])
+{
+    const int64_t simd_w = GEMM_BF16_AVX512_SIMD_W;
+
+    for (int64_t r = 0; r < ROWS; ++r) {
+        acc[r][0] = _mm512_setzero_ps();
+        acc[r][1] = _mm512_setzero_ps();
+    }
+
+    for (int64_t kq = 0; kq < Kq; ++kq) {
+        const __m512i zmm_l0 = _mm512_loadu_si512((const __m512i *)(lane_src + 0 * simd_w * GEMM_BF16_K_ALIGN));
+        const __m512i zmm_l1 = _mm512_loadu_si512((const __m512i *)(lane_src + 1 * simd_w * GEMM_BF16_K_ALIGN));
+        for (int64_t r = 0; r < ROWS; ++r) {
+            const __m512i zmm_r = _mm512_set1_epi32(*(const int32_t *)(row_src + r * row_stride));
+            acc[r][0]           = dot_t::dot(acc[r][0], zmm_l0, zmm_r);
+            acc[r][1]           = dot_t::dot(acc[r][1], zmm_l1, zmm_r);
+        }
+        row_src += GEMM_BF16_K_ALIGN;
+        lane_src += lane_stride;
+    }
+}
+
+template <int64_t ROWS, bool ROW_A>
+static inline void gemm_bf16_avx512_store(
+    const gemm_bf16_param &param,
+    const int64_t row_start,
+    const int64_t lane_start,
+    const int64_t lanes,
+    __m512 acc[][2])
+{
+    const int64_t simd_w  = GEMM_BF16_AVX512_SIMD_W;
+    const __m512 zmm_zero = _mm512_setzero_ps();
+    const __m512 zmm_six  = _mm512_set1_ps(6.0f);
+
+    for (int64_t v = 0; v < GEMM_BF16_AVX512_LANE_BLK / simd_w; ++v) {
+        const int64_t lane  = lane_start + v * simd_w;
+        const int64_t valid = min<int64_t>(lanes - v * simd_w, simd_w);
+        if (valid <= 0) {
+            break;
+        }
+        const __mmask16 mask = (__mmask16)((1u << valid) - 1);
+
+        // per lane bias(LANE_A)
+        __m512 zmm_bias = zmm_zero;
+        if (!ROW_A && param.bias) {
+            zmm_bias = _mm512_maskz_loadu_ps(mask, param.bias + lane);
+        }
+
+        for (int64_t r = 0; r < ROWS; ++r) {
+            const int64_t row = row_start + r;
+            if (ROW_A && param.bias) {
+                zmm_bias = _mm512_set1_ps(param.bias[row]);
+            }
+
+            __m512 zmm_y = _mm512_add_ps(acc[r][v], zmm_bias);
+            if (param.post & (gemm_post::RELU6 | gemm_post::RELU)) zmm_y = _mm512_max_ps(zmm_y, zmm_zero);
+            if (param.post & gemm_post::RELU6) zmm_y = _mm512_min_ps(zmm_y, zmm_six);
+
+            const int64_t offset = row * param.ldc + lane;
+            if (param.c_type == ppl::common::DATATYPE_BFLOAT16) {
+                // masked 16-bit stores need avx512bw
+                const __m256i ymm_y = cvt_fp32_bf16_avx512(zmm_y);
+                if (valid == simd_w) {
+                    _mm256_storeu_si256((__m256i *)((uint16_t *)param.C + offset), ymm_y);
+                } else {
+                    uint16_t tmp[GEMM_BF16_AVX512_SIMD_W];
+                    _mm256_storeu_si256((__m256i *)tmp, ymm_y);
+                    memcpy((uint16_t *)param.C + offset, tmp, valid * sizeof(uint16_t));
+                }
+            } else {
+                _mm512_mask_storeu_ps((float *)param.C + offset, mask, zmm_y);
+            }
+        }
+    }
+}
+
+template <typename dot_t, int64_t ROWS, bool ROW_A>
+static void gemm_bf16_avx512_block(
+    const gemm_bf16_param &param,
+    const int64_t row_start,
+    const int64_t lane_start,
+    const int64_t lanes)
+{
+    const int64_t Kq = div_up(param.K, GEMM_BF16_K_ALIGN);
+    const int64_t Kp = Kq * GEMM_BF16_K_ALIGN;
+    const int64_t Ml = round_up(param.M, GEMM_BF16_LANE_ALIGN);
+
+    const uint16_t *row_src;
+    const uint16_t *lane_src;
+    int64_t row_stride, lane_stride;
+    if (ROW_A) {
+        row_src     = param.packed_a + row_start * Kp;
+        row_stride  = Kp;
+        lane_src    = param.packed_b + lane_start * GEMM_BF16_K_ALIGN;
+        lane_stride = param.ldb * GEMM_BF16_K_ALIGN;
+    } else {
+        row_src     = param.packed_b + row_start * param.ldb;
+        row_stride  = param.ldb;
+        lane_src    = param.packed_a + lane_start * GEMM_BF16_K_ALIGN;
+        lane_stride = Ml * GEMM_BF16_K_ALIGN;
+    }
+
+    __m512 acc[GEMM_BF16_AVX512_ROW_BLK][2];
+    gemm_bf16_avx512_kernel<dot_t, ROWS>(row_src, row_stride, lane_src, lane_stride, Kq, acc);
+    gemm_bf16_avx512_store<ROWS, ROW_A>(param, row_start, lane_start, lanes, acc);
+}
+
+template <typename dot_t, bool ROW_A>
+static void gemm_bf16_avx512_impl(
+    const gemm_bf16_param &param)
+{
+    typedef void (*block_func_t)(const gemm_bf16_param &, const int64_t, const int64_t, const int64_t);
+    static const block_func_t block_table[GEMM_BF16_AVX512_ROW_BLK] = {
+        gemm_bf16_avx512_block<dot_t, 1, ROW_A>,
+        gemm_bf16_avx512_block<dot_t, 2, ROW_A>,
+        gemm_bf16_avx512_block<dot_t, 3, ROW_A>,
+        gemm_bf16_avx512_block<dot_t, 4, ROW_A>,
+        gemm_bf16_avx512_block<dot_t, 5, ROW_A>,
+        gemm_bf16_avx512_block<dot_t, 6, ROW_A>,
+    };
+
+    const int64_t lane_blk   = GEMM_BF16_AVX512_LANE_BLK;
+    const int64_t row_blk    = GEMM_BF16_AVX512_ROW_BLK;
+    const int64_t R          = gemm_bf16_get_rows(param);
+    const int64_t L          = gemm_bf16_get_lanes(param);
+    const int64_t num_chunks = div_up(R, GEMM_BF16_ROW_CHUNK);
+    const int64_t num_tasks  = div_up(L, lane_blk) * num_chunks;
+
+    // tasks sharing the same lanes are adjacent so that the lane block stays in cache
+    PRAGMA_OMP_PARALLEL_FOR()
+    for (int64_t t = 0; t < num_tasks; ++t) {
+        const int64_t lane_start = (t / num_chunks) * lane_blk;
+        const int64_t lanes      = min(L - lane_start, lane_blk);
+        const int64_t row_begin  = (t % num_chunks) * GEMM_BF16_ROW_CHUNK;
+        const int64_t row_end    = min(R, row_begin + GEMM_BF16_ROW_CHUNK);
+        for (int64_t r = row_begin; r < row_end; r += row_blk) {
+            const int64_t rows = min(row_end - r, row_blk);
+            block_table[rows - 1](param, r, lane_start, lanes);
+        }
+    }
+}
+
+template <typename dot_t>
+static ppl::common::RetCode gemm_bf16_avx512_common(
+    const gemm_bf16_param &param)
+{
+    if (param.layout == gemm_bf16_layout::ROW_A) {
+        gemm_bf16_avx512_impl<dot_t, true>(param);
+    } else {
+        gemm_bf16_avx512_impl<dot_t, false>(param);
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+}}}; // namespace ppl::kernel::x86
+
+#endif
@@ -0,0 +1,68 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#ifndef __ST_PPL_KERNEL_X86_BF16_GEMM_GEMM_BF16_COMMON_H_
+#define __ST_PPL_KERNEL_X86_BF16_GEMM_GEMM_BF16_COMMON_H_
+
+#include "ppl/kernel/x86/bf16/bf16_tools.h"
+#include "ppl/kernel/x86/bf16/gemm.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+// rows of C processed by one task. multiple of row blocks of all microkernels.
+const int64_t GEMM_BF16_ROW_CHUNK = 48;
+
+inline int64_t gemm_bf16_get_kp(const int64_t K)
+{
+    return round_up(K, GEMM_BF16_K_ALIGN);
+}
+
+inline int64_t gemm_bf16_get_rows(const gemm_bf16_param &param)
+{
+    return param.layout == gemm_bf16_layout::ROW_A ? param.M : param.N;
+}
+
+inline int64_t gemm_bf16_get_lanes(const gemm_bf16_param &param)
+{
+    return param.layout == gemm_bf16_layout::ROW_A ? param.N : param.M;
+}
+
+// applies bias and activation of one element
+inline void gemm_bf16_store_scalar(
+    const gemm_bf16_param &param,
+    const int64_t row,
+    const int64_t lane,
+    float y)
+{
+    const int64_t m = param.layout == gemm_bf16_layout::ROW_A ? row : lane;
+
+    if (param.bias) y += param.bias[m];
+    if (param.post & (gemm_post::RELU6 | gemm_post::RELU)) y = max(y, 0.0f);
+    if (param.post & gemm_post::RELU6) y = min(y, 6.0f);
+
+    const int64_t offset = row * param.ldc + lane;
+    if (param.c_type == ppl::common::DATATYPE_BFLOAT16) {
+        ((uint16_t *)param.C)[offset] = cvt_fp32_bf16_scalar(y);
+    } else {
+        ((float *)param.C)[offset] = y;
+    }
+}
+
+}}}; // namespace ppl::kernel::x86
+
+#endif
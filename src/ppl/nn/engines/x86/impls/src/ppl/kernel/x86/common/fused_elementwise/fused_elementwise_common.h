@@ -0,0 +1,275 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef __ST_PPL_KERNEL_X86_COMMON_FUSED_ELEMENTWISE_FUSED_ELEMENTWISE_COMMON_H_
+#define __ST_PPL_KERNEL_X86_COMMON_FUSED_ELEMENTWISE_FUSED_ELEMENTWISE_COMMON_H_
+
+#include <math.h>
+#include <vector>
+
+#include "ppl/kernel/x86/common/internal_include.h"
+#include "ppl/kernel/x86/fp32/fused_elementwise.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+// floats of a tile(2KB). each live intermediate result of a tile takes a slot of this size in the tile buffer.
+#define FUSED_ELEMENTWISE_TILE() 512
+
+/*
+    assigns tile slots to results of instructions but the last one, which is written to dst. the slot of a result
+    is reused by following instructions after its last reader, so a chain only needs one slot. slots[k] is -1 for
+    the last instruction. returns the number of slots.
+*/
+static inline int32_t fused_elementwise_assign_tile_slots(
+    const fused_elementwise_inst_t *insts,
+    const int32_t num_src,
+    const int32_t num_insts,
+    int32_t *slots)
+{
+    std::vector<int32_t> last_reader(num_insts, -1);
+    for (int32_t k = 0; k < num_insts; ++k) {
+        const int32_t num_operands = fused_elementwise_is_binary(insts[k].opcode) ? 2 : 1;
+        for (int32_t j = 0; j < num_operands; ++j) {
+            const int32_t v = (j == 0 ? insts[k].src0 : insts[k].src1) - num_src;
+            if (v >= 0 && v < k) {
+                last_reader[v] = k;
+            }
+        }
+    }
+
+    std::vector<int32_t> free_slots;
+    int32_t num_slots = 0;
+    for (int32_t k = 0; k < num_insts; ++k) {
+        // operands read for the last time are released first, elementwise results can overwrite their operands
+        const int32_t num_operands = fused_elementwise_is_binary(insts[k].opcode) ? 2 : 1;
+        for (int32_t j = 0; j < num_operands; ++j) {
+            const int32_t v = (j == 0 ? insts[k].src0 : insts[k].src1) - num_src;
+            if (v >= 0 && v < k && last_reader[v] == k && slots[v] >= 0 &&
+                (j == 0 || insts[k].src0 != insts[k].src1)) {
+                free_slots.push_back(slots[v]);
+            }
+        }
+
+        if (k == num_insts - 1) {
+            slots[k] = -1;
+        } else if (!free_slots.empty()) {
+            slots[k] = free_slots.back();
+            free_slots.pop_back();
+        } else {
+            slots[k] = num_slots++;
+        }
+
+        // results which are never read are dropped at once
+        if (slots[k] >= 0 && last_reader[k] < 0) {
+            free_slots.push_back(slots[k]);
+        }
+    }
+    return num_slots;
+}
+
+template <int32_t _op>
+static inline float fused_elementwise_scalar_kernel_common(const float a, const float b)
+{
+    switch (_op) {
+        case FUSED_ELEMENTWISE_ADD: return a + b;
+        case FUSED_ELEMENTWISE_SUB: return a - b;
+        case FUSED_ELEMENTWISE_MUL: return a * b;
+        case FUSED_ELEMENTWISE_DIV: return a / b;
+        case FUSED_ELEMENTWISE_MAX: return a > b ? a : b;
+        case FUSED_ELEMENTWISE_MIN: return a < b ? a : b;
+        case FUSED_ELEMENTWISE_RELU: return a > 0.0f ? a : 0.0f;
+        case FUSED_ELEMENTWISE_SIGMOID: return 1.0f / (1.0f + expf(-a));
+        case FUSED_ELEMENTWISE_TANH: return tanhf(a);
+        case FUSED_ELEMENTWISE_EXP: return expf(a);
+        case FUSED_ELEMENTWISE_ERF: return erff(a);
+        case FUSED_ELEMENTWISE_ABS: return fabsf(a);
+        case FUSED_ELEMENTWISE_NEG: return -a;
+        case FUSED_ELEMENTWISE_SQRT: return sqrtf(a);
+        default: return 0.0f;
+    }
+}
+
+/*
+    vec_ops provides:
+        vec_t, simd_w
+        load(ptr), store(ptr, v), set1(val)
+        op<_op>(a, b): vectorized fused_elementwise_scalar_kernel_common<_op>
+*/
+template <typename vec_ops, int32_t _op>
+static void fused_elementwise_tile_kernel_common(
+    const float *src0,
+    const bool src0_is_scalar,
+    const float *src1,
+    const bool src1_is_scalar,
+    const int64_t length,
+    float *dst)
+{
+    typedef typename vec_ops::vec_t vec_t;
+    const int64_t simd_w      = vec_ops::simd_w;
+    const int64_t unroll_body = round(length, simd_w * 2);
+
+    if (src0_is_scalar && src1_is_scalar) {
+        const float val = fused_elementwise_scalar_kernel_common<_op>(src0[0], src1[0]);
+        for (int64_t i = 0; i < length; ++i) {
+            dst[i] = val;
+        }
+        return;
+    }
+
+    if (src0_is_scalar) {
+        const vec_t v_src0 = vec_ops::set1(src0[0]);
+        for (int64_t i = 0; i < unroll_body; i += simd_w * 2) {
+            vec_ops::store(dst + i + 0, vec_ops::template op<_op>(v_src0, vec_ops::load(src1 + i + 0)));
+            vec_ops::store(dst + i + simd_w, vec_ops::template op<_op>(v_src0, vec_ops::load(src1 + i + simd_w)));
+        }
+        for (int64_t i = unroll_body; i < length; ++i) {
+            dst[i] = fused_elementwise_scalar_kernel_common<_op>(src0[0], src1[i]);
+        }
+    } else if (src1_is_scalar) {
+        const vec_t v_src1 = vec_ops::set1(src1[0]);
+        for (int64_t i = 0; i < unroll_body; i += simd_w * 2) {
+            vec_ops::store(dst + i + 0, vec_ops::template op<_op>(vec_ops::load(src0 + i + 0), v_src1));
+            vec_ops::store(dst + i + simd_w, vec_ops::template op<_op>(vec_ops::load(src0 + i + simd_w), v_src1));
+        }
+        for (int64_t i = unroll_body; i < length; ++i) {
+            dst[i] = fused_elementwise_scalar_kernel_common<_op>(src0[i], src1[0]);
+        }
+    } else {
+        for (int64_t i = 0; i < unroll_body; i += simd_w * 2) {
+            vec_ops::store(dst + i + 0, vec_ops::template op<_op>(vec_ops::load(src0 + i + 0), vec_ops::load(src1 + i + 0)));
+            vec_ops::store(dst + i + simd_w, vec_ops::template op<_op>(vec_ops::load(src0 + i + simd_w), vec_ops::load(src1 + i + simd_w)));
+        }
+        for (int64_t i = unroll_body; i < length; ++i) {
+            dst[i] = fused_elementwise_scalar_kernel_common<_op>(src0[i], src1[i]);
+        }
+    }
+}
+
+template <typename vec_ops>
+static void fused_elementwise_tile_common(
+    const int64_t tile_offset,
+    const int64_t tile_length,
+    const float **src,
+    const bool *src_is_scalar,
+    const int32_t num_src,
+    const fused_elementwise_inst_t *insts,
+    const int32_t num_insts,
+    const int32_t *slots,
+    float *tile_buffer,
+    float *dst)
+{
+    const int64_t tile = FUSED_ELEMENTWISE_TILE();
+    for (int32_t k = 0; k < num_insts; ++k) {
+        const fused_elementwise_inst_t &inst = insts[k];
+
+        const float *src0;
+        const float *src1;
+        bool src0_is_scalar;
+        bool src1_is_scalar;
+        if (inst.src0 < num_src) {
+            src0_is_scalar = src_is_scalar[inst.src0];
+            src0           = src0_is_scalar ? src[inst.src0] : src[inst.src0] + tile_offset;
+        } else {
+            src0_is_scalar = false;
+            src0           = tile_buffer + slots[inst.src0 - num_src] * tile;
+        }
+        if (!fused_elementwise_is_binary(inst.opcode)) {
+            // unary kernels read src1 the same way as src0 and ignore it
+            src1           = src0;
+            src1_is_scalar = src0_is_scalar;
+        } else if (inst.src1 < num_src) {
+            src1_is_scalar = src_is_scalar[inst.src1];
+            src1           = src1_is_scalar ? src[inst.src1] : src[inst.src1] + tile_offset;
+        } else {
+            src1_is_scalar = false;
+            src1           = tile_buffer + slots[inst.src1 - num_src] * tile;
+        }
+        float *inst_dst = (k == num_insts - 1) ? dst + tile_offset : tile_buffer + slots[k] * tile;
+
+#define _FUSED_ELEMENTWISE_CASE(OP)                                    \
+    case OP:                                                           \
+        fused_elementwise_tile_kernel_common<vec_ops, OP>(             \
+            src0, src0_is_scalar, src1, src1_is_scalar, tile_length, inst_dst); \
+        break
+
+        switch (inst.opcode) {
+            _FUSED_ELEMENTWISE_CASE(FUSED_ELEMENTWISE_ADD);
+            _FUSED_ELEMENTWISE_CASE(FUSED_ELEMENTWISE_SUB);
+            _FUSED_ELEMENTWISE_CASE(FUSED_ELEMENTWISE_MUL);
+            _FUSED_ELEMENTWISE_CASE(FUSED_ELEMENTWISE_DIV);
+            _FUSED_ELEMENTWISE_CASE(FUSED_ELEMENTWISE_MAX);
+            _FUSED_ELEMENTWISE_CASE(FUSED_ELEMENTWISE_MIN);
+            _FUSED_ELEMENTWISE_CASE(FUSED_ELEMENTWISE_RELU);
+            _FUSED_ELEMENTWISE_CASE(FUSED_ELEMENTWISE_SIGMOID);
+            _FUSED_ELEMENTWISE_CASE(FUSED_ELEMENTWISE_TANH);
+            _FUSED_ELEMENTWISE_CASE(FUSED_ELEMENTWISE_EXP);
+            _FUSED_ELEMENTWISE_CASE(FUSED_ELEMENTWISE_ERF);
+            _FUSED_ELEMENTWISE_CASE(FUSED_ELEMENTWISE_ABS);
+            _FUSED_ELEMENTWISE_CASE(FUSED_ELEMENTWISE_NEG);
+            _FUSED_ELEMENTWISE_CASE(FUSED_ELEMENTWISE_SQRT);
+            default: break;
+        }
+#undef _FUSED_ELEMENTWISE_CASE
+    }
+}
+
+template <typename vec_ops>
+ppl::common::RetCode fused_elementwise_fp32_common(
+    const int64_t length,
+    const float **src,
+    const bool *src_is_scalar,
+    const int32_t num_src,
+    const fused_elementwise_inst_t *insts,
+    const int32_t num_insts,
+    void *temp_buffer,
+    float *dst)
+{
+    if (num_insts <= 0) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    for (int32_t k = 0; k < num_insts; ++k) {
+        // results of following instructions are not computed yet
+        const int32_t num_values = num_src + k;
+        if (insts[k].src0 < 0 || insts[k].src0 >= num_values ||
+            (fused_elementwise_is_binary(insts[k].opcode) && (insts[k].src1 < 0 || insts[k].src1 >= num_values))) {
+            return ppl::common::RC_INVALID_VALUE;
+        }
+    }
+
+    std::vector<int32_t> slots(num_insts);
+    const int32_t num_slots = fused_elementwise_assign_tile_slots(insts, num_src, num_insts, slots.data());
+
+    const int64_t tile         = FUSED_ELEMENTWISE_TILE();
+    const int64_t num_tiles    = div_up(length, tile);
+    const int64_t thread_bytes = round_up(num_slots * tile * sizeof(float), PPL_X86_CACHELINE_BYTES());
+
+    PRAGMA_OMP_PARALLEL_FOR()
+    for (int64_t t = 0; t < num_tiles; ++t) {
+        float *tile_buffer = (float*)((uint8_t*)temp_buffer + PPL_OMP_THREAD_ID() * thread_bytes);
+        const int64_t tile_offset = t * tile;
+        const int64_t tile_length = min<int64_t>(tile, length - tile_offset);
+        fused_elementwise_tile_common<vec_ops>(
+            tile_offset, tile_length, src, src_is_scalar, num_src,
+            insts, num_insts, slots.data(), tile_buffer, dst);
+    }
+
+    return ppl::common::RC_SUCCESS;
+}
+
+}}}; // namespace ppl::kernel::x86
+
+#endif
@@ -0,0 +1,167 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef __ST_PPL_KERNEL_X86_COMMON_LAYERNORM_LAYERNORM_COMMON_H_
+#define __ST_PPL_KERNEL_X86_COMMON_LAYERNORM_LAYERNORM_COMMON_H_
+
+#include <math.h>
+
+#include "ppl/kernel/x86/common/internal_include.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+/*
+    vec_ops provides:
+        vec_t, simd_w
+        load(ptr), store(ptr, v), set1(val)
+        add(a, b), sub(a, b), mul(a, b), fmadd(a, b, c): a * b + c
+*/
+template <typename vec_ops>
+static void layernorm_row_mean_var_common(
+    const float *src,
+    const int64_t length,
+    float *mean,
+    float *var)
+{
+    typedef typename vec_ops::vec_t vec_t;
+    const int64_t simd_w   = vec_ops::simd_w;
+    const int64_t unroll_n = 2 * simd_w;
+    const int64_t body     = round(length, unroll_n);
+
+    // every lane runs Welford's algorithm on its own elements. all lanes have the same count.
+    vec_t v_mean0 = vec_ops::set1(0.0f);
+    vec_t v_mean1 = vec_ops::set1(0.0f);
+    vec_t v_m2_0  = vec_ops::set1(0.0f);
+    vec_t v_m2_1  = vec_ops::set1(0.0f);
+    int64_t lane_count = 0;
+    for (int64_t i = 0; i < body; i += unroll_n) {
+        ++lane_count;
+        const vec_t v_rcp = vec_ops::set1(1.0f / lane_count);
+        const vec_t v_x0  = vec_ops::load(src + i + 0 * simd_w);
+        const vec_t v_x1  = vec_ops::load(src + i + 1 * simd_w);
+        const vec_t v_d0  = vec_ops::sub(v_x0, v_mean0);
+        const vec_t v_d1  = vec_ops::sub(v_x1, v_mean1);
+        v_mean0           = vec_ops::fmadd(v_d0, v_rcp, v_mean0);
+        v_mean1           = vec_ops::fmadd(v_d1, v_rcp, v_mean1);
+        v_m2_0            = vec_ops::fmadd(v_d0, vec_ops::sub(v_x0, v_mean0), v_m2_0);
+        v_m2_1            = vec_ops::fmadd(v_d1, vec_ops::sub(v_x1, v_mean1), v_m2_1);
+    }
+
+    // merges lanes with Chan's formula
+    double count = 0.0, m = 0.0, m2 = 0.0;
+    if (lane_count > 0) {
+        float lane_mean[unroll_n];
+        float lane_m2[unroll_n];
+        vec_ops::store(lane_mean + 0 * simd_w, v_mean0);
+        vec_ops::store(lane_mean + 1 * simd_w, v_mean1);
+        vec_ops::store(lane_m2 + 0 * simd_w, v_m2_0);
+        vec_ops::store(lane_m2 + 1 * simd_w, v_m2_1);
+        for (int64_t l = 0; l < unroll_n; ++l) {
+            m += lane_mean[l];
+        }
+        m /= unroll_n;
+        for (int64_t l = 0; l < unroll_n; ++l) {
+            const double d = lane_mean[l] - m;
+            m2 += lane_m2[l] + lane_count * d * d;
+        }
+        count = (double)lane_count * unroll_n;
+    }
+
+    for (int64_t i = body; i < length; ++i) {
+        count += 1.0;
+        const double d = src[i] - m;
+        m += d / count;
+        m2 += d * (src[i] - m);
+    }
+
+    *mean = (float)m;
+    *var  = (float)(m2 / count);
+}
+
+template <typename vec_ops>
+ppl::common::RetCode layernorm_ndarray_fp32_common(
+    const ppl::nn::TensorShape *src_shape,
+    const float *src,
+    const float *scale,
+    const float *shift,
+    const int64_t axis,
+    const float eps,
+    float *dst)
+{
+    typedef typename vec_ops::vec_t vec_t;
+    const int64_t simd_w = vec_ops::simd_w;
+
+    const int64_t dim_count = src_shape->GetDimCount();
+    const int64_t real_axis = axis < 0 ? axis + dim_count : axis;
+    if (real_axis < 0 || real_axis >= dim_count) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+
+    int64_t outer_dim = 1;
+    int64_t inner_dim = 1;
+    for (int64_t i = 0; i < real_axis; ++i) {
+        outer_dim *= src_shape->GetDim(i);
+    }
+    for (int64_t i = real_axis; i < dim_count; ++i) {
+        inner_dim *= src_shape->GetDim(i);
+    }
+    const int64_t body = round(inner_dim, simd_w);
+
+    PRAGMA_OMP_PARALLEL_FOR()
+    for (int64_t o = 0; o < outer_dim; ++o) {
+        const float *p_src = src + o * inner_dim;
+        float *p_dst       = dst + o * inner_dim;
+
+        float mean, var;
+        layernorm_row_mean_var_common<vec_ops>(p_src, inner_dim, &mean, &var);
+        const float rstd = 1.0f / sqrtf(var + eps);
+
+        // dst = src * (rstd * scale) + (shift - mean * rstd * scale)
+        const vec_t v_rstd = vec_ops::set1(rstd);
+        const vec_t v_nmr  = vec_ops::set1(-mean * rstd);
+        if (scale) {
+            for (int64_t i = 0; i < body; i += simd_w) {
+                const vec_t v_a = vec_ops::mul(v_rstd, vec_ops::load(scale + i));
+                vec_t v_b       = vec_ops::mul(v_nmr, vec_ops::load(scale + i));
+                if (shift) {
+                    v_b = vec_ops::add(v_b, vec_ops::load(shift + i));
+                }
+                vec_ops::store(p_dst + i, vec_ops::fmadd(vec_ops::load(p_src + i), v_a, v_b));
+            }
+            for (int64_t i = body; i < inner_dim; ++i) {
+                p_dst[i] = (p_src[i] - mean) * rstd * scale[i] + (shift ? shift[i] : 0.0f);
+            }
+        } else {
+            for (int64_t i = 0; i < body; i += simd_w) {
+                vec_t v_b = v_nmr;
+                if (shift) {
+                    v_b = vec_ops::add(v_b, vec_ops::load(shift + i));
+                }
+                vec_ops::store(p_dst + i, vec_ops::fmadd(vec_ops::load(p_src + i), v_rstd, v_b));
+            }
+            for (int64_t i = body; i < inner_dim; ++i) {
+                p_dst[i] = (p_src[i] - mean) * rstd + (shift ? shift[i] : 0.0f);
+            }
+        }
+    }
+
+    return ppl::common::RC_SUCCESS;
+}
+
+}}}; // namespace ppl::kernel::x86
+
+#endif
@@ -0,0 +1,427 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef __ST_PPL_KERNEL_X86_COMMON_MULTI_HEAD_ATTENTION_MULTI_HEAD_ATTENTION_COMMON_H_
+#define __ST_PPL_KERNEL_X86_COMMON_MULTI_HEAD_ATTENTION_MULTI_HEAD_ATTENTION_COMMON_H_
+
+#include <math.h>
+#include <float.h>
+#include <string.h>
+
+#include "ppl/kernel/x86/common/internal_include.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+// queries of a block share the same key/value tiles, which stay in L1/L2 cache
+#define MHA_Q_BLK() 16
+#define MHA_KV_TILE() 64
+// rows of queries computed by a micro-kernel, each row takes 2 vector registers of accumulators
+#define MHA_MR() 4
+
+/*
+    keys and values of a head are strided by num_heads * head_dim, so that they are packed before the attention:
+        k_trans:  [batch * num_heads, num_kv_tiles, head_dim, kv_tile], padded columns are zeros
+        v_packed: [batch * num_heads, seqlen_kv, head_dim]
+    buffer of a thread:
+        acc:      [q_blk, head_dim], unnormalized outputs
+        scores:   [q_blk, kv_tile], scores and probabilities of the current tile
+*/
+inline uint64_t multi_head_attention_packed_bytes_common(
+    const int64_t batch,
+    const int64_t seqlen_kv,
+    const int64_t num_heads,
+    const int64_t head_dim)
+{
+    const int64_t k_floats = batch * num_heads * div_up(seqlen_kv, MHA_KV_TILE()) * head_dim * MHA_KV_TILE();
+    const int64_t v_floats = batch * num_heads * seqlen_kv * head_dim;
+    return round_up(k_floats * sizeof(float), PPL_X86_CACHELINE_BYTES()) +
+           round_up(v_floats * sizeof(float), PPL_X86_CACHELINE_BYTES());
+}
+
+inline uint64_t multi_head_attention_thread_buffer_bytes_common(const int64_t head_dim)
+{
+    const int64_t floats = MHA_Q_BLK() * head_dim + MHA_Q_BLK() * MHA_KV_TILE();
+    return round_up(floats * sizeof(float), PPL_X86_CACHELINE_BYTES());
+}
+
+/*
+    vec_ops provides:
+        vec_t, simd_w
+        load(ptr), store(ptr, v), set1(val)
+        add(a, b), sub(a, b), mul(a, b), max(a, b), fmadd(a, b, c): a * b + c
+        exp(a), reduce_add(a), reduce_max(a)
+*/
+
+// scores[r][j..j + 2 * simd_w) = q[r] * k_trans[:, j..j + 2 * simd_w) * scale, for _rows rows
+template <typename vec_ops, int32_t _rows>
+static inline void multi_head_attention_qk_kernel_common(
+    const float *q,
+    const int64_t q_stride,
+    const float *k_trans,
+    const int64_t head_dim,
+    const float scale,
+    float *scores)
+{
+    typedef typename vec_ops::vec_t vec_t;
+    const int64_t simd_w = vec_ops::simd_w;
+
+    vec_t v_acc00, v_acc01, v_acc10, v_acc11, v_acc20, v_acc21, v_acc30, v_acc31;
+    v_acc00 = vec_ops::set1(0.0f);
+    v_acc01 = vec_ops::set1(0.0f);
+    if (_rows > 1) {
+        v_acc10 = vec_ops::set1(0.0f);
+        v_acc11 = vec_ops::set1(0.0f);
+    }
+    if (_rows > 2) {
+        v_acc20 = vec_ops::set1(0.0f);
+        v_acc21 = vec_ops::set1(0.0f);
+    }
+    if (_rows > 3) {
+        v_acc30 = vec_ops::set1(0.0f);
+        v_acc31 = vec_ops::set1(0.0f);
+    }
+    for (int64_t d = 0; d < head_dim; ++d) {
+        const vec_t v_k0 = vec_ops::load(k_trans + d * MHA_KV_TILE() + 0 * simd_w);
+        const vec_t v_k1 = vec_ops::load(k_trans + d * MHA_KV_TILE() + 1 * simd_w);
+        vec_t v_q        = vec_ops::set1(q[0 * q_stride + d]);
+        v_acc00          = vec_ops::fmadd(v_q, v_k0, v_acc00);
+        v_acc01          = vec_ops::fmadd(v_q, v_k1, v_acc01);
+        if (_rows > 1) {
+            v_q     = vec_ops::set1(q[1 * q_stride + d]);
+            v_acc10 = vec_ops::fmadd(v_q, v_k0, v_acc10);
+            v_acc11 = vec_ops::fmadd(v_q, v_k1, v_acc11);
+        }
+        if (_rows > 2) {
+            v_q     = vec_ops::set1(q[2 * q_stride + d]);
+            v_acc20 = vec_ops::fmadd(v_q, v_k0, v_acc20);
+            v_acc21 = vec_ops::fmadd(v_q, v_k1, v_acc21);
+        }
+        if (_rows > 3) {
+            v_q     = vec_ops::set1(q[3 * q_stride + d]);
+            v_acc30 = vec_ops::fmadd(v_q, v_k0, v_acc30);
+            v_acc31 = vec_ops::fmadd(v_q, v_k1, v_acc31);
+        }
+    }
+    const vec_t v_scale = vec_ops::set1(scale);
+    vec_ops::store(scores + 0 * MHA_KV_TILE() + 0 * simd_w, vec_ops::mul(v_acc00, v_scale));
+    vec_ops::store(scores + 0 * MHA_KV_TILE() + 1 * simd_w, vec_ops::mul(v_acc01, v_scale));
+    if (_rows > 1) {
+        vec_ops::store(scores + 1 * MHA_KV_TILE() + 0 * simd_w, vec_ops::mul(v_acc10, v_scale));
+        vec_ops::store(scores + 1 * MHA_KV_TILE() + 1 * simd_w, vec_ops::mul(v_acc11, v_scale));
+    }
+    if (_rows > 2) {
+        vec_ops::store(scores + 2 * MHA_KV_TILE() + 0 * simd_w, vec_ops::mul(v_acc20, v_scale));
+        vec_ops::store(scores + 2 * MHA_KV_TILE() + 1 * simd_w, vec_ops::mul(v_acc21, v_scale));
+    }
+    if (_rows > 3) {
+        vec_ops::store(scores + 3 * MHA_KV_TILE() + 0 * simd_w, vec_ops::mul(v_acc30, v_scale));
+        vec_ops::store(scores + 3 * MHA_KV_TILE() + 1 * simd_w, vec_ops::mul(v_acc31, v_scale));
+    }
+}
+
+// acc[r][0.._nvec * simd_w) = acc[r][...] * correct[r] + probs[r][0..kv_len) * v[0..kv_len)[...], for _rows rows
+template <typename vec_ops, int32_t _rows, int32_t _nvec>
+static inline void multi_head_attention_pv_kernel_common(
+    const float *probs,
+    const float *v,
+    const int64_t v_stride,
+    const int64_t kv_len,
+    const float *correct,
+    const int64_t head_dim,
+    float *acc)
+{
+    typedef typename vec_ops::vec_t vec_t;
+    const int64_t simd_w = vec_ops::simd_w;
+
+    vec_t v_sum00, v_sum01, v_sum10, v_sum11, v_sum20, v_sum21, v_sum30, v_sum31;
+    v_sum00 = vec_ops::set1(0.0f);
+    if (_nvec > 1) v_sum01 = vec_ops::set1(0.0f);
+    if (_rows > 1) {
+        v_sum10 = vec_ops::set1(0.0f);
+        if (_nvec > 1) v_sum11 = vec_ops::set1(0.0f);
+    }
+    if (_rows > 2) {
+        v_sum20 = vec_ops::set1(0.0f);
+        if (_nvec > 1) v_sum21 = vec_ops::set1(0.0f);
+    }
+    if (_rows > 3) {
+        v_sum30 = vec_ops::set1(0.0f);
+        if (_nvec > 1) v_sum31 = vec_ops::set1(0.0f);
+    }
+    for (int64_t j = 0; j < kv_len; ++j) {
+        vec_t v_v1;
+        const vec_t v_v0 = vec_ops::load(v + j * v_stride + 0 * simd_w);
+        if (_nvec > 1) v_v1 = vec_ops::load(v + j * v_stride + 1 * simd_w);
+        vec_t v_p = vec_ops::set1(probs[0 * MHA_KV_TILE() + j]);
+        v_sum00   = vec_ops::fmadd(v_p, v_v0, v_sum00);
+        if (_nvec > 1) v_sum01 = vec_ops::fmadd(v_p, v_v1, v_sum01);
+        if (_rows > 1) {
+            v_p     = vec_ops::set1(probs[1 * MHA_KV_TILE() + j]);
+            v_sum10 = vec_ops::fmadd(v_p, v_v0, v_sum10);
+            if (_nvec > 1) v_sum11 = vec_ops::fmadd(v_p, v_v1, v_sum11);
+        }
+        if (_rows > 2) {
+            v_p     = vec_ops::set1(probs[2 * MHA_KV_TILE() + j]);
+            v_sum20 = vec_ops::fmadd(v_p, v_v0, v_sum20);
+            if (_nvec > 1) v_sum21 = vec_ops::fmadd(v_p, v_v1, v_sum21);
+        }
+        if (_rows > 3) {
+            v_p     = vec_ops::set1(probs[3 * MHA_KV_TILE() + j]);
+            v_sum30 = vec_ops::fmadd(v_p, v_v0, v_sum30);
+            if (_nvec > 1) v_sum31 = vec_ops::fmadd(v_p, v_v1, v_sum31);
+        }
+    }
+
+#define _MHA_PV_STORE(R, N, SUM)                                                      \
+    do {                                                                              \
+        float *p_acc = acc + R * head_dim + N * simd_w;                               \
+        vec_ops::store(p_acc, vec_ops::fmadd(vec_ops::load(p_acc), v_correct, SUM)); \
+    } while (0)
+    vec_t v_correct = vec_ops::set1(correct[0]);
+    _MHA_PV_STORE(0, 0, v_sum00);
+    if (_nvec > 1) _MHA_PV_STORE(0, 1, v_sum01);
+    if (_rows > 1) {
+        v_correct = vec_ops::set1(correct[1]);
+        _MHA_PV_STORE(1, 0, v_sum10);
+        if (_nvec > 1) _MHA_PV_STORE(1, 1, v_sum11);
+    }
+    if (_rows > 2) {
+        v_correct = vec_ops::set1(correct[2]);
+        _MHA_PV_STORE(2, 0, v_sum20);
+        if (_nvec > 1) _MHA_PV_STORE(2, 1, v_sum21);
+    }
+    if (_rows > 3) {
+        v_correct = vec_ops::set1(correct[3]);
+        _MHA_PV_STORE(3, 0, v_sum30);
+        if (_nvec > 1) _MHA_PV_STORE(3, 1, v_sum31);
+    }
+#undef _MHA_PV_STORE
+}
+
+template <typename vec_ops, int32_t _rows>
+static inline void multi_head_attention_pv_rows_common(
+    const float *probs,
+    const float *v,
+    const int64_t v_stride,
+    const int64_t kv_len,
+    const float *correct,
+    const int64_t head_dim,
+    float *acc)
+{
+    const int64_t simd_w = vec_ops::simd_w;
+    int64_t d            = 0;
+    for (; d + 2 * simd_w <= head_dim; d += 2 * simd_w) {
+        multi_head_attention_pv_kernel_common<vec_ops, _rows, 2>(
+            probs, v + d, v_stride, kv_len, correct, head_dim, acc + d);
+    }
+    if (d + simd_w <= head_dim) {
+        multi_head_attention_pv_kernel_common<vec_ops, _rows, 1>(
+            probs, v + d, v_stride, kv_len, correct, head_dim, acc + d);
+        d += simd_w;
+    }
+    for (; d < head_dim; ++d) {
+        for (int32_t r = 0; r < _rows; ++r) {
+            float sum = 0.0f;
+            for (int64_t j = 0; j < kv_len; ++j) {
+                sum += probs[r * MHA_KV_TILE() + j] * v[j * v_stride + d];
+            }
+            acc[r * head_dim + d] = acc[r * head_dim + d] * correct[r] + sum;
+        }
+    }
+}
+
+template <typename vec_ops>
+ppl::common::RetCode multi_head_attention_fp32_common(
+    const float *q,
+    const float *k,
+    const float *v,
+    const float *mask,
+    const int64_t batch,
+    const int64_t seqlen_q,
+    const int64_t seqlen_kv,
+    const int64_t num_heads,
+    const int64_t head_dim,
+    const int64_t mask_batch_stride,
+    const float scale,
+    void *temp_buffer,
+    float *dst)
+{
+    typedef typename vec_ops::vec_t vec_t;
+    const int64_t simd_w = vec_ops::simd_w;
+
+    if (batch <= 0 || seqlen_q <= 0 || seqlen_kv <= 0 || num_heads <= 0 || head_dim <= 0) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+
+    const int64_t hidden        = num_heads * head_dim;
+    const int64_t num_kv_tiles  = div_up(seqlen_kv, MHA_KV_TILE());
+    const int64_t num_q_blk     = div_up(seqlen_q, MHA_Q_BLK());
+    const int64_t num_tasks     = batch * num_heads * num_q_blk;
+    const uint64_t thread_bytes = multi_head_attention_thread_buffer_bytes_common(head_dim);
+
+    float *k_trans  = (float*)temp_buffer;
+    float *v_packed = k_trans + round_up(num_kv_tiles * head_dim * MHA_KV_TILE() * batch * num_heads,
+                                         PPL_X86_CACHELINE_BYTES() / sizeof(float));
+    uint8_t *thread_buffer = (uint8_t*)temp_buffer +
+                             multi_head_attention_packed_bytes_common(batch, seqlen_kv, num_heads, head_dim);
+
+    PRAGMA_OMP_PARALLEL_FOR()
+    for (int64_t t = 0; t < batch * num_heads * num_kv_tiles; ++t) {
+        const int64_t bh      = t / num_kv_tiles;
+        const int64_t kv_beg  = t % num_kv_tiles * MHA_KV_TILE();
+        const int64_t kv_len  = min<int64_t>(seqlen_kv - kv_beg, MHA_KV_TILE());
+        const int64_t offset  = ((bh / num_heads) * seqlen_kv + kv_beg) * hidden + (bh % num_heads) * head_dim;
+        float *k_trans_tile   = k_trans + t * head_dim * MHA_KV_TILE();
+        float *v_packed_tile  = v_packed + (bh * seqlen_kv + kv_beg) * head_dim;
+        for (int64_t j = 0; j < kv_len; ++j) {
+            const float *k_row = k + offset + j * hidden;
+            for (int64_t d = 0; d < head_dim; ++d) {
+                k_trans_tile[d * MHA_KV_TILE() + j] = k_row[d];
+            }
+            memcpy(v_packed_tile + j * head_dim, v + offset + j * hidden, head_dim * sizeof(float));
+        }
+        for (int64_t d = 0; d < head_dim; ++d) {
+            for (int64_t j = kv_len; j < MHA_KV_TILE(); ++j) {
+                k_trans_tile[d * MHA_KV_TILE() + j] = 0.0f;
+            }
+        }
+    }
+
+    PRAGMA_OMP_PARALLEL_FOR()
+    for (int64_t t = 0; t < num_tasks; ++t) {
+        const int64_t b     = t / (num_heads * num_q_blk);
+        const int64_t h     = t / num_q_blk % num_heads;
+        const int64_t q_beg = t % num_q_blk * MHA_Q_BLK();
+        const int64_t q_len = min<int64_t>(seqlen_q - q_beg, MHA_Q_BLK());
+
+        float *acc    = (float*)(thread_buffer + PPL_OMP_THREAD_ID() * thread_bytes);
+        float *scores = acc + MHA_Q_BLK() * head_dim;
+        float row_max[MHA_Q_BLK()];
+        float row_sum[MHA_Q_BLK()];
+        float correct[MHA_Q_BLK()];
+        for (int64_t r = 0; r < q_len; ++r) {
+            row_max[r] = -FLT_MAX;
+            row_sum[r] = 0.0f;
+        }
+        memset(acc, 0, q_len * head_dim * sizeof(float));
+
+        const float *q_blk  = q + (b * seqlen_q + q_beg) * hidden + h * head_dim;
+        const float *p_mask = mask ? mask + b * mask_batch_stride : nullptr;
+        for (int64_t kv_beg = 0; kv_beg < seqlen_kv; kv_beg += MHA_KV_TILE()) {
+            const int64_t kv_len      = min<int64_t>(seqlen_kv - kv_beg, MHA_KV_TILE());
+            const int64_t kv_pad      = round_up(kv_len, 2 * simd_w);
+            const int64_t kv_body     = round(kv_len, simd_w);
+            const float *k_trans_tile =
+                k_trans + ((b * num_heads + h) * num_kv_tiles + kv_beg / MHA_KV_TILE()) * head_dim * MHA_KV_TILE();
+            const float *v_tile       = v_packed + ((b * num_heads + h) * seqlen_kv + kv_beg) * head_dim;
+
+            for (int64_t r = 0; r < q_len; r += MHA_MR()) {
+                const int64_t rows = min<int64_t>(q_len - r, MHA_MR());
+                for (int64_t j = 0; j < kv_pad; j += 2 * simd_w) {
+#define _MHA_QK_KERNEL(ROWS)                                             \
+    case ROWS:                                                           \
+        multi_head_attention_qk_kernel_common<vec_ops, ROWS>(            \
+            q_blk + r * hidden, hidden, k_trans_tile + j, head_dim, scale, \
+            scores + r * MHA_KV_TILE() + j);                             \
+        break
+                    switch (rows) {
+                        _MHA_QK_KERNEL(1);
+                        _MHA_QK_KERNEL(2);
+                        _MHA_QK_KERNEL(3);
+                        _MHA_QK_KERNEL(4);
+                    }
+#undef _MHA_QK_KERNEL
+                }
+            }
+
+            // online softmax: rescales previous results when a larger score is found
+            for (int64_t r = 0; r < q_len; ++r) {
+                float *row  = scores + r * MHA_KV_TILE();
+                vec_t v_max = vec_ops::set1(-FLT_MAX);
+                for (int64_t j = 0; j < kv_body; j += simd_w) {
+                    vec_t v_s = vec_ops::load(row + j);
+                    if (p_mask) {
+                        v_s = vec_ops::add(v_s, vec_ops::load(p_mask + kv_beg + j));
+                        vec_ops::store(row + j, v_s);
+                    }
+                    v_max = vec_ops::max(v_max, v_s);
+                }
+                float tile_max = vec_ops::reduce_max(v_max);
+                for (int64_t j = kv_body; j < kv_len; ++j) {
+                    if (p_mask) {
+                        row[j] += p_mask[kv_beg + j];
+                    }
+                    tile_max = max(tile_max, row[j]);
+                }
+
+                const float new_max = max(row_max[r], tile_max);
+                const vec_t v_new_max = vec_ops::set1(new_max);
+                vec_t v_sum         = vec_ops::set1(0.0f);
+                for (int64_t j = 0; j < kv_body; j += simd_w) {
+                    const vec_t v_p = vec_ops::exp(vec_ops::sub(vec_ops::load(row + j), v_new_max));
+                    vec_ops::store(row + j, v_p);
+                    v_sum = vec_ops::add(v_sum, v_p);
+                }
+                float tile_sum = vec_ops::reduce_add(v_sum);
+                for (int64_t j = kv_body; j < kv_len; ++j) {
+                    row[j] = expf(row[j] - new_max);
+                    tile_sum += row[j];
+                }
+                correct[r] = expf(row_max[r] - new_max);
+                row_sum[r] = row_sum[r] * correct[r] + tile_sum;
+                row_max[r] = new_max;
+            }
+
+            for (int64_t r = 0; r < q_len; r += MHA_MR()) {
+                const int64_t rows = min<int64_t>(q_len - r, MHA_MR());
+#define _MHA_PV_ROWS(ROWS)                                                    \
+    case ROWS:                                                                \
+        multi_head_attention_pv_rows_common<vec_ops, ROWS>(                   \
+            scores + r * MHA_KV_TILE(), v_tile, head_dim, kv_len, correct + r, \
+            head_dim, acc + r * head_dim);                                    \
+        break
+                switch (rows) {
+                    _MHA_PV_ROWS(1);
+                    _MHA_PV_ROWS(2);
+                    _MHA_PV_ROWS(3);
+                    _MHA_PV_ROWS(4);
+                }
+#undef _MHA_PV_ROWS
+            }
+        }
+
+        for (int64_t r = 0; r < q_len; ++r) {
+            float *dst_row       = dst + (b * seqlen_q + q_beg + r) * hidden + h * head_dim;
+            const float *acc_row = acc + r * head_dim;
+            const float rcp_sum  = row_sum[r] > 0.0f ? 1.0f / row_sum[r] : 0.0f;
+            const vec_t v_rcp    = vec_ops::set1(rcp_sum);
+            int64_t i            = 0;
+            for (; i + simd_w <= head_dim; i += simd_w) {
+                vec_ops::store(dst_row + i, vec_ops::mul(vec_ops::load(acc_row + i), v_rcp));
+            }
+            for (; i < head_dim; ++i) {
+                dst_row[i] = acc_row[i] * rcp_sum;
+            }
+        }
+    }
+
+    return ppl::common::RC_SUCCESS;
+}
+
+}}}; // namespace ppl::kernel::x86
+
+#endif
@@ -51,10 +51,43 @@ void set_omp_core_binding(const int32_t *cores, const int32_t num_cores, const i
 #endif
 }
 
+void set_omp_core_affinity(const int32_t *cores, const int32_t num_cores, const bool pin_threads)
+{
+    if (num_cores <= 0) {
+        return;
+    }
+#if defined(__linux__)
+    PRAGMA_OMP_PARALLEL()
+    {
+        int32_t omp_tid = PPL_OMP_THREAD_ID();
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        if (pin_threads) {
+            CPU_SET(cores[omp_tid % num_cores], &cpuset);
+        } else {
+            for (int32_t i = 0; i < num_cores; ++i) {
+                CPU_SET(cores[i], &cpuset);
+            }
+        }
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) != 0) {
+            LOG(ERROR) << "Core binding failed";
+        }
+    }
+#endif
+}
+
 int32_t get_omp_max_threads()
 {
     return PPL_OMP_MAX_THREADS();
 }
+
+void set_omp_max_threads(const int32_t num_threads)
+{
+#ifdef PPL_USE_X86_OMP
+    omp_set_num_threads(num_threads);
+#endif
+}
+
 // A very naive version
 single_parallel_loop_config_t select_single_parallel_loop(
     const std::vector<int64_t> &iter_of_loop,
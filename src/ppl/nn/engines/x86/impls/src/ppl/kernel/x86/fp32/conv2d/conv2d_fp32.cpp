@@ -429,4 +429,77 @@ conv2d_fp32_manager *conv2d_algo_selector::gen_algo(const conv2d_fp32_param &par
     return nullptr;
 }
 
+std::vector<conv2d_fp32_algo_info> conv2d_algo_selector::get_supported_algos(const ppl::common::dataformat_t src_format, const conv2d_fp32_param &param, const ppl::common::isa_t isa_flags)
+{
+    static const conv2d_fp32_algo_info candidates[] = {
+#ifdef PPL_USE_X86_AVX512
+        {conv2d_fp32_algo::DIRECT, ppl::common::ISA_X86_AVX512, ppl::common::DATAFORMAT_NDARRAY, ppl::common::DATAFORMAT_N16CX},
+        {conv2d_fp32_algo::DEPTHWISE, ppl::common::ISA_X86_AVX512, ppl::common::DATAFORMAT_N16CX, ppl::common::DATAFORMAT_N16CX},
+        {conv2d_fp32_algo::GEMM_DIRECT, ppl::common::ISA_X86_AVX512, ppl::common::DATAFORMAT_N16CX, ppl::common::DATAFORMAT_N16CX},
+        {conv2d_fp32_algo::WINOGRAD_B4F3, ppl::common::ISA_X86_AVX512, ppl::common::DATAFORMAT_N16CX, ppl::common::DATAFORMAT_N16CX},
+        {conv2d_fp32_algo::DIRECT, ppl::common::ISA_X86_AVX512, ppl::common::DATAFORMAT_N16CX, ppl::common::DATAFORMAT_N16CX},
+#endif
+        {conv2d_fp32_algo::DIRECT, ppl::common::ISA_X86_FMA, ppl::common::DATAFORMAT_NDARRAY, ppl::common::DATAFORMAT_N16CX},
+        {conv2d_fp32_algo::DEPTHWISE, ppl::common::ISA_X86_FMA, ppl::common::DATAFORMAT_N16CX, ppl::common::DATAFORMAT_N16CX},
+        {conv2d_fp32_algo::GEMM_DIRECT, ppl::common::ISA_X86_FMA, ppl::common::DATAFORMAT_N16CX, ppl::common::DATAFORMAT_N16CX},
+        {conv2d_fp32_algo::WINOGRAD_B4F3, ppl::common::ISA_X86_FMA, ppl::common::DATAFORMAT_N16CX, ppl::common::DATAFORMAT_N16CX},
+        {conv2d_fp32_algo::DIRECT, ppl::common::ISA_X86_FMA, ppl::common::DATAFORMAT_N16CX, ppl::common::DATAFORMAT_N16CX},
+        {conv2d_fp32_algo::IM2COL_GEMM, ppl::common::ISA_X86_FMA, ppl::common::DATAFORMAT_NDARRAY, ppl::common::DATAFORMAT_NDARRAY},
+        {conv2d_fp32_algo::DEPTHWISE, ppl::common::ISA_X86_SSE, ppl::common::DATAFORMAT_NDARRAY, ppl::common::DATAFORMAT_NDARRAY},
+        {conv2d_fp32_algo::IM2COL_GEMM, ppl::common::ISA_X86_SSE, ppl::common::DATAFORMAT_NDARRAY, ppl::common::DATAFORMAT_NDARRAY},
+    };
+
+    std::vector<conv2d_fp32_algo_info> algos;
+
+    auto default_info = select_algo(src_format, param, isa_flags);
+    if (default_info.algo_type == conv2d_fp32_algo::UNKNOWN) {
+        return algos;
+    }
+    algos.push_back(default_info);
+
+    const bool is_winograd_b4f3_applicable = true &&
+        !param.is_depthwise() &&
+        param.kernel_h == 3 && param.kernel_w == 3 &&
+        param.stride_h == 1 && param.stride_w == 1 &&
+        param.dilation_h == 1 && param.dilation_w == 1;
+
+    for (uint64_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); ++i) {
+        const conv2d_fp32_algo_info &info = candidates[i];
+        if (!(info.isa & isa_flags)) {
+            continue;
+        }
+        if (info.input_format == ppl::common::DATAFORMAT_NDARRAY && src_format != ppl::common::DATAFORMAT_NDARRAY) {
+            continue;
+        }
+        // same preconditions as select_algo()
+        if (info.algo_type == conv2d_fp32_algo::DEPTHWISE && !param.is_depthwise()) {
+            continue;
+        }
+        if (info.algo_type == conv2d_fp32_algo::GEMM_DIRECT && !param.is_pointwise()) {
+            continue;
+        }
+        if (info.algo_type == conv2d_fp32_algo::WINOGRAD_B4F3 && !is_winograd_b4f3_applicable) {
+            continue;
+        }
+        if (info.algo_type == default_info.algo_type &&
+            info.isa == default_info.isa &&
+            info.input_format == default_info.input_format &&
+            info.output_format == default_info.output_format) {
+            continue;
+        }
+
+        auto mgr = gen_algo(param, info, nullptr);
+        if (!mgr) {
+            continue;
+        }
+        bool supported = mgr->is_supported();
+        delete mgr;
+        if (supported) {
+            algos.push_back(info);
+        }
+    }
+
+    return algos;
+}
+
 }}}; // namespace ppl::kernel::x86
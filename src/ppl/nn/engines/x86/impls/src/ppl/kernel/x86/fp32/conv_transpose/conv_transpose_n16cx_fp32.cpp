@@ -0,0 +1,112 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <string.h>
+
+#include "ppl/kernel/x86/fp32/conv_transpose/conv_transpose_n16cx_fp32_common.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+bool conv_transpose_n16cx_fp32_is_supported(
+    const ppl::common::isa_t isa,
+    const conv_transpose_n16cx_fp32_param &param)
+{
+    if (!(isa & ppl::common::ISA_X86_FMA)) {
+        return false;
+    }
+    if (param.kernel_h <= 0 || param.kernel_w <= 0 || param.stride_h <= 0 || param.stride_w <= 0) {
+        return false;
+    }
+    if (param.pad_h < 0 || param.pad_w < 0 || param.channels <= 0 || param.num_output <= 0) {
+        return false;
+    }
+    return param.fuse_flag == conv_fuse_flag::NONE ||
+           param.fuse_flag == conv_fuse_flag::RELU ||
+           param.fuse_flag == conv_fuse_flag::RELU6;
+}
+
+uint64_t conv_transpose_n16cx_fp32_get_packed_weight_bytes(
+    const conv_transpose_n16cx_fp32_param &param)
+{
+    // taps of all phases add up to kernel_h * kernel_w
+    const int64_t padded_oc = round_up(param.num_output, CONV_TRANSPOSE_N16CX_CH_DT_BLK());
+    const int64_t padded_ic = round_up(param.channels, CONV_TRANSPOSE_N16CX_CH_DT_BLK());
+    return (padded_oc + padded_oc * padded_ic * param.kernel_h * param.kernel_w) * sizeof(float);
+}
+
+ppl::common::RetCode conv_transpose_n16cx_fp32_pack_weight(
+    const conv_transpose_n16cx_fp32_param &param,
+    const float *weight,
+    const float *bias,
+    float *packed_weight)
+{
+    const int64_t ch_dt_blk = CONV_TRANSPOSE_N16CX_CH_DT_BLK();
+    const int64_t padded_oc = round_up(param.num_output, ch_dt_blk);
+    const int64_t padded_ic = round_up(param.channels, ch_dt_blk);
+    const int64_t kernel_hw = param.kernel_h * param.kernel_w;
+
+    memset(packed_weight, 0, conv_transpose_n16cx_fp32_get_packed_weight_bytes(param));
+    if (bias) {
+        memcpy(packed_weight, bias, param.num_output * sizeof(float));
+    }
+
+    std::vector<conv_transpose_n16cx_fp32_phase> phases;
+    conv_transpose_n16cx_fp32_init_phases(param, 0, 0, &phases);
+
+    for (size_t p = 0; p < phases.size(); ++p) {
+        const auto &ph      = phases[p];
+        const int64_t sub_h = ph.h.sub_kernel;
+        const int64_t sub_w = ph.w.sub_kernel;
+        if (sub_h == 0 || sub_w == 0) {
+            continue;
+        }
+        const int64_t flt_icb_stride = sub_h * sub_w * ch_dt_blk * ch_dt_blk;
+        const int64_t flt_ocb_stride = padded_ic * sub_h * sub_w * ch_dt_blk;
+        PRAGMA_OMP_PARALLEL_FOR()
+        for (int64_t oc = 0; oc < param.num_output; ++oc) {
+            float *l_flt = packed_weight + ph.flt_offset + (oc / ch_dt_blk) * flt_ocb_stride + oc % ch_dt_blk;
+            for (int64_t ic = 0; ic < param.channels; ++ic) {
+                const float *l_weight = weight + (ic * param.num_output + oc) * kernel_hw;
+                float *ic_flt         = l_flt + (ic / ch_dt_blk) * flt_icb_stride + (ic % ch_dt_blk) * ch_dt_blk;
+                for (int64_t th = 0; th < sub_h; ++th) {
+                    const int64_t kh = ph.h.first_tap + param.stride_h * (sub_h - 1 - th);
+                    for (int64_t tw = 0; tw < sub_w; ++tw) {
+                        const int64_t kw = ph.w.first_tap + param.stride_w * (sub_w - 1 - tw);
+                        ic_flt[(th * sub_w + tw) * ch_dt_blk * ch_dt_blk] = l_weight[kh * param.kernel_w + kw];
+                    }
+                }
+            }
+        }
+    }
+
+    return ppl::common::RC_SUCCESS;
+}
+
+uint64_t conv_transpose_n16cx_fp32_get_buffer_bytes(
+    const conv_transpose_n16cx_fp32_param &param,
+    const ppl::nn::TensorShape *dst_shape)
+{
+    // stride_w == 1 writes rows of dst directly, otherwise each thread gathers a phase row before scattering
+    if (param.stride_w == 1) {
+        return 0;
+    }
+    const int64_t dst_w      = dst_shape->GetDim(3);
+    const uint64_t row_bytes = div_up(dst_w, param.stride_w) * CONV_TRANSPOSE_N16CX_CH_DT_BLK() * sizeof(float);
+    return round_up(row_bytes, PPL_X86_CACHELINE_BYTES()) * PPL_OMP_MAX_THREADS();
+}
+
+}}}; // namespace ppl::kernel::x86
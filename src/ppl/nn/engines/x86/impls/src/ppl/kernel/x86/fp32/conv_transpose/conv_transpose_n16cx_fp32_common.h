@@ -0,0 +1,91 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef __ST_PPL_KERNEL_X86_FP32_CONV_TRANSPOSE_CONV_TRANSPOSE_N16CX_FP32_COMMON_H_
+#define __ST_PPL_KERNEL_X86_FP32_CONV_TRANSPOSE_CONV_TRANSPOSE_N16CX_FP32_COMMON_H_
+
+#include <vector>
+
+#include "ppl/kernel/x86/common/internal_include.h"
+#include "ppl/kernel/x86/fp32/conv_transpose.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+#define CONV_TRANSPOSE_N16CX_CH_DT_BLK() 16
+
+/*
+  dst[o] of a 1-D conv_transpose only receives taps k with (o + pad - k) % stride == 0. for the phase
+  r = o % stride they are k = first_tap + stride * t, so dst[r + stride * j] is a stride-1 convolution of src
+  with the reversed sub-kernel [first_tap + stride * (sub_kernel - 1), ..., first_tap] and pad sub_pad.
+*/
+struct conv_transpose_n16cx_fp32_phase_1d {
+    int64_t first_tap;
+    int64_t sub_kernel;
+    int64_t sub_pad;
+    int64_t dst_len; // number of dst pixels of this phase
+};
+
+inline conv_transpose_n16cx_fp32_phase_1d conv_transpose_n16cx_fp32_init_phase_1d(
+    const int64_t phase,
+    const int64_t kernel,
+    const int64_t stride,
+    const int64_t pad,
+    const int64_t dst_len)
+{
+    conv_transpose_n16cx_fp32_phase_1d p;
+    p.first_tap  = (phase + pad) % stride;
+    p.sub_kernel = p.first_tap < kernel ? div_up(kernel - p.first_tap, stride) : 0;
+    p.sub_pad    = p.sub_kernel - 1 - (phase + pad - p.first_tap) / stride;
+    p.dst_len    = phase < dst_len ? div_up(dst_len - phase, stride) : 0;
+    return p;
+}
+
+struct conv_transpose_n16cx_fp32_phase {
+    conv_transpose_n16cx_fp32_phase_1d h;
+    conv_transpose_n16cx_fp32_phase_1d w;
+    int64_t flt_offset; // offset of the sub-filter in packed weight
+};
+
+/*
+  packed weight: padded bias [round_up(num_output, 16)], then a sub-filter for each phase in (rh, rw) order,
+  laid out as [ocb][icb][sub_kernel_h][sub_kernel_w][16ic][16oc] like the n16cx direct conv2d filter.
+*/
+inline void conv_transpose_n16cx_fp32_init_phases(
+    const conv_transpose_n16cx_fp32_param &param,
+    const int64_t dst_h,
+    const int64_t dst_w,
+    std::vector<conv_transpose_n16cx_fp32_phase> *phases)
+{
+    const int64_t padded_oc = round_up(param.num_output, CONV_TRANSPOSE_N16CX_CH_DT_BLK());
+    const int64_t padded_ic = round_up(param.channels, CONV_TRANSPOSE_N16CX_CH_DT_BLK());
+
+    phases->resize(param.stride_h * param.stride_w);
+    int64_t flt_offset = padded_oc;
+    for (int64_t rh = 0; rh < param.stride_h; ++rh) {
+        for (int64_t rw = 0; rw < param.stride_w; ++rw) {
+            auto &p      = phases->at(rh * param.stride_w + rw);
+            p.h          = conv_transpose_n16cx_fp32_init_phase_1d(rh, param.kernel_h, param.stride_h, param.pad_h, dst_h);
+            p.w          = conv_transpose_n16cx_fp32_init_phase_1d(rw, param.kernel_w, param.stride_w, param.pad_w, dst_w);
+            p.flt_offset = flt_offset;
+            flt_offset += padded_oc * padded_ic * p.h.sub_kernel * p.w.sub_kernel;
+        }
+    }
+}
+
+}}}; // namespace ppl::kernel::x86
+
+#endif
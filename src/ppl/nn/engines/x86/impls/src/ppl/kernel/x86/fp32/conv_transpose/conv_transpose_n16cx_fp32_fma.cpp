@@ -0,0 +1,186 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <immintrin.h>
+
+#include "ppl/kernel/x86/fp32/conv2d/direct/fma/conv2d_n16cx_direct_kernel_fp32_fma.h"
+#include "ppl/kernel/x86/fp32/conv_transpose/conv_transpose_n16cx_fp32_common.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+// phases without any tap only get bias
+static inline void conv_transpose_n16cx_fill_bias_fp32_fma(
+    const float *bias,
+    const uint64_t kernel_flags,
+    const int64_t length,
+    float *dst)
+{
+    __m256 ymm0 = _mm256_loadu_ps(bias + 0 * CH_RF_BLK());
+    __m256 ymm1 = _mm256_loadu_ps(bias + 1 * CH_RF_BLK());
+    if (kernel_flags & (KERNEL_FLAG_RELU() | KERNEL_FLAG_RELU6())) {
+        ymm0 = _mm256_max_ps(ymm0, _mm256_setzero_ps());
+        ymm1 = _mm256_max_ps(ymm1, _mm256_setzero_ps());
+    }
+    if (kernel_flags & KERNEL_FLAG_RELU6()) {
+        ymm0 = _mm256_min_ps(ymm0, _mm256_set1_ps(6.0f));
+        ymm1 = _mm256_min_ps(ymm1, _mm256_set1_ps(6.0f));
+    }
+    for (int64_t i = 0; i < length; ++i) {
+        _mm256_storeu_ps(dst + i * CH_DT_BLK() + 0 * CH_RF_BLK(), ymm0);
+        _mm256_storeu_ps(dst + i * CH_DT_BLK() + 1 * CH_RF_BLK(), ymm1);
+    }
+}
+
+ppl::common::RetCode conv_transpose_n16cx_fp32_fma(
+    const conv_transpose_n16cx_fp32_param &param,
+    const ppl::nn::TensorShape *src_shape,
+    const float *src,
+    const float *packed_weight,
+    const ppl::nn::TensorShape *dst_shape,
+    void *temp_buffer,
+    float *dst)
+{
+    const int64_t batch     = src_shape->GetDim(0);
+    const int64_t src_h     = src_shape->GetDim(2);
+    const int64_t src_w     = src_shape->GetDim(3);
+    const int64_t dst_h     = dst_shape->GetDim(2);
+    const int64_t dst_w     = dst_shape->GetDim(3);
+    const int64_t padded_ic = round_up(param.channels, CH_DT_BLK());
+    const int64_t padded_oc = round_up(param.num_output, CH_DT_BLK());
+    const int64_t ocb_num   = padded_oc / CH_DT_BLK();
+    const int64_t stride_h  = param.stride_h;
+    const int64_t stride_w  = param.stride_w;
+
+    const int64_t src_b_stride = padded_ic * src_h * src_w;
+    const int64_t dst_b_stride = padded_oc * dst_h * dst_w;
+    const int64_t row_buf_len  = round_up(div_up(dst_w, stride_w) * CH_DT_BLK() * sizeof(float), PPL_X86_CACHELINE_BYTES()) / sizeof(float);
+    const int64_t oc_sel       = 1; // CH_DT_BLK() / CH_RF_BLK() - 1
+    const int64_t stride_w_sel = 1; // every phase is a stride-1 conv
+    const int64_t nt_store_sel = 0;
+    const int64_t ow_kr_blk    = BLK1X6_OW_RF();
+
+    uint64_t kernel_flags = KERNEL_FLAG_LD_BIAS();
+    if (param.fuse_flag & conv_fuse_flag::RELU) {
+        kernel_flags |= KERNEL_FLAG_RELU();
+    } else if (param.fuse_flag & conv_fuse_flag::RELU6) {
+        kernel_flags |= KERNEL_FLAG_RELU6();
+    }
+
+    std::vector<conv_transpose_n16cx_fp32_phase> phases;
+    conv_transpose_n16cx_fp32_init_phases(param, dst_h, dst_w, &phases);
+
+    PRAGMA_OMP_PARALLEL_FOR()
+    for (int64_t task = 0; task < batch * ocb_num * dst_h; ++task) {
+        const int64_t oh  = task % dst_h;
+        const int64_t ocb = (task / dst_h) % ocb_num;
+        const int64_t b   = task / (dst_h * ocb_num);
+        const int64_t rh  = oh % stride_h;
+        const int64_t jh  = oh / stride_h;
+
+        const float *l_src  = src + b * src_b_stride;
+        const float *l_bias = packed_weight + ocb * CH_DT_BLK();
+        float *dst_row      = dst + b * dst_b_stride + (ocb * dst_h + oh) * dst_w * CH_DT_BLK();
+        float *row_buf      = stride_w == 1 ? dst_row : (float *)temp_buffer + PPL_OMP_THREAD_ID() * row_buf_len;
+
+        for (int64_t rw = 0; rw < stride_w; ++rw) {
+            const auto &ph        = phases[rh * stride_w + rw];
+            const int64_t row_len = ph.w.dst_len;
+            const int64_t sub_h   = ph.h.sub_kernel;
+            const int64_t sub_w   = ph.w.sub_kernel;
+            if (row_len == 0) {
+                continue;
+            }
+
+            if (sub_h == 0 || sub_w == 0) {
+                conv_transpose_n16cx_fill_bias_fp32_fma(l_bias, kernel_flags, row_len, row_buf);
+            } else {
+                int64_t share_param[SHAR_PARAM_LEN()];
+                int64_t private_param[PRIV_PARAM_LEN()];
+                share_param[CHANNELS_IDX()]       = param.channels;
+                share_param[SRC_ICB_STRIDE_IDX()] = src_h * src_w * CH_DT_BLK();
+                share_param[SRC_SW_STRIDE_IDX()]  = CH_DT_BLK();
+                share_param[SRC_DH_STRIDE_IDX()]  = src_w * CH_DT_BLK();
+                share_param[SRC_DW_STRIDE_IDX()]  = CH_DT_BLK();
+                share_param[KH_IDX()]             = sub_h;
+                share_param[KW_IDX()]             = sub_w;
+                PICK_PARAM(uint64_t, share_param, FLAGS_IDX()) = kernel_flags;
+
+                const int64_t ih = jh - ph.h.sub_pad;
+                private_param[KH_START_IDX()] = min<int64_t>(max<int64_t>(0 - ih, 0), sub_h);
+                private_param[KH_END_IDX()]   = max<int64_t>(min<int64_t>(src_h - ih, sub_h), 0);
+
+                // outputs whose taps are all inside src go to the unrolled kernels
+                const int64_t unroll_start = min<int64_t>(max<int64_t>(ph.w.sub_pad, 0), row_len);
+                const int64_t unroll_end   = max<int64_t>(min<int64_t>(src_w - sub_w + ph.w.sub_pad + 1, row_len), unroll_start);
+                const int64_t unroll_body  = round(unroll_end - unroll_start, ow_kr_blk);
+                const int64_t unroll_tail  = unroll_end - unroll_start - unroll_body;
+
+                PICK_PARAM(const float *, private_param, SRC_IDX())  = l_src + (ih * src_w - ph.w.sub_pad) * CH_DT_BLK();
+                PICK_PARAM(const float *, private_param, HIS_IDX())  = row_buf;
+                PICK_PARAM(float *, private_param, DST_IDX())        = row_buf;
+                PICK_PARAM(const float *, private_param, FLT_IDX())  = packed_weight + ph.flt_offset + ocb * padded_ic * sub_h * sub_w * CH_DT_BLK();
+                PICK_PARAM(const float *, private_param, BIAS_IDX()) = l_bias;
+
+                for (int64_t j = 0; j < unroll_start; ++j) {
+                    const int64_t iw = j - ph.w.sub_pad;
+                    private_param[KW_START_IDX()] = min<int64_t>(max<int64_t>(0 - iw, 0), sub_w);
+                    private_param[KW_END_IDX()]   = max<int64_t>(min<int64_t>(src_w - iw, sub_w), 0);
+                    conv2d_n16cx_direct_kernel_fp32_fma_pad_table[nt_store_sel][oc_sel](private_param, share_param);
+                    PICK_PARAM(const float *, private_param, SRC_IDX()) += CH_DT_BLK();
+                    PICK_PARAM(const float *, private_param, HIS_IDX()) += CH_DT_BLK();
+                    PICK_PARAM(float *, private_param, DST_IDX()) += CH_DT_BLK();
+                }
+                if (unroll_body) {
+                    private_param[OW_IDX()] = unroll_body;
+                    conv2d_n16cx_direct_kernel_fp32_fma_blk_table[nt_store_sel][stride_w_sel][oc_sel][ow_kr_blk - 1](private_param, share_param);
+                    PICK_PARAM(const float *, private_param, SRC_IDX()) += unroll_body * CH_DT_BLK();
+                    PICK_PARAM(const float *, private_param, HIS_IDX()) += unroll_body * CH_DT_BLK();
+                    PICK_PARAM(float *, private_param, DST_IDX()) += unroll_body * CH_DT_BLK();
+                }
+                if (unroll_tail) {
+                    private_param[OW_IDX()] = unroll_tail;
+                    conv2d_n16cx_direct_kernel_fp32_fma_blk_table[nt_store_sel][stride_w_sel][oc_sel][unroll_tail - 1](private_param, share_param);
+                    PICK_PARAM(const float *, private_param, SRC_IDX()) += unroll_tail * CH_DT_BLK();
+                    PICK_PARAM(const float *, private_param, HIS_IDX()) += unroll_tail * CH_DT_BLK();
+                    PICK_PARAM(float *, private_param, DST_IDX()) += unroll_tail * CH_DT_BLK();
+                }
+                for (int64_t j = unroll_end; j < row_len; ++j) {
+                    const int64_t iw = j - ph.w.sub_pad;
+                    private_param[KW_START_IDX()] = min<int64_t>(max<int64_t>(0 - iw, 0), sub_w);
+                    private_param[KW_END_IDX()]   = max<int64_t>(min<int64_t>(src_w - iw, sub_w), 0);
+                    conv2d_n16cx_direct_kernel_fp32_fma_pad_table[nt_store_sel][oc_sel](private_param, share_param);
+                    PICK_PARAM(const float *, private_param, SRC_IDX()) += CH_DT_BLK();
+                    PICK_PARAM(const float *, private_param, HIS_IDX()) += CH_DT_BLK();
+                    PICK_PARAM(float *, private_param, DST_IDX()) += CH_DT_BLK();
+                }
+            }
+
+            if (stride_w != 1) {
+                float *l_dst = dst_row + rw * CH_DT_BLK();
+                for (int64_t j = 0; j < row_len; ++j) {
+                    _mm256_storeu_ps(l_dst + 0 * CH_RF_BLK(), _mm256_loadu_ps(row_buf + j * CH_DT_BLK() + 0 * CH_RF_BLK()));
+                    _mm256_storeu_ps(l_dst + 1 * CH_RF_BLK(), _mm256_loadu_ps(row_buf + j * CH_DT_BLK() + 1 * CH_RF_BLK()));
+                    l_dst += stride_w * CH_DT_BLK();
+                }
+            }
+        }
+    }
+
+    return ppl::common::RC_SUCCESS;
+}
+
+}}}; // namespace ppl::kernel::x86
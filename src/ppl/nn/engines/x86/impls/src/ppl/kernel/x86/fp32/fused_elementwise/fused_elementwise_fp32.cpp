@@ -0,0 +1,66 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/kernel/x86/common/internal_include.h"
+#include "ppl/kernel/x86/common/fused_elementwise/fused_elementwise_common.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+struct fused_elementwise_vec_ops_scalar {
+    typedef float vec_t;
+    static const int64_t simd_w = 1;
+
+    static inline vec_t load(const float *ptr) { return *ptr; }
+    static inline void store(float *ptr, const vec_t v) { *ptr = v; }
+    static inline vec_t set1(const float val) { return val; }
+
+    template <int32_t _op>
+    static inline vec_t op(const vec_t a, const vec_t b)
+    {
+        return fused_elementwise_scalar_kernel_common<_op>(a, b);
+    }
+};
+
+uint64_t fused_elementwise_fp32_get_buffer_bytes(
+    const fused_elementwise_inst_t *insts,
+    const int32_t num_src,
+    const int32_t num_insts)
+{
+    if (num_insts <= 1) {
+        return 0;
+    }
+    std::vector<int32_t> slots(num_insts);
+    const int32_t num_slots = fused_elementwise_assign_tile_slots(insts, num_src, num_insts, slots.data());
+    const uint64_t thread_bytes = round_up(num_slots * FUSED_ELEMENTWISE_TILE() * sizeof(float), PPL_X86_CACHELINE_BYTES());
+    return thread_bytes * PPL_OMP_MAX_THREADS();
+}
+
+ppl::common::RetCode fused_elementwise_fp32(
+    const int64_t length,
+    const float **src,
+    const bool *src_is_scalar,
+    const int32_t num_src,
+    const fused_elementwise_inst_t *insts,
+    const int32_t num_insts,
+    void *temp_buffer,
+    float *dst)
+{
+    return fused_elementwise_fp32_common<fused_elementwise_vec_ops_scalar>(
+        length, src, src_is_scalar, num_src, insts, num_insts, temp_buffer, dst);
+}
+
+}}}; // namespace ppl::kernel::x86
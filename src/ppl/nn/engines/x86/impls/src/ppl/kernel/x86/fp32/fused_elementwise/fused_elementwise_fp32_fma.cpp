@@ -0,0 +1,71 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <immintrin.h>
+
+#include "ppl/kernel/x86/common/internal_include.h"
+#include "ppl/kernel/x86/common/math_fma.h"
+#include "ppl/kernel/x86/common/fused_elementwise/fused_elementwise_common.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+struct fused_elementwise_vec_ops_fma {
+    typedef __m256 vec_t;
+    static const int64_t simd_w = 8;
+
+    static inline vec_t load(const float *ptr) { return _mm256_loadu_ps(ptr); }
+    static inline void store(float *ptr, const vec_t v) { _mm256_storeu_ps(ptr, v); }
+    static inline vec_t set1(const float val) { return _mm256_set1_ps(val); }
+
+    template <int32_t _op>
+    static inline vec_t op(const vec_t a, const vec_t b)
+    {
+        switch (_op) {
+            case FUSED_ELEMENTWISE_ADD: return _mm256_add_ps(a, b);
+            case FUSED_ELEMENTWISE_SUB: return _mm256_sub_ps(a, b);
+            case FUSED_ELEMENTWISE_MUL: return _mm256_mul_ps(a, b);
+            case FUSED_ELEMENTWISE_DIV: return _mm256_div_ps(a, b);
+            case FUSED_ELEMENTWISE_MAX: return _mm256_max_ps(a, b);
+            case FUSED_ELEMENTWISE_MIN: return _mm256_min_ps(a, b);
+            case FUSED_ELEMENTWISE_RELU: return _mm256_max_ps(a, _mm256_setzero_ps());
+            case FUSED_ELEMENTWISE_SIGMOID: return _fma_sigmoid_ps(a);
+            case FUSED_ELEMENTWISE_TANH: return _fma_tanh_ps(a);
+            case FUSED_ELEMENTWISE_EXP: return _fma_exp_ps(a);
+            case FUSED_ELEMENTWISE_ERF: return _fma_erf_ps(a);
+            case FUSED_ELEMENTWISE_ABS: return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a);
+            case FUSED_ELEMENTWISE_NEG: return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f));
+            case FUSED_ELEMENTWISE_SQRT: return _mm256_sqrt_ps(a);
+            default: return a;
+        }
+    }
+};
+
+ppl::common::RetCode fused_elementwise_fp32_fma(
+    const int64_t length,
+    const float **src,
+    const bool *src_is_scalar,
+    const int32_t num_src,
+    const fused_elementwise_inst_t *insts,
+    const int32_t num_insts,
+    void *temp_buffer,
+    float *dst)
+{
+    return fused_elementwise_fp32_common<fused_elementwise_vec_ops_fma>(
+        length, src, src_is_scalar, num_src, insts, num_insts, temp_buffer, dst);
+}
+
+}}}; // namespace ppl::kernel::x86
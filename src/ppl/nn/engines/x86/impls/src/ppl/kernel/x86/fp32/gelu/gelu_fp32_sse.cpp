@@ -0,0 +1,82 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <immintrin.h>
+#include <math.h>
+
+#include "ppl/kernel/x86/common/internal_include.h"
+#include "ppl/kernel/x86/common/math_sse.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+ppl::common::RetCode gelu_fp32_sse(
+    const ppl::nn::TensorShape *x_shape,
+    const float *x,
+    const bool approximate,
+    float *y)
+{
+    const int64_t n_elem      = x_shape->GetElementsIncludingPadding();
+    const int64_t simd_w      = 4;
+    const int64_t unroll_n    = 4 * simd_w;
+    const int64_t unroll_body = round(n_elem, unroll_n);
+
+    const __m128 v_half = _mm_set1_ps(0.5f);
+    const __m128 v_one  = _mm_set1_ps(1.0f);
+
+    if (approximate) {
+        const __m128 v_k0 = _mm_set1_ps(0.7978845608f); // sqrt(2 / pi)
+        const __m128 v_k1 = _mm_set1_ps(0.044715f * 0.7978845608f);
+#define _OP_PS(X) _mm_mul_ps(_mm_mul_ps(v_half, X), _mm_add_ps(v_one, _sse_tanh_ps(_mm_mul_ps(X, _mm_add_ps(_mm_mul_ps(v_k1, _mm_mul_ps(X, X)), v_k0)))))
+        PRAGMA_OMP_PARALLEL_FOR()
+        for (int64_t i = 0; i < unroll_body; i += unroll_n) {
+            __m128 src0 = _mm_loadu_ps(x + i + 0 * simd_w);
+            __m128 src1 = _mm_loadu_ps(x + i + 1 * simd_w);
+            __m128 src2 = _mm_loadu_ps(x + i + 2 * simd_w);
+            __m128 src3 = _mm_loadu_ps(x + i + 3 * simd_w);
+            _mm_storeu_ps(y + i + 0 * simd_w, _OP_PS(src0));
+            _mm_storeu_ps(y + i + 1 * simd_w, _OP_PS(src1));
+            _mm_storeu_ps(y + i + 2 * simd_w, _OP_PS(src2));
+            _mm_storeu_ps(y + i + 3 * simd_w, _OP_PS(src3));
+        }
+#undef _OP_PS
+        for (int64_t i = unroll_body; i < n_elem; ++i) {
+            y[i] = 0.5f * x[i] * (1.0f + tanhf(0.7978845608f * (x[i] + 0.044715f * x[i] * x[i] * x[i])));
+        }
+    } else {
+        const __m128 v_rsqrt2 = _mm_set1_ps(0.7071067812f);
+#define _OP_PS(X) _mm_mul_ps(_mm_mul_ps(v_half, X), _mm_add_ps(v_one, _sse_erf_ps(_mm_mul_ps(X, v_rsqrt2))))
+        PRAGMA_OMP_PARALLEL_FOR()
+        for (int64_t i = 0; i < unroll_body; i += unroll_n) {
+            __m128 src0 = _mm_loadu_ps(x + i + 0 * simd_w);
+            __m128 src1 = _mm_loadu_ps(x + i + 1 * simd_w);
+            __m128 src2 = _mm_loadu_ps(x + i + 2 * simd_w);
+            __m128 src3 = _mm_loadu_ps(x + i + 3 * simd_w);
+            _mm_storeu_ps(y + i + 0 * simd_w, _OP_PS(src0));
+            _mm_storeu_ps(y + i + 1 * simd_w, _OP_PS(src1));
+            _mm_storeu_ps(y + i + 2 * simd_w, _OP_PS(src2));
+            _mm_storeu_ps(y + i + 3 * simd_w, _OP_PS(src3));
+        }
+#undef _OP_PS
+        for (int64_t i = unroll_body; i < n_elem; ++i) {
+            y[i] = 0.5f * x[i] * (1.0f + erff(x[i] * 0.7071067812f));
+        }
+    }
+
+    return ppl::common::RC_SUCCESS;
+}
+
+}}}; // namespace ppl::kernel::x86
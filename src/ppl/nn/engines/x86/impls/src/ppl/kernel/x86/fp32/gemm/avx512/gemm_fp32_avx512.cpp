@@ -820,7 +820,7 @@ ppl::common::RetCode gemm_fp32_avx512_pack_b(
         const float *base_b = B + (is_trans_b ? nb * ldb + kb : kb * ldb + nb);
         float *base_p = packedB + kb * padded_nb_eff + nb * K;
 
-        if (n_regs == gemm_kernel_fp32_avx512::config::MAX_N_REGS) {
+        if (nb_eff == n_blk) { // body func always packs n_blk columns
             pack_b_body_func[is_trans_b](base_b, nb_eff, kb_eff, ldb, base_p);
         } else {
             pack_b_tail_func[is_trans_b][n_regs](base_b, nb_eff, kb_eff, ldb, base_p);
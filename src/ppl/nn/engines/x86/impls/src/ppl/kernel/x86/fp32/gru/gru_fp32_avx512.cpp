@@ -0,0 +1,321 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <math.h>
+#include <string.h>
+#include <immintrin.h>
+
+#include "ppl/kernel/x86/common/internal_include.h"
+#include "ppl/kernel/x86/fp32/gru.h"
+#include "ppl/kernel/x86/fp32/gemm.h"
+#include "ppl/kernel/x86/common/math_avx512.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+static const int64_t ACT_H_BLK = 128;
+
+static inline float sigmoidf(const float x) {
+    return 1.0f / (1.0f + expf(-x));
+}
+
+static inline uint64_t gru_fp32_avx512_get_packed_r_size(const int64_t hidden_size) {
+    // linear_before_reset: [3H, H], otherwise: [2H, H] + [H, H]
+    const uint64_t packed_r_zrh = gemm_fp32_avx512_get_packed_b_bytes(rnn_num_gate::GRU * hidden_size, hidden_size);
+    const uint64_t packed_r_zr_h = gemm_fp32_avx512_get_packed_b_bytes(2 * hidden_size, hidden_size) +
+                                   gemm_fp32_avx512_get_packed_b_bytes(hidden_size, hidden_size);
+    return round_up(max(packed_r_zrh, packed_r_zr_h) / sizeof(float), 16);
+}
+
+// rh = sigmoid(gate_r) * Hprev
+static inline void gru_fp32_avx512_reset_hidden(
+    const float *gR,
+    const float *Hprev,
+    const int64_t length,
+    float *rh)
+{
+    const int64_t simd_w = 16;
+    int64_t h = 0;
+    for (; h <= length - simd_w; h += simd_w) {
+        const __m512 rt = _avx512_sigmoid_ps(_mm512_loadu_ps(gR + h));
+        _mm512_storeu_ps(rh + h, _mm512_mul_ps(rt, _mm512_loadu_ps(Hprev + h)));
+    }
+    for (; h < length; ++h) {
+        rh[h] = sigmoidf(gR[h]) * Hprev[h];
+    }
+}
+
+// Ht = (1 - zt) * nt + zt * Hprev = nt + zt * (Hprev - nt)
+// nt = tanh(gate_h) or tanh(gate_h + rt * (hidden_h + Rbh)) if linear_before_reset
+template <bool linear_before_reset>
+static inline void gru_fp32_avx512_update_hidden(
+    const float *gZ,
+    const float *gR,
+    const float *gH,
+    const float *hZ,
+    const float *hR,
+    const float *hH,
+    const float *Rbh,
+    const float *Hprev,
+    const int64_t length,
+    float *Ht,
+    float *Yt)
+{
+    const int64_t simd_w = 16;
+    int64_t h = 0;
+    for (; h <= length - simd_w; h += simd_w) {
+        __m512 gz = _mm512_loadu_ps(gZ + h);
+        __m512 gh = _mm512_loadu_ps(gH + h);
+        if (linear_before_reset) {
+            gz = _mm512_add_ps(gz, _mm512_loadu_ps(hZ + h));
+            const __m512 rt = _avx512_sigmoid_ps(_mm512_add_ps(_mm512_loadu_ps(gR + h), _mm512_loadu_ps(hR + h)));
+            __m512 hh = _mm512_loadu_ps(hH + h);
+            if (Rbh) hh = _mm512_add_ps(hh, _mm512_loadu_ps(Rbh + h));
+            gh = _mm512_fmadd_ps(rt, hh, gh);
+        }
+        const __m512 zt = _avx512_sigmoid_ps(gz);
+        const __m512 nt = _avx512_tanh_ps(gh);
+        const __m512 hn = _mm512_fmadd_ps(zt, _mm512_sub_ps(_mm512_loadu_ps(Hprev + h), nt), nt);
+        _mm512_storeu_ps(Ht + h, hn);
+        if (Yt) _mm512_storeu_ps(Yt + h, hn);
+    }
+    for (; h < length; ++h) {
+        float gz = gZ[h];
+        float gh = gH[h];
+        if (linear_before_reset) {
+            gz += hZ[h];
+            const float rt = sigmoidf(gR[h] + hR[h]);
+            gh += rt * (hH[h] + (Rbh ? Rbh[h] : 0.0f));
+        }
+        const float zt = sigmoidf(gz);
+        const float nt = ::tanhf(gh);
+        Ht[h] = nt + zt * (Hprev[h] - nt);
+        if (Yt) Yt[h] = Ht[h];
+    }
+}
+
+uint64_t gru_fp32_avx512_get_buffer_bytes(
+    const ppl::nn::TensorShape *X_shape,
+    const rnn_direction_t direction,
+    const int64_t hidden_size,
+    const bool has_Y,
+    const bool has_Y_h)
+{
+    if (!has_Y && !has_Y_h)
+        return 64u;
+
+    const int64_t seq_len = X_shape->GetDim(0);
+    const int64_t batch = X_shape->GetDim(1);
+    const int64_t num_direction = direction == rnn_direction::BIDIRECTIONAL ? 2 : 1;
+
+    const uint64_t packed_r_size = gru_fp32_avx512_get_packed_r_size(hidden_size);
+    const uint64_t bias_size = round_up(rnn_num_gate::GRU * hidden_size, 16);
+    const uint64_t gate_buff_size = seq_len * batch * rnn_num_gate::GRU * hidden_size;
+    const uint64_t hidden_buff_size = batch * rnn_num_gate::GRU * hidden_size;
+    const uint64_t yh_size = has_Y_h ? 0 : num_direction * batch * hidden_size;
+
+    return (packed_r_size + bias_size + gate_buff_size + hidden_buff_size + yh_size) * sizeof(float);
+}
+
+// same as gru_fp32_fma() but in avx512
+ppl::common::RetCode gru_fp32_avx512(
+    const ppl::nn::TensorShape *X_shape,
+    const float *X,
+    const float *X_weight,
+    const float *R_weight,
+    const float *bias,
+    const int32_t *sequence_lens,
+    const float *initial_h,
+    const rnn_direction_t direction,
+    const int64_t hidden_size,
+    const bool linear_before_reset,
+    void *temp_buffer,
+    float *Y,
+    float *Y_h)
+{
+    if (!Y && !Y_h) {
+        return ppl::common::RC_SUCCESS;
+    }
+
+    const int64_t num_direction = direction == rnn_direction::BIDIRECTIONAL ? 2 : 1;
+    const int64_t seq_len = X_shape->GetDim(0);
+    const int64_t batch = X_shape->GetDim(1);
+    const int64_t input_size = X_shape->GetDim(2);
+    const int64_t num_gate_out = rnn_num_gate::GRU * hidden_size;
+
+    // set temp buffer
+    float *temp_buffer_fp32 = reinterpret_cast<float*>(temp_buffer);
+    float *packed_R = temp_buffer_fp32;
+    temp_buffer_fp32 += gru_fp32_avx512_get_packed_r_size(hidden_size);
+    float *sum_bias = temp_buffer_fp32;
+    temp_buffer_fp32 += round_up(num_gate_out, 16);
+    float *gate_buf = temp_buffer_fp32;
+    temp_buffer_fp32 += seq_len * batch * num_gate_out;
+    float *hidden_buf = temp_buffer_fp32;
+    temp_buffer_fp32 += batch * num_gate_out;
+
+    float *Yh_buf = Y_h;
+    if (!Yh_buf) {
+        Yh_buf = temp_buffer_fp32;
+        temp_buffer_fp32 += num_direction * batch * hidden_size;
+    }
+
+    float *packed_Rzr = packed_R;
+    float *packed_Rh = packed_R + gemm_fp32_avx512_get_packed_b_bytes(2 * hidden_size, hidden_size) / sizeof(float);
+
+    const int64_t h_tasks = div_up(hidden_size, ACT_H_BLK);
+
+    for (int64_t nd = 0; nd < num_direction; ++nd) {
+        const bool is_reverse = nd || (direction == rnn_direction::REVERSE);
+
+        float *nd_Yh = Yh_buf + nd * batch * hidden_size;
+        float *nd_Y = Y ? Y + nd * batch * hidden_size : nullptr;
+
+        const float *nd_W = X_weight + nd * num_gate_out * input_size;
+        const float *nd_R = R_weight + nd * num_gate_out * hidden_size;
+        const float *nd_Wb = bias ? bias + nd * 2 * num_gate_out : nullptr;
+        const float *nd_Rb = bias ? nd_Wb + num_gate_out : nullptr;
+        const float *nd_Rbh = nd_Rb ? nd_Rb + 2 * hidden_size : nullptr;
+
+        const float *nd_init_h = initial_h ? initial_h + nd * batch * hidden_size : nullptr;
+
+        // Rbh is applied after the reset gate if linear_before_reset
+        if (bias) {
+            const int64_t rb_len = linear_before_reset ? 2 * hidden_size : num_gate_out;
+            for (int64_t i = 0; i < rb_len; ++i) {
+                sum_bias[i] = nd_Wb[i] + nd_Rb[i];
+            }
+            for (int64_t i = rb_len; i < num_gate_out; ++i) {
+                sum_bias[i] = nd_Wb[i];
+            }
+        }
+
+        // X (seq_len, batch, input_size)
+        // h_0 (num_direction, batch, hidden_size)
+        // Y (seq_len, num_direction, batch, hidden_size)
+        // h_n (num_direction, batch, hidden_size)
+
+        auto ret = gemm_fp32_avx512( // gate[:] = X[:]*W[nd]_{zrh}^T+Wb_{zrh}(+Rb_{zr(h)})
+            X, nd_W, bias ? sum_bias : nullptr, nullptr,
+            gemm_m_type::NOTRANS, gemm_m_type::TRANS,
+            bias ? gemm_v_type::ROW_VEC : gemm_v_type::EMPTY, gemm_m_type::EMPTY,
+            seq_len * batch, num_gate_out, input_size,
+            input_size, input_size, num_gate_out, 0,
+            1.0f, 0.0f, 1.0f, 0.0f, gemm_post::NONE, gate_buf);
+        if (ret != ppl::common::RC_SUCCESS) {
+            return ret;
+        }
+
+        if (linear_before_reset) {
+            ret = gemm_fp32_avx512_pack_b(nd_R, gemm_m_type::TRANS, num_gate_out, hidden_size, hidden_size, packed_R);
+        } else {
+            ret = gemm_fp32_avx512_pack_b(nd_R, gemm_m_type::TRANS, 2 * hidden_size, hidden_size, hidden_size, packed_Rzr);
+            if (ret == ppl::common::RC_SUCCESS) {
+                ret = gemm_fp32_avx512_pack_b(nd_R + 2 * hidden_size * hidden_size, gemm_m_type::TRANS,
+                                           hidden_size, hidden_size, hidden_size, packed_Rh);
+            }
+        }
+        if (ret != ppl::common::RC_SUCCESS) {
+            return ret;
+        }
+
+        if (!nd_init_h) {
+            memset(nd_Yh, 0, batch * hidden_size * sizeof(float));
+        }
+
+        for (int64_t seq_idx = 0; seq_idx < seq_len; ++seq_idx) {
+            const int64_t mapped_seq_index = is_reverse ? (seq_len - seq_idx - 1) : seq_idx;
+            const float *Y_h_prev = (seq_idx == 0 && nd_init_h) ? nd_init_h : nd_Yh;
+            float *sY = nd_Y ? nd_Y + mapped_seq_index * num_direction * batch * hidden_size : nullptr;
+            float *sgate = gate_buf + mapped_seq_index * batch * num_gate_out;
+
+            if (linear_before_reset) {
+                ret = gemm_fp32_avx512( // hidden = h_{t-1}[nd]*R[nd]_{zrh}^T
+                    Y_h_prev, packed_R, nullptr, nullptr,
+                    gemm_m_type::NOTRANS, gemm_m_type::PACKED,
+                    gemm_v_type::EMPTY, gemm_m_type::EMPTY,
+                    batch, num_gate_out, hidden_size,
+                    hidden_size, num_gate_out, num_gate_out, 0,
+                    1.0f, 0.0f, 0.0f, 0.0f, gemm_post::NONE, hidden_buf);
+            } else {
+                ret = gemm_fp32_avx512( // gate[s]_{zr} += h_{t-1}[nd]*R[nd]_{zr}^T
+                    Y_h_prev, packed_Rzr, nullptr, nullptr,
+                    gemm_m_type::NOTRANS, gemm_m_type::PACKED,
+                    gemm_v_type::EMPTY, gemm_m_type::EMPTY,
+                    batch, 2 * hidden_size, hidden_size,
+                    hidden_size, 2 * hidden_size, num_gate_out, 0,
+                    1.0f, 1.0f, 0.0f, 0.0f, gemm_post::NONE, sgate);
+                if (ret != ppl::common::RC_SUCCESS) {
+                    return ret;
+                }
+
+PRAGMA_OMP_PARALLEL_FOR()
+                for (int64_t t = 0; t < batch * h_tasks; ++t) {
+                    const int64_t b = t / h_tasks;
+                    const int64_t hb = (t % h_tasks) * ACT_H_BLK;
+                    const int64_t h_eff = min(hidden_size - hb, ACT_H_BLK);
+                    gru_fp32_avx512_reset_hidden(
+                        sgate + b * num_gate_out + hidden_size + hb, Y_h_prev + b * hidden_size + hb,
+                        h_eff, hidden_buf + b * hidden_size + hb);
+                }
+
+                ret = gemm_fp32_avx512( // gate[s]_{h} += (r_t*h_{t-1}[nd])*R[nd]_{h}^T
+                    hidden_buf, packed_Rh, nullptr, nullptr,
+                    gemm_m_type::NOTRANS, gemm_m_type::PACKED,
+                    gemm_v_type::EMPTY, gemm_m_type::EMPTY,
+                    batch, hidden_size, hidden_size,
+                    hidden_size, hidden_size, num_gate_out, 0,
+                    1.0f, 1.0f, 0.0f, 0.0f, gemm_post::NONE, sgate + 2 * hidden_size);
+            }
+            if (ret != ppl::common::RC_SUCCESS) {
+                return ret;
+            }
+
+PRAGMA_OMP_PARALLEL_FOR()
+            for (int64_t t = 0; t < batch * h_tasks; ++t) {
+                const int64_t b = t / h_tasks;
+                const int64_t hb = (t % h_tasks) * ACT_H_BLK;
+                const int64_t h_eff = min(hidden_size - hb, ACT_H_BLK);
+
+                const float *Hprev = Y_h_prev + b * hidden_size + hb;
+                float *Ht = nd_Yh + b * hidden_size + hb;
+                float *Yt = sY ? sY + b * hidden_size + hb : nullptr;
+                if (!sequence_lens || mapped_seq_index < sequence_lens[b]) {
+                    const float *gZ = sgate + b * num_gate_out + hb;
+                    const float *gR = gZ + hidden_size;
+                    const float *gH = gR + hidden_size;
+                    if (linear_before_reset) {
+                        const float *hZ = hidden_buf + b * num_gate_out + hb;
+                        gru_fp32_avx512_update_hidden<true>(
+                            gZ, gR, gH, hZ, hZ + hidden_size, hZ + 2 * hidden_size,
+                            nd_Rbh ? nd_Rbh + hb : nullptr, Hprev, h_eff, Ht, Yt);
+                    } else {
+                        gru_fp32_avx512_update_hidden<false>(
+                            gZ, gR, gH, nullptr, nullptr, nullptr, nullptr, Hprev, h_eff, Ht, Yt);
+                    }
+                } else { // pass through the hidden state, output zeros
+                    memcpy(Ht, Hprev, h_eff * sizeof(float));
+                    if (Yt) memset(Yt, 0, h_eff * sizeof(float));
+                }
+            }
+        }
+    }
+
+    return ppl::common::RC_SUCCESS;
+}
+
+}}}; // namespace ppl::kernel::x86
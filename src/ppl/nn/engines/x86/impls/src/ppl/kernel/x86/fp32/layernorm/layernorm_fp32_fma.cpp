@@ -0,0 +1,50 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <immintrin.h>
+
+#include "ppl/kernel/x86/common/internal_include.h"
+#include "ppl/kernel/x86/common/layernorm/layernorm_common.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+struct layernorm_vec_ops_fma {
+    typedef __m256 vec_t;
+    static const int64_t simd_w = 8;
+
+    static inline vec_t load(const float *ptr) { return _mm256_loadu_ps(ptr); }
+    static inline void store(float *ptr, const vec_t v) { _mm256_storeu_ps(ptr, v); }
+    static inline vec_t set1(const float val) { return _mm256_set1_ps(val); }
+    static inline vec_t add(const vec_t a, const vec_t b) { return _mm256_add_ps(a, b); }
+    static inline vec_t sub(const vec_t a, const vec_t b) { return _mm256_sub_ps(a, b); }
+    static inline vec_t mul(const vec_t a, const vec_t b) { return _mm256_mul_ps(a, b); }
+    static inline vec_t fmadd(const vec_t a, const vec_t b, const vec_t c) { return _mm256_fmadd_ps(a, b, c); }
+};
+
+ppl::common::RetCode layernorm_ndarray_fp32_fma(
+    const ppl::nn::TensorShape *src_shape,
+    const float *src,
+    const float *scale,
+    const float *shift,
+    const int64_t axis,
+    const float eps,
+    float *dst)
+{
+    return layernorm_ndarray_fp32_common<layernorm_vec_ops_fma>(src_shape, src, scale, shift, axis, eps, dst);
+}
+
+}}}; // namespace ppl::kernel::x86
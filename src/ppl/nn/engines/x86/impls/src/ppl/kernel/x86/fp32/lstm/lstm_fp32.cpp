@@ -43,8 +43,8 @@ uint64_t lstm_fp32_ref_get_buffer_bytes(
     const int64_t num_direction = direction == rnn_direction::BIDIRECTIONAL ? 2 : 1;
 
     const uint64_t gate_buff_size = batch * rnn_num_gate::LSTM * hidden_size;
-    const uint64_t yh_size = has_Y_h ? num_direction * batch * hidden_size : 0;
-    const uint64_t yc_size = has_Y_c ? num_direction * batch * hidden_size : 0;
+    const uint64_t yh_size = has_Y_h ? 0 : num_direction * batch * hidden_size;
+    const uint64_t yc_size = has_Y_c ? 0 : num_direction * batch * hidden_size;
 
     return (gate_buff_size + yh_size + yc_size) * sizeof(float);
 }
@@ -125,7 +125,7 @@ ppl::common::RetCode lstm_fp32_ref(
             gemm_fp32_ref( // X[s]*W[nd]_{iofc}^T+Wb_{iofc}
                 sX, nd_W, nd_Wb, nullptr,
                 gemm_m_type::NOTRANS, gemm_m_type::TRANS,
-                gemm_v_type::ROW_VEC, gemm_m_type::EMPTY,
+                nd_Wb ? gemm_v_type::ROW_VEC : gemm_v_type::EMPTY, gemm_m_type::EMPTY,
                 batch, rnn_num_gate::LSTM * hidden_size, input_size,
                 input_size, input_size, rnn_num_gate::LSTM * hidden_size, 0,
                 1.0f, 0.0f, 1.0f, 0.0f, gemm_post::NONE, gate_buf);
@@ -134,9 +134,9 @@ ppl::common::RetCode lstm_fp32_ref(
             gemm_fp32_ref( // h_0[nd]*R[nd]_{iofc}^T+Rb_{iofc}
                 Y_h_prev, nd_R, nd_Rb, nullptr,
                 gemm_m_type::NOTRANS, gemm_m_type::TRANS,
-                gemm_v_type::ROW_VEC, gemm_m_type::NOTRANS,
+                nd_Rb ? gemm_v_type::ROW_VEC : gemm_v_type::EMPTY, gemm_m_type::EMPTY,
                 batch, rnn_num_gate::LSTM * hidden_size, hidden_size,
-                hidden_size, hidden_size, rnn_num_gate::LSTM * hidden_size, rnn_num_gate::LSTM * hidden_size,
+                hidden_size, hidden_size, rnn_num_gate::LSTM * hidden_size, 0,
                 alpha, 1.0f, 1.0f, 0.0f, gemm_post::NONE, gate_buf);
 
             if (is_first_seq && !Y_h_prev) {
@@ -151,7 +151,7 @@ ppl::common::RetCode lstm_fp32_ref(
             if (!P_weight) {
 PRAGMA_OMP_PARALLEL_FOR()
                 for (int64_t b = 0; b < batch; ++b) {
-                    if (!sequence_lens || seq_idx < sequence_lens[b]) {
+                    if (!sequence_lens || mapped_seq_index < sequence_lens[b]) {
                         const float *gI = gate_buf + b * rnn_num_gate::LSTM * hidden_size;
                         const float *gO = gI + hidden_size;
                         const float *gF = gO + hidden_size;
@@ -171,13 +171,16 @@ PRAGMA_OMP_PARALLEL_FOR()
                         if (Y) {
                             memcpy(Yt, Ht, hidden_size * sizeof(float));
                         }
-                    } else { // pass through the initial_h, initial_c
+                    } else { // pass through the initial_h, initial_c, output zeros
                         const float *Hprev = Y_h_prev + b * hidden_size;
                         const float *Cprev = Y_c_prev + b * hidden_size;
                         float *Ct = nd_Yc + b * hidden_size;
                         float *Ht = nd_Yh + b * hidden_size;
                         memcpy(Ct, Cprev, hidden_size * sizeof(float));
                         memcpy(Ht, Hprev, hidden_size * sizeof(float));
+                        if (Y) {
+                            memset(sY + b * hidden_size, 0, hidden_size * sizeof(float));
+                        }
                     }
                 }
             } else {
@@ -186,7 +189,7 @@ PRAGMA_OMP_PARALLEL_FOR()
                 const float *pF = pO + hidden_size;
 PRAGMA_OMP_PARALLEL_FOR()
                 for (int64_t b = 0; b < batch; ++b) {
-                    if (!sequence_lens || seq_idx < sequence_lens[b]) {
+                    if (!sequence_lens || mapped_seq_index < sequence_lens[b]) {
                         const float *gI = gate_buf + b * rnn_num_gate::LSTM * hidden_size;
                         const float *gO = gI + hidden_size;
                         const float *gF = gO + hidden_size;
@@ -206,13 +209,16 @@ PRAGMA_OMP_PARALLEL_FOR()
                         if (Y) {
                             memcpy(Yt, Ht, hidden_size * sizeof(float));
                         }
-                    } else { // pass through the initial_h, initial_c
+                    } else { // pass through the initial_h, initial_c, output zeros
                         const float *Hprev = Y_h_prev + b * hidden_size;
                         const float *Cprev = Y_c_prev + b * hidden_size;
                         float *Ct = nd_Yc + b * hidden_size;
                         float *Ht = nd_Yh + b * hidden_size;
                         memcpy(Ct, Cprev, hidden_size * sizeof(float));
                         memcpy(Ht, Hprev, hidden_size * sizeof(float));
+                        if (Y) {
+                            memset(sY + b * hidden_size, 0, hidden_size * sizeof(float));
+                        }
                     }
                 }
             }
@@ -0,0 +1,273 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <math.h>
+#include <string.h>
+#include <immintrin.h>
+
+#include "ppl/kernel/x86/common/internal_include.h"
+#include "ppl/kernel/x86/fp32/lstm.h"
+#include "ppl/kernel/x86/fp32/gemm.h"
+#include "ppl/kernel/x86/common/math_avx512.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+static const int64_t ACT_H_BLK = 128;
+
+static inline float sigmoidf(const float x) {
+    return 1.0f / (1.0f + expf(-x));
+}
+
+template <bool has_peephole>
+static inline void lstm_fp32_avx512_activate_gates(
+    const float *gI,
+    const float *gO,
+    const float *gF,
+    const float *gC,
+    const float *pI,
+    const float *pO,
+    const float *pF,
+    const float *Cprev,
+    const int64_t length,
+    float *Ct,
+    float *Ht,
+    float *Yt)
+{
+    const int64_t simd_w = 16;
+    int64_t h = 0;
+    for (; h <= length - simd_w; h += simd_w) {
+        const __m512 cp = _mm512_loadu_ps(Cprev + h);
+        __m512 gi = _mm512_loadu_ps(gI + h);
+        __m512 gf = _mm512_loadu_ps(gF + h);
+        if (has_peephole) {
+            gi = _mm512_fmadd_ps(cp, _mm512_loadu_ps(pI + h), gi);
+            gf = _mm512_fmadd_ps(cp, _mm512_loadu_ps(pF + h), gf);
+        }
+        const __m512 it = _avx512_sigmoid_ps(gi);
+        const __m512 ft = _avx512_sigmoid_ps(gf);
+        const __m512 ct = _avx512_tanh_ps(_mm512_loadu_ps(gC + h));
+        const __m512 cn = _mm512_fmadd_ps(ft, cp, _mm512_mul_ps(it, ct));
+        __m512 go = _mm512_loadu_ps(gO + h);
+        if (has_peephole) {
+            go = _mm512_fmadd_ps(cn, _mm512_loadu_ps(pO + h), go);
+        }
+        const __m512 ot = _avx512_sigmoid_ps(go);
+        const __m512 hn = _mm512_mul_ps(ot, _avx512_tanh_ps(cn));
+        _mm512_storeu_ps(Ct + h, cn);
+        _mm512_storeu_ps(Ht + h, hn);
+        if (Yt) _mm512_storeu_ps(Yt + h, hn);
+    }
+    for (; h < length; ++h) {
+        const float it = sigmoidf(gI[h] + (has_peephole ? pI[h] * Cprev[h] : 0.0f));
+        const float ft = sigmoidf(gF[h] + (has_peephole ? pF[h] * Cprev[h] : 0.0f));
+        const float ct = ::tanhf(gC[h]);
+        Ct[h] = ft * Cprev[h] + it * ct;
+        const float ot = sigmoidf(gO[h] + (has_peephole ? pO[h] * Ct[h] : 0.0f));
+        Ht[h] = ot * ::tanhf(Ct[h]);
+        if (Yt) Yt[h] = Ht[h];
+    }
+}
+
+uint64_t lstm_fp32_avx512_get_buffer_bytes(
+    const ppl::nn::TensorShape *X_shape,
+    const rnn_direction_t direction,
+    const int64_t hidden_size,
+    const bool has_Y,
+    const bool has_Y_h,
+    const bool has_Y_c)
+{
+    if (!has_Y && !has_Y_h && !has_Y_c)
+        return 64u;
+
+    const int64_t seq_len = X_shape->GetDim(0);
+    const int64_t batch = X_shape->GetDim(1);
+    const int64_t num_direction = direction == rnn_direction::BIDIRECTIONAL ? 2 : 1;
+
+    const uint64_t packed_r_size = round_up(gemm_fp32_avx512_get_packed_b_bytes(rnn_num_gate::LSTM * hidden_size, hidden_size) / sizeof(float), 16);
+    const uint64_t bias_size = round_up(rnn_num_gate::LSTM * hidden_size, 16);
+    const uint64_t gate_buff_size = seq_len * batch * rnn_num_gate::LSTM * hidden_size;
+    const uint64_t yh_size = has_Y_h ? 0 : num_direction * batch * hidden_size;
+    const uint64_t yc_size = has_Y_c ? 0 : num_direction * batch * hidden_size;
+
+    return (packed_r_size + bias_size + gate_buff_size + yh_size + yc_size) * sizeof(float);
+}
+
+// same as lstm_fp32_fma() but in avx512
+ppl::common::RetCode lstm_fp32_avx512(
+    const ppl::nn::TensorShape *X_shape,
+    const float *X,
+    const float *X_weight,
+    const float *R_weight,
+    const float *P_weight,
+    const float *bias,
+    const int32_t *sequence_lens,
+    const float *initial_h,
+    const float *initial_c,
+    const rnn_direction_t direction,
+    const int64_t hidden_size,
+    void *temp_buffer,
+    float *Y,
+    float *Y_h,
+    float *Y_c)
+{
+    if (!Y && !Y_h && !Y_c) {
+        return ppl::common::RC_SUCCESS;
+    }
+
+    const int64_t num_direction = direction == rnn_direction::BIDIRECTIONAL ? 2 : 1;
+    const int64_t seq_len = X_shape->GetDim(0);
+    const int64_t batch = X_shape->GetDim(1);
+    const int64_t input_size = X_shape->GetDim(2);
+    const int64_t num_gate_out = rnn_num_gate::LSTM * hidden_size;
+
+    // set temp buffer
+    float *temp_buffer_fp32 = reinterpret_cast<float*>(temp_buffer);
+    float *packed_R = temp_buffer_fp32;
+    temp_buffer_fp32 += round_up(gemm_fp32_avx512_get_packed_b_bytes(num_gate_out, hidden_size) / sizeof(float), 16);
+    float *sum_bias = temp_buffer_fp32;
+    temp_buffer_fp32 += round_up(num_gate_out, 16);
+    float *gate_buf = temp_buffer_fp32;
+    temp_buffer_fp32 += seq_len * batch * num_gate_out;
+
+    float *Yh_buf = Y_h;
+    float *Yc_buf = Y_c;
+    if (!Yh_buf) {
+        Yh_buf = temp_buffer_fp32;
+        temp_buffer_fp32 += num_direction * batch * hidden_size;
+    }
+    if (!Yc_buf) {
+        Yc_buf = temp_buffer_fp32;
+        temp_buffer_fp32 += num_direction * batch * hidden_size;
+    }
+
+    const int64_t h_tasks = div_up(hidden_size, ACT_H_BLK);
+
+    for (int64_t nd = 0; nd < num_direction; ++nd) {
+        const bool is_reverse = nd || (direction == rnn_direction::REVERSE);
+
+        float *nd_Yh = Yh_buf + nd * batch * hidden_size;
+        float *nd_Yc = Yc_buf + nd * batch * hidden_size;
+        float *nd_Y = Y ? Y + nd * batch * hidden_size : nullptr;
+
+        const float *nd_W = X_weight + nd * num_gate_out * input_size;
+        const float *nd_R = R_weight + nd * num_gate_out * hidden_size;
+        const float *nd_P = P_weight ? P_weight + nd * (rnn_num_gate::LSTM - 1) * hidden_size : nullptr;
+        const float *nd_Wb = bias ? bias + nd * 2 * num_gate_out : nullptr;
+        const float *nd_Rb = bias ? nd_Wb + num_gate_out : nullptr;
+
+        const float *nd_init_h = initial_h ? initial_h + nd * batch * hidden_size : nullptr;
+        const float *nd_init_c = initial_c ? initial_c + nd * batch * hidden_size : nullptr;
+
+        if (bias) {
+            for (int64_t i = 0; i < num_gate_out; ++i) {
+                sum_bias[i] = nd_Wb[i] + nd_Rb[i];
+            }
+        }
+
+        // X (seq_len, batch, input_size)
+        // h_0 (num_direction, batch, hidden_size)
+        // c_0 (num_direction, batch, hidden_size)
+        // Y (seq_len, num_direction, batch, hidden_size)
+        // h_n (num_direction, batch, hidden_size)
+        // c_n (num_direction, batch, hidden_size)
+
+        auto ret = gemm_fp32_avx512( // gate[:] = X[:]*W[nd]_{iofc}^T+Wb_{iofc}+Rb_{iofc}
+            X, nd_W, bias ? sum_bias : nullptr, nullptr,
+            gemm_m_type::NOTRANS, gemm_m_type::TRANS,
+            bias ? gemm_v_type::ROW_VEC : gemm_v_type::EMPTY, gemm_m_type::EMPTY,
+            seq_len * batch, num_gate_out, input_size,
+            input_size, input_size, num_gate_out, 0,
+            1.0f, 0.0f, 1.0f, 0.0f, gemm_post::NONE, gate_buf);
+        if (ret != ppl::common::RC_SUCCESS) {
+            return ret;
+        }
+
+        ret = gemm_fp32_avx512_pack_b(nd_R, gemm_m_type::TRANS, num_gate_out, hidden_size, hidden_size, packed_R);
+        if (ret != ppl::common::RC_SUCCESS) {
+            return ret;
+        }
+
+        for (int64_t seq_idx = 0; seq_idx < seq_len; ++seq_idx) {
+            const int64_t mapped_seq_index = is_reverse ? (seq_len - seq_idx - 1) : seq_idx;
+            const bool is_first_seq = seq_idx == 0;
+
+            const float *Y_h_prev = is_first_seq ? nd_init_h : nd_Yh;
+            const float *Y_c_prev = is_first_seq ? nd_init_c : nd_Yc;
+            float *sY = nd_Y ? nd_Y + mapped_seq_index * num_direction * batch * hidden_size : nullptr;
+            float *sgate = gate_buf + mapped_seq_index * batch * num_gate_out;
+
+            if (Y_h_prev) {
+                ret = gemm_fp32_avx512( // gate[s] += h_{t-1}[nd]*R[nd]_{iofc}^T
+                    Y_h_prev, packed_R, nullptr, nullptr,
+                    gemm_m_type::NOTRANS, gemm_m_type::PACKED,
+                    gemm_v_type::EMPTY, gemm_m_type::EMPTY,
+                    batch, num_gate_out, hidden_size,
+                    hidden_size, num_gate_out, num_gate_out, 0,
+                    1.0f, 1.0f, 0.0f, 0.0f, gemm_post::NONE, sgate);
+                if (ret != ppl::common::RC_SUCCESS) {
+                    return ret;
+                }
+            }
+
+            if (is_first_seq && !Y_h_prev) {
+                Y_h_prev = nd_Yh; // preprocess Y_h_prev
+                memset(nd_Yh, 0, batch * hidden_size * sizeof(float));
+            }
+            if (is_first_seq && !Y_c_prev) {
+                Y_c_prev = nd_Yc; // preprocess Y_c_prev
+                memset(nd_Yc, 0, batch * hidden_size * sizeof(float));
+            }
+
+PRAGMA_OMP_PARALLEL_FOR()
+            for (int64_t t = 0; t < batch * h_tasks; ++t) {
+                const int64_t b = t / h_tasks;
+                const int64_t hb = (t % h_tasks) * ACT_H_BLK;
+                const int64_t h_eff = min(hidden_size - hb, ACT_H_BLK);
+
+                const float *Cprev = Y_c_prev + b * hidden_size + hb;
+                float *Ct = nd_Yc + b * hidden_size + hb;
+                float *Ht = nd_Yh + b * hidden_size + hb;
+                if (!sequence_lens || mapped_seq_index < sequence_lens[b]) {
+                    const float *gI = sgate + b * num_gate_out + hb;
+                    const float *gO = gI + hidden_size;
+                    const float *gF = gO + hidden_size;
+                    const float *gC = gF + hidden_size;
+                    float *Yt = sY ? sY + b * hidden_size + hb : nullptr;
+                    if (nd_P) {
+                        lstm_fp32_avx512_activate_gates<true>(
+                            gI, gO, gF, gC, nd_P + hb, nd_P + hidden_size + hb, nd_P + 2 * hidden_size + hb,
+                            Cprev, h_eff, Ct, Ht, Yt);
+                    } else {
+                        lstm_fp32_avx512_activate_gates<false>(
+                            gI, gO, gF, gC, nullptr, nullptr, nullptr,
+                            Cprev, h_eff, Ct, Ht, Yt);
+                    }
+                } else { // pass through the initial_h, initial_c, output zeros
+                    const float *Hprev = Y_h_prev + b * hidden_size + hb;
+                    memcpy(Ct, Cprev, h_eff * sizeof(float));
+                    memcpy(Ht, Hprev, h_eff * sizeof(float));
+                    if (sY) memset(sY + b * hidden_size + hb, 0, h_eff * sizeof(float));
+                }
+            }
+        }
+    }
+
+    return ppl::common::RC_SUCCESS;
+}
+
+}}}; // namespace ppl::kernel::x86
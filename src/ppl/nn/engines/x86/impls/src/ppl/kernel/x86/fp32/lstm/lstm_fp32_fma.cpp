@@ -15,6 +15,7 @@
 // specific language governing permissions and limitations
 // under the License.
 
+
 #include <math.h>
 #include <immintrin.h>
 
@@ -26,10 +27,63 @@
 
 namespace ppl { namespace kernel { namespace x86 {
 
+// hidden units processed by one task of the gate activation. small enough to keep all cores busy when batch is 1.
+static const int64_t ACT_H_BLK = 64;
+
 static inline float sigmoidf(const float x) {
     return 1.0f / (1.0f + expf(-x));
 }
 
+template <bool has_peephole>
+static inline void lstm_fp32_fma_activate_gates(
+    const float *gI,
+    const float *gO,
+    const float *gF,
+    const float *gC,
+    const float *pI,
+    const float *pO,
+    const float *pF,
+    const float *Cprev,
+    const int64_t length,
+    float *Ct,
+    float *Ht,
+    float *Yt)
+{
+    const int64_t simd_w = 8;
+    int64_t h = 0;
+    for (; h <= length - simd_w; h += simd_w) {
+        const __m256 cp = _mm256_loadu_ps(Cprev + h);
+        __m256 gi = _mm256_loadu_ps(gI + h);
+        __m256 gf = _mm256_loadu_ps(gF + h);
+        if (has_peephole) {
+            gi = _mm256_fmadd_ps(cp, _mm256_loadu_ps(pI + h), gi);
+            gf = _mm256_fmadd_ps(cp, _mm256_loadu_ps(pF + h), gf);
+        }
+        const __m256 it = _fma_sigmoid_ps(gi);
+        const __m256 ft = _fma_sigmoid_ps(gf);
+        const __m256 ct = _fma_tanh_ps(_mm256_loadu_ps(gC + h));
+        const __m256 cn = _mm256_fmadd_ps(ft, cp, _mm256_mul_ps(it, ct));
+        __m256 go = _mm256_loadu_ps(gO + h);
+        if (has_peephole) {
+            go = _mm256_fmadd_ps(cn, _mm256_loadu_ps(pO + h), go);
+        }
+        const __m256 ot = _fma_sigmoid_ps(go);
+        const __m256 hn = _mm256_mul_ps(ot, _fma_tanh_ps(cn));
+        _mm256_storeu_ps(Ct + h, cn);
+        _mm256_storeu_ps(Ht + h, hn);
+        if (Yt) _mm256_storeu_ps(Yt + h, hn);
+    }
+    for (; h < length; ++h) {
+        const float it = sigmoidf(gI[h] + (has_peephole ? pI[h] * Cprev[h] : 0.0f));
+        const float ft = sigmoidf(gF[h] + (has_peephole ? pF[h] * Cprev[h] : 0.0f));
+        const float ct = ::tanhf(gC[h]);
+        Ct[h] = ft * Cprev[h] + it * ct;
+        const float ot = sigmoidf(gO[h] + (has_peephole ? pO[h] * Ct[h] : 0.0f));
+        Ht[h] = ot * ::tanhf(Ct[h]);
+        if (Yt) Yt[h] = Ht[h];
+    }
+}
+
 uint64_t lstm_fp32_fma_get_buffer_bytes(
     const ppl::nn::TensorShape *X_shape,
     const rnn_direction_t direction,
@@ -41,16 +95,25 @@ uint64_t lstm_fp32_fma_get_buffer_bytes(
     if (!has_Y && !has_Y_h && !has_Y_c)
         return 64u;
 
+    const int64_t seq_len = X_shape->GetDim(0);
     const int64_t batch = X_shape->GetDim(1);
     const int64_t num_direction = direction == rnn_direction::BIDIRECTIONAL ? 2 : 1;
 
-    const uint64_t gate_buff_size = batch * rnn_num_gate::LSTM * hidden_size;
-    const uint64_t yh_size = has_Y_h ? num_direction * batch * hidden_size : 0;
-    const uint64_t yc_size = has_Y_c ? num_direction * batch * hidden_size : 0;
+    const uint64_t packed_r_size = round_up(gemm_fp32_fma_get_packed_b_bytes(rnn_num_gate::LSTM * hidden_size, hidden_size) / sizeof(float), 16);
+    const uint64_t bias_size = round_up(rnn_num_gate::LSTM * hidden_size, 16);
+    const uint64_t gate_buff_size = seq_len * batch * rnn_num_gate::LSTM * hidden_size;
+    const uint64_t yh_size = has_Y_h ? 0 : num_direction * batch * hidden_size;
+    const uint64_t yc_size = has_Y_c ? 0 : num_direction * batch * hidden_size;
 
-    return (gate_buff_size + yh_size + yc_size) * sizeof(float);
+    return (packed_r_size + bias_size + gate_buff_size + yh_size + yc_size) * sizeof(float);
 }
 
+/*
+  input projections of all timesteps are computed by one [seq_len * batch, 4 * hidden_size] gemm before
+  the recurrence, which is well parallelized even if batch is 1. each timestep then only runs the
+  recurrent gemm with R packed once per direction, followed by the gate activation split by batch
+  and hidden units.
+*/
 ppl::common::RetCode lstm_fp32_fma(
     const ppl::nn::TensorShape *X_shape,
     const float *X,
@@ -72,18 +135,23 @@ ppl::common::RetCode lstm_fp32_fma(
         return ppl::common::RC_SUCCESS;
     }
 
-    const int64_t simd_w = 8;
-
     const int64_t num_direction = direction == rnn_direction::BIDIRECTIONAL ? 2 : 1;
     const int64_t seq_len = X_shape->GetDim(0);
     const int64_t batch = X_shape->GetDim(1);
     const int64_t input_size = X_shape->GetDim(2);
-
-    float *Yh_buf = Y_h;
-    float *Yc_buf = Y_c;
+    const int64_t num_gate_out = rnn_num_gate::LSTM * hidden_size;
 
     // set temp buffer
     float *temp_buffer_fp32 = reinterpret_cast<float*>(temp_buffer);
+    float *packed_R = temp_buffer_fp32;
+    temp_buffer_fp32 += round_up(gemm_fp32_fma_get_packed_b_bytes(num_gate_out, hidden_size) / sizeof(float), 16);
+    float *sum_bias = temp_buffer_fp32;
+    temp_buffer_fp32 += round_up(num_gate_out, 16);
+    float *gate_buf = temp_buffer_fp32;
+    temp_buffer_fp32 += seq_len * batch * num_gate_out;
+
+    float *Yh_buf = Y_h;
+    float *Yc_buf = Y_c;
     if (!Yh_buf) {
         Yh_buf = temp_buffer_fp32;
         temp_buffer_fp32 += num_direction * batch * hidden_size;
@@ -92,56 +160,75 @@ ppl::common::RetCode lstm_fp32_fma(
         Yc_buf = temp_buffer_fp32;
         temp_buffer_fp32 += num_direction * batch * hidden_size;
     }
-    float *gate_buf = temp_buffer_fp32;
+
+    const int64_t h_tasks = div_up(hidden_size, ACT_H_BLK);
 
     for (int64_t nd = 0; nd < num_direction; ++nd) {
         const bool is_reverse = nd || (direction == rnn_direction::REVERSE);
 
         float *nd_Yh = Yh_buf + nd * batch * hidden_size;
         float *nd_Yc = Yc_buf + nd * batch * hidden_size;
-        float *nd_Y = Y + nd * batch * hidden_size;
+        float *nd_Y = Y ? Y + nd * batch * hidden_size : nullptr;
 
-        const float *nd_W = X_weight + nd * rnn_num_gate::LSTM * hidden_size * input_size;
-        const float *nd_R = R_weight + nd * rnn_num_gate::LSTM * hidden_size * hidden_size;
+        const float *nd_W = X_weight + nd * num_gate_out * input_size;
+        const float *nd_R = R_weight + nd * num_gate_out * hidden_size;
         const float *nd_P = P_weight ? P_weight + nd * (rnn_num_gate::LSTM - 1) * hidden_size : nullptr;
-        const float *nd_Wb = bias ? bias + nd * 2 * rnn_num_gate::LSTM * hidden_size : nullptr;
-        const float *nd_Rb = bias ? nd_Wb + rnn_num_gate::LSTM * hidden_size : nullptr;
+        const float *nd_Wb = bias ? bias + nd * 2 * num_gate_out : nullptr;
+        const float *nd_Rb = bias ? nd_Wb + num_gate_out : nullptr;
 
         const float *nd_init_h = initial_h ? initial_h + nd * batch * hidden_size : nullptr;
         const float *nd_init_c = initial_c ? initial_c + nd * batch * hidden_size : nullptr;
 
+        if (bias) {
+            for (int64_t i = 0; i < num_gate_out; ++i) {
+                sum_bias[i] = nd_Wb[i] + nd_Rb[i];
+            }
+        }
+
+        // X (seq_len, batch, input_size)
+        // h_0 (num_direction, batch, hidden_size)
+        // c_0 (num_direction, batch, hidden_size)
+        // Y (seq_len, num_direction, batch, hidden_size)
+        // h_n (num_direction, batch, hidden_size)
+        // c_n (num_direction, batch, hidden_size)
+
+        auto ret = gemm_fp32_fma( // gate[:] = X[:]*W[nd]_{iofc}^T+Wb_{iofc}+Rb_{iofc}
+            X, nd_W, bias ? sum_bias : nullptr, nullptr,
+            gemm_m_type::NOTRANS, gemm_m_type::TRANS,
+            bias ? gemm_v_type::ROW_VEC : gemm_v_type::EMPTY, gemm_m_type::EMPTY,
+            seq_len * batch, num_gate_out, input_size,
+            input_size, input_size, num_gate_out, 0,
+            1.0f, 0.0f, 1.0f, 0.0f, gemm_post::NONE, gate_buf);
+        if (ret != ppl::common::RC_SUCCESS) {
+            return ret;
+        }
+
+        ret = gemm_fp32_fma_pack_b(nd_R, gemm_m_type::TRANS, num_gate_out, hidden_size, hidden_size, packed_R);
+        if (ret != ppl::common::RC_SUCCESS) {
+            return ret;
+        }
+
         for (int64_t seq_idx = 0; seq_idx < seq_len; ++seq_idx) {
             const int64_t mapped_seq_index = is_reverse ? (seq_len - seq_idx - 1) : seq_idx;
             const bool is_first_seq = seq_idx == 0;
 
-            // X (seq_len, batch, input_size)
-            // h_0 (num_direction, batch, hidden_size)
-            // c_0 (num_direction, batch, hidden_size)
-            // Y (seq_len, num_direction, batch, hidden_size)
-            // h_n (num_direction, batch, hidden_size)
-            // c_n (num_direction, batch, hidden_size)
-
-            const float *sX = X + mapped_seq_index * batch * input_size;
             const float *Y_h_prev = is_first_seq ? nd_init_h : nd_Yh;
             const float *Y_c_prev = is_first_seq ? nd_init_c : nd_Yc;
-            float *sY = nd_Y + mapped_seq_index * num_direction * batch * hidden_size;
-
-            gemm_fp32_fma( // gate = X[s]*W[nd]_{iofc}^T+Wb_{iofc}
-                sX, nd_W, nd_Wb, nullptr,
-                gemm_m_type::NOTRANS, gemm_m_type::TRANS,
-                gemm_v_type::ROW_VEC, gemm_m_type::EMPTY,
-                batch, rnn_num_gate::LSTM * hidden_size, input_size,
-                input_size, input_size, rnn_num_gate::LSTM * hidden_size, 0,
-                1.0f, 0.0f, 1.0f, 0.0f, gemm_post::NONE, gate_buf);
-
-            const float thisK = !Y_h_prev ? 0 : hidden_size; // some hack
-            gemm_fp32_fma( // gate += h_0[nd]*R[nd]_{iofc}^T+Rb_{iofc}
-                Y_h_prev, nd_R, nd_Rb, nullptr,
-                gemm_m_type::NOTRANS, gemm_m_type::TRANS,
-                gemm_v_type::ROW_VEC, gemm_m_type::NOTRANS,
-                batch, rnn_num_gate::LSTM * hidden_size, thisK,
-                hidden_size, hidden_size, rnn_num_gate::LSTM * hidden_size, rnn_num_gate::LSTM * hidden_size,
-                1.0f, 1.0f, 1.0f, 0.0f, gemm_post::NONE, gate_buf);
+            float *sY = nd_Y ? nd_Y + mapped_seq_index * num_direction * batch * hidden_size : nullptr;
+            float *sgate = gate_buf + mapped_seq_index * batch * num_gate_out;
+
+            if (Y_h_prev) {
+                ret = gemm_fp32_fma( // gate[s] += h_{t-1}[nd]*R[nd]_{iofc}^T
+                    Y_h_prev, packed_R, nullptr, nullptr,
+                    gemm_m_type::NOTRANS, gemm_m_type::PACKED,
+                    gemm_v_type::EMPTY, gemm_m_type::EMPTY,
+                    batch, num_gate_out, hidden_size,
+                    hidden_size, num_gate_out, num_gate_out, 0,
+                    1.0f, 1.0f, 0.0f, 0.0f, gemm_post::NONE, sgate);
+                if (ret != ppl::common::RC_SUCCESS) {
+                    return ret;
+                }
+            }
 
             if (is_first_seq && !Y_h_prev) {
                 Y_h_prev = nd_Yh; // preprocess Y_h_prev
@@ -152,95 +239,35 @@ ppl::common::RetCode lstm_fp32_fma(
                 memset32_avx(nd_Yc, 0, batch * hidden_size);
             }
 
-            if (!P_weight) {
 PRAGMA_OMP_PARALLEL_FOR()
-                for (int64_t b = 0; b < batch; ++b) {
-                    if (!sequence_lens || seq_idx < sequence_lens[b]) {
-                        const float *gI = gate_buf + b * rnn_num_gate::LSTM * hidden_size;
-                        const float *gO = gI + hidden_size;
-                        const float *gF = gO + hidden_size;
-                        const float *gC = gF + hidden_size;
-                        const float *Cprev = Y_c_prev + b * hidden_size;
-                        float *Ct = nd_Yc + b * hidden_size;
-                        float *Ht = nd_Yh + b * hidden_size;
-                        float *Yt = sY + b * hidden_size;
-                        int64_t h = 0;
-                        for (; h <= hidden_size - simd_w; h += simd_w) {
-                            const __m256 it = _fma_sigmoid_ps(_mm256_loadu_ps(gI + h));
-                            const __m256 ft = _fma_sigmoid_ps(_mm256_loadu_ps(gF + h));
-                            const __m256 ct = _fma_tanh_ps(_mm256_loadu_ps(gC + h));
-                            const __m256 cn = ft * _mm256_loadu_ps(Cprev + h) + it * ct;
-                            const __m256 ot = _fma_sigmoid_ps(_mm256_loadu_ps(gO + h));
-                            const __m256 hn = ot *_fma_tanh_ps(cn);
-                            _mm256_storeu_ps(Ct + h, cn);
-                            _mm256_storeu_ps(Ht + h, hn);
-                        }
-                        for (; h < hidden_size; ++h) {
-                            const float it = sigmoidf(gI[h]);
-                            const float ft = sigmoidf(gF[h]);
-                            const float ct = ::tanhf(gC[h]);
-                            Ct[h] = ft * Cprev[h] + it * ct;
-                            const float ot = sigmoidf(gO[h]);
-                            Ht[h] = ot * ::tanhf(Ct[h]);
-                        }
-                        if (Y) {
-                            memcpy32_avx(Yt, Ht, hidden_size);
-                        }
-                    } else { // pass through the initial_h, initial_c
-                        const float *Hprev = Y_h_prev + b * hidden_size;
-                        const float *Cprev = Y_c_prev + b * hidden_size;
-                        float *Ct = nd_Yc + b * hidden_size;
-                        float *Ht = nd_Yh + b * hidden_size;
-                        memcpy32_avx(Ct, Cprev, hidden_size);
-                        memcpy32_avx(Ht, Hprev, hidden_size);
-                    }
-                }
-            } else {
-                const float *pI = nd_P;
-                const float *pO = pI + hidden_size;
-                const float *pF = pO + hidden_size;
-PRAGMA_OMP_PARALLEL_FOR()
-                for (int64_t b = 0; b < batch; ++b) {
-                    if (!sequence_lens || seq_idx < sequence_lens[b]) {
-                        const float *gI = gate_buf + b * rnn_num_gate::LSTM * hidden_size;
-                        const float *gO = gI + hidden_size;
-                        const float *gF = gO + hidden_size;
-                        const float *gC = gF + hidden_size;
-                        const float *Cprev = Y_c_prev + b * hidden_size;
-                        float *Ct = nd_Yc + b * hidden_size;
-                        float *Ht = nd_Yh + b * hidden_size;
-                        float *Yt = sY + b * hidden_size;
-                        int64_t h = 0;
-                        for (; h <= hidden_size - simd_w; h += simd_w) {
-                            const __m256 cp = _mm256_loadu_ps(Cprev + h);
-                            const __m256 it = _fma_sigmoid_ps(_mm256_loadu_ps(gI + h) + cp * _mm256_loadu_ps(pI + h));
-                            const __m256 ft = _fma_sigmoid_ps(_mm256_loadu_ps(gF + h) + cp * _mm256_loadu_ps(pF + h));
-                            const __m256 ct = _fma_tanh_ps(_mm256_loadu_ps(gC + h));
-                            const __m256 cn = ft * cp + it * ct;
-                            const __m256 ot = _fma_sigmoid_ps(_mm256_loadu_ps(gO + h) + cn * _mm256_loadu_ps(pO + h));
-                            const __m256 hn = ot *_fma_tanh_ps(cn);
-                            _mm256_storeu_ps(Ct + h, cn);
-                            _mm256_storeu_ps(Ht + h, hn);
-                        }
-                        for (; h < hidden_size; ++h) {
-                            const float it = sigmoidf(gI[h] + pI[h] * Cprev[h]);
-                            const float ft = sigmoidf(gF[h] + pF[h] * Cprev[h]);
-                            const float ct = ::tanhf(gC[h]);
-                            Ct[h] = ft * Cprev[h] + it * ct;
-                            const float ot = sigmoidf(gO[h] + pO[h] * Ct[h]);
-                            Ht[h] = ot * ::tanhf(Ct[h]);
-                        }
-                        if (Y) {
-                            memcpy32_avx(Yt, Ht, hidden_size * sizeof(float));
-                        }
-                    } else { // pass through the initial_h, initial_c
-                        const float *Hprev = Y_h_prev + b * hidden_size;
-                        const float *Cprev = Y_c_prev + b * hidden_size;
-                        float *Ct = nd_Yc + b * hidden_size;
-                        float *Ht = nd_Yh + b * hidden_size;
-                        memcpy32_avx(Ct, Cprev, hidden_size);
-                        memcpy32_avx(Ht, Hprev, hidden_size);
+            for (int64_t t = 0; t < batch * h_tasks; ++t) {
+                const int64_t b = t / h_tasks;
+                const int64_t hb = (t % h_tasks) * ACT_H_BLK;
+                const int64_t h_eff = min(hidden_size - hb, ACT_H_BLK);
+
+                const float *Cprev = Y_c_prev + b * hidden_size + hb;
+                float *Ct = nd_Yc + b * hidden_size + hb;
+                float *Ht = nd_Yh + b * hidden_size + hb;
+                if (!sequence_lens || mapped_seq_index < sequence_lens[b]) {
+                    const float *gI = sgate + b * num_gate_out + hb;
+                    const float *gO = gI + hidden_size;
+                    const float *gF = gO + hidden_size;
+                    const float *gC = gF + hidden_size;
+                    float *Yt = sY ? sY + b * hidden_size + hb : nullptr;
+                    if (nd_P) {
+                        lstm_fp32_fma_activate_gates<true>(
+                            gI, gO, gF, gC, nd_P + hb, nd_P + hidden_size + hb, nd_P + 2 * hidden_size + hb,
+                            Cprev, h_eff, Ct, Ht, Yt);
+                    } else {
+                        lstm_fp32_fma_activate_gates<false>(
+                            gI, gO, gF, gC, nullptr, nullptr, nullptr,
+                            Cprev, h_eff, Ct, Ht, Yt);
                     }
+                } else { // pass through the initial_h, initial_c, output zeros
+                    const float *Hprev = Y_h_prev + b * hidden_size + hb;
+                    memcpy32_avx(Ct, Cprev, h_eff);
+                    memcpy32_avx(Ht, Hprev, h_eff);
+                    if (sY) memset32_avx(sY + b * hidden_size + hb, 0, h_eff);
                 }
             }
         }
@@ -249,5 +276,4 @@ PRAGMA_OMP_PARALLEL_FOR()
     return ppl::common::RC_SUCCESS;
 }
 
-
 }}}; // namespace ppl::kernel::x86
@@ -20,6 +20,7 @@
 
 #include "ppl/kernel/x86/common/internal_include.h"
 #include "ppl/kernel/x86/fp32/gemm_v2.h"
+#include "ppl/kernel/x86/fp32/gemm.h"
 
 namespace ppl { namespace kernel { namespace x86 {
 
@@ -194,4 +195,45 @@ ppl::common::RetCode matmul_ndarray_fp32(
         max_dim_count, 0, m, n, k, dst);
 }
 
+uint64_t matmul_ndarray_fp32_get_packed_b_bytes(
+    const ppl::common::isa_t isa_flag,
+    const int64_t N,
+    const int64_t K)
+{
+    return gemm_fp32_get_packed_b_bytes(isa_flag, N, K);
+}
+
+ppl::common::RetCode matmul_ndarray_fp32_pack_b(
+    const ppl::common::isa_t isa_flag,
+    const float *src1,
+    const int64_t N,
+    const int64_t K,
+    float *packed_src1)
+{
+    return gemm_pack_b_fp32(isa_flag, src1, gemm_m_type::NOTRANS, N, K, N, packed_src1);
+}
+
+ppl::common::RetCode matmul_ndarray_packed_b_fp32(
+    const ppl::nn::TensorShape *src0_shape,
+    const float *src0,
+    const float *packed_src1,
+    const int64_t N,
+    const int64_t K,
+    const ppl::common::isa_t isa_flag,
+    float *dst)
+{
+    if (K <= 0 || src0_shape->GetDim(src0_shape->GetDimCount() - 1) != K) {
+        return ppl::common::RC_INVALID_VALUE;
+    }
+    const int64_t M = src0_shape->GetElementsExcludingPadding() / K;
+
+    return gemm_fp32(
+        isa_flag, src0, packed_src1, nullptr, nullptr,
+        gemm_m_type::NOTRANS, gemm_m_type::PACKED,
+        gemm_v_type::EMPTY, gemm_m_type::EMPTY,
+        M, N, K, K, N, N, 0,
+        1.0f, 0.0f, 0.0f, 0.0f,
+        gemm_post::NONE, dst);
+}
+
 }}}; // namespace ppl::kernel::x86
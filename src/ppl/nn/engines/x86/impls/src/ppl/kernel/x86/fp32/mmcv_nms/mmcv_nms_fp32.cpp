@@ -16,6 +16,7 @@
 // under the License.
 
 #include "ppl/kernel/x86/common/internal_include.h"
+#include "ppl/kernel/x86/fp32/nms/nms_fp32_common.h"
 
 #include <vector>
 #include <algorithm>
@@ -98,4 +99,11 @@ ppl::common::RetCode mmcv_nms_ndarray_fp32(
     return mmcv_nms_ndarray_fp32_naive(boxes, scores, num_boxes_in, iou_threshold, offset, dst, num_boxes_out);
 }
 
+uint64_t mmcv_nms_ndarray_fp32_get_buffer_bytes(
+        const uint32_t num_boxes_in,
+        const bool use_bitmask)
+{
+    return nms_fp32_init_buffer_layout(num_boxes_in, 1, 1, 0, use_bitmask).total_bytes;
+}
+
 }}}; // namespace ppl::kernel::x86
@@ -0,0 +1,82 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <math.h>
+
+#include "ppl/kernel/x86/common/internal_include.h"
+#include "ppl/kernel/x86/common/multi_head_attention/multi_head_attention_common.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+struct multi_head_attention_vec_ops_scalar {
+    typedef float vec_t;
+    static const int64_t simd_w = 1;
+
+    static inline vec_t load(const float *ptr) { return *ptr; }
+    static inline void store(float *ptr, const vec_t v) { *ptr = v; }
+    static inline vec_t set1(const float val) { return val; }
+    static inline vec_t add(const vec_t a, const vec_t b) { return a + b; }
+    static inline vec_t sub(const vec_t a, const vec_t b) { return a - b; }
+    static inline vec_t mul(const vec_t a, const vec_t b) { return a * b; }
+    static inline vec_t max(const vec_t a, const vec_t b) { return a > b ? a : b; }
+    static inline vec_t fmadd(const vec_t a, const vec_t b, const vec_t c) { return a * b + c; }
+    static inline vec_t exp(const vec_t a) { return expf(a); }
+    static inline float reduce_add(const vec_t a) { return a; }
+    static inline float reduce_max(const vec_t a) { return a; }
+};
+
+bool multi_head_attention_fp32_is_profitable(
+    const ppl::common::isa_t isa)
+{
+    /*
+      unfused sse gemms and softmax are 5-25x slower for all shapes. with fma, packing keys and values of each head
+      does not pay off against the blocked gemms: bert-base(seqlen 128/384, head_dim 64) runs at 0.7-0.9x of the
+      unfused speed with fma and 0.8-1.07x with avx512, and short queries of decoding at 0.2-0.6x.
+    */
+    return !(isa & ppl::common::ISA_X86_FMA);
+}
+
+uint64_t multi_head_attention_fp32_get_buffer_bytes(
+    const int64_t batch,
+    const int64_t seqlen_kv,
+    const int64_t num_heads,
+    const int64_t head_dim)
+{
+    return multi_head_attention_packed_bytes_common(batch, seqlen_kv, num_heads, head_dim) +
+           multi_head_attention_thread_buffer_bytes_common(head_dim) * PPL_OMP_MAX_THREADS();
+}
+
+ppl::common::RetCode multi_head_attention_fp32(
+    const float *q,
+    const float *k,
+    const float *v,
+    const float *mask,
+    const int64_t batch,
+    const int64_t seqlen_q,
+    const int64_t seqlen_kv,
+    const int64_t num_heads,
+    const int64_t head_dim,
+    const int64_t mask_batch_stride,
+    const float scale,
+    void *temp_buffer,
+    float *dst)
+{
+    return multi_head_attention_fp32_common<multi_head_attention_vec_ops_scalar>(
+        q, k, v, mask, batch, seqlen_q, seqlen_kv, num_heads, head_dim, mask_batch_stride, scale, temp_buffer, dst);
+}
+
+}}}; // namespace ppl::kernel::x86
@@ -0,0 +1,80 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <immintrin.h>
+
+#include "ppl/kernel/x86/common/internal_include.h"
+#include "ppl/kernel/x86/common/math_sse.h"
+#include "ppl/kernel/x86/common/multi_head_attention/multi_head_attention_common.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+struct multi_head_attention_vec_ops_sse {
+    typedef __m128 vec_t;
+    static const int64_t simd_w = 4;
+
+    static inline vec_t load(const float *ptr) { return _mm_loadu_ps(ptr); }
+    static inline void store(float *ptr, const vec_t v) { _mm_storeu_ps(ptr, v); }
+    static inline vec_t set1(const float val) { return _mm_set1_ps(val); }
+    static inline vec_t add(const vec_t a, const vec_t b) { return _mm_add_ps(a, b); }
+    static inline vec_t sub(const vec_t a, const vec_t b) { return _mm_sub_ps(a, b); }
+    static inline vec_t max(const vec_t a, const vec_t b) { return _mm_max_ps(a, b); }
+    static inline vec_t mul(const vec_t a, const vec_t b) { return _mm_mul_ps(a, b); }
+    static inline vec_t fmadd(const vec_t a, const vec_t b, const vec_t c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    static inline vec_t exp(const vec_t a) { return _sse_exp_ps(a); }
+    static inline float reduce_add(const vec_t a)
+    {
+        float tmp[simd_w];
+        store(tmp, a);
+        float sum = 0.0f;
+        for (int64_t i = 0; i < simd_w; ++i) {
+            sum += tmp[i];
+        }
+        return sum;
+    }
+    static inline float reduce_max(const vec_t a)
+    {
+        float tmp[simd_w];
+        store(tmp, a);
+        float val = tmp[0];
+        for (int64_t i = 1; i < simd_w; ++i) {
+            val = tmp[i] > val ? tmp[i] : val;
+        }
+        return val;
+    }
+};
+
+ppl::common::RetCode multi_head_attention_fp32_sse(
+    const float *q,
+    const float *k,
+    const float *v,
+    const float *mask,
+    const int64_t batch,
+    const int64_t seqlen_q,
+    const int64_t seqlen_kv,
+    const int64_t num_heads,
+    const int64_t head_dim,
+    const int64_t mask_batch_stride,
+    const float scale,
+    void *temp_buffer,
+    float *dst)
+{
+    return multi_head_attention_fp32_common<multi_head_attention_vec_ops_sse>(
+        q, k, v, mask, batch, seqlen_q, seqlen_kv, num_heads, head_dim, mask_batch_stride, scale, temp_buffer, dst);
+}
+
+}}}; // namespace ppl::kernel::x86
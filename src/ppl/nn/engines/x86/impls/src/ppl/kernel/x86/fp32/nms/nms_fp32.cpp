@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "ppl/kernel/x86/common/internal_include.h"
+#include "ppl/kernel/x86/fp32/nms/nms_fp32_common.h"
 
 namespace ppl { namespace kernel { namespace x86 {
 
@@ -141,4 +142,23 @@ ppl::common::RetCode nms_ndarray_fp32(
     return nms_ndarray_naive(boxes, scommons, num_boxes_in, batch, num_classes, center_point_box, maxoutput_boxes_per_batch_per_class, iou_threshold, scommon_threshold, dst, num_boxes_out);
 }
 
+bool nms_ndarray_fp32_bitmask_is_preferred(
+    const uint32_t batch,
+    const uint32_t num_classes,
+    const int64_t num_candidates)
+{
+    // the bitmask costs num_candidates^2 / 8 bytes and does redundant work for boxes which are suppressed
+    return (int64_t)batch * num_classes < PPL_OMP_MAX_THREADS() && num_candidates <= NMS_BITMASK_MAX_BOXES();
+}
+
+uint64_t nms_ndarray_fp32_get_buffer_bytes(
+    const uint32_t num_boxes_in,
+    const uint32_t batch,
+    const uint32_t num_classes,
+    const int64_t topk,
+    const bool use_bitmask)
+{
+    return nms_fp32_init_buffer_layout(num_boxes_in, batch, num_classes, topk, use_bitmask).total_bytes;
+}
+
 }}}; // namespace ppl::kernel::x86
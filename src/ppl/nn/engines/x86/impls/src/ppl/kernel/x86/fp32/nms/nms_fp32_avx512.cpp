@@ -0,0 +1,43 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/kernel/x86/fp32/nms/nms_iou_kernel_fp32_avx512.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+ppl::common::RetCode nms_ndarray_fp32_avx512(
+    const float *boxes,
+    const float *scores,
+    const uint32_t num_boxes_in,
+    const uint32_t batch,
+    const uint32_t num_classes,
+    const bool center_point_box,
+    const int64_t max_output_boxes_per_batch_per_class,
+    const float iou_threshold,
+    const float score_threshold,
+    const int64_t topk,
+    const bool use_bitmask,
+    void *temp_buffer,
+    int64_t *dst,
+    int64_t *num_boxes_out)
+{
+    return nms_ndarray_fp32_parallel<nms_iou_kernel_fp32_avx512>(
+        boxes, scores, num_boxes_in, batch, num_classes, center_point_box, max_output_boxes_per_batch_per_class,
+        iou_threshold, score_threshold, topk, use_bitmask, temp_buffer, dst, num_boxes_out);
+}
+
+}}}; // namespace ppl::kernel::x86
@@ -0,0 +1,447 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef __ST_PPL_KERNEL_X86_FP32_NMS_NMS_FP32_COMMON_H_
+#define __ST_PPL_KERNEL_X86_FP32_NMS_NMS_FP32_COMMON_H_
+
+#include <string.h>
+#include <algorithm>
+
+#include "ppl/kernel/x86/common/internal_include.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+#define NMS_BOX_BLK()          64 // boxes per word of the suppression bitmask
+#define NMS_BITMASK_MAX_BOXES() 8192
+
+/*
+  boxes are converted to planar arrays once, so that iou of one box against a block of boxes is computed
+  with simd. corners are normalized the same way as calc_iou() of the scalar kernels, which keeps the
+  results bitwise identical.
+*/
+struct nms_fp32_planar {
+    float *x1;
+    float *y1;
+    float *x2;
+    float *y2;
+    float *w;
+    float *h;
+    float *area;
+};
+
+struct nms_fp32_box {
+    float x1, y1, x2, y2, w, h, area;
+};
+
+#define NMS_PLANAR_ARRAYS() 7
+
+inline nms_fp32_planar nms_fp32_init_planar(float *base, const int64_t stride)
+{
+    nms_fp32_planar p;
+    p.x1   = base + 0 * stride;
+    p.y1   = base + 1 * stride;
+    p.x2   = base + 2 * stride;
+    p.y2   = base + 3 * stride;
+    p.w    = base + 4 * stride;
+    p.h    = base + 5 * stride;
+    p.area = base + 6 * stride;
+    return p;
+}
+
+inline nms_fp32_box nms_fp32_load_box(const nms_fp32_planar &p, const int64_t i)
+{
+    nms_fp32_box b;
+    b.x1   = p.x1[i];
+    b.y1   = p.y1[i];
+    b.x2   = p.x2[i];
+    b.y2   = p.y2[i];
+    b.w    = p.w[i];
+    b.h    = p.h[i];
+    b.area = p.area[i];
+    return b;
+}
+
+inline void nms_fp32_store_box(const nms_fp32_box &b, const int64_t i, nms_fp32_planar *p)
+{
+    p->x1[i]   = b.x1;
+    p->y1[i]   = b.y1;
+    p->x2[i]   = b.x2;
+    p->y2[i]   = b.y2;
+    p->w[i]    = b.w;
+    p->h[i]    = b.h;
+    p->area[i] = b.area;
+}
+
+// onnx boxes: [x_center, y_center, width, height] or [y1, x1, y2, x2]
+inline nms_fp32_box nms_fp32_onnx_box(const float *b, const bool centered)
+{
+    nms_fp32_box r;
+    if (centered) {
+        r.w  = b[2];
+        r.h  = b[3];
+        r.x1 = b[0] - r.w / 2;
+        r.x2 = b[0] + r.w / 2;
+        r.y1 = b[1] - r.h / 2;
+        r.y2 = b[1] + r.h / 2;
+    } else {
+        r.w  = abs(b[1] - b[3]);
+        r.h  = abs(b[0] - b[2]);
+        r.x1 = min(b[1], b[3]);
+        r.x2 = max(b[1], b[3]);
+        r.y1 = min(b[0], b[2]);
+        r.y2 = max(b[0], b[2]);
+    }
+    r.area = r.w * r.h;
+    return r;
+}
+
+// mmcv boxes: [x1, y1, x2, y2]
+inline nms_fp32_box nms_fp32_mmcv_box(const float *b, const float offset)
+{
+    nms_fp32_box r;
+    r.x1   = b[0];
+    r.y1   = b[1];
+    r.x2   = b[2];
+    r.y2   = b[3];
+    r.w    = b[2] - b[0] + offset;
+    r.h    = b[3] - b[1] + offset;
+    r.area = r.w * r.h;
+    return r;
+}
+
+/*
+  keeps boxes whose score is greater than `score_threshold`(all boxes if `use_threshold` is false) and sorts
+  them like argsort(), by descending score and then ascending index. with `topk` > 0 only the topk highest
+  are partially selected before sorting.
+*/
+inline int64_t nms_fp32_select_candidates(
+    const float *scores,
+    const int64_t num_boxes,
+    const bool use_threshold,
+    const float score_threshold,
+    const int64_t topk,
+    uint32_t *candidates)
+{
+    int64_t num_candidates = 0;
+    for (int64_t i = 0; i < num_boxes; ++i) {
+        if (!use_threshold || scores[i] > score_threshold) {
+            candidates[num_candidates++] = i;
+        }
+    }
+
+    auto cmp = [scores](const uint32_t a, const uint32_t b) {
+        return scores[a] > scores[b] || (scores[a] == scores[b] && a < b);
+    };
+    if (topk > 0 && num_candidates > topk) {
+        std::nth_element(candidates, candidates + topk, candidates + num_candidates, cmp);
+        num_candidates = topk;
+    }
+    std::sort(candidates, candidates + num_candidates, cmp);
+    return num_candidates;
+}
+
+/*
+  temp buffer:
+  - planar boxes of each batch
+  - selected indices and their count of each (batch, class)
+  - greedy: candidates and planar selected boxes of each thread
+  - bitmask: candidates, planar sorted candidates, suppression bitmask and removed bits
+*/
+struct nms_fp32_buffer_layout {
+    int64_t planar_stride;
+    int64_t task_cap;
+    int64_t cand_cap;
+    int64_t sorted_stride;
+    int64_t mask_words;
+    uint64_t planar_offset;
+    uint64_t selected_offset;
+    uint64_t count_offset;
+    uint64_t scratch_offset;
+    uint64_t scratch_bytes; // per thread for greedy
+    uint64_t total_bytes;
+};
+
+inline nms_fp32_buffer_layout nms_fp32_init_buffer_layout(
+    const int64_t num_boxes,
+    const int64_t batch,
+    const int64_t num_classes,
+    const int64_t topk,
+    const bool use_bitmask)
+{
+    const uint64_t align = PPL_X86_CACHELINE_BYTES();
+    const int64_t tasks  = batch * num_classes;
+
+    nms_fp32_buffer_layout l;
+    l.cand_cap      = topk > 0 ? min<int64_t>(topk, num_boxes) : num_boxes;
+    // not bounded by max_output_boxes_per_batch_per_class, which is data, so that the size only depends on shapes
+    l.task_cap      = max<int64_t>(l.cand_cap, 1);
+    l.planar_stride = round_up(max<int64_t>(num_boxes, 1), NMS_BOX_BLK());
+    l.sorted_stride = round_up(max<int64_t>(use_bitmask ? l.cand_cap : l.task_cap, 1), NMS_BOX_BLK());
+    l.mask_words    = l.sorted_stride / NMS_BOX_BLK();
+
+    l.planar_offset   = 0;
+    l.selected_offset = l.planar_offset + round_up(batch * NMS_PLANAR_ARRAYS() * l.planar_stride * sizeof(float), align);
+    l.count_offset    = l.selected_offset + round_up(tasks * l.task_cap * sizeof(uint32_t), align);
+    l.scratch_offset  = l.count_offset + round_up(tasks * sizeof(int64_t), align);
+
+    l.scratch_bytes = round_up(num_boxes * sizeof(uint32_t), align) +
+                      round_up(NMS_PLANAR_ARRAYS() * l.sorted_stride * sizeof(float), align);
+    if (use_bitmask) {
+        l.scratch_bytes += round_up(l.cand_cap * l.mask_words * sizeof(uint64_t), align) +
+                           round_up(l.mask_words * sizeof(uint64_t), align);
+        l.total_bytes = l.scratch_offset + l.scratch_bytes;
+    } else {
+        l.total_bytes = l.scratch_offset + l.scratch_bytes * PPL_OMP_MAX_THREADS();
+    }
+    return l;
+}
+
+/*
+  iou_kernel_t provides, for box `a` against planar boxes `b`:
+  - any_suppress<mmcv>(a, b, count, ...): whether any of the first `count` boxes suppresses `a`
+  - suppress_bits<mmcv>(a, b, j, ...): suppression bits of boxes [j, j + NMS_BOX_BLK())
+  onnx boxes are suppressed when iou > iou_threshold, mmcv boxes when iou >= iou_threshold.
+*/
+template <typename iou_kernel_t, bool mmcv>
+int64_t nms_fp32_greedy(
+    const nms_fp32_planar &boxes,
+    const uint32_t *candidates,
+    const int64_t num_candidates,
+    const int64_t max_output,
+    const float iou_threshold,
+    const float offset,
+    nms_fp32_planar *selected,
+    uint32_t *selected_index)
+{
+    int64_t selected_num = 0;
+    for (int64_t i = 0; i < num_candidates; ++i) {
+        const nms_fp32_box box = nms_fp32_load_box(boxes, candidates[i]);
+        if (!iou_kernel_t::template any_suppress<mmcv>(box, *selected, selected_num, iou_threshold, offset)) {
+            nms_fp32_store_box(box, selected_num, selected);
+            selected_index[selected_num++] = candidates[i];
+        }
+        if (selected_num >= max_output) {
+            break;
+        }
+    }
+    return selected_num;
+}
+
+template <typename iou_kernel_t, bool mmcv>
+int64_t nms_fp32_bitmask(
+    const nms_fp32_planar &boxes,
+    const uint32_t *candidates,
+    const int64_t num_candidates,
+    const int64_t max_output,
+    const float iou_threshold,
+    const float offset,
+    const int64_t sorted_stride,
+    nms_fp32_planar *sorted,
+    uint64_t *mask,
+    uint64_t *removed,
+    uint32_t *selected_index)
+{
+    if (num_candidates == 0) {
+        return 0;
+    }
+    const int64_t words = div_up(num_candidates, NMS_BOX_BLK());
+
+    PRAGMA_OMP_PARALLEL_FOR()
+    for (int64_t i = 0; i < sorted_stride; ++i) {
+        if (i < num_candidates) {
+            nms_fp32_store_box(nms_fp32_load_box(boxes, candidates[i]), i, sorted);
+        } else {
+            nms_fp32_store_box(nms_fp32_box{0, 0, 0, 0, 0, 0, 0}, i, sorted);
+        }
+    }
+
+    // row i holds boxes after i which are suppressed by box i, so rows are filled in parallel
+    const uint64_t tail_bits = num_candidates % NMS_BOX_BLK() ? (1ull << (num_candidates % NMS_BOX_BLK())) - 1 : ~0ull;
+    PRAGMA_OMP_PARALLEL_FOR_SCHEDULE(dynamic)
+    for (int64_t i = 0; i < num_candidates; ++i) {
+        const nms_fp32_box box = nms_fp32_load_box(*sorted, i);
+        uint64_t *row          = mask + i * words;
+        for (int64_t w = i / NMS_BOX_BLK(); w < words; ++w) {
+            uint64_t bits = iou_kernel_t::template suppress_bits<mmcv>(box, *sorted, w * NMS_BOX_BLK(), iou_threshold, offset);
+            if (w == i / NMS_BOX_BLK()) {
+                bits &= ~((2ull << (i % NMS_BOX_BLK())) - 1);
+            }
+            if (w == words - 1) {
+                bits &= tail_bits;
+            }
+            row[w] = bits;
+        }
+    }
+
+    memset(removed, 0, words * sizeof(uint64_t));
+    int64_t selected_num = 0;
+    for (int64_t i = 0; i < num_candidates; ++i) {
+        if (!(removed[i / NMS_BOX_BLK()] & (1ull << (i % NMS_BOX_BLK())))) {
+            selected_index[selected_num++] = candidates[i];
+            const uint64_t *row = mask + i * words;
+            for (int64_t w = i / NMS_BOX_BLK(); w < words; ++w) {
+                removed[w] |= row[w];
+            }
+        }
+        if (selected_num >= max_output) {
+            break;
+        }
+    }
+    return selected_num;
+}
+
+template <typename iou_kernel_t>
+ppl::common::RetCode nms_ndarray_fp32_parallel(
+    const float *boxes,
+    const float *scores,
+    const uint32_t num_boxes_in,
+    const uint32_t batch,
+    const uint32_t num_classes,
+    const bool center_point_box,
+    const int64_t max_output_boxes_per_batch_per_class,
+    const float iou_threshold,
+    const float score_threshold,
+    const int64_t topk,
+    const bool use_bitmask,
+    void *temp_buffer,
+    int64_t *dst,
+    int64_t *num_boxes_out)
+{
+    const int64_t num_boxes = num_boxes_in;
+    const int64_t tasks     = (int64_t)batch * num_classes;
+    const nms_fp32_buffer_layout l = nms_fp32_init_buffer_layout(
+        num_boxes, batch, num_classes, topk, use_bitmask);
+
+    char *base              = (char *)temp_buffer;
+    float *planar_base      = (float *)(base + l.planar_offset);
+    uint32_t *selected_base = (uint32_t *)(base + l.selected_offset);
+    int64_t *selected_count = (int64_t *)(base + l.count_offset);
+
+    PRAGMA_OMP_PARALLEL_FOR()
+    for (int64_t i = 0; i < batch * num_boxes; ++i) {
+        const int64_t b = i / num_boxes;
+        auto planar     = nms_fp32_init_planar(planar_base + b * NMS_PLANAR_ARRAYS() * l.planar_stride, l.planar_stride);
+        nms_fp32_store_box(nms_fp32_onnx_box(boxes + i * 4, center_point_box), i % num_boxes, &planar);
+    }
+
+    if (use_bitmask) {
+        char *scratch      = base + l.scratch_offset;
+        uint32_t *cand     = (uint32_t *)scratch;
+        scratch += round_up(num_boxes * sizeof(uint32_t), PPL_X86_CACHELINE_BYTES());
+        auto sorted        = nms_fp32_init_planar((float *)scratch, l.sorted_stride);
+        scratch += round_up(NMS_PLANAR_ARRAYS() * l.sorted_stride * sizeof(float), PPL_X86_CACHELINE_BYTES());
+        uint64_t *mask     = (uint64_t *)scratch;
+        scratch += round_up(l.cand_cap * l.mask_words * sizeof(uint64_t), PPL_X86_CACHELINE_BYTES());
+        uint64_t *removed  = (uint64_t *)scratch;
+        for (int64_t t = 0; t < tasks; ++t) {
+            const int64_t b    = t / num_classes;
+            const auto planar  = nms_fp32_init_planar(planar_base + b * NMS_PLANAR_ARRAYS() * l.planar_stride, l.planar_stride);
+            const int64_t num_cand = nms_fp32_select_candidates(scores + t * num_boxes, num_boxes, true, score_threshold, topk, cand);
+            selected_count[t] = nms_fp32_bitmask<iou_kernel_t, false>(
+                planar, cand, num_cand, max_output_boxes_per_batch_per_class, iou_threshold, 0.0f,
+                l.sorted_stride, &sorted, mask, removed, selected_base + t * l.task_cap);
+        }
+    } else {
+        PRAGMA_OMP_PARALLEL_FOR_SCHEDULE(dynamic)
+        for (int64_t t = 0; t < tasks; ++t) {
+            char *scratch     = base + l.scratch_offset + PPL_OMP_THREAD_ID() * l.scratch_bytes;
+            uint32_t *cand    = (uint32_t *)scratch;
+            scratch += round_up(num_boxes * sizeof(uint32_t), PPL_X86_CACHELINE_BYTES());
+            auto selected     = nms_fp32_init_planar((float *)scratch, l.sorted_stride);
+            const int64_t b   = t / num_classes;
+            const auto planar = nms_fp32_init_planar(planar_base + b * NMS_PLANAR_ARRAYS() * l.planar_stride, l.planar_stride);
+            const int64_t num_cand = nms_fp32_select_candidates(scores + t * num_boxes, num_boxes, true, score_threshold, topk, cand);
+            selected_count[t] = nms_fp32_greedy<iou_kernel_t, false>(
+                planar, cand, num_cand, max_output_boxes_per_batch_per_class, iou_threshold, 0.0f,
+                &selected, selected_base + t * l.task_cap);
+        }
+    }
+
+    int64_t out_num = 0;
+    for (int64_t t = 0; t < tasks; ++t) {
+        const int64_t count = selected_count[t];
+        selected_count[t]   = out_num;
+        out_num += count;
+    }
+    PRAGMA_OMP_PARALLEL_FOR()
+    for (int64_t t = 0; t < tasks; ++t) {
+        const int64_t count      = (t + 1 < tasks ? selected_count[t + 1] : out_num) - selected_count[t];
+        const uint32_t *selected = selected_base + t * l.task_cap;
+        int64_t *l_dst           = dst + selected_count[t] * 3;
+        for (int64_t i = 0; i < count; ++i) {
+            l_dst[i * 3 + 0] = t / num_classes;
+            l_dst[i * 3 + 1] = t % num_classes;
+            l_dst[i * 3 + 2] = selected[i];
+        }
+    }
+
+    *num_boxes_out = out_num;
+    return ppl::common::RC_SUCCESS;
+}
+
+template <typename iou_kernel_t>
+ppl::common::RetCode mmcv_nms_ndarray_fp32_parallel(
+    const float *boxes,
+    const float *scores,
+    const uint32_t num_boxes_in,
+    const float iou_threshold,
+    const int64_t offset,
+    const bool use_bitmask,
+    void *temp_buffer,
+    int64_t *dst,
+    int64_t *num_boxes_out)
+{
+    const int64_t num_boxes        = num_boxes_in;
+    const nms_fp32_buffer_layout l = nms_fp32_init_buffer_layout(num_boxes, 1, 1, 0, use_bitmask);
+
+    char *base               = (char *)temp_buffer;
+    auto planar              = nms_fp32_init_planar((float *)(base + l.planar_offset), l.planar_stride);
+    uint32_t *selected_index = (uint32_t *)(base + l.selected_offset);
+    char *scratch            = base + l.scratch_offset;
+    uint32_t *cand           = (uint32_t *)scratch;
+    scratch += round_up(num_boxes * sizeof(uint32_t), PPL_X86_CACHELINE_BYTES());
+    auto sorted              = nms_fp32_init_planar((float *)scratch, l.sorted_stride);
+    scratch += round_up(NMS_PLANAR_ARRAYS() * l.sorted_stride * sizeof(float), PPL_X86_CACHELINE_BYTES());
+
+    PRAGMA_OMP_PARALLEL_FOR()
+    for (int64_t i = 0; i < num_boxes; ++i) {
+        nms_fp32_store_box(nms_fp32_mmcv_box(boxes + i * 4, offset), i, &planar);
+    }
+
+    const int64_t num_cand = nms_fp32_select_candidates(scores, num_boxes, false, 0.0f, 0, cand);
+    int64_t selected_num   = 0;
+    if (use_bitmask) {
+        uint64_t *mask    = (uint64_t *)scratch;
+        scratch += round_up(l.cand_cap * l.mask_words * sizeof(uint64_t), PPL_X86_CACHELINE_BYTES());
+        uint64_t *removed = (uint64_t *)scratch;
+        selected_num      = nms_fp32_bitmask<iou_kernel_t, true>(
+            planar, cand, num_cand, num_boxes, iou_threshold, offset, l.sorted_stride, &sorted, mask, removed, selected_index);
+    } else {
+        selected_num = nms_fp32_greedy<iou_kernel_t, true>(
+            planar, cand, num_cand, num_boxes, iou_threshold, offset, &sorted, selected_index);
+    }
+
+    for (int64_t i = 0; i < selected_num; ++i) {
+        dst[i] = selected_index[i];
+    }
+    *num_boxes_out = selected_num;
+    return ppl::common::RC_SUCCESS;
+}
+
+}}}; // namespace ppl::kernel::x86
+
+#endif
@@ -0,0 +1,113 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef __ST_PPL_KERNEL_X86_FP32_NMS_NMS_IOU_KERNEL_FP32_AVX512_H_
+#define __ST_PPL_KERNEL_X86_FP32_NMS_NMS_IOU_KERNEL_FP32_AVX512_H_
+
+#include <immintrin.h>
+
+#include "ppl/kernel/x86/fp32/nms/nms_fp32_common.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+struct nms_iou_kernel_fp32_avx512 {
+    static const int64_t simd_w = 16;
+
+    struct box_vec {
+        __m512 x1, y1, x2, y2, w, h, area;
+    };
+
+    static inline box_vec broadcast(const nms_fp32_box &a)
+    {
+        box_vec v;
+        v.x1   = _mm512_set1_ps(a.x1);
+        v.y1   = _mm512_set1_ps(a.y1);
+        v.x2   = _mm512_set1_ps(a.x2);
+        v.y2   = _mm512_set1_ps(a.y2);
+        v.w    = _mm512_set1_ps(a.w);
+        v.h    = _mm512_set1_ps(a.h);
+        v.area = _mm512_set1_ps(a.area);
+        return v;
+    }
+
+    // lanes of boxes [j, j + simd_w) suppressed by `a`, or suppressing `a`(iou is symmetric)
+    template <bool mmcv>
+    static inline __mmask16 suppress(const box_vec &a, const nms_fp32_planar &b, const int64_t j, const __m512 &thr, const __m512 &offset)
+    {
+        const __m512 bx1 = _mm512_loadu_ps(b.x1 + j);
+        const __m512 by1 = _mm512_loadu_ps(b.y1 + j);
+        const __m512 bx2 = _mm512_loadu_ps(b.x2 + j);
+        const __m512 by2 = _mm512_loadu_ps(b.y2 + j);
+        const __m512 barea = _mm512_loadu_ps(b.area + j);
+        if (mmcv) {
+            const __m512 zero = _mm512_setzero_ps();
+            const __m512 iw = _mm512_max_ps(zero, _mm512_add_ps(_mm512_sub_ps(_mm512_min_ps(a.x2, bx2), _mm512_max_ps(a.x1, bx1)), offset));
+            const __m512 ih = _mm512_max_ps(zero, _mm512_add_ps(_mm512_sub_ps(_mm512_min_ps(a.y2, by2), _mm512_max_ps(a.y1, by1)), offset));
+            const __m512 inter = _mm512_mul_ps(iw, ih);
+            const __m512 iou = _mm512_div_ps(inter, _mm512_sub_ps(_mm512_add_ps(a.area, barea), inter));
+            return _mm512_cmp_ps_mask(iou, thr, _CMP_GE_OQ);
+        } else {
+            const __m512 bw = _mm512_loadu_ps(b.w + j);
+            const __m512 bh = _mm512_loadu_ps(b.h + j);
+            const __m512 iw = _mm512_sub_ps(_mm512_add_ps(a.w, bw), _mm512_sub_ps(_mm512_max_ps(a.x2, bx2), _mm512_min_ps(a.x1, bx1)));
+            const __m512 ih = _mm512_sub_ps(_mm512_add_ps(a.h, bh), _mm512_sub_ps(_mm512_max_ps(a.y2, by2), _mm512_min_ps(a.y1, by1)));
+            const __mmask16 overlap = _mm512_cmp_ps_mask(iw, _mm512_setzero_ps(), _CMP_GT_OQ) &
+                                      _mm512_cmp_ps_mask(ih, _mm512_setzero_ps(), _CMP_GT_OQ);
+            const __m512 inter = _mm512_mul_ps(ih, iw);
+            const __m512 iou = _mm512_maskz_div_ps(overlap, inter, _mm512_sub_ps(_mm512_add_ps(a.area, barea), inter));
+            return _mm512_cmp_ps_mask(iou, thr, _CMP_GT_OQ);
+        }
+    }
+
+    template <bool mmcv>
+    static inline bool any_suppress(const nms_fp32_box &a, const nms_fp32_planar &b, const int64_t count, const float iou_threshold, const float offset)
+    {
+        const box_vec va = broadcast(a);
+        const __m512 thr = _mm512_set1_ps(iou_threshold);
+        const __m512 off = _mm512_set1_ps(offset);
+        int64_t j = 0;
+        for (; j + simd_w <= count; j += simd_w) {
+            if (suppress<mmcv>(va, b, j, thr, off)) {
+                return true;
+            }
+        }
+        if (j < count) {
+            const __mmask16 valid = (__mmask16)((1u << (count - j)) - 1);
+            if (valid & suppress<mmcv>(va, b, j, thr, off)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <bool mmcv>
+    static inline uint64_t suppress_bits(const nms_fp32_box &a, const nms_fp32_planar &b, const int64_t j, const float iou_threshold, const float offset)
+    {
+        const box_vec va = broadcast(a);
+        const __m512 thr = _mm512_set1_ps(iou_threshold);
+        const __m512 off = _mm512_set1_ps(offset);
+        uint64_t bits = 0;
+        for (int64_t k = 0; k < NMS_BOX_BLK(); k += simd_w) {
+            bits |= (uint64_t)suppress<mmcv>(va, b, j + k, thr, off) << k;
+        }
+        return bits;
+    }
+};
+
+}}}; // namespace ppl::kernel::x86
+
+#endif
@@ -0,0 +1,109 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <immintrin.h>
+#include <string.h>
+
+#include "ppl/kernel/x86/common/internal_include.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+static inline __m256 cvt_8xu8_ps_avx(const uint8_t *src)
+{
+    int32_t lo, hi;
+    memcpy(&lo, src, sizeof(lo));
+    memcpy(&hi, src + 4, sizeof(hi));
+    const __m128 v_lo = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(lo)));
+    const __m128 v_hi = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(hi)));
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(v_lo), v_hi, 1);
+}
+
+ppl::common::RetCode reorder_nxc_u8_n16cx_fp32_avx(
+    const ppl::nn::TensorShape *dst_shape,
+    const uint8_t *src,
+    const float *mean,
+    const float *scale,
+    float *dst)
+{
+    if (dst_shape->GetDimCount() < 3) {
+        return ppl::common::RC_UNSUPPORTED;
+    }
+
+    const int64_t batch    = dst_shape->GetDim(0);
+    const int64_t channels = dst_shape->GetDim(1);
+    const int64_t X        = dst_shape->GetElementsExcludingPadding() / batch / channels;
+
+    const int64_t simd_w   = 8;
+    const int64_t c_blk    = 16;
+    const int64_t padded_c = round_up(channels, c_blk);
+
+    // padded channels get zero scale, so they are filled with zeros without a branch
+    float *padded_mean  = (float*)ppl::common::AlignedAlloc(2 * padded_c * sizeof(float), PPL_X86_CACHELINE_BYTES());
+    if (!padded_mean) {
+        return ppl::common::RC_OUT_OF_MEMORY;
+    }
+    float *padded_scale = padded_mean + padded_c;
+    for (int64_t c = 0; c < padded_c; ++c) {
+        padded_mean[c]  = (mean && c < channels) ? mean[c] : 0.0f;
+        padded_scale[c] = c < channels ? (scale ? scale[c] : 1.0f) : 0.0f;
+    }
+
+    const int64_t full_c = round(channels, c_blk);
+
+#ifdef PPL_USE_X86_OMP_COLLAPSE
+    PRAGMA_OMP_PARALLEL_FOR_COLLAPSE(2)
+#endif
+    for (int64_t b = 0; b < batch; ++b) {
+#ifndef PPL_USE_X86_OMP_COLLAPSE
+        PRAGMA_OMP_PARALLEL_FOR()
+#endif
+        for (int64_t x = 0; x < X; ++x) {
+            const uint8_t *lsrc = src + (b * X + x) * channels;
+            float *ldst         = dst + b * padded_c * X + x * c_blk;
+            for (int64_t c = 0; c < full_c; c += c_blk) {
+                __m256 v_src0 = cvt_8xu8_ps_avx(lsrc + c + 0 * simd_w);
+                __m256 v_src1 = cvt_8xu8_ps_avx(lsrc + c + 1 * simd_w);
+                v_src0 = _mm256_mul_ps(_mm256_sub_ps(v_src0, _mm256_loadu_ps(padded_mean + c + 0 * simd_w)),
+                                       _mm256_loadu_ps(padded_scale + c + 0 * simd_w));
+                v_src1 = _mm256_mul_ps(_mm256_sub_ps(v_src1, _mm256_loadu_ps(padded_mean + c + 1 * simd_w)),
+                                       _mm256_loadu_ps(padded_scale + c + 1 * simd_w));
+                _mm256_storeu_ps(ldst + c * X + 0 * simd_w, v_src0);
+                _mm256_storeu_ps(ldst + c * X + 1 * simd_w, v_src1);
+            }
+            if (full_c < channels) {
+                // copies the tail to avoid reading past the end of src
+                uint8_t tail[16] = {0};
+                memcpy(tail, lsrc + full_c, channels - full_c);
+                __m256 v_src0 = cvt_8xu8_ps_avx(tail + 0 * simd_w);
+                __m256 v_src1 = cvt_8xu8_ps_avx(tail + 1 * simd_w);
+                v_src0 = _mm256_mul_ps(_mm256_sub_ps(v_src0, _mm256_loadu_ps(padded_mean + full_c + 0 * simd_w)),
+                                       _mm256_loadu_ps(padded_scale + full_c + 0 * simd_w));
+                v_src1 = _mm256_mul_ps(_mm256_sub_ps(v_src1, _mm256_loadu_ps(padded_mean + full_c + 1 * simd_w)),
+                                       _mm256_loadu_ps(padded_scale + full_c + 1 * simd_w));
+                _mm256_storeu_ps(ldst + full_c * X + 0 * simd_w, v_src0);
+                _mm256_storeu_ps(ldst + full_c * X + 1 * simd_w, v_src1);
+            }
+        }
+    }
+
+    ppl::common::AlignedFree(padded_mean);
+
+    return ppl::common::RC_SUCCESS;
+}
+
+}}}; // namespace ppl::kernel::x86
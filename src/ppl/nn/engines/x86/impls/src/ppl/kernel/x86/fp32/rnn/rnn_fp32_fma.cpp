@@ -0,0 +1,200 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <math.h>
+#include <immintrin.h>
+
+#include "ppl/kernel/x86/common/internal_include.h"
+#include "ppl/kernel/x86/fp32/rnn.h"
+#include "ppl/kernel/x86/fp32/gemm.h"
+#include "ppl/kernel/x86/common/avx_tools.h"
+#include "ppl/kernel/x86/common/math_fma.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+static const int64_t ACT_H_BLK = 64;
+
+// Ht = tanh(gate)
+static inline void rnn_fp32_fma_update_hidden(
+    const float *gI,
+    const int64_t length,
+    float *Ht,
+    float *Yt)
+{
+    const int64_t simd_w = 8;
+    int64_t h = 0;
+    for (; h <= length - simd_w; h += simd_w) {
+        const __m256 hn = _fma_tanh_ps(_mm256_loadu_ps(gI + h));
+        _mm256_storeu_ps(Ht + h, hn);
+        if (Yt) _mm256_storeu_ps(Yt + h, hn);
+    }
+    for (; h < length; ++h) {
+        Ht[h] = ::tanhf(gI[h]);
+        if (Yt) Yt[h] = Ht[h];
+    }
+}
+
+uint64_t rnn_fp32_fma_get_buffer_bytes(
+    const ppl::nn::TensorShape *X_shape,
+    const rnn_direction_t direction,
+    const int64_t hidden_size,
+    const bool has_Y,
+    const bool has_Y_h)
+{
+    if (!has_Y && !has_Y_h)
+        return 64u;
+
+    const int64_t seq_len = X_shape->GetDim(0);
+    const int64_t batch = X_shape->GetDim(1);
+    const int64_t num_direction = direction == rnn_direction::BIDIRECTIONAL ? 2 : 1;
+
+    const uint64_t packed_r_size = round_up(gemm_fp32_fma_get_packed_b_bytes(hidden_size, hidden_size) / sizeof(float), 16);
+    const uint64_t bias_size = round_up(hidden_size, 16);
+    const uint64_t gate_buff_size = seq_len * batch * hidden_size;
+    const uint64_t yh_size = has_Y_h ? 0 : num_direction * batch * hidden_size;
+
+    return (packed_r_size + bias_size + gate_buff_size + yh_size) * sizeof(float);
+}
+
+/*
+  same structure as lstm_fp32_fma(): input projections of all timesteps are computed by one gemm
+  before the recurrence and recurrent weights are packed once per direction.
+*/
+ppl::common::RetCode rnn_fp32_fma(
+    const ppl::nn::TensorShape *X_shape,
+    const float *X,
+    const float *X_weight,
+    const float *R_weight,
+    const float *bias,
+    const int32_t *sequence_lens,
+    const float *initial_h,
+    const rnn_direction_t direction,
+    const int64_t hidden_size,
+    void *temp_buffer,
+    float *Y,
+    float *Y_h)
+{
+    if (!Y && !Y_h) {
+        return ppl::common::RC_SUCCESS;
+    }
+
+    const int64_t num_direction = direction == rnn_direction::BIDIRECTIONAL ? 2 : 1;
+    const int64_t seq_len = X_shape->GetDim(0);
+    const int64_t batch = X_shape->GetDim(1);
+    const int64_t input_size = X_shape->GetDim(2);
+
+    // set temp buffer
+    float *temp_buffer_fp32 = reinterpret_cast<float*>(temp_buffer);
+    float *packed_R = temp_buffer_fp32;
+    temp_buffer_fp32 += round_up(gemm_fp32_fma_get_packed_b_bytes(hidden_size, hidden_size) / sizeof(float), 16);
+    float *sum_bias = temp_buffer_fp32;
+    temp_buffer_fp32 += round_up(hidden_size, 16);
+    float *gate_buf = temp_buffer_fp32;
+    temp_buffer_fp32 += seq_len * batch * hidden_size;
+
+    float *Yh_buf = Y_h;
+    if (!Yh_buf) {
+        Yh_buf = temp_buffer_fp32;
+        temp_buffer_fp32 += num_direction * batch * hidden_size;
+    }
+
+    const int64_t h_tasks = div_up(hidden_size, ACT_H_BLK);
+
+    for (int64_t nd = 0; nd < num_direction; ++nd) {
+        const bool is_reverse = nd || (direction == rnn_direction::REVERSE);
+
+        float *nd_Yh = Yh_buf + nd * batch * hidden_size;
+        float *nd_Y = Y ? Y + nd * batch * hidden_size : nullptr;
+
+        const float *nd_W = X_weight + nd * hidden_size * input_size;
+        const float *nd_R = R_weight + nd * hidden_size * hidden_size;
+        const float *nd_Wb = bias ? bias + nd * 2 * hidden_size : nullptr;
+        const float *nd_Rb = bias ? nd_Wb + hidden_size : nullptr;
+
+        const float *nd_init_h = initial_h ? initial_h + nd * batch * hidden_size : nullptr;
+
+        if (bias) {
+            for (int64_t i = 0; i < hidden_size; ++i) {
+                sum_bias[i] = nd_Wb[i] + nd_Rb[i];
+            }
+        }
+
+        // X (seq_len, batch, input_size)
+        // h_0 (num_direction, batch, hidden_size)
+        // Y (seq_len, num_direction, batch, hidden_size)
+        // h_n (num_direction, batch, hidden_size)
+
+        auto ret = gemm_fp32_fma( // gate[:] = X[:]*W[nd]^T+Wb+Rb
+            X, nd_W, bias ? sum_bias : nullptr, nullptr,
+            gemm_m_type::NOTRANS, gemm_m_type::TRANS,
+            bias ? gemm_v_type::ROW_VEC : gemm_v_type::EMPTY, gemm_m_type::EMPTY,
+            seq_len * batch, hidden_size, input_size,
+            input_size, input_size, hidden_size, 0,
+            1.0f, 0.0f, 1.0f, 0.0f, gemm_post::NONE, gate_buf);
+        if (ret != ppl::common::RC_SUCCESS) {
+            return ret;
+        }
+
+        ret = gemm_fp32_fma_pack_b(nd_R, gemm_m_type::TRANS, hidden_size, hidden_size, hidden_size, packed_R);
+        if (ret != ppl::common::RC_SUCCESS) {
+            return ret;
+        }
+
+        if (!nd_init_h) {
+            memset32_avx(nd_Yh, 0, batch * hidden_size);
+        }
+
+        for (int64_t seq_idx = 0; seq_idx < seq_len; ++seq_idx) {
+            const int64_t mapped_seq_index = is_reverse ? (seq_len - seq_idx - 1) : seq_idx;
+            const float *Y_h_prev = (seq_idx == 0 && nd_init_h) ? nd_init_h : nd_Yh;
+            float *sY = nd_Y ? nd_Y + mapped_seq_index * num_direction * batch * hidden_size : nullptr;
+            float *sgate = gate_buf + mapped_seq_index * batch * hidden_size;
+
+            ret = gemm_fp32_fma( // gate[s] += h_{t-1}[nd]*R[nd]^T
+                Y_h_prev, packed_R, nullptr, nullptr,
+                gemm_m_type::NOTRANS, gemm_m_type::PACKED,
+                gemm_v_type::EMPTY, gemm_m_type::EMPTY,
+                batch, hidden_size, hidden_size,
+                hidden_size, hidden_size, hidden_size, 0,
+                1.0f, 1.0f, 0.0f, 0.0f, gemm_post::NONE, sgate);
+            if (ret != ppl::common::RC_SUCCESS) {
+                return ret;
+            }
+
+PRAGMA_OMP_PARALLEL_FOR()
+            for (int64_t t = 0; t < batch * h_tasks; ++t) {
+                const int64_t b = t / h_tasks;
+                const int64_t hb = (t % h_tasks) * ACT_H_BLK;
+                const int64_t h_eff = min(hidden_size - hb, ACT_H_BLK);
+
+                float *Ht = nd_Yh + b * hidden_size + hb;
+                float *Yt = sY ? sY + b * hidden_size + hb : nullptr;
+                if (!sequence_lens || mapped_seq_index < sequence_lens[b]) {
+                    rnn_fp32_fma_update_hidden(sgate + b * hidden_size + hb, h_eff, Ht, Yt);
+                } else { // pass through the hidden state, output zeros
+                    memcpy32_avx(Ht, Y_h_prev + b * hidden_size + hb, h_eff);
+                    if (Yt) memset32_avx(Yt, 0, h_eff);
+                }
+            }
+        }
+    }
+
+    return ppl::common::RC_SUCCESS;
+}
+
+}}}; // namespace ppl::kernel::x86
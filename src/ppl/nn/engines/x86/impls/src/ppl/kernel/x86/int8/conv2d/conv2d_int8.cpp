@@ -0,0 +1,187 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <string.h>
+
+#include "ppl/kernel/x86/common/internal_include.h"
+#include "ppl/kernel/x86/int8/conv2d.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+static inline int64_t conv2d_int8_get_k(const conv2d_int8_param &param)
+{
+    return param.channels / param.group * param.kernel_h * param.kernel_w;
+}
+
+uint64_t conv2d_int8_get_packed_weight_bytes(
+    const conv2d_int8_param &param)
+{
+    const int64_t oc_per_gp = param.num_output / param.group;
+    return param.group * gemm_s8u8_get_packed_a_bytes(gemm_s8u8_layout::ROW_A, oc_per_gp, conv2d_int8_get_k(param));
+}
+
+ppl::common::RetCode conv2d_int8_quantize_pack_weight(
+    const ppl::common::isa_t isa,
+    const conv2d_int8_param &param,
+    const float *weight,
+    int8_t *packed_weight,
+    float *w_scale,
+    int32_t *w_sum)
+{
+    const int64_t oc_per_gp    = param.num_output / param.group;
+    const int64_t K            = conv2d_int8_get_k(param);
+    const uint64_t packed_size = gemm_s8u8_get_packed_a_bytes(gemm_s8u8_layout::ROW_A, oc_per_gp, K);
+
+    for (int64_t g = 0; g < param.group; ++g) {
+        auto status = gemm_s8u8_quantize_pack_a(
+            isa, gemm_s8u8_layout::ROW_A, weight + g * oc_per_gp * K, oc_per_gp, K, K,
+            packed_weight + g * packed_size, w_scale + g * oc_per_gp, w_sum + g * oc_per_gp);
+        if (status != ppl::common::RC_SUCCESS) {
+            return status;
+        }
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+uint64_t conv2d_int8_get_temp_buffer_bytes(
+    const conv2d_int8_param &param,
+    const ppl::nn::TensorShape *dst_shape)
+{
+    const int64_t dst_hw = dst_shape->GetDim(2) * dst_shape->GetDim(3);
+    return gemm_s8u8_get_packed_b_bytes(gemm_s8u8_layout::ROW_A, dst_hw, conv2d_int8_get_k(param));
+}
+
+// [ic_per_gp][src_h][src_w] -> [div_up(K, 4)][ldb][4], out of bound pixels are filled with zero point
+static void conv2d_int8_im2col(
+    const conv2d_int8_param &param,
+    const uint8_t *src,
+    const int64_t src_h,
+    const int64_t src_w,
+    const int64_t dst_h,
+    const int64_t dst_w,
+    const uint8_t pad_value,
+    const int64_t ldb,
+    uint8_t *col)
+{
+    const int64_t kernel_hw = param.kernel_h * param.kernel_w;
+    const int64_t K         = conv2d_int8_get_k(param);
+    const int64_t Kq        = div_up(K, GEMM_S8U8_K_ALIGN);
+    const int64_t K_A       = GEMM_S8U8_K_ALIGN;
+
+    PRAGMA_OMP_PARALLEL_FOR()
+    for (int64_t kq = 0; kq < Kq; ++kq) {
+        uint8_t *l_col = col + kq * ldb * K_A;
+        if (kq * K_A + K_A > K) {
+            memset(l_col, 0, ldb * K_A);
+        }
+        for (int64_t kr = 0; kr < K_A && kq * K_A + kr < K; ++kr) {
+            const int64_t k  = kq * K_A + kr;
+            const int64_t ic = k / kernel_hw;
+            const int64_t kh = k % kernel_hw / param.kernel_w;
+            const int64_t kw = k % param.kernel_w;
+
+            const uint8_t *l_src = src + ic * src_h * src_w;
+            for (int64_t oh = 0; oh < dst_h; ++oh) {
+                const int64_t ih = oh * param.stride_h - param.pad_h + kh * param.dilation_h;
+                uint8_t *ll_col  = l_col + oh * dst_w * K_A + kr;
+                if (ih < 0 || ih >= src_h) {
+                    for (int64_t ow = 0; ow < dst_w; ++ow) {
+                        ll_col[ow * K_A] = pad_value;
+                    }
+                    continue;
+                }
+                const uint8_t *ll_src = l_src + ih * src_w;
+                for (int64_t ow = 0; ow < dst_w; ++ow) {
+                    const int64_t iw = ow * param.stride_w - param.pad_w + kw * param.dilation_w;
+                    ll_col[ow * K_A] = (iw < 0 || iw >= src_w) ? pad_value : ll_src[iw];
+                }
+            }
+        }
+    }
+}
+
+ppl::common::RetCode conv2d_int8(
+    const ppl::common::isa_t isa,
+    const conv2d_int8_param &param,
+    const ppl::nn::TensorShape *src_shape,
+    const uint8_t *src,
+    const int32_t src_zero_point,
+    const int8_t *packed_weight,
+    const int32_t *w_sum,
+    const float *scale,
+    const float *bias,
+    const ppl::nn::TensorShape *dst_shape,
+    const float dst_scale,
+    const int32_t dst_zero_point,
+    void *temp_buffer,
+    void *dst)
+{
+    const int64_t batch     = src_shape->GetDim(0);
+    const int64_t src_h     = src_shape->GetDim(2);
+    const int64_t src_w     = src_shape->GetDim(3);
+    const int64_t dst_h     = dst_shape->GetDim(2);
+    const int64_t dst_w     = dst_shape->GetDim(3);
+    const int64_t ic_per_gp = param.channels / param.group;
+    const int64_t oc_per_gp = param.num_output / param.group;
+    const int64_t K         = conv2d_int8_get_k(param);
+    const int64_t dst_hw    = dst_h * dst_w;
+    const int64_t ldb       = round_up(dst_hw, GEMM_S8U8_LANE_ALIGN);
+
+    const auto dst_type = dst_shape->GetDataType();
+    if (dst_type != ppl::common::DATATYPE_FLOAT32 && dst_type != ppl::common::DATATYPE_UINT8) {
+        return ppl::common::RC_UNSUPPORTED;
+    }
+    const int64_t dst_elem_size = ppl::common::GetSizeOfDataType(dst_type);
+    const uint64_t packed_size  = gemm_s8u8_get_packed_a_bytes(gemm_s8u8_layout::ROW_A, oc_per_gp, K);
+    uint8_t *col                = (uint8_t *)temp_buffer;
+
+    gemm_s8u8_param gemm_param;
+    gemm_param.layout       = gemm_s8u8_layout::ROW_A;
+    gemm_param.packed_b     = col;
+    gemm_param.M            = oc_per_gp;
+    gemm_param.N            = dst_hw;
+    gemm_param.K            = K;
+    gemm_param.ldb          = ldb;
+    gemm_param.ldc          = dst_hw;
+    gemm_param.b_zero_point = src_zero_point;
+    gemm_param.post         = param.post;
+    gemm_param.c_type       = dst_type;
+    gemm_param.c_scale      = dst_scale;
+    gemm_param.c_zero_point = dst_zero_point;
+
+    for (int64_t b = 0; b < batch; ++b) {
+        for (int64_t g = 0; g < param.group; ++g) {
+            const uint8_t *l_src = src + (b * param.channels + g * ic_per_gp) * src_h * src_w;
+            conv2d_int8_im2col(param, l_src, src_h, src_w, dst_h, dst_w, (uint8_t)src_zero_point, ldb, col);
+
+            gemm_param.packed_a = packed_weight + g * packed_size;
+            gemm_param.scale    = scale + g * oc_per_gp;
+            gemm_param.bias     = bias ? bias + g * oc_per_gp : nullptr;
+            gemm_param.a_sum    = w_sum + g * oc_per_gp;
+            gemm_param.C        = (uint8_t *)dst + (b * param.num_output + g * oc_per_gp) * dst_hw * dst_elem_size;
+            auto status         = gemm_s8u8(isa, gemm_param);
+            if (status != ppl::common::RC_SUCCESS) {
+                return status;
+            }
+        }
+    }
+
+    return ppl::common::RC_SUCCESS;
+}
+
+}}}; // namespace ppl::kernel::x86
@@ -0,0 +1,199 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <string.h>
+#include <math.h>
+
+#include "ppl/kernel/x86/int8/gemm/gemm_s8u8_common.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+// gemm_s8u8_avx2 dequantizes with _mm256_fmadd_ps, so fma is required as well as avx2
+static inline bool gemm_s8u8_use_avx2(const ppl::common::isa_t isa)
+{
+    return (isa & ppl::common::ISA_X86_AVX2) && (isa & ppl::common::ISA_X86_FMA);
+}
+
+int32_t gemm_s8u8_get_a_max_value(
+    const ppl::common::isa_t isa)
+{
+#ifdef PPL_USE_X86_AVX512_VNNI
+    if (isa & ppl::common::ISA_X86_AVX512VNNI) {
+        return 127;
+    }
+#endif
+    if (gemm_s8u8_use_avx2(isa)) {
+        return 63;
+    }
+    return 127;
+}
+
+uint64_t gemm_s8u8_get_packed_a_bytes(
+    const gemm_s8u8_layout_t layout,
+    const int64_t M,
+    const int64_t K)
+{
+    if (layout == gemm_s8u8_layout::ROW_A) {
+        return M * gemm_s8u8_get_kp(K);
+    }
+    return round_up(M, GEMM_S8U8_LANE_ALIGN) * gemm_s8u8_get_kp(K);
+}
+
+ppl::common::RetCode gemm_s8u8_quantize_pack_a(
+    const ppl::common::isa_t isa,
+    const gemm_s8u8_layout_t layout,
+    const float *A,
+    const int64_t M,
+    const int64_t K,
+    const int64_t lda,
+    int8_t *packed_a,
+    float *a_scale,
+    int32_t *a_sum)
+{
+    const int64_t Kp      = gemm_s8u8_get_kp(K);
+    const int64_t Ml      = round_up(M, GEMM_S8U8_LANE_ALIGN);
+    const float max_value = (float)gemm_s8u8_get_a_max_value(isa);
+
+    memset(packed_a, 0, gemm_s8u8_get_packed_a_bytes(layout, M, K));
+
+    PRAGMA_OMP_PARALLEL_FOR()
+    for (int64_t m = 0; m < M; ++m) {
+        const float *a = A + m * lda;
+        float abs_max  = 0.0f;
+        for (int64_t k = 0; k < K; ++k) {
+            abs_max = max(abs_max, fabsf(a[k]));
+        }
+        const float scale     = abs_max > 0.0f ? abs_max / max_value : 1.0f;
+        const float inv_scale = 1.0f / scale;
+
+        int32_t sum = 0;
+        for (int64_t k = 0; k < K; ++k) {
+            const int32_t q = (int32_t)nearbyintf(a[k] * inv_scale);
+            const int8_t qa = (int8_t)min(max(q, (int32_t)-max_value), (int32_t)max_value);
+            if (layout == gemm_s8u8_layout::ROW_A) {
+                packed_a[m * Kp + k] = qa;
+            } else {
+                packed_a[((k / GEMM_S8U8_K_ALIGN) * Ml + m) * GEMM_S8U8_K_ALIGN + k % GEMM_S8U8_K_ALIGN] = qa;
+            }
+            sum += qa;
+        }
+        a_scale[m] = scale;
+        a_sum[m]   = sum;
+    }
+
+    return ppl::common::RC_SUCCESS;
+}
+
+uint64_t gemm_s8u8_get_packed_b_bytes(
+    const gemm_s8u8_layout_t layout,
+    const int64_t N,
+    const int64_t K)
+{
+    if (layout == gemm_s8u8_layout::ROW_A) {
+        return gemm_s8u8_get_kp(K) * round_up(N, GEMM_S8U8_LANE_ALIGN);
+    }
+    return N * gemm_s8u8_get_kp(K);
+}
+
+ppl::common::RetCode gemm_s8u8_pack_b_trans(
+    const gemm_s8u8_layout_t layout,
+    const uint8_t *B,
+    const int64_t N,
+    const int64_t K,
+    const int64_t ldb,
+    uint8_t *packed_b,
+    int64_t *packed_ldb)
+{
+    const int64_t Kp = gemm_s8u8_get_kp(K);
+
+    if (layout == gemm_s8u8_layout::ROW_A) {
+        const int64_t Nl = round_up(N, GEMM_S8U8_LANE_ALIGN);
+        memset(packed_b, 0, Kp * Nl);
+        PRAGMA_OMP_PARALLEL_FOR()
+        for (int64_t n = 0; n < N; ++n) {
+            for (int64_t k = 0; k < K; ++k) {
+                packed_b[((k / GEMM_S8U8_K_ALIGN) * Nl + n) * GEMM_S8U8_K_ALIGN + k % GEMM_S8U8_K_ALIGN] = B[n * ldb + k];
+            }
+        }
+        *packed_ldb = Nl;
+    } else {
+        PRAGMA_OMP_PARALLEL_FOR()
+        for (int64_t n = 0; n < N; ++n) {
+            memcpy(packed_b + n * Kp, B + n * ldb, K);
+            memset(packed_b + n * Kp + K, 0, Kp - K);
+        }
+        *packed_ldb = Kp;
+    }
+
+    return ppl::common::RC_SUCCESS;
+}
+
+ppl::common::RetCode gemm_s8u8_ref(
+    const gemm_s8u8_param &param)
+{
+    const bool row_a  = param.layout == gemm_s8u8_layout::ROW_A;
+    const int64_t Kp  = gemm_s8u8_get_kp(param.K);
+    const int64_t Ml  = round_up(param.M, GEMM_S8U8_LANE_ALIGN);
+    const int64_t R   = gemm_s8u8_get_rows(param);
+    const int64_t L   = gemm_s8u8_get_lanes(param);
+    const int64_t K_A = GEMM_S8U8_K_ALIGN;
+
+#ifdef PPL_USE_X86_OMP_COLLAPSE
+    PRAGMA_OMP_PARALLEL_FOR_COLLAPSE(2)
+#endif
+    for (int64_t r = 0; r < R; ++r) {
+#ifndef PPL_USE_X86_OMP_COLLAPSE
+        PRAGMA_OMP_PARALLEL_FOR()
+#endif
+        for (int64_t l = 0; l < L; ++l) {
+            const int64_t m = row_a ? r : l;
+            const int64_t n = row_a ? l : r;
+            int32_t acc     = 0;
+            for (int64_t k = 0; k < param.K; ++k) {
+                const int32_t a = row_a ? param.packed_a[m * Kp + k] : param.packed_a[((k / K_A) * Ml + m) * K_A + k % K_A];
+                const int32_t b = row_a ? param.packed_b[((k / K_A) * param.ldb + n) * K_A + k % K_A] : param.packed_b[n * param.ldb + k];
+                acc += a * b;
+            }
+            gemm_s8u8_store_scalar(param, r, l, acc);
+        }
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+ppl::common::RetCode gemm_s8u8(
+    const ppl::common::isa_t isa,
+    const gemm_s8u8_param &param)
+{
+    if (param.M <= 0 || param.N <= 0) {
+        return ppl::common::RC_SUCCESS;
+    }
+    if (param.c_type != ppl::common::DATATYPE_FLOAT32 && param.c_type != ppl::common::DATATYPE_UINT8) {
+        return ppl::common::RC_UNSUPPORTED;
+    }
+#ifdef PPL_USE_X86_AVX512_VNNI
+    if (isa & ppl::common::ISA_X86_AVX512VNNI) {
+        return gemm_s8u8_avx512_vnni(param);
+    }
+#endif
+    if (gemm_s8u8_use_avx2(isa)) {
+        return gemm_s8u8_avx2(param);
+    }
+    return gemm_s8u8_ref(param);
+}
+
+}}}; // namespace ppl::kernel::x86
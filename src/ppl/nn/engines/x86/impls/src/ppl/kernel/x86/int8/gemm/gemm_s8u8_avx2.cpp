@@ -0,0 +1,214 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <immintrin.h>
+
+#include "ppl/kernel/x86/int8/gemm/gemm_s8u8_common.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+static const int64_t ROW_BLK  = 4;
+static const int64_t LANE_BLK = 16;
+static const int64_t SIMD_W   = 8;
+
+/*
+  accumulates ROWS x 16 int32 lanes of C by vpmaddubsw + vpmaddwd. sums of adjacent u8 x s8 products are
+  saturated to int16 by vpmaddubsw, which never happens if A is quantized to 7-bit(see gemm_s8u8_get_a_max_value).
+*/
+template <int64_t ROWS, bool ROW_A>
+static inline void gemm_s8u8_avx2_kernel(
+    const uint8_t *row_src,
+    const int64_t row_stride,
+    const uint8_t *lane_src,
+    const int64_t lane_stride,
+    const int64_t Kq,
+    __m256i acc[][2])
+{
+    const __m256i ymm_one_i16 = _mm256_set1_epi16(1);
+    for (int64_t r = 0; r < ROWS; ++r) {
+        acc[r][0] = _mm256_setzero_si256();
+        acc[r][1] = _mm256_setzero_si256();
+    }
+
+    for (int64_t kq = 0; kq < Kq; ++kq) {
+        const __m256i ymm_l0 = _mm256_loadu_si256((const __m256i *)(lane_src + 0 * SIMD_W * GEMM_S8U8_K_ALIGN));
+        const __m256i ymm_l1 = _mm256_loadu_si256((const __m256i *)(lane_src + 1 * SIMD_W * GEMM_S8U8_K_ALIGN));
+        for (int64_t r = 0; r < ROWS; ++r) {
+            const __m256i ymm_r = _mm256_set1_epi32(*(const int32_t *)(row_src + r * row_stride));
+            __m256i ymm_t0, ymm_t1;
+            // the first multiplicand of vpmaddubsw is unsigned
+            if (ROW_A) {
+                ymm_t0 = _mm256_maddubs_epi16(ymm_l0, ymm_r);
+                ymm_t1 = _mm256_maddubs_epi16(ymm_l1, ymm_r);
+            } else {
+                ymm_t0 = _mm256_maddubs_epi16(ymm_r, ymm_l0);
+                ymm_t1 = _mm256_maddubs_epi16(ymm_r, ymm_l1);
+            }
+            acc[r][0] = _mm256_add_epi32(acc[r][0], _mm256_madd_epi16(ymm_t0, ymm_one_i16));
+            acc[r][1] = _mm256_add_epi32(acc[r][1], _mm256_madd_epi16(ymm_t1, ymm_one_i16));
+        }
+        row_src += GEMM_S8U8_K_ALIGN;
+        lane_src += lane_stride;
+    }
+}
+
+template <int64_t ROWS, bool ROW_A>
+static inline void gemm_s8u8_avx2_store(
+    const gemm_s8u8_param &param,
+    const int64_t row_start,
+    const int64_t lane_start,
+    const int64_t lanes,
+    __m256i acc[][2])
+{
+    const __m256 ymm_zero    = _mm256_setzero_ps();
+    const __m256 ymm_six     = _mm256_set1_ps(6.0f);
+    const __m256 ymm_inv_c   = _mm256_set1_ps(1.0f / param.c_scale);
+    const __m256i ymm_c_zp   = _mm256_set1_epi32(param.c_zero_point);
+    const __m256i ymm_b_zp   = _mm256_set1_epi32(param.b_zero_point);
+    const __m256i ymm_u8_min = _mm256_setzero_si256();
+    const __m256i ymm_u8_max = _mm256_set1_epi32(255);
+
+    for (int64_t v = 0; v < LANE_BLK / SIMD_W; ++v) {
+        const int64_t lane  = lane_start + v * SIMD_W;
+        const int64_t valid = min<int64_t>(lanes - v * SIMD_W, SIMD_W);
+        if (valid <= 0) {
+            break;
+        }
+        if (valid < SIMD_W) {
+            int32_t acc_buf[ROW_BLK][SIMD_W];
+            for (int64_t r = 0; r < ROWS; ++r) {
+                _mm256_storeu_si256((__m256i *)acc_buf[r], acc[r][v]);
+                for (int64_t l = 0; l < valid; ++l) {
+                    gemm_s8u8_store_scalar(param, row_start + r, lane + l, acc_buf[r][l]);
+                }
+            }
+            continue;
+        }
+
+        // per lane params(LANE_A)
+        __m256 ymm_scale, ymm_bias;
+        __m256i ymm_comp;
+        if (!ROW_A) {
+            ymm_scale = _mm256_loadu_ps(param.scale + lane);
+            ymm_bias  = param.bias ? _mm256_loadu_ps(param.bias + lane) : ymm_zero;
+            ymm_comp  = _mm256_mullo_epi32(_mm256_loadu_si256((const __m256i *)(param.a_sum + lane)), ymm_b_zp);
+        }
+
+        for (int64_t r = 0; r < ROWS; ++r) {
+            const int64_t row = row_start + r;
+            if (ROW_A) {
+                ymm_scale = _mm256_set1_ps(param.scale[row]);
+                ymm_bias  = param.bias ? _mm256_set1_ps(param.bias[row]) : ymm_zero;
+                ymm_comp  = _mm256_set1_epi32(param.b_zero_point * param.a_sum[row]);
+            }
+
+            __m256 ymm_y = _mm256_cvtepi32_ps(_mm256_sub_epi32(acc[r][v], ymm_comp));
+            ymm_y        = _mm256_fmadd_ps(ymm_y, ymm_scale, ymm_bias);
+            if (param.post & (gemm_post::RELU6 | gemm_post::RELU)) ymm_y = _mm256_max_ps(ymm_y, ymm_zero);
+            if (param.post & gemm_post::RELU6) ymm_y = _mm256_min_ps(ymm_y, ymm_six);
+
+            const int64_t offset = row * param.ldc + lane;
+            if (param.c_type == ppl::common::DATATYPE_UINT8) {
+                __m256i ymm_q = _mm256_add_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(ymm_y, ymm_inv_c)), ymm_c_zp);
+                ymm_q         = _mm256_min_epi32(_mm256_max_epi32(ymm_q, ymm_u8_min), ymm_u8_max);
+                // [q0..q3, q4..q7] -> 8 x u8
+                __m128i xmm_q16 = _mm_packs_epi32(_mm256_castsi256_si128(ymm_q), _mm256_extracti128_si256(ymm_q, 1));
+                _mm_storel_epi64((__m128i *)((uint8_t *)param.C + offset), _mm_packus_epi16(xmm_q16, xmm_q16));
+            } else {
+                _mm256_storeu_ps((float *)param.C + offset, ymm_y);
+            }
+        }
+    }
+}
+
+template <int64_t ROWS, bool ROW_A>
+static void gemm_s8u8_avx2_block(
+    const gemm_s8u8_param &param,
+    const int64_t row_start,
+    const int64_t lane_start,
+    const int64_t lanes)
+{
+    const int64_t Kq = div_up(param.K, GEMM_S8U8_K_ALIGN);
+    const int64_t Kp = Kq * GEMM_S8U8_K_ALIGN;
+    const int64_t Ml = round_up(param.M, GEMM_S8U8_LANE_ALIGN);
+
+    const uint8_t *row_src;
+    const uint8_t *lane_src;
+    int64_t row_stride, lane_stride;
+    if (ROW_A) {
+        row_src     = (const uint8_t *)param.packed_a + row_start * Kp;
+        row_stride  = Kp;
+        lane_src    = param.packed_b + lane_start * GEMM_S8U8_K_ALIGN;
+        lane_stride = param.ldb * GEMM_S8U8_K_ALIGN;
+    } else {
+        row_src     = param.packed_b + row_start * param.ldb;
+        row_stride  = param.ldb;
+        lane_src    = (const uint8_t *)param.packed_a + lane_start * GEMM_S8U8_K_ALIGN;
+        lane_stride = Ml * GEMM_S8U8_K_ALIGN;
+    }
+
+    __m256i acc[ROW_BLK][2];
+    gemm_s8u8_avx2_kernel<ROWS, ROW_A>(row_src, row_stride, lane_src, lane_stride, Kq, acc);
+    gemm_s8u8_avx2_store<ROWS, ROW_A>(param, row_start, lane_start, lanes, acc);
+}
+
+template <bool ROW_A>
+static void gemm_s8u8_avx2_impl(
+    const gemm_s8u8_param &param)
+{
+    typedef void (*block_func_t)(const gemm_s8u8_param &, const int64_t, const int64_t, const int64_t);
+    static const block_func_t block_table[ROW_BLK] = {
+        gemm_s8u8_avx2_block<1, ROW_A>,
+        gemm_s8u8_avx2_block<2, ROW_A>,
+        gemm_s8u8_avx2_block<3, ROW_A>,
+        gemm_s8u8_avx2_block<4, ROW_A>,
+    };
+
+    const int64_t R          = gemm_s8u8_get_rows(param);
+    const int64_t L          = gemm_s8u8_get_lanes(param);
+    const int64_t num_chunks = div_up(R, GEMM_S8U8_ROW_CHUNK);
+    const int64_t num_tasks  = div_up(L, GEMM_S8U8_LANE_ALIGN) * num_chunks;
+
+    // tasks sharing the same lanes are adjacent so that the lane block stays in cache
+    PRAGMA_OMP_PARALLEL_FOR()
+    for (int64_t t = 0; t < num_tasks; ++t) {
+        const int64_t lane_begin = (t / num_chunks) * GEMM_S8U8_LANE_ALIGN;
+        const int64_t lane_end   = min(L, lane_begin + GEMM_S8U8_LANE_ALIGN);
+        const int64_t row_begin  = (t % num_chunks) * GEMM_S8U8_ROW_CHUNK;
+        const int64_t row_end    = min(R, row_begin + GEMM_S8U8_ROW_CHUNK);
+        for (int64_t l = lane_begin; l < lane_end; l += LANE_BLK) {
+            for (int64_t r = row_begin; r < row_end; r += ROW_BLK) {
+                const int64_t rows = min(row_end - r, ROW_BLK);
+                block_table[rows - 1](param, r, l, lane_end - l);
+            }
+        }
+    }
+}
+
+ppl::common::RetCode gemm_s8u8_avx2(
+    const gemm_s8u8_param &param)
+{
+    if (param.layout == gemm_s8u8_layout::ROW_A) {
+        gemm_s8u8_avx2_impl<true>(param);
+    } else {
+        gemm_s8u8_avx2_impl<false>(param);
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+}}}; // namespace ppl::kernel::x86
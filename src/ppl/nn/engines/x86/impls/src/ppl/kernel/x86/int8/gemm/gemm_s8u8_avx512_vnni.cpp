@@ -0,0 +1,199 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <immintrin.h>
+
+#include "ppl/kernel/x86/int8/gemm/gemm_s8u8_common.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+static const int64_t ROW_BLK  = 6;
+static const int64_t LANE_BLK = 32;
+static const int64_t SIMD_W   = 16;
+
+/*
+  accumulates ROWS x 32 int32 lanes of C. `row_src` points to k = 0 of the first row and `lane_src` points to
+  the first 4 x 32 bytes of the lane block.
+*/
+template <int64_t ROWS, bool ROW_A>
+static inline void gemm_s8u8_avx512_vnni_kernel(
+    const uint8_t *row_src,
+    const int64_t row_stride,
+    const uint8_t *lane_src,
+    const int64_t lane_stride,
+    const int64_t Kq,
+    __m512i acc[][2])
+{
+    for (int64_t r = 0; r < ROWS; ++r) {
+        acc[r][0] = _mm512_setzero_si512();
+        acc[r][1] = _mm512_setzero_si512();
+    }
+
+    for (int64_t kq = 0; kq < Kq; ++kq) {
+        const __m512i zmm_l0 = _mm512_loadu_si512((const __m512i *)(lane_src + 0 * SIMD_W * GEMM_S8U8_K_ALIGN));
+        const __m512i zmm_l1 = _mm512_loadu_si512((const __m512i *)(lane_src + 1 * SIMD_W * GEMM_S8U8_K_ALIGN));
+        for (int64_t r = 0; r < ROWS; ++r) {
+            const __m512i zmm_r = _mm512_set1_epi32(*(const int32_t *)(row_src + r * row_stride));
+            // the first multiplicand of vpdpbusd is unsigned
+            if (ROW_A) {
+                acc[r][0] = _mm512_dpbusd_epi32(acc[r][0], zmm_l0, zmm_r);
+                acc[r][1] = _mm512_dpbusd_epi32(acc[r][1], zmm_l1, zmm_r);
+            } else {
+                acc[r][0] = _mm512_dpbusd_epi32(acc[r][0], zmm_r, zmm_l0);
+                acc[r][1] = _mm512_dpbusd_epi32(acc[r][1], zmm_r, zmm_l1);
+            }
+        }
+        row_src += GEMM_S8U8_K_ALIGN;
+        lane_src += lane_stride;
+    }
+}
+
+template <int64_t ROWS, bool ROW_A>
+static inline void gemm_s8u8_avx512_vnni_store(
+    const gemm_s8u8_param &param,
+    const int64_t row_start,
+    const int64_t lane_start,
+    const int64_t lanes,
+    __m512i acc[][2])
+{
+    const __m512 zmm_zero     = _mm512_setzero_ps();
+    const __m512 zmm_six      = _mm512_set1_ps(6.0f);
+    const __m512 zmm_inv_c    = _mm512_set1_ps(1.0f / param.c_scale);
+    const __m512i zmm_c_zp    = _mm512_set1_epi32(param.c_zero_point);
+    const __m512i zmm_b_zp    = _mm512_set1_epi32(param.b_zero_point);
+    const __m512i zmm_u8_min  = _mm512_setzero_si512();
+    const __m512i zmm_u8_max  = _mm512_set1_epi32(255);
+
+    for (int64_t v = 0; v < LANE_BLK / SIMD_W; ++v) {
+        const int64_t lane = lane_start + v * SIMD_W;
+        const int64_t valid = min<int64_t>(lanes - v * SIMD_W, SIMD_W);
+        if (valid <= 0) {
+            break;
+        }
+        const __mmask16 mask = (__mmask16)((1u << valid) - 1);
+
+        // per lane params(LANE_A)
+        __m512 zmm_scale, zmm_bias;
+        __m512i zmm_comp;
+        if (!ROW_A) {
+            zmm_scale = _mm512_maskz_loadu_ps(mask, param.scale + lane);
+            zmm_bias  = param.bias ? _mm512_maskz_loadu_ps(mask, param.bias + lane) : zmm_zero;
+            zmm_comp  = _mm512_mullo_epi32(_mm512_maskz_loadu_epi32(mask, param.a_sum + lane), zmm_b_zp);
+        }
+
+        for (int64_t r = 0; r < ROWS; ++r) {
+            const int64_t row = row_start + r;
+            if (ROW_A) {
+                zmm_scale = _mm512_set1_ps(param.scale[row]);
+                zmm_bias  = param.bias ? _mm512_set1_ps(param.bias[row]) : zmm_zero;
+                zmm_comp  = _mm512_set1_epi32(param.b_zero_point * param.a_sum[row]);
+            }
+
+            __m512 zmm_y = _mm512_cvtepi32_ps(_mm512_sub_epi32(acc[r][v], zmm_comp));
+            zmm_y        = _mm512_fmadd_ps(zmm_y, zmm_scale, zmm_bias);
+            if (param.post & (gemm_post::RELU6 | gemm_post::RELU)) zmm_y = _mm512_max_ps(zmm_y, zmm_zero);
+            if (param.post & gemm_post::RELU6) zmm_y = _mm512_min_ps(zmm_y, zmm_six);
+
+            const int64_t offset = row * param.ldc + lane;
+            if (param.c_type == ppl::common::DATATYPE_UINT8) {
+                __m512i zmm_q = _mm512_add_epi32(_mm512_cvtps_epi32(_mm512_mul_ps(zmm_y, zmm_inv_c)), zmm_c_zp);
+                zmm_q         = _mm512_min_epi32(_mm512_max_epi32(zmm_q, zmm_u8_min), zmm_u8_max);
+                _mm512_mask_cvtepi32_storeu_epi8((uint8_t *)param.C + offset, mask, zmm_q);
+            } else {
+                _mm512_mask_storeu_ps((float *)param.C + offset, mask, zmm_y);
+            }
+        }
+    }
+}
+
+template <int64_t ROWS, bool ROW_A>
+static void gemm_s8u8_avx512_vnni_block(
+    const gemm_s8u8_param &param,
+    const int64_t row_start,
+    const int64_t lane_start,
+    const int64_t lanes)
+{
+    const int64_t Kq = div_up(param.K, GEMM_S8U8_K_ALIGN);
+    const int64_t Kp = Kq * GEMM_S8U8_K_ALIGN;
+    const int64_t Ml = round_up(param.M, GEMM_S8U8_LANE_ALIGN);
+
+    const uint8_t *row_src;
+    const uint8_t *lane_src;
+    int64_t row_stride, lane_stride;
+    if (ROW_A) {
+        row_src     = (const uint8_t *)param.packed_a + row_start * Kp;
+        row_stride  = Kp;
+        lane_src    = param.packed_b + lane_start * GEMM_S8U8_K_ALIGN;
+        lane_stride = param.ldb * GEMM_S8U8_K_ALIGN;
+    } else {
+        row_src     = param.packed_b + row_start * param.ldb;
+        row_stride  = param.ldb;
+        lane_src    = (const uint8_t *)param.packed_a + lane_start * GEMM_S8U8_K_ALIGN;
+        lane_stride = Ml * GEMM_S8U8_K_ALIGN;
+    }
+
+    __m512i acc[ROW_BLK][2];
+    gemm_s8u8_avx512_vnni_kernel<ROWS, ROW_A>(row_src, row_stride, lane_src, lane_stride, Kq, acc);
+    gemm_s8u8_avx512_vnni_store<ROWS, ROW_A>(param, row_start, lane_start, lanes, acc);
+}
+
+template <bool ROW_A>
+static void gemm_s8u8_avx512_vnni_impl(
+    const gemm_s8u8_param &param)
+{
+    typedef void (*block_func_t)(const gemm_s8u8_param &, const int64_t, const int64_t, const int64_t);
+    static const block_func_t block_table[ROW_BLK] = {
+        gemm_s8u8_avx512_vnni_block<1, ROW_A>,
+        gemm_s8u8_avx512_vnni_block<2, ROW_A>,
+        gemm_s8u8_avx512_vnni_block<3, ROW_A>,
+        gemm_s8u8_avx512_vnni_block<4, ROW_A>,
+        gemm_s8u8_avx512_vnni_block<5, ROW_A>,
+        gemm_s8u8_avx512_vnni_block<6, ROW_A>,
+    };
+
+    const int64_t R          = gemm_s8u8_get_rows(param);
+    const int64_t L          = gemm_s8u8_get_lanes(param);
+    const int64_t num_chunks = div_up(R, GEMM_S8U8_ROW_CHUNK);
+    const int64_t num_tasks  = div_up(L, LANE_BLK) * num_chunks;
+
+    // tasks sharing the same lanes are adjacent so that the lane block stays in cache
+    PRAGMA_OMP_PARALLEL_FOR()
+    for (int64_t t = 0; t < num_tasks; ++t) {
+        const int64_t lane_start = (t / num_chunks) * LANE_BLK;
+        const int64_t lanes      = min(L - lane_start, LANE_BLK);
+        const int64_t row_begin  = (t % num_chunks) * GEMM_S8U8_ROW_CHUNK;
+        const int64_t row_end    = min(R, row_begin + GEMM_S8U8_ROW_CHUNK);
+        for (int64_t r = row_begin; r < row_end; r += ROW_BLK) {
+            const int64_t rows = min(row_end - r, ROW_BLK);
+            block_table[rows - 1](param, r, lane_start, lanes);
+        }
+    }
+}
+
+ppl::common::RetCode gemm_s8u8_avx512_vnni(
+    const gemm_s8u8_param &param)
+{
+    if (param.layout == gemm_s8u8_layout::ROW_A) {
+        gemm_s8u8_avx512_vnni_impl<true>(param);
+    } else {
+        gemm_s8u8_avx512_vnni_impl<false>(param);
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+}}}; // namespace ppl::kernel::x86
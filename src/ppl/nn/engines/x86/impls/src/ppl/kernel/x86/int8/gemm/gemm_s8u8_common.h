@@ -0,0 +1,73 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#ifndef __ST_PPL_KERNEL_X86_INT8_GEMM_GEMM_S8U8_COMMON_H_
+#define __ST_PPL_KERNEL_X86_INT8_GEMM_GEMM_S8U8_COMMON_H_
+
+#include <math.h>
+
+#include "ppl/kernel/x86/common/internal_include.h"
+#include "ppl/kernel/x86/int8/gemm.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+// rows of C processed by one task. multiple of row blocks of all microkernels.
+const int64_t GEMM_S8U8_ROW_CHUNK = 48;
+
+inline int64_t gemm_s8u8_get_kp(const int64_t K)
+{
+    return round_up(K, GEMM_S8U8_K_ALIGN);
+}
+
+inline int64_t gemm_s8u8_get_rows(const gemm_s8u8_param &param)
+{
+    return param.layout == gemm_s8u8_layout::ROW_A ? param.M : param.N;
+}
+
+inline int64_t gemm_s8u8_get_lanes(const gemm_s8u8_param &param)
+{
+    return param.layout == gemm_s8u8_layout::ROW_A ? param.N : param.M;
+}
+
+// applies dequantization, bias, activation and requantization of one element
+inline void gemm_s8u8_store_scalar(
+    const gemm_s8u8_param &param,
+    const int64_t row,
+    const int64_t lane,
+    const int32_t acc)
+{
+    const bool row_a = param.layout == gemm_s8u8_layout::ROW_A;
+    const int64_t m  = row_a ? row : lane;
+
+    float y = param.scale[m] * (float)(acc - param.b_zero_point * param.a_sum[m]);
+    if (param.bias) y += param.bias[m];
+    if (param.post & (gemm_post::RELU6 | gemm_post::RELU)) y = max(y, 0.0f);
+    if (param.post & gemm_post::RELU6) y = min(y, 6.0f);
+
+    const int64_t offset = row * param.ldc + lane;
+    if (param.c_type == ppl::common::DATATYPE_UINT8) {
+        const int32_t q = (int32_t)nearbyintf(y * (1.0f / param.c_scale)) + param.c_zero_point;
+        ((uint8_t *)param.C)[offset] = (uint8_t)min(max(q, 0), 255);
+    } else {
+        ((float *)param.C)[offset] = y;
+    }
+}
+
+}}}; // namespace ppl::kernel::x86
+
+#endif
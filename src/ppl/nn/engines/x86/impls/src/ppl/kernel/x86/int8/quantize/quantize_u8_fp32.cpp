@@ -0,0 +1,98 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <math.h>
+
+#include "ppl/kernel/x86/common/internal_include.h"
+#include "ppl/kernel/x86/int8/quantize.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+ppl::common::RetCode quantize_fp32_u8_ref(
+    const ppl::nn::TensorShape *src_shape,
+    const float *src,
+    const float scale,
+    const int32_t zero_point,
+    uint8_t *dst)
+{
+    const int64_t n_elem  = src_shape->GetElementsIncludingPadding();
+    const float inv_scale = 1.0f / scale;
+
+    PRAGMA_OMP_PARALLEL_FOR()
+    for (int64_t i = 0; i < n_elem; ++i) {
+        const int32_t q = (int32_t)nearbyintf(src[i] * inv_scale) + zero_point;
+        dst[i]          = (uint8_t)min(max(q, 0), 255);
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+ppl::common::RetCode dequantize_u8_fp32_ref(
+    const ppl::nn::TensorShape *src_shape,
+    const uint8_t *src,
+    const float scale,
+    const int32_t zero_point,
+    float *dst)
+{
+    const int64_t n_elem = src_shape->GetElementsIncludingPadding();
+
+    PRAGMA_OMP_PARALLEL_FOR()
+    for (int64_t i = 0; i < n_elem; ++i) {
+        dst[i] = (float)((int32_t)src[i] - zero_point) * scale;
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+ppl::common::RetCode quantize_fp32_u8(
+    const ppl::common::isa_t isa,
+    const ppl::nn::TensorShape *src_shape,
+    const float *src,
+    const float scale,
+    const int32_t zero_point,
+    uint8_t *dst)
+{
+#ifdef PPL_USE_X86_AVX512
+    if (isa & ppl::common::ISA_X86_AVX512) {
+        return quantize_fp32_u8_avx512(src_shape, src, scale, zero_point, dst);
+    }
+#endif
+    if (isa & ppl::common::ISA_X86_SSE) {
+        return quantize_fp32_u8_sse(src_shape, src, scale, zero_point, dst);
+    }
+    return quantize_fp32_u8_ref(src_shape, src, scale, zero_point, dst);
+}
+
+ppl::common::RetCode dequantize_u8_fp32(
+    const ppl::common::isa_t isa,
+    const ppl::nn::TensorShape *src_shape,
+    const uint8_t *src,
+    const float scale,
+    const int32_t zero_point,
+    float *dst)
+{
+#ifdef PPL_USE_X86_AVX512
+    if (isa & ppl::common::ISA_X86_AVX512) {
+        return dequantize_u8_fp32_avx512(src_shape, src, scale, zero_point, dst);
+    }
+#endif
+    if (isa & ppl::common::ISA_X86_SSE) {
+        return dequantize_u8_fp32_sse(src_shape, src, scale, zero_point, dst);
+    }
+    return dequantize_u8_fp32_ref(src_shape, src, scale, zero_point, dst);
+}
+
+}}}; // namespace ppl::kernel::x86
@@ -0,0 +1,96 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <immintrin.h>
+#include <math.h>
+
+#include "ppl/kernel/x86/common/internal_include.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+ppl::common::RetCode quantize_fp32_u8_avx512(
+    const ppl::nn::TensorShape *src_shape,
+    const float *src,
+    const float scale,
+    const int32_t zero_point,
+    uint8_t *dst)
+{
+    const int64_t n_elem        = src_shape->GetElementsIncludingPadding();
+    const int64_t simd_w        = 16;
+    const int64_t unroll_n      = 4 * simd_w;
+    const int64_t unroll_n_body = round(n_elem, unroll_n);
+    const float inv_scale       = 1.0f / scale;
+
+    if (unroll_n_body) {
+        PRAGMA_OMP_PARALLEL()
+        {
+            const __m512 zmm_inv_scale = _mm512_set1_ps(inv_scale);
+            const __m512i zmm_zp       = _mm512_set1_epi32(zero_point);
+            const __m512i zmm_zero     = _mm512_setzero_si512();
+            const __m512i zmm_u8_max   = _mm512_set1_epi32(255);
+            PRAGMA_OMP_FOR()
+            for (int64_t n = 0; n < unroll_n_body; n += unroll_n) {
+                for (int64_t u = 0; u < unroll_n; u += simd_w) {
+                    __m512i zmm_i = _mm512_add_epi32(_mm512_cvtps_epi32(_mm512_mul_ps(_mm512_loadu_ps(src + n + u), zmm_inv_scale)), zmm_zp);
+                    zmm_i = _mm512_min_epi32(_mm512_max_epi32(zmm_i, zmm_zero), zmm_u8_max);
+                    _mm_storeu_si128((__m128i*)(dst + n + u), _mm512_cvtepi32_epi8(zmm_i));
+                }
+            }
+        }
+    }
+    for (int64_t n = unroll_n_body; n < n_elem; ++n) {
+        const int32_t q = (int32_t)nearbyintf(src[n] * inv_scale) + zero_point;
+        dst[n]          = (uint8_t)min(max(q, 0), 255);
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+ppl::common::RetCode dequantize_u8_fp32_avx512(
+    const ppl::nn::TensorShape *src_shape,
+    const uint8_t *src,
+    const float scale,
+    const int32_t zero_point,
+    float *dst)
+{
+    const int64_t n_elem        = src_shape->GetElementsIncludingPadding();
+    const int64_t simd_w        = 16;
+    const int64_t unroll_n      = 4 * simd_w;
+    const int64_t unroll_n_body = round(n_elem, unroll_n);
+
+    if (unroll_n_body) {
+        PRAGMA_OMP_PARALLEL()
+        {
+            const __m512 zmm_scale = _mm512_set1_ps(scale);
+            const __m512i zmm_zp   = _mm512_set1_epi32(zero_point);
+            PRAGMA_OMP_FOR()
+            for (int64_t n = 0; n < unroll_n_body; n += unroll_n) {
+                for (int64_t u = 0; u < unroll_n; u += simd_w) {
+                    __m512i zmm_i = _mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i*)(src + n + u)));
+                    zmm_i = _mm512_sub_epi32(zmm_i, zmm_zp);
+                    _mm512_storeu_ps(dst + n + u, _mm512_mul_ps(_mm512_cvtepi32_ps(zmm_i), zmm_scale));
+                }
+            }
+        }
+    }
+    for (int64_t n = unroll_n_body; n < n_elem; ++n) {
+        dst[n] = (float)((int32_t)src[n] - zero_point) * scale;
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+}}}; // namespace ppl::kernel::x86
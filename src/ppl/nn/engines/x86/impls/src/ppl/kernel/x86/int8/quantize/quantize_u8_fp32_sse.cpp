@@ -0,0 +1,101 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <nmmintrin.h>
+#include <math.h>
+
+#include "ppl/kernel/x86/common/internal_include.h"
+
+namespace ppl { namespace kernel { namespace x86 {
+
+ppl::common::RetCode quantize_fp32_u8_sse(
+    const ppl::nn::TensorShape *src_shape,
+    const float *src,
+    const float scale,
+    const int32_t zero_point,
+    uint8_t *dst)
+{
+    const int64_t n_elem        = src_shape->GetElementsIncludingPadding();
+    const int64_t simd_w        = 4;
+    const int64_t unroll_n      = 4 * simd_w;
+    const int64_t unroll_n_body = round(n_elem, unroll_n);
+    const float inv_scale       = 1.0f / scale;
+
+    if (unroll_n_body) {
+        PRAGMA_OMP_PARALLEL()
+        {
+            const __m128 mm_inv_scale = _mm_set1_ps(inv_scale);
+            const __m128i mm_zp       = _mm_set1_epi32(zero_point);
+            PRAGMA_OMP_FOR()
+            for (int64_t n = 0; n < unroll_n_body; n += unroll_n) {
+                __m128i mm_i0 = _mm_add_epi32(_mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src + n + 0 * simd_w), mm_inv_scale)), mm_zp);
+                __m128i mm_i1 = _mm_add_epi32(_mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src + n + 1 * simd_w), mm_inv_scale)), mm_zp);
+                __m128i mm_i2 = _mm_add_epi32(_mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src + n + 2 * simd_w), mm_inv_scale)), mm_zp);
+                __m128i mm_i3 = _mm_add_epi32(_mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src + n + 3 * simd_w), mm_inv_scale)), mm_zp);
+                // saturations are done by packs
+                __m128i mm_s0 = _mm_packs_epi32(mm_i0, mm_i1);
+                __m128i mm_s1 = _mm_packs_epi32(mm_i2, mm_i3);
+                _mm_storeu_si128((__m128i*)(dst + n), _mm_packus_epi16(mm_s0, mm_s1));
+            }
+        }
+    }
+    for (int64_t n = unroll_n_body; n < n_elem; ++n) {
+        const int32_t q = (int32_t)nearbyintf(src[n] * inv_scale) + zero_point;
+        dst[n]          = (uint8_t)min(max(q, 0), 255);
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+ppl::common::RetCode dequantize_u8_fp32_sse(
+    const ppl::nn::TensorShape *src_shape,
+    const uint8_t *src,
+    const float scale,
+    const int32_t zero_point,
+    float *dst)
+{
+    const int64_t n_elem        = src_shape->GetElementsIncludingPadding();
+    const int64_t simd_w        = 4;
+    const int64_t unroll_n      = 4 * simd_w;
+    const int64_t unroll_n_body = round(n_elem, unroll_n);
+
+    if (unroll_n_body) {
+        PRAGMA_OMP_PARALLEL()
+        {
+            const __m128 mm_scale = _mm_set1_ps(scale);
+            const __m128i mm_zp   = _mm_set1_epi32(zero_point);
+            PRAGMA_OMP_FOR()
+            for (int64_t n = 0; n < unroll_n_body; n += unroll_n) {
+                __m128i mm_u8 = _mm_loadu_si128((const __m128i*)(src + n));
+                __m128i mm_i0 = _mm_sub_epi32(_mm_cvtepu8_epi32(mm_u8), mm_zp);
+                __m128i mm_i1 = _mm_sub_epi32(_mm_cvtepu8_epi32(_mm_srli_si128(mm_u8, 4)), mm_zp);
+                __m128i mm_i2 = _mm_sub_epi32(_mm_cvtepu8_epi32(_mm_srli_si128(mm_u8, 8)), mm_zp);
+                __m128i mm_i3 = _mm_sub_epi32(_mm_cvtepu8_epi32(_mm_srli_si128(mm_u8, 12)), mm_zp);
+                _mm_storeu_ps(dst + n + 0 * simd_w, _mm_mul_ps(_mm_cvtepi32_ps(mm_i0), mm_scale));
+                _mm_storeu_ps(dst + n + 1 * simd_w, _mm_mul_ps(_mm_cvtepi32_ps(mm_i1), mm_scale));
+                _mm_storeu_ps(dst + n + 2 * simd_w, _mm_mul_ps(_mm_cvtepi32_ps(mm_i2), mm_scale));
+                _mm_storeu_ps(dst + n + 3 * simd_w, _mm_mul_ps(_mm_cvtepi32_ps(mm_i3), mm_scale));
+            }
+        }
+    }
+    for (int64_t n = unroll_n_body; n < n_elem; ++n) {
+        dst[n] = (float)((int32_t)src[n] - zero_point) * scale;
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+}}}; // namespace ppl::kernel::x86
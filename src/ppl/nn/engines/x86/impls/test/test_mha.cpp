@@ -0,0 +1,305 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <random>
+#include <chrono>
+
+#include <inttypes.h>
+#include <float.h>
+#include <string.h>
+
+#if defined(__linux__) && defined(PPL_USE_X86_OMP)
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <pthread.h>
+#include <omp.h>
+#endif
+
+#include "ppl/kernel/x86/fp32/multi_head_attention.h"
+#include "ppl/kernel/x86/fp32/gemm.h"
+#include "ppl/kernel/x86/fp32/softmax.h"
+#include "ppl/kernel/x86/common/macros.h"
+#include "ppl/common/generic_cpu_allocator.h"
+#include "ppl/common/sys.h"
+#include "simple_flags.h"
+#include "utils/check.h"
+
+#define CASE_STRING_FMT() "b%" PRId64 "q%" PRId64 "kv%" PRId64 "h%" PRId64 "d%" PRId64 "_n%s"
+
+Define_bool_opt("--help", Flag_help, false, "show these help information");
+Define_string(cfg, "", "(required) mha config file, format:" CASE_STRING_FMT() ", b: batch, q: query length, kv: key length, h: heads, d: head dim");
+Define_int32(warm_up, 2, "(2) warm up iterations");
+Define_int32(min_iter, 10, "(10) min benchmark iterations");
+Define_float(min_second, 1.0f, "(1.0) min benchmark seconds");
+Define_bool(validate, false, "(false) do result validation");
+Define_float(eps, 1e-4f, "(1e-4) rel error trunk for validation");
+Define_string(isa, "auto", "(auto) sse, fma, avx512, auto");
+Define_bool(mask, false, "(false) add a key mask shared by all batches");
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+template <typename func_t>
+static bool benchmark(func_t func, double *min_us, double *avg_us)
+{
+    for (int32_t i = 0; i < Flag_warm_up; ++i) {
+        if (ppl::common::RC_SUCCESS != func()) {
+            return false;
+        }
+    }
+
+    double tot_exe_us = 0.;
+    int64_t tot_exe_iter = 0;
+    *min_us = DBL_MAX;
+    for (; tot_exe_iter < Flag_min_iter || tot_exe_us < Flag_min_second * 1e6; ++tot_exe_iter) {
+        auto start = bench_clock::now();
+        if (ppl::common::RC_SUCCESS != func()) {
+            return false;
+        }
+        auto end = bench_clock::now();
+        double dur = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e3;
+        tot_exe_us += dur;
+        *min_us = std::min(*min_us, dur);
+    }
+    *avg_us = tot_exe_us / tot_exe_iter;
+    return true;
+}
+
+int main(int argc, char **argv) {
+    simple_flags::parse_args(argc, argv);
+    if (Flag_help) {
+        simple_flags::print_args_info();
+        return 0;
+    }
+
+    std::cerr << "==============================================================\n";
+    std::cerr << "read config\n";
+
+    std::ifstream cfgfile;
+    {
+        cfgfile.open(Flag_cfg, std::ios_base::in | std::ios_base::binary);
+        if (!cfgfile.is_open()) {
+            std::cerr << "cannot open config file\n";
+            simple_flags::print_args_info();
+            return -1;
+        }
+    }
+
+    int32_t num_threads = 1;
+#if defined(__linux__) && defined(PPL_USE_X86_OMP)
+    num_threads = omp_get_max_threads();
+#pragma omp parallel
+    {
+#define handle_error_en(en, msg) do { errno = en; perror(msg); exit(EXIT_FAILURE); } while (0)
+        int i = omp_get_thread_num();
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(i, &cpuset);
+        if (int s = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) != 0) {
+            handle_error_en(s, "pthread_setaffinity_np");
+        }
+#undef handle_error_en
+    }
+#endif
+
+    auto isa = ppl::common::GetCpuISA();
+    if (Flag_isa == "sse") {
+        isa = ppl::common::ISA_X86_SSE;
+    } else if (Flag_isa == "fma") {
+        isa &= ~ppl::common::ISA_X86_AVX512;
+    } else if (Flag_isa != "auto" && Flag_isa != "avx512") {
+        std::cerr << "unknown isa: " << Flag_isa << "\n";
+        return -1;
+    }
+    const ppl::common::isa_t fma_isa = ppl::common::ISA_X86_AVX | ppl::common::ISA_X86_FMA;
+    if (Flag_isa == "fma" && (isa & fma_isa) != fma_isa) {
+        std::cerr << "fma is not supported\n";
+        return -1;
+    }
+    if (Flag_isa == "avx512" && !(isa & ppl::common::ISA_X86_AVX512)) {
+        std::cerr << "avx512 is not supported\n";
+        return -1;
+    }
+
+    std::cerr << "==============================================================\n";
+    fprintf(
+        stderr,
+        "num_threads=%d\nwarm_up=%d\nmin_iter=%d\nmin_second=%f\nvalidate=%d\nisa=%s\nmask=%d\n\n",
+        num_threads, Flag_warm_up, Flag_min_iter, Flag_min_second, Flag_validate, Flag_isa.c_str(), Flag_mask
+    );
+    std::cerr << "==============================================================\n";
+    std::cerr << "begin tests\n";
+    std::cerr << "line_no,case_string,unfused_avg_ms,min_ms,avg_ms,speedup\n";
+
+    char line[512];
+    int line_no = 0;
+    int case_no = 0;
+    double all_case_us = 0.;
+    double all_case_unfused_us = 0.;
+    while (cfgfile.getline(line, 512, '\n')) {
+        ++line_no;
+
+        // skip comment
+        if (line[0] == '#' || line[0] == '\0') {
+            continue;
+        }
+
+        char case_name[100];
+        int64_t batch, seqlen_q, seqlen_kv, num_heads, head_dim;
+        if (6 != sscanf(
+            line,
+            CASE_STRING_FMT() "\n",
+            &batch, &seqlen_q, &seqlen_kv, &num_heads, &head_dim, case_name
+        )) {
+            std::cerr << line_no << "," << line << ",invalid format\n";
+            continue;
+        }
+
+        fprintf(
+            stderr,
+            "%d," CASE_STRING_FMT(),
+            line_no, batch, seqlen_q, seqlen_kv, num_heads, head_dim, case_name
+        );
+
+        const int64_t hidden = num_heads * head_dim;
+        const float scale = 1.0f / sqrtf((float)head_dim);
+        const uint64_t temp_buffer_size = ppl::kernel::x86::multi_head_attention_fp32_get_buffer_bytes(batch, seqlen_kv, num_heads, head_dim);
+
+        ppl::common::GenericCpuAllocator allocator(PPL_X86_CACHELINE_BYTES());
+        float *q = (float*)allocator.Alloc(batch * seqlen_q * hidden * sizeof(float));
+        float *k = (float*)allocator.Alloc(batch * seqlen_kv * hidden * sizeof(float));
+        float *v = (float*)allocator.Alloc(batch * seqlen_kv * hidden * sizeof(float));
+        float *mask = (float*)allocator.Alloc(seqlen_kv * sizeof(float));
+        float *scores = (float*)allocator.Alloc(seqlen_q * seqlen_kv * sizeof(float));
+        float *dst = (float*)allocator.Alloc(batch * seqlen_q * hidden * sizeof(float));
+        float *dst_unfused = (float*)allocator.Alloc(batch * seqlen_q * hidden * sizeof(float));
+        void *temp_buffer = allocator.Alloc(temp_buffer_size);
+        if (!q || !k || !v || !mask || !scores || !dst || !dst_unfused || !temp_buffer) {
+            std::cerr << "," << "out of memory\n";
+            return -1;
+        }
+
+        std::mt19937 rng(line_no);
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        for (int64_t i = 0; i < batch * seqlen_q * hidden; ++i) {
+            q[i] = dist(rng);
+        }
+        for (int64_t i = 0; i < batch * seqlen_kv * hidden; ++i) {
+            k[i] = dist(rng);
+            v[i] = dist(rng);
+        }
+        // the last quarter of keys are padding
+        for (int64_t i = 0; i < seqlen_kv; ++i) {
+            mask[i] = i < seqlen_kv - seqlen_kv / 4 ? 0.0f : -10000.0f;
+        }
+        const float *p_mask = Flag_mask ? mask : nullptr;
+
+        auto run = [&]() -> ppl::common::RetCode {
+#ifdef PPL_USE_X86_AVX512
+            if (isa & ppl::common::ISA_X86_AVX512) {
+                return ppl::kernel::x86::multi_head_attention_fp32_avx512(
+                    q, k, v, p_mask, batch, seqlen_q, seqlen_kv, num_heads, head_dim, 0, scale, temp_buffer, dst);
+            }
+#endif
+            if ((isa & fma_isa) == fma_isa) {
+                return ppl::kernel::x86::multi_head_attention_fp32_fma(
+                    q, k, v, p_mask, batch, seqlen_q, seqlen_kv, num_heads, head_dim, 0, scale, temp_buffer, dst);
+            }
+            return ppl::kernel::x86::multi_head_attention_fp32_sse(
+                q, k, v, p_mask, batch, seqlen_q, seqlen_kv, num_heads, head_dim, 0, scale, temp_buffer, dst);
+        };
+
+        // MatMul, Softmax and MatMul of each head, as they run without fusion
+        ppl::nn::TensorShape scores_shape;
+        scores_shape.Reshape({seqlen_q, seqlen_kv});
+        scores_shape.SetDataType(ppl::common::DATATYPE_FLOAT32);
+        scores_shape.SetDataFormat(ppl::common::DATAFORMAT_NDARRAY);
+        auto run_unfused = [&]() -> ppl::common::RetCode {
+            for (int64_t b = 0; b < batch; ++b) {
+                for (int64_t h = 0; h < num_heads; ++h) {
+                    const int64_t q_offset = b * seqlen_q * hidden + h * head_dim;
+                    const int64_t kv_offset = b * seqlen_kv * hidden + h * head_dim;
+                    auto status = ppl::kernel::x86::gemm_fp32(
+                        isa, q + q_offset, k + kv_offset, p_mask, nullptr,
+                        ppl::kernel::x86::gemm_m_type::NOTRANS, ppl::kernel::x86::gemm_m_type::TRANS,
+                        p_mask ? ppl::kernel::x86::gemm_v_type::ROW_VEC : ppl::kernel::x86::gemm_v_type::EMPTY,
+                        ppl::kernel::x86::gemm_m_type::EMPTY, seqlen_q, seqlen_kv, head_dim, hidden, hidden,
+                        seqlen_kv, 0, scale, 0.0f, 1.0f, 0.0f, ppl::kernel::x86::gemm_post::NONE, scores);
+                    if (status != ppl::common::RC_SUCCESS) {
+                        return status;
+                    }
+                    status = ppl::kernel::x86::softmax13_ndarray_fp32(isa, &scores_shape, scores, 1, scores);
+                    if (status != ppl::common::RC_SUCCESS) {
+                        return status;
+                    }
+                    status = ppl::kernel::x86::gemm_fp32(
+                        isa, scores, v + kv_offset, nullptr, nullptr,
+                        ppl::kernel::x86::gemm_m_type::NOTRANS, ppl::kernel::x86::gemm_m_type::NOTRANS,
+                        ppl::kernel::x86::gemm_v_type::EMPTY, ppl::kernel::x86::gemm_m_type::EMPTY,
+                        seqlen_q, head_dim, seqlen_kv, seqlen_kv, hidden, hidden, 0, 1.0f, 0.0f, 0.0f, 0.0f,
+                        ppl::kernel::x86::gemm_post::NONE, dst_unfused + q_offset);
+                    if (status != ppl::common::RC_SUCCESS) {
+                        return status;
+                    }
+                }
+            }
+            return ppl::common::RC_SUCCESS;
+        };
+
+        double min_us, avg_us, unfused_min_us, unfused_avg_us;
+        if (!benchmark(run, &min_us, &avg_us)) {
+            std::cerr << "," << "execute failed\n";
+            return -1;
+        }
+        if (!benchmark(run_unfused, &unfused_min_us, &unfused_avg_us)) {
+            std::cerr << "," << "execute unfused failed\n";
+            return -1;
+        }
+
+        fprintf(stderr, ",%.3f,%.3f,%.3f,%.2f",
+            unfused_avg_us / 1e3, min_us / 1e3, avg_us / 1e3, unfused_avg_us / avg_us);
+
+        ++case_no;
+        all_case_us += avg_us;
+        all_case_unfused_us += unfused_avg_us;
+
+        if (Flag_validate) {
+            std::cerr << ",";
+            check_array_error(dst, dst_unfused, batch * seqlen_q * hidden, Flag_eps);
+        }
+
+        allocator.Free(q);
+        allocator.Free(k);
+        allocator.Free(v);
+        allocator.Free(mask);
+        allocator.Free(scores);
+        allocator.Free(dst);
+        allocator.Free(dst_unfused);
+        allocator.Free(temp_buffer);
+        std::cerr << "\n";
+    }
+    std::cerr
+        << "tot time(ms): "<< all_case_us / 1e3 << "\t"
+        << "unfused tot time(ms): " << all_case_unfused_us / 1e3 << "\t"
+        << "speedup: " << all_case_unfused_us / all_case_us << "\n";
+    cfgfile.close();
+}
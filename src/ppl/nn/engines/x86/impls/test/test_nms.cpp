@@ -0,0 +1,342 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <random>
+#include <chrono>
+
+#include <inttypes.h>
+#include <float.h>
+#include <string.h>
+
+#if defined(__linux__) && defined(PPL_USE_X86_OMP)
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <pthread.h>
+#include <omp.h>
+#endif
+
+#include "ppl/kernel/x86/fp32/nms.h"
+#include "ppl/kernel/x86/fp32/mmcv_nms.h"
+#include "ppl/kernel/x86/common/math.h"
+#include "ppl/kernel/x86/common/macros.h"
+#include "ppl/common/generic_cpu_allocator.h"
+#include "ppl/common/sys.h"
+#include "simple_flags.h"
+#include "utils/check.h"
+
+#define CASE_STRING_FMT() "b%" PRId64 "c%" PRId64 "n%" PRId64 "m%" PRId64 "k%" PRId64 "_n%s"
+
+Define_bool_opt("--help", Flag_help, false, "show these help information");
+Define_string(cfg, "", "(required) nms config file, format:" CASE_STRING_FMT() ", b: batch, c: classes, n: boxes, m: max output boxes per class, k: topk(0 for all)");
+Define_int32(warm_up, 2, "(2) warm up iterations");
+Define_int32(min_iter, 10, "(10) min benchmark iterations");
+Define_float(min_second, 1.0f, "(1.0) min benchmark seconds");
+Define_bool(validate, false, "(false) do result validation");
+Define_float(iou_threshold, 0.5f, "(0.5) iou threshold");
+Define_float(score_threshold, -FLT_MAX, "(-FLT_MAX) score threshold");
+Define_int32(bitmask, -1, "(-1) suppression mode, -1: auto, 0: greedy, 1: bitmask");
+Define_bool(mmcv, false, "(false) benchmark mmcv nms, batch and classes must be 1, max output and topk are ignored");
+Define_bool(center_point_box, false, "(false) boxes are [x_center, y_center, width, height]");
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+template <typename func_t>
+static bool benchmark(func_t func, double *min_us, double *avg_us)
+{
+    for (int32_t i = 0; i < Flag_warm_up; ++i) {
+        if (ppl::common::RC_SUCCESS != func()) {
+            return false;
+        }
+    }
+
+    double tot_exe_us = 0.;
+    int64_t tot_exe_iter = 0;
+    *min_us = DBL_MAX;
+    for (; tot_exe_iter < Flag_min_iter || tot_exe_us < Flag_min_second * 1e6; ++tot_exe_iter) {
+        auto start = bench_clock::now();
+        if (ppl::common::RC_SUCCESS != func()) {
+            return false;
+        }
+        auto end = bench_clock::now();
+        double dur = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e3;
+        tot_exe_us += dur;
+        *min_us = std::min(*min_us, dur);
+    }
+    *avg_us = tot_exe_us / tot_exe_iter;
+    return true;
+}
+
+// boxes gathered around a few centers, so that every box overlaps with some others
+static void init_boxes(const int64_t batch, const int64_t num_boxes, const bool mmcv, std::mt19937 &rng, float *boxes)
+{
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    const int64_t num_clusters = std::max<int64_t>(num_boxes / 16, 1);
+    for (int64_t b = 0; b < batch; ++b) {
+        std::vector<float> centers(num_clusters * 2);
+        for (auto &c : centers) {
+            c = dist(rng) * 1000.0f;
+        }
+        for (int64_t i = 0; i < num_boxes; ++i) {
+            const int64_t c   = rng() % num_clusters;
+            const float cx    = centers[c * 2 + 0] + dist(rng) * 8.0f;
+            const float cy    = centers[c * 2 + 1] + dist(rng) * 8.0f;
+            const float w     = 16.0f + dist(rng) * 32.0f;
+            const float h     = 16.0f + dist(rng) * 32.0f;
+            float *box        = boxes + (b * num_boxes + i) * 4;
+            if (Flag_center_point_box && !mmcv) {
+                box[0] = cx;
+                box[1] = cy;
+                box[2] = w;
+                box[3] = h;
+            } else if (mmcv) {
+                box[0] = cx - w * 0.5f;
+                box[1] = cy - h * 0.5f;
+                box[2] = cx + w * 0.5f;
+                box[3] = cy + h * 0.5f;
+            } else {
+                box[0] = cy - h * 0.5f;
+                box[1] = cx - w * 0.5f;
+                box[2] = cy + h * 0.5f;
+                box[3] = cx + w * 0.5f;
+            }
+        }
+    }
+}
+
+// the reference kernel has no topk, so scores out of topk are cleared before running it
+static void apply_topk(const int64_t num_tasks, const int64_t num_boxes, const int64_t topk, float *scores)
+{
+    if (topk <= 0 || topk >= num_boxes) {
+        return;
+    }
+    std::vector<int64_t> indices(num_boxes);
+    for (int64_t t = 0; t < num_tasks; ++t) {
+        float *task_scores = scores + t * num_boxes;
+        for (int64_t i = 0; i < num_boxes; ++i) {
+            indices[i] = i;
+        }
+        std::stable_sort(indices.begin(), indices.end(), [task_scores](int64_t a, int64_t b) {
+            return task_scores[a] > task_scores[b];
+        });
+        for (int64_t i = topk; i < num_boxes; ++i) {
+            task_scores[indices[i]] = -FLT_MAX;
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    simple_flags::parse_args(argc, argv);
+    if (Flag_help) {
+        simple_flags::print_args_info();
+        return 0;
+    }
+
+    std::cerr << "==============================================================\n";
+    std::cerr << "read config\n";
+
+    std::ifstream cfgfile;
+    {
+        cfgfile.open(Flag_cfg, std::ios_base::in | std::ios_base::binary);
+        if (!cfgfile.is_open()) {
+            std::cerr << "cannot open config file\n";
+            simple_flags::print_args_info();
+            return -1;
+        }
+    }
+
+    int32_t num_threads = 1;
+#if defined(__linux__) && defined(PPL_USE_X86_OMP)
+    num_threads = omp_get_max_threads();
+#pragma omp parallel
+    {
+#define handle_error_en(en, msg) do { errno = en; perror(msg); exit(EXIT_FAILURE); } while (0)
+        int i = omp_get_thread_num();
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(i, &cpuset);
+        if (int s = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) != 0) {
+            handle_error_en(s, "pthread_setaffinity_np");
+        }
+#undef handle_error_en
+    }
+#endif
+
+    const auto isa = ppl::common::GetCpuISA();
+    if (!(isa & ppl::common::ISA_X86_AVX)) {
+        std::cerr << "avx is not supported\n";
+        return -1;
+    }
+
+    std::cerr << "==============================================================\n";
+    fprintf(
+        stderr,
+        "num_threads=%d\nwarm_up=%d\nmin_iter=%d\nmin_second=%f\nvalidate=%d\n"
+        "iou_threshold=%f\nscore_threshold=%f\nbitmask=%d\nmmcv=%d\ncenter_point_box=%d\n\n",
+        num_threads, Flag_warm_up, Flag_min_iter, Flag_min_second, Flag_validate,
+        Flag_iou_threshold, Flag_score_threshold, Flag_bitmask, Flag_mmcv, Flag_center_point_box
+    );
+    std::cerr << "==============================================================\n";
+    std::cerr << "begin tests\n";
+    std::cerr << "line_no,case_string,bitmask,num_output,ref_avg_ms,min_ms,avg_ms,speedup\n";
+
+    char line[512];
+    int line_no = 0;
+    int case_no = 0;
+    double all_case_us = 0.;
+    double all_case_ref_us = 0.;
+    while (cfgfile.getline(line, 512, '\n')) {
+        ++line_no;
+
+        // skip comment
+        if (line[0] == '#' || line[0] == '\0') {
+            continue;
+        }
+
+        char case_name[100];
+        int64_t batch, num_classes, num_boxes, max_output, topk;
+        if (6 != sscanf(
+            line,
+            CASE_STRING_FMT() "\n",
+            &batch, &num_classes, &num_boxes, &max_output, &topk, case_name
+        )) {
+            std::cerr << line_no << "," << line << ",invalid format\n";
+            continue;
+        }
+        if (Flag_mmcv) {
+            batch = 1;
+            num_classes = 1;
+            max_output = num_boxes;
+            topk = 0;
+        }
+
+        fprintf(
+            stderr,
+            "%d," CASE_STRING_FMT(),
+            line_no, batch, num_classes, num_boxes, max_output, topk, case_name
+        );
+
+        const int64_t num_candidates = topk > 0 ? std::min(topk, num_boxes) : num_boxes;
+        const bool use_bitmask = Flag_bitmask < 0
+            ? ppl::kernel::x86::nms_ndarray_fp32_bitmask_is_preferred(batch, num_classes, num_candidates)
+            : Flag_bitmask > 0;
+
+        ppl::common::GenericCpuAllocator allocator(PPL_X86_CACHELINE_BYTES());
+        const uint64_t dst_len = Flag_mmcv ? num_boxes : batch * num_classes * num_boxes * 3;
+        const uint64_t temp_buffer_size = Flag_mmcv
+            ? ppl::kernel::x86::mmcv_nms_ndarray_fp32_get_buffer_bytes(num_boxes, use_bitmask)
+            : ppl::kernel::x86::nms_ndarray_fp32_get_buffer_bytes(num_boxes, batch, num_classes, topk, use_bitmask);
+
+        float *boxes = (float*)allocator.Alloc(batch * num_boxes * 4 * sizeof(float));
+        float *scores = (float*)allocator.Alloc(batch * num_classes * num_boxes * sizeof(float));
+        int64_t *dst = (int64_t*)allocator.Alloc(std::max<uint64_t>(dst_len, 1) * sizeof(int64_t));
+        int64_t *dst_ref = (int64_t*)allocator.Alloc(std::max<uint64_t>(dst_len, 1) * sizeof(int64_t));
+        void *temp_buffer = allocator.Alloc(std::max<uint64_t>(temp_buffer_size, 1));
+        if (!boxes || !scores || !dst || !dst_ref || !temp_buffer) {
+            std::cerr << "," << "out of memory\n";
+            return -1;
+        }
+
+        std::mt19937 rng(line_no);
+        init_boxes(batch, num_boxes, Flag_mmcv, rng, boxes);
+        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+        for (int64_t i = 0; i < batch * num_classes * num_boxes; ++i) {
+            scores[i] = dist(rng);
+        }
+
+        int64_t num_output = 0;
+        auto run = [&]() -> ppl::common::RetCode {
+            if (Flag_mmcv) {
+#ifdef PPL_USE_X86_AVX512
+                if (isa & ppl::common::ISA_X86_AVX512) {
+                    return ppl::kernel::x86::mmcv_nms_ndarray_fp32_avx512(
+                        boxes, scores, num_boxes, Flag_iou_threshold, 0, use_bitmask, temp_buffer, dst, &num_output);
+                }
+#endif
+                return ppl::kernel::x86::mmcv_nms_ndarray_fp32_avx(
+                    boxes, scores, num_boxes, Flag_iou_threshold, 0, use_bitmask, temp_buffer, dst, &num_output);
+            }
+#ifdef PPL_USE_X86_AVX512
+            if (isa & ppl::common::ISA_X86_AVX512) {
+                return ppl::kernel::x86::nms_ndarray_fp32_avx512(
+                    boxes, scores, num_boxes, batch, num_classes, Flag_center_point_box, max_output,
+                    Flag_iou_threshold, Flag_score_threshold, topk, use_bitmask, temp_buffer, dst, &num_output);
+            }
+#endif
+            return ppl::kernel::x86::nms_ndarray_fp32_avx(
+                boxes, scores, num_boxes, batch, num_classes, Flag_center_point_box, max_output,
+                Flag_iou_threshold, Flag_score_threshold, topk, use_bitmask, temp_buffer, dst, &num_output);
+        };
+
+        int64_t num_output_ref = 0;
+        auto run_ref = [&]() -> ppl::common::RetCode {
+            if (Flag_mmcv) {
+                return ppl::kernel::x86::mmcv_nms_ndarray_fp32(
+                    boxes, scores, num_boxes, Flag_iou_threshold, 0, dst_ref, &num_output_ref);
+            }
+            return ppl::kernel::x86::nms_ndarray_fp32(
+                boxes, scores, num_boxes, batch, num_classes, Flag_center_point_box, max_output,
+                Flag_iou_threshold, Flag_score_threshold, dst_ref, &num_output_ref);
+        };
+
+        double min_us, avg_us, ref_min_us, ref_avg_us;
+        if (!benchmark(run, &min_us, &avg_us)) {
+            std::cerr << "," << "execute failed\n";
+            return -1;
+        }
+
+        // scores are modified for topk, so the reference runs after the benchmarked kernel
+        apply_topk(batch * num_classes, num_boxes, topk, scores);
+        if (!benchmark(run_ref, &ref_min_us, &ref_avg_us)) {
+            std::cerr << "," << "execute reference failed\n";
+            return -1;
+        }
+
+        fprintf(stderr, ",%d,%" PRId64 ",%.3f,%.3f,%.3f,%.2f",
+            use_bitmask, num_output, ref_avg_us / 1e3, min_us / 1e3, avg_us / 1e3, ref_avg_us / avg_us);
+
+        ++case_no;
+        all_case_us += avg_us;
+        all_case_ref_us += ref_avg_us;
+
+        if (Flag_validate) {
+            std::cerr << ",";
+            if (num_output != num_output_ref) {
+                std::cerr << "num_output=" << num_output << " ref:" << num_output_ref;
+            } else {
+                check_array_error<int64_t>(dst, dst_ref, num_output * (Flag_mmcv ? 1 : 3), 0);
+            }
+        }
+
+        allocator.Free(boxes);
+        allocator.Free(scores);
+        allocator.Free(dst);
+        allocator.Free(dst_ref);
+        allocator.Free(temp_buffer);
+        std::cerr << "\n";
+    }
+    std::cerr
+        << "tot time(ms): "<< all_case_us / 1e3 << "\t"
+        << "ref tot time(ms): " << all_case_ref_us / 1e3 << "\t"
+        << "speedup: " << all_case_ref_us / all_case_us << "\n";
+    cfgfile.close();
+}
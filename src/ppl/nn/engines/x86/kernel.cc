@@ -16,6 +16,10 @@
 // under the License.
 
 #include "ppl/nn/engines/x86/kernel.h"
+#include "ppl/nn/utils/destructor.h"
+#include "ppl/kernel/x86/common/threading_tools.h"
+#include <string.h>
+#include <algorithm>
 using namespace std;
 using namespace ppl::common;
 
@@ -25,16 +29,180 @@ using namespace ppl::common;
 
 namespace ppl { namespace nn { namespace x86 {
 
+static inline uint64_t HashCombine(uint64_t h, uint64_t v) {
+    // FNV-1a
+    for (uint32_t i = 0; i < sizeof(v); ++i) {
+        h ^= (v >> (i * 8)) & 0xff;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+static uint64_t HashKey(const vector<uint64_t>& key) {
+    uint64_t h = 14695981039346656037ull;
+    for (auto v = key.begin(); v != key.end(); ++v) {
+        h = HashCombine(h, *v);
+    }
+    return h;
+}
+
+static void AppendShapeKey(const TensorImpl* tensor, vector<uint64_t>* key) {
+    if (!tensor) {
+        key->push_back(0);
+        return;
+    }
+
+    auto shape = tensor->GetShape();
+    key->push_back(1);
+    key->push_back(shape->GetDataType());
+    key->push_back(shape->GetDataFormat());
+    key->push_back(shape->GetDimCount());
+    for (uint32_t i = 0; i < shape->GetDimCount(); ++i) {
+        key->push_back(shape->GetDim(i));
+        key->push_back(((uint64_t)shape->GetPadding0(i) << 32) | shape->GetPadding1(i));
+    }
+}
+
+static void AppendDataKey(const uint8_t* data, uint64_t bytes, vector<uint64_t>* key) {
+    key->push_back(bytes);
+    for (uint64_t i = 0; i < bytes; i += sizeof(uint64_t)) {
+        uint64_t v = 0;
+        memcpy(&v, data + i, std::min<uint64_t>(sizeof(v), bytes - i));
+        key->push_back(v);
+    }
+}
+
+void X86Kernel::BuildShapeKey(const KernelExecContext& ctx, vector<uint64_t>* key) {
+    key->clear();
+    for (uint32_t i = 0; i < ctx.GetInputCount(); ++i) {
+        AppendShapeKey(ctx.GetInput<TensorImpl>(i), key);
+    }
+    for (uint32_t i = 0; i < ctx.GetOutputCount(); ++i) {
+        AppendShapeKey(ctx.GetOutput<TensorImpl>(i), key);
+    }
+}
+
+/*
+  inputs whose values are read by shape inference functions. their data is part of the signature, while other inputs
+  only contribute their shapes.
+*/
+struct ShapeDataInputs final {
+    const char* domain;
+    const char* type;
+    uint32_t input_mask;
+};
+
+static const ShapeDataInputs g_shape_data_inputs[] = {
+    {"", "ConstantOfShape", 0x1}, // input
+    {"", "Expand", 0x2}, // shape
+    {"", "Pad", 0x2}, // pads
+    {"", "Range", 0x7}, // start, limit, delta
+    {"", "Reshape", 0x2}, // shape
+    {"", "Resize", 0xe}, // roi, scales, sizes
+    {"", "Slice", 0x1e}, // starts, ends, axes, steps
+    {"", "Tile", 0x2}, // repeats
+    {"", "TopK", 0x2}, // k
+};
+
+/*
+  output shapes of these kernels depend on the values of their inputs and are determined in DoExecute(), so the
+  cache is always disabled for them.
+*/
+struct KernelTypeName final {
+    const char* domain;
+    const char* type;
+};
+
+static const KernelTypeName g_data_dependent_kernels[] = {
+    {"", "NonMaxSuppression"},
+    {"", "NonZero"},
+    {"mmcv", "NonMaxSuppression"},
+};
+
+template <typename T, uint32_t N>
+static const T* FindKernelType(const T (&table)[N], const ir::Node::Type& type) {
+    for (uint32_t i = 0; i < N; ++i) {
+        if (type.domain == table[i].domain && type.name == table[i].type) {
+            return &table[i];
+        }
+    }
+    return nullptr;
+}
+
+void X86Kernel::BuildInputSignature(const KernelExecContext& ctx, vector<uint64_t>* key) const {
+    key->clear();
+    for (uint32_t i = 0; i < ctx.GetInputCount(); ++i) {
+        auto tensor = ctx.GetInput<TensorImpl>(i);
+        AppendShapeKey(tensor, key);
+        if (i >= 32 || !(shape_data_input_mask_ & (1u << i)) || !tensor || !tensor->GetBufferPtr()) {
+            continue;
+        }
+        AppendDataKey(tensor->GetBufferPtr<const uint8_t>(), tensor->GetShape()->GetBytesIncludingPadding(), key);
+    }
+}
+
 RetCode X86Kernel::BeforeExecute(KernelExecContext* ctx) {
+    uint64_t signature = 0;
+    if (reshape_cache_enabled_) {
+        BuildInputSignature(*ctx, &key_buffer_);
+        signature = HashKey(key_buffer_);
+        // the hash rejects most changes and keys are compared in case of collisions
+        if (reshape_cache_valid_ && signature == input_signature_ && key_buffer_ == input_signature_key_) {
+            for (uint32_t i = 0; i < ctx->GetOutputCount(); ++i) {
+                *ctx->GetOutput<TensorImpl>(i)->GetShape() = cached_output_shapes_[i];
+            }
+            reshape_cache_hit_ = true;
+            return RC_SUCCESS;
+        }
+    }
+
+    reshape_cache_hit_ = false;
     auto status = Reshape(ctx);
     if (status != RC_SUCCESS) {
         LOG(ERROR) << "reshape kernel[" << GetName() << "] failed: " << GetRetCodeStr(status);
+        reshape_cache_valid_ = false;
         return status;
     }
 
+    if (reshape_cache_enabled_) {
+        // outputs may be modified by DoExecute()(NonZero, for example), so they are saved before execution
+        cached_output_shapes_.resize(ctx->GetOutputCount());
+        for (uint32_t i = 0; i < ctx->GetOutputCount(); ++i) {
+            cached_output_shapes_[i] = *ctx->GetOutput<TensorImpl>(i)->GetShape();
+        }
+        input_signature_ = signature;
+        input_signature_key_.swap(key_buffer_);
+        reshape_cache_valid_ = true;
+    }
+
     return RC_SUCCESS;
 }
 
+void X86Kernel::SetReshapeCacheFlag(bool enabled) {
+    auto& type = GetType();
+    auto shape_data_inputs = FindKernelType(g_shape_data_inputs, type);
+    shape_data_input_mask_ = (shape_data_inputs ? shape_data_inputs->input_mask : 0);
+    reshape_cache_enabled_ = (enabled && !FindKernelType(g_data_dependent_kernels, type));
+    reshape_cache_valid_ = false;
+    reshape_cache_hit_ = false;
+    cached_output_shapes_.clear();
+    input_signature_key_.clear();
+}
+
+uint64_t X86Kernel::GetTmpBufferSize(const KernelExecContext& ctx) {
+    BuildShapeKey(ctx, &key_buffer_);
+    // sizes of tmp buffers of some kernels depend on the number of threads
+    key_buffer_.push_back(ppl::kernel::x86::get_omp_max_threads());
+    auto hash = HashKey(key_buffer_);
+    if (!tmp_buffer_size_valid_ || hash != shape_hash_ || key_buffer_ != shape_key_) {
+        tmp_buffer_size_ = CalcTmpBufferSize(ctx);
+        shape_hash_ = hash;
+        shape_key_.swap(key_buffer_);
+        tmp_buffer_size_valid_ = true;
+    }
+    return tmp_buffer_size_;
+}
+
 bool X86Kernel::CanDoExecute(const KernelExecContext& ctx) const {
     for (uint32_t i = 0; i < ctx.GetInputCount(); ++i) {
         auto tensor = ctx.GetInput<TensorImpl>(i);
@@ -45,18 +213,50 @@ bool X86Kernel::CanDoExecute(const KernelExecContext& ctx) const {
     return true;
 }
 
+RetCode X86Kernel::ReallocTensorBuffer(TensorImpl* tensor) {
+    auto device = GetX86Device();
+    tensor->SetDevice(device);
+
+    BufferDesc view;
+    if (tensor->GetType() == TENSORTYPE_NORMAL && !tensor->GetBufferPtr() &&
+        device->FindInplaceSlice(tensor->GetEdge()->GetId(), *tensor->GetShape(), &view)) {
+        tensor->SetBuffer(view, device, false);
+        return RC_SUCCESS;
+    }
+
+    return tensor->ReallocBuffer();
+}
+
 RetCode X86Kernel::Execute(KernelExecContext* ctx) {
 #ifdef PPLNN_ENABLE_KERNEL_PROFILING
     utils::CpuTimingGuard __timing_guard__(&begin_ts_, &end_ts_, ctx->IsProfilingEnabled());
 #endif
 
+    // the setting belongs to the calling thread, which may be shared with the application or other runtimes
+    const int32_t omp_threads = GetX86Device()->GetOmpThreadsPerKernel();
+    const int32_t saved_omp_threads = ppl::kernel::x86::get_omp_max_threads();
+    if (omp_threads > 0 && omp_threads != saved_omp_threads) {
+        ppl::kernel::x86::set_omp_max_threads(omp_threads);
+    }
+    utils::Destructor __omp_threads_guard([omp_threads, saved_omp_threads]() -> void {
+        if (omp_threads > 0 && omp_threads != saved_omp_threads) {
+            ppl::kernel::x86::set_omp_max_threads(saved_omp_threads);
+        }
+    });
+    GetX86Device()->BindOmpThreads();
+
     auto status = BeforeExecute(ctx);
     if (status != RC_SUCCESS) {
         LOG(ERROR) << "BeforeExecute() of kernel[" << GetName() << "] failed: " << GetRetCodeStr(status);
         return status;
     }
 
-    if (CanDoExecute(*ctx)) {
+    // result of CanDoExecute() only depends on shapes, which are the same as the last execution if cache hits
+    if (!reshape_cache_hit_) {
+        can_do_execute_ = CanDoExecute(*ctx);
+    }
+
+    if (can_do_execute_) {
         status = DoExecute(ctx);
     } else {
         // TODO: discard the boundary case of conv/pool/deconv, and try to remove this thing
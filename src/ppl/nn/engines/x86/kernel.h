@@ -38,6 +38,12 @@ public:
 
     ppl::common::RetCode Execute(KernelExecContext*) override final;
 
+    /**
+       @brief if enabled, `Reshape()` is skipped and output shapes of the last execution are restored when input
+       shapes and values of small inputs are the same as those of the last execution.
+    */
+    void SetReshapeCacheFlag(bool) override;
+
     ppl::common::RetCode Reshape(KernelExecContext* ctx) const {
         return reshape_func_(ctx);
     }
@@ -49,6 +55,9 @@ public:
     void SetCommonParam(const X86CommonParam* p) {
         common_param_ = p;
     }
+    const X86CommonParam* GetCommonParam() const {
+        return common_param_;
+    }
 
 protected:
     virtual bool CanDoExecute(const KernelExecContext&) const;
@@ -58,6 +67,19 @@ protected:
         return 0;
     }
 
+    /**
+       @brief returns the result of `CalcTmpBufferSize()`, which is recomputed only when shapes of inputs
+       or outputs(or the number of threads) differ from those of the last call.
+       @note must be called after outputs are reshaped.
+    */
+    uint64_t GetTmpBufferSize(const KernelExecContext& ctx);
+
+    /**
+       @brief sets device of `tensor` and allocates its buffer. if `tensor` is an input of an in-place Concat and its
+       shape is the same as that of the last run, a slice of the Concat's output is used as its buffer instead.
+    */
+    ppl::common::RetCode ReallocTensorBuffer(TensorImpl* tensor);
+
     bool MayUseISA(uint32_t flag) const {
         return !!(GetX86Device()->GetISA() & flag);
     }
@@ -78,6 +100,13 @@ public:
         auto diff = std::chrono::duration_cast<std::chrono::microseconds>(end_ts_ - begin_ts_);
         return diff.count();
     }
+    uint64_t GetExecutionBeginTime() const override {
+        auto ts = std::chrono::duration_cast<std::chrono::microseconds>(begin_ts_.time_since_epoch());
+        return ts.count();
+    }
+    bool IsReshapeCacheHit() const override {
+        return reshape_cache_hit_;
+    }
 
 private:
     std::chrono::time_point<std::chrono::system_clock> begin_ts_;
@@ -86,10 +115,31 @@ private:
 
 private:
     ppl::common::RetCode BeforeExecute(KernelExecContext*);
+    static void BuildShapeKey(const KernelExecContext&, std::vector<uint64_t>* key);
+    void BuildInputSignature(const KernelExecContext&, std::vector<uint64_t>* key) const;
 
 private:
     const X86CommonParam* common_param_ = nullptr;
     std::function<ppl::common::RetCode(InputOutputInfo*)> reshape_func_;
+
+    // scratch for building keys below without allocating every run
+    std::vector<uint64_t> key_buffer_;
+
+    // cached result of `CalcTmpBufferSize()`, keyed by shapes and the number of threads
+    bool tmp_buffer_size_valid_ = false;
+    uint64_t tmp_buffer_size_ = 0;
+    uint64_t shape_hash_ = 0; // hash of `shape_key_`
+    std::vector<uint64_t> shape_key_;
+
+    // output shapes inferred by `reshape_func_`, keyed by the signature of inputs
+    bool reshape_cache_enabled_ = false;
+    bool reshape_cache_valid_ = false;
+    bool reshape_cache_hit_ = false;
+    bool can_do_execute_ = false;
+    uint32_t shape_data_input_mask_ = 0; // inputs whose data is part of `input_signature_key_`
+    uint64_t input_signature_ = 0; // hash of `input_signature_key_`
+    std::vector<uint64_t> input_signature_key_;
+    std::vector<TensorShape> cached_output_shapes_;
 };
 
 }}} // namespace ppl::nn::x86
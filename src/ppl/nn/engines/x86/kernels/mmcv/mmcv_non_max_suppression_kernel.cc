@@ -16,11 +16,23 @@
 // under the License.
 
 #include "ppl/nn/engines/x86/kernels/mmcv/mmcv_non_max_suppression_kernel.h"
+#include "ppl/nn/utils/destructor.h"
+#include "ppl/nn/common/logger.h"
 
+#include "ppl/kernel/x86/fp32/nms.h"
 #include "ppl/kernel/x86/fp32/mmcv_nms.h"
 
 namespace ppl { namespace nn { namespace x86 {
 
+uint64_t MMCVNonMaxSuppressionKernel::CalcTmpBufferSize(const KernelExecContext& ctx) const {
+    if (!MayUseISA(ppl::common::ISA_X86_AVX)) {
+        return 0;
+    }
+    const uint32_t num_boxes = ctx.GetInput<TensorImpl>(0)->GetShape()->GetDim(0);
+    return kernel::x86::mmcv_nms_ndarray_fp32_get_buffer_bytes(
+        num_boxes, kernel::x86::nms_ndarray_fp32_bitmask_is_preferred(1, 1, num_boxes));
+}
+
 ppl::common::RetCode MMCVNonMaxSuppressionKernel::DoExecute(KernelExecContext* ctx) {
     auto boxes = ctx->GetInput<TensorImpl>(0);
     auto scores = ctx->GetInput<TensorImpl>(1);
@@ -41,10 +53,44 @@ ppl::common::RetCode MMCVNonMaxSuppressionKernel::DoExecute(KernelExecContext* c
     PPLNN_X86_DEBUG_TRACE("Output [output]:\n");
     PPL_X86_TENSOR_PRINT_DEBUG_MSG(output);
 
+    const uint32_t num_boxes = boxes->GetShape()->GetDim(0);
     int64_t real_num_boxes_output = 0;
-    auto ret = kernel::x86::mmcv_nms_ndarray_fp32(
-        boxes->GetBufferPtr<const float>(), scores->GetBufferPtr<const float>(), boxes->GetShape()->GetDim(0),
-        param_->iou_threshold, param_->offset, output->GetBufferPtr<int64_t>(), &real_num_boxes_output);
+
+    BufferDesc tmp_buffer_desc;
+    auto tmp_buffer_size = GetTmpBufferSize(*ctx);
+    auto status = GetX86Device()->AllocTmpBuffer(tmp_buffer_size, &tmp_buffer_desc);
+    if (status != ppl::common::RC_SUCCESS) {
+        LOG(ERROR) << "alloc tmp buffer size[" << tmp_buffer_size << "] for kernel[" << GetName()
+                   << "] failed: " << ppl::common::GetRetCodeStr(status);
+        return status;
+    }
+    utils::Destructor __tmp_buffer_guard([this, &tmp_buffer_desc]() -> void {
+        GetX86Device()->FreeTmpBuffer(&tmp_buffer_desc);
+    });
+    auto tmp_buffer = tmp_buffer_desc.addr;
+    PPLNN_X86_DEBUG_TRACE("buffer: %p\n", tmp_buffer);
+
+    // there is only one task in mmcv nms, so the suppression bitmask is the only way to use all threads
+    const bool use_bitmask = kernel::x86::nms_ndarray_fp32_bitmask_is_preferred(1, 1, num_boxes);
+    ppl::common::RetCode ret;
+    if (false) {
+    }
+#ifdef PPL_USE_X86_AVX512
+    else if (MayUseISA(ppl::common::ISA_X86_AVX512)) {
+        ret = kernel::x86::mmcv_nms_ndarray_fp32_avx512(
+            boxes->GetBufferPtr<const float>(), scores->GetBufferPtr<const float>(), num_boxes, param_->iou_threshold,
+            param_->offset, use_bitmask, tmp_buffer, output->GetBufferPtr<int64_t>(), &real_num_boxes_output);
+    }
+#endif
+    else if (MayUseISA(ppl::common::ISA_X86_AVX)) {
+        ret = kernel::x86::mmcv_nms_ndarray_fp32_avx(
+            boxes->GetBufferPtr<const float>(), scores->GetBufferPtr<const float>(), num_boxes, param_->iou_threshold,
+            param_->offset, use_bitmask, tmp_buffer, output->GetBufferPtr<int64_t>(), &real_num_boxes_output);
+    } else {
+        ret = kernel::x86::mmcv_nms_ndarray_fp32(boxes->GetBufferPtr<const float>(), scores->GetBufferPtr<const float>(),
+                                                 num_boxes, param_->iou_threshold, param_->offset,
+                                                 output->GetBufferPtr<int64_t>(), &real_num_boxes_output);
+    }
     if (ret != ppl::common::RC_SUCCESS) {
         ctx->GetOutput<TensorImpl>(0)->GetShape()->Reshape({0});
         return ret;
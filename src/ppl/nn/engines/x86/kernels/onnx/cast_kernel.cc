@@ -18,6 +18,7 @@
 #include "ppl/nn/engines/x86/kernels/onnx/cast_kernel.h"
 
 #include "ppl/kernel/x86/common/cast.h"
+#include "ppl/kernel/x86/bf16/cvt.h"
 
 namespace ppl { namespace nn { namespace x86 {
 
@@ -33,6 +34,21 @@ ppl::common::RetCode CastKernel::DoExecute(KernelExecContext* ctx) {
     PPLNN_X86_DEBUG_TRACE("to: %d\n", param_->to);
     PPLNN_X86_DEBUG_TRACE("isa: %u\n", GetISA());
 
+    const auto in_type = input->GetShape()->GetDataType();
+    const auto out_type = output->GetShape()->GetDataType();
+    if ((in_type == ppl::common::DATATYPE_FLOAT32 && out_type == ppl::common::DATATYPE_BFLOAT16) ||
+        (in_type == ppl::common::DATATYPE_BFLOAT16 && out_type == ppl::common::DATATYPE_FLOAT32)) {
+        PPLNN_X86_REALLOC_TENSOR_BUFFER(output);
+        PPLNN_X86_DEBUG_TRACE("Output [output]:\n");
+        PPL_X86_TENSOR_PRINT_DEBUG_MSG(output);
+        if (in_type == ppl::common::DATATYPE_FLOAT32) {
+            return kernel::x86::cvt_fp32_bf16(GetISA(), input->GetShape(), input->GetBufferPtr<float>(),
+                                              output->GetBufferPtr<uint16_t>());
+        }
+        return kernel::x86::cvt_bf16_fp32(GetISA(), input->GetShape(), input->GetBufferPtr<uint16_t>(),
+                                          output->GetBufferPtr<float>());
+    }
+
     if (ppl::common::GetSizeOfDataType(input->GetShape()->GetDataType()) == ppl::common::GetSizeOfDataType(output->GetShape()->GetDataType())
         && ctx->IsLastConsumerOfInput(0)
         && input->GetType() == TENSORTYPE_NORMAL) {
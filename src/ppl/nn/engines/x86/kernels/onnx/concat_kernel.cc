@@ -17,6 +17,7 @@
 
 #include "ppl/nn/engines/x86/kernels/onnx/concat_kernel.h"
 #include "ppl/nn/engines/x86/macros.h"
+#include "ppl/nn/engines/x86/utils.h"
 #include "ppl/kernel/x86/fp32/concat.h"
 #include "ppl/kernel/x86/int64/concat.h"
 #include "ppl/kernel/x86/bool/concat.h"
@@ -41,6 +42,79 @@ uint64_t ConcatKernel::CalcTmpBufferSize(const KernelExecContext& ctx) const {
     return 0;
 }
 
+ppl::common::RetCode ConcatKernel::DoInplaceExecute(KernelExecContext* ctx, bool* done) {
+    *done = false;
+
+    auto concat_result = ctx->GetOutput<TensorImpl>(0);
+    auto output_shape = concat_result->GetShape();
+    const uint32_t input_count = ctx->GetInputCount();
+    const int32_t real_axis = param_->axis < 0 ? param_->axis + output_shape->GetDimCount() : param_->axis;
+    if (!CalcContiguousSliceOffsets(*output_shape, src_shape_list_.data(), input_count, real_axis, 64,
+                                    &slice_offsets_)) {
+        return ppl::common::RC_SUCCESS;
+    }
+
+    auto device = GetX86Device();
+    const edgeid_t eid = concat_result->GetEdge()->GetId();
+
+    auto ib = device->FindInplaceBuffer(eid);
+    bool slices_changed = (!ib || ib->slices.size() != input_count);
+    for (uint32_t i = 0; !slices_changed && i < input_count; ++i) {
+        auto& slice = ib->slices[i];
+        slices_changed = (slice.offset != slice_offsets_[i] || !TensorShapeEqual(slice.shape, *src_shape_list_[i]));
+    }
+
+    if (slices_changed) {
+        /*
+          inputs whose shapes are not changed may be slices of the current buffer. they are copied into the output
+          before the buffer is replaced, and producers will write into slices of the new buffer from the next run.
+        */
+        PPLNN_X86_REALLOC_TENSOR_BUFFER(concat_result);
+        auto dst = concat_result->GetBufferPtr<char>();
+        for (uint32_t i = 0; i < input_count; ++i) {
+            memcpy(dst + slice_offsets_[i], src_list_[i], src_shape_list_[i]->GetBytesIncludingPadding());
+        }
+        PPLNN_X86_DEBUG_TRACE("Output [concat_result]:\n");
+        PPL_X86_TENSOR_PRINT_DEBUG_MSG(concat_result);
+        *done = true;
+
+        auto status = device->AllocInplaceBuffer(eid, output_shape->GetBytesIncludingPadding(), &ib);
+        if (status == ppl::common::RC_UNSUPPORTED) {
+            return ppl::common::RC_SUCCESS;
+        }
+        if (status != ppl::common::RC_SUCCESS) {
+            LOG(ERROR) << "AllocInplaceBuffer for tensor[" << concat_result->GetName()
+                       << "] failed: " << ppl::common::GetRetCodeStr(status);
+            return status;
+        }
+
+        std::vector<InplaceBuffer::Slice> slices(input_count);
+        for (uint32_t i = 0; i < input_count; ++i) {
+            slices[i].eid = ctx->GetInput<TensorImpl>(i)->GetEdge()->GetId();
+            slices[i].shape = *src_shape_list_[i];
+            slices[i].offset = slice_offsets_[i];
+        }
+        device->SetInplaceSlices(ib, std::move(slices));
+        return ppl::common::RC_SUCCESS;
+    }
+
+    auto base = (char*)ib->buffer.addr;
+    for (uint32_t i = 0; i < input_count; ++i) {
+        auto dst = base + slice_offsets_[i];
+        // producers which take over buffers of their inputs cannot write into slices
+        if (src_list_[i] != dst) {
+            memcpy(dst, src_list_[i], src_shape_list_[i]->GetBytesIncludingPadding());
+        }
+    }
+
+    concat_result->SetBuffer(BufferDesc(base), device, false);
+    PPLNN_X86_DEBUG_TRACE("Output [concat_result]:\n");
+    PPL_X86_TENSOR_PRINT_DEBUG_MSG(concat_result);
+
+    *done = true;
+    return ppl::common::RC_SUCCESS;
+}
+
 ppl::common::RetCode ConcatKernel::DoExecute(KernelExecContext* ctx) {
     src_list_.resize(ctx->GetInputCount());
     src_shape_list_.resize(ctx->GetInputCount());
@@ -60,6 +134,14 @@ ppl::common::RetCode ConcatKernel::DoExecute(KernelExecContext* ctx) {
     PPLNN_X86_DEBUG_TRACE("axis: %d\n", param_->axis);
     PPLNN_X86_DEBUG_TRACE("isa: %u\n", GetISA());
 
+    if (inplace_) {
+        bool done = false;
+        auto status = DoInplaceExecute(ctx, &done);
+        if (status != ppl::common::RC_SUCCESS || done) {
+            return status;
+        }
+    }
+
     PPLNN_X86_REALLOC_TENSOR_BUFFER(concat_result);
     PPLNN_X86_DEBUG_TRACE("Output [concat_result]:\n");
     PPL_X86_TENSOR_PRINT_DEBUG_MSG(concat_result);
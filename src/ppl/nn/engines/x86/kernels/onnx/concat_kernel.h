@@ -31,13 +31,22 @@ public:
         param_ = p;
     }
 
+    /** @brief outputs of producers are written into slices of the output directly if possible */
+    void SetInplace(bool inplace) {
+        inplace_ = inplace;
+    }
+
 private:
     uint64_t CalcTmpBufferSize(const KernelExecContext& ctx) const override;
     ppl::common::RetCode DoExecute(KernelExecContext*) override;
     bool CanDoExecute(const KernelExecContext&) const override;
+    /** @param done set to false if the in-place buffer cannot be used and the output should be computed normally */
+    ppl::common::RetCode DoInplaceExecute(KernelExecContext*, bool* done);
 
 private:
     const ppl::nn::onnx::ConcatParam* param_ = nullptr;
+    bool inplace_ = false;
+    std::vector<uint64_t> slice_offsets_;
     std::vector<const void*> src_list_;
     std::vector<const TensorShape*> src_shape_list_;
 };
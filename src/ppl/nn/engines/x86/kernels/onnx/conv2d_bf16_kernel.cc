@@ -0,0 +1,89 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "ppl/nn/utils/destructor.h"
+#include "ppl/nn/engines/x86/kernels/onnx/conv2d_bf16_kernel.h"
+
+namespace ppl { namespace nn { namespace x86 {
+
+uint64_t Conv2dBf16Kernel::CalcTmpBufferSize(const KernelExecContext& ctx) const {
+    if (param_->data_format == ppl::common::DATAFORMAT_N16CX) {
+        return 0;
+    }
+    auto y = ctx.GetOutput<TensorImpl>(0);
+    return ppl::kernel::x86::conv2d_bf16_get_temp_buffer_bytes(param_->param, y->GetShape());
+}
+
+ppl::common::RetCode Conv2dBf16Kernel::DoExecute(KernelExecContext* ctx) {
+    PPLNN_X86_REQUIRED_INPUT(X, 0);
+    PPLNN_X86_REQUIRED_OUTPUT(Y, 0);
+
+    PPLNN_X86_DEBUG_TRACE("Op: %s\n", GetName().c_str());
+    PPLNN_X86_DEBUG_TRACE("Input [X]:\n");
+    PPL_X86_TENSOR_PRINT_DEBUG_MSG(X);
+
+    PPLNN_X86_DEBUG_TRACE("kernel_shape: %ld %ld\n", param_->param.kernel_h, param_->param.kernel_w);
+    PPLNN_X86_DEBUG_TRACE("dilations: %ld %ld\n", param_->param.dilation_h, param_->param.dilation_w);
+    PPLNN_X86_DEBUG_TRACE("strides: %ld %ld\n", param_->param.stride_h, param_->param.stride_w);
+    PPLNN_X86_DEBUG_TRACE("pads: %ld %ld\n", param_->param.pad_h, param_->param.pad_w);
+    PPLNN_X86_DEBUG_TRACE("group: %ld\n", param_->param.group);
+    PPLNN_X86_DEBUG_TRACE("channels: %ld\n", param_->param.channels);
+    PPLNN_X86_DEBUG_TRACE("num_output: %ld\n", param_->param.num_output);
+    PPLNN_X86_DEBUG_TRACE("post: %d\n", param_->param.post);
+    PPLNN_X86_DEBUG_TRACE("isa: %u\n", GetISA());
+
+    if (X->GetShape()->GetDataType() != ppl::common::DATATYPE_BFLOAT16 ||
+        X->GetShape()->GetDataFormat() != param_->data_format) {
+        LOG(ERROR) << "only support bfloat16 " << ppl::common::GetDataFormatStr(param_->data_format)
+                   << " input, but got [" << ppl::common::GetDataTypeStr(X->GetShape()->GetDataType()) << "]["
+                   << ppl::common::GetDataFormatStr(X->GetShape()->GetDataFormat()) << "].";
+        return ppl::common::RC_UNSUPPORTED;
+    }
+
+    PPLNN_X86_REALLOC_TENSOR_BUFFER(Y);
+    PPLNN_X86_DEBUG_TRACE("Output [Y]:\n");
+    PPL_X86_TENSOR_PRINT_DEBUG_MSG(Y);
+
+    if (param_->data_format == ppl::common::DATAFORMAT_N16CX) {
+        return ppl::kernel::x86::conv2d_n16cx_bf16(GetISA(), param_->param, X->GetShape(),
+                                                   X->GetBufferPtr<uint16_t>(), param_->packed_weight.data(),
+                                                   param_->bias.empty() ? nullptr : param_->bias.data(),
+                                                   Y->GetShape(), Y->GetBufferPtr<void>());
+    }
+
+    BufferDesc tmp_buffer_desc;
+    auto tmp_buffer_size = GetTmpBufferSize(*ctx);
+    auto status = GetX86Device()->AllocTmpBuffer(tmp_buffer_size, &tmp_buffer_desc);
+    if (status != ppl::common::RC_SUCCESS) {
+        LOG(ERROR) << "alloc tmp buffer size[" << tmp_buffer_size << "] for kernel[" << GetName()
+                   << "] failed: " << ppl::common::GetRetCodeStr(status);
+        return status;
+    }
+    utils::Destructor __tmp_buffer_guard([this, &tmp_buffer_desc]() -> void {
+        GetX86Device()->FreeTmpBuffer(&tmp_buffer_desc);
+    });
+    auto tmp_buffer = tmp_buffer_desc.addr;
+    PPLNN_X86_DEBUG_TRACE("buffer: %p\n", tmp_buffer);
+
+    return ppl::kernel::x86::conv2d_bf16(GetISA(), param_->param, X->GetShape(), X->GetBufferPtr<uint16_t>(),
+                                         param_->packed_weight.data(),
+                                         param_->bias.empty() ? nullptr : param_->bias.data(), Y->GetShape(),
+                                         tmp_buffer, Y->GetBufferPtr<void>());
+}
+
+}}} // namespace ppl::nn::x86
@@ -24,6 +24,11 @@ namespace ppl { namespace nn { namespace x86 {
 uint64_t ConvTransposeKernel::CalcTmpBufferSize(const KernelExecContext& ctx) const {
     auto x = ctx.GetInput<TensorImpl>(0);
 
+    if (n16cx_param_ && x->GetShape()->GetDataFormat() == ppl::common::DATAFORMAT_N16CX) {
+        auto y = ctx.GetOutput<TensorImpl>(0);
+        return kernel::x86::conv_transpose_n16cx_fp32_get_buffer_bytes(n16cx_param_->param, y->GetShape());
+    }
+
     const int32_t batch = x->GetShape()->GetDim(0);
     const int32_t src_h = x->GetShape()->GetDim(2);
     const int32_t src_w = x->GetShape()->GetDim(3);
@@ -81,6 +86,9 @@ ppl::common::RetCode ConvTransposeKernel::DoExecute(KernelExecContext* ctx) {
     PPLNN_X86_DEBUG_TRACE("strides: %d %d\n", param_->strides[0], param_->strides[1]);
     PPLNN_X86_DEBUG_TRACE("pads: %d %d %d %d\n", param_->pads[0], param_->pads[1], param_->pads[2], param_->pads[3]);
     PPLNN_X86_DEBUG_TRACE("group: %ld\n", param_->group);
+    if (n16cx_param_) {
+        PPLNN_X86_DEBUG_TRACE("fuse_flag: %lu\n", n16cx_param_->param.fuse_flag);
+    }
     PPLNN_X86_DEBUG_TRACE("isa: %u\n", GetISA());
 
     const int32_t batch = X->GetShape()->GetDim(0);
@@ -95,7 +103,7 @@ ppl::common::RetCode ConvTransposeKernel::DoExecute(KernelExecContext* ctx) {
     PPL_X86_TENSOR_PRINT_DEBUG_MSG(Y);
 
     BufferDesc tmp_buffer_desc;
-    auto tmp_buffer_size = CalcTmpBufferSize(*ctx);
+    auto tmp_buffer_size = GetTmpBufferSize(*ctx);
     auto status = GetX86Device()->AllocTmpBuffer(tmp_buffer_size, &tmp_buffer_desc);
     if (status != ppl::common::RC_SUCCESS) {
         LOG(ERROR) << "alloc tmp buffer size[" << tmp_buffer_size << "] for kernel[" << GetName()
@@ -112,7 +120,24 @@ ppl::common::RetCode ConvTransposeKernel::DoExecute(KernelExecContext* ctx) {
     const auto data_type = X->GetShape()->GetDataType();
 
     if (data_type == ppl::common::DATATYPE_FLOAT32) {
-        if (data_format == ppl::common::DATAFORMAT_NDARRAY) {
+        if (data_format == ppl::common::DATAFORMAT_N16CX && n16cx_param_) {
+            if (false) {
+            }
+#ifdef PPL_USE_X86_AVX512
+            else if (MayUseISA(ppl::common::ISA_X86_AVX512)) {
+                return kernel::x86::conv_transpose_n16cx_fp32_avx512(
+                    n16cx_param_->param, X->GetShape(), X->GetBufferPtr<float>(), n16cx_param_->packed_weight.data(),
+                    Y->GetShape(), tmp_buffer, Y->GetBufferPtr<float>());
+            }
+#endif
+            else if (MayUseISA(ppl::common::ISA_X86_FMA)) {
+                return kernel::x86::conv_transpose_n16cx_fp32_fma(
+                    n16cx_param_->param, X->GetShape(), X->GetBufferPtr<float>(), n16cx_param_->packed_weight.data(),
+                    Y->GetShape(), tmp_buffer, Y->GetBufferPtr<float>());
+            } else {
+                LOG(ERROR) << "unsupported isa: " << GetISA();
+            }
+        } else if (data_format == ppl::common::DATAFORMAT_NDARRAY) {
             if (false) {
             }
 #ifdef PPL_USE_X86_AVX512
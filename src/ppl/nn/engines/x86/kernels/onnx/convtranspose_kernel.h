@@ -20,6 +20,7 @@
 
 #include "ppl/nn/engines/x86/kernel.h"
 #include "ppl/nn/params/onnx/convtranspose_param.h"
+#include "ppl/nn/engines/x86/params/convtranspose_param.h"
 
 namespace ppl { namespace nn { namespace x86 {
 
@@ -30,6 +31,9 @@ public:
     void SetParam(const ppl::nn::onnx::ConvTransposeParam* p) {
         param_ = p;
     }
+    void SetN16cxParam(const ConvTransposeN16cxParam* p) {
+        n16cx_param_ = p;
+    }
 
 private:
     uint64_t CalcTmpBufferSize(const KernelExecContext& ctx) const override;
@@ -37,6 +41,7 @@ private:
 
 private:
     const ppl::nn::onnx::ConvTransposeParam* param_ = nullptr;
+    const ConvTransposeN16cxParam* n16cx_param_ = nullptr;
 };
 
 }}} // namespace ppl::nn::x86
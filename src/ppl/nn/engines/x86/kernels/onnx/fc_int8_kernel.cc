@@ -0,0 +1,104 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/nn/engines/x86/kernels/onnx/fc_int8_kernel.h"
+#include "ppl/nn/utils/destructor.h"
+
+namespace ppl { namespace nn { namespace x86 {
+
+uint64_t FCInt8Kernel::CalcTmpBufferSize(const KernelExecContext& ctx) const {
+    // input rows can be used directly if they are aligned
+    if (param_->channels % ppl::kernel::x86::GEMM_S8U8_K_ALIGN == 0) {
+        return 0;
+    }
+    auto a = ctx.GetInput<TensorImpl>(0);
+    return ppl::kernel::x86::gemm_s8u8_get_packed_b_bytes(ppl::kernel::x86::gemm_s8u8_layout::LANE_A,
+                                                          a->GetShape()->GetDim(0), param_->channels);
+}
+
+ppl::common::RetCode FCInt8Kernel::DoExecute(KernelExecContext* ctx) {
+    PPLNN_X86_REQUIRED_INPUT(A, 0);
+    PPLNN_X86_REQUIRED_OUTPUT(Y, 0);
+
+    PPLNN_X86_DEBUG_TRACE("Op: %s\n", GetName().c_str());
+    PPLNN_X86_DEBUG_TRACE("Input [A]:\n");
+    PPL_X86_TENSOR_PRINT_DEBUG_MSG(A);
+
+    PPLNN_X86_DEBUG_TRACE("channels: %ld\n", param_->channels);
+    PPLNN_X86_DEBUG_TRACE("num_output: %ld\n", param_->num_output);
+    PPLNN_X86_DEBUG_TRACE("post: %d\n", param_->post);
+    PPLNN_X86_DEBUG_TRACE("isa: %u\n", GetISA());
+
+    if (A->GetShape()->GetDataType() != ppl::common::DATATYPE_UINT8) {
+        LOG(ERROR) << "only support uint8 input, but got ["
+                   << ppl::common::GetDataTypeStr(A->GetShape()->GetDataType()) << "].";
+        return ppl::common::RC_UNSUPPORTED;
+    }
+
+    PPLNN_X86_REALLOC_TENSOR_BUFFER(Y);
+    PPLNN_X86_DEBUG_TRACE("Output [Y]:\n");
+    PPL_X86_TENSOR_PRINT_DEBUG_MSG(Y);
+
+    BufferDesc tmp_buffer_desc;
+    auto tmp_buffer_size = GetTmpBufferSize(*ctx);
+    auto status = GetX86Device()->AllocTmpBuffer(tmp_buffer_size, &tmp_buffer_desc);
+    if (status != ppl::common::RC_SUCCESS) {
+        LOG(ERROR) << "alloc tmp buffer size[" << tmp_buffer_size << "] for kernel[" << GetName()
+                   << "] failed: " << ppl::common::GetRetCodeStr(status);
+        return status;
+    }
+    utils::Destructor __tmp_buffer_guard([this, &tmp_buffer_desc]() -> void {
+        GetX86Device()->FreeTmpBuffer(&tmp_buffer_desc);
+    });
+    PPLNN_X86_DEBUG_TRACE("buffer: %p\n", tmp_buffer_desc.addr);
+
+    const int64_t batch = A->GetShape()->GetDim(0);
+
+    ppl::kernel::x86::gemm_s8u8_param gemm_param;
+    gemm_param.layout = ppl::kernel::x86::gemm_s8u8_layout::LANE_A;
+    gemm_param.packed_a = param_->packed_weight.data();
+    gemm_param.packed_b = A->GetBufferPtr<uint8_t>();
+    gemm_param.ldb = param_->channels;
+    if (tmp_buffer_size > 0) {
+        auto packed_b = (uint8_t*)tmp_buffer_desc.addr;
+        status = ppl::kernel::x86::gemm_s8u8_pack_b_trans(gemm_param.layout, A->GetBufferPtr<uint8_t>(), batch,
+                                                          param_->channels, param_->channels, packed_b,
+                                                          &gemm_param.ldb);
+        if (status != ppl::common::RC_SUCCESS) {
+            LOG(ERROR) << "pack input failed: " << ppl::common::GetRetCodeStr(status);
+            return status;
+        }
+        gemm_param.packed_b = packed_b;
+    }
+    gemm_param.scale = param_->scale.data();
+    gemm_param.bias = param_->bias.empty() ? nullptr : param_->bias.data();
+    gemm_param.a_sum = param_->weight_sum.data();
+    gemm_param.M = param_->num_output;
+    gemm_param.N = batch;
+    gemm_param.K = param_->channels;
+    gemm_param.ldc = param_->num_output;
+    gemm_param.b_zero_point = param_->src_quant.zero_point;
+    gemm_param.post = param_->post;
+    gemm_param.c_type = Y->GetShape()->GetDataType();
+    gemm_param.c_scale = param_->dst_quant.scale;
+    gemm_param.c_zero_point = param_->dst_quant.zero_point;
+    gemm_param.C = Y->GetBufferPtr<void>();
+
+    return ppl::kernel::x86::gemm_s8u8(GetISA(), gemm_param);
+}
+
+}}} // namespace ppl::nn::x86
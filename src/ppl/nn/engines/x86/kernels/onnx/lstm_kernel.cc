@@ -42,6 +42,12 @@ uint64_t LSTMKernel::CalcTmpBufferSize(const KernelExecContext& ctx) const {
     const bool has_Y = ctx.GetOutputCount() > 0 && ctx.GetOutput<TensorImpl>(0);
     const bool has_Y_h = ctx.GetOutputCount() > 1 && ctx.GetOutput<TensorImpl>(1);
     const bool has_Y_c = ctx.GetOutputCount() > 2 && ctx.GetOutput<TensorImpl>(2);
+#ifdef PPL_USE_X86_AVX512
+    if (MayUseISA(ppl::common::ISA_X86_AVX512)) {
+        return kernel::x86::lstm_fp32_avx512_get_buffer_bytes(
+            X->GetShape(), direction_, param_->hidden_size, has_Y, has_Y_h, has_Y_c);
+    }
+#endif
     if (MayUseISA(ppl::common::ISA_X86_FMA)) {
         return kernel::x86::lstm_fp32_fma_get_buffer_bytes(
             X->GetShape(), direction_, param_->hidden_size, has_Y, has_Y_h, has_Y_c);
@@ -143,7 +149,7 @@ ppl::common::RetCode LSTMKernel::DoExecute(KernelExecContext* ctx) {
     }
 
     BufferDesc tmp_buffer_desc;
-    auto tmp_buffer_size = CalcTmpBufferSize(*ctx);
+    auto tmp_buffer_size = GetTmpBufferSize(*ctx);
     auto status = GetX86Device()->AllocTmpBuffer(tmp_buffer_size, &tmp_buffer_desc);
     if (status != ppl::common::RC_SUCCESS) {
         LOG(ERROR) << "alloc tmp buffer size[" << tmp_buffer_size << "] for kernel[" << GetName()
@@ -160,6 +166,15 @@ ppl::common::RetCode LSTMKernel::DoExecute(KernelExecContext* ctx) {
     const auto data_format = X->GetShape()->GetDataFormat();
 
     if (data_type == ppl::common::DATATYPE_FLOAT32 && data_format == ppl::common::DATAFORMAT_NDARRAY) {
+#ifdef PPL_USE_X86_AVX512
+        if (MayUseISA(ppl::common::ISA_X86_AVX512)) {
+            return kernel::x86::lstm_fp32_avx512(
+                X->GetShape(), X->GetBufferPtr<const float>(),
+                W->GetBufferPtr<const float>(), R->GetBufferPtr<const float>(),
+                P_data, B_data, sequence_lens_data, initial_h_data, initial_c_data,
+                direction_, param_->hidden_size, tmp_buffer, Y_data, Y_h_data, Y_c_data);
+        }
+#endif
         if (MayUseISA(ppl::common::ISA_X86_FMA)) {
             return kernel::x86::lstm_fp32_fma(
                 X->GetShape(), X->GetBufferPtr<const float>(),
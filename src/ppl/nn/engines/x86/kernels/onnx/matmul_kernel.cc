@@ -22,13 +22,48 @@
 namespace ppl { namespace nn { namespace x86 {
 
 uint64_t MatMulKernel::CalcTmpBufferSize(const KernelExecContext& ctx) const {
+    if (param_) {
+        return 0;
+    }
+
     const TensorShape* A = ctx.GetInput<TensorImpl>(0)->GetShape();
     const TensorShape* B = ctx.GetInput<TensorImpl>(1)->GetShape();
 
     return kernel::x86::matmul_ndarray_fp32_get_buffer_bytes(A, B, GetISA());
 }
 
+ppl::common::RetCode MatMulKernel::ExecutePackedB(KernelExecContext* ctx) {
+    PPLNN_X86_REQUIRED_INPUT(A, 0);
+    PPLNN_X86_REQUIRED_OUTPUT(Y, 0);
+
+    PPLNN_X86_DEBUG_TRACE("Op: %s\n", GetName().c_str());
+    PPLNN_X86_DEBUG_TRACE("Input [A]:\n");
+    PPL_X86_TENSOR_PRINT_DEBUG_MSG(A);
+
+    PPLNN_X86_DEBUG_TRACE("packed B: N(%ld) K(%ld)\n", param_->N, param_->K);
+    PPLNN_X86_DEBUG_TRACE("isa: %u\n", param_->packed_isa);
+
+    PPLNN_X86_REALLOC_TENSOR_BUFFER(Y);
+    PPLNN_X86_DEBUG_TRACE("Output [Y]:\n");
+    PPL_X86_TENSOR_PRINT_DEBUG_MSG(Y);
+
+    const auto data_type = A->GetShape()->GetDataType();
+    const auto data_format = A->GetShape()->GetDataFormat();
+    if (data_type != ppl::common::DATATYPE_FLOAT32 || data_format != ppl::common::DATAFORMAT_NDARRAY) {
+        LOG(ERROR) << "only support fp32 ndarray now.";
+        return ppl::common::RC_UNSUPPORTED;
+    }
+
+    return kernel::x86::matmul_ndarray_packed_b_fp32(A->GetShape(), A->GetBufferPtr<float>(),
+                                                     param_->packed_b.data(), param_->N, param_->K,
+                                                     param_->packed_isa, Y->GetBufferPtr<float>());
+}
+
 ppl::common::RetCode MatMulKernel::DoExecute(KernelExecContext* ctx) {
+    if (param_) {
+        return ExecutePackedB(ctx);
+    }
+
     PPLNN_X86_REQUIRED_INPUT(A, 0);
     PPLNN_X86_REQUIRED_INPUT(B, 1);
     PPLNN_X86_REQUIRED_OUTPUT(Y, 0);
@@ -46,7 +81,7 @@ ppl::common::RetCode MatMulKernel::DoExecute(KernelExecContext* ctx) {
     PPL_X86_TENSOR_PRINT_DEBUG_MSG(Y);
 
     BufferDesc tmp_buffer_desc;
-    auto tmp_buffer_size = CalcTmpBufferSize(*ctx);
+    auto tmp_buffer_size = GetTmpBufferSize(*ctx);
     auto status = GetX86Device()->AllocTmpBuffer(tmp_buffer_size, &tmp_buffer_desc);
     if (status != ppl::common::RC_SUCCESS) {
         LOG(ERROR) << "alloc tmp buffer size[" << tmp_buffer_size << "] for kernel[" << GetName()
@@ -19,6 +19,7 @@
 #define _ST_HPC_PPL_NN_ENGINES_X86_KERNELS_ONNX_MATMUL_KERNEL_H_
 
 #include "ppl/nn/engines/x86/kernel.h"
+#include "ppl/nn/engines/x86/params/matmul_param.h"
 
 namespace ppl { namespace nn { namespace x86 {
 
@@ -26,9 +27,18 @@ class MatMulKernel : public X86Kernel {
 public:
     MatMulKernel(const ir::Node* node) : X86Kernel(node) {}
 
+    /** @brief uses constant B packed at optimization time. B is not read if it is set. */
+    void SetParam(const MatMulParam* p) {
+        param_ = p;
+    }
+
 private:
     uint64_t CalcTmpBufferSize(const KernelExecContext&) const override;
     ppl::common::RetCode DoExecute(KernelExecContext*) override;
+    ppl::common::RetCode ExecutePackedB(KernelExecContext*);
+
+private:
+    const MatMulParam* param_ = nullptr;
 };
 
 }}} // namespace ppl::nn::x86
@@ -16,20 +16,44 @@
 // under the License.
 
 #include "ppl/nn/engines/x86/kernels/onnx/non_max_suppression_kernel.h"
+#include "ppl/nn/utils/destructor.h"
+#include "ppl/nn/common/logger.h"
 #include "ppl/kernel/x86/fp32/nms.h"
 #include <float.h>
 
 namespace ppl { namespace nn { namespace x86 {
 
+int64_t NonMaxSuppressionKernel::GetMaxOutputBoxesPerClass(const KernelExecContext& ctx) const {
+    auto max_output_boxes_per_class_tensor = ctx.GetInputCount() > 2 ? ctx.GetInput<TensorImpl>(2) : nullptr;
+    return max_output_boxes_per_class_tensor ? max_output_boxes_per_class_tensor->GetBufferPtr<int64_t>()[0] : 0;
+}
+
+bool NonMaxSuppressionKernel::UseBitmask(const KernelExecContext& ctx) const {
+    auto boxes_shape = ctx.GetInput<TensorImpl>(0)->GetShape();
+    auto scores_shape = ctx.GetInput<TensorImpl>(1)->GetShape();
+    return ppl::kernel::x86::nms_ndarray_fp32_bitmask_is_preferred(boxes_shape->GetDim(0), scores_shape->GetDim(1),
+                                                                  boxes_shape->GetDim(1));
+}
+
+uint64_t NonMaxSuppressionKernel::CalcTmpBufferSize(const KernelExecContext& ctx) const {
+    if (!MayUseISA(ppl::common::ISA_X86_AVX)) {
+        return 0;
+    }
+    auto boxes_shape = ctx.GetInput<TensorImpl>(0)->GetShape();
+    auto scores_shape = ctx.GetInput<TensorImpl>(1)->GetShape();
+    // the size must not depend on max_output_boxes_per_class, because it is cached by shapes
+    return ppl::kernel::x86::nms_ndarray_fp32_get_buffer_bytes(boxes_shape->GetDim(1), boxes_shape->GetDim(0),
+                                                               scores_shape->GetDim(1), 0, UseBitmask(ctx));
+}
+
 ppl::common::RetCode NonMaxSuppressionKernel::DoExecute(KernelExecContext* ctx) {
     PPLNN_X86_REQUIRED_INPUT(boxes, 0);
     PPLNN_X86_REQUIRED_INPUT(scores, 1);
-    PPLNN_X86_OPTIONAL_INPUT(max_output_boxes_per_class_tensor, 2);
     PPLNN_X86_OPTIONAL_INPUT(iou_threshold_tensor, 3);
     PPLNN_X86_OPTIONAL_INPUT(score_threshold_tensor, 4);
     PPLNN_X86_REQUIRED_OUTPUT(output, 0);
     
-    const int64_t max_output_boxes_per_class = max_output_boxes_per_class_tensor ? max_output_boxes_per_class_tensor->GetBufferPtr<int64_t>()[0] : 0;
+    const int64_t max_output_boxes_per_class = GetMaxOutputBoxesPerClass(*ctx);
     const float iou_threshold = iou_threshold_tensor ? (iou_threshold_tensor->GetBufferPtr<float>())[0] : 0;
     const float score_threshold = score_threshold_tensor ? (score_threshold_tensor->GetBufferPtr<float>())[0] : -FLT_MAX;
 
@@ -48,13 +72,49 @@ ppl::common::RetCode NonMaxSuppressionKernel::DoExecute(KernelExecContext* ctx)
     PPLNN_X86_DEBUG_TRACE("Output [output]:\n");
     PPL_X86_TENSOR_PRINT_DEBUG_MSG(output);
 
+    const uint32_t num_boxes = boxes->GetShape()->GetDim(1);
+    const uint32_t batch = boxes->GetShape()->GetDim(0);
+    const uint32_t num_classes = scores->GetShape()->GetDim(1);
     int64_t real_num_boxes_output = 0;
 
-    auto ret = kernel::x86::nms_ndarray_fp32(boxes->GetBufferPtr<const float>(), scores->GetBufferPtr<const float>(),
-                                             boxes->GetShape()->GetDim(1), boxes->GetShape()->GetDim(0),
-                                             scores->GetShape()->GetDim(1), param_->center_point_box != 0,
-                                             max_output_boxes_per_class, iou_threshold, score_threshold,
-                                             output->GetBufferPtr<int64_t>(), &real_num_boxes_output);
+    BufferDesc tmp_buffer_desc;
+    auto tmp_buffer_size = GetTmpBufferSize(*ctx);
+    auto status = GetX86Device()->AllocTmpBuffer(tmp_buffer_size, &tmp_buffer_desc);
+    if (status != ppl::common::RC_SUCCESS) {
+        LOG(ERROR) << "alloc tmp buffer size[" << tmp_buffer_size << "] for kernel[" << GetName()
+                   << "] failed: " << ppl::common::GetRetCodeStr(status);
+        return status;
+    }
+    utils::Destructor __tmp_buffer_guard([this, &tmp_buffer_desc]() -> void {
+        GetX86Device()->FreeTmpBuffer(&tmp_buffer_desc);
+    });
+    auto tmp_buffer = tmp_buffer_desc.addr;
+    PPLNN_X86_DEBUG_TRACE("buffer: %p\n", tmp_buffer);
+
+    // onnx NonMaxSuppression has no topk, all boxes above score_threshold are candidates
+    const bool use_bitmask = UseBitmask(*ctx);
+    ppl::common::RetCode ret;
+    if (false) {
+    }
+#ifdef PPL_USE_X86_AVX512
+    else if (MayUseISA(ppl::common::ISA_X86_AVX512)) {
+        ret = kernel::x86::nms_ndarray_fp32_avx512(
+            boxes->GetBufferPtr<const float>(), scores->GetBufferPtr<const float>(), num_boxes, batch, num_classes,
+            param_->center_point_box != 0, max_output_boxes_per_class, iou_threshold, score_threshold, 0, use_bitmask,
+            tmp_buffer, output->GetBufferPtr<int64_t>(), &real_num_boxes_output);
+    }
+#endif
+    else if (MayUseISA(ppl::common::ISA_X86_AVX)) {
+        ret = kernel::x86::nms_ndarray_fp32_avx(
+            boxes->GetBufferPtr<const float>(), scores->GetBufferPtr<const float>(), num_boxes, batch, num_classes,
+            param_->center_point_box != 0, max_output_boxes_per_class, iou_threshold, score_threshold, 0, use_bitmask,
+            tmp_buffer, output->GetBufferPtr<int64_t>(), &real_num_boxes_output);
+    } else {
+        ret = kernel::x86::nms_ndarray_fp32(boxes->GetBufferPtr<const float>(), scores->GetBufferPtr<const float>(),
+                                            num_boxes, batch, num_classes, param_->center_point_box != 0,
+                                            max_output_boxes_per_class, iou_threshold, score_threshold,
+                                            output->GetBufferPtr<int64_t>(), &real_num_boxes_output);
+    }
     if (ret != ppl::common::RC_SUCCESS) {
         ctx->GetOutput<TensorImpl>(0)->GetShape()->Reshape({0, 3});
         return ret;
@@ -32,8 +32,12 @@ public:
     }
 
 private:
+    uint64_t CalcTmpBufferSize(const KernelExecContext& ctx) const override;
     ppl::common::RetCode DoExecute(KernelExecContext*) override;
 
+    int64_t GetMaxOutputBoxesPerClass(const KernelExecContext& ctx) const;
+    bool UseBitmask(const KernelExecContext& ctx) const;
+
 private:
     const ppl::nn::onnx::NonMaxSuppressionParam* param_ = nullptr;
 };
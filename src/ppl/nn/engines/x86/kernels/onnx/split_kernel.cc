@@ -17,6 +17,7 @@
 
 #include "ppl/nn/engines/x86/kernels/onnx/split_kernel.h"
 #include "ppl/nn/engines/x86/macros.h"
+#include "ppl/nn/engines/x86/utils.h"
 
 #include "ppl/kernel/x86/fp32/split.h"
 #include "ppl/kernel/x86/int64/split.h"
@@ -24,6 +25,58 @@
 
 namespace ppl { namespace nn { namespace x86 {
 
+ppl::common::RetCode SplitKernel::DoInplaceExecute(KernelExecContext* ctx, bool* done) {
+    *done = false;
+
+    // the buffer of the input is taken over and released after all outputs are freed
+    auto input = ctx->GetInput<TensorImpl>(0);
+    auto device = GetX86Device();
+    if (input->GetType() != TENSORTYPE_NORMAL || !input->IsBufferOwner() || input->GetDevice() != device ||
+        !ctx->IsLastConsumerOfInput(0)) {
+        return ppl::common::RC_SUCCESS;
+    }
+
+    const uint32_t output_count = ctx->GetOutputCount();
+    std::vector<const TensorShape*> dst_shape_list(output_count);
+    for (uint32_t i = 0; i < output_count; ++i) {
+        dst_shape_list[i] = ctx->GetOutput<TensorImpl>(i)->GetShape();
+        // views are identified by their addresses
+        if (dst_shape_list[i]->GetBytesIncludingPadding() == 0) {
+            return ppl::common::RC_SUCCESS;
+        }
+    }
+
+    auto input_shape = input->GetShape();
+    const int32_t real_axis = param_->axis < 0 ? param_->axis + input_shape->GetDimCount() : param_->axis;
+    if (!CalcContiguousSliceOffsets(*input_shape, dst_shape_list.data(), output_count, real_axis, 64,
+                                    &slice_offsets_)) {
+        return ppl::common::RC_SUCCESS;
+    }
+
+    std::vector<BufferDesc> views(output_count);
+    auto status = device->ShareBuffer(input->GetBufferDesc(), input_shape->GetBytesIncludingPadding(),
+                                      slice_offsets_.data(), output_count, views.data());
+    if (status == ppl::common::RC_UNSUPPORTED) {
+        return ppl::common::RC_SUCCESS;
+    }
+    if (status != ppl::common::RC_SUCCESS) {
+        LOG(ERROR) << "ShareBuffer for tensor[" << input->GetName()
+                   << "] failed: " << ppl::common::GetRetCodeStr(status);
+        return status;
+    }
+    input->DetachBuffer();
+
+    for (uint32_t i = 0; i < output_count; ++i) {
+        auto output = ctx->GetOutput<TensorImpl>(i);
+        output->SetBuffer(views[i], device, true);
+        PPLNN_X86_DEBUG_TRACE("Output [outputs[%u]]:\n", i);
+        PPL_X86_TENSOR_PRINT_DEBUG_MSG(output);
+    }
+
+    *done = true;
+    return ppl::common::RC_SUCCESS;
+}
+
 ppl::common::RetCode SplitKernel::DoExecute(KernelExecContext* ctx) {
     PPLNN_X86_REQUIRED_INPUT(input, 0);
 
@@ -37,6 +90,14 @@ ppl::common::RetCode SplitKernel::DoExecute(KernelExecContext* ctx) {
     PPLNN_X86_DEBUG_TRACE("axis: %d\n", param_->axis);
     PPLNN_X86_DEBUG_TRACE("isa: %u\n", GetISA());
 
+    if (inplace_) {
+        bool done = false;
+        auto status = DoInplaceExecute(ctx, &done);
+        if (status != ppl::common::RC_SUCCESS || done) {
+            return status;
+        }
+    }
+
     for (uint32_t i = 0; i < ctx->GetOutputCount(); ++i) {
         auto output = ctx->GetOutput<TensorImpl>(i);
         PPLNN_X86_REALLOC_TENSOR_BUFFER(output);
@@ -31,11 +31,20 @@ public:
         param_ = p;
     }
 
+    /** @brief outputs are slices of the input if possible */
+    void SetInplace(bool inplace) {
+        inplace_ = inplace;
+    }
+
 private:
     ppl::common::RetCode DoExecute(KernelExecContext*) override;
+    /** @param done set to false if outputs cannot be slices of the input and should be computed normally */
+    ppl::common::RetCode DoInplaceExecute(KernelExecContext*, bool* done);
 
 private:
     const ppl::nn::onnx::SplitParam* param_ = nullptr;
+    bool inplace_ = false;
+    std::vector<uint64_t> slice_offsets_;
 };
 
 }}} // namespace ppl::nn::x86
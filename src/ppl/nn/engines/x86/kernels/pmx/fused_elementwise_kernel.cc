@@ -0,0 +1,115 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/nn/engines/x86/kernels/pmx/fused_elementwise_kernel.h"
+#include "ppl/nn/utils/destructor.h"
+#include "ppl/nn/common/logger.h"
+
+namespace ppl { namespace nn { namespace x86 {
+
+uint64_t FusedElementwiseKernel::CalcTmpBufferSize(const KernelExecContext& ctx) const {
+    return ppl::kernel::x86::fused_elementwise_fp32_get_buffer_bytes(insts_->data(), ctx.GetInputCount(),
+                                                                      insts_->size());
+}
+
+ppl::common::RetCode FusedElementwiseKernel::DoExecute(KernelExecContext* ctx) {
+    PPLNN_X86_REQUIRED_OUTPUT(output, 0);
+
+    PPLNN_X86_DEBUG_TRACE("Op: %s\n", GetName().c_str());
+
+    const uint32_t input_count = ctx->GetInputCount();
+    if (!src_is_scalar_) {
+        src_is_scalar_.reset(new bool[input_count]);
+    }
+    src_list_.resize(input_count);
+
+    // inputs are either of the same shape as the output or scalars
+    const uint64_t output_elems = output->GetShape()->GetElementsIncludingPadding();
+    const auto output_format = output->GetShape()->GetDataFormat();
+    for (uint32_t i = 0; i < input_count; ++i) {
+        auto input = ctx->GetInput<TensorImpl>(i);
+        PPLNN_X86_DEBUG_TRACE("Input [inputs[%u]]:\n", i);
+        PPL_X86_TENSOR_PRINT_DEBUG_MSG(input);
+
+        auto input_shape = input->GetShape();
+        if (input_shape->GetDataType() != ppl::common::DATATYPE_FLOAT32) {
+            LOG(ERROR) << "unsupported data type: " << ppl::common::GetDataTypeStr(input_shape->GetDataType()) << ".";
+            return ppl::common::RC_UNSUPPORTED;
+        }
+
+        const uint64_t input_elems = input_shape->GetElementsIncludingPadding();
+        if (input_elems == output_elems && input_shape->GetDataFormat() == output_format) {
+            src_is_scalar_[i] = false;
+        } else if (input_elems == 1) {
+            src_is_scalar_[i] = true;
+        } else {
+            LOG(ERROR) << "input[" << input->GetName() << "] of kernel[" << GetName()
+                       << "] is neither of the output's shape nor a scalar.";
+            return ppl::common::RC_UNSUPPORTED;
+        }
+        src_list_[i] = input->GetBufferPtr<float>();
+    }
+
+    PPLNN_X86_DEBUG_TRACE("instruction count: %lu\n", insts_->size());
+    PPLNN_X86_DEBUG_TRACE("isa: %u\n", GetISA());
+
+    BufferDesc tmp_buffer_desc;
+    auto tmp_buffer_size = GetTmpBufferSize(*ctx);
+    auto status = GetX86Device()->AllocTmpBuffer(tmp_buffer_size, &tmp_buffer_desc);
+    if (status != ppl::common::RC_SUCCESS) {
+        LOG(ERROR) << "alloc tmp buffer size[" << tmp_buffer_size << "] for kernel[" << GetName()
+                   << "] failed: " << ppl::common::GetRetCodeStr(status);
+        return status;
+    }
+    utils::Destructor __tmp_buffer_guard([this, &tmp_buffer_desc]() -> void {
+        GetX86Device()->FreeTmpBuffer(&tmp_buffer_desc);
+    });
+    auto tmp_buffer = tmp_buffer_desc.addr;
+    PPLNN_X86_DEBUG_TRACE("buffer: %p\n", tmp_buffer);
+
+    PPLNN_X86_REALLOC_TENSOR_BUFFER(output);
+    PPLNN_X86_DEBUG_TRACE("Output [output]:\n");
+    PPL_X86_TENSOR_PRINT_DEBUG_MSG(output);
+
+    const int64_t length = output_elems;
+    const int32_t num_src = input_count;
+    const int32_t num_insts = insts_->size();
+    if (false) {
+    }
+#ifdef PPL_USE_X86_AVX512
+    else if (MayUseISA(ppl::common::ISA_X86_AVX512)) {
+        return ppl::kernel::x86::fused_elementwise_fp32_avx512(length, src_list_.data(), src_is_scalar_.get(),
+                                                               num_src, insts_->data(), num_insts, tmp_buffer,
+                                                               output->GetBufferPtr<float>());
+    }
+#endif
+    else if (MayUseISA(ppl::common::ISA_X86_FMA)) {
+        return ppl::kernel::x86::fused_elementwise_fp32_fma(length, src_list_.data(), src_is_scalar_.get(), num_src,
+                                                            insts_->data(), num_insts, tmp_buffer,
+                                                            output->GetBufferPtr<float>());
+    } else if (MayUseISA(ppl::common::ISA_X86_SSE)) {
+        return ppl::kernel::x86::fused_elementwise_fp32_sse(length, src_list_.data(), src_is_scalar_.get(), num_src,
+                                                            insts_->data(), num_insts, tmp_buffer,
+                                                            output->GetBufferPtr<float>());
+    }
+
+    return ppl::kernel::x86::fused_elementwise_fp32(length, src_list_.data(), src_is_scalar_.get(), num_src,
+                                                    insts_->data(), num_insts, tmp_buffer,
+                                                    output->GetBufferPtr<float>());
+}
+
+}}} // namespace ppl::nn::x86
@@ -0,0 +1,48 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef _ST_HPC_PPL_NN_ENGINES_X86_KERNELS_PMX_FUSED_ELEMENTWISE_KERNEL_H_
+#define _ST_HPC_PPL_NN_ENGINES_X86_KERNELS_PMX_FUSED_ELEMENTWISE_KERNEL_H_
+
+#include "ppl/nn/engines/x86/kernel.h"
+#include "ppl/kernel/x86/fp32/fused_elementwise.h"
+#include <memory>
+
+namespace ppl { namespace nn { namespace x86 {
+
+class FusedElementwiseKernel : public X86Kernel {
+public:
+    FusedElementwiseKernel(const ir::Node* node) : X86Kernel(node) {}
+
+    /** @brief instructions of the expression. values [0, input count) are inputs of this kernel. */
+    void SetInstructions(const std::vector<ppl::kernel::x86::fused_elementwise_inst_t>* insts) {
+        insts_ = insts;
+    }
+
+private:
+    uint64_t CalcTmpBufferSize(const KernelExecContext& ctx) const override;
+    ppl::common::RetCode DoExecute(KernelExecContext*) override;
+
+private:
+    const std::vector<ppl::kernel::x86::fused_elementwise_inst_t>* insts_ = nullptr;
+    std::vector<const float*> src_list_;
+    std::unique_ptr<bool[]> src_is_scalar_;
+};
+
+}}} // namespace ppl::nn::x86
+
+#endif
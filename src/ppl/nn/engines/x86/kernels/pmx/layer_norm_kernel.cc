@@ -0,0 +1,87 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/nn/engines/x86/kernels/pmx/layer_norm_kernel.h"
+#include "ppl/nn/common/logger.h"
+
+#include "ppl/kernel/x86/fp32/layernorm.h"
+
+namespace ppl { namespace nn { namespace x86 {
+
+ppl::common::RetCode LayerNormKernel::DoExecute(KernelExecContext* ctx) {
+    PPLNN_X86_REQUIRED_INPUT(input, 0);
+    PPLNN_X86_OPTIONAL_INPUT(scale, 1);
+    PPLNN_X86_OPTIONAL_INPUT(shift, 2);
+    PPLNN_X86_REQUIRED_OUTPUT(output, 0);
+
+    PPLNN_X86_DEBUG_TRACE("Op: %s\n", GetName().c_str());
+
+    PPLNN_X86_DEBUG_TRACE("Input [input]:\n");
+    PPL_X86_TENSOR_PRINT_DEBUG_MSG(input);
+    if (scale) {
+        PPLNN_X86_DEBUG_TRACE("Input [scale]:\n");
+        PPL_X86_TENSOR_PRINT_DEBUG_MSG(scale);
+    }
+    if (shift) {
+        PPLNN_X86_DEBUG_TRACE("Input [shift]:\n");
+        PPL_X86_TENSOR_PRINT_DEBUG_MSG(shift);
+    }
+
+    PPLNN_X86_DEBUG_TRACE("axis: %d\n", param_->axis);
+    PPLNN_X86_DEBUG_TRACE("eps: %f\n", param_->eps);
+    PPLNN_X86_DEBUG_TRACE("isa: %u\n", GetISA());
+
+    PPLNN_X86_REALLOC_TENSOR_BUFFER(output);
+    PPLNN_X86_DEBUG_TRACE("Output [output]:\n");
+    PPL_X86_TENSOR_PRINT_DEBUG_MSG(output);
+
+    const ppl::common::datatype_t data_type = input->GetShape()->GetDataType();
+    const ppl::common::dataformat_t data_format = input->GetShape()->GetDataFormat();
+    if (data_type != ppl::common::DATATYPE_FLOAT32 || data_format != ppl::common::DATAFORMAT_NDARRAY) {
+        LOG(ERROR) << "unsupported data type " << ppl::common::GetDataTypeStr(data_type) << " or data format "
+                   << ppl::common::GetDataFormatStr(data_format) << ".";
+        return ppl::common::RC_UNSUPPORTED;
+    }
+
+    const float* scale_ptr = (param_->elementwise_affine && scale) ? scale->GetBufferPtr<float>() : nullptr;
+    const float* shift_ptr = (param_->elementwise_affine && shift) ? shift->GetBufferPtr<float>() : nullptr;
+
+    if (false) {
+    }
+#ifdef PPL_USE_X86_AVX512
+    else if (MayUseISA(ppl::common::ISA_X86_AVX512)) {
+        return ppl::kernel::x86::layernorm_ndarray_fp32_avx512(input->GetShape(), input->GetBufferPtr<float>(),
+                                                               scale_ptr, shift_ptr, param_->axis, param_->eps,
+                                                               output->GetBufferPtr<float>());
+    }
+#endif
+    else if (MayUseISA(ppl::common::ISA_X86_FMA)) {
+        return ppl::kernel::x86::layernorm_ndarray_fp32_fma(input->GetShape(), input->GetBufferPtr<float>(),
+                                                            scale_ptr, shift_ptr, param_->axis, param_->eps,
+                                                            output->GetBufferPtr<float>());
+    } else if (MayUseISA(ppl::common::ISA_X86_SSE)) {
+        return ppl::kernel::x86::layernorm_ndarray_fp32_sse(input->GetShape(), input->GetBufferPtr<float>(),
+                                                            scale_ptr, shift_ptr, param_->axis, param_->eps,
+                                                            output->GetBufferPtr<float>());
+    }
+
+    return ppl::kernel::x86::layernorm_ndarray_fp32(input->GetShape(), input->GetBufferPtr<float>(), scale_ptr,
+                                                    shift_ptr, param_->axis, param_->eps,
+                                                    output->GetBufferPtr<float>());
+}
+
+}}} // namespace ppl::nn::x86
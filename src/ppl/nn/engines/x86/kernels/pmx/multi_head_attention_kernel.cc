@@ -0,0 +1,139 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/nn/engines/x86/kernels/pmx/multi_head_attention_kernel.h"
+#include "ppl/nn/engines/x86/utils.h"
+#include "ppl/nn/utils/destructor.h"
+#include "ppl/nn/common/logger.h"
+
+#include "ppl/kernel/x86/fp32/multi_head_attention.h"
+
+namespace ppl { namespace nn { namespace x86 {
+
+uint64_t MultiHeadAttentionKernel::CalcTmpBufferSize(const KernelExecContext& ctx) const {
+    auto q_shape = ctx.GetInput<TensorImpl>(0)->GetShape();
+    auto kv_shape = ctx.GetInput<TensorImpl>(1)->GetShape();
+    const int64_t hidden = q_shape->GetDim(2);
+    return ppl::kernel::x86::multi_head_attention_fp32_get_buffer_bytes(
+        q_shape->GetDim(0), kv_shape->GetDim(1), param_->num_heads, hidden / param_->num_heads);
+}
+
+ppl::common::RetCode MultiHeadAttentionKernel::DoExecute(KernelExecContext* ctx) {
+    PPLNN_X86_REQUIRED_INPUT(query, 0);
+    PPLNN_X86_REQUIRED_INPUT(key, 1);
+    PPLNN_X86_REQUIRED_INPUT(value, 2);
+    PPLNN_X86_OPTIONAL_INPUT(mask, 3);
+    PPLNN_X86_REQUIRED_OUTPUT(output, 0);
+
+    PPLNN_X86_DEBUG_TRACE("Op: %s\n", GetName().c_str());
+
+    PPLNN_X86_DEBUG_TRACE("Input [query]:\n");
+    PPL_X86_TENSOR_PRINT_DEBUG_MSG(query);
+    PPLNN_X86_DEBUG_TRACE("Input [key]:\n");
+    PPL_X86_TENSOR_PRINT_DEBUG_MSG(key);
+    PPLNN_X86_DEBUG_TRACE("Input [value]:\n");
+    PPL_X86_TENSOR_PRINT_DEBUG_MSG(value);
+    if (mask) {
+        PPLNN_X86_DEBUG_TRACE("Input [mask]:\n");
+        PPL_X86_TENSOR_PRINT_DEBUG_MSG(mask);
+    }
+
+    PPLNN_X86_DEBUG_TRACE("num_heads: %d\n", param_->num_heads);
+    PPLNN_X86_DEBUG_TRACE("scale: %f\n", param_->scale);
+    PPLNN_X86_DEBUG_TRACE("isa: %u\n", GetISA());
+
+    auto q_shape = query->GetShape();
+    auto kv_shape = key->GetShape();
+    if (q_shape->GetDataType() != ppl::common::DATATYPE_FLOAT32 ||
+        q_shape->GetDataFormat() != ppl::common::DATAFORMAT_NDARRAY) {
+        LOG(ERROR) << "only support fp32 ndarray now.";
+        return ppl::common::RC_UNSUPPORTED;
+    }
+
+    const int64_t batch = q_shape->GetDim(0);
+    const int64_t seqlen_q = q_shape->GetDim(1);
+    const int64_t hidden = q_shape->GetDim(2);
+    const int64_t seqlen_kv = kv_shape->GetDim(1);
+    const int64_t num_heads = param_->num_heads;
+    if (hidden % num_heads != 0 || kv_shape->GetDim(0) != batch || kv_shape->GetDim(2) != hidden ||
+        !TensorShapeEqual(*value->GetShape(), *kv_shape)) {
+        LOG(ERROR) << "invalid shapes of query/key/value of kernel[" << GetName() << "].";
+        return ppl::common::RC_INVALID_VALUE;
+    }
+
+    // only masks of keys are supported: [batch, 1, 1, seqlen_kv] or [1, 1, 1, seqlen_kv]
+    const float* mask_ptr = nullptr;
+    int64_t mask_batch_stride = 0;
+    if (mask) {
+        const uint64_t mask_elems = mask->GetShape()->GetElementsExcludingPadding();
+        if (mask_elems == (uint64_t)(batch * seqlen_kv)) {
+            mask_batch_stride = seqlen_kv;
+        } else if (mask_elems != (uint64_t)seqlen_kv) {
+            LOG(ERROR) << "unsupported mask shape of kernel[" << GetName() << "].";
+            return ppl::common::RC_UNSUPPORTED;
+        }
+        mask_ptr = mask->GetBufferPtr<float>();
+    }
+
+    BufferDesc tmp_buffer_desc;
+    auto tmp_buffer_size = GetTmpBufferSize(*ctx);
+    auto status = GetX86Device()->AllocTmpBuffer(tmp_buffer_size, &tmp_buffer_desc);
+    if (status != ppl::common::RC_SUCCESS) {
+        LOG(ERROR) << "alloc tmp buffer size[" << tmp_buffer_size << "] for kernel[" << GetName()
+                   << "] failed: " << ppl::common::GetRetCodeStr(status);
+        return status;
+    }
+    utils::Destructor __tmp_buffer_guard([this, &tmp_buffer_desc]() -> void {
+        GetX86Device()->FreeTmpBuffer(&tmp_buffer_desc);
+    });
+    auto tmp_buffer = tmp_buffer_desc.addr;
+    PPLNN_X86_DEBUG_TRACE("buffer: %p\n", tmp_buffer);
+
+    PPLNN_X86_REALLOC_TENSOR_BUFFER(output);
+    PPLNN_X86_DEBUG_TRACE("Output [output]:\n");
+    PPL_X86_TENSOR_PRINT_DEBUG_MSG(output);
+
+    const int64_t head_dim = hidden / num_heads;
+    if (false) {
+    }
+#ifdef PPL_USE_X86_AVX512
+    else if (MayUseISA(ppl::common::ISA_X86_AVX512)) {
+        return ppl::kernel::x86::multi_head_attention_fp32_avx512(
+            query->GetBufferPtr<float>(), key->GetBufferPtr<float>(), value->GetBufferPtr<float>(), mask_ptr, batch,
+            seqlen_q, seqlen_kv, num_heads, head_dim, mask_batch_stride, param_->scale, tmp_buffer,
+            output->GetBufferPtr<float>());
+    }
+#endif
+    else if (MayUseISA(ppl::common::ISA_X86_FMA)) {
+        return ppl::kernel::x86::multi_head_attention_fp32_fma(
+            query->GetBufferPtr<float>(), key->GetBufferPtr<float>(), value->GetBufferPtr<float>(), mask_ptr, batch,
+            seqlen_q, seqlen_kv, num_heads, head_dim, mask_batch_stride, param_->scale, tmp_buffer,
+            output->GetBufferPtr<float>());
+    } else if (MayUseISA(ppl::common::ISA_X86_SSE)) {
+        return ppl::kernel::x86::multi_head_attention_fp32_sse(
+            query->GetBufferPtr<float>(), key->GetBufferPtr<float>(), value->GetBufferPtr<float>(), mask_ptr, batch,
+            seqlen_q, seqlen_kv, num_heads, head_dim, mask_batch_stride, param_->scale, tmp_buffer,
+            output->GetBufferPtr<float>());
+    }
+
+    return ppl::kernel::x86::multi_head_attention_fp32(
+        query->GetBufferPtr<float>(), key->GetBufferPtr<float>(), value->GetBufferPtr<float>(), mask_ptr, batch,
+        seqlen_q, seqlen_kv, num_heads, head_dim, mask_batch_stride, param_->scale, tmp_buffer,
+        output->GetBufferPtr<float>());
+}
+
+}}} // namespace ppl::nn::x86
@@ -15,6 +15,8 @@
 // specific language governing permissions and limitations
 // under the License.
 
+#include <cstring> // memcpy
+
 #include "ppl/nn/engines/x86/kernels/pmx/reorder_kernel.h"
 #include "ppl/nn/common/logger.h"
 
@@ -40,6 +42,19 @@ ppl::common::RetCode ReorderKernel::DoExecute(KernelExecContext* ctx) {
 
     const bool may_inplace = ctx->IsLastConsumerOfInput(0) && input->GetType() == TENSORTYPE_NORMAL;
 
+    if (input_format == output_format) {
+        // input is already in the target format, e.g. filled by `Tensor::ConvertFromHostImage()`
+        if (may_inplace) {
+            output->TransferBufferFrom(input);
+        } else {
+            PPLNN_X86_REALLOC_TENSOR_BUFFER(output);
+            memcpy(output->GetBufferPtr(), input->GetBufferPtr(), input->GetShape()->GetBytesIncludingPadding());
+        }
+        PPLNN_X86_DEBUG_TRACE("Output [output]:\n");
+        PPL_X86_TENSOR_PRINT_DEBUG_MSG(output);
+        return ppl::common::RC_SUCCESS;
+    }
+
     if (ppl::common::GetSizeOfDataType(data_type) == 4) {
         if (input_format == ppl::common::DATAFORMAT_NDARRAY && output_format == ppl::common::DATAFORMAT_N16CX) {
             const TensorShape padded_input_shape = PadShapeTo3Dims(*input->GetShape());
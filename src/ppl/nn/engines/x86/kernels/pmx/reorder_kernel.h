@@ -42,6 +42,12 @@ class ReorderKernel : public X86Kernel {
 public:
     ReorderKernel(const ir::Node* node) : X86Kernel(node) {}
 
+    // a reorder converts its input to the format that the next kernel works on
+    ppl::common::dataformat_t GetPreferredInputDataFormat(uint32_t) const override {
+        auto param = GetCommonParam();
+        return param ? param->output_formats[0] : ppl::common::DATAFORMAT_UNKNOWN;
+    }
+
 private:
     ppl::common::RetCode DoExecute(KernelExecContext*) override;
 };
@@ -61,7 +61,11 @@ RetCode ConcatOp::SelectFormat(const InputOutputInfo& info, vector<dataformat_t>
 }
 
 KernelImpl* ConcatOp::CreateKernelImpl() const {
-    return CreateKernelImplWithParam<ConcatKernel>(param_.get());
+    auto kernel = CreateKernelImplWithParam<ConcatKernel>(param_.get());
+    if (kernel) {
+        kernel->SetInplace(inplace_);
+    }
+    return kernel;
 }
 
 }}} // namespace ppl::nn::x86
@@ -18,11 +18,22 @@
 #include "ppl/nn/engines/x86/optimizer/ops/onnx/conv_op.h"
 #include "ppl/nn/engines/x86/kernels/onnx/conv2d_dynamic_kernel.h"
 #include "ppl/nn/engines/x86/kernels/onnx/conv2d_kernel.h"
+#include "ppl/nn/engines/x86/kernels/onnx/conv2d_int8_kernel.h"
+#include "ppl/nn/engines/x86/kernels/onnx/conv2d_bf16_kernel.h"
+#include "ppl/nn/engines/x86/optimizer/quant_utils.h"
+#include "ppl/nn/engines/x86/algo_tuning_cache.h"
 #include "ppl/nn/oputils/onnx/reshape_conv.h"
+#include "ppl/nn/utils/destructor.h"
 #include "ppl/nn/common/logger.h"
 
 #include "ppl/kernel/x86/common/threading_tools.h"
 
+#include <chrono>
+
+#ifdef PPLNN_ENABLE_PMX_MODEL
+#include "ppl/nn/engines/x86/pmx/kernel_param_serializer.h"
+#endif
+
 using namespace std;
 using namespace ppl::common;
 
@@ -38,6 +49,186 @@ ConvOp::~ConvOp() {
         }
         delete conv2d_param_;
     }
+    if (conv2d_int8_param_ != nullptr) {
+        delete conv2d_int8_param_;
+    }
+    if (conv2d_bf16_param_ != nullptr) {
+        delete conv2d_bf16_param_;
+    }
+}
+
+// decides whether winograd b4f3 should fallback to direct at runtime
+static bool InferWinogradFallback(const TensorImpl* X, const TensorImpl* Y,
+                                  const ppl::kernel::x86::conv2d_fp32_param* param) {
+    const int64_t dst_h = Y->GetShape()->GetDim(2);
+    const int64_t dst_w = Y->GetShape()->GetDim(3);
+    const int64_t batch = X->GetShape()->GetDim(0);
+    const int64_t num_tiles = batch * ((dst_h + 3) / 4) * ((dst_w + 3) / 4);
+    const bool align_tiles = (dst_h % 4 == 0) && (dst_w % 4) == 0;
+
+    const int64_t num_threads = ppl::kernel::x86::get_omp_max_threads();
+    if (num_threads > 4) { // Maybe memory bound. Just maybe.
+        if (param->group > 4) {
+            if (param->channels / param->group <= 2 * 1.801f * 16) { // Multigroup need more channels
+                return true;
+            }
+        }
+        if (param->group / num_threads > 1 && num_threads / batch <= 4) { // Many group but small batch
+            return true;
+        }
+    }
+    return num_tiles < (align_tiles ? 10 : 12);
+}
+
+/*
+  runs `algo_info` with zero-filled input and returns the best time in microseconds of several runs.
+  returns a negative value if `algo_info` cannot be executed.
+*/
+static double ProfileConv2dAlgo(const ppl::kernel::x86::conv2d_fp32_param& param,
+                                const ppl::kernel::x86::conv2d_fp32_algo_info& algo_info, const TensorShape& src_shape,
+                                const float* weight_data, const float* bias_data, Allocator* allocator) {
+    static const uint32_t max_runs = 5;
+    static const double max_total_us = 100000.0;
+
+    unique_ptr<ppl::kernel::x86::conv2d_fp32_manager> mgr(
+        ppl::kernel::x86::conv2d_algo_selector::gen_algo(param, algo_info, allocator));
+    if (!mgr || mgr->gen_cvt_weights(weight_data, bias_data) != RC_SUCCESS) {
+        return -1.0;
+    }
+    utils::Destructor __mgr_guard([&mgr]() -> void {
+        mgr->release_cvt_weights();
+    });
+
+    unique_ptr<ppl::kernel::x86::conv2d_fp32_executor> executor(mgr->gen_executor());
+    if (!executor) {
+        return -1.0;
+    }
+
+    TensorShape src = src_shape;
+    src.SetDataType(DATATYPE_FLOAT32);
+    src.SetDataFormat(algo_info.input_format);
+
+    const int64_t src_h = src_shape.GetDim(2);
+    const int64_t src_w = src_shape.GetDim(3);
+    const int64_t dst_dims[] = {
+        src_shape.GetDim(0), param.num_output,
+        (src_h + 2 * param.pad_h - (param.dilation_h * (param.kernel_h - 1) + 1)) / param.stride_h + 1,
+        (src_w + 2 * param.pad_w - (param.dilation_w * (param.kernel_w - 1) + 1)) / param.stride_w + 1};
+    TensorShape dst;
+    dst.SetDataType(DATATYPE_FLOAT32);
+    dst.SetDataFormat(algo_info.output_format);
+    dst.Reshape(dst_dims, 4);
+
+    executor->set_src_shape(&src);
+    executor->set_dst_shape(&dst);
+    if (executor->prepare() != RC_SUCCESS) {
+        return -1.0;
+    }
+
+    const uint64_t src_bytes = src.GetBytesIncludingPadding();
+    const uint64_t dst_bytes = dst.GetBytesIncludingPadding();
+    const uint64_t tmp_bytes = executor->cal_temp_buffer_size();
+    void* src_buf = allocator->Alloc(src_bytes);
+    void* dst_buf = allocator->Alloc(dst_bytes);
+    void* tmp_buf = (tmp_bytes > 0) ? allocator->Alloc(tmp_bytes) : nullptr;
+    utils::Destructor __buffer_guard([allocator, src_buf, dst_buf, tmp_buf]() -> void {
+        allocator->Free(src_buf);
+        allocator->Free(dst_buf);
+        if (tmp_buf) {
+            allocator->Free(tmp_buf);
+        }
+    });
+    if (!src_buf || !dst_buf || (tmp_bytes > 0 && !tmp_buf)) {
+        return -1.0;
+    }
+    memset(src_buf, 0, src_bytes);
+
+    executor->set_src((const float*)src_buf);
+    executor->set_dst((float*)dst_buf);
+    executor->set_temp_buffer(tmp_buf);
+
+    // warm up
+    if (executor->execute() != RC_SUCCESS) {
+        return -1.0;
+    }
+
+    double best_us = -1.0, total_us = 0.0;
+    for (uint32_t i = 0; i < max_runs && total_us < max_total_us; ++i) {
+        auto begin_ts = std::chrono::high_resolution_clock::now();
+        executor->execute();
+        auto end_ts = std::chrono::high_resolution_clock::now();
+        double us = std::chrono::duration_cast<std::chrono::nanoseconds>(end_ts - begin_ts).count() / 1000.0;
+        if (best_us < 0 || us < best_us) {
+            best_us = us;
+        }
+        total_us += us;
+    }
+
+    return best_us;
+}
+
+/*
+  algorithms found in `options.algo_cache`(imported or tuned before) are preferred. otherwise all supported
+  algorithms are benchmarked if tuning is enabled and the input shape is fixed. `is_tuned` is set to true
+  if the result does not come from heuristics.
+*/
+static ppl::kernel::x86::conv2d_fp32_algo_info SelectConv2dAlgo(const TensorShape& src_shape,
+                                                                const ppl::kernel::x86::conv2d_fp32_param& param,
+                                                                const float* weight_data, const float* bias_data,
+                                                                const OptKernelOptions& options, bool* is_tuned) {
+    auto isa = options.device->GetISA();
+    auto default_info =
+        ppl::kernel::x86::conv2d_algo_selector::select_algo(src_shape.GetDataFormat(), param, isa);
+
+    *is_tuned = false;
+    if (!options.algo_cache || src_shape.GetDimCount() != 4 ||
+        default_info.algo_type == ppl::kernel::x86::conv2d_fp32_algo::UNKNOWN) {
+        return default_info;
+    }
+    for (uint32_t i = 0; i < src_shape.GetDimCount(); ++i) {
+        if (src_shape.GetDim(i) <= 0) {
+            return default_info;
+        }
+    }
+
+    uint32_t num_threads = options.device->GetOmpThreadsPerKernel();
+    if (num_threads == 0) {
+        num_threads = ppl::kernel::x86::get_omp_max_threads();
+    }
+    auto key = AlgoTuningCache::GenConv2dKey(isa, param, src_shape, num_threads);
+
+    ppl::kernel::x86::conv2d_fp32_algo_info cached_info;
+    if (options.algo_cache->FindConv2dAlgo(key, &cached_info)) {
+        unique_ptr<ppl::kernel::x86::conv2d_fp32_manager> mgr(
+            ppl::kernel::x86::conv2d_algo_selector::gen_algo(param, cached_info, nullptr));
+        if ((cached_info.isa & isa) == cached_info.isa && mgr && mgr->is_supported()) {
+            *is_tuned = true;
+            return cached_info;
+        }
+        LOG(WARNING) << "cached algorithm[" << cached_info.algo_type << "] of [" << key
+                     << "] is not supported. ignored.";
+    }
+
+    if (!options.engine_options || options.engine_options->dynamic_tuning_level == TUNING_OFF) {
+        return default_info;
+    }
+
+    auto candidates = ppl::kernel::x86::conv2d_algo_selector::get_supported_algos(src_shape.GetDataFormat(), param, isa);
+
+    auto best_info = default_info;
+    double best_us = -1.0;
+    for (auto c = candidates.begin(); c != candidates.end(); ++c) {
+        auto us = ProfileConv2dAlgo(param, *c, src_shape, weight_data, bias_data, options.device->GetAllocator());
+        LOG(DEBUG) << "conv2d [" << key << "] algo[" << c->algo_type << "] isa[" << c->isa << "]: " << us << " us";
+        if (us >= 0 && (best_us < 0 || us < best_us)) {
+            best_us = us;
+            best_info = *c;
+        }
+    }
+
+    options.algo_cache->InsertConv2dAlgo(key, best_info);
+    *is_tuned = true;
+    return best_info;
 }
 
 RetCode ConvOp::Init(const OptKernelOptions& options) {
@@ -49,10 +240,18 @@ RetCode ConvOp::Init(const OptKernelOptions& options) {
 
     auto node = GetNode();
     auto graph_data = options.graph_data;
-    const ir::Shape& weight_shape = graph_data->shapes.find(node->GetInput(1))->second;
 
-    const int64_t kernel_dims =
-        param_->kernel_shape.size() == 0 ? (weight_shape.dims.size() - 2) : param_->kernel_shape.size();
+    // shapes are not available when loading from a pmx model, in which case `kernel_shape` is always set
+    int64_t kernel_dims = param_->kernel_shape.size();
+    if (kernel_dims == 0) {
+        auto weight_shape_ref = graph_data->shapes.find(node->GetInput(1));
+        if (weight_shape_ref == graph_data->shapes.end()) {
+            LOG(ERROR) << "cannot find shape of weight[" << node->GetInput(1) << "] of conv[" << node->GetName()
+                       << "]";
+            return RC_NOT_FOUND;
+        }
+        kernel_dims = weight_shape_ref->second.dims.size() - 2;
+    }
 
     if (kernel_dims != 2) {
         LOG(ERROR) << "Only support Conv2d currently. Get unsupported kernel_dims=" << kernel_dims << ", which is Conv("
@@ -64,11 +263,155 @@ RetCode ConvOp::Init(const OptKernelOptions& options) {
         return onnx::ReshapeConv(info, param_.get());
     };
 
-    infer_type_func_ = GenericInferType;
+    infer_type_func_ = [this](InputOutputInfo* info) -> void {
+        if (conv2d_int8_param_) {
+            info->GetOutput<TensorImpl>(0)->GetShape()->SetDataType(conv2d_int8_param_->output_type);
+        } else if (conv2d_bf16_param_) {
+            info->GetOutput<TensorImpl>(0)->GetShape()->SetDataType(conv2d_bf16_param_->output_type);
+        } else {
+            GenericInferType(info);
+        }
+    };
 
     return RC_SUCCESS;
 }
 
+/*
+  convs whose input has per-tensor quantization info run in int8 with weights quantized per output channel.
+  depthwise convs are memory bound and are left in float32.
+*/
+bool ConvOp::TrySelectInt8Algorithm(const OptKernelOptions& options, const float* weight_data, const float* bias_data,
+                                    int64_t num_output, int64_t channels) {
+    auto node = GetNode();
+    if (!options.quant_info || !IsNodeQuantEnabled(options.quant_info, node->GetName())) {
+        return false;
+    }
+
+    QuantizeParam src_quant;
+    auto input_edge = options.graph_topo->GetEdge(node->GetInput(0));
+    if (!FindTensorQuantParam(options.quant_info, input_edge->GetName(), &src_quant)) {
+        return false;
+    }
+
+    if (param_->group > 1 && param_->group == channels && param_->group == num_output) {
+        return false;
+    }
+
+    unique_ptr<Conv2dInt8Param> int8_param(new Conv2dInt8Param);
+    if (!int8_param) {
+        return false;
+    }
+
+    ppl::kernel::x86::conv2d_int8_param& param = int8_param->param;
+    param.kernel_h = param_->kernel_shape[0];
+    param.kernel_w = param_->kernel_shape[1];
+    param.stride_h = param_->strides[0];
+    param.stride_w = param_->strides[1];
+    param.pad_h = param_->pads[0];
+    param.pad_w = param_->pads[1];
+    param.dilation_h = param_->dilations[0];
+    param.dilation_w = param_->dilations[1];
+    param.group = param_->group;
+    param.channels = channels;
+    param.num_output = num_output;
+    param.post = ppl::kernel::x86::gemm_post::NONE;
+
+    auto isa = options.device->GetISA();
+    vector<float> weight_scale(num_output);
+    int8_param->packed_weight.resize(ppl::kernel::x86::conv2d_int8_get_packed_weight_bytes(param));
+    int8_param->weight_sum.resize(num_output);
+    auto status = ppl::kernel::x86::conv2d_int8_quantize_pack_weight(
+        isa, param, weight_data, int8_param->packed_weight.data(), weight_scale.data(), int8_param->weight_sum.data());
+    if (status != RC_SUCCESS) {
+        LOG(WARNING) << "quantize weight of conv[" << node->GetName() << "] failed: " << GetRetCodeStr(status)
+                     << ", fallback to float32.";
+        return false;
+    }
+
+    int8_param->scale.resize(num_output);
+    for (int64_t i = 0; i < num_output; ++i) {
+        int8_param->scale[i] = weight_scale[i] * src_quant.scale;
+    }
+    if (bias_data) {
+        int8_param->bias.assign(bias_data, bias_data + num_output);
+    }
+    int8_param->weight_max_value = ppl::kernel::x86::gemm_s8u8_get_a_max_value(isa);
+    int8_param->src_quant = src_quant;
+
+    if (conv2d_int8_param_) {
+        delete conv2d_int8_param_;
+    }
+    conv2d_int8_param_ = int8_param.release();
+
+    LOG(DEBUG) << "conv[" << node->GetName() << "] runs in int8, src scale[" << src_quant.scale << "] zero_point["
+               << src_quant.zero_point << "]";
+    return true;
+}
+
+/*
+  convs run in bfloat16 with float32 accumulation if it is enabled by `forward_precision`. depthwise convs are
+  memory bound and are left in float32.
+*/
+bool ConvOp::TrySelectBf16Algorithm(const OptKernelOptions& options, const float* weight_data, const float* bias_data,
+                                    int64_t num_output, int64_t channels) {
+    if (!IsBf16Enabled(options)) {
+        return false;
+    }
+
+    if (param_->group > 1 && param_->group == channels && param_->group == num_output) {
+        return false;
+    }
+
+    unique_ptr<Conv2dBf16Param> bf16_param(new Conv2dBf16Param);
+    if (!bf16_param) {
+        return false;
+    }
+
+    ppl::kernel::x86::conv2d_bf16_param& param = bf16_param->param;
+    param.kernel_h = param_->kernel_shape[0];
+    param.kernel_w = param_->kernel_shape[1];
+    param.stride_h = param_->strides[0];
+    param.stride_w = param_->strides[1];
+    param.pad_h = param_->pads[0];
+    param.pad_w = param_->pads[1];
+    param.dilation_h = param_->dilations[0];
+    param.dilation_w = param_->dilations[1];
+    param.group = param_->group;
+    param.channels = channels;
+    param.num_output = num_output;
+    param.post = ppl::kernel::x86::gemm_post::NONE;
+
+    // activations stay in n16cx like float32 convs, group convs fall back to im2col + gemm in ndarray
+    RetCode status;
+    if (ppl::kernel::x86::conv2d_n16cx_bf16_is_supported(param)) {
+        bf16_param->data_format = DATAFORMAT_N16CX;
+        bf16_param->packed_weight.resize(ppl::kernel::x86::conv2d_n16cx_bf16_get_packed_weight_bytes(param) /
+                                         sizeof(uint16_t));
+        status = ppl::kernel::x86::conv2d_n16cx_bf16_pack_weight(param, weight_data, bf16_param->packed_weight.data());
+    } else {
+        bf16_param->data_format = DATAFORMAT_NDARRAY;
+        bf16_param->packed_weight.resize(ppl::kernel::x86::conv2d_bf16_get_packed_weight_bytes(param) /
+                                         sizeof(uint16_t));
+        status = ppl::kernel::x86::conv2d_bf16_pack_weight(param, weight_data, bf16_param->packed_weight.data());
+    }
+    if (status != RC_SUCCESS) {
+        LOG(WARNING) << "pack weight of conv[" << GetNode()->GetName() << "] failed: " << GetRetCodeStr(status)
+                     << ", fallback to float32.";
+        return false;
+    }
+    if (bias_data) {
+        bf16_param->bias.assign(bias_data, bias_data + num_output);
+    }
+
+    if (conv2d_bf16_param_) {
+        delete conv2d_bf16_param_;
+    }
+    conv2d_bf16_param_ = bf16_param.release();
+
+    LOG(DEBUG) << "conv[" << GetNode()->GetName() << "] runs in bfloat16";
+    return true;
+}
+
 ppl::common::RetCode ConvOp::SelectAlgorithm(const InputOutputInfo& info, const OptKernelOptions& options) {
     auto node = GetNode();
     auto graph_data = options.graph_data;
@@ -108,6 +451,16 @@ ppl::common::RetCode ConvOp::SelectAlgorithm(const InputOutputInfo& info, const
     }
 
     if (kernel_dims == 2) {
+        const int32_t num_output = weight_shape.dims[0];
+        const int32_t channels = weight_shape.dims[1] * param_->group;
+
+        if (TrySelectInt8Algorithm(options, weight_data, bias_data, num_output, channels)) {
+            return RC_SUCCESS;
+        }
+        if (TrySelectBf16Algorithm(options, weight_data, bias_data, num_output, channels)) {
+            return RC_SUCCESS;
+        }
+
         if (!conv2d_param_) {
             conv2d_param_ = new Conv2dParam;
         }
@@ -115,9 +468,6 @@ ppl::common::RetCode ConvOp::SelectAlgorithm(const InputOutputInfo& info, const
             return ppl::common::RC_OUT_OF_MEMORY;
         }
 
-        const int32_t num_output = weight_shape.dims[0];
-        const int32_t channels = weight_shape.dims[1] * param_->group;
-
         ppl::kernel::x86::conv2d_fp32_param& conv2d_param = conv2d_param_->param;
         conv2d_param.kernel_h = conv_param.kernel_shape[0];
         conv2d_param.kernel_w = conv_param.kernel_shape[1];
@@ -132,8 +482,15 @@ ppl::common::RetCode ConvOp::SelectAlgorithm(const InputOutputInfo& info, const
         conv2d_param.channels = channels;
         conv2d_param.fuse_flag = 0;
 
-        conv2d_param_->algo_info = ppl::kernel::x86::conv2d_algo_selector::select_algo(
-            info.GetInput<TensorImpl>(0)->GetShape()->GetDataFormat(), conv2d_param_->param, options.device->GetISA());
+        std::vector<float> zero_bias;
+        if (!bias_data) {
+            zero_bias.resize(num_output, 0.0f);
+        }
+
+        bool is_tuned = false;
+        conv2d_param_->algo_info =
+            SelectConv2dAlgo(*info.GetInput<TensorImpl>(0)->GetShape(), conv2d_param_->param, weight_data,
+                             bias_data ? bias_data : zero_bias.data(), options, &is_tuned);
 
         if (conv2d_param_->algo_info.algo_type == ppl::kernel::x86::conv2d_fp32_algo::UNKNOWN) {
             LOG(INFO) << "Conv select algorithm failed, use fallback kernel";
@@ -141,32 +498,13 @@ ppl::common::RetCode ConvOp::SelectAlgorithm(const InputOutputInfo& info, const
             conv2d_param_->mgr = ppl::kernel::x86::conv2d_algo_selector::gen_algo(
                 conv2d_param_->param, conv2d_param_->algo_info, options.device->GetAllocator());
 
-            // winograd b4f3 avx512 may fallback to direct
-            if (conv2d_param_->algo_info.algo_type == ppl::kernel::x86::conv2d_fp32_algo::WINOGRAD_B4F3) {
+            // winograd b4f3 avx512 may fallback to direct. tuned results are measured with the real shape.
+            if (!is_tuned &&
+                conv2d_param_->algo_info.algo_type == ppl::kernel::x86::conv2d_fp32_algo::WINOGRAD_B4F3) {
                 conv2d_param_->algo_info.algo_type = ppl::kernel::x86::conv2d_fp32_algo::DIRECT;
                 conv2d_param_->fallback_mgr = ppl::kernel::x86::conv2d_algo_selector::gen_algo(
                     conv2d_param_->param, conv2d_param_->algo_info, options.device->GetAllocator());
-                conv2d_param_->infer_fallback_func = [](const TensorImpl* X, const TensorImpl* Y,
-                                                        const ppl::kernel::x86::conv2d_fp32_param* param) -> bool {
-                    const int64_t dst_h = Y->GetShape()->GetDim(2);
-                    const int64_t dst_w = Y->GetShape()->GetDim(3);
-                    const int64_t batch = X->GetShape()->GetDim(0);
-                    const int64_t num_tiles = batch * ((dst_h + 3) / 4) * ((dst_w + 3) / 4);
-                    const bool align_tiles = (dst_h % 4 == 0) && (dst_w % 4) == 0;
-
-                    const int64_t num_threads = ppl::kernel::x86::get_omp_max_threads();
-                    if (num_threads > 4) { // Maybe memory bound. Just maybe.
-                        if (param->group > 4) {
-                            if (param->channels / param->group <= 2 * 1.801f * 16) { // Multigroup need more channels
-                                return true;
-                            }
-                        }
-                        if (param->group / num_threads > 1 && num_threads / batch <= 4) { // Many group but small batch
-                            return true;
-                        }
-                    }
-                    return num_tiles < (align_tiles ? 10 : 12);
-                };
+                conv2d_param_->infer_fallback_func = InferWinogradFallback;
                 conv2d_param_->algo_info.algo_type = ppl::kernel::x86::conv2d_fp32_algo::WINOGRAD_B4F3;
             }
 
@@ -176,7 +514,6 @@ ppl::common::RetCode ConvOp::SelectAlgorithm(const InputOutputInfo& info, const
                     conv2d_param_->fallback_mgr->gen_cvt_weights(weight_data, bias_data);
                 }
             } else {
-                std::vector<float> zero_bias(conv2d_param.num_output, 0.0f);
                 conv2d_param_->mgr->gen_cvt_weights(weight_data, zero_bias.data());
                 if (conv2d_param_->fallback_mgr) {
                     conv2d_param_->fallback_mgr->gen_cvt_weights(weight_data, zero_bias.data());
@@ -193,6 +530,16 @@ ppl::common::RetCode ConvOp::SelectAlgorithm(const InputOutputInfo& info, const
 
 RetCode ConvOp::SelectFormat(const InputOutputInfo& info, vector<dataformat_t>* selected_input_formats,
                              vector<dataformat_t>* selected_output_formats) {
+    if (conv2d_int8_param_) {
+        selected_input_formats->at(0) = DATAFORMAT_NDARRAY;
+        selected_output_formats->at(0) = DATAFORMAT_NDARRAY;
+        return RC_SUCCESS;
+    }
+    if (conv2d_bf16_param_) {
+        selected_input_formats->at(0) = conv2d_bf16_param_->data_format;
+        selected_output_formats->at(0) = conv2d_bf16_param_->data_format;
+        return RC_SUCCESS;
+    }
     if (conv2d_param_ && conv2d_param_->algo_info.algo_type != ppl::kernel::x86::conv2d_fp32_algo::UNKNOWN) {
         selected_input_formats->at(0) = conv2d_param_->algo_info.input_format;
         if (conv2d_param_->mgr->param().fuse_flag & ppl::kernel::x86::conv_fuse_flag::SUM) {
@@ -204,7 +551,8 @@ RetCode ConvOp::SelectFormat(const InputOutputInfo& info, vector<dataformat_t>*
 }
 
 RetCode ConvOp::OmitConstantsData(std::map<edgeid_t, int64_t>* constants_data_refcount) {
-    if (conv2d_param_ && conv2d_param_->algo_info.algo_type != ppl::kernel::x86::conv2d_fp32_algo::UNKNOWN) {
+    if (conv2d_int8_param_ || conv2d_bf16_param_ ||
+        (conv2d_param_ && conv2d_param_->algo_info.algo_type != ppl::kernel::x86::conv2d_fp32_algo::UNKNOWN)) {
         auto weight_id = GetNode()->GetInput(1);
         auto it = constants_data_refcount->find(weight_id);
         if (it != constants_data_refcount->end()) {
@@ -222,6 +570,20 @@ RetCode ConvOp::OmitConstantsData(std::map<edgeid_t, int64_t>* constants_data_re
 }
 
 bool ConvOp::TryFuseReLU() {
+    if (conv2d_int8_param_) {
+        if (conv2d_int8_param_->param.post != ppl::kernel::x86::gemm_post::NONE) {
+            return false;
+        }
+        conv2d_int8_param_->param.post = ppl::kernel::x86::gemm_post::RELU;
+        return true;
+    }
+    if (conv2d_bf16_param_) {
+        if (conv2d_bf16_param_->param.post != ppl::kernel::x86::gemm_post::NONE) {
+            return false;
+        }
+        conv2d_bf16_param_->param.post = ppl::kernel::x86::gemm_post::RELU;
+        return true;
+    }
     if (!conv2d_param_ || conv2d_param_->algo_info.algo_type == ppl::kernel::x86::conv2d_fp32_algo::UNKNOWN) {
         return false;
     }
@@ -235,6 +597,20 @@ bool ConvOp::TryFuseReLU() {
 }
 
 bool ConvOp::TryFuseReLU6() {
+    if (conv2d_int8_param_) {
+        if (conv2d_int8_param_->param.post != ppl::kernel::x86::gemm_post::NONE) {
+            return false;
+        }
+        conv2d_int8_param_->param.post = ppl::kernel::x86::gemm_post::RELU6;
+        return true;
+    }
+    if (conv2d_bf16_param_) {
+        if (conv2d_bf16_param_->param.post != ppl::kernel::x86::gemm_post::NONE) {
+            return false;
+        }
+        conv2d_bf16_param_->param.post = ppl::kernel::x86::gemm_post::RELU6;
+        return true;
+    }
     if (!conv2d_param_ || conv2d_param_->algo_info.algo_type == ppl::kernel::x86::conv2d_fp32_algo::UNKNOWN) {
         return false;
     }
@@ -264,7 +640,121 @@ bool ConvOp::TryFuseSum() {
     return true;
 }
 
+void ConvOp::SetInt8Output(const QuantizeParam& dst_quant) {
+    conv2d_int8_param_->output_type = DATATYPE_UINT8;
+    conv2d_int8_param_->dst_quant = dst_quant;
+}
+
+void ConvOp::SetBf16Output(datatype_t data_type) {
+    conv2d_bf16_param_->output_type = data_type;
+}
+
+#ifdef PPLNN_ENABLE_PMX_MODEL
+/*
+  layout of private data:
+  version(uint32) | bias_term(int32) | has_int8(uint32) [int8 param] | has_bf16(uint32) [bf16 param] |
+  has_fp32(uint32) [fp32 param]
+  the version must be increased whenever the layout changes. data of version 1 started with bias_term(0 or 1)
+  directly and had no int8 and bf16 flags.
+*/
+static const uint32_t CONV_PRIVATE_DATA_VERSION = 2;
+
+RetCode ConvOp::SerializePrivateData(const pmx::SerializationContext&, utils::DataStream* ds) const {
+    WritePod(CONV_PRIVATE_DATA_VERSION, ds);
+    WritePod(bias_term_, ds);
+    WritePod((uint32_t)(conv2d_int8_param_ ? 1 : 0), ds);
+    if (conv2d_int8_param_) {
+        return SerializeConv2dInt8Param(*conv2d_int8_param_, ds);
+    }
+    WritePod((uint32_t)(conv2d_bf16_param_ ? 1 : 0), ds);
+    if (conv2d_bf16_param_) {
+        return SerializeConv2dBf16Param(*conv2d_bf16_param_, ds);
+    }
+    WritePod((uint32_t)(conv2d_param_ ? 1 : 0), ds);
+    if (conv2d_param_) {
+        return SerializeConv2dParam(*conv2d_param_, ds);
+    }
+    return RC_SUCCESS;
+}
+
+RetCode ConvOp::DeserializePrivateData(DataReader* reader, X86Device* device) {
+    uint32_t version = 0;
+    auto status = reader->ReadPod(&version);
+    if (status != RC_SUCCESS) {
+        return status;
+    }
+    if (version != CONV_PRIVATE_DATA_VERSION) {
+        LOG(ERROR) << "unsupported private data version[" << version << "] of conv[" << GetNode()->GetName()
+                   << "], expected [" << CONV_PRIVATE_DATA_VERSION << "]. please regenerate the model.";
+        return RC_UNSUPPORTED;
+    }
+
+    uint32_t has_int8_param = 0;
+    status = reader->ReadPod(&bias_term_);
+    if (status == RC_SUCCESS) {
+        status = reader->ReadPod(&has_int8_param);
+    }
+    if (status != RC_SUCCESS) {
+        return status;
+    }
+
+    if (has_int8_param) {
+        if (!conv2d_int8_param_) {
+            conv2d_int8_param_ = new Conv2dInt8Param;
+        }
+        if (!conv2d_int8_param_) {
+            return RC_OUT_OF_MEMORY;
+        }
+        return DeserializeConv2dInt8Param(reader, device->GetISA(), conv2d_int8_param_);
+    }
+
+    uint32_t has_bf16_param = 0;
+    status = reader->ReadPod(&has_bf16_param);
+    if (status != RC_SUCCESS) {
+        return status;
+    }
+    if (has_bf16_param) {
+        if (!conv2d_bf16_param_) {
+            conv2d_bf16_param_ = new Conv2dBf16Param;
+        }
+        if (!conv2d_bf16_param_) {
+            return RC_OUT_OF_MEMORY;
+        }
+        return DeserializeConv2dBf16Param(reader, conv2d_bf16_param_);
+    }
+
+    uint32_t has_conv2d_param = 0;
+    status = reader->ReadPod(&has_conv2d_param);
+    if (status != RC_SUCCESS || !has_conv2d_param) {
+        return status;
+    }
+
+    if (!conv2d_param_) {
+        conv2d_param_ = new Conv2dParam;
+    }
+    if (!conv2d_param_) {
+        return RC_OUT_OF_MEMORY;
+    }
+
+    status = DeserializeConv2dParam(reader, device->GetAllocator(), conv2d_param_);
+    if (status != RC_SUCCESS) {
+        return status;
+    }
+
+    if (conv2d_param_->fallback_mgr) {
+        conv2d_param_->infer_fallback_func = InferWinogradFallback;
+    }
+    return RC_SUCCESS;
+}
+#endif
+
 KernelImpl* ConvOp::CreateKernelImpl() const {
+    if (conv2d_int8_param_) {
+        return CreateKernelImplWithParam<Conv2dInt8Kernel>(conv2d_int8_param_);
+    }
+    if (conv2d_bf16_param_) {
+        return CreateKernelImplWithParam<Conv2dBf16Kernel>(conv2d_bf16_param_);
+    }
     if (!conv2d_param_ || conv2d_param_->algo_info.algo_type == ppl::kernel::x86::conv2d_fp32_algo::UNKNOWN) {
         return CreateKernelImplWithParam<Conv2dDynamicKernel>(param_.get());
     }
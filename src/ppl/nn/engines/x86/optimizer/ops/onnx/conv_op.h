@@ -27,7 +27,8 @@ namespace ppl { namespace nn { namespace x86 {
 class PostDepthwiseConvOp;
 class ConvOp final : public X86OptKernel {
 public:
-    ConvOp(const ir::Node* node) : X86OptKernel(node), conv2d_param_(nullptr) {}
+    ConvOp(const ir::Node* node)
+        : X86OptKernel(node), conv2d_param_(nullptr), conv2d_int8_param_(nullptr), conv2d_bf16_param_(nullptr) {}
 
     ~ConvOp();
     ppl::common::RetCode Init(const OptKernelOptions& options) override;
@@ -44,9 +45,42 @@ public:
     bool TryFuseReLU6();
     bool TryFuseSum();
 
+    /** @brief returns param of the float32 kernel, or nullptr if this conv does not run in float32 */
+    const Conv2dParam* GetConv2dParam() const {
+        return conv2d_param_;
+    }
+
+    /** @brief returns param of the int8 kernel, or nullptr if this conv runs in float32 */
+    const Conv2dInt8Param* GetInt8Param() const {
+        return conv2d_int8_param_;
+    }
+    /** @brief makes the int8 kernel output uint8 requantized by `dst_quant` */
+    void SetInt8Output(const QuantizeParam& dst_quant);
+
+    /** @brief returns param of the bfloat16 kernel, or nullptr if this conv runs in float32 */
+    const Conv2dBf16Param* GetBf16Param() const {
+        return conv2d_bf16_param_;
+    }
+    /** @brief makes the bfloat16 kernel output `data_type`, which is float32 by default */
+    void SetBf16Output(ppl::common::datatype_t data_type);
+
+#ifdef PPLNN_ENABLE_PMX_MODEL
+protected:
+    ppl::common::RetCode SerializePrivateData(const pmx::SerializationContext&, utils::DataStream*) const override;
+    ppl::common::RetCode DeserializePrivateData(DataReader*, X86Device*) override;
+#endif
+
+private:
+    bool TrySelectInt8Algorithm(const OptKernelOptions& options, const float* weight_data, const float* bias_data,
+                                int64_t num_output, int64_t channels);
+    bool TrySelectBf16Algorithm(const OptKernelOptions& options, const float* weight_data, const float* bias_data,
+                                int64_t num_output, int64_t channels);
+
 private:
     int32_t bias_term_ = 0;
     Conv2dParam* conv2d_param_;
+    Conv2dInt8Param* conv2d_int8_param_;
+    Conv2dBf16Param* conv2d_bf16_param_;
     std::shared_ptr<ppl::nn::onnx::ConvParam> param_;
 
     friend PostDepthwiseConvOp;
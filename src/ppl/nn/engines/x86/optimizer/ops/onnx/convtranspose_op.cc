@@ -19,11 +19,90 @@
 #include "ppl/nn/engines/x86/kernels/onnx/convtranspose_kernel.h"
 #include "ppl/nn/oputils/onnx/reshape_convtranspose.h"
 #include "ppl/nn/common/logger.h"
+
+#ifdef PPLNN_ENABLE_PMX_MODEL
+#include "ppl/nn/engines/x86/pmx/kernel_param_serializer.h"
+#endif
+
 using namespace std;
 using namespace ppl::common;
 
 namespace ppl { namespace nn { namespace x86 {
 
+/*
+  a float32 convtranspose with constant weight(and bias) is packed for the n16cx kernel, which keeps
+  decoders and upsampling paths of segmentation networks in n16cx instead of reordering to ndarray and back.
+*/
+bool ConvTransposeOp::TryPackN16cx(const OptKernelOptions& options) {
+    auto node = GetNode();
+    auto graph_data = options.graph_data;
+
+    if (param_->group != 1 || (!param_->auto_pad.empty() && param_->auto_pad != "NOTSET")) {
+        return false;
+    }
+    for (auto d = param_->dilations.begin(); d != param_->dilations.end(); ++d) {
+        if (*d != 1) {
+            return false;
+        }
+    }
+    if (param_->strides.size() != 2 || param_->pads.size() != 4) {
+        return false;
+    }
+
+    auto weight_ref = graph_data->constants.find(node->GetInput(1));
+    auto weight_shape_ref = graph_data->shapes.find(node->GetInput(1));
+    if (weight_ref == graph_data->constants.end() || weight_shape_ref == graph_data->shapes.end()) {
+        return false;
+    }
+    const ir::Shape& weight_shape = weight_shape_ref->second;
+    if (weight_shape.data_type != DATATYPE_FLOAT32 || weight_shape.dims.size() != 4) {
+        return false;
+    }
+
+    const float* bias = nullptr;
+    if (node->GetInputCount() > 2 && node->GetInput(2) != INVALID_EDGEID) {
+        auto bias_ref = graph_data->constants.find(node->GetInput(2));
+        if (bias_ref == graph_data->constants.end() ||
+            bias_ref->second.data.size() != weight_shape.dims[1] * sizeof(float)) {
+            return false;
+        }
+        bias = (const float*)bias_ref->second.data.data();
+    }
+
+    ppl::kernel::x86::conv_transpose_n16cx_fp32_param kernel_param;
+    kernel_param.channels = weight_shape.dims[0];
+    kernel_param.num_output = weight_shape.dims[1];
+    kernel_param.kernel_h = weight_shape.dims[2];
+    kernel_param.kernel_w = weight_shape.dims[3];
+    kernel_param.stride_h = param_->strides[0];
+    kernel_param.stride_w = param_->strides[1];
+    kernel_param.pad_h = param_->pads[0];
+    kernel_param.pad_w = param_->pads[1];
+    kernel_param.fuse_flag = ppl::kernel::x86::conv_fuse_flag::NONE;
+    if (!ppl::kernel::x86::conv_transpose_n16cx_fp32_is_supported(options.device->GetISA(), kernel_param)) {
+        return false;
+    }
+    if (weight_ref->second.data.size() !=
+        kernel_param.channels * kernel_param.num_output * kernel_param.kernel_h * kernel_param.kernel_w * sizeof(float)) {
+        return false;
+    }
+
+    auto n16cx_param = make_shared<ConvTransposeN16cxParam>();
+    n16cx_param->param = kernel_param;
+    n16cx_param->packed_weight.resize(
+        ppl::kernel::x86::conv_transpose_n16cx_fp32_get_packed_weight_bytes(kernel_param) / sizeof(float));
+    auto status = ppl::kernel::x86::conv_transpose_n16cx_fp32_pack_weight(
+        kernel_param, (const float*)weight_ref->second.data.data(), bias, n16cx_param->packed_weight.data());
+    if (status != RC_SUCCESS) {
+        LOG(WARNING) << "pack weight of convtranspose[" << node->GetName() << "] failed: " << GetRetCodeStr(status);
+        return false;
+    }
+
+    n16cx_param_ = n16cx_param;
+    LOG(DEBUG) << "weight of convtranspose[" << node->GetName() << "] is packed for n16cx";
+    return true;
+}
+
 RetCode ConvTransposeOp::Init(const OptKernelOptions& options) {
     auto status = GenericLoadParam(options, &param_);
     if (status != RC_SUCCESS) {
@@ -33,10 +112,18 @@ RetCode ConvTransposeOp::Init(const OptKernelOptions& options) {
 
     auto node = GetNode();
     auto graph_data = options.graph_data;
-    const ir::Shape& weight_shape = graph_data->shapes.find(node->GetInput(1))->second;
 
-    const int64_t kernel_dims =
-        param_->kernel_shape.size() == 0 ? (weight_shape.dims.size() - 2) : param_->kernel_shape.size();
+    // shapes are not available when loading from a pmx model
+    int64_t kernel_dims = param_->kernel_shape.size();
+    if (kernel_dims == 0) {
+        auto weight_shape_ref = graph_data->shapes.find(node->GetInput(1));
+        if (weight_shape_ref == graph_data->shapes.end()) {
+            LOG(ERROR) << "cannot find shape of weight[" << node->GetInput(1) << "] of convtranspose["
+                       << node->GetName() << "]";
+            return RC_NOT_FOUND;
+        }
+        kernel_dims = weight_shape_ref->second.dims.size() - 2;
+    }
 
     if (kernel_dims != 2) {
         LOG(ERROR) << "Only support ConvTranspose2d currently. Get unsupported kernel_dims=" << kernel_dims
@@ -50,11 +137,76 @@ RetCode ConvTransposeOp::Init(const OptKernelOptions& options) {
 
     infer_type_func_ = GenericInferType;
 
+    TryPackN16cx(options);
+
     return RC_SUCCESS;
 }
 
+RetCode ConvTransposeOp::SelectFormat(const InputOutputInfo& info, vector<dataformat_t>* selected_input_formats,
+                                      vector<dataformat_t>* selected_output_formats) {
+    if (n16cx_param_) {
+        selected_input_formats->at(0) = DATAFORMAT_N16CX;
+        selected_output_formats->at(0) = DATAFORMAT_N16CX;
+    }
+    return RC_SUCCESS;
+}
+
+RetCode ConvTransposeOp::OmitConstantsData(std::map<edgeid_t, int64_t>* constants_data_refcount) {
+    if (n16cx_param_) {
+        auto node = GetNode();
+        for (uint32_t i = 1; i < node->GetInputCount() && i <= 2; ++i) {
+            auto it = constants_data_refcount->find(node->GetInput(i));
+            if (it != constants_data_refcount->end()) {
+                it->second--;
+            }
+        }
+    }
+    return RC_SUCCESS;
+}
+
+bool ConvTransposeOp::TryFuseReLU() {
+    if (!n16cx_param_ || n16cx_param_->param.fuse_flag != ppl::kernel::x86::conv_fuse_flag::NONE) {
+        return false;
+    }
+    n16cx_param_->param.fuse_flag = ppl::kernel::x86::conv_fuse_flag::RELU;
+    return true;
+}
+
+bool ConvTransposeOp::TryFuseReLU6() {
+    if (!n16cx_param_ || n16cx_param_->param.fuse_flag != ppl::kernel::x86::conv_fuse_flag::NONE) {
+        return false;
+    }
+    n16cx_param_->param.fuse_flag = ppl::kernel::x86::conv_fuse_flag::RELU6;
+    return true;
+}
+
+#ifdef PPLNN_ENABLE_PMX_MODEL
+RetCode ConvTransposeOp::SerializePrivateData(const pmx::SerializationContext&, utils::DataStream* ds) const {
+    WritePod((uint32_t)(n16cx_param_ ? 1 : 0), ds);
+    if (n16cx_param_) {
+        return SerializeConvTransposeN16cxParam(*n16cx_param_, ds);
+    }
+    return RC_SUCCESS;
+}
+
+RetCode ConvTransposeOp::DeserializePrivateData(DataReader* reader, X86Device* device) {
+    uint32_t has_n16cx_param = 0;
+    auto status = reader->ReadPod(&has_n16cx_param);
+    if (status != RC_SUCCESS || !has_n16cx_param) {
+        return status;
+    }
+
+    n16cx_param_ = make_shared<ConvTransposeN16cxParam>();
+    return DeserializeConvTransposeN16cxParam(reader, device->GetISA(), n16cx_param_.get());
+}
+#endif
+
 KernelImpl* ConvTransposeOp::CreateKernelImpl() const {
-    return CreateKernelImplWithParam<ConvTransposeKernel>(param_.get());
+    auto kernel = CreateKernelImplWithParam<ConvTransposeKernel>(param_.get());
+    if (kernel && n16cx_param_) {
+        kernel->SetN16cxParam(n16cx_param_.get());
+    }
+    return kernel;
 }
 
 }}} // namespace ppl::nn::x86
@@ -19,6 +19,7 @@
 #define _ST_HPC_PPL_NN_ENGINES_X86_OPTIMIZER_OPS_ONNX_CONVTRANSPOSE_OP_H_
 
 #include "ppl/nn/params/onnx/convtranspose_param.h"
+#include "ppl/nn/engines/x86/params/convtranspose_param.h"
 #include "ppl/nn/engines/x86/optimizer/opt_kernel.h"
 
 namespace ppl { namespace nn { namespace x86 {
@@ -28,9 +29,27 @@ public:
     ConvTransposeOp(const ir::Node* node) : X86OptKernel(node) {}
     ppl::common::RetCode Init(const OptKernelOptions& options) override;
     KernelImpl* CreateKernelImpl() const override;
+    ppl::common::RetCode SelectFormat(const InputOutputInfo& info,
+                                      std::vector<ppl::common::dataformat_t>* selected_input_formats,
+                                      std::vector<ppl::common::dataformat_t>* selected_output_formats) override;
+    ppl::common::RetCode OmitConstantsData(std::map<edgeid_t, int64_t>* constants_data_refcount) override;
+
+    /** @note only the n16cx kernel supports fused activations */
+    bool TryFuseReLU();
+    bool TryFuseReLU6();
+
+#ifdef PPLNN_ENABLE_PMX_MODEL
+protected:
+    ppl::common::RetCode SerializePrivateData(const pmx::SerializationContext&, utils::DataStream*) const override;
+    ppl::common::RetCode DeserializePrivateData(DataReader*, X86Device*) override;
+#endif
+
+private:
+    bool TryPackN16cx(const OptKernelOptions& options);
 
 private:
     std::shared_ptr<ppl::nn::onnx::ConvTransposeParam> param_;
+    std::shared_ptr<ConvTransposeN16cxParam> n16cx_param_;
 };
 
 }}} // namespace ppl::nn::x86
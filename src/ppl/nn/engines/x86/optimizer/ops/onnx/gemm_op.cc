@@ -18,8 +18,16 @@
 #include "ppl/nn/engines/x86/optimizer/ops/onnx/gemm_op.h"
 #include "ppl/nn/engines/x86/kernels/onnx/gemm_kernel.h"
 #include "ppl/nn/engines/x86/kernels/onnx/fc_kernel.h"
+#include "ppl/nn/engines/x86/kernels/onnx/fc_int8_kernel.h"
+#include "ppl/nn/engines/x86/kernels/onnx/fc_bf16_kernel.h"
+#include "ppl/nn/engines/x86/optimizer/quant_utils.h"
 #include "ppl/nn/oputils/onnx/reshape_gemm.h"
 #include "ppl/nn/common/logger.h"
+
+#ifdef PPLNN_ENABLE_PMX_MODEL
+#include "ppl/nn/engines/x86/pmx/kernel_param_serializer.h"
+#endif
+
 using namespace std;
 using namespace ppl::common;
 
@@ -32,6 +40,116 @@ GemmOp::~GemmOp() {
         }
         delete fc_param_;
     }
+    if (fc_int8_param_ != nullptr) {
+        delete fc_int8_param_;
+    }
+    if (fc_bf16_param_ != nullptr) {
+        delete fc_bf16_param_;
+    }
+}
+
+/*
+  fcs whose input has per-tensor quantization info run in int8. weights are packed in
+  gemm_s8u8_layout::LANE_A so that small batches use full vectors.
+*/
+bool GemmOp::TrySelectInt8Algorithm(const OptKernelOptions& options, const float* weight_data,
+                                    const float* bias_data) {
+    auto node = GetNode();
+    if (!options.quant_info || !IsNodeQuantEnabled(options.quant_info, node->GetName())) {
+        return false;
+    }
+    if (param_->alpha != 1.0f || (bias_data && param_->beta != 1.0f)) {
+        return false;
+    }
+
+    QuantizeParam src_quant;
+    auto input_edge = options.graph_topo->GetEdge(node->GetInput(0));
+    if (!FindTensorQuantParam(options.quant_info, input_edge->GetName(), &src_quant)) {
+        return false;
+    }
+
+    const ir::Shape& weight_shape = options.graph_data->shapes.find(node->GetInput(1))->second;
+    const int64_t num_output = weight_shape.dims[0];
+    const int64_t channels = weight_shape.dims[1];
+
+    unique_ptr<FCInt8Param> int8_param(new FCInt8Param);
+    if (!int8_param) {
+        return false;
+    }
+    int8_param->num_output = num_output;
+    int8_param->channels = channels;
+
+    auto isa = options.device->GetISA();
+    const auto layout = ppl::kernel::x86::gemm_s8u8_layout::LANE_A;
+    vector<float> weight_scale(num_output);
+    int8_param->packed_weight.resize(ppl::kernel::x86::gemm_s8u8_get_packed_a_bytes(layout, num_output, channels));
+    int8_param->weight_sum.resize(num_output);
+    auto status = ppl::kernel::x86::gemm_s8u8_quantize_pack_a(isa, layout, weight_data, num_output, channels, channels,
+                                                              int8_param->packed_weight.data(), weight_scale.data(),
+                                                              int8_param->weight_sum.data());
+    if (status != RC_SUCCESS) {
+        LOG(WARNING) << "quantize weight of fc[" << node->GetName() << "] failed: " << GetRetCodeStr(status)
+                     << ", fallback to float32.";
+        return false;
+    }
+
+    int8_param->scale.resize(num_output);
+    for (int64_t i = 0; i < num_output; ++i) {
+        int8_param->scale[i] = weight_scale[i] * src_quant.scale;
+    }
+    if (bias_data) {
+        int8_param->bias.assign(bias_data, bias_data + num_output);
+    }
+    int8_param->weight_max_value = ppl::kernel::x86::gemm_s8u8_get_a_max_value(isa);
+    int8_param->src_quant = src_quant;
+
+    fc_int8_param_ = int8_param.release();
+
+    LOG(DEBUG) << "fc[" << node->GetName() << "] runs in int8, src scale[" << src_quant.scale << "] zero_point["
+               << src_quant.zero_point << "]";
+    return true;
+}
+
+// fcs run in bfloat16 with float32 accumulation if it is enabled by `forward_precision`
+bool GemmOp::TrySelectBf16Algorithm(const OptKernelOptions& options, const float* weight_data,
+                                    const float* bias_data) {
+    if (!IsBf16Enabled(options)) {
+        return false;
+    }
+    if (param_->alpha != 1.0f || (bias_data && param_->beta != 1.0f)) {
+        return false;
+    }
+
+    auto node = GetNode();
+    const ir::Shape& weight_shape = options.graph_data->shapes.find(node->GetInput(1))->second;
+    const int64_t num_output = weight_shape.dims[0];
+    const int64_t channels = weight_shape.dims[1];
+
+    unique_ptr<FCBf16Param> bf16_param(new FCBf16Param);
+    if (!bf16_param) {
+        return false;
+    }
+    bf16_param->num_output = num_output;
+    bf16_param->channels = channels;
+
+    const auto layout = ppl::kernel::x86::gemm_bf16_layout::LANE_A;
+    bf16_param->packed_weight.resize(ppl::kernel::x86::gemm_bf16_get_packed_a_bytes(layout, num_output, channels) /
+                                     sizeof(uint16_t));
+    auto status = ppl::kernel::x86::gemm_bf16_pack_a(layout, weight_data, num_output, channels, channels,
+                                                     bf16_param->packed_weight.data());
+    if (status != RC_SUCCESS) {
+        LOG(WARNING) << "pack weight of fc[" << node->GetName() << "] failed: " << GetRetCodeStr(status)
+                     << ", fallback to float32.";
+        return false;
+    }
+    if (bias_data) {
+        bf16_param->bias.assign(bias_data, bias_data + num_output);
+    }
+
+    fc_bf16_param_ = bf16_param.release();
+
+    LOG(DEBUG) << "fc[" << node->GetName() << "] runs in bfloat16";
+    return true;
 }
 
 RetCode GemmOp::Init(const OptKernelOptions& options) {
@@ -60,7 +178,9 @@ RetCode GemmOp::Init(const OptKernelOptions& options) {
 
     param_->bias_term = (node->GetInputCount() == 3) ? true : false;
 
-    if (!param_->transA && param_->transB && weight_data != nullptr) {
+    if (!param_->transA && param_->transB && weight_data != nullptr &&
+        !TrySelectInt8Algorithm(options, weight_data, bias_data) &&
+        !TrySelectBf16Algorithm(options, weight_data, bias_data)) {
         if (!fc_param_) {
             fc_param_ = new FCParam;
         }
@@ -94,13 +214,22 @@ RetCode GemmOp::Init(const OptKernelOptions& options) {
         return onnx::ReshapeGemm(info, param_.get());
     };
 
-    infer_type_func_ = GenericInferType;
+    infer_type_func_ = [this](InputOutputInfo* info) -> void {
+        if (fc_int8_param_) {
+            info->GetOutput<TensorImpl>(0)->GetShape()->SetDataType(fc_int8_param_->output_type);
+        } else if (fc_bf16_param_) {
+            info->GetOutput<TensorImpl>(0)->GetShape()->SetDataType(fc_bf16_param_->output_type);
+        } else {
+            GenericInferType(info);
+        }
+    };
 
     return RC_SUCCESS;
 }
 
 RetCode GemmOp::OmitConstantsData(std::map<edgeid_t, int64_t>* constants_data_refcount) {
-    if (fc_param_ && fc_param_->algo_info.algo_type != ppl::kernel::x86::fc_fp32_algo::UNKNOWN) {
+    if (fc_int8_param_ || fc_bf16_param_ ||
+        (fc_param_ && fc_param_->algo_info.algo_type != ppl::kernel::x86::fc_fp32_algo::UNKNOWN)) {
         auto weight_id = GetNode()->GetInput(1);
         auto it = constants_data_refcount->find(weight_id);
         if (it != constants_data_refcount->end()) {
@@ -119,6 +248,12 @@ RetCode GemmOp::OmitConstantsData(std::map<edgeid_t, int64_t>* constants_data_re
 
 bool GemmOp::TryFuseReLU() {
     fuse_relu_ = true;
+    if (fc_int8_param_) {
+        fc_int8_param_->post = ppl::kernel::x86::gemm_post::RELU;
+    }
+    if (fc_bf16_param_) {
+        fc_bf16_param_->post = ppl::kernel::x86::gemm_post::RELU;
+    }
     if (fc_param_ && fc_param_->algo_info.algo_type != ppl::kernel::x86::fc_fp32_algo::UNKNOWN) {
         ppl::kernel::x86::fc_fp32_param param = fc_param_->mgr->param();
         param.fuse_flag |= ppl::kernel::x86::fc_fuse_flag::RELU;
@@ -127,7 +262,92 @@ bool GemmOp::TryFuseReLU() {
     return true;
 }
 
+void GemmOp::SetInt8Output(const QuantizeParam& dst_quant) {
+    fc_int8_param_->output_type = DATATYPE_UINT8;
+    fc_int8_param_->dst_quant = dst_quant;
+}
+
+void GemmOp::SetBf16Output(datatype_t data_type) {
+    fc_bf16_param_->output_type = data_type;
+}
+
+#ifdef PPLNN_ENABLE_PMX_MODEL
+RetCode GemmOp::SerializePrivateData(const pmx::SerializationContext&, utils::DataStream* ds) const {
+    WritePod(fuse_relu_, ds);
+    WritePod((uint32_t)(fc_int8_param_ ? 1 : 0), ds);
+    if (fc_int8_param_) {
+        return SerializeFCInt8Param(*fc_int8_param_, ds);
+    }
+    WritePod((uint32_t)(fc_bf16_param_ ? 1 : 0), ds);
+    if (fc_bf16_param_) {
+        return SerializeFCBf16Param(*fc_bf16_param_, ds);
+    }
+    WritePod((uint32_t)(fc_param_ ? 1 : 0), ds);
+    if (fc_param_) {
+        return SerializeFCParam(*fc_param_, ds);
+    }
+    return RC_SUCCESS;
+}
+
+RetCode GemmOp::DeserializePrivateData(DataReader* reader, X86Device* device) {
+    uint32_t has_int8_param = 0;
+    auto status = reader->ReadPod(&fuse_relu_);
+    if (status == RC_SUCCESS) {
+        status = reader->ReadPod(&has_int8_param);
+    }
+    if (status != RC_SUCCESS) {
+        return status;
+    }
+
+    if (has_int8_param) {
+        if (!fc_int8_param_) {
+            fc_int8_param_ = new FCInt8Param;
+        }
+        if (!fc_int8_param_) {
+            return RC_OUT_OF_MEMORY;
+        }
+        return DeserializeFCInt8Param(reader, device->GetISA(), fc_int8_param_);
+    }
+
+    uint32_t has_bf16_param = 0;
+    status = reader->ReadPod(&has_bf16_param);
+    if (status != RC_SUCCESS) {
+        return status;
+    }
+    if (has_bf16_param) {
+        if (!fc_bf16_param_) {
+            fc_bf16_param_ = new FCBf16Param;
+        }
+        if (!fc_bf16_param_) {
+            return RC_OUT_OF_MEMORY;
+        }
+        return DeserializeFCBf16Param(reader, fc_bf16_param_);
+    }
+
+    uint32_t has_fc_param = 0;
+    status = reader->ReadPod(&has_fc_param);
+    if (status != RC_SUCCESS || !has_fc_param) {
+        return status;
+    }
+
+    if (!fc_param_) {
+        fc_param_ = new FCParam;
+    }
+    if (!fc_param_) {
+        return RC_OUT_OF_MEMORY;
+    }
+
+    return DeserializeFCParam(reader, device->GetAllocator(), fc_param_);
+}
+#endif
+
 KernelImpl* GemmOp::CreateKernelImpl() const {
+    if (fc_int8_param_) {
+        return CreateKernelImplWithParam<FCInt8Kernel>(fc_int8_param_);
+    }
+    if (fc_bf16_param_) {
+        return CreateKernelImplWithParam<FCBf16Kernel>(fc_bf16_param_);
+    }
     if (fc_param_ && fc_param_->algo_info.algo_type != ppl::kernel::x86::fc_fp32_algo::UNKNOWN) {
         return CreateKernelImplWithParam<FCKernel>(fc_param_);
     } else {
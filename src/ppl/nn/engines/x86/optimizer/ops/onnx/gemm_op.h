@@ -26,15 +26,42 @@ namespace ppl { namespace nn { namespace x86 {
 
 class GemmOp final : public X86OptKernel {
 public:
-    GemmOp(const ir::Node* node) : X86OptKernel(node), fc_param_(nullptr) {}
+    GemmOp(const ir::Node* node)
+        : X86OptKernel(node), fc_param_(nullptr), fc_int8_param_(nullptr), fc_bf16_param_(nullptr) {}
     ~GemmOp();
     ppl::common::RetCode Init(const OptKernelOptions& options) override;
     KernelImpl* CreateKernelImpl() const override;
     ppl::common::RetCode OmitConstantsData(std::map<edgeid_t, int64_t>* constants_data_refcount) override;
     bool TryFuseReLU();
 
+    /** @brief returns param of the int8 kernel, or nullptr if this gemm runs in float32 */
+    const FCInt8Param* GetInt8Param() const {
+        return fc_int8_param_;
+    }
+    /** @brief makes the int8 kernel output uint8 requantized by `dst_quant` */
+    void SetInt8Output(const QuantizeParam& dst_quant);
+
+    /** @brief returns param of the bfloat16 kernel, or nullptr if this gemm runs in float32 */
+    const FCBf16Param* GetBf16Param() const {
+        return fc_bf16_param_;
+    }
+    /** @brief makes the bfloat16 kernel output `data_type`, which is float32 by default */
+    void SetBf16Output(ppl::common::datatype_t data_type);
+
+#ifdef PPLNN_ENABLE_PMX_MODEL
+protected:
+    ppl::common::RetCode SerializePrivateData(const pmx::SerializationContext&, utils::DataStream*) const override;
+    ppl::common::RetCode DeserializePrivateData(DataReader*, X86Device*) override;
+#endif
+
+private:
+    bool TrySelectInt8Algorithm(const OptKernelOptions& options, const float* weight_data, const float* bias_data);
+    bool TrySelectBf16Algorithm(const OptKernelOptions& options, const float* weight_data, const float* bias_data);
+
 private:
     FCParam* fc_param_;
+    FCInt8Param* fc_int8_param_;
+    FCBf16Param* fc_bf16_param_;
     std::shared_ptr<ppl::nn::onnx::GemmParam> param_;
     bool fuse_relu_ = false;
 };
@@ -29,6 +29,16 @@ public:
     ppl::common::RetCode Init(const OptKernelOptions& options) override;
     KernelImpl* CreateKernelImpl() const override;
 
+#ifdef PPLNN_ENABLE_PMX_MODEL
+    // subgraphs cannot be serialized yet
+    ppl::common::RetCode SerializeData(const pmx::SerializationContext&, utils::DataStream*) const override {
+        return ppl::common::RC_UNSUPPORTED;
+    }
+    ppl::common::RetCode DeserializeData(const pmx::DeserializationContext&, const void*, uint64_t) override {
+        return ppl::common::RC_UNSUPPORTED;
+    }
+#endif
+
 private:
     onnx::IfOp op_;
 };
@@ -18,12 +18,74 @@
 #include "ppl/nn/engines/x86/optimizer/ops/onnx/matmul_op.h"
 #include "ppl/nn/engines/x86/kernels/onnx/matmul_kernel.h"
 #include "ppl/nn/oputils/onnx/reshape_matmul.h"
+#include "ppl/nn/common/logger.h"
+#include "ppl/kernel/x86/fp32/matmul.h"
+
+#ifdef PPLNN_ENABLE_PMX_MODEL
+#include "ppl/nn/engines/x86/pmx/kernel_param_serializer.h"
+#endif
+
 using namespace std;
 using namespace ppl::common;
 
 namespace ppl { namespace nn { namespace x86 {
 
+/*
+  a constant float32 B whose dims are [K, N] or [K](leading 1s are allowed) is packed once here, so
+  MatMul(activation, Constant) in transformers runs like a fc: all batch dims of A are folded into M
+  and the packed panel is reused by every row.
+*/
+bool MatMulOp::TryPackConstantB(const OptKernelOptions& options) {
+    auto node = GetNode();
+    auto graph_data = options.graph_data;
+
+    auto constant_ref = graph_data->constants.find(node->GetInput(1));
+    if (constant_ref == graph_data->constants.end()) {
+        return false;
+    }
+    auto shape_ref = graph_data->shapes.find(node->GetInput(1));
+    if (shape_ref == graph_data->shapes.end()) {
+        return false;
+    }
+
+    const ir::Shape& b_shape = shape_ref->second;
+    if (b_shape.data_type != DATATYPE_FLOAT32 || b_shape.data_format != DATAFORMAT_NDARRAY ||
+        b_shape.dims.empty()) {
+        return false;
+    }
+    const uint32_t dim_count = b_shape.dims.size();
+    for (uint32_t i = 0; i + 2 < dim_count; ++i) {
+        if (b_shape.dims[i] != 1) {
+            return false;
+        }
+    }
+    const int64_t N = (dim_count == 1) ? 1 : b_shape.dims[dim_count - 1];
+    const int64_t K = (dim_count == 1) ? b_shape.dims[0] : b_shape.dims[dim_count - 2];
+    if (N <= 0 || K <= 0 || constant_ref->second.data.size() != N * K * sizeof(float)) {
+        return false;
+    }
+
+    auto isa = options.device->GetISA();
+    shared_ptr<MatMulParam> param = make_shared<MatMulParam>();
+    param->N = N;
+    param->K = K;
+    param->packed_isa = isa;
+    param->packed_b.resize(ppl::kernel::x86::matmul_ndarray_fp32_get_packed_b_bytes(isa, N, K) / sizeof(float));
+    auto status = ppl::kernel::x86::matmul_ndarray_fp32_pack_b(
+        isa, (const float*)constant_ref->second.data.data(), N, K, param->packed_b.data());
+    if (status != RC_SUCCESS) {
+        LOG(WARNING) << "pack constant B of matmul[" << node->GetName() << "] failed: " << GetRetCodeStr(status);
+        return false;
+    }
+
+    packed_param_ = param;
+    LOG(DEBUG) << "constant B of matmul[" << node->GetName() << "] is packed, N[" << N << "] K[" << K << "]";
+    return true;
+}
+
 RetCode MatMulOp::Init(const OptKernelOptions& options) {
+    TryPackConstantB(options);
+
     infer_dims_func_ = [](InputOutputInfo* info) -> RetCode {
         return onnx::ReshapeMatMul(info, nullptr);
     };
@@ -33,7 +95,41 @@ RetCode MatMulOp::Init(const OptKernelOptions& options) {
     return RC_SUCCESS;
 }
 
+RetCode MatMulOp::OmitConstantsData(std::map<edgeid_t, int64_t>* constants_data_refcount) {
+    if (packed_param_) {
+        auto it = constants_data_refcount->find(GetNode()->GetInput(1));
+        if (it != constants_data_refcount->end()) {
+            it->second--;
+        }
+    }
+    return RC_SUCCESS;
+}
+
+#ifdef PPLNN_ENABLE_PMX_MODEL
+RetCode MatMulOp::SerializePrivateData(const pmx::SerializationContext&, utils::DataStream* ds) const {
+    WritePod((uint32_t)(packed_param_ ? 1 : 0), ds);
+    if (packed_param_) {
+        return SerializeMatMulParam(*packed_param_, ds);
+    }
+    return RC_SUCCESS;
+}
+
+RetCode MatMulOp::DeserializePrivateData(DataReader* reader, X86Device* device) {
+    uint32_t has_packed_param = 0;
+    auto status = reader->ReadPod(&has_packed_param);
+    if (status != RC_SUCCESS || !has_packed_param) {
+        return status;
+    }
+
+    packed_param_ = make_shared<MatMulParam>();
+    return DeserializeMatMulParam(reader, device->GetISA(), packed_param_.get());
+}
+#endif
+
 KernelImpl* MatMulOp::CreateKernelImpl() const {
+    if (packed_param_) {
+        return CreateKernelImplWithParam<MatMulKernel>(packed_param_.get());
+    }
     return CreateKernelImplWithoutParam<MatMulKernel>();
 }
 
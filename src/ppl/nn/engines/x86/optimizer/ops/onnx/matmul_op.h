@@ -18,6 +18,7 @@
 #ifndef _ST_HPC_PPL_NN_ENGINES_X86_OPTIMIZER_OPS_ONNX_MATMUL_OP_H_
 #define _ST_HPC_PPL_NN_ENGINES_X86_OPTIMIZER_OPS_ONNX_MATMUL_OP_H_
 
+#include "ppl/nn/engines/x86/params/matmul_param.h"
 #include "ppl/nn/engines/x86/optimizer/opt_kernel.h"
 
 namespace ppl { namespace nn { namespace x86 {
@@ -27,6 +28,19 @@ public:
     MatMulOp(const ir::Node* node) : X86OptKernel(node) {}
     ppl::common::RetCode Init(const OptKernelOptions& options) override;
     KernelImpl* CreateKernelImpl() const override;
+    ppl::common::RetCode OmitConstantsData(std::map<edgeid_t, int64_t>* constants_data_refcount) override;
+
+#ifdef PPLNN_ENABLE_PMX_MODEL
+protected:
+    ppl::common::RetCode SerializePrivateData(const pmx::SerializationContext&, utils::DataStream*) const override;
+    ppl::common::RetCode DeserializePrivateData(DataReader*, X86Device*) override;
+#endif
+
+private:
+    bool TryPackConstantB(const OptKernelOptions& options);
+
+private:
+    std::shared_ptr<MatMulParam> packed_param_;
 };
 
 }}} // namespace ppl::nn::x86
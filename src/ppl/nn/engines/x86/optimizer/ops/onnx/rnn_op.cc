@@ -0,0 +1,73 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <float.h>
+
+#include "ppl/nn/engines/x86/optimizer/ops/onnx/rnn_op.h"
+#include "ppl/nn/engines/x86/kernels/onnx/rnn_kernel.h"
+#include "ppl/nn/oputils/onnx/reshape_rnn.h"
+#include "ppl/nn/common/logger.h"
+using namespace std;
+using namespace ppl::common;
+
+namespace ppl { namespace nn { namespace x86 {
+
+// exporters may write default activations explicitly
+static bool IsDefaultActivations(const onnx::RNNParam& param) {
+    static const onnx::RNNParam::activation_t default_acts[] = {
+        onnx::RNNParam::ACT_TANH,
+    };
+    const uint32_t acts_per_direction = sizeof(default_acts) / sizeof(default_acts[0]);
+    for (uint32_t i = 0; i < param.activations.size(); ++i) {
+        if (param.activations[i] != default_acts[i % acts_per_direction]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+RetCode RNNOp::Init(const OptKernelOptions& options) {
+    auto status = GenericLoadParam(options, &param_);
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "load param failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    if (!IsDefaultActivations(*param_) || param_->activation_alpha.size() || param_->activation_beta.size()) {
+        LOG(ERROR) << "RNN only supports default activations(tanh)";
+        return ppl::common::RC_UNSUPPORTED;
+    }
+
+    if (param_->clip != FLT_MAX) {
+        LOG(ERROR) << "RNN does not support clip";
+        return ppl::common::RC_UNSUPPORTED;
+    }
+
+    infer_dims_func_ = [this](InputOutputInfo* info) -> RetCode {
+        return onnx::ReshapeRNN(info, param_.get());
+    };
+
+    infer_type_func_ = GenericInferType;
+
+    return RC_SUCCESS;
+}
+
+KernelImpl* RNNOp::CreateKernelImpl() const {
+    return CreateKernelImplWithParam<RNNKernel>(param_.get());
+}
+
+}}} // namespace ppl::nn::x86
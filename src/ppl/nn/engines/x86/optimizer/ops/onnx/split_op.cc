@@ -58,7 +58,11 @@ RetCode SplitOp::SelectFormat(const InputOutputInfo& info, vector<dataformat_t>*
 }
 
 KernelImpl* SplitOp::CreateKernelImpl() const {
-    return CreateKernelImplWithParam<SplitKernel>(param_.get());
+    auto kernel = CreateKernelImplWithParam<SplitKernel>(param_.get());
+    if (kernel) {
+        kernel->SetInplace(inplace_);
+    }
+    return kernel;
 }
 
 }}} // namespace ppl::nn::x86
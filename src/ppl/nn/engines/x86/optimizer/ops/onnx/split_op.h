@@ -32,8 +32,26 @@ public:
                                       std::vector<ppl::common::dataformat_t>* selected_input_formats,
                                       std::vector<ppl::common::dataformat_t>* selected_output_formats) override;
 
+    void SetInplace(bool inplace) {
+        inplace_ = inplace;
+    }
+    bool IsInplace() const {
+        return inplace_;
+    }
+
+#ifdef PPLNN_ENABLE_PMX_MODEL
+protected:
+    ppl::common::RetCode SerializePrivateData(const pmx::SerializationContext&, utils::DataStream* ds) const override {
+        return WritePod(inplace_, ds);
+    }
+    ppl::common::RetCode DeserializePrivateData(DataReader* reader, X86Device*) override {
+        return reader->ReadPod(&inplace_);
+    }
+#endif
+
 private:
     std::shared_ptr<ppl::nn::onnx::SplitParam> param_;
+    bool inplace_ = false;
 };
 
 }}} // namespace ppl::nn::x86
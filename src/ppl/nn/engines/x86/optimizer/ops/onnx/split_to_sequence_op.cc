@@ -24,15 +24,13 @@ using namespace ppl::common;
 namespace ppl { namespace nn { namespace x86 {
 
 RetCode SplitToSequenceOp::Init(const OptKernelOptions& options) {
-    auto node = GetNode();
-    auto graph_data = options.graph_data;
-    auto attr_ref = graph_data->attrs.find(node->GetId());
-    if (attr_ref == graph_data->attrs.end()) {
-        LOG(ERROR) << "cannot find attr for SplitToSequenceOp[" << node->GetName() << "]";
-        return RC_NOT_FOUND;
+    shared_ptr<ppl::nn::onnx::SplitToSequenceParam> param;
+    auto status = GenericLoadParam(options, &param);
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "cannot find attr for SplitToSequenceOp[" << GetNode()->GetName() << "]";
+        return status;
     }
 
-    auto param = static_cast<ppl::nn::onnx::SplitToSequenceParam*>(attr_ref->second.get());
     op_.Init(param->axis, param->keepdims, onnx::SplitToSequenceOp::GenericSplitFunc);
     return RC_SUCCESS;
 }
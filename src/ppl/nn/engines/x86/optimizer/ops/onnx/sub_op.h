@@ -38,6 +38,16 @@ public:
         return fuse_relu_;
     }
 
+#ifdef PPLNN_ENABLE_PMX_MODEL
+protected:
+    ppl::common::RetCode SerializePrivateData(const pmx::SerializationContext&, utils::DataStream* ds) const override {
+        return WritePod(fuse_relu_, ds);
+    }
+    ppl::common::RetCode DeserializePrivateData(DataReader* reader, X86Device*) override {
+        return reader->ReadPod(&fuse_relu_);
+    }
+#endif
+
 private:
     bool fuse_relu_ = false;
 };
@@ -0,0 +1,49 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/nn/engines/x86/optimizer/ops/pmx/dequantize_op.h"
+#include "ppl/nn/engines/x86/kernels/pmx/dequantize_kernel.h"
+using namespace std;
+using namespace ppl::common;
+
+namespace ppl { namespace nn { namespace x86 {
+
+RetCode DequantizeOp::Init(const OptKernelOptions& options) {
+    infer_dims_func_ = GenericInferDims;
+
+    infer_type_func_ = [](InputOutputInfo* info) -> void {
+        info->GetOutput<TensorImpl>(0)->GetShape()->SetDataType(DATATYPE_FLOAT32);
+    };
+
+    return RC_SUCCESS;
+}
+
+#ifdef PPLNN_ENABLE_PMX_MODEL
+RetCode DequantizeOp::SerializePrivateData(const pmx::SerializationContext&, utils::DataStream* ds) const {
+    return WritePod(param_, ds);
+}
+
+RetCode DequantizeOp::DeserializePrivateData(DataReader* reader, X86Device*) {
+    return reader->ReadPod(&param_);
+}
+#endif
+
+KernelImpl* DequantizeOp::CreateKernelImpl() const {
+    return CreateKernelImplWithParam<DequantizeKernel>(&param_);
+}
+
+}}} // namespace ppl::nn::x86
@@ -0,0 +1,48 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef _ST_HPC_PPL_NN_ENGINES_X86_OPTIMIZER_OPS_PMX_DEQUANTIZE_OP_H_
+#define _ST_HPC_PPL_NN_ENGINES_X86_OPTIMIZER_OPS_PMX_DEQUANTIZE_OP_H_
+
+#include "ppl/nn/engines/x86/params/quantize_param.h"
+#include "ppl/nn/engines/x86/optimizer/opt_kernel.h"
+
+namespace ppl { namespace nn { namespace x86 {
+
+class DequantizeOp final : public X86OptKernel {
+public:
+    DequantizeOp(const ir::Node* node) : X86OptKernel(node) {}
+    ppl::common::RetCode Init(const OptKernelOptions& options) override;
+    KernelImpl* CreateKernelImpl() const override;
+
+    void SetQuantParam(const QuantizeParam& param) {
+        param_ = param;
+    }
+
+#ifdef PPLNN_ENABLE_PMX_MODEL
+protected:
+    ppl::common::RetCode SerializePrivateData(const pmx::SerializationContext&, utils::DataStream*) const override;
+    ppl::common::RetCode DeserializePrivateData(DataReader*, X86Device*) override;
+#endif
+
+private:
+    QuantizeParam param_;
+};
+
+}}} // namespace ppl::nn::x86
+
+#endif
@@ -0,0 +1,63 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/nn/engines/x86/optimizer/ops/pmx/fused_elementwise_op.h"
+#include "ppl/nn/engines/x86/kernels/pmx/fused_elementwise_kernel.h"
+#include "ppl/nn/oputils/onnx/reshape_sum.h"
+using namespace std;
+using namespace ppl::common;
+
+namespace ppl { namespace nn { namespace x86 {
+
+RetCode FusedElementwiseOp::Init(const OptKernelOptions& options) {
+    infer_dims_func_ = [](InputOutputInfo* info) -> RetCode {
+        if (info->GetInputCount() == 1) {
+            return GenericInferDims(info);
+        }
+        return onnx::ReshapeSum(info, nullptr);
+    };
+
+    infer_type_func_ = GenericInferType;
+
+    return RC_SUCCESS;
+}
+
+RetCode FusedElementwiseOp::SelectFormat(const InputOutputInfo& info, vector<dataformat_t>* selected_input_formats,
+                                         vector<dataformat_t>* selected_output_formats) {
+    // output keeps the format of the largest input. others are of the same shape or scalars.
+    uint32_t full_idx = 0;
+    for (uint32_t i = 0; i < info.GetInputCount(); ++i) {
+        auto shape = info.GetInput<TensorImpl>(i)->GetShape();
+        selected_input_formats->at(i) = shape->GetDataFormat();
+        if (shape->GetElementsIncludingPadding() >
+            info.GetInput<TensorImpl>(full_idx)->GetShape()->GetElementsIncludingPadding()) {
+            full_idx = i;
+        }
+    }
+    selected_output_formats->at(0) = info.GetInput<TensorImpl>(full_idx)->GetShape()->GetDataFormat();
+    return RC_SUCCESS;
+}
+
+KernelImpl* FusedElementwiseOp::CreateKernelImpl() const {
+    auto kernel = CreateKernelImplWithoutParam<FusedElementwiseKernel>();
+    if (kernel) {
+        kernel->SetInstructions(&insts_);
+    }
+    return kernel;
+}
+
+}}} // namespace ppl::nn::x86
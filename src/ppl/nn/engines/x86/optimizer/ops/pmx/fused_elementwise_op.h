@@ -0,0 +1,58 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef _ST_HPC_PPL_NN_ENGINES_X86_OPTIMIZER_OPS_PMX_FUSED_ELEMENTWISE_OP_H_
+#define _ST_HPC_PPL_NN_ENGINES_X86_OPTIMIZER_OPS_PMX_FUSED_ELEMENTWISE_OP_H_
+
+#include "ppl/nn/engines/x86/optimizer/opt_kernel.h"
+#include "ppl/kernel/x86/fp32/fused_elementwise.h"
+
+namespace ppl { namespace nn { namespace x86 {
+
+/**
+   @class FusedElementwiseOp
+   @brief a chain of elementwise ops evaluated in one pass. it is created by the FuseElementwiseChain rule.
+*/
+class FusedElementwiseOp final : public X86OptKernel {
+public:
+    FusedElementwiseOp(const ir::Node* node) : X86OptKernel(node) {}
+    ppl::common::RetCode Init(const OptKernelOptions& options) override;
+    KernelImpl* CreateKernelImpl() const override;
+    ppl::common::RetCode SelectFormat(const InputOutputInfo& info,
+                                      std::vector<ppl::common::dataformat_t>* selected_input_formats,
+                                      std::vector<ppl::common::dataformat_t>* selected_output_formats) override;
+    void SetInstructions(std::vector<ppl::kernel::x86::fused_elementwise_inst_t>&& insts) {
+        insts_ = std::move(insts);
+    }
+
+#ifdef PPLNN_ENABLE_PMX_MODEL
+protected:
+    ppl::common::RetCode SerializePrivateData(const pmx::SerializationContext&, utils::DataStream* ds) const override {
+        return WriteVector(insts_, ds);
+    }
+    ppl::common::RetCode DeserializePrivateData(DataReader* reader, X86Device*) override {
+        return reader->ReadVector(&insts_);
+    }
+#endif
+
+private:
+    std::vector<ppl::kernel::x86::fused_elementwise_inst_t> insts_;
+};
+
+}}} // namespace ppl::nn::x86
+
+#endif
@@ -0,0 +1,63 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/nn/engines/x86/optimizer/ops/pmx/multi_head_attention_op.h"
+#include "ppl/nn/engines/x86/kernels/pmx/multi_head_attention_kernel.h"
+#include "ppl/nn/common/logger.h"
+using namespace std;
+using namespace ppl::common;
+
+namespace ppl { namespace nn { namespace x86 {
+
+RetCode MultiHeadAttentionOp::Init(const OptKernelOptions& options) {
+    auto status = GenericLoadParam(options, &param_);
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "load param failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    infer_type_func_ = GenericInferType;
+
+    // query: [batch, seqlen_q, hidden], key/value: [batch, seqlen_kv, hidden], output: [batch, seqlen_q, hidden]
+    auto param = param_.get();
+    infer_dims_func_ = [param](InputOutputInfo* info) -> RetCode {
+        auto& query = *info->GetInput<TensorImpl>(0)->GetShape();
+        auto& key = *info->GetInput<TensorImpl>(1)->GetShape();
+        auto& value = *info->GetInput<TensorImpl>(2)->GetShape();
+        if (query.GetDimCount() != 3 || key.GetDimCount() != 3 || value.GetDimCount() != 3) {
+            LOG(ERROR) << "query, key and value should be 3-D tensors.";
+            return RC_INVALID_VALUE;
+        }
+        if (param->num_heads <= 0 || query.GetDim(2) % param->num_heads != 0) {
+            LOG(ERROR) << "hidden size[" << query.GetDim(2) << "] is not divisible by num_heads["
+                       << param->num_heads << "].";
+            return RC_INVALID_VALUE;
+        }
+
+        auto& output = *info->GetOutput<TensorImpl>(0)->GetShape();
+        output.Reshape(query.GetDims(), query.GetDimCount());
+        return RC_SUCCESS;
+    };
+
+    return RC_SUCCESS;
+}
+
+KernelImpl* MultiHeadAttentionOp::CreateKernelImpl() const {
+    return CreateKernelImplWithParam<MultiHeadAttentionKernel>(param_.get());
+}
+
+}}} // namespace ppl::nn::x86
@@ -17,6 +17,12 @@
 
 #include "ppl/nn/engines/x86/optimizer/ops/pmx/post_depthwise_conv_op.h"
 #include "ppl/nn/engines/x86/kernels/pmx/post_depthwise_conv2d_kernel.h"
+
+#ifdef PPLNN_ENABLE_PMX_MODEL
+#include "ppl/nn/engines/x86/pmx/kernel_param_serializer.h"
+#include "ppl/nn/common/logger.h"
+#endif
+
 using namespace std;
 using namespace ppl::common;
 
@@ -122,6 +128,57 @@ RetCode PostDepthwiseConvOp::SelectFormat(
     return RC_INVALID_VALUE;
 }
 
+#ifdef PPLNN_ENABLE_PMX_MODEL
+RetCode PostDepthwiseConvOp::SerializePrivateData(const pmx::SerializationContext&, utils::DataStream* ds) const {
+    if (!pd_conv2d_param_) {
+        return RC_INVALID_VALUE;
+    }
+
+    WritePod(pd_conv2d_param_->algo_info, ds);
+    auto status = SerializeConv2dParam(*pd_conv2d_param_->conv2d_param, ds);
+    if (status != RC_SUCCESS) {
+        return status;
+    }
+    return SerializeConv2dParam(*pd_conv2d_param_->depthwise_conv2d_param, ds);
+}
+
+RetCode PostDepthwiseConvOp::DeserializePrivateData(DataReader* reader, X86Device* device) {
+    if (!pd_conv2d_param_) {
+        pd_conv2d_param_ = new PostDepthwiseConv2dParam;
+    }
+    if (!pd_conv2d_param_) {
+        return RC_OUT_OF_MEMORY;
+    }
+
+    auto status = reader->ReadPod(&pd_conv2d_param_->algo_info);
+    if (status != RC_SUCCESS) {
+        return status;
+    }
+
+    pd_conv2d_param_->conv2d_param = new Conv2dParam;
+    pd_conv2d_param_->depthwise_conv2d_param = new Conv2dParam;
+
+    status = DeserializeConv2dParam(reader, device->GetAllocator(), pd_conv2d_param_->conv2d_param);
+    if (status != RC_SUCCESS) {
+        return status;
+    }
+    status = DeserializeConv2dParam(reader, device->GetAllocator(), pd_conv2d_param_->depthwise_conv2d_param);
+    if (status != RC_SUCCESS) {
+        return status;
+    }
+
+    pd_conv2d_param_->mgr = ppl::kernel::x86::pd_conv2d_algo_selector::gen_algo(
+        pd_conv2d_param_->algo_info, pd_conv2d_param_->conv2d_param->mgr,
+        pd_conv2d_param_->depthwise_conv2d_param->mgr);
+    if (!pd_conv2d_param_->mgr) {
+        LOG(ERROR) << "create post depthwise conv2d manager failed.";
+        return RC_UNSUPPORTED;
+    }
+
+    return RC_SUCCESS;
+}
+#endif
+
 KernelImpl* PostDepthwiseConvOp::CreateKernelImpl() const {
     if (pd_conv2d_param_ && pd_conv2d_param_->algo_info.algo_type != ppl::kernel::x86::conv2d_fp32_algo::UNKNOWN) {
         return CreateKernelImplWithParam<PostDepthwiseConv2dKernel>(pd_conv2d_param_);
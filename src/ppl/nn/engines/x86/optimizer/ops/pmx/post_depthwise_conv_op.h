@@ -26,7 +26,7 @@ namespace ppl { namespace nn { namespace x86 {
 
 class PostDepthwiseConvOp final : public X86OptKernel {
 public:
-    PostDepthwiseConvOp(const ir::Node* node) : X86OptKernel(node) {}
+    PostDepthwiseConvOp(const ir::Node* node) : X86OptKernel(node), pd_conv2d_param_(nullptr) {}
     ~PostDepthwiseConvOp();
     ppl::common::RetCode Init(const OptKernelOptions& options) override;
     KernelImpl* CreateKernelImpl() const override;
@@ -41,6 +41,12 @@ public:
     static PostDepthwiseConv2dParam* TryMakePostDepthwiseConv2dParam(
         ConvOp *conv_op, ConvOp *post_conv_op);
 
+#ifdef PPLNN_ENABLE_PMX_MODEL
+protected:
+    ppl::common::RetCode SerializePrivateData(const pmx::SerializationContext&, utils::DataStream*) const override;
+    ppl::common::RetCode DeserializePrivateData(DataReader*, X86Device*) override;
+#endif
+
 private:
     PostDepthwiseConv2dParam *pd_conv2d_param_;
 };
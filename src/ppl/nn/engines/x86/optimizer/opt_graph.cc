@@ -191,7 +191,9 @@ RetCode OptGraph::TryToInferDims(X86Device* device) {
     return RC_SUCCESS;
 }
 
-RetCode OptGraph::DoOptimize(const utils::SharedResource& resource, X86Device* device) {
+RetCode OptGraph::DoOptimize(const utils::SharedResource& resource, X86Device* device,
+                             const EngineOptions& engine_options, AlgoTuningCache* algo_cache,
+                             const QuantParamInfo* quant_info) {
     OptKernelOptions options;
     options.resource = &resource;
     options.graph_data = graph_->data.get();
@@ -199,6 +201,11 @@ RetCode OptGraph::DoOptimize(const utils::SharedResource& resource, X86Device* d
     options.tensors = &tensor_impls_;
     options.device = device;
     options.info = info_;
+    options.engine_options = &engine_options;
+    options.algo_cache = algo_cache;
+    if (quant_info && !quant_info->tensor_params.empty()) {
+        options.quant_info = quant_info;
+    }
 
     for (auto it = info_->kernels.begin(); it != info_->kernels.end(); ++it) {
         auto kernel = (X86OptKernel*)(it->second.get());
@@ -245,6 +252,28 @@ RetCode OptGraph::DoOptimize(const utils::SharedResource& resource, X86Device* d
 
     opt_rule_manager->ApplyByTag("AfterLayoutOptimize", options);
 
+    // applied after specific fusions(Swish, conv + activation, ...) which have dedicated kernels
+    opt_rule_manager->Apply("", "FuseElementwiseChain", options);
+
+    if (options.quant_info) {
+        if (true != opt_rule_manager->Apply("", "QuantizeOptimize", options)) {
+            LOG(ERROR) << "QuantizeOptimize failed";
+            return ppl::common::RC_OTHER_ERROR;
+        }
+    }
+
+    // bfloat16 ops are selected in Init() and LayoutOptimize. Cast ops are inserted after fusions so that they
+    // do not block conv/fc + activation patterns.
+    if (IsBf16Enabled(options)) {
+        if (true != opt_rule_manager->Apply("", "PrecisionOptimize", options)) {
+            LOG(ERROR) << "PrecisionOptimize failed";
+            return ppl::common::RC_OTHER_ERROR;
+        }
+    }
+
+    // done after all rules which may change the graph, so that in-place Concat/Split ops are not invalidated
+    opt_rule_manager->Apply("", "InplaceConcatSplit", options);
+
 #ifdef SHOW_GRAPH_VIS
     std::string vis = utils::ToGraphviz(graph_->topo.get());
     std::ofstream out_file("./graph.dot");
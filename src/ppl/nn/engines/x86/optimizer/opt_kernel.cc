@@ -17,6 +17,13 @@
 
 #include "ppl/nn/engines/x86/optimizer/opt_kernel.h"
 #include "ppl/common/sys.h"
+
+#ifdef PPLNN_ENABLE_PMX_MODEL
+#include "ppl/nn/engines/x86/pmx/op_param_serializer.h"
+#include "ppl/nn/utils/buffer_data_stream.h"
+#include "ppl/nn/common/logger.h"
+#endif
+
 using namespace std;
 using namespace ppl::common;
 
@@ -26,4 +33,95 @@ X86OptKernel::X86OptKernel(const ir::Node* node) : OptKernel(node) {
     common_param_.output_formats.resize(node->GetOutputCount(), DATAFORMAT_NDARRAY);
 }
 
+#ifdef PPLNN_ENABLE_PMX_MODEL
+/*
+  layout of op data: a `pmx::onnx::OpParam` whose `value` is the onnx param(if any) and `data_` contains:
+    - private param(params which are not in `pmx::onnx::OpParamType`)
+    - output formats
+    - data written by SerializePrivateData()
+*/
+RetCode X86OptKernel::SerializeData(const pmx::SerializationContext& ctx, utils::DataStream* ds) const {
+    flatbuffers::FlatBufferBuilder builder;
+    utils::BufferDataStream private_data;
+
+    auto fb_type = pmx::onnx::OpParamType_NONE;
+    flatbuffers::Offset<void> fb_value;
+    auto status = SerializeOpParam(ctx, loaded_param_.get(), &builder, &fb_type, &fb_value, &private_data);
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "serialize param of op[" << GetNode()->GetName() << "] failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    status = WriteVector(common_param_.output_formats, &private_data);
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "write output formats of op[" << GetNode()->GetName() << "] failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    status = SerializePrivateData(ctx, &private_data);
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "serialize private data of op[" << GetNode()->GetName() << "] failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    auto fb_data = builder.CreateVector<uint8_t>((const uint8_t*)private_data.GetData(), private_data.GetSize());
+    auto fb_op_param = pmx::onnx::CreateOpParam(builder, fb_type, fb_value, fb_data);
+    pmx::onnx::FinishOpParamBuffer(builder, fb_op_param);
+    return ds->Write(builder.GetBufferPointer(), builder.GetSize());
+}
+
+RetCode X86OptKernel::DeserializeData(const pmx::DeserializationContext&, const void* base, uint64_t size) {
+    auto node = GetNode();
+
+    flatbuffers::Verifier verifier((const uint8_t*)base, size);
+    if (!pmx::onnx::VerifyOpParamBuffer(verifier)) {
+        LOG(ERROR) << "verify data of op[" << node->GetName() << "] failed.";
+        return RC_INVALID_VALUE;
+    }
+
+    auto fb_op_param = pmx::onnx::GetOpParam(base);
+    auto fb_data = fb_op_param->data_();
+    DataReader reader(fb_data ? fb_data->data() : nullptr, fb_data ? fb_data->size() : 0);
+
+    shared_ptr<ir::Attr> param;
+    auto status = DeserializeOpParam(*fb_op_param, &reader, &param);
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "deserialize param of op[" << node->GetName() << "] failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    // constants and shapes are not available. ops should not rely on them when initializing.
+    ir::GraphData graph_data;
+    if (param) {
+        graph_data.attrs.insert(make_pair(node->GetId(), param));
+    }
+
+    OptKernelOptions options;
+    options.graph_data = &graph_data;
+    options.device = device_;
+
+    status = Init(options);
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "init op[" << node->GetName() << "] failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    vector<dataformat_t> output_formats;
+    status = reader.ReadVector(&output_formats);
+    if (status != RC_SUCCESS || output_formats.size() != node->GetOutputCount()) {
+        LOG(ERROR) << "read output formats of op[" << node->GetName() << "] failed.";
+        return RC_INVALID_VALUE;
+    }
+    common_param_.output_formats = std::move(output_formats);
+
+    status = DeserializePrivateData(&reader, device_);
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "deserialize private data of op[" << node->GetName() << "] failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    return RC_SUCCESS;
+}
+#endif
+
 }}} // namespace ppl::nn::x86
@@ -22,15 +22,26 @@
 #include "ppl/nn/runtime/tensor_impl.h"
 #include "ppl/nn/engines/x86/x86_device.h"
 #include "ppl/nn/engines/x86/x86_common_param.h"
+#include "ppl/nn/engines/x86/engine_options.h"
 #include "ppl/nn/runtime/runtime_partition_info.h"
 #include <functional>
 
+#ifdef PPLNN_ENABLE_PMX_MODEL
+#include "ppl/nn/engines/x86/pmx/serialization_utils.h"
+#endif
+
+namespace ppl { namespace nn {
+struct QuantParamInfo;
+}} // namespace ppl::nn
+
 namespace ppl { namespace nn { namespace utils {
 struct SharedResource;
 }}} // namespace ppl::nn::utils
 
 namespace ppl { namespace nn { namespace x86 {
 
+class AlgoTuningCache;
+
 struct OptKernelOptions final {
     const utils::SharedResource* resource = nullptr;
     ir::GraphData* graph_data = nullptr;
@@ -38,8 +49,18 @@ struct OptKernelOptions final {
     X86Device* device = nullptr;
     RuntimePartitionInfo* info = nullptr;
     std::map<edgeid_t, std::unique_ptr<TensorImpl>>* tensors = nullptr;
+    const EngineOptions* engine_options = nullptr;
+    AlgoTuningCache* algo_cache = nullptr;
+    /** not null only if quantization info is set */
+    const QuantParamInfo* quant_info = nullptr;
 };
 
+/** @brief returns true if convs and fcs are allowed to run in bfloat16 */
+inline bool IsBf16Enabled(const OptKernelOptions& options) {
+    return (options.engine_options && options.engine_options->forward_precision == ppl::common::DATATYPE_BFLOAT16 &&
+            (options.device->GetISA() & ppl::common::ISA_X86_AVX512));
+}
+
 class X86OptKernel : public OptKernel {
 public:
     X86OptKernel(const ir::Node* node);
@@ -79,17 +100,33 @@ public:
     }
 
 #ifdef PPLNN_ENABLE_PMX_MODEL
-    ppl::common::RetCode SerializeData(const pmx::SerializationContext&, utils::DataStream*) const override {
-        return ppl::common::RC_UNSUPPORTED;
+    /**
+       @brief saves the param, output formats and data generated by SelectAlgorithm()/fusions(packed weights, for
+       example) so that they can be restored without optimizing again.
+    */
+    ppl::common::RetCode SerializeData(const pmx::SerializationContext&, utils::DataStream*) const override;
+    ppl::common::RetCode DeserializeData(const pmx::DeserializationContext&, const void*, uint64_t) override;
+
+    /** @brief device used to restore device-dependent data in DeserializeData() */
+    void SetDevice(X86Device* device) {
+        device_ = device;
+    }
+
+protected:
+    /** @brief saves data which cannot be derived from the param. called at the end of SerializeData(). */
+    virtual ppl::common::RetCode SerializePrivateData(const pmx::SerializationContext&, utils::DataStream*) const {
+        return ppl::common::RC_SUCCESS;
     }
-    ppl::common::RetCode DeserializeData(const pmx::DeserializationContext&, const void*, uint64_t) override {
-        return ppl::common::RC_UNSUPPORTED;
+
+    /** @brief reverse operation of SerializePrivateData(). called after Init() in DeserializeData(). */
+    virtual ppl::common::RetCode DeserializePrivateData(DataReader*, X86Device*) {
+        return ppl::common::RC_SUCCESS;
     }
 #endif
 
 protected:
     template <typename T>
-    ppl::common::RetCode GenericLoadParam(const OptKernelOptions& options, std::shared_ptr<T>* param) const {
+    ppl::common::RetCode GenericLoadParam(const OptKernelOptions& options, std::shared_ptr<T>* param) {
         auto node = GetNode();
         auto graph_data = options.graph_data;
 
@@ -98,6 +135,7 @@ protected:
             return ppl::common::RC_NOT_FOUND;
         }
 
+        loaded_param_ = param_ref->second;
         *param = std::static_pointer_cast<T>(param_ref->second);
         return ppl::common::RC_SUCCESS;
     }
@@ -156,6 +194,14 @@ protected:
     std::function<void(InputOutputInfo*)> infer_type_func_;
     std::function<ppl::common::RetCode(InputOutputInfo*)> infer_dims_func_;
     X86CommonParam common_param_;
+
+    /** param loaded by GenericLoadParam(), which is used to serialize this op */
+    std::shared_ptr<ir::Attr> loaded_param_;
+
+#ifdef PPLNN_ENABLE_PMX_MODEL
+private:
+    X86Device* device_ = nullptr;
+#endif
 };
 
 }}} // namespace ppl::nn::x86
@@ -26,7 +26,14 @@
 #include "ppl/nn/engines/x86/optimizer/rules/fuse_batch_normalization_relu.h"
 #include "ppl/nn/engines/x86/optimizer/rules/fuse_channel_shuffle.h"
 #include "ppl/nn/engines/x86/optimizer/rules/fuse_swish.h"
+#include "ppl/nn/engines/x86/optimizer/rules/fuse_elementwise_chain.h"
+#include "ppl/nn/engines/x86/optimizer/rules/fuse_layer_norm.h"
+#include "ppl/nn/engines/x86/optimizer/rules/fuse_gelu.h"
+#include "ppl/nn/engines/x86/optimizer/rules/fuse_multi_head_attention.h"
 #include "ppl/nn/engines/x86/optimizer/rules/layout_optimize.h"
+#include "ppl/nn/engines/x86/optimizer/rules/quantize_optimize.h"
+#include "ppl/nn/engines/x86/optimizer/rules/precision_optimize.h"
+#include "ppl/nn/engines/x86/optimizer/rules/inplace_concat_split.h"
 
 namespace ppl { namespace nn { namespace x86 {
 
@@ -89,8 +96,15 @@ OptRuleManager::~OptRuleManager() {
 
 OptRuleManager::OptRuleManager() {
     REGISTER_OPT_RULE("", "LayoutOptimize", LayoutOptimize);
+    REGISTER_OPT_RULE("", "QuantizeOptimize", QuantizeOptimize);
+    REGISTER_OPT_RULE("", "PrecisionOptimize", PrecisionOptimize);
+    REGISTER_OPT_RULE("", "InplaceConcatSplit", InplaceConcatSplit);
+    REGISTER_OPT_RULE("", "FuseElementwiseChain", FuseElementwiseChain);
 
     REGISTER_OPT_RULE("BeforeLayoutOptimize", "FuseChannelShuffle", FuseChannelShuffle);
+    REGISTER_OPT_RULE("BeforeLayoutOptimize", "FuseLayerNorm", FuseLayerNorm);
+    REGISTER_OPT_RULE("BeforeLayoutOptimize", "FuseGELU", FuseGELU);
+    REGISTER_OPT_RULE("BeforeLayoutOptimize", "FuseMultiHeadAttention", FuseMultiHeadAttention);
 
     REGISTER_OPT_RULE("AfterLayoutOptimize", "FuseConvActivation", FuseConvActivation);
     REGISTER_OPT_RULE("AfterLayoutOptimize", "FuseConvEltwise", FuseConvEltwise);
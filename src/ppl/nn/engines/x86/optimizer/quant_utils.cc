@@ -0,0 +1,113 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/nn/engines/x86/optimizer/quant_utils.h"
+#include "ppl/nn/common/logger.h"
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+using namespace std;
+
+namespace ppl { namespace nn { namespace x86 {
+
+/*
+  QuantParamParser saves json integers as int64 and floating numbers as double, both of which are 8 bytes.
+  bit patterns of normal doubles are larger than 2^52 when interpreted as int64, while integers in quantization
+  files are far less than that.
+*/
+static bool GetNumberField(const QuantParam& param, const char* key, double* value) {
+    auto ref = param.fields.find(key);
+    if (ref == param.fields.end() || ref->second.content.size() != sizeof(int64_t)) {
+        return false;
+    }
+
+    int64_t i64;
+    memcpy(&i64, ref->second.content.data(), sizeof(i64));
+    if (i64 > -(1LL << 52) && i64 < (1LL << 52)) {
+        *value = (double)i64;
+    } else {
+        memcpy(value, ref->second.content.data(), sizeof(double));
+    }
+    return true;
+}
+
+bool FindTensorQuantParam(const QuantParamInfo* info, const string& name, QuantizeParam* param) {
+    if (!info) {
+        return false;
+    }
+
+    auto ref = info->tensor_params.find(name);
+    if (ref == info->tensor_params.end()) {
+        return false;
+    }
+    auto& fields = ref->second.fields;
+
+    auto per_channel_ref = fields.find("per_channel");
+    if (per_channel_ref != fields.end() && per_channel_ref->second.content.size() == sizeof(bool) &&
+        *(const bool*)per_channel_ref->second.content.data()) {
+        return false;
+    }
+
+    double bit_width = 8;
+    if (GetNumberField(ref->second, "bit_width", &bit_width) && bit_width != 8) {
+        return false;
+    }
+
+    double tensor_max, tensor_min;
+    if (GetNumberField(ref->second, "tensor_max", &tensor_max) &&
+        GetNumberField(ref->second, "tensor_min", &tensor_min)) {
+        // zero must be representable so that paddings are exact
+        tensor_max = std::max(tensor_max, 0.0);
+        tensor_min = std::min(tensor_min, 0.0);
+        if (tensor_max - tensor_min < 1e-12) {
+            return false;
+        }
+        param->scale = (float)((tensor_max - tensor_min) / 255.0);
+        param->zero_point = std::min(std::max((int32_t)lround(-tensor_min / param->scale), 0), 255);
+        return true;
+    }
+
+    double scale, zero_point;
+    if (GetNumberField(ref->second, "scale", &scale) && GetNumberField(ref->second, "zero_point", &zero_point)) {
+        if (scale <= 0 || zero_point < 0 || zero_point > 255) {
+            LOG(WARNING) << "invalid uint8 quant param of tensor[" << name << "]: scale[" << scale << "], zero_point["
+                         << zero_point << "]";
+            return false;
+        }
+        param->scale = (float)scale;
+        param->zero_point = (int32_t)lround(zero_point);
+        return true;
+    }
+
+    return false;
+}
+
+bool IsNodeQuantEnabled(const QuantParamInfo* info, const string& name) {
+    if (!info) {
+        return false;
+    }
+
+    auto ref = info->node_params.find(name);
+    if (ref == info->node_params.end()) {
+        return true;
+    }
+
+    auto data_type_ref = ref->second.fields.find("data_type");
+    return (data_type_ref == ref->second.fields.end() || data_type_ref->second.content != "FLOAT32");
+}
+
+}}} // namespace ppl::nn::x86
@@ -0,0 +1,38 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef _ST_HPC_PPL_NN_ENGINES_X86_OPTIMIZER_QUANT_UTILS_H_
+#define _ST_HPC_PPL_NN_ENGINES_X86_OPTIMIZER_QUANT_UTILS_H_
+
+#include "ppl/nn/quantization/quant_param_info.h"
+#include "ppl/nn/engines/x86/params/quantize_param.h"
+
+namespace ppl { namespace nn { namespace x86 {
+
+/**
+   @brief gets the uint8 quantization param of tensor `name` from its `tensor_max` and `tensor_min`(or `scale` and
+   `zero_point` if they are not present).
+   @return false if `name` is not found or is not quantized per tensor in 8 bits.
+*/
+bool FindTensorQuantParam(const QuantParamInfo* info, const std::string& name, QuantizeParam* param);
+
+/** @brief returns false if node `name` is forced to run in float32 by its `data_type`. */
+bool IsNodeQuantEnabled(const QuantParamInfo* info, const std::string& name);
+
+}}} // namespace ppl::nn::x86
+
+#endif
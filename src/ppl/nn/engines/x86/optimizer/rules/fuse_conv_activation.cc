@@ -18,6 +18,7 @@
 #include "ppl/nn/engines/x86/optimizer/rules/fuse_conv_activation.h"
 #include "ppl/nn/engines/x86/optimizer/rules/utils.h"
 #include "ppl/nn/engines/x86/optimizer/ops/onnx/conv_op.h"
+#include "ppl/nn/engines/x86/optimizer/ops/onnx/convtranspose_op.h"
 #include "ppl/nn/params/onnx/clip_param.h"
 
 namespace ppl { namespace nn { namespace x86 {
@@ -66,6 +67,16 @@ static bool IsReLU6(const ir::GraphData* graph_data, const ir::Node* clip_node)
     return false;
 }
 
+// sets fuse flag to conv_op or convtranspose_op
+static bool TryFuseActivation(OptKernel* kernel, bool is_conv_transpose, bool is_relu6) {
+    if (is_conv_transpose) {
+        auto op = static_cast<ConvTransposeOp*>(kernel);
+        return is_relu6 ? op->TryFuseReLU6() : op->TryFuseReLU();
+    }
+    auto op = static_cast<ConvOp*>(kernel);
+    return is_relu6 ? op->TryFuseReLU6() : op->TryFuseReLU();
+}
+
 bool FuseConvActivation(const OptKernelOptions& options) {
     bool graphchanged = false;
     auto graph_topo = options.graph_topo;
@@ -75,7 +86,8 @@ bool FuseConvActivation(const OptKernelOptions& options) {
 
     for (auto it = graph_topo->CreateNodeIter(); it->IsValid(); it->Forward()) {
         auto node = it->Get();
-        if (node->GetType().domain == "" && node->GetType().name == "Conv") {
+        const bool is_conv_transpose = (node->GetType().name == "ConvTranspose");
+        if (node->GetType().domain == "" && (node->GetType().name == "Conv" || is_conv_transpose)) {
             auto conv_node = node;
             auto conv_output_edge_id = conv_node->GetOutput(0);
             auto conv_output_edge = graph_topo->GetEdge(conv_output_edge_id);
@@ -92,13 +104,13 @@ bool FuseConvActivation(const OptKernelOptions& options) {
                 continue;
             }
 
-            auto conv_kernel = static_cast<ConvOp*>(info->kernels[conv_node->GetId()].get());
+            auto conv_kernel = info->kernels[conv_node->GetId()].get();
             if (successor_node->GetType().name == "Relu") {
-                if (!conv_kernel->TryFuseReLU()) { // set fuse flag to conv_op
+                if (!TryFuseActivation(conv_kernel, is_conv_transpose, false)) {
                     continue;
                 }
             } else if (IsReLU6(graph_data, successor_node)) {
-                if (!conv_kernel->TryFuseReLU6()) { // set fuse flag to conv_op
+                if (!TryFuseActivation(conv_kernel, is_conv_transpose, true)) {
                     continue;
                 }
                 // remove relu6's input min/max's connect in advance
@@ -0,0 +1,398 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/nn/engines/x86/optimizer/rules/fuse_elementwise_chain.h"
+#include "ppl/nn/engines/x86/optimizer/rules/utils.h"
+#include "ppl/nn/engines/x86/optimizer/ops/onnx/add_op.h"
+#include "ppl/nn/engines/x86/optimizer/ops/onnx/sub_op.h"
+#include "ppl/nn/engines/x86/optimizer/ops/onnx/mul_op.h"
+#include "ppl/nn/engines/x86/optimizer/ops/onnx/div_op.h"
+#include "ppl/nn/engines/x86/optimizer/ops/pmx/fused_elementwise_op.h"
+#include "ppl/nn/engines/x86/utils.h"
+#include "ppl/nn/common/logger.h"
+#include <limits>
+using namespace std;
+using namespace ppl::common;
+using namespace ppl::kernel::x86;
+
+namespace ppl { namespace nn { namespace x86 {
+
+// intermediate results take at most (MAX_FUSED_INSTS - 1) tiles of 2KB, which fit in a 32KB L1 cache
+static const uint32_t MAX_FUSED_INSTS = 16;
+static const uint32_t MAX_FUSED_INPUTS = 16;
+static const uint32_t INVALID_TOPO_IDX = numeric_limits<uint32_t>::max();
+
+// returns false if `node` cannot be fused
+static bool GetOpcode(const ir::Node* node, X86OptKernel* kernel, int32_t* opcode, bool* fuse_relu) {
+    static const map<string, int32_t> opcodes = {
+        {"Add", FUSED_ELEMENTWISE_ADD},    {"Sub", FUSED_ELEMENTWISE_SUB},
+        {"Mul", FUSED_ELEMENTWISE_MUL},    {"Div", FUSED_ELEMENTWISE_DIV},
+        {"Max", FUSED_ELEMENTWISE_MAX},    {"Min", FUSED_ELEMENTWISE_MIN},
+        {"Relu", FUSED_ELEMENTWISE_RELU},  {"Sigmoid", FUSED_ELEMENTWISE_SIGMOID},
+        {"Tanh", FUSED_ELEMENTWISE_TANH},  {"Exp", FUSED_ELEMENTWISE_EXP},
+        {"Erf", FUSED_ELEMENTWISE_ERF},    {"Abs", FUSED_ELEMENTWISE_ABS},
+        {"Neg", FUSED_ELEMENTWISE_NEG},    {"Sqrt", FUSED_ELEMENTWISE_SQRT},
+    };
+
+    auto& type = node->GetType();
+    if (type.domain != "" || node->GetOutputCount() != 1) {
+        return false;
+    }
+    auto ref = opcodes.find(type.name);
+    if (ref == opcodes.end()) {
+        return false;
+    }
+    if (node->GetInputCount() != (fused_elementwise_is_binary(ref->second) ? 2u : 1u)) {
+        return false;
+    }
+
+    *opcode = ref->second;
+    *fuse_relu = false;
+    if (type.name == "Add") {
+        *fuse_relu = static_cast<AddOp*>(kernel)->HasFuseReLU();
+    } else if (type.name == "Sub") {
+        *fuse_relu = static_cast<SubOp*>(kernel)->HasFuseReLU();
+    } else if (type.name == "Mul") {
+        *fuse_relu = static_cast<MulOp*>(kernel)->HasFuseReLU();
+    } else if (type.name == "Div") {
+        *fuse_relu = static_cast<DivOp*>(kernel)->HasFuseReLU();
+    }
+    return true;
+}
+
+namespace {
+
+struct FusionGroup final {
+    vector<ir::Node*> nodes;
+    vector<int32_t> opcodes;
+    vector<bool> fuse_relu;
+    uint32_t inst_count = 0;
+};
+
+class ChainBuilder final {
+public:
+    ChainBuilder(const OptKernelOptions& options) : options_(options) {}
+
+    void Init() {
+        auto topo = options_.graph_topo;
+        topo_idx_.assign(topo->GetCurrentNodeIdBound(), INVALID_TOPO_IDX);
+        sorted_nodes_.clear();
+        topo->TopologicalSort([this](nodeid_t nid) -> void {
+            topo_idx_[nid] = sorted_nodes_.size();
+            sorted_nodes_.push_back(nid);
+        });
+        visited_.assign(topo_idx_.size(), false);
+    }
+
+    const vector<nodeid_t>& GetSortedNodes() const {
+        return sorted_nodes_;
+    }
+
+    /** @brief grows a group from `seed`. returns false if no more than one node can be fused. */
+    bool Grow(ir::Node* seed, FusionGroup* group);
+
+private:
+    const TensorShape* GetShape(edgeid_t eid) const {
+        auto ref = options_.tensors->find(eid);
+        return (ref == options_.tensors->end()) ? nullptr : ref->second->GetShape();
+    }
+
+    bool IsFusable(ir::Node* node, const TensorShape& output_shape, int32_t* opcode, bool* fuse_relu) const;
+    bool IsValidInput(edgeid_t eid, const TensorShape& output_shape, const set<ir::Node*>& members,
+                      uint32_t min_topo_idx) const;
+    edgeid_t FindOnlyEscapingEdge(const vector<ir::Node*>& nodes, const set<ir::Node*>& members) const;
+
+private:
+    const OptKernelOptions& options_;
+    vector<nodeid_t> sorted_nodes_;
+    vector<uint32_t> topo_idx_;
+    vector<bool> visited_;
+};
+
+} // namespace
+
+bool ChainBuilder::IsFusable(ir::Node* node, const TensorShape& output_shape, int32_t* opcode,
+                             bool* fuse_relu) const {
+    if (node->GetId() >= visited_.size() || visited_[node->GetId()]) {
+        return false;
+    }
+    auto ref = options_.info->kernels.find(node->GetId());
+    if (ref == options_.info->kernels.end()) {
+        return false;
+    }
+    if (!GetOpcode(node, static_cast<X86OptKernel*>(ref->second.get()), opcode, fuse_relu)) {
+        return false;
+    }
+
+    auto shape = GetShape(node->GetOutput(0));
+    return (shape && shape->GetDataType() == DATATYPE_FLOAT32 && TensorShapeEqual(*shape, output_shape));
+}
+
+// inputs from outside of the group are either of the same shape as the output or scalar constants
+bool ChainBuilder::IsValidInput(edgeid_t eid, const TensorShape& output_shape, const set<ir::Node*>& members,
+                                uint32_t min_topo_idx) const {
+    auto edge = options_.graph_topo->GetEdge(eid);
+    if (!edge) {
+        return false;
+    }
+    auto producer = options_.graph_topo->GetNode(edge->GetProducer());
+    if (producer && members.find(producer) != members.end()) {
+        return true;
+    }
+    // producers of inputs must run before the group, otherwise the fused node will introduce a cycle
+    if (producer && topo_idx_[producer->GetId()] >= min_topo_idx) {
+        return false;
+    }
+
+    auto shape = GetShape(eid);
+    if (!shape || shape->GetDataType() != DATATYPE_FLOAT32) {
+        return false;
+    }
+    if (TensorShapeEqual(*shape, output_shape)) {
+        return true;
+    }
+    return (shape->GetElementsIncludingPadding() == 1 &&
+            options_.graph_data->constants.find(eid) != options_.graph_data->constants.end());
+}
+
+// returns the only output edge which is used outside of `nodes`, or INVALID_EDGEID
+edgeid_t ChainBuilder::FindOnlyEscapingEdge(const vector<ir::Node*>& nodes, const set<ir::Node*>& members) const {
+    auto topo = options_.graph_topo;
+    edgeid_t escaping_eid = INVALID_EDGEID;
+    for (auto n = nodes.begin(); n != nodes.end(); ++n) {
+        auto eid = (*n)->GetOutput(0);
+        auto edge = topo->GetEdge(eid);
+
+        bool escaping = IsReservedEdge(*options_.tensors, eid) || edge->CalcConsumerCount() == 0;
+        for (auto it = edge->CreateConsumerIter(); !escaping && it.IsValid(); it.Forward()) {
+            if (members.find(topo->GetNode(it.Get())) == members.end()) {
+                escaping = true;
+            }
+        }
+
+        if (escaping) {
+            if (escaping_eid != INVALID_EDGEID) {
+                return INVALID_EDGEID;
+            }
+            escaping_eid = eid;
+        }
+    }
+    return escaping_eid;
+}
+
+bool ChainBuilder::Grow(ir::Node* seed, FusionGroup* group) {
+    auto topo = options_.graph_topo;
+
+    int32_t opcode;
+    bool fuse_relu;
+    auto seed_shape = GetShape(seed->GetOutput(0));
+    if (!seed_shape || !IsFusable(seed, *seed_shape, &opcode, &fuse_relu)) {
+        return false;
+    }
+    const TensorShape output_shape = *seed_shape;
+    const uint32_t min_topo_idx = topo_idx_[seed->GetId()];
+
+    vector<ir::Node*> nodes;
+    vector<int32_t> opcodes;
+    vector<bool> fuse_relus;
+    set<ir::Node*> members;
+    set<edgeid_t> inputs;
+    uint32_t inst_count = 0;
+
+    auto try_add = [&](ir::Node* node, int32_t op, bool relu) -> bool {
+        set<edgeid_t> new_inputs = inputs;
+        for (uint32_t i = 0; i < node->GetInputCount(); ++i) {
+            auto eid = node->GetInput(i);
+            if (!IsValidInput(eid, output_shape, members, min_topo_idx)) {
+                return false;
+            }
+            auto producer = topo->GetNode(topo->GetEdge(eid)->GetProducer());
+            if (!producer || members.find(producer) == members.end()) {
+                new_inputs.insert(eid);
+            }
+        }
+        uint32_t new_inst_count = inst_count + (relu ? 2 : 1);
+        if (new_inputs.size() > MAX_FUSED_INPUTS || new_inst_count > MAX_FUSED_INSTS) {
+            return false;
+        }
+
+        nodes.push_back(node);
+        opcodes.push_back(op);
+        fuse_relus.push_back(relu);
+        members.insert(node);
+        inputs.swap(new_inputs);
+        inst_count = new_inst_count;
+        return true;
+    };
+
+    if (!try_add(seed, opcode, fuse_relu)) {
+        return false;
+    }
+
+    uint32_t valid_count = 0, valid_inst_count = 0;
+    while (true) {
+        // a group is valid if only the output of its last node is used outside
+        if (nodes.size() > 1 && FindOnlyEscapingEdge(nodes, members) == nodes.back()->GetOutput(0)) {
+            valid_count = nodes.size();
+            valid_inst_count = inst_count;
+        }
+
+        // picks the earliest consumer of the group which can be fused
+        ir::Node* next = nullptr;
+        int32_t next_opcode = 0;
+        bool next_fuse_relu = false;
+        for (auto n = nodes.begin(); n != nodes.end(); ++n) {
+            auto edge = topo->GetEdge((*n)->GetOutput(0));
+            for (auto it = edge->CreateConsumerIter(); it.IsValid(); it.Forward()) {
+                auto consumer = topo->GetNode(it.Get());
+                if (!consumer || members.find(consumer) != members.end()) {
+                    continue;
+                }
+                if (next && topo_idx_[consumer->GetId()] >= topo_idx_[next->GetId()]) {
+                    continue;
+                }
+                int32_t op;
+                bool relu;
+                if (IsFusable(consumer, output_shape, &op, &relu)) {
+                    next = consumer;
+                    next_opcode = op;
+                    next_fuse_relu = relu;
+                }
+            }
+        }
+
+        if (!next || !try_add(next, next_opcode, next_fuse_relu)) {
+            break;
+        }
+    }
+
+    if (valid_count < 2) {
+        return false;
+    }
+
+    group->nodes.assign(nodes.begin(), nodes.begin() + valid_count);
+    group->opcodes.assign(opcodes.begin(), opcodes.begin() + valid_count);
+    group->fuse_relu.assign(fuse_relus.begin(), fuse_relus.begin() + valid_count);
+    group->inst_count = valid_inst_count;
+    for (auto n = group->nodes.begin(); n != group->nodes.end(); ++n) {
+        visited_[(*n)->GetId()] = true;
+    }
+    return true;
+}
+
+static RetCode FuseGroup(const OptKernelOptions& options, FusionGroup* group) {
+    auto topo = options.graph_topo;
+    auto& tensors = *options.tensors;
+
+    set<ir::Node*> members(group->nodes.begin(), group->nodes.end());
+
+    // values of inputs come first, followed by results of instructions
+    vector<ir::Edge*> inputs;
+    map<edgeid_t, int32_t> values;
+    for (auto n = group->nodes.begin(); n != group->nodes.end(); ++n) {
+        for (uint32_t i = 0; i < (*n)->GetInputCount(); ++i) {
+            auto edge = topo->GetEdge((*n)->GetInput(i));
+            auto producer = topo->GetNode(edge->GetProducer());
+            if ((producer && members.find(producer) != members.end()) || values.count(edge->GetId())) {
+                continue;
+            }
+            values.insert(make_pair(edge->GetId(), (int32_t)inputs.size()));
+            inputs.push_back(edge);
+        }
+    }
+
+    vector<fused_elementwise_inst_t> insts;
+    insts.reserve(group->inst_count);
+    const int32_t num_src = inputs.size();
+    for (uint32_t i = 0; i < group->nodes.size(); ++i) {
+        auto node = group->nodes[i];
+        fused_elementwise_inst_t inst;
+        inst.opcode = group->opcodes[i];
+        inst.src0 = values[node->GetInput(0)];
+        inst.src1 = fused_elementwise_is_binary(inst.opcode) ? values[node->GetInput(1)] : -1;
+        insts.push_back(inst);
+        if (group->fuse_relu[i]) {
+            inst.opcode = FUSED_ELEMENTWISE_RELU;
+            inst.src0 = num_src + insts.size() - 1;
+            inst.src1 = -1;
+            insts.push_back(inst);
+        }
+        values[node->GetOutput(0)] = num_src + insts.size() - 1;
+    }
+
+    auto last_node = group->nodes.back();
+    vector<ir::Edge*> outputs(1, topo->GetEdge(last_node->GetOutput(0)));
+    auto output_format = tensors[outputs[0]->GetId()]->GetShape()->GetDataFormat();
+
+    const string fused_node_name = "Fused_Elementwise_" + group->nodes.front()->GetName() + "_" + last_node->GetName();
+    auto node_ret_pair = topo->AddNode(fused_node_name);
+    if (!node_ret_pair.second) {
+        LOG(ERROR) << "node[" << fused_node_name << "] already exists.";
+        return RC_EXISTS;
+    }
+    auto fused_node = node_ret_pair.first;
+    fused_node->SetType(ir::Node::Type("pmx", "FusedElementwise", 1));
+
+    // output formats of an opt kernel are sized by outputs of its node, so it is created after replacement
+    auto status = ReplaceSubgraphWithOneNode(options, group->nodes, inputs, outputs, fused_node);
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "replace subgraph with node[" << fused_node_name << "] failed: " << GetRetCodeStr(status);
+        topo->DelNode(fused_node->GetId());
+        return status;
+    }
+
+    X86OptKernel* fused_opt_kernel = nullptr;
+    status = CreateX86OptKernel(options, fused_node, &fused_opt_kernel);
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "Create OptKernel [" << fused_node_name << "] failed: " << GetRetCodeStr(status);
+        return status;
+    }
+    static_cast<FusedElementwiseOp*>(fused_opt_kernel)->SetInstructions(std::move(insts));
+    fused_opt_kernel->SetOutputDataFormat(0, output_format);
+
+    return RC_SUCCESS;
+}
+
+bool FuseElementwiseChain(const OptKernelOptions& options) {
+    ChainBuilder builder(options);
+    builder.Init();
+
+    // groups are disjoint, so they are collected before the graph is changed
+    vector<FusionGroup> groups;
+    auto& sorted_nodes = builder.GetSortedNodes();
+    for (auto x = sorted_nodes.begin(); x != sorted_nodes.end(); ++x) {
+        FusionGroup group;
+        if (builder.Grow(options.graph_topo->GetNode(*x), &group)) {
+            groups.push_back(std::move(group));
+        }
+    }
+
+    bool graph_changed = false;
+    for (auto g = groups.begin(); g != groups.end(); ++g) {
+        auto status = FuseGroup(options, &(*g));
+        if (status != RC_SUCCESS) {
+            LOG(WARNING) << "fuse elementwise chain starting from node[" << g->nodes.front()->GetName()
+                         << "] failed: " << GetRetCodeStr(status);
+            continue;
+        }
+        graph_changed = true;
+    }
+
+    return graph_changed;
+}
+
+}}} // namespace ppl::nn::x86
@@ -0,0 +1,227 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/nn/engines/x86/optimizer/rules/fuse_gelu.h"
+#include "ppl/nn/engines/x86/optimizer/rules/utils.h"
+#include "ppl/nn/params/pmx/gelu_param.h"
+#include "ppl/nn/common/logger.h"
+#include <math.h>
+
+namespace ppl { namespace nn { namespace x86 {
+
+static inline bool IsCloseTo(float value, float expected) {
+    return fabsf(value - expected) <= 1e-4f * fabsf(expected);
+}
+
+/*
+  returns `a` if `node` is `op_type(a, c)`, or `op_type(c, a)` for Add/Mul, where `c` is a scalar constant close to
+  `expected`. returns INVALID_EDGEID otherwise.
+*/
+static edgeid_t GetOperandOfConstantOp(const OptKernelOptions& options, const ir::Node* node, const char* op_type,
+                                       float expected) {
+    if (!IsOnnxNode(node, op_type) || node->GetInputCount() != 2) {
+        return INVALID_EDGEID;
+    }
+    float value;
+    if (GetScalarConstant(options, node->GetInput(1), &value) && IsCloseTo(value, expected)) {
+        return node->GetInput(0);
+    }
+    if (node->GetType().name != "Div" && GetScalarConstant(options, node->GetInput(0), &value) &&
+        IsCloseTo(value, expected)) {
+        return node->GetInput(1);
+    }
+    return INVALID_EDGEID;
+}
+
+static edgeid_t GetOtherInput(const ir::Node* node, edgeid_t input) {
+    if (node->GetInputCount() != 2) {
+        return INVALID_EDGEID;
+    }
+    if (node->GetInput(0) == input) {
+        return node->GetInput(1);
+    }
+    if (node->GetInput(1) == input) {
+        return node->GetInput(0);
+    }
+    return INVALID_EDGEID;
+}
+
+// returns the producer of `edge_id` if `consumer` is the only consumer of `edge_id`
+static ir::Node* GetProducerOfOnlyInput(const OptKernelOptions& options, edgeid_t edge_id, const ir::Node* consumer) {
+    if (edge_id == INVALID_EDGEID || GetOnlyConsumer(options, edge_id) != consumer) {
+        return nullptr;
+    }
+    return options.graph_topo->GetNode(options.graph_topo->GetEdge(edge_id)->GetProducer());
+}
+
+/*
+  matches `0.5 * x * (1 + t)` in one of the following orders:
+    ((1 + t) * x) * 0.5
+    ((1 + t) * 0.5) * x
+    (1 + t) * (x * 0.5)
+  matched nodes are appended to `nodes`. returns the last node or nullptr.
+*/
+static ir::Node* MatchGELUTail(const OptKernelOptions& options, edgeid_t t, edgeid_t x,
+                               std::vector<ir::Node*>* nodes) {
+    auto add_node = GetOnlyConsumer(options, t);
+    if (!add_node || GetOperandOfConstantOp(options, add_node, "Add", 1.0f) != t) {
+        return nullptr;
+    }
+    const edgeid_t add_output = add_node->GetOutput(0);
+
+    auto mul1_node = GetOnlyConsumer(options, add_output);
+    if (!IsOnnxNode(mul1_node, "Mul")) {
+        return nullptr;
+    }
+    const edgeid_t mul1_other = GetOtherInput(mul1_node, add_output);
+    const edgeid_t mul1_output = mul1_node->GetOutput(0);
+
+    if (mul1_other == x) {
+        auto mul2_node = GetOnlyConsumer(options, mul1_output);
+        if (!mul2_node || GetOperandOfConstantOp(options, mul2_node, "Mul", 0.5f) != mul1_output) {
+            return nullptr;
+        }
+        nodes->insert(nodes->end(), {add_node, mul1_node, mul2_node});
+        return mul2_node;
+    }
+
+    if (GetOperandOfConstantOp(options, mul1_node, "Mul", 0.5f) == add_output) {
+        auto mul2_node = GetOnlyConsumer(options, mul1_output);
+        if (!IsOnnxNode(mul2_node, "Mul") || GetOtherInput(mul2_node, mul1_output) != x) {
+            return nullptr;
+        }
+        nodes->insert(nodes->end(), {add_node, mul1_node, mul2_node});
+        return mul2_node;
+    }
+
+    auto half_node = GetProducerOfOnlyInput(options, mul1_other, mul1_node);
+    if (!half_node || GetOperandOfConstantOp(options, half_node, "Mul", 0.5f) != x) {
+        return nullptr;
+    }
+    nodes->insert(nodes->end(), {half_node, add_node, mul1_node});
+    return mul1_node;
+}
+
+// x / sqrt(2) or x * (1 / sqrt(2))
+static edgeid_t MatchErfInput(const OptKernelOptions& options, ir::Node* pre_node, std::vector<ir::Node*>* nodes) {
+    auto x = GetOperandOfConstantOp(options, pre_node, "Div", (float)M_SQRT2);
+    if (x == INVALID_EDGEID) {
+        x = GetOperandOfConstantOp(options, pre_node, "Mul", (float)M_SQRT1_2);
+    }
+    if (x != INVALID_EDGEID) {
+        nodes->push_back(pre_node);
+    }
+    return x;
+}
+
+// sqrt(2 / pi) * (x + 0.044715 * x^3), where x^3 is `Pow(x, 3)` or `x * x * x`
+static edgeid_t MatchTanhInput(const OptKernelOptions& options, ir::Node* pre_node, std::vector<ir::Node*>* nodes) {
+    const edgeid_t inner = GetOperandOfConstantOp(options, pre_node, "Mul", (float)(M_2_SQRTPI * M_SQRT1_2));
+    auto add_node = GetProducerOfOnlyInput(options, inner, pre_node);
+    if (!IsOnnxNode(add_node, "Add") || add_node->GetInputCount() != 2) {
+        return INVALID_EDGEID;
+    }
+
+    edgeid_t x = INVALID_EDGEID;
+    edgeid_t cube = INVALID_EDGEID;
+    ir::Node* coeff_node = nullptr;
+    for (uint32_t i = 0; i < 2; ++i) {
+        coeff_node = GetProducerOfOnlyInput(options, add_node->GetInput(i), add_node);
+        if (coeff_node) {
+            cube = GetOperandOfConstantOp(options, coeff_node, "Mul", 0.044715f);
+            if (cube != INVALID_EDGEID) {
+                x = add_node->GetInput(1 - i);
+                break;
+            }
+        }
+    }
+    if (cube == INVALID_EDGEID) {
+        return INVALID_EDGEID;
+    }
+
+    auto cube_node = GetProducerOfOnlyInput(options, cube, coeff_node);
+    if (GetOperandOfConstantOp(options, cube_node, "Pow", 3.0f) == x && cube_node->GetInput(0) == x) {
+        nodes->insert(nodes->end(), {cube_node, coeff_node, add_node, pre_node});
+        return x;
+    }
+
+    if (!IsOnnxNode(cube_node, "Mul")) {
+        return INVALID_EDGEID;
+    }
+    const edgeid_t square = GetOtherInput(cube_node, x);
+    auto square_node = GetProducerOfOnlyInput(options, square, cube_node);
+    if (!IsOnnxNode(square_node, "Mul") || square_node->GetInputCount() != 2 || square_node->GetInput(0) != x ||
+        square_node->GetInput(1) != x) {
+        return INVALID_EDGEID;
+    }
+    nodes->insert(nodes->end(), {square_node, cube_node, coeff_node, add_node, pre_node});
+    return x;
+}
+
+/*
+  erf form, exported from `torch.nn.GELU()`:
+    y = 0.5 * x * (1 + erf(x / sqrt(2)))
+  tanh form, exported from `torch.nn.GELU(approximate='tanh')` and many BERT/GPT implementations:
+    y = 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3)))
+*/
+bool FuseGELU(const OptKernelOptions& options) {
+    bool graph_changed = false;
+    auto graph_topo = options.graph_topo;
+    auto& tensors = *options.tensors;
+
+    for (auto it = graph_topo->CreateNodeIter(); it->IsValid(); it->Forward()) {
+        auto act_node = it->Get();
+        const bool approximate = IsOnnxNode(act_node, "Tanh");
+        if (!approximate && !IsOnnxNode(act_node, "Erf")) {
+            continue;
+        }
+
+        auto pre_node = GetProducerOfOnlyInput(options, act_node->GetInput(0), act_node);
+        if (!pre_node) {
+            continue;
+        }
+
+        std::vector<ir::Node*> nodes;
+        const edgeid_t x =
+            approximate ? MatchTanhInput(options, pre_node, &nodes) : MatchErfInput(options, pre_node, &nodes);
+        if (x == INVALID_EDGEID || tensors[x]->GetShape()->GetDataType() != ppl::common::DATATYPE_FLOAT32) {
+            continue;
+        }
+        nodes.push_back(act_node);
+
+        auto last_node = MatchGELUTail(options, act_node->GetOutput(0), x, &nodes);
+        if (!last_node) {
+            continue;
+        }
+
+        auto param = std::make_shared<ppl::nn::pmx::GELUParam>();
+        param->approximate = approximate;
+
+        std::vector<ir::Edge*> inputs = {graph_topo->GetEdge(x)};
+        std::vector<ir::Edge*> outputs = {graph_topo->GetEdge(last_node->GetOutput(0))};
+        const std::string node_name = "Fused_GELU_" + act_node->GetName() + "_" + last_node->GetName();
+        if (ReplaceSubgraphWithPmxNode(options, node_name, "GELU", param, nodes, inputs, outputs) !=
+            ppl::common::RC_SUCCESS) {
+            continue;
+        }
+        graph_changed = true;
+    }
+
+    return graph_changed;
+}
+
+}}} // namespace ppl::nn::x86
@@ -0,0 +1,236 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/nn/engines/x86/optimizer/rules/fuse_layer_norm.h"
+#include "ppl/nn/engines/x86/optimizer/rules/utils.h"
+#include "ppl/nn/params/onnx/reduce_param.h"
+#include "ppl/nn/params/pmx/layer_norm_param.h"
+#include "ppl/nn/common/logger.h"
+
+namespace ppl { namespace nn { namespace x86 {
+
+// returns the first normalized axis if `node` is a ReduceMean over trailing axes of `dim_count` dims with keepdims
+static bool GetTrailingReduceMeanAxis(const OptKernelOptions& options, const ir::Node* node, uint32_t dim_count,
+                                      int32_t* axis) {
+    if (!IsOnnxNode(node, "ReduceMean")) {
+        return false;
+    }
+    auto attr_ref = options.graph_data->attrs.find(node->GetId());
+    if (attr_ref == options.graph_data->attrs.end()) {
+        return false;
+    }
+    auto param = (const ppl::nn::onnx::ReduceParam*)attr_ref->second.get();
+    if (!param->keepdims || param->axes.empty() || param->axes.size() > dim_count) {
+        return false;
+    }
+
+    std::vector<bool> reduced(dim_count, false);
+    for (auto a : param->axes) {
+        const int32_t fixed_axis = a < 0 ? a + (int32_t)dim_count : a;
+        if (fixed_axis < 0 || fixed_axis >= (int32_t)dim_count || reduced[fixed_axis]) {
+            return false;
+        }
+        reduced[fixed_axis] = true;
+    }
+
+    const int32_t first_axis = dim_count - param->axes.size();
+    for (uint32_t i = first_axis; i < dim_count; ++i) {
+        if (!reduced[i]) {
+            return false;
+        }
+    }
+    *axis = first_axis - (int32_t)dim_count;
+    return true;
+}
+
+// `node` is `Op(input, const)` or `Op(const, input)` whose constant is a fp32 tensor broadcasted along normalized dims
+static ir::Edge* GetAffineConstant(const OptKernelOptions& options, const ir::Node* node, edgeid_t input,
+                                   const TensorShape& input_shape, int32_t axis) {
+    if (node->GetInputCount() != 2) {
+        return nullptr;
+    }
+    edgeid_t other;
+    if (node->GetInput(0) == input) {
+        other = node->GetInput(1);
+    } else if (node->GetInput(1) == input) {
+        other = node->GetInput(0);
+    } else {
+        return nullptr;
+    }
+    if (options.graph_data->constants.find(other) == options.graph_data->constants.end()) {
+        return nullptr;
+    }
+
+    auto& shape = *(*options.tensors)[other]->GetShape();
+    if (shape.GetDataType() != ppl::common::DATATYPE_FLOAT32 || shape.GetDimCount() > (uint32_t)(-axis)) {
+        return nullptr;
+    }
+    // constant must have the same trailing dims as the normalized dims
+    const uint32_t offset = input_shape.GetDimCount() - shape.GetDimCount();
+    for (uint32_t i = 0; i < shape.GetDimCount(); ++i) {
+        if (shape.GetDim(i) != input_shape.GetDim(offset + i)) {
+            return nullptr;
+        }
+    }
+    int64_t norm_size = 1;
+    for (uint32_t i = input_shape.GetDimCount() + axis; i < input_shape.GetDimCount(); ++i) {
+        norm_size *= input_shape.GetDim(i);
+    }
+    if ((int64_t)shape.GetElementsIncludingPadding() != norm_size) {
+        return nullptr;
+    }
+
+    return options.graph_topo->GetEdge(other);
+}
+
+/*
+  pattern exported from `torch.nn.LayerNorm`:
+
+    x -> ReduceMean -> Sub(x, mean) -> Pow(d, 2) | Mul(d, d) -> ReduceMean -> Add(var, eps) -> Sqrt -> Div(d, std)
+      [-> Mul(norm, scale) [-> Add(norm, shift)]]
+*/
+bool FuseLayerNorm(const OptKernelOptions& options) {
+    bool graph_changed = false;
+    auto graph_topo = options.graph_topo;
+    auto& tensors = *options.tensors;
+
+    for (auto it = graph_topo->CreateNodeIter(); it->IsValid(); it->Forward()) {
+        auto mean_node = it->Get();
+        if (!IsOnnxNode(mean_node, "ReduceMean")) {
+            continue;
+        }
+
+        auto input_edge = graph_topo->GetEdge(mean_node->GetInput(0));
+        auto& input_shape = *tensors[input_edge->GetId()]->GetShape();
+        if (input_shape.GetDataType() != ppl::common::DATATYPE_FLOAT32 || input_shape.GetDimCount() == 0) {
+            continue;
+        }
+        const uint32_t dim_count = input_shape.GetDimCount();
+
+        int32_t axis;
+        if (!GetTrailingReduceMeanAxis(options, mean_node, dim_count, &axis)) {
+            continue;
+        }
+
+        // d = x - mean
+        auto sub_node = GetOnlyConsumer(options, mean_node->GetOutput(0));
+        if (!IsOnnxNode(sub_node, "Sub") || sub_node->GetInput(0) != input_edge->GetId() ||
+            sub_node->GetInput(1) != mean_node->GetOutput(0)) {
+            continue;
+        }
+        auto diff_edge = graph_topo->GetEdge(sub_node->GetOutput(0));
+        if (diff_edge->CalcConsumerCount() != 2 || IsReservedEdge(tensors, diff_edge->GetId())) {
+            continue;
+        }
+
+        // d * d and d / std are the only consumers of d
+        ir::Node* square_node = nullptr;
+        ir::Node* div_node = nullptr;
+        for (auto consumer_it = diff_edge->CreateConsumerIter(); consumer_it.IsValid(); consumer_it.Forward()) {
+            auto consumer = graph_topo->GetNode(consumer_it.Get());
+            if (IsOnnxNode(consumer, "Div")) {
+                div_node = consumer;
+            } else if (IsOnnxNode(consumer, "Pow")) {
+                float exponent;
+                if (consumer->GetInput(0) == diff_edge->GetId() &&
+                    GetScalarConstant(options, consumer->GetInput(1), &exponent) && exponent == 2.0f) {
+                    square_node = consumer;
+                }
+            } else if (IsOnnxNode(consumer, "Mul")) {
+                if (consumer->GetInput(0) == diff_edge->GetId() && consumer->GetInput(1) == diff_edge->GetId()) {
+                    square_node = consumer;
+                }
+            }
+        }
+        if (!square_node || !div_node || div_node->GetInput(0) != diff_edge->GetId()) {
+            continue;
+        }
+
+        // var = mean(d * d)
+        auto var_node = GetOnlyConsumer(options, square_node->GetOutput(0));
+        int32_t var_axis;
+        if (!var_node || var_node->GetInput(0) != square_node->GetOutput(0) ||
+            !GetTrailingReduceMeanAxis(options, var_node, dim_count, &var_axis) || var_axis != axis) {
+            continue;
+        }
+
+        // var + eps
+        auto add_eps_node = GetOnlyConsumer(options, var_node->GetOutput(0));
+        if (!IsOnnxNode(add_eps_node, "Add")) {
+            continue;
+        }
+        float eps;
+        const edgeid_t eps_edge_id = (add_eps_node->GetInput(0) == var_node->GetOutput(0))
+            ? add_eps_node->GetInput(1)
+            : add_eps_node->GetInput(0);
+        if (!GetScalarConstant(options, eps_edge_id, &eps)) {
+            continue;
+        }
+
+        // std = sqrt(var + eps), norm = d / std
+        auto sqrt_node = GetOnlyConsumer(options, add_eps_node->GetOutput(0));
+        if (!IsOnnxNode(sqrt_node, "Sqrt")) {
+            continue;
+        }
+        if (GetOnlyConsumer(options, sqrt_node->GetOutput(0)) != div_node ||
+            div_node->GetInput(1) != sqrt_node->GetOutput(0)) {
+            continue;
+        }
+
+        std::vector<ir::Node*> nodes = {mean_node, sub_node, square_node, var_node, add_eps_node, sqrt_node, div_node};
+        std::vector<ir::Edge*> inputs = {input_edge};
+        auto output_edge = graph_topo->GetEdge(div_node->GetOutput(0));
+
+        // optional norm * scale [+ shift]. shift is not fused without scale.
+        auto mul_node = GetOnlyConsumer(options, output_edge->GetId());
+        if (IsOnnxNode(mul_node, "Mul")) {
+            auto scale_edge = GetAffineConstant(options, mul_node, output_edge->GetId(), input_shape, axis);
+            if (scale_edge) {
+                nodes.push_back(mul_node);
+                inputs.push_back(scale_edge);
+                output_edge = graph_topo->GetEdge(mul_node->GetOutput(0));
+
+                auto add_node = GetOnlyConsumer(options, output_edge->GetId());
+                if (IsOnnxNode(add_node, "Add")) {
+                    auto shift_edge = GetAffineConstant(options, add_node, output_edge->GetId(), input_shape, axis);
+                    if (shift_edge) {
+                        nodes.push_back(add_node);
+                        inputs.push_back(shift_edge);
+                        output_edge = graph_topo->GetEdge(add_node->GetOutput(0));
+                    }
+                }
+            }
+        }
+
+        auto param = std::make_shared<ppl::nn::pmx::LayerNormParam>();
+        param->elementwise_affine = (inputs.size() > 1);
+        param->axis = axis;
+        param->eps = eps;
+
+        std::vector<ir::Edge*> outputs = {output_edge};
+        const std::string node_name = "Fused_LayerNorm_" + mean_node->GetName() + "_" + nodes.back()->GetName();
+        if (ReplaceSubgraphWithPmxNode(options, node_name, "LayerNorm", param, nodes, inputs, outputs) !=
+            ppl::common::RC_SUCCESS) {
+            continue;
+        }
+        graph_changed = true;
+    }
+
+    return graph_changed;
+}
+
+}}} // namespace ppl::nn::x86
@@ -0,0 +1,256 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/nn/engines/x86/optimizer/rules/fuse_multi_head_attention.h"
+#include "ppl/nn/engines/x86/optimizer/rules/utils.h"
+#include "ppl/nn/params/onnx/transpose_param.h"
+#include "ppl/nn/params/onnx/softmax_param.h"
+#include "ppl/nn/params/pmx/multi_head_attention_param.h"
+#include "ppl/nn/common/logger.h"
+
+#include "ppl/kernel/x86/fp32/multi_head_attention.h"
+
+namespace ppl { namespace nn { namespace x86 {
+
+static bool HasTransposePerm(const OptKernelOptions& options, const ir::Node* node,
+                             const std::vector<int32_t>& perm) {
+    if (!IsOnnxNode(node, "Transpose")) {
+        return false;
+    }
+    auto attr_ref = options.graph_data->attrs.find(node->GetId());
+    if (attr_ref == options.graph_data->attrs.end()) {
+        return false;
+    }
+    return (((const ppl::nn::onnx::TransposeParam*)attr_ref->second.get())->perm == perm);
+}
+
+static ir::Node* GetProducer(const OptKernelOptions& options, edgeid_t edge_id) {
+    auto edge = options.graph_topo->GetEdge(edge_id);
+    return edge ? options.graph_topo->GetNode(edge->GetProducer()) : nullptr;
+}
+
+/*
+  matches `Transpose(perm)(Reshape(src, [B, S, num_heads, head_dim]))` which produces `edge_id`, where `src` is a fp32
+  tensor of shape [B, S, num_heads * head_dim]. matched nodes are appended to `nodes`. returns `src` or nullptr.
+*/
+static ir::Edge* MatchSplitHeads(const OptKernelOptions& options, edgeid_t edge_id, const std::vector<int32_t>& perm,
+                                 std::vector<ir::Node*>* nodes, int64_t* num_heads, int64_t* head_dim) {
+    auto& tensors = *options.tensors;
+
+    auto transpose_node = GetProducer(options, edge_id);
+    if (!HasTransposePerm(options, transpose_node, perm) || !GetOnlyConsumer(options, edge_id)) {
+        return nullptr;
+    }
+    auto reshape_node = GetProducer(options, transpose_node->GetInput(0));
+    if (!IsOnnxNode(reshape_node, "Reshape") ||
+        GetOnlyConsumer(options, transpose_node->GetInput(0)) != transpose_node) {
+        return nullptr;
+    }
+    // shape must be a constant, otherwise its producers would be left without consumers
+    if (reshape_node->GetInputCount() != 2 ||
+        options.graph_data->constants.find(reshape_node->GetInput(1)) == options.graph_data->constants.end()) {
+        return nullptr;
+    }
+
+    auto& src_shape = *tensors[reshape_node->GetInput(0)]->GetShape();
+    auto& dst_shape = *tensors[reshape_node->GetOutput(0)]->GetShape();
+    if (src_shape.GetDataType() != ppl::common::DATATYPE_FLOAT32 || src_shape.GetDimCount() != 3 ||
+        dst_shape.GetDimCount() != 4) {
+        return nullptr;
+    }
+    if (dst_shape.GetDim(0) != src_shape.GetDim(0) || dst_shape.GetDim(1) != src_shape.GetDim(1) ||
+        dst_shape.GetDim(2) * dst_shape.GetDim(3) != src_shape.GetDim(2)) {
+        return nullptr;
+    }
+
+    *num_heads = dst_shape.GetDim(2);
+    *head_dim = dst_shape.GetDim(3);
+    nodes->insert(nodes->end(), {reshape_node, transpose_node});
+    return options.graph_topo->GetEdge(reshape_node->GetInput(0));
+}
+
+/*
+  attention blocks exported from BERT-like models:
+
+    q = Transpose[0, 2, 1, 3](Reshape(query, [B, Sq, nh, hd]))
+    k = Transpose[0, 2, 3, 1](Reshape(key, [B, Skv, nh, hd]))
+    v = Transpose[0, 2, 1, 3](Reshape(value, [B, Skv, nh, hd]))
+    scores = MatMul(q, k) [/ c | * c] [+ mask]
+    output = Reshape(Transpose[0, 2, 1, 3](MatMul(Softmax(scores, axis = -1), v)), [B, Sq, nh * hd])
+
+  only masks of keys, whose shape is [B, 1, 1, Skv] or [1, 1, 1, Skv], are supported. nothing is fused if gemms are
+  faster with the isa of the device.
+*/
+bool FuseMultiHeadAttention(const OptKernelOptions& options) {
+    if (!ppl::kernel::x86::multi_head_attention_fp32_is_profitable(options.device->GetISA())) {
+        return false;
+    }
+
+    bool graph_changed = false;
+    auto graph_topo = options.graph_topo;
+    auto& attrs = options.graph_data->attrs;
+    auto& tensors = *options.tensors;
+
+    static const std::vector<int32_t> split_perm = {0, 2, 1, 3};
+    static const std::vector<int32_t> split_transposed_perm = {0, 2, 3, 1};
+
+    for (auto it = graph_topo->CreateNodeIter(); it->IsValid(); it->Forward()) {
+        auto softmax_node = it->Get();
+        if (!IsOnnxNode(softmax_node, "Softmax")) {
+            continue;
+        }
+        auto& scores_shape = *tensors[softmax_node->GetInput(0)]->GetShape();
+        if (scores_shape.GetDimCount() != 4 || scores_shape.GetDataType() != ppl::common::DATATYPE_FLOAT32) {
+            continue;
+        }
+        auto attr_ref = attrs.find(softmax_node->GetId());
+        if (attr_ref == attrs.end()) {
+            continue;
+        }
+        const int32_t softmax_axis = ((const ppl::nn::onnx::SoftmaxParam*)attr_ref->second.get())->axis;
+        if (softmax_axis != -1 && softmax_axis != 3) {
+            continue;
+        }
+
+        std::vector<ir::Node*> nodes;
+        edgeid_t scores = softmax_node->GetInput(0);
+        auto producer = GetProducer(options, scores);
+        if (!producer || GetOnlyConsumer(options, scores) != softmax_node) {
+            continue;
+        }
+
+        // optional mask
+        ir::Edge* mask_edge = nullptr;
+        if (IsOnnxNode(producer, "Add")) {
+            auto add_node = producer;
+            for (uint32_t i = 0; i < 2 && i < add_node->GetInputCount(); ++i) {
+                auto candidate = GetProducer(options, add_node->GetInput(i));
+                if ((IsOnnxNode(candidate, "MatMul") || IsOnnxNode(candidate, "Div") ||
+                     IsOnnxNode(candidate, "Mul")) &&
+                    GetOnlyConsumer(options, add_node->GetInput(i)) == add_node) {
+                    scores = add_node->GetInput(i);
+                    mask_edge = graph_topo->GetEdge(add_node->GetInput(1 - i));
+                    break;
+                }
+            }
+            if (!mask_edge) {
+                continue;
+            }
+            auto& mask_shape = *tensors[mask_edge->GetId()]->GetShape();
+            if (mask_shape.GetDataType() != ppl::common::DATATYPE_FLOAT32 || mask_shape.GetDimCount() != 4 ||
+                (mask_shape.GetDim(0) != 1 && mask_shape.GetDim(0) != scores_shape.GetDim(0)) ||
+                mask_shape.GetDim(1) != 1 || mask_shape.GetDim(2) != 1 ||
+                mask_shape.GetDim(3) != scores_shape.GetDim(3)) {
+                continue;
+            }
+            nodes.push_back(add_node);
+            producer = GetProducer(options, scores);
+        }
+
+        // optional scaling
+        float scale = 1.0f;
+        if (IsOnnxNode(producer, "Div") || IsOnnxNode(producer, "Mul")) {
+            const bool is_div = IsOnnxNode(producer, "Div");
+            float value;
+            edgeid_t scaled = INVALID_EDGEID;
+            if (GetScalarConstant(options, producer->GetInput(1), &value)) {
+                scaled = producer->GetInput(0);
+            } else if (!is_div && GetScalarConstant(options, producer->GetInput(0), &value)) {
+                scaled = producer->GetInput(1);
+            }
+            if (scaled == INVALID_EDGEID || (is_div && value == 0.0f)) {
+                continue;
+            }
+            scale = is_div ? 1.0f / value : value;
+            nodes.push_back(producer);
+            scores = scaled;
+            producer = GetProducer(options, scores);
+            if (GetOnlyConsumer(options, scores) != nodes.back()) {
+                continue;
+            }
+        }
+
+        // q * k^T
+        auto qk_node = producer;
+        if (!IsOnnxNode(qk_node, "MatMul")) {
+            continue;
+        }
+        int64_t q_heads, q_head_dim, k_heads, k_head_dim, v_heads, v_head_dim;
+        auto query_edge = MatchSplitHeads(options, qk_node->GetInput(0), split_perm, &nodes, &q_heads, &q_head_dim);
+        if (!query_edge) {
+            continue;
+        }
+        auto key_edge =
+            MatchSplitHeads(options, qk_node->GetInput(1), split_transposed_perm, &nodes, &k_heads, &k_head_dim);
+        if (!key_edge || k_heads != q_heads || k_head_dim != q_head_dim) {
+            continue;
+        }
+        nodes.push_back(qk_node);
+        nodes.push_back(softmax_node);
+
+        // probs * v
+        auto pv_node = GetOnlyConsumer(options, softmax_node->GetOutput(0));
+        if (!IsOnnxNode(pv_node, "MatMul") || pv_node->GetInput(0) != softmax_node->GetOutput(0)) {
+            continue;
+        }
+        auto value_edge = MatchSplitHeads(options, pv_node->GetInput(1), split_perm, &nodes, &v_heads, &v_head_dim);
+        if (!value_edge || v_heads != q_heads || v_head_dim != q_head_dim) {
+            continue;
+        }
+        nodes.push_back(pv_node);
+
+        // merge heads
+        auto merge_transpose_node = GetOnlyConsumer(options, pv_node->GetOutput(0));
+        if (!HasTransposePerm(options, merge_transpose_node, split_perm)) {
+            continue;
+        }
+        auto merge_reshape_node = GetOnlyConsumer(options, merge_transpose_node->GetOutput(0));
+        if (!IsOnnxNode(merge_reshape_node, "Reshape") || merge_reshape_node->GetInputCount() != 2 ||
+            options.graph_data->constants.find(merge_reshape_node->GetInput(1)) ==
+                options.graph_data->constants.end()) {
+            continue;
+        }
+        auto& query_shape = *tensors[query_edge->GetId()]->GetShape();
+        auto& output_shape = *tensors[merge_reshape_node->GetOutput(0)]->GetShape();
+        if (output_shape.GetDimCount() != 3 || output_shape.GetDim(0) != query_shape.GetDim(0) ||
+            output_shape.GetDim(1) != query_shape.GetDim(1) || output_shape.GetDim(2) != query_shape.GetDim(2)) {
+            continue;
+        }
+        nodes.push_back(merge_transpose_node);
+        nodes.push_back(merge_reshape_node);
+
+        auto param = std::make_shared<ppl::nn::pmx::MultiHeadAttentionParam>();
+        param->num_heads = q_heads;
+        param->scale = scale;
+
+        std::vector<ir::Edge*> inputs = {query_edge, key_edge, value_edge};
+        if (mask_edge) {
+            inputs.push_back(mask_edge);
+        }
+        std::vector<ir::Edge*> outputs = {graph_topo->GetEdge(merge_reshape_node->GetOutput(0))};
+        const std::string node_name = "Fused_MultiHeadAttention_" + softmax_node->GetName();
+        if (ReplaceSubgraphWithPmxNode(options, node_name, "MultiHeadAttention", param, nodes, inputs, outputs) !=
+            ppl::common::RC_SUCCESS) {
+            continue;
+        }
+        graph_changed = true;
+    }
+
+    return graph_changed;
+}
+
+}}} // namespace ppl::nn::x86
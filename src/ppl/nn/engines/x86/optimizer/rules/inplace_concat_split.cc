@@ -0,0 +1,138 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/nn/engines/x86/optimizer/rules/inplace_concat_split.h"
+#include "ppl/nn/engines/x86/optimizer/rules/utils.h"
+#include "ppl/nn/engines/x86/optimizer/ops/onnx/concat_op.h"
+#include "ppl/nn/engines/x86/optimizer/ops/onnx/split_op.h"
+#include <set>
+#include <string>
+
+namespace ppl { namespace nn { namespace x86 {
+
+// ops whose outputs may take over buffers of their inputs by `TensorImpl::TransferBufferFrom()`
+static bool MayForwardBuffer(const ir::Node::Type& type) {
+    static const std::set<std::string> onnx_ops = {
+        "Add", "Cast", "Div", "Flatten", "Identity", "If", "LeakyRelu", "Loop",
+        "Mul", "Pad", "Reshape", "Squeeze", "Sub", "Unsqueeze",
+    };
+    if (type.domain == "") {
+        return onnx_ops.find(type.name) != onnx_ops.end();
+    }
+    return (type.domain == "pmx" && type.name == "Reorder");
+}
+
+/*
+  buffers of in-place Concat outputs are kept by the device across runs, and those of in-place Split outputs are
+  parts of one buffer. they must not reach reserved tensors, whose buffers are kept by users after runs, through
+  consumers which forward buffers.
+*/
+static bool MayReachReservedEdge(const ir::GraphTopo* graph_topo,
+                                 const std::map<edgeid_t, std::unique_ptr<TensorImpl>>& tensors, const ir::Edge* edge) {
+    if (IsReservedEdge(tensors, edge->GetId())) {
+        return true;
+    }
+
+    for (auto it = edge->CreateConsumerIter(); it.IsValid(); it.Forward()) {
+        auto consumer = graph_topo->GetNode(it.Get());
+        if (!consumer || !MayForwardBuffer(consumer->GetType())) {
+            continue;
+        }
+        for (uint32_t i = 0; i < consumer->GetOutputCount(); ++i) {
+            auto output_edge = graph_topo->GetEdge(consumer->GetOutput(i));
+            if (output_edge && MayReachReservedEdge(graph_topo, tensors, output_edge)) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+// each input is only used by the Concat, so that it is not read after the output(which contains it) is modified
+static bool CanConcatBeInplace(const ir::GraphTopo* graph_topo,
+                               const std::map<edgeid_t, std::unique_ptr<TensorImpl>>& tensors, const ir::Node* node) {
+    auto output_edge = graph_topo->GetEdge(node->GetOutput(0));
+    if (!output_edge || MayReachReservedEdge(graph_topo, tensors, output_edge)) {
+        return false;
+    }
+
+    std::set<edgeid_t> inputs;
+    for (uint32_t i = 0; i < node->GetInputCount(); ++i) {
+        auto input_edge = graph_topo->GetEdge(node->GetInput(i));
+        if (!input_edge || input_edge->CalcConsumerCount() != 1 || IsReservedEdge(tensors, input_edge->GetId()) ||
+            input_edge->GetProducer() == INVALID_NODEID) {
+            return false;
+        }
+        if (!inputs.insert(input_edge->GetId()).second) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool CanSplitBeInplace(const ir::GraphTopo* graph_topo,
+                              const std::map<edgeid_t, std::unique_ptr<TensorImpl>>& tensors, const ir::Node* node) {
+    auto input_edge = graph_topo->GetEdge(node->GetInput(0));
+    if (!input_edge || IsReservedEdge(tensors, input_edge->GetId())) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < node->GetOutputCount(); ++i) {
+        auto output_edge = graph_topo->GetEdge(node->GetOutput(i));
+        if (!output_edge || MayReachReservedEdge(graph_topo, tensors, output_edge)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool InplaceConcatSplit(const OptKernelOptions &options) {
+    bool marked = false;
+    auto graph_topo = options.graph_topo;
+    auto info = options.info;
+    auto &tensors = *options.tensors;
+
+    for (auto it = graph_topo->CreateNodeIter(); it->IsValid(); it->Forward()) {
+        auto node = it->Get();
+        auto &type = node->GetType();
+        if (type.domain != "") {
+            continue;
+        }
+
+        auto kernel_ref = info->kernels.find(node->GetId());
+        if (kernel_ref == info->kernels.end()) {
+            continue;
+        }
+
+        if (type.name == "Concat") {
+            auto concat_op = static_cast<ConcatOp*>(kernel_ref->second.get());
+            concat_op->SetInplace(CanConcatBeInplace(graph_topo, tensors, node));
+            marked = marked || concat_op->IsInplace();
+        } else if (type.name == "Split") {
+            auto split_op = static_cast<SplitOp*>(kernel_ref->second.get());
+            split_op->SetInplace(CanSplitBeInplace(graph_topo, tensors, node));
+            marked = marked || split_op->IsInplace();
+        }
+    }
+
+    return marked;
+}
+
+}}} // namespace ppl::nn::x86
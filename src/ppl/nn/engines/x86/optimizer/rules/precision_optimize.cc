@@ -0,0 +1,238 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "ppl/nn/engines/x86/optimizer/rules/precision_optimize.h"
+#include "ppl/nn/engines/x86/optimizer/rules/utils.h"
+#include "ppl/nn/engines/x86/optimizer/ops/onnx/conv_op.h"
+#include "ppl/nn/engines/x86/optimizer/ops/onnx/gemm_op.h"
+#include "ppl/nn/params/onnx/cast_param.h"
+
+namespace ppl { namespace nn { namespace x86 {
+
+static bool IsBf16Node(const ir::Node* node, OptKernel* kernel) {
+    auto& type = node->GetType();
+    if (type.domain == "" && type.name == "Conv") {
+        return (static_cast<ConvOp*>(kernel)->GetBf16Param() != nullptr);
+    }
+    if (type.domain == "" && type.name == "Gemm") {
+        return (static_cast<GemmOp*>(kernel)->GetBf16Param() != nullptr);
+    }
+    return false;
+}
+
+// ops which only move bytes of their first input, so that bfloat16 regions are extended through them
+static bool IsBf16PassThroughNode(const ir::Node* node) {
+    auto& type = node->GetType();
+    return (type.domain == "" &&
+            (type.name == "Flatten" || type.name == "Reshape" || type.name == "Squeeze" ||
+             type.name == "Unsqueeze" || type.name == "Identity"));
+}
+
+// checks whether `edge` is read by bfloat16 ops directly or through pass-through ops
+static bool HasBf16Reader(const OptKernelOptions& options, const ir::Edge* edge) {
+    auto graph_topo = options.graph_topo;
+    auto info = options.info;
+    if (IsReservedEdge(*options.tensors, edge->GetId())) {
+        return false;
+    }
+
+    for (auto it = edge->CreateConsumerIter(); it.IsValid(); it.Forward()) {
+        auto consumer = graph_topo->GetNode(it.Get());
+        if (consumer->GetInput(0) != edge->GetId()) {
+            continue;
+        }
+        if (IsBf16Node(consumer, info->kernels[consumer->GetId()].get())) {
+            return true;
+        }
+        if (IsBf16PassThroughNode(consumer) && HasBf16Reader(options, graph_topo->GetEdge(consumer->GetOutput(0)))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void SetBf16Output(const ir::Node* node, OptKernel* kernel, ppl::common::datatype_t data_type) {
+    auto& type = node->GetType();
+    if (type.name == "Conv") {
+        static_cast<ConvOp*>(kernel)->SetBf16Output(data_type);
+    } else if (type.name == "Gemm") {
+        static_cast<GemmOp*>(kernel)->SetBf16Output(data_type);
+    }
+}
+
+// edge -> Cast(to `data_type`) -> new edge -> consumers
+static ppl::common::RetCode AddCastOp(const OptKernelOptions& options, ir::Edge* edge,
+                                      const std::vector<nodeid_t>& consumers, ppl::common::datatype_t data_type,
+                                      ir::Edge** new_edge) {
+    auto graph_topo = options.graph_topo;
+    auto& tensors = *options.tensors;
+
+    std::string node_name = "Cast_" + edge->GetName() + "_to_" + ppl::common::GetDataTypeStr(data_type);
+    auto node_ret_pair = graph_topo->AddNode(node_name);
+    if (!node_ret_pair.second) {
+        LOG(ERROR) << "node[" << node_name << "] already exists.";
+        return ppl::common::RC_EXISTS;
+    }
+    auto node = node_ret_pair.first;
+    node->SetType(ir::Node::Type("", "Cast", 13));
+
+    auto edge_ret_pair = graph_topo->AddEdge(node_name + "_edge");
+    if (!edge_ret_pair.second) {
+        LOG(ERROR) << "edge[" << node_name << "_edge] already exists.";
+        return ppl::common::RC_EXISTS;
+    }
+    auto out_edge = edge_ret_pair.first;
+
+    node->AddInput(edge->GetId());
+    node->AddOutput(out_edge->GetId());
+    out_edge->SetProducer(node->GetId());
+    edge->AddConsumer(node->GetId());
+    for (auto c = consumers.begin(); c != consumers.end(); ++c) {
+        edge->DelConsumer(*c);
+        out_edge->AddConsumer(*c);
+        graph_topo->GetNode(*c)->ReplaceInput(edge->GetId(), out_edge->GetId());
+    }
+
+    // param is stored in graph data so that it can be serialized like other Cast ops
+    auto param = std::make_shared<ppl::nn::onnx::CastParam>();
+    param->to = data_type;
+    options.graph_data->attrs[node->GetId()] = param;
+
+    X86OptKernel* opt_kernel = nullptr;
+    auto status = CreateX86OptKernel(options, node, &opt_kernel);
+    if (status != ppl::common::RC_SUCCESS) {
+        LOG(ERROR) << "create kernel[" << node_name << "] failed: " << ppl::common::GetRetCodeStr(status);
+        return status;
+    }
+
+    auto in_shape = tensors[edge->GetId()]->GetShape();
+    opt_kernel->SetOutputDataFormat(0, in_shape->GetDataFormat());
+
+    TensorImpl* tensor = new TensorImpl(out_edge, TENSORTYPE_NORMAL);
+    *tensor->GetShape() = *in_shape;
+    tensor->GetShape()->SetDataType(data_type);
+    tensors.emplace(out_edge->GetId(), std::unique_ptr<TensorImpl>(tensor));
+
+    if (new_edge) {
+        *new_edge = out_edge;
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+/*
+  sets `edge` to bfloat16 as well as outputs of pass-through ops leading to bfloat16 readers. other consumers read
+  float32 from one Cast op, so that Cast ops are only inserted at boundaries of bfloat16 regions.
+*/
+static ppl::common::RetCode SetBf16Edge(const OptKernelOptions& options, ir::Edge* edge) {
+    auto graph_topo = options.graph_topo;
+    auto info = options.info;
+    auto& tensors = *options.tensors;
+
+    tensors[edge->GetId()]->GetShape()->SetDataType(ppl::common::DATATYPE_BFLOAT16);
+
+    std::vector<nodeid_t> consumers;
+    for (auto it = edge->CreateConsumerIter(); it.IsValid(); it.Forward()) {
+        consumers.push_back(it.Get());
+    }
+
+    std::vector<nodeid_t> fp32_consumers;
+    for (auto c = consumers.begin(); c != consumers.end(); ++c) {
+        auto consumer = graph_topo->GetNode(*c);
+        if (consumer->GetInput(0) == edge->GetId()) {
+            if (IsBf16Node(consumer, info->kernels[consumer->GetId()].get())) {
+                continue;
+            }
+            if (IsBf16PassThroughNode(consumer)) {
+                auto out_edge = graph_topo->GetEdge(consumer->GetOutput(0));
+                if (HasBf16Reader(options, out_edge)) {
+                    auto status = SetBf16Edge(options, out_edge);
+                    if (status != ppl::common::RC_SUCCESS) {
+                        return status;
+                    }
+                    continue;
+                }
+            }
+        }
+        fp32_consumers.push_back(*c);
+    }
+
+    if (!fp32_consumers.empty()) {
+        return AddCastOp(options, edge, fp32_consumers, ppl::common::DATATYPE_FLOAT32, nullptr);
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+bool PrecisionOptimize(const OptKernelOptions& options) {
+    auto graph_topo = options.graph_topo;
+    auto info = options.info;
+    auto& tensors = *options.tensors;
+
+    std::vector<ir::Node*> bf16_nodes;
+    for (auto it = graph_topo->CreateNodeIter(); it->IsValid(); it->Forward()) {
+        auto node = it->Get();
+        if (IsBf16Node(node, info->kernels[node->GetId()].get())) {
+            bf16_nodes.push_back(node);
+        }
+    }
+    if (bf16_nodes.empty()) {
+        return true;
+    }
+
+    // keeps outputs in bfloat16 if they are consumed by bfloat16 ops directly or through pass-through ops
+    for (auto n = bf16_nodes.begin(); n != bf16_nodes.end(); ++n) {
+        auto node = *n;
+        auto edge = graph_topo->GetEdge(node->GetOutput(0));
+        if (!HasBf16Reader(options, edge)) {
+            continue;
+        }
+
+        SetBf16Output(node, info->kernels[node->GetId()].get(), ppl::common::DATATYPE_BFLOAT16);
+        auto status = SetBf16Edge(options, edge);
+        if (status != ppl::common::RC_SUCCESS) {
+            return false;
+        }
+    }
+
+    // converts float32 inputs. bfloat16 ops with the same input share one Cast op.
+    std::map<edgeid_t, ir::Edge*> converted_edges;
+    for (auto n = bf16_nodes.begin(); n != bf16_nodes.end(); ++n) {
+        auto node = *n;
+        auto edge = graph_topo->GetEdge(node->GetInput(0));
+        if (tensors[edge->GetId()]->GetShape()->GetDataType() == ppl::common::DATATYPE_BFLOAT16) {
+            continue;
+        }
+
+        auto ref = converted_edges.find(edge->GetId());
+        if (ref != converted_edges.end()) {
+            edge->DelConsumer(node->GetId());
+            ref->second->AddConsumer(node->GetId());
+            node->ReplaceInput(edge->GetId(), ref->second->GetId());
+        } else {
+            ir::Edge* converted_edge = nullptr;
+            auto status = AddCastOp(options, edge, {node->GetId()}, ppl::common::DATATYPE_BFLOAT16, &converted_edge);
+            if (status != ppl::common::RC_SUCCESS) {
+                return false;
+            }
+            converted_edges.insert(std::make_pair(edge->GetId(), converted_edge));
+        }
+    }
+
+    return true;
+}
+
+}}} // namespace ppl::nn::x86
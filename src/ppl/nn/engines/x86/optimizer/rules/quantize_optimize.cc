@@ -0,0 +1,201 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/nn/engines/x86/optimizer/rules/quantize_optimize.h"
+#include "ppl/nn/engines/x86/optimizer/rules/utils.h"
+#include "ppl/nn/engines/x86/optimizer/quant_utils.h"
+#include "ppl/nn/engines/x86/optimizer/ops/onnx/conv_op.h"
+#include "ppl/nn/engines/x86/optimizer/ops/onnx/gemm_op.h"
+#include "ppl/nn/engines/x86/optimizer/ops/pmx/quantize_op.h"
+#include "ppl/nn/engines/x86/optimizer/ops/pmx/dequantize_op.h"
+
+namespace ppl { namespace nn { namespace x86 {
+
+// returns quant param of input 0 if `node` runs in int8
+static const QuantizeParam* GetInt8SrcQuant(const ir::Node* node, OptKernel* kernel) {
+    auto& type = node->GetType();
+    if (type.domain == "" && type.name == "Conv") {
+        auto param = static_cast<ConvOp*>(kernel)->GetInt8Param();
+        return param ? &param->src_quant : nullptr;
+    }
+    if (type.domain == "" && type.name == "Gemm") {
+        auto param = static_cast<GemmOp*>(kernel)->GetInt8Param();
+        return param ? &param->src_quant : nullptr;
+    }
+    return nullptr;
+}
+
+static void SetInt8Output(const ir::Node* node, OptKernel* kernel, const QuantizeParam& dst_quant) {
+    auto& type = node->GetType();
+    if (type.name == "Conv") {
+        static_cast<ConvOp*>(kernel)->SetInt8Output(dst_quant);
+    } else if (type.name == "Gemm") {
+        static_cast<GemmOp*>(kernel)->SetInt8Output(dst_quant);
+    }
+}
+
+// edge -> `type_name` -> new edge -> consumers
+static ppl::common::RetCode AddQuantizeOp(const OptKernelOptions& options, const std::string& type_name,
+                                          ir::Edge* edge, const std::vector<nodeid_t>& consumers,
+                                          const QuantizeParam& param, ir::Edge** new_edge) {
+    auto graph_topo = options.graph_topo;
+    auto& tensors = *options.tensors;
+
+    std::string node_name = type_name + "_" + edge->GetName();
+    if (type_name == "Quantize") {
+        node_name += "_of_" + graph_topo->GetNode(consumers[0])->GetName();
+    }
+    auto node_ret_pair = graph_topo->AddNode(node_name);
+    if (!node_ret_pair.second) {
+        LOG(ERROR) << "node[" << node_name << "] already exists.";
+        return ppl::common::RC_EXISTS;
+    }
+    auto node = node_ret_pair.first;
+    node->SetType(ir::Node::Type("pmx", type_name, 1));
+
+    auto edge_ret_pair = graph_topo->AddEdge(node_name + "_edge");
+    if (!edge_ret_pair.second) {
+        LOG(ERROR) << "edge[" << node_name << "_edge] already exists.";
+        return ppl::common::RC_EXISTS;
+    }
+    auto out_edge = edge_ret_pair.first;
+
+    node->AddInput(edge->GetId());
+    node->AddOutput(out_edge->GetId());
+    out_edge->SetProducer(node->GetId());
+    edge->AddConsumer(node->GetId());
+    for (auto c = consumers.begin(); c != consumers.end(); ++c) {
+        edge->DelConsumer(*c);
+        out_edge->AddConsumer(*c);
+        graph_topo->GetNode(*c)->ReplaceInput(edge->GetId(), out_edge->GetId());
+    }
+
+    X86OptKernel* opt_kernel = nullptr;
+    auto status = CreateX86OptKernel(options, node, &opt_kernel);
+    if (status != ppl::common::RC_SUCCESS) {
+        LOG(ERROR) << "create kernel[" << node_name << "] failed: " << ppl::common::GetRetCodeStr(status);
+        return status;
+    }
+
+    auto in_shape = tensors[edge->GetId()]->GetShape();
+    if (type_name == "Quantize") {
+        static_cast<QuantizeOp*>(opt_kernel)->SetQuantParam(param);
+    } else {
+        static_cast<DequantizeOp*>(opt_kernel)->SetQuantParam(param);
+    }
+    opt_kernel->SetOutputDataFormat(0, in_shape->GetDataFormat());
+
+    TensorImpl* tensor = new TensorImpl(out_edge, TENSORTYPE_NORMAL);
+    *tensor->GetShape() = *in_shape;
+    tensor->GetShape()->SetDataType(type_name == "Quantize" ? ppl::common::DATATYPE_UINT8
+                                                            : ppl::common::DATATYPE_FLOAT32);
+    tensors.emplace(out_edge->GetId(), std::unique_ptr<TensorImpl>(tensor));
+
+    if (new_edge) {
+        *new_edge = out_edge;
+    }
+    return ppl::common::RC_SUCCESS;
+}
+
+bool QuantizeOptimize(const OptKernelOptions &options) {
+    auto graph_topo = options.graph_topo;
+    auto info = options.info;
+    auto &tensors = *options.tensors;
+
+    std::vector<ir::Node*> int8_nodes;
+    for (auto it = graph_topo->CreateNodeIter(); it->IsValid(); it->Forward()) {
+        auto node = it->Get();
+        if (GetInt8SrcQuant(node, info->kernels[node->GetId()].get())) {
+            int8_nodes.push_back(node);
+        }
+    }
+    if (int8_nodes.empty()) {
+        return true;
+    }
+
+    // keeps outputs in uint8 if they are consumed by int8 ops directly
+    for (auto n = int8_nodes.begin(); n != int8_nodes.end(); ++n) {
+        auto node = *n;
+        auto edge = graph_topo->GetEdge(node->GetOutput(0));
+        QuantizeParam dst_quant;
+        if (IsReservedEdge(tensors, edge->GetId()) ||
+            !FindTensorQuantParam(options.quant_info, edge->GetName(), &dst_quant)) {
+            continue;
+        }
+
+        std::vector<nodeid_t> fp32_consumers;
+        bool has_int8_consumer = false;
+        for (auto it = edge->CreateConsumerIter(); it.IsValid(); it.Forward()) {
+            auto consumer = graph_topo->GetNode(it.Get());
+            auto src_quant = GetInt8SrcQuant(consumer, info->kernels[consumer->GetId()].get());
+            if (src_quant && *src_quant == dst_quant && consumer->GetInput(0) == edge->GetId()) {
+                has_int8_consumer = true;
+            } else {
+                fp32_consumers.push_back(consumer->GetId());
+            }
+        }
+        if (!has_int8_consumer) {
+            continue;
+        }
+
+        SetInt8Output(node, info->kernels[node->GetId()].get(), dst_quant);
+        tensors[edge->GetId()]->GetShape()->SetDataType(ppl::common::DATATYPE_UINT8);
+
+        if (!fp32_consumers.empty()) {
+            auto status = AddQuantizeOp(options, "Dequantize", edge, fp32_consumers, dst_quant, nullptr);
+            if (status != ppl::common::RC_SUCCESS) {
+                return false;
+            }
+        }
+    }
+
+    // quantizes float32 inputs. int8 ops with the same input and param share one Quantize op.
+    std::map<edgeid_t, std::vector<std::pair<QuantizeParam, ir::Edge*>>> quantized_edges;
+    for (auto n = int8_nodes.begin(); n != int8_nodes.end(); ++n) {
+        auto node = *n;
+        auto edge = graph_topo->GetEdge(node->GetInput(0));
+        if (tensors[edge->GetId()]->GetShape()->GetDataType() == ppl::common::DATATYPE_UINT8) {
+            continue;
+        }
+
+        auto& src_quant = *GetInt8SrcQuant(node, info->kernels[node->GetId()].get());
+        auto& candidates = quantized_edges[edge->GetId()];
+        ir::Edge* quantized_edge = nullptr;
+        for (auto c = candidates.begin(); c != candidates.end(); ++c) {
+            if (c->first == src_quant) {
+                quantized_edge = c->second;
+                break;
+            }
+        }
+
+        if (quantized_edge) {
+            edge->DelConsumer(node->GetId());
+            quantized_edge->AddConsumer(node->GetId());
+            node->ReplaceInput(edge->GetId(), quantized_edge->GetId());
+        } else {
+            auto status = AddQuantizeOp(options, "Quantize", edge, {node->GetId()}, src_quant, &quantized_edge);
+            if (status != ppl::common::RC_SUCCESS) {
+                return false;
+            }
+            candidates.push_back(std::make_pair(src_quant, quantized_edge));
+        }
+    }
+
+    return true;
+}
+
+}}} // namespace ppl::nn::x86
@@ -19,6 +19,32 @@
 
 namespace ppl { namespace nn { namespace x86 {
 
+ir::Node* GetOnlyConsumer(const OptKernelOptions& options, edgeid_t edge_id) {
+    auto edge = options.graph_topo->GetEdge(edge_id);
+    if (!edge || edge->CalcConsumerCount() != 1 || IsReservedEdge(*options.tensors, edge_id)) {
+        return nullptr;
+    }
+    return options.graph_topo->GetNode(edge->CreateConsumerIter().Get());
+}
+
+bool GetScalarConstant(const OptKernelOptions& options, edgeid_t edge_id, float* value) {
+    auto constant_ref = options.graph_data->constants.find(edge_id);
+    if (constant_ref == options.graph_data->constants.end()) {
+        return false;
+    }
+    auto tensor_ref = options.tensors->find(edge_id);
+    if (tensor_ref == options.tensors->end() ||
+        tensor_ref->second->GetShape()->GetDataType() != ppl::common::DATATYPE_FLOAT32) {
+        return false;
+    }
+    auto& data = constant_ref->second.data;
+    if (data.size() != sizeof(float)) {
+        return false;
+    }
+    *value = *(const float*)data.data();
+    return true;
+}
+
 // replace subgraph with one node
 ppl::common::RetCode ReplaceSubgraphWithOneNode(
     const OptKernelOptions& options, std::vector<ir::Node*>& nodes,
@@ -108,4 +134,48 @@ ppl::common::RetCode ReplaceSubgraphWithOneNode(
     return ppl::common::RC_SUCCESS;
 }
 
+ppl::common::RetCode ReplaceSubgraphWithPmxNode(
+    const OptKernelOptions& options, const std::string& node_name, const std::string& type_name,
+    const std::shared_ptr<ir::Attr>& param, std::vector<ir::Node*>& nodes,
+    std::vector<ir::Edge*>& inputs, std::vector<ir::Edge*>& outputs) {
+    auto graph_topo = options.graph_topo;
+    auto graph_data = options.graph_data;
+
+    const ir::Node::Type type("pmx", type_name, 1);
+    if (!OptKernelCreatorManager::GetInstance()->Find(type.domain, type.name, type.version)) {
+        LOG(ERROR) << "cannot find creator for X86OptKernel[" << node_name << "] type[" << type.domain << ":"
+                   << type.name << "]";
+        return ppl::common::RC_NOT_FOUND;
+    }
+
+    auto node_ret_pair = graph_topo->AddNode(node_name);
+    if (!node_ret_pair.second) {
+        LOG(ERROR) << "node[" << node_name << "] already exists.";
+        return ppl::common::RC_EXISTS;
+    }
+    auto node = node_ret_pair.first;
+    node->SetType(type);
+    if (param) {
+        graph_data->attrs[node->GetId()] = param;
+    }
+
+    auto status = ReplaceSubgraphWithOneNode(options, nodes, inputs, outputs, node);
+    if (status != ppl::common::RC_SUCCESS) {
+        LOG(ERROR) << "replace subgraph with node[" << node_name << "] failed: " << ppl::common::GetRetCodeStr(status);
+        graph_data->attrs.erase(node->GetId());
+        graph_topo->DelNode(node->GetId());
+        return status;
+    }
+
+    // output formats of an opt kernel are sized by outputs of its node, so it is created after replacement
+    X86OptKernel* opt_kernel = nullptr;
+    status = CreateX86OptKernel(options, node, &opt_kernel);
+    if (status != ppl::common::RC_SUCCESS) {
+        LOG(ERROR) << "Create OptKernel [" << node_name << "] failed: " << ppl::common::GetRetCodeStr(status);
+        return status;
+    }
+
+    return ppl::common::RC_SUCCESS;
+}
+
 }}} // namespace ppl::nn::x86
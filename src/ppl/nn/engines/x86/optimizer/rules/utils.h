@@ -63,12 +63,31 @@ inline bool IsReservedEdge(const std::map<edgeid_t, std::unique_ptr<TensorImpl>>
     return false;
 }
 
+/** @brief returns the consumer of `edge_id` if it is the only consumer and `edge_id` is not reserved */
+ir::Node* GetOnlyConsumer(const OptKernelOptions& options, edgeid_t edge_id);
+
+/** @brief returns true if `edge_id` is a fp32 constant with only one element, and stores its value in `value` */
+bool GetScalarConstant(const OptKernelOptions& options, edgeid_t edge_id, float* value);
+
+inline bool IsOnnxNode(const ir::Node* node, const char* name) {
+    return (node && node->GetType().domain == "" && node->GetType().name == name);
+}
+
 // replace subgraph with one node
 ppl::common::RetCode ReplaceSubgraphWithOneNode(
     const OptKernelOptions& options, std::vector<ir::Node*>& nodes,
     std::vector<ir::Edge*>& inputs, std::vector<ir::Edge*>& outputs,
     ir::Node* target_node);
 
+/**
+   @brief creates a pmx node named `node_name` with `param` and replaces `nodes` with it.
+   the graph is unchanged unless it fails to create the opt kernel after replacement.
+*/
+ppl::common::RetCode ReplaceSubgraphWithPmxNode(
+    const OptKernelOptions& options, const std::string& node_name, const std::string& type_name,
+    const std::shared_ptr<ir::Attr>& param, std::vector<ir::Node*>& nodes,
+    std::vector<ir::Edge*>& inputs, std::vector<ir::Edge*>& outputs);
+
 }}} // namespace ppl::nn::x86
 
 #endif
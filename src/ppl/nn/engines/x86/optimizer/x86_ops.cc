@@ -46,6 +46,7 @@ using namespace ppl::common;
 #include "ppl/nn/engines/x86/optimizer/ops/onnx/gather_nd_op.h"
 #include "ppl/nn/engines/x86/optimizer/ops/onnx/gemm_op.h"
 #include "ppl/nn/engines/x86/optimizer/ops/onnx/greater_op.h"
+#include "ppl/nn/engines/x86/optimizer/ops/onnx/gru_op.h"
 #include "ppl/nn/engines/x86/optimizer/ops/onnx/identity_op.h"
 #include "ppl/nn/engines/x86/optimizer/ops/onnx/if_op.h"
 #include "ppl/nn/engines/x86/optimizer/ops/onnx/leaky_relu_op.h"
@@ -75,6 +76,7 @@ using namespace ppl::common;
 #include "ppl/nn/engines/x86/optimizer/ops/onnx/relu_op.h"
 #include "ppl/nn/engines/x86/optimizer/ops/onnx/reshape_op.h"
 #include "ppl/nn/engines/x86/optimizer/ops/onnx/resize_op.h"
+#include "ppl/nn/engines/x86/optimizer/ops/onnx/rnn_op.h"
 #include "ppl/nn/engines/x86/optimizer/ops/onnx/scatter_elements_op.h"
 #include "ppl/nn/engines/x86/optimizer/ops/onnx/scatter_nd_op.h"
 #include "ppl/nn/engines/x86/optimizer/ops/onnx/sequence_at_op.h"
@@ -103,7 +105,13 @@ using namespace ppl::common;
 #include "ppl/nn/engines/x86/optimizer/ops/pmx/channel_shuffle_op.h"
 #include "ppl/nn/engines/x86/optimizer/ops/pmx/shape_operation_op.h"
 #include "ppl/nn/engines/x86/optimizer/ops/pmx/swish_op.h"
+#include "ppl/nn/engines/x86/optimizer/ops/pmx/fused_elementwise_op.h"
+#include "ppl/nn/engines/x86/optimizer/ops/pmx/layer_norm_op.h"
+#include "ppl/nn/engines/x86/optimizer/ops/pmx/gelu_op.h"
+#include "ppl/nn/engines/x86/optimizer/ops/pmx/multi_head_attention_op.h"
 #include "ppl/nn/engines/x86/optimizer/ops/pmx/post_depthwise_conv_op.h"
+#include "ppl/nn/engines/x86/optimizer/ops/pmx/quantize_op.h"
+#include "ppl/nn/engines/x86/optimizer/ops/pmx/dequantize_op.h"
 
 namespace ppl { namespace nn { namespace x86 {
 
@@ -162,6 +170,7 @@ void RegisterBuiltinOpImpls() {
     RegisterOptKernelCreator<GemmOp>("", "Gemm", 9, 16);
     RegisterOptKernelCreator<AveragePoolOp>("", "GlobalAveragePool", 1, 16);
     RegisterOptKernelCreator<GreaterOp>("", "Greater", 7, 16);
+    RegisterOptKernelCreator<GRUOp>("", "GRU", 7, 13);
     // I
     RegisterOptKernelCreator<IdentityOp>("", "Identity", 1, 13);
     RegisterOptKernelCreator<IfOp>("", "If", 1, 12);
@@ -196,6 +205,7 @@ void RegisterBuiltinOpImpls() {
     RegisterOptKernelCreator<ReluOp>("", "Relu", 6, 16);
     RegisterOptKernelCreator<ReshapeOp>("", "Reshape", 5, 13);
     RegisterOptKernelCreator<ResizeOp>("", "Resize", 11, 16);
+    RegisterOptKernelCreator<RNNOp>("", "RNN", 7, 13);
     RegisterOptKernelCreator<ROIAlignOp>("", "RoiAlign", 10, 15);
     // S
     RegisterOptKernelCreator<ScatterElementsOp>("", "ScatterElements", 11, 15);
@@ -233,7 +243,13 @@ void RegisterBuiltinOpImpls() {
     RegisterOptKernelCreator<ReorderOp>("pmx", "Reorder", 1, 1);
     RegisterOptKernelCreator<ShapeOperationOp>("pmx", "Shape", 1, 1);
     RegisterOptKernelCreator<SwishOp>("pmx", "Swish", 1, 1);
+    RegisterOptKernelCreator<FusedElementwiseOp>("pmx", "FusedElementwise", 1, 1);
+    RegisterOptKernelCreator<LayerNormOp>("pmx", "LayerNorm", 1, 1);
+    RegisterOptKernelCreator<GELUOp>("pmx", "GELU", 1, 1);
+    RegisterOptKernelCreator<MultiHeadAttentionOp>("pmx", "MultiHeadAttention", 1, 1);
     RegisterOptKernelCreator<PostDepthwiseConvOp>("pmx", "PostDepthwiseConv", 1, 1);
+    RegisterOptKernelCreator<QuantizeOp>("pmx", "Quantize", 1, 1);
+    RegisterOptKernelCreator<DequantizeOp>("pmx", "Dequantize", 1, 1);
 }
 
 }}} // namespace ppl::nn::x86
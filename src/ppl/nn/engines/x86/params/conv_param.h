@@ -19,9 +19,13 @@
 #define _ST_HPC_PPL_NN_ENGINES_X86_PARAMS_CONV_PARAM_H_
 
 #include <functional>
+#include <vector>
 
 #include "ppl/nn/runtime/tensor_impl.h"
 #include "ppl/kernel/x86/fp32/conv2d.h"
+#include "ppl/kernel/x86/int8/conv2d.h"
+#include "ppl/kernel/x86/bf16/conv2d.h"
+#include "ppl/nn/engines/x86/params/quantize_param.h"
 
 namespace ppl { namespace nn { namespace x86 {
 
@@ -39,6 +43,27 @@ struct Conv2dParam {
     }
 };
 
+struct Conv2dInt8Param {
+    ppl::kernel::x86::conv2d_int8_param param;
+    std::vector<int8_t> packed_weight;
+    std::vector<int32_t> weight_sum;
+    std::vector<float> scale; // weight_scale * src_quant.scale
+    std::vector<float> bias;
+    int32_t weight_max_value; // depends on the isa used to quantize weights
+    QuantizeParam src_quant;
+    ppl::common::datatype_t output_type = ppl::common::DATATYPE_FLOAT32;
+    QuantizeParam dst_quant; // used if `output_type` is DATATYPE_UINT8
+};
+
+struct Conv2dBf16Param {
+    ppl::kernel::x86::conv2d_bf16_param param;
+    // DATAFORMAT_N16CX(direct conv) or DATAFORMAT_NDARRAY(im2col + gemm), which decides the layout of packed weight
+    ppl::common::dataformat_t data_format = ppl::common::DATAFORMAT_NDARRAY;
+    std::vector<uint16_t> packed_weight;
+    std::vector<float> bias;
+    ppl::common::datatype_t output_type = ppl::common::DATATYPE_FLOAT32;
+};
+
 }}}; // namespace ppl::nn::x86
 
 #endif
\ No newline at end of file
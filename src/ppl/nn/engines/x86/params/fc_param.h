@@ -18,7 +18,12 @@
 #ifndef _ST_HPC_PPL_NN_ENGINES_X86_PARAMS_FC_PARAM_H_
 #define _ST_HPC_PPL_NN_ENGINES_X86_PARAMS_FC_PARAM_H_
 
+#include <vector>
+
 #include "ppl/kernel/x86/fp32/fc.h"
+#include "ppl/kernel/x86/int8/gemm.h"
+#include "ppl/kernel/x86/bf16/gemm.h"
+#include "ppl/nn/engines/x86/params/quantize_param.h"
 
 namespace ppl { namespace nn { namespace x86 {
 
@@ -30,6 +35,29 @@ struct FCParam {
     ~FCParam() { if (mgr != nullptr) delete mgr; }
 };
 
+struct FCInt8Param {
+    int64_t num_output;
+    int64_t channels;
+    ppl::kernel::x86::gemm_post_t post = ppl::kernel::x86::gemm_post::NONE;
+    std::vector<int8_t> packed_weight; // in gemm_s8u8_layout::LANE_A
+    std::vector<int32_t> weight_sum;
+    std::vector<float> scale; // weight_scale * src_quant.scale
+    std::vector<float> bias;
+    int32_t weight_max_value;
+    QuantizeParam src_quant;
+    ppl::common::datatype_t output_type = ppl::common::DATATYPE_FLOAT32;
+    QuantizeParam dst_quant;
+};
+
+struct FCBf16Param {
+    int64_t num_output;
+    int64_t channels;
+    ppl::kernel::x86::gemm_post_t post = ppl::kernel::x86::gemm_post::NONE;
+    std::vector<uint16_t> packed_weight; // in gemm_bf16_layout::LANE_A
+    std::vector<float> bias;
+    ppl::common::datatype_t output_type = ppl::common::DATATYPE_FLOAT32;
+};
+
 }}}; // namespace ppl::nn::x86
 
 #endif
\ No newline at end of file
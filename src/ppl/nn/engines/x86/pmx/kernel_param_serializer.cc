@@ -0,0 +1,449 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifdef PPLNN_ENABLE_PMX_MODEL
+
+#include "ppl/nn/engines/x86/pmx/kernel_param_serializer.h"
+#include "ppl/nn/common/logger.h"
+using namespace std;
+using namespace ppl::common;
+using namespace ppl::kernel::x86;
+
+namespace ppl { namespace nn { namespace x86 {
+
+static RetCode WriteFloatArray(const float* data, uint64_t size, utils::DataStream* ds) {
+    auto status = WritePod(size, ds);
+    if (status != RC_SUCCESS || size == 0) {
+        return status;
+    }
+    return ds->Write(data, size * sizeof(float));
+}
+
+/** @note `*data` should be freed by `allocator` */
+static RetCode ReadFloatArray(DataReader* reader, Allocator* allocator, float** data, uint64_t* size) {
+    auto status = reader->ReadPod(size);
+    if (status != RC_SUCCESS) {
+        return status;
+    }
+
+    *data = nullptr;
+    if (*size == 0) {
+        return RC_SUCCESS;
+    }
+    if (*size > reader->GetRemainingBytes() / sizeof(float)) {
+        return RC_INVALID_VALUE;
+    }
+
+    *data = (float*)allocator->Alloc(*size * sizeof(float));
+    if (!*data) {
+        return RC_OUT_OF_MEMORY;
+    }
+    return reader->Read(*data, *size * sizeof(float));
+}
+
+/* -------------------------------------------------------------------------- */
+
+static RetCode SerializeConv2dManager(const conv2d_fp32_manager* mgr, utils::DataStream* ds) {
+    WritePod(mgr->param(), ds);
+    WriteFloatArray(mgr->cvt_filter(), mgr->cvt_filter_size(), ds);
+    return WriteFloatArray(mgr->cvt_bias(), mgr->cvt_bias_size(), ds);
+}
+
+static RetCode DeserializeConv2dManager(DataReader* reader, Allocator* allocator,
+                                        const conv2d_fp32_algo_info& algo_info, conv2d_fp32_manager** mgr) {
+    conv2d_fp32_param param;
+    auto status = reader->ReadPod(&param);
+    if (status != RC_SUCCESS) {
+        return status;
+    }
+
+    *mgr = conv2d_algo_selector::gen_algo(param, algo_info, allocator);
+    if (!*mgr) {
+        LOG(ERROR) << "create conv2d manager of algo[" << algo_info.algo_type << "] isa[" << algo_info.isa
+                   << "] failed.";
+        return RC_UNSUPPORTED;
+    }
+
+    // weights set here are released by release_cvt_weights() even if reading fails
+    float* cvt_filter = nullptr;
+    uint64_t cvt_filter_size = 0;
+    status = ReadFloatArray(reader, allocator, &cvt_filter, &cvt_filter_size);
+    (*mgr)->set_cvt_filter(cvt_filter, cvt_filter_size);
+    if (status != RC_SUCCESS) {
+        return status;
+    }
+
+    float* cvt_bias = nullptr;
+    uint64_t cvt_bias_size = 0;
+    status = ReadFloatArray(reader, allocator, &cvt_bias, &cvt_bias_size);
+    (*mgr)->set_cvt_bias(cvt_bias, cvt_bias_size);
+    return status;
+}
+
+RetCode SerializeConv2dParam(const Conv2dParam& param, utils::DataStream* ds) {
+    WritePod(param.param, ds);
+    WritePod(param.algo_info, ds);
+    if (param.algo_info.algo_type == conv2d_fp32_algo::UNKNOWN) {
+        return RC_SUCCESS;
+    }
+
+    auto status = SerializeConv2dManager(param.mgr, ds);
+    if (status != RC_SUCCESS) {
+        return status;
+    }
+
+    WritePod((uint32_t)(param.fallback_mgr ? 1 : 0), ds);
+    if (param.fallback_mgr) {
+        return SerializeConv2dManager(param.fallback_mgr, ds);
+    }
+    return RC_SUCCESS;
+}
+
+RetCode DeserializeConv2dParam(DataReader* reader, Allocator* allocator, Conv2dParam* param) {
+    auto status = reader->ReadPod(&param->param);
+    if (status == RC_SUCCESS) {
+        status = reader->ReadPod(&param->algo_info);
+    }
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "read conv2d param failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    if (param->algo_info.algo_type == conv2d_fp32_algo::UNKNOWN) {
+        return RC_SUCCESS;
+    }
+
+    status = DeserializeConv2dManager(reader, allocator, param->algo_info, &param->mgr);
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "read conv2d manager failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    uint32_t has_fallback = 0;
+    status = reader->ReadPod(&has_fallback);
+    if (status != RC_SUCCESS) {
+        return status;
+    }
+
+    if (has_fallback) {
+        // see ConvOp::SelectAlgorithm()
+        auto fallback_algo_info = param->algo_info;
+        fallback_algo_info.algo_type = conv2d_fp32_algo::DIRECT;
+        status = DeserializeConv2dManager(reader, allocator, fallback_algo_info, &param->fallback_mgr);
+        if (status != RC_SUCCESS) {
+            LOG(ERROR) << "read fallback conv2d manager failed: " << GetRetCodeStr(status);
+            return status;
+        }
+    }
+
+    return RC_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+
+RetCode SerializeFCParam(const FCParam& param, utils::DataStream* ds) {
+    WritePod(param.param, ds);
+    WritePod(param.algo_info, ds);
+    if (param.algo_info.algo_type == fc_fp32_algo::UNKNOWN) {
+        return RC_SUCCESS;
+    }
+
+    WritePod(param.mgr->param(), ds);
+    WriteFloatArray(param.mgr->cvt_filter(), param.mgr->cvt_filter_size(), ds);
+    return WriteFloatArray(param.mgr->cvt_bias(), param.mgr->cvt_bias_size(), ds);
+}
+
+RetCode DeserializeFCParam(DataReader* reader, Allocator* allocator, FCParam* param) {
+    auto status = reader->ReadPod(&param->param);
+    if (status == RC_SUCCESS) {
+        status = reader->ReadPod(&param->algo_info);
+    }
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "read fc param failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    if (param->algo_info.algo_type == fc_fp32_algo::UNKNOWN) {
+        return RC_SUCCESS;
+    }
+
+    fc_fp32_param mgr_param;
+    status = reader->ReadPod(&mgr_param);
+    if (status != RC_SUCCESS) {
+        return status;
+    }
+
+    param->mgr = fc_algo_selector::gen_algo(mgr_param, param->algo_info, allocator);
+    if (!param->mgr) {
+        LOG(ERROR) << "create fc manager of algo[" << param->algo_info.algo_type << "] isa["
+                   << param->algo_info.isa << "] failed.";
+        return RC_UNSUPPORTED;
+    }
+
+    float* cvt_filter = nullptr;
+    uint64_t cvt_filter_size = 0;
+    status = ReadFloatArray(reader, allocator, &cvt_filter, &cvt_filter_size);
+    param->mgr->set_cvt_filter(cvt_filter, cvt_filter_size);
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "read packed weights of fc failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    float* cvt_bias = nullptr;
+    uint64_t cvt_bias_size = 0;
+    status = ReadFloatArray(reader, allocator, &cvt_bias, &cvt_bias_size);
+    param->mgr->set_cvt_bias(cvt_bias, cvt_bias_size);
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "read packed bias of fc failed: " << GetRetCodeStr(status);
+    }
+    return status;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static RetCode CheckWeightMaxValue(int32_t weight_max_value, isa_t isa) {
+    if (weight_max_value > gemm_s8u8_get_a_max_value(isa)) {
+        LOG(ERROR) << "int8 weights quantized in [" << -weight_max_value << ", " << weight_max_value
+                   << "] are not supported by isa[" << isa << "].";
+        return RC_UNSUPPORTED;
+    }
+    return RC_SUCCESS;
+}
+
+RetCode SerializeConv2dInt8Param(const Conv2dInt8Param& param, utils::DataStream* ds) {
+    WritePod(param.param, ds);
+    WriteVector(param.packed_weight, ds);
+    WriteVector(param.weight_sum, ds);
+    WriteVector(param.scale, ds);
+    WriteVector(param.bias, ds);
+    WritePod(param.weight_max_value, ds);
+    WritePod(param.src_quant, ds);
+    WritePod(param.output_type, ds);
+    return WritePod(param.dst_quant, ds);
+}
+
+RetCode DeserializeConv2dInt8Param(DataReader* reader, isa_t isa, Conv2dInt8Param* param) {
+    auto status = reader->ReadPod(&param->param);
+    if (status == RC_SUCCESS) {
+        status = reader->ReadVector(&param->packed_weight);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadVector(&param->weight_sum);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadVector(&param->scale);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadVector(&param->bias);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadPod(&param->weight_max_value);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadPod(&param->src_quant);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadPod(&param->output_type);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadPod(&param->dst_quant);
+    }
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "read conv2d int8 param failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    return CheckWeightMaxValue(param->weight_max_value, isa);
+}
+
+RetCode SerializeFCInt8Param(const FCInt8Param& param, utils::DataStream* ds) {
+    WritePod(param.num_output, ds);
+    WritePod(param.channels, ds);
+    WritePod(param.post, ds);
+    WriteVector(param.packed_weight, ds);
+    WriteVector(param.weight_sum, ds);
+    WriteVector(param.scale, ds);
+    WriteVector(param.bias, ds);
+    WritePod(param.weight_max_value, ds);
+    WritePod(param.src_quant, ds);
+    WritePod(param.output_type, ds);
+    return WritePod(param.dst_quant, ds);
+}
+
+RetCode DeserializeFCInt8Param(DataReader* reader, isa_t isa, FCInt8Param* param) {
+    auto status = reader->ReadPod(&param->num_output);
+    if (status == RC_SUCCESS) {
+        status = reader->ReadPod(&param->channels);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadPod(&param->post);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadVector(&param->packed_weight);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadVector(&param->weight_sum);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadVector(&param->scale);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadVector(&param->bias);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadPod(&param->weight_max_value);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadPod(&param->src_quant);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadPod(&param->output_type);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadPod(&param->dst_quant);
+    }
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "read fc int8 param failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    return CheckWeightMaxValue(param->weight_max_value, isa);
+}
+
+RetCode SerializeConv2dBf16Param(const Conv2dBf16Param& param, utils::DataStream* ds) {
+    WritePod(param.param, ds);
+    WritePod(param.data_format, ds);
+    WriteVector(param.packed_weight, ds);
+    WriteVector(param.bias, ds);
+    return WritePod(param.output_type, ds);
+}
+
+RetCode DeserializeConv2dBf16Param(DataReader* reader, Conv2dBf16Param* param) {
+    auto status = reader->ReadPod(&param->param);
+    if (status == RC_SUCCESS) {
+        status = reader->ReadPod(&param->data_format);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadVector(&param->packed_weight);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadVector(&param->bias);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadPod(&param->output_type);
+    }
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "read conv2d bf16 param failed: " << GetRetCodeStr(status);
+    }
+    return status;
+}
+
+RetCode SerializeFCBf16Param(const FCBf16Param& param, utils::DataStream* ds) {
+    WritePod(param.num_output, ds);
+    WritePod(param.channels, ds);
+    WritePod(param.post, ds);
+    WriteVector(param.packed_weight, ds);
+    WriteVector(param.bias, ds);
+    return WritePod(param.output_type, ds);
+}
+
+RetCode DeserializeFCBf16Param(DataReader* reader, FCBf16Param* param) {
+    auto status = reader->ReadPod(&param->num_output);
+    if (status == RC_SUCCESS) {
+        status = reader->ReadPod(&param->channels);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadPod(&param->post);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadVector(&param->packed_weight);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadVector(&param->bias);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadPod(&param->output_type);
+    }
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "read fc bf16 param failed: " << GetRetCodeStr(status);
+    }
+    return status;
+}
+
+/* -------------------------------------------------------------------------- */
+
+RetCode SerializeMatMulParam(const MatMulParam& param, utils::DataStream* ds) {
+    WritePod(param.N, ds);
+    WritePod(param.K, ds);
+    WritePod(param.packed_isa, ds);
+    return WriteVector(param.packed_b, ds);
+}
+
+RetCode DeserializeMatMulParam(DataReader* reader, isa_t isa, MatMulParam* param) {
+    auto status = reader->ReadPod(&param->N);
+    if (status == RC_SUCCESS) {
+        status = reader->ReadPod(&param->K);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadPod(&param->packed_isa);
+    }
+    if (status == RC_SUCCESS) {
+        status = reader->ReadVector(&param->packed_b);
+    }
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "read matmul param failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    if ((param->packed_isa & isa) != param->packed_isa) {
+        LOG(ERROR) << "B of matmul is packed for isa[" << param->packed_isa << "] which is not supported by isa["
+                   << isa << "]";
+        return RC_UNSUPPORTED;
+    }
+    return RC_SUCCESS;
+}
+
+RetCode SerializeConvTransposeN16cxParam(const ConvTransposeN16cxParam& param, utils::DataStream* ds) {
+    WritePod(param.param, ds);
+    return WriteVector(param.packed_weight, ds);
+}
+
+RetCode DeserializeConvTransposeN16cxParam(DataReader* reader, isa_t isa, ConvTransposeN16cxParam* param) {
+    auto status = reader->ReadPod(&param->param);
+    if (status == RC_SUCCESS) {
+        status = reader->ReadVector(&param->packed_weight);
+    }
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "read convtranspose param failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    if (!ppl::kernel::x86::conv_transpose_n16cx_fp32_is_supported(isa, param->param)) {
+        LOG(ERROR) << "n16cx convtranspose is not supported by isa[" << isa << "]";
+        return RC_UNSUPPORTED;
+    }
+    if (param->packed_weight.size() * sizeof(float) !=
+        ppl::kernel::x86::conv_transpose_n16cx_fp32_get_packed_weight_bytes(param->param)) {
+        LOG(ERROR) << "size of packed weight of convtranspose mismatches";
+        return RC_INVALID_VALUE;
+    }
+    return RC_SUCCESS;
+}
+
+}}} // namespace ppl::nn::x86
+
+#endif
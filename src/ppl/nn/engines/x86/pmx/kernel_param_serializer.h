@@ -0,0 +1,65 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef _ST_HPC_PPL_NN_ENGINES_X86_PMX_KERNEL_PARAM_SERIALIZER_H_
+#define _ST_HPC_PPL_NN_ENGINES_X86_PMX_KERNEL_PARAM_SERIALIZER_H_
+
+#include "ppl/nn/engines/x86/params/conv_param.h"
+#include "ppl/nn/engines/x86/params/convtranspose_param.h"
+#include "ppl/nn/engines/x86/params/fc_param.h"
+#include "ppl/nn/engines/x86/params/matmul_param.h"
+#include "ppl/nn/engines/x86/pmx/serialization_utils.h"
+
+namespace ppl { namespace nn { namespace x86 {
+
+/**
+   @brief saves selected algorithms, fused flags and packed weights of `param`.
+   @note `infer_fallback_func` is not saved and should be set by the caller.
+*/
+ppl::common::RetCode SerializeConv2dParam(const Conv2dParam& param, utils::DataStream*);
+
+/** @brief managers are recreated with packed weights allocated by `allocator`. */
+ppl::common::RetCode DeserializeConv2dParam(DataReader*, ppl::common::Allocator* allocator, Conv2dParam* param);
+
+ppl::common::RetCode SerializeFCParam(const FCParam& param, utils::DataStream*);
+ppl::common::RetCode DeserializeFCParam(DataReader*, ppl::common::Allocator* allocator, FCParam* param);
+
+/** @note weights quantized with a larger `weight_max_value` than the isa supports are rejected. */
+ppl::common::RetCode SerializeConv2dInt8Param(const Conv2dInt8Param& param, utils::DataStream*);
+ppl::common::RetCode DeserializeConv2dInt8Param(DataReader*, ppl::common::isa_t isa, Conv2dInt8Param* param);
+
+ppl::common::RetCode SerializeFCInt8Param(const FCInt8Param& param, utils::DataStream*);
+ppl::common::RetCode DeserializeFCInt8Param(DataReader*, ppl::common::isa_t isa, FCInt8Param* param);
+
+ppl::common::RetCode SerializeConv2dBf16Param(const Conv2dBf16Param& param, utils::DataStream*);
+ppl::common::RetCode DeserializeConv2dBf16Param(DataReader*, Conv2dBf16Param* param);
+
+ppl::common::RetCode SerializeFCBf16Param(const FCBf16Param& param, utils::DataStream*);
+ppl::common::RetCode DeserializeFCBf16Param(DataReader*, FCBf16Param* param);
+
+/** @note B packed for an isa that is not supported by `isa` is rejected. */
+ppl::common::RetCode SerializeMatMulParam(const MatMulParam& param, utils::DataStream*);
+ppl::common::RetCode DeserializeMatMulParam(DataReader*, ppl::common::isa_t isa, MatMulParam* param);
+
+/** @note packed weights are rejected if `isa` cannot run the n16cx kernel. */
+ppl::common::RetCode SerializeConvTransposeN16cxParam(const ConvTransposeN16cxParam& param, utils::DataStream*);
+ppl::common::RetCode DeserializeConvTransposeN16cxParam(DataReader*, ppl::common::isa_t isa,
+                                                        ConvTransposeN16cxParam* param);
+
+}}} // namespace ppl::nn::x86
+
+#endif
@@ -0,0 +1,504 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifdef PPLNN_ENABLE_PMX_MODEL
+
+#include "ppl/nn/engines/x86/pmx/op_param_serializer.h"
+#include "ppl/nn/models/pmx/oputils/onnx/argmax.h"
+#include "ppl/nn/models/pmx/oputils/onnx/batch_normalization.h"
+#include "ppl/nn/models/pmx/oputils/onnx/cast.h"
+#include "ppl/nn/models/pmx/oputils/onnx/concat.h"
+#include "ppl/nn/models/pmx/oputils/onnx/conv.h"
+#include "ppl/nn/models/pmx/oputils/onnx/conv_transpose.h"
+#include "ppl/nn/models/pmx/oputils/onnx/cumsum.h"
+#include "ppl/nn/models/pmx/oputils/onnx/depth_to_space.h"
+#include "ppl/nn/models/pmx/oputils/onnx/flatten.h"
+#include "ppl/nn/models/pmx/oputils/onnx/gather.h"
+#include "ppl/nn/models/pmx/oputils/onnx/gather_nd.h"
+#include "ppl/nn/models/pmx/oputils/onnx/gemm.h"
+#include "ppl/nn/models/pmx/oputils/onnx/instance_normalization.h"
+#include "ppl/nn/models/pmx/oputils/onnx/leaky_relu.h"
+#include "ppl/nn/models/pmx/oputils/onnx/lrn.h"
+#include "ppl/nn/models/pmx/oputils/onnx/lstm.h"
+#include "ppl/nn/models/pmx/oputils/onnx/maxunpool.h"
+#include "ppl/nn/models/pmx/oputils/onnx/non_max_suppression.h"
+#include "ppl/nn/models/pmx/oputils/onnx/pad.h"
+#include "ppl/nn/models/pmx/oputils/onnx/pooling.h"
+#include "ppl/nn/models/pmx/oputils/onnx/reduce.h"
+#include "ppl/nn/models/pmx/oputils/onnx/resize.h"
+#include "ppl/nn/models/pmx/oputils/onnx/roialign.h"
+#include "ppl/nn/models/pmx/oputils/onnx/scatter_elements.h"
+#include "ppl/nn/models/pmx/oputils/onnx/softmax.h"
+#include "ppl/nn/models/pmx/oputils/onnx/split.h"
+#include "ppl/nn/models/pmx/oputils/onnx/split_to_sequence.h"
+#include "ppl/nn/models/pmx/oputils/onnx/squeeze.h"
+#include "ppl/nn/models/pmx/oputils/onnx/topk.h"
+#include "ppl/nn/models/pmx/oputils/onnx/transpose.h"
+#include "ppl/nn/models/pmx/oputils/onnx/unsqueeze.h"
+#include "ppl/nn/params/onnx/clip_param.h"
+#include "ppl/nn/params/onnx/slice_param.h"
+#include "ppl/nn/params/onnx/constant_of_shape_param.h"
+#include "ppl/nn/params/onnx/gru_param.h"
+#include "ppl/nn/params/onnx/rnn_param.h"
+#include "ppl/nn/params/pmx/channel_shuffle_param.h"
+#include "ppl/nn/params/pmx/swish_param.h"
+#include "ppl/nn/params/pmx/shape_operation_param.h"
+#include "ppl/nn/params/pmx/layer_norm_param.h"
+#include "ppl/nn/params/pmx/gelu_param.h"
+#include "ppl/nn/params/pmx/multi_head_attention_param.h"
+#include "ppl/nn/common/logger.h"
+using namespace std;
+using namespace flatbuffers;
+using namespace ppl::common;
+
+namespace ppl { namespace nn { namespace x86 {
+
+/** params which do not have a slot in `pmx::onnx::OpParamType` */
+enum {
+    PRIVATE_PARAM_NONE = 0,
+    PRIVATE_PARAM_CLIP = 1,
+    PRIVATE_PARAM_SLICE = 2,
+    PRIVATE_PARAM_CONSTANT_OF_SHAPE = 3,
+    PRIVATE_PARAM_CHANNEL_SHUFFLE = 4,
+    PRIVATE_PARAM_SWISH = 5,
+    PRIVATE_PARAM_SHAPE_OPERATION = 6,
+    PRIVATE_PARAM_GRU = 7,
+    PRIVATE_PARAM_RNN = 8,
+    PRIVATE_PARAM_LAYER_NORM = 9,
+    PRIVATE_PARAM_GELU = 10,
+    PRIVATE_PARAM_MULTI_HEAD_ATTENTION = 11,
+};
+
+/* -------------------------------------------------------------------------- */
+
+template <typename ParamType, typename FbParamType>
+static bool TrySerializeFbParam(const ir::Attr* attr,
+                                Offset<FbParamType> (*serialize_func)(const ParamType&, FlatBufferBuilder*),
+                                pmx::onnx::OpParamType type, FlatBufferBuilder* builder,
+                                pmx::onnx::OpParamType* fb_type, Offset<void>* fb_value) {
+    auto param = dynamic_cast<const ParamType*>(attr);
+    if (!param) {
+        return false;
+    }
+
+    *fb_type = type;
+    *fb_value = serialize_func(*param, builder).Union();
+    return true;
+}
+
+static bool SerializeFbParam(const ir::Attr* attr, FlatBufferBuilder* builder, pmx::onnx::OpParamType* fb_type,
+                             Offset<void>* fb_value) {
+    using namespace pmx::onnx;
+    return (TrySerializeFbParam(attr, SerializeArgMaxParam, OpParamType_ArgMaxParam, builder, fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializeBatchNormalizationParam, OpParamType_BatchNormalizationParam,
+                                builder, fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializeCastParam, OpParamType_CastParam, builder, fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializeConcatParam, OpParamType_ConcatParam, builder, fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializeConvParam, OpParamType_ConvParam, builder, fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializeConvTransposeParam, OpParamType_ConvTransposeParam, builder,
+                                fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializeCumSumParam, OpParamType_CumSumParam, builder, fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializeDepthToSpaceParam, OpParamType_DepthToSpaceParam, builder, fb_type,
+                                fb_value) ||
+            TrySerializeFbParam(attr, SerializeFlattenParam, OpParamType_FlattenParam, builder, fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializeGatherParam, OpParamType_GatherParam, builder, fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializeGatherNDParam, OpParamType_GatherNDParam, builder, fb_type,
+                                fb_value) ||
+            TrySerializeFbParam(attr, SerializeGemmParam, OpParamType_GemmParam, builder, fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializeInstanceNormalizationParam, OpParamType_InstanceNormalizationParam,
+                                builder, fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializeLeakyReluParam, OpParamType_LeakyReluParam, builder, fb_type,
+                                fb_value) ||
+            TrySerializeFbParam(attr, SerializeLRNParam, OpParamType_LRNParam, builder, fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializeLSTMParam, OpParamType_LSTMParam, builder, fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializeMaxUnpoolParam, OpParamType_MaxUnpoolParam, builder, fb_type,
+                                fb_value) ||
+            TrySerializeFbParam(attr, SerializeNonMaxSuppressionParam, OpParamType_NonMaxSuppressionParam, builder,
+                                fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializePadParam, OpParamType_PadParam, builder, fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializePoolingParam, OpParamType_PoolingParam, builder, fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializeReduceParam, OpParamType_ReduceParam, builder, fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializeResizeParam, OpParamType_ResizeParam, builder, fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializeRoiAlignParam, OpParamType_RoiAlignParam, builder, fb_type,
+                                fb_value) ||
+            TrySerializeFbParam(attr, SerializeScatterElementsParam, OpParamType_ScatterElementsParam, builder,
+                                fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializeSoftmaxParam, OpParamType_SoftmaxParam, builder, fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializeSplitParam, OpParamType_SplitParam, builder, fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializeSplitToSequenceParam, OpParamType_SplitToSequenceParam, builder,
+                                fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializeSqueezeParam, OpParamType_SqueezeParam, builder, fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializeTopKParam, OpParamType_TopKParam, builder, fb_type, fb_value) ||
+            TrySerializeFbParam(attr, SerializeTransposeParam, OpParamType_TransposeParam, builder, fb_type,
+                                fb_value) ||
+            TrySerializeFbParam(attr, SerializeUnsqueezeParam, OpParamType_UnsqueezeParam, builder, fb_type,
+                                fb_value));
+}
+
+static RetCode SerializePrivateParam(const pmx::SerializationContext& ctx, const ir::Attr* attr,
+                                     utils::DataStream* ds) {
+    auto clip_param = dynamic_cast<const ppl::nn::onnx::ClipParam*>(attr);
+    if (clip_param) {
+        WritePod((uint32_t)PRIVATE_PARAM_CLIP, ds);
+        WritePod(clip_param->min_value, ds);
+        return WritePod(clip_param->max_value, ds);
+    }
+
+    auto slice_param = dynamic_cast<const ppl::nn::onnx::SliceParam*>(attr);
+    if (slice_param) {
+        WritePod((uint32_t)PRIVATE_PARAM_SLICE, ds);
+        WriteVector(slice_param->axes, ds);
+        WriteVector(slice_param->ends, ds);
+        return WriteVector(slice_param->starts, ds);
+    }
+
+    auto constant_of_shape_param = dynamic_cast<const ppl::nn::onnx::ConstantOfShapeParam*>(attr);
+    if (constant_of_shape_param) {
+        WritePod((uint32_t)PRIVATE_PARAM_CONSTANT_OF_SHAPE, ds);
+        WritePod(constant_of_shape_param->data_type, ds);
+        WriteVector(constant_of_shape_param->dims, ds);
+        return WriteString(constant_of_shape_param->data, ds);
+    }
+
+    auto channel_shuffle_param = dynamic_cast<const ppl::nn::pmx::ChannelShuffleParam*>(attr);
+    if (channel_shuffle_param) {
+        WritePod((uint32_t)PRIVATE_PARAM_CHANNEL_SHUFFLE, ds);
+        return WritePod(channel_shuffle_param->group, ds);
+    }
+
+    auto swish_param = dynamic_cast<const ppl::nn::pmx::SwishParam*>(attr);
+    if (swish_param) {
+        WritePod((uint32_t)PRIVATE_PARAM_SWISH, ds);
+        return WritePod(swish_param->beta, ds);
+    }
+
+    auto shape_operation_param = dynamic_cast<const ppl::nn::pmx::ShapeOperationParam*>(attr);
+    if (shape_operation_param) {
+        WritePod((uint32_t)PRIVATE_PARAM_SHAPE_OPERATION, ds);
+        WritePod((uint64_t)shape_operation_param->alpha.size(), ds);
+        for (auto it = shape_operation_param->alpha.begin(); it != shape_operation_param->alpha.end(); ++it) {
+            if (it->first >= ctx.eid2seq.size()) {
+                LOG(ERROR) << "invalid edge id[" << it->first << "] in ShapeOperationParam.";
+                return RC_INVALID_VALUE;
+            }
+            // edge ids of loaded models are the same as sequential numbers
+            WritePod(ctx.eid2seq[it->first], ds);
+            WritePod(it->second, ds);
+        }
+        return RC_SUCCESS;
+    }
+
+    auto gru_param = dynamic_cast<const ppl::nn::onnx::GRUParam*>(attr);
+    if (gru_param) {
+        WritePod((uint32_t)PRIVATE_PARAM_GRU, ds);
+        WriteVector(gru_param->activation_alpha, ds);
+        WriteVector(gru_param->activation_beta, ds);
+        WriteVector(gru_param->activations, ds);
+        WritePod(gru_param->clip, ds);
+        WritePod(gru_param->direction, ds);
+        WritePod(gru_param->hidden_size, ds);
+        return WritePod(gru_param->linear_before_reset, ds);
+    }
+
+    auto rnn_param = dynamic_cast<const ppl::nn::onnx::RNNParam*>(attr);
+    if (rnn_param) {
+        WritePod((uint32_t)PRIVATE_PARAM_RNN, ds);
+        WriteVector(rnn_param->activation_alpha, ds);
+        WriteVector(rnn_param->activation_beta, ds);
+        WriteVector(rnn_param->activations, ds);
+        WritePod(rnn_param->clip, ds);
+        WritePod(rnn_param->direction, ds);
+        return WritePod(rnn_param->hidden_size, ds);
+    }
+
+    auto layer_norm_param = dynamic_cast<const ppl::nn::pmx::LayerNormParam*>(attr);
+    if (layer_norm_param) {
+        WritePod((uint32_t)PRIVATE_PARAM_LAYER_NORM, ds);
+        WritePod(layer_norm_param->elementwise_affine, ds);
+        WritePod(layer_norm_param->axis, ds);
+        return WritePod(layer_norm_param->eps, ds);
+    }
+
+    auto gelu_param = dynamic_cast<const ppl::nn::pmx::GELUParam*>(attr);
+    if (gelu_param) {
+        WritePod((uint32_t)PRIVATE_PARAM_GELU, ds);
+        return WritePod(gelu_param->approximate, ds);
+    }
+
+    auto mha_param = dynamic_cast<const ppl::nn::pmx::MultiHeadAttentionParam*>(attr);
+    if (mha_param) {
+        WritePod((uint32_t)PRIVATE_PARAM_MULTI_HEAD_ATTENTION, ds);
+        WritePod(mha_param->num_heads, ds);
+        return WritePod(mha_param->scale, ds);
+    }
+
+    return RC_UNSUPPORTED;
+}
+
+RetCode SerializeOpParam(const pmx::SerializationContext& ctx, const ir::Attr* param, FlatBufferBuilder* builder,
+                         pmx::onnx::OpParamType* fb_type, Offset<void>* fb_value, utils::DataStream* private_data) {
+    *fb_type = pmx::onnx::OpParamType_NONE;
+    *fb_value = 0;
+
+    if (!param || SerializeFbParam(param, builder, fb_type, fb_value)) {
+        return WritePod((uint32_t)PRIVATE_PARAM_NONE, private_data);
+    }
+
+    return SerializePrivateParam(ctx, param, private_data);
+}
+
+/* -------------------------------------------------------------------------- */
+
+template <typename ParamType, typename FbParamType>
+static RetCode DeserializeFbParam(const FbParamType* fb_param,
+                                  void (*deserialize_func)(const FbParamType&, ParamType*),
+                                  shared_ptr<ir::Attr>* attr) {
+    if (!fb_param) {
+        return RC_INVALID_VALUE;
+    }
+
+    auto param = make_shared<ParamType>();
+    deserialize_func(*fb_param, param.get());
+    *attr = param;
+    return RC_SUCCESS;
+}
+
+static RetCode DeserializeFbParam(const pmx::onnx::OpParam& fb_op_param, shared_ptr<ir::Attr>* attr) {
+    using namespace pmx::onnx;
+    auto& p = fb_op_param;
+    switch (p.value_type()) {
+        case OpParamType_ArgMaxParam:
+            return DeserializeFbParam(p.value_as_ArgMaxParam(), DeserializeArgMaxParam, attr);
+        case OpParamType_BatchNormalizationParam:
+            return DeserializeFbParam(p.value_as_BatchNormalizationParam(), DeserializeBatchNormalizationParam,
+                                      attr);
+        case OpParamType_CastParam:
+            return DeserializeFbParam(p.value_as_CastParam(), DeserializeCastParam, attr);
+        case OpParamType_ConcatParam:
+            return DeserializeFbParam(p.value_as_ConcatParam(), DeserializeConcatParam, attr);
+        case OpParamType_ConvParam:
+            return DeserializeFbParam(p.value_as_ConvParam(), DeserializeConvParam, attr);
+        case OpParamType_ConvTransposeParam:
+            return DeserializeFbParam(p.value_as_ConvTransposeParam(), DeserializeConvTransposeParam, attr);
+        case OpParamType_CumSumParam:
+            return DeserializeFbParam(p.value_as_CumSumParam(), DeserializeCumSumParam, attr);
+        case OpParamType_DepthToSpaceParam:
+            return DeserializeFbParam(p.value_as_DepthToSpaceParam(), DeserializeDepthToSpaceParam, attr);
+        case OpParamType_FlattenParam:
+            return DeserializeFbParam(p.value_as_FlattenParam(), DeserializeFlattenParam, attr);
+        case OpParamType_GatherParam:
+            return DeserializeFbParam(p.value_as_GatherParam(), DeserializeGatherParam, attr);
+        case OpParamType_GatherNDParam:
+            return DeserializeFbParam(p.value_as_GatherNDParam(), DeserializeGatherNDParam, attr);
+        case OpParamType_GemmParam:
+            return DeserializeFbParam(p.value_as_GemmParam(), DeserializeGemmParam, attr);
+        case OpParamType_InstanceNormalizationParam:
+            return DeserializeFbParam(p.value_as_InstanceNormalizationParam(),
+                                      DeserializeInstanceNormalizationParam, attr);
+        case OpParamType_LeakyReluParam:
+            return DeserializeFbParam(p.value_as_LeakyReluParam(), DeserializeLeakyReluParam, attr);
+        case OpParamType_LRNParam:
+            return DeserializeFbParam(p.value_as_LRNParam(), DeserializeLRNParam, attr);
+        case OpParamType_LSTMParam:
+            return DeserializeFbParam(p.value_as_LSTMParam(), DeserializeLSTMParam, attr);
+        case OpParamType_MaxUnpoolParam:
+            return DeserializeFbParam(p.value_as_MaxUnpoolParam(), DeserializeMaxUnpoolParam, attr);
+        case OpParamType_NonMaxSuppressionParam:
+            return DeserializeFbParam(p.value_as_NonMaxSuppressionParam(), DeserializeNonMaxSuppressionParam, attr);
+        case OpParamType_PadParam:
+            return DeserializeFbParam(p.value_as_PadParam(), DeserializePadParam, attr);
+        case OpParamType_PoolingParam:
+            return DeserializeFbParam(p.value_as_PoolingParam(), DeserializePoolingParam, attr);
+        case OpParamType_ReduceParam:
+            return DeserializeFbParam(p.value_as_ReduceParam(), DeserializeReduceParam, attr);
+        case OpParamType_ResizeParam:
+            return DeserializeFbParam(p.value_as_ResizeParam(), DeserializeResizeParam, attr);
+        case OpParamType_RoiAlignParam:
+            return DeserializeFbParam(p.value_as_RoiAlignParam(), DeserializeRoiAlignParam, attr);
+        case OpParamType_ScatterElementsParam:
+            return DeserializeFbParam(p.value_as_ScatterElementsParam(), DeserializeScatterElementsParam, attr);
+        case OpParamType_SoftmaxParam:
+            return DeserializeFbParam(p.value_as_SoftmaxParam(), DeserializeSoftmaxParam, attr);
+        case OpParamType_SplitParam:
+            return DeserializeFbParam(p.value_as_SplitParam(), DeserializeSplitParam, attr);
+        case OpParamType_SplitToSequenceParam:
+            return DeserializeFbParam(p.value_as_SplitToSequenceParam(), DeserializeSplitToSequenceParam, attr);
+        case OpParamType_SqueezeParam:
+            return DeserializeFbParam(p.value_as_SqueezeParam(), DeserializeSqueezeParam, attr);
+        case OpParamType_TopKParam:
+            return DeserializeFbParam(p.value_as_TopKParam(), DeserializeTopKParam, attr);
+        case OpParamType_TransposeParam:
+            return DeserializeFbParam(p.value_as_TransposeParam(), DeserializeTransposeParam, attr);
+        case OpParamType_UnsqueezeParam:
+            return DeserializeFbParam(p.value_as_UnsqueezeParam(), DeserializeUnsqueezeParam, attr);
+        default:
+            break;
+    }
+
+    LOG(ERROR) << "unsupported op param type[" << (uint32_t)p.value_type() << "]";
+    return RC_UNSUPPORTED;
+}
+
+static RetCode DeserializePrivateParam(uint32_t kind, DataReader* reader, shared_ptr<ir::Attr>* attr) {
+    RetCode status = RC_SUCCESS;
+
+    if (kind == PRIVATE_PARAM_CLIP) {
+        auto param = make_shared<ppl::nn::onnx::ClipParam>();
+        status = reader->ReadPod(&param->min_value);
+        if (status == RC_SUCCESS) {
+            status = reader->ReadPod(&param->max_value);
+        }
+        *attr = param;
+    } else if (kind == PRIVATE_PARAM_SLICE) {
+        auto param = make_shared<ppl::nn::onnx::SliceParam>();
+        status = reader->ReadVector(&param->axes);
+        if (status == RC_SUCCESS) {
+            status = reader->ReadVector(&param->ends);
+        }
+        if (status == RC_SUCCESS) {
+            status = reader->ReadVector(&param->starts);
+        }
+        *attr = param;
+    } else if (kind == PRIVATE_PARAM_CONSTANT_OF_SHAPE) {
+        auto param = make_shared<ppl::nn::onnx::ConstantOfShapeParam>();
+        status = reader->ReadPod(&param->data_type);
+        if (status == RC_SUCCESS) {
+            status = reader->ReadVector(&param->dims);
+        }
+        if (status == RC_SUCCESS) {
+            status = reader->ReadString(&param->data);
+        }
+        *attr = param;
+    } else if (kind == PRIVATE_PARAM_CHANNEL_SHUFFLE) {
+        auto param = make_shared<ppl::nn::pmx::ChannelShuffleParam>();
+        status = reader->ReadPod(&param->group);
+        *attr = param;
+    } else if (kind == PRIVATE_PARAM_SWISH) {
+        auto param = make_shared<ppl::nn::pmx::SwishParam>();
+        status = reader->ReadPod(&param->beta);
+        *attr = param;
+    } else if (kind == PRIVATE_PARAM_SHAPE_OPERATION) {
+        auto param = make_shared<ppl::nn::pmx::ShapeOperationParam>();
+        uint64_t count = 0;
+        status = reader->ReadPod(&count);
+        for (uint64_t i = 0; i < count && status == RC_SUCCESS; ++i) {
+            edgeid_t eid;
+            ppl::nn::pmx::ShapeMatrix matrix;
+            status = reader->ReadPod(&eid);
+            if (status == RC_SUCCESS) {
+                status = reader->ReadPod(&matrix);
+            }
+            param->alpha.insert(make_pair(eid, matrix));
+        }
+        *attr = param;
+    } else if (kind == PRIVATE_PARAM_GRU) {
+        auto param = make_shared<ppl::nn::onnx::GRUParam>();
+        status = reader->ReadVector(&param->activation_alpha);
+        if (status == RC_SUCCESS) {
+            status = reader->ReadVector(&param->activation_beta);
+        }
+        if (status == RC_SUCCESS) {
+            status = reader->ReadVector(&param->activations);
+        }
+        if (status == RC_SUCCESS) {
+            status = reader->ReadPod(&param->clip);
+        }
+        if (status == RC_SUCCESS) {
+            status = reader->ReadPod(&param->direction);
+        }
+        if (status == RC_SUCCESS) {
+            status = reader->ReadPod(&param->hidden_size);
+        }
+        if (status == RC_SUCCESS) {
+            status = reader->ReadPod(&param->linear_before_reset);
+        }
+        *attr = param;
+    } else if (kind == PRIVATE_PARAM_RNN) {
+        auto param = make_shared<ppl::nn::onnx::RNNParam>();
+        status = reader->ReadVector(&param->activation_alpha);
+        if (status == RC_SUCCESS) {
+            status = reader->ReadVector(&param->activation_beta);
+        }
+        if (status == RC_SUCCESS) {
+            status = reader->ReadVector(&param->activations);
+        }
+        if (status == RC_SUCCESS) {
+            status = reader->ReadPod(&param->clip);
+        }
+        if (status == RC_SUCCESS) {
+            status = reader->ReadPod(&param->direction);
+        }
+        if (status == RC_SUCCESS) {
+            status = reader->ReadPod(&param->hidden_size);
+        }
+        *attr = param;
+    } else if (kind == PRIVATE_PARAM_LAYER_NORM) {
+        auto param = make_shared<ppl::nn::pmx::LayerNormParam>();
+        status = reader->ReadPod(&param->elementwise_affine);
+        if (status == RC_SUCCESS) {
+            status = reader->ReadPod(&param->axis);
+        }
+        if (status == RC_SUCCESS) {
+            status = reader->ReadPod(&param->eps);
+        }
+        *attr = param;
+    } else if (kind == PRIVATE_PARAM_GELU) {
+        auto param = make_shared<ppl::nn::pmx::GELUParam>();
+        status = reader->ReadPod(&param->approximate);
+        *attr = param;
+    } else if (kind == PRIVATE_PARAM_MULTI_HEAD_ATTENTION) {
+        auto param = make_shared<ppl::nn::pmx::MultiHeadAttentionParam>();
+        status = reader->ReadPod(&param->num_heads);
+        if (status == RC_SUCCESS) {
+            status = reader->ReadPod(&param->scale);
+        }
+        *attr = param;
+    } else {
+        LOG(ERROR) << "unsupported private param type[" << kind << "]";
+        return RC_UNSUPPORTED;
+    }
+
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "read private param of type[" << kind << "] failed: " << GetRetCodeStr(status);
+    }
+    return status;
+}
+
+RetCode DeserializeOpParam(const pmx::onnx::OpParam& fb_op_param, DataReader* private_data,
+                           shared_ptr<ir::Attr>* param) {
+    uint32_t kind = PRIVATE_PARAM_NONE;
+    auto status = private_data->ReadPod(&kind);
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "read type of private param failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    if (kind != PRIVATE_PARAM_NONE) {
+        return DeserializePrivateParam(kind, private_data, param);
+    }
+
+    if (fb_op_param.value_type() == pmx::onnx::OpParamType_NONE) {
+        param->reset();
+        return RC_SUCCESS;
+    }
+
+    return DeserializeFbParam(fb_op_param, param);
+}
+
+}}} // namespace ppl::nn::x86
+
+#endif
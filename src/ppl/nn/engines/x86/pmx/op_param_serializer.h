@@ -0,0 +1,45 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef _ST_HPC_PPL_NN_ENGINES_X86_PMX_OP_PARAM_SERIALIZER_H_
+#define _ST_HPC_PPL_NN_ENGINES_X86_PMX_OP_PARAM_SERIALIZER_H_
+
+#include "ppl/nn/ir/graph.h"
+#include "ppl/nn/models/pmx/serialization_context.h"
+#include "ppl/nn/models/pmx/generated/onnx_op_generated.h"
+#include "ppl/nn/engines/x86/pmx/serialization_utils.h"
+#include <memory>
+
+namespace ppl { namespace nn { namespace x86 {
+
+/**
+   @brief serializes `param` loaded by an op.
+   params that have a slot in `pmx::onnx::OpParamType` are stored in `fb_type` and `fb_value`. others(and
+   the tag indicating which kind of param it is) are written into `private_data`.
+   @note `param` can be nullptr, which means that the op has no param.
+*/
+ppl::common::RetCode SerializeOpParam(const pmx::SerializationContext&, const ir::Attr* param,
+                                      flatbuffers::FlatBufferBuilder*, pmx::onnx::OpParamType* fb_type,
+                                      flatbuffers::Offset<void>* fb_value, utils::DataStream* private_data);
+
+/** @brief reverse operation of `SerializeOpParam()`. `param` is set to nullptr if the op has no param. */
+ppl::common::RetCode DeserializeOpParam(const pmx::onnx::OpParam&, DataReader* private_data,
+                                        std::shared_ptr<ir::Attr>* param);
+
+}}} // namespace ppl::nn::x86
+
+#endif
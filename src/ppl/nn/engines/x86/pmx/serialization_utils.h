@@ -0,0 +1,112 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef _ST_HPC_PPL_NN_ENGINES_X86_PMX_SERIALIZATION_UTILS_H_
+#define _ST_HPC_PPL_NN_ENGINES_X86_PMX_SERIALIZATION_UTILS_H_
+
+#include "ppl/common/retcode.h"
+#include "ppl/nn/utils/data_stream.h"
+#include <string>
+#include <vector>
+#include <cstring> // memcpy
+
+namespace ppl { namespace nn { namespace x86 {
+
+/** @brief reads data written by functions below from a memory buffer */
+class DataReader final {
+public:
+    DataReader(const void* base, uint64_t size) : base_((const char*)base), size_(size) {}
+
+    ppl::common::RetCode Read(void* dst, uint64_t bytes) {
+        if (bytes > size_ - offset_) {
+            return ppl::common::RC_INVALID_VALUE;
+        }
+        if (bytes > 0) {
+            memcpy(dst, base_ + offset_, bytes);
+            offset_ += bytes;
+        }
+        return ppl::common::RC_SUCCESS;
+    }
+
+    template <typename T>
+    ppl::common::RetCode ReadPod(T* value) {
+        return Read(value, sizeof(T));
+    }
+
+    template <typename T>
+    ppl::common::RetCode ReadVector(std::vector<T>* vec) {
+        uint64_t count = 0;
+        auto status = ReadPod(&count);
+        if (status != ppl::common::RC_SUCCESS) {
+            return status;
+        }
+        if (count > (size_ - offset_) / sizeof(T)) {
+            return ppl::common::RC_INVALID_VALUE;
+        }
+        vec->resize(count);
+        return Read(vec->data(), count * sizeof(T));
+    }
+
+    ppl::common::RetCode ReadString(std::string* str) {
+        uint64_t len = 0;
+        auto status = ReadPod(&len);
+        if (status != ppl::common::RC_SUCCESS) {
+            return status;
+        }
+        if (len > size_ - offset_) {
+            return ppl::common::RC_INVALID_VALUE;
+        }
+        str->assign(base_ + offset_, len);
+        offset_ += len;
+        return ppl::common::RC_SUCCESS;
+    }
+
+    uint64_t GetRemainingBytes() const {
+        return size_ - offset_;
+    }
+
+private:
+    const char* base_;
+    const uint64_t size_;
+    uint64_t offset_ = 0;
+};
+
+template <typename T>
+static inline ppl::common::RetCode WritePod(const T& value, utils::DataStream* ds) {
+    return ds->Write(&value, sizeof(T));
+}
+
+template <typename T>
+static inline ppl::common::RetCode WriteVector(const std::vector<T>& vec, utils::DataStream* ds) {
+    auto status = WritePod((uint64_t)vec.size(), ds);
+    if (status != ppl::common::RC_SUCCESS || vec.empty()) {
+        return status;
+    }
+    return ds->Write(vec.data(), vec.size() * sizeof(T));
+}
+
+static inline ppl::common::RetCode WriteString(const std::string& str, utils::DataStream* ds) {
+    auto status = WritePod((uint64_t)str.size(), ds);
+    if (status != ppl::common::RC_SUCCESS || str.empty()) {
+        return status;
+    }
+    return ds->Write(str.data(), str.size());
+}
+
+}}} // namespace ppl::nn::x86
+
+#endif
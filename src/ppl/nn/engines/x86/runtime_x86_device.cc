@@ -17,11 +17,16 @@
 
 #include "ppl/nn/engines/x86/options.h"
 #include "ppl/nn/engines/x86/runtime_x86_device.h"
+#include "ppl/nn/engines/x86/utils.h"
 #include "ppl/nn/utils/stack_buffer_manager.h"
 #include "ppl/nn/utils/compact_buffer_manager.h"
+#include "ppl/nn/utils/planned_buffer_manager.h"
 #include "ppl/nn/utils/cpu_block_allocator.h"
 #include "ppl/nn/common/logger.h"
+#include "ppl/nn/utils/trace_recorder.h"
+#include "ppl/kernel/x86/common/threading_tools.h"
 #include <stdarg.h>
+#include <atomic>
 using namespace std;
 using namespace ppl::common;
 
@@ -38,6 +43,10 @@ RuntimeX86Device::RuntimeX86Device(uint64_t alignment, isa_t isa, uint32_t mm_po
     } else if (mm_policy_ == MM_COMPACT) {
         allocator_.reset(new utils::CpuBlockAllocator());
         buffer_manager_.reset(new utils::CompactBufferManager(allocator_.get(), alignment, 64u));
+    } else if (mm_policy_ == MM_STATIC_PLAN) {
+        allocator_.reset(new utils::CpuBlockAllocator());
+        auto fallback = new utils::CompactBufferManager(allocator_.get(), alignment, 64u);
+        buffer_manager_.reset(new utils::PlannedBufferManager(fallback, alignment));
     }
 }
 
@@ -47,17 +56,88 @@ RuntimeX86Device::~RuntimeX86Device() {
     if (tmp_buffer_size_) {
         buffer_manager_->Free(&shared_tmp_buffer_);
     }
+    FreeInplaceBuffers();
+    for (auto it = shared_buffers_.begin(); it != shared_buffers_.end(); ++it) {
+        buffer_manager_->Free(&it->second.buffer);
+    }
     buffer_manager_.reset();
 }
 
+#ifdef PPLNN_ENABLE_KERNEL_PROFILING
+static void TraceMemoryEvent(const char* name, uint64_t bytes, const utils::BufferManager* mgr) {
+    auto recorder = utils::TraceRecorder::GetInstance();
+    if (recorder->IsEnabled()) {
+        recorder->AddInstantEvent("memory", name, bytes);
+        recorder->AddCounterEvent("memory", "x86 allocated bytes", mgr->GetAllocatedBytes());
+    }
+}
+#endif
+
+RetCode RuntimeX86Device::DoRealloc(uint64_t bytes, BufferDesc* buffer) {
+    if (buffer->addr && ReleaseSharedView(buffer)) {
+        buffer->addr = nullptr;
+    }
+
+    auto status = buffer_manager_->Realloc(bytes, buffer);
+#ifdef PPLNN_ENABLE_KERNEL_PROFILING
+    TraceMemoryEvent("Realloc", bytes, buffer_manager_.get());
+#endif
+    return status;
+}
+
+void RuntimeX86Device::DoFree(BufferDesc* buffer) {
+    if (ReleaseSharedView(buffer)) {
+        return;
+    }
+
+    buffer_manager_->Free(buffer);
+#ifdef PPLNN_ENABLE_KERNEL_PROFILING
+    TraceMemoryEvent("Free", 0, buffer_manager_.get());
+#endif
+}
+
+RetCode RuntimeX86Device::Realloc(uint64_t bytes, BufferDesc* buffer) {
+    if (max_concurrent_kernels_ > 1) {
+        lock_guard<mutex> lck(mm_mutex_);
+        return DoRealloc(bytes, buffer);
+    }
+    return DoRealloc(bytes, buffer);
+}
+
+void RuntimeX86Device::Free(BufferDesc* buffer) {
+    if (max_concurrent_kernels_ > 1) {
+        lock_guard<mutex> lck(mm_mutex_);
+        DoFree(buffer);
+        return;
+    }
+    DoFree(buffer);
+}
+
 RetCode RuntimeX86Device::AllocTmpBuffer(uint64_t bytes, BufferDesc* buffer) {
-    if (mm_policy_ == MM_COMPACT) {
+#ifdef PPLNN_ENABLE_KERNEL_PROFILING
+    auto recorder = utils::TraceRecorder::GetInstance();
+    if (recorder->IsEnabled()) {
+        recorder->AddCounterEvent("memory", "x86 tmp buffer bytes", bytes);
+    }
+#endif
+
+    if (max_concurrent_kernels_ > 1) {
+        // the shared tmp buffer cannot be used by kernels running concurrently
+        buffer->addr = nullptr;
+        return Realloc(bytes, buffer);
+    }
+
+    if (mm_policy_ == MM_STATIC_PLAN) {
+        // tmp buffers are allocated and freed by each kernel in the same order, which are served by the plan
         auto ret = buffer_manager_->Realloc(bytes, &shared_tmp_buffer_);
         if (RC_SUCCESS != ret) {
             return ret;
         }
     } else {
-        if (bytes > tmp_buffer_size_ || bytes <= tmp_buffer_size_ / 2) {
+        // the shared tmp buffer only grows during a run so that it is reserved once for the max size required by
+        // kernels. it may be shrunk in `BeforeRun()`.
+        run_max_tmp_bytes_ = std::max(run_max_tmp_bytes_, bytes);
+        if (bytes > tmp_buffer_size_) {
             auto ret = buffer_manager_->Realloc(bytes, &shared_tmp_buffer_);
             if (RC_SUCCESS != ret) {
                 return ret;
@@ -70,19 +150,314 @@ RetCode RuntimeX86Device::AllocTmpBuffer(uint64_t bytes, BufferDesc* buffer) {
 }
 
 void RuntimeX86Device::FreeTmpBuffer(BufferDesc* buffer) {
-    if (mm_policy_ == MM_COMPACT) {
+    if (max_concurrent_kernels_ > 1) {
+        Free(buffer);
+        return;
+    }
+
+    if (mm_policy_ == MM_STATIC_PLAN) {
         buffer_manager_->Free(&shared_tmp_buffer_);
     }
 }
 
+RetCode RuntimeX86Device::SetMaxConcurrentKernels(uint32_t n) {
+    if (n == 0) {
+        LOG(ERROR) << "max concurrent kernels should be greater than 0.";
+        return RC_INVALID_VALUE;
+    }
+
+    if (n > 1 && mm_policy_ == MM_STATIC_PLAN) {
+        // allocation order of kernels running concurrently is not deterministic
+        static_cast<utils::PlannedBufferManager*>(buffer_manager_.get())->Disable();
+    }
+
+    max_concurrent_kernels_ = n;
+    UpdateOmpThreadsPerKernel();
+
+    return RC_SUCCESS;
+}
+
+void RuntimeX86Device::UpdateOmpThreadsPerKernel() {
+    uint32_t max_threads = omp_threads_;
+    if (max_threads == 0 && !core_set_.empty()) {
+        max_threads = core_set_.size();
+    }
+
+    if (max_concurrent_kernels_ > 1) {
+        if (max_threads == 0) {
+            max_threads = (uint32_t)ppl::kernel::x86::get_omp_max_threads();
+        }
+        omp_threads_per_kernel_ = std::max(max_threads / max_concurrent_kernels_, 1u);
+    } else {
+        omp_threads_per_kernel_ = max_threads;
+    }
+}
+
+static atomic<uint64_t> g_core_set_seq(0);
+static thread_local uint64_t g_bound_core_set_id = 0;
+
+void RuntimeX86Device::BindOmpThreads() {
+    // the OpenMP team of a thread is reused by following parallel regions, so it is bound only once
+    if (core_set_.empty() || g_bound_core_set_id == core_set_id_) {
+        return;
+    }
+    ppl::kernel::x86::set_omp_core_affinity(core_set_.data(), core_set_.size(), (max_concurrent_kernels_ == 1));
+    g_bound_core_set_id = core_set_id_;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/*
+  in-place buffers are kept across runs. they are allocated by the generic allocator instead of `buffer_manager_` so
+  that they are never placed in the arena of MM_STATIC_PLAN, whose regions are reused by other buffers in each run.
+*/
+
+void RuntimeX86Device::FreeInplaceBuffer(InplaceBuffer* ib) {
+    X86Device::Free(&ib->buffer);
+    ib->buffer.addr = nullptr;
+    ib->bytes = 0;
+    for (auto s = ib->slices.begin(); s != ib->slices.end(); ++s) {
+        inplace_slices_.erase(s->eid);
+    }
+    ib->slices.clear();
+}
+
+void RuntimeX86Device::FreeInplaceBuffers() {
+    for (auto it = inplace_buffers_.begin(); it != inplace_buffers_.end(); ++it) {
+        FreeInplaceBuffer(&it->second);
+    }
+    inplace_buffers_.clear();
+    inplace_slices_.clear();
+}
+
+InplaceBuffer* RuntimeX86Device::FindInplaceBuffer(edgeid_t eid) {
+    // kernels running concurrently may access `inplace_buffers_` at the same time
+    if (max_concurrent_kernels_ > 1) {
+        return nullptr;
+    }
+    auto ref = inplace_buffers_.find(eid);
+    return (ref == inplace_buffers_.end()) ? nullptr : &ref->second;
+}
+
+RetCode RuntimeX86Device::AllocInplaceBuffer(edgeid_t eid, uint64_t bytes, InplaceBuffer** res) {
+    if (max_concurrent_kernels_ > 1) {
+        return RC_UNSUPPORTED;
+    }
+
+    auto ib = &inplace_buffers_[eid];
+    FreeInplaceBuffer(ib);
+
+    auto status = X86Device::Realloc(bytes, &ib->buffer);
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "alloc in-place buffer of [" << bytes << "] bytes failed: " << GetRetCodeStr(status);
+        inplace_buffers_.erase(eid);
+        return status;
+    }
+    ib->bytes = bytes;
+
+    if (mm_policy_ == MM_STATIC_PLAN) {
+        // inputs of the Concat will be slices of this buffer in the following runs, which changes the allocation
+        // sequence recorded in this run.
+        static_cast<utils::PlannedBufferManager*>(buffer_manager_.get())->RestartRecording();
+    }
+
+    *res = ib;
+    return RC_SUCCESS;
+}
+
+/*
+  shared buffers are allocated by `buffer_manager_` and only live in one run. views are told apart by their addresses,
+  which are unique because views are not empty. not supported by MM_STATIC_PLAN, whose plan is based on the
+  allocation sequence of tensors.
+*/
+
+RetCode RuntimeX86Device::ShareBuffer(const BufferDesc& buffer, uint64_t bytes, const uint64_t* offsets,
+                                      uint32_t count, BufferDesc* views) {
+    if (max_concurrent_kernels_ > 1 || mm_policy_ == MM_STATIC_PLAN || count == 0) {
+        return RC_UNSUPPORTED;
+    }
+
+    auto base = (char*)buffer.addr;
+    auto& shared = shared_buffers_[base];
+    shared.buffer = buffer;
+    shared.bytes = bytes;
+    shared.ref_count = count;
+    for (uint32_t i = 0; i < count; ++i) {
+        views[i] = BufferDesc(base + offsets[i]);
+    }
+    return RC_SUCCESS;
+}
+
+// returns false if `view` is not created by `ShareBuffer()`
+bool RuntimeX86Device::ReleaseSharedView(BufferDesc* view) {
+    if (shared_buffers_.empty()) {
+        return false;
+    }
+
+    auto addr = (const char*)view->addr;
+    auto ref = shared_buffers_.upper_bound(addr);
+    if (ref == shared_buffers_.begin()) {
+        return false;
+    }
+    --ref;
+    if (addr >= ref->first + ref->second.bytes) {
+        return false;
+    }
+
+    --ref->second.ref_count;
+    if (ref->second.ref_count == 0) {
+        buffer_manager_->Free(&ref->second.buffer);
+        shared_buffers_.erase(ref);
+    }
+    view->addr = nullptr;
+    return true;
+}
+
+void RuntimeX86Device::SetInplaceSlices(InplaceBuffer* ib, vector<InplaceBuffer::Slice>&& slices) {
+    for (auto s = ib->slices.begin(); s != ib->slices.end(); ++s) {
+        inplace_slices_.erase(s->eid);
+    }
+    ib->slices = std::move(slices);
+    for (uint32_t i = 0; i < ib->slices.size(); ++i) {
+        inplace_slices_[ib->slices[i].eid] = make_pair(ib, i);
+    }
+}
+
+bool RuntimeX86Device::FindInplaceSlice(edgeid_t eid, const TensorShape& shape, BufferDesc* view) const {
+    if (inplace_slices_.empty() || max_concurrent_kernels_ > 1) {
+        return false;
+    }
+
+    auto ref = inplace_slices_.find(eid);
+    if (ref == inplace_slices_.end()) {
+        return false;
+    }
+
+    auto ib = ref->second.first;
+    auto& slice = ib->slices[ref->second.second];
+    if (!TensorShapeEqual(shape, slice.shape) ||
+        shape.GetBytesIncludingPadding() != slice.shape.GetBytesIncludingPadding()) {
+        return false;
+    }
+
+    *view = BufferDesc((char*)ib->buffer.addr + slice.offset);
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+RetCode RuntimeX86Device::BeforeRun() {
+    if (mm_policy_ == MM_STATIC_PLAN) {
+        return static_cast<utils::PlannedBufferManager*>(buffer_manager_.get())->BeginRun();
+    }
+
+    // shapes changed and the last run required much less tmp memory than reserved
+    if (run_max_tmp_bytes_ > 0 && run_max_tmp_bytes_ <= tmp_buffer_size_ / 2) {
+        auto status = buffer_manager_->Realloc(run_max_tmp_bytes_, &shared_tmp_buffer_);
+        if (status != RC_SUCCESS) {
+            LOG(ERROR) << "realloc tmp buffer of [" << run_max_tmp_bytes_ << "] bytes failed: " << GetRetCodeStr(status);
+            return status;
+        }
+        tmp_buffer_size_ = run_max_tmp_bytes_;
+    }
+    run_max_tmp_bytes_ = 0;
+
+    return RC_SUCCESS;
+}
+
 /* -------------------------------------------------------------------------- */
 
 RetCode RuntimeX86Device::DoMemDefrag(RuntimeX86Device* dev, va_list) {
+    if (dev->mm_policy_ == MM_STATIC_PLAN) {
+        LOG(ERROR) << "memory defragmentation is not supported by MM_STATIC_PLAN.";
+        return RC_UNSUPPORTED;
+    }
+
+    auto prev_bytes = dev->buffer_manager_->GetAllocatedBytes();
+
+    // shared tmp buffer will be reallocated by the next kernel which needs it
+    if (dev->tmp_buffer_size_ > 0) {
+        dev->buffer_manager_->Free(&dev->shared_tmp_buffer_);
+        dev->shared_tmp_buffer_.addr = nullptr;
+        dev->tmp_buffer_size_ = 0;
+    }
+    dev->run_max_tmp_bytes_ = 0;
+
+    // in-place buffers will be allocated again by in-place Concats in the next run
+    dev->FreeInplaceBuffers();
+
+    if (dev->mm_policy_ == MM_COMPACT) {
+        auto status = static_cast<utils::CompactBufferManager*>(dev->buffer_manager_.get())->Defragment();
+        if (status != RC_SUCCESS) {
+            LOG(ERROR) << "defragment failed: " << GetRetCodeStr(status);
+            return status;
+        }
+    } else if (dev->mm_policy_ == MM_MRU) {
+        static_cast<utils::StackBufferManager*>(dev->buffer_manager_.get())->Defragment();
+    }
+
+    auto cur_bytes = dev->buffer_manager_->GetAllocatedBytes();
+    dev->defrag_reclaimed_bytes_ = (prev_bytes > cur_bytes) ? (prev_bytes - cur_bytes) : 0;
+    LOG(DEBUG) << "buffer manager[" << dev->buffer_manager_->GetName() << "] reclaims ["
+               << dev->defrag_reclaimed_bytes_ << "] bytes.";
+
+    return RC_SUCCESS;
+}
+
+RetCode RuntimeX86Device::GetMemPlanInfo(RuntimeX86Device* dev, va_list args) {
+    if (dev->mm_policy_ != MM_STATIC_PLAN) {
+        LOG(ERROR) << "memory plan is only available when mm_policy is MM_STATIC_PLAN.";
+        return RC_UNSUPPORTED;
+    }
+
+    auto mgr = static_cast<utils::PlannedBufferManager*>(dev->buffer_manager_.get());
+    auto planned_bytes = va_arg(args, uint64_t*);
+    auto fragmentation_ratio = va_arg(args, float*);
+    auto allocated_bytes = va_arg(args, uint64_t*);
+
+    *planned_bytes = mgr->GetPlannedBytes();
+    *fragmentation_ratio = mgr->GetFragmentationRatio();
+    *allocated_bytes = mgr->GetAllocatedBytes();
+    return RC_SUCCESS;
+}
+
+RetCode RuntimeX86Device::GetDefragReclaimedBytes(RuntimeX86Device* dev, va_list args) {
+    auto reclaimed_bytes = va_arg(args, uint64_t*);
+    *reclaimed_bytes = dev->defrag_reclaimed_bytes_;
+    return RC_SUCCESS;
+}
+
+RetCode RuntimeX86Device::SetOmpThreads(RuntimeX86Device* dev, va_list args) {
+    dev->omp_threads_ = va_arg(args, uint32_t);
+    dev->UpdateOmpThreadsPerKernel();
+    return RC_SUCCESS;
+}
+
+RetCode RuntimeX86Device::SetCoreSet(RuntimeX86Device* dev, va_list args) {
+    auto cores = va_arg(args, const int32_t*);
+    auto num_cores = va_arg(args, uint32_t);
+    if (num_cores > 0 && !cores) {
+        LOG(ERROR) << "core list is empty.";
+        return RC_INVALID_VALUE;
+    }
+
+    if (num_cores > 0) {
+        dev->core_set_.assign(cores, cores + num_cores);
+        dev->core_set_id_ = ++g_core_set_seq;
+    } else {
+        dev->core_set_.clear();
+        dev->core_set_id_ = 0;
+    }
+    dev->UpdateOmpThreadsPerKernel();
     return RC_SUCCESS;
 }
 
 RuntimeX86Device::ConfHandlerFunc RuntimeX86Device::conf_handlers_[] = {
     DoMemDefrag, // DEV_CONF_MEM_DEFRAG
+    GetMemPlanInfo, // DEV_CONF_GET_MEM_PLAN_INFO
+    GetDefragReclaimedBytes, // DEV_CONF_GET_DEFRAG_RECLAIMED_BYTES
+    SetOmpThreads, // DEV_CONF_SET_OMP_THREADS
+    SetCoreSet, // DEV_CONF_SET_CORE_SET
 };
 
 RetCode RuntimeX86Device::Configure(uint32_t option, ...) {
@@ -22,6 +22,9 @@
 #include "ppl/nn/utils/buffer_manager.h"
 #include "ppl/common/allocator.h"
 #include <memory>
+#include <mutex>
+#include <vector>
+#include <map>
 
 namespace ppl { namespace nn { namespace x86 {
 
@@ -39,34 +42,90 @@ public:
         return allocator_.get();
     }
 
-    ppl::common::RetCode Realloc(uint64_t bytes, BufferDesc* buffer) override {
-        return buffer_manager_->Realloc(bytes, buffer);
-    }
-
-    void Free(BufferDesc* buffer) override {
-        buffer_manager_->Free(buffer);
-    }
+    ppl::common::RetCode Realloc(uint64_t bytes, BufferDesc* buffer) override;
+    void Free(BufferDesc* buffer) override;
 
     ppl::common::RetCode AllocTmpBuffer(uint64_t bytes, BufferDesc* buffer) override;
     void FreeTmpBuffer(BufferDesc* buffer) override;
 
+    /**
+       @brief allows at most `n` kernels to use this device at the same time.
+       if `n` > 1, allocations are serialized, each kernel gets its own tmp buffer and
+       OpenMP threads are divided evenly among kernels.
+    */
+    ppl::common::RetCode SetMaxConcurrentKernels(uint32_t n);
+
+    /** @brief called before each run. the shared tmp buffer may be shrunk if it is much larger than needed. */
+    ppl::common::RetCode BeforeRun();
+
+    uint32_t GetOmpThreadsPerKernel() const override {
+        return omp_threads_per_kernel_;
+    }
+
+    void BindOmpThreads() override;
+
+    InplaceBuffer* FindInplaceBuffer(edgeid_t eid) override;
+    ppl::common::RetCode AllocInplaceBuffer(edgeid_t eid, uint64_t bytes, InplaceBuffer**) override;
+    ppl::common::RetCode ShareBuffer(const BufferDesc& buffer, uint64_t bytes, const uint64_t* offsets,
+                                     uint32_t count, BufferDesc* views) override;
+    void SetInplaceSlices(InplaceBuffer* ib, std::vector<InplaceBuffer::Slice>&& slices) override;
+    bool FindInplaceSlice(edgeid_t eid, const TensorShape& shape, BufferDesc* view) const override;
+
     // ----- configurations ----- //
 
     /**
-       @brief replaces all blocks with a single block.
+       @brief releases unused memory. blocks are replaced with a single block for MM_COMPACT and
+       cached buffers are freed for MM_MRU.
        @note make sure that this device is not used when calling DoMemDefrag().
     */
     static ppl::common::RetCode DoMemDefrag(RuntimeX86Device*, va_list);
+    static ppl::common::RetCode GetMemPlanInfo(RuntimeX86Device*, va_list);
+    static ppl::common::RetCode GetDefragReclaimedBytes(RuntimeX86Device*, va_list);
+    static ppl::common::RetCode SetOmpThreads(RuntimeX86Device*, va_list);
+    static ppl::common::RetCode SetCoreSet(RuntimeX86Device*, va_list);
 
     typedef ppl::common::RetCode (*ConfHandlerFunc)(RuntimeX86Device*, va_list);
     static ConfHandlerFunc conf_handlers_[DEV_CONF_MAX];
 
     ppl::common::RetCode Configure(uint32_t, ...) override;
 
+private:
+    void UpdateOmpThreadsPerKernel();
+    ppl::common::RetCode DoRealloc(uint64_t bytes, BufferDesc* buffer);
+    void DoFree(BufferDesc* buffer);
+    void FreeInplaceBuffer(InplaceBuffer*);
+    void FreeInplaceBuffers();
+    bool ReleaseSharedView(BufferDesc* view);
+
+private:
+    struct SharedBuffer final {
+        BufferDesc buffer;
+        uint64_t bytes;
+        uint32_t ref_count;
+    };
+
 private:
     uint32_t mm_policy_;
     BufferDesc shared_tmp_buffer_;
+    /** reserved size of `shared_tmp_buffer_`. always 0 for MM_STATIC_PLAN. */
     uint64_t tmp_buffer_size_;
+    /** max tmp buffer size required by kernels in the current run */
+    uint64_t run_max_tmp_bytes_ = 0;
+    uint64_t defrag_reclaimed_bytes_ = 0;
+    uint32_t max_concurrent_kernels_ = 1;
+    uint32_t omp_threads_per_kernel_ = 0;
+    /** max OpenMP threads of this device. 0 means no limitation. */
+    uint32_t omp_threads_ = 0;
+    std::vector<int32_t> core_set_;
+    /** unique among all devices. threads bound to the current `core_set_` record it. */
+    uint64_t core_set_id_ = 0;
+    std::mutex mm_mutex_;
+    /** edge id => buffer kept across runs by an in-place Concat/Split */
+    std::map<edgeid_t, InplaceBuffer> inplace_buffers_;
+    /** edge id => (buffer, index of slice) of inputs of in-place Concats */
+    std::map<edgeid_t, std::pair<const InplaceBuffer*, uint32_t>> inplace_slices_;
+    /** address => buffer split into views by `ShareBuffer()`(inputs of in-place Splits) */
+    std::map<const char*, SharedBuffer> shared_buffers_;
     std::unique_ptr<utils::BufferManager> buffer_manager_;
     std::shared_ptr<ppl::common::Allocator> allocator_;
 };
@@ -19,6 +19,7 @@
 #define _ST_HPC_PPL_NN_ENGINES_X86_UTILS_H_
 
 #include "ppl/nn/common/tensor_shape.h"
+#include <vector>
 
 namespace ppl { namespace nn { namespace x86 {
 
@@ -46,6 +47,47 @@ inline bool TensorShapeEqual(const TensorShape &a, const TensorShape &b) {
     return true;
 }
 
+/**
+   @brief calculates byte offsets of `slices` in `whole`, which is the concatenation of `slices` along `axis`.
+   @return false if some slice is not stored contiguously in `whole` or its offset is not aligned to `alignment`.
+*/
+inline bool CalcContiguousSliceOffsets(const TensorShape& whole, const TensorShape* const* slices, uint32_t slice_count,
+                                       uint32_t axis, uint64_t alignment, std::vector<uint64_t>* offsets) {
+    auto data_format = whole.GetDataFormat();
+    if (data_format == ppl::common::DATAFORMAT_NDARRAY) {
+        // slices are contiguous if all outer dims are 1
+        for (uint32_t i = 0; i < axis; ++i) {
+            if (whole.GetDim(i) != 1) {
+                return false;
+            }
+        }
+    } else if (data_format == ppl::common::DATAFORMAT_N16CX) {
+        // channel blocks of different slices must not be interleaved
+        if (axis != 1 || whole.GetDim(0) != 1) {
+            return false;
+        }
+        for (uint32_t i = 0; i + 1 < slice_count; ++i) {
+            if (slices[i]->GetDim(1) % 16 != 0) {
+                return false;
+            }
+        }
+    } else {
+        return false;
+    }
+
+    offsets->resize(slice_count);
+    uint64_t offset = 0;
+    for (uint32_t i = 0; i < slice_count; ++i) {
+        if (offset % alignment != 0) {
+            return false;
+        }
+        offsets->at(i) = offset;
+        offset += slices[i]->GetBytesIncludingPadding();
+    }
+
+    return (offset == whole.GetBytesIncludingPadding());
+}
+
 }}}; // namespace
 
 #endif
@@ -22,9 +22,26 @@
 #include "ppl/nn/engines/x86/data_converter.h"
 #include "ppl/common/generic_cpu_allocator.h"
 #include <cstring> // memcpy
+#include <vector>
 
 namespace ppl { namespace nn { namespace x86 {
 
+/**
+   @brief a buffer kept across runs by an in-place Concat. its slices are used as buffers of inputs of the Concat so
+   that data need not be copied.
+*/
+struct InplaceBuffer final {
+    struct Slice final {
+        edgeid_t eid;
+        TensorShape shape;
+        uint64_t offset;
+    };
+
+    BufferDesc buffer;
+    uint64_t bytes = 0;
+    std::vector<Slice> slices;
+};
+
 class X86Device : public Device {
 public:
     X86Device(uint64_t alignment, ppl::common::isa_t isa) : isa_(isa), data_converter_(isa), allocator_(alignment) {}
@@ -49,6 +66,48 @@ public:
         return &allocator_;
     }
 
+    /** @brief max number of OpenMP threads a kernel can use. 0 means no limitation. */
+    virtual uint32_t GetOmpThreadsPerKernel() const {
+        return 0;
+    }
+
+    /** @brief binds OpenMP threads started by the calling thread to cores of this device if necessary */
+    virtual void BindOmpThreads() {}
+
+    // ----- buffers of in-place Concat/Split ----- //
+
+    /** @return the in-place buffer of edge `eid`, or nullptr if not found or in-place buffers are not supported */
+    virtual InplaceBuffer* FindInplaceBuffer(edgeid_t eid) {
+        return nullptr;
+    }
+
+    /** @brief (re)allocates the in-place buffer of edge `eid`. contents and slices are discarded. */
+    virtual ppl::common::RetCode AllocInplaceBuffer(edgeid_t eid, uint64_t bytes, InplaceBuffer**) {
+        return ppl::common::RC_UNSUPPORTED;
+    }
+
+    /**
+       @brief takes over `buffer` of `bytes`, which is allocated by this device, and splits it into `count` views
+       starting at `offsets`. each view is non-empty and owned by whom it is given to. `buffer` is freed after all
+       views are freed by `Free()`(or `Realloc()`). the caller should detach `buffer` from its owner if RC_SUCCESS
+       is returned.
+    */
+    virtual ppl::common::RetCode ShareBuffer(const BufferDesc& buffer, uint64_t bytes, const uint64_t* offsets,
+                                             uint32_t count, BufferDesc* views) {
+        return ppl::common::RC_UNSUPPORTED;
+    }
+
+    /** @brief sets slices of `ib`, which can be found by `FindInplaceSlice()` later */
+    virtual void SetInplaceSlices(InplaceBuffer* ib, std::vector<InplaceBuffer::Slice>&& slices) {}
+
+    /**
+       @brief finds the slice used as the buffer of edge `eid` whose shape is `shape`.
+       @return true if found, and `view` points to the slice.
+    */
+    virtual bool FindInplaceSlice(edgeid_t eid, const TensorShape& shape, BufferDesc* view) const {
+        return false;
+    }
+
     ppl::common::RetCode Realloc(uint64_t bytes, BufferDesc* buffer) override {
         if (buffer->addr) {
             allocator_.Free(buffer->addr);
@@ -33,6 +33,7 @@
 #include "ppl/nn/models/onnx/parsers/onnx/parse_gather_param.h"
 #include "ppl/nn/models/onnx/parsers/onnx/parse_gather_nd_param.h"
 #include "ppl/nn/models/onnx/parsers/onnx/parse_gemm_param.h"
+#include "ppl/nn/models/onnx/parsers/onnx/parse_gru_param.h"
 #include "ppl/nn/models/onnx/parsers/onnx/parse_if_param.h"
 #include "ppl/nn/models/onnx/parsers/onnx/parse_instancenormalization_param.h"
 #include "ppl/nn/models/onnx/parsers/onnx/parse_leaky_relu_param.h"
@@ -45,6 +46,7 @@
 #include "ppl/nn/models/onnx/parsers/onnx/parse_pooling_param.h"
 #include "ppl/nn/models/onnx/parsers/onnx/parse_reduce_param.h"
 #include "ppl/nn/models/onnx/parsers/onnx/parse_resize_param.h"
+#include "ppl/nn/models/onnx/parsers/onnx/parse_rnn_param.h"
 #include "ppl/nn/models/onnx/parsers/onnx/parse_roialign_param.h"
 #include "ppl/nn/models/onnx/parsers/onnx/parse_scatter_elements_param.h"
 #include "ppl/nn/models/onnx/parsers/onnx/parse_slice_param.h"
@@ -155,6 +157,7 @@ ParamParserManager::ParamParserManager() {
     PPL_REGISTER_OP_WITH_PARAM("", "Gemm", 9, 16, ppl::nn::onnx::GemmParam, ParseGemmParam);
     PPL_REGISTER_OP_WITH_PARAM("", "GlobalAveragePool", 1, 16, ppl::nn::onnx::PoolingParam, ParsePoolingParam);
     PPL_REGISTER_OP_WITHOUT_PARAM("", "Greater", 7, 16);
+    PPL_REGISTER_OP_WITH_PARAM("", "GRU", 7, 13, ppl::nn::onnx::GRUParam, ParseGRUParam);
     // I
     PPL_REGISTER_OP_WITHOUT_PARAM("", "Identity", 1, 13);
     PPL_REGISTER_OP_WITH_PARAM("", "If", 1, 12, ppl::nn::onnx::IfParam, ParseIfParam);
@@ -194,6 +197,7 @@ ParamParserManager::ParamParserManager() {
     PPL_REGISTER_OP_WITHOUT_PARAM("", "Relu", 6, 16);
     PPL_REGISTER_OP_WITHOUT_PARAM("", "Reshape", 5, 13);
     PPL_REGISTER_OP_WITH_PARAM("", "Resize", 11, 16, ppl::nn::onnx::ResizeParam, ParseResizeParam);
+    PPL_REGISTER_OP_WITH_PARAM("", "RNN", 7, 13, ppl::nn::onnx::RNNParam, ParseRNNParam);
     PPL_REGISTER_OP_WITH_PARAM("", "RoiAlign", 10, 15, ppl::nn::onnx::RoiAlignParam, ParseRoiAlignParam);
     // S
     PPL_REGISTER_OP_WITH_PARAM("", "ScatterElements", 11, 15, ppl::nn::onnx::ScatterElementsParam,
@@ -0,0 +1,87 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <float.h>
+
+#include "ppl/nn/models/onnx/parsers/onnx/parse_rnn_param.h"
+#include "ppl/nn/common/logger.h"
+#include "ppl/nn/models/onnx/utils.h"
+using namespace std;
+using namespace ppl::common;
+using namespace ppl::nn::onnx;
+
+namespace ppl { namespace nn { namespace onnx {
+
+RetCode ParseRNNParam(const ::onnx::NodeProto& pb_node, const ParamParserExtraArgs& args, ir::Node*, ir::Attr* arg) {
+    auto param = static_cast<RNNParam*>(arg);
+
+    static const map<string, RNNParam::activation_t> act_map = {
+        {"Relu", RNNParam::ACT_RELU},
+        {"Tanh", RNNParam::ACT_TANH},
+        {"Sigmoid", RNNParam::ACT_SIGMOID},
+        {"Affine", RNNParam::ACT_AFFINE},
+        {"LeakyRelu", RNNParam::ACT_LEAKY_RELU},
+        {"ThresholdedRelu", RNNParam::ACT_THRESHOLDED_RELU},
+        {"ScaledTanh", RNNParam::ACT_SCALED_TANH},
+        {"HardSigmoid", RNNParam::ACT_HARD_SIGMOID},
+        {"Elu", RNNParam::ACT_ELU},
+        {"Softsign", RNNParam::ACT_SOFTSIGN},
+        {"Softplus", RNNParam::ACT_SOFTPLUS},
+    };
+
+    static const map<string, RNNParam::direction_t> direction_map = {
+        {"forward", RNNParam::DIR_FORWARD},
+        {"reverse", RNNParam::DIR_REVERSE},
+        {"bidirectional", RNNParam::DIR_BIDIRECTIONAL},
+    };
+
+    param->activation_alpha = utils::GetNodeAttrsByKey<float>(pb_node, "activation_alpha");
+    param->activation_beta = utils::GetNodeAttrsByKey<float>(pb_node, "activation_beta");
+
+    auto activations = utils::GetNodeAttrsByKey<string>(pb_node, "activations");
+    param->activations.resize(activations.size());
+    for (size_t i = 0; i < activations.size(); ++i) {
+        auto it = act_map.find(activations[i]);
+        if (it == act_map.end()) {
+            LOG(ERROR) << "Unsupported activation type: " << activations[i];
+            return RC_UNSUPPORTED;
+        }
+        param->activations[i] = it->second;
+    }
+
+    param->clip = utils::GetNodeAttrByKey<float>(pb_node, "clip", FLT_MAX);
+
+    auto direction = utils::GetNodeAttrByKey<string>(pb_node, "direction", "forward");
+    {
+        auto it = direction_map.find(direction);
+        if (it == direction_map.end()) {
+            LOG(ERROR) << "Unsupported direction type: " << direction;
+            return RC_UNSUPPORTED;
+        }
+        param->direction = it->second;
+    }
+
+    param->hidden_size = utils::GetNodeAttrByKey<int32_t>(pb_node, "hidden_size", INT32_MIN);
+    if (param->hidden_size == INT32_MIN) {
+        LOG(ERROR) << "hidden_size is not set but required";
+        return RC_INVALID_VALUE;
+    }
+
+    return RC_SUCCESS;
+}
+
+}}} // namespace ppl::nn::onnx
@@ -151,6 +151,10 @@ public:
                        const flatbuffers::Vector<flatbuffers::Offset<ppl::nn::pmx::Constant>>* fb_constants)
         : topo_(topo), shared_data_(shared_data), info_(info), fb_constants_(fb_constants) {}
 
+    bool IsDataPersistent() const override {
+        return (info_->constant_data_holder != nullptr);
+    }
+
     uint64_t CalcTotalBytes(uint64_t alignment) const override {
         uint64_t total_bytes = 0;
         for (auto y = fb_constants_->begin(); y != fb_constants_->end(); ++y) {
@@ -27,6 +27,10 @@ namespace ppl { namespace nn { namespace pmx {
 
 class GraphParser final {
 public:
+    /**
+       @note constants may refer to the model buffer directly if `RuntimeGraphInfo::constant_data_holder`
+       is set, which must keep the buffer alive.
+    */
     static ppl::common::RetCode Parse(const Graph*, const std::vector<EngineImpl*>&, ir::GraphTopo*, RuntimeGraphInfo*);
 };
 
@@ -203,6 +203,16 @@ static RetCode CreateFbShapes(FlatBufferBuilder* builder, const SerializationCon
     return RC_SUCCESS;
 }
 
+/*
+  offsets of constants are aligned so that engines can refer to data in the mapped model file directly.
+  `shared_data` itself is forced to align to the same boundary in CreateFbGraphData().
+*/
+static const uint64_t g_shared_data_alignment = 64;
+
+static inline uint64_t Align(uint64_t v, uint64_t alignment) {
+    return (v + alignment - 1) & (~(alignment - 1));
+}
+
 static pair<uint64_t, uint64_t> FindOrInsertData(const vector<uint8_t>& data, vector<uint8_t>* shared_data,
                                                  vector<pair<uint64_t, uint64_t>>* shared_data_items) {
     for (auto o = shared_data_items->begin(); o != shared_data_items->end(); ++o) {
@@ -214,8 +224,8 @@ static pair<uint64_t, uint64_t> FindOrInsertData(const vector<uint8_t>& data, ve
         }
     }
 
-    auto new_data_item = pair<uint64_t, uint64_t>(shared_data->size(), data.size());
-    shared_data->resize(shared_data->size() + data.size());
+    auto new_data_item = pair<uint64_t, uint64_t>(Align(shared_data->size(), g_shared_data_alignment), data.size());
+    shared_data->resize(new_data_item.first + data.size());
     memcpy(shared_data->data() + new_data_item.first, data.data(), data.size());
     shared_data_items->push_back(new_data_item);
     return new_data_item;
@@ -382,6 +392,7 @@ static RetCode CreateFbGraphData(FlatBufferBuilder* builder, const Serialization
         return status;
     }
 
+    builder->ForceVectorAlignment(shared_data.size(), sizeof(uint8_t), g_shared_data_alignment);
     auto fb_shared_data = builder->CreateVector<uint8_t>(shared_data);
     *fb_data = CreateGraphData(*builder, fb_shapes, fb_partitions, fb_shared_data);
     return RC_SUCCESS;
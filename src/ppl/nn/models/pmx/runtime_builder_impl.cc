@@ -106,14 +106,41 @@ RetCode RuntimeBuilderImpl::Init(const char* model_buf, uint64_t buf_len, ppl::n
     return RC_SUCCESS;
 }
 
+static bool IsReferredByConstants(const RuntimeGraphInfo& info, const char* base, uint64_t size) {
+    for (auto p = info.partitions.begin(); p != info.partitions.end(); ++p) {
+        for (auto c = p->constants.begin(); c != p->constants.end(); ++c) {
+            auto addr = c->second.GetBufferPtr<const char>();
+            if (!c->second.IsBufferOwner() && addr >= base && addr < base + size) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 RetCode RuntimeBuilderImpl::Init(const char* model_file, ppl::nn::Engine** engines, uint32_t engine_num) {
-    FileMapping fm;
-    auto status = fm.Init(model_file);
+    auto fm = make_shared<FileMapping>();
+    auto status = fm->Init(model_file);
     if (status != RC_SUCCESS) {
         LOG(ERROR) << "Init filemapping from file [" << model_file << "] faild: " << GetRetCodeStr(status);
         return status;
     }
-    return Init(fm.Data(), fm.Size(), engines, engine_num);
+
+    // engines may refer to constants in the mapping instead of copying them
+    graph_info_->constant_data_holder = fm;
+
+    status = Init(fm->Data(), fm->Size(), engines, engine_num);
+    if (status != RC_SUCCESS) {
+        return status;
+    }
+
+    if (!IsReferredByConstants(*graph_info_, fm->Data(), fm->Size())) {
+        graph_info_->constant_data_holder.reset();
+    } else {
+        LOG(INFO) << "constants refer to the mapped model file directly.";
+    }
+
+    return RC_SUCCESS;
 }
 
 RetCode RuntimeBuilderImpl::Preprocess() {
@@ -19,6 +19,7 @@
 #define _ST_HPC_PPL_NN_RUNTIME_KERNEL_EXEC_CONTEXT_H_
 
 #include "ppl/nn/common/input_output_info.h"
+#include <atomic>
 
 namespace ppl { namespace nn {
 
@@ -37,14 +38,42 @@ public:
     void SetEdgeLastConsumerList(const std::vector<nodeid_t>* l) {
         edge_last_consumer_ = l;
     }
+    /**
+       @brief sets refcounts of edges that are updated during execution.
+       @note if it is set, `IsLastConsumerOfInput()` uses refcounts instead of `edge_last_consumer`.
+    */
+    void SetEdgeRefcountList(const std::vector<std::atomic<uint32_t>>* l) {
+        edge_refcount_ = l;
+    }
     bool IsLastConsumerOfInput(uint32_t idx) const {
         auto eid = node_->GetInput(idx);
+        if (edge_refcount_) {
+            return IsOnlyRemainingConsumer(eid);
+        }
         return (edge_last_consumer_->at(eid) == node_->GetId());
     }
 
+private:
+    /** checks whether all the remaining references of `eid` come from the current node */
+    bool IsOnlyRemainingConsumer(edgeid_t eid) const {
+        uint32_t refcount = 0;
+        for (uint32_t i = 0; i < node_->GetInputCount(); ++i) {
+            if (node_->GetInput(i) == eid) {
+                ++refcount;
+            }
+        }
+        for (uint32_t i = 0; i < node_->GetExtraInputCount(); ++i) {
+            if (node_->GetExtraInput(i) == eid) {
+                ++refcount;
+            }
+        }
+        return (edge_refcount_->at(eid).load(std::memory_order_acquire) == refcount);
+    }
+
 private:
     bool is_profiling_enabled_ = false;
     const std::vector<nodeid_t>* edge_last_consumer_ = nullptr;
+    const std::vector<std::atomic<uint32_t>>* edge_refcount_ = nullptr;
 };
 
 }} // namespace ppl::nn
@@ -63,12 +63,36 @@ public:
     */
     virtual ppl::common::RetCode Execute(KernelExecContext* ctx) = 0;
 
+    /**
+       @brief data format in which this kernel prefers to receive its `idx`-th input.
+       @return DATAFORMAT_UNKNOWN if this kernel has no preference.
+    */
+    virtual ppl::common::dataformat_t GetPreferredInputDataFormat(uint32_t idx) const {
+        return ppl::common::DATAFORMAT_UNKNOWN;
+    }
+
+    /**
+       @brief allows this kernel to skip shape inference when its inputs are the same as those of the last execution.
+       kernels that do not support it ignore this flag.
+    */
+    virtual void SetReshapeCacheFlag(bool) {}
+
 #ifdef PPLNN_ENABLE_KERNEL_PROFILING
 public:
     /** @brief get execution time in microseconds */
     virtual uint64_t GetExecutionTime() const {
         return 0;
     }
+
+    /** @brief get the beginning of the last execution in microseconds since epoch of system_clock. 0 if unknown. */
+    virtual uint64_t GetExecutionBeginTime() const {
+        return 0;
+    }
+
+    /** @brief whether shape inference is skipped in the last execution */
+    virtual bool IsReshapeCacheHit() const {
+        return false;
+    }
 #endif
 
 private:
@@ -0,0 +1,273 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/nn/common/logger.h"
+#include "ppl/nn/runtime/parallel_scheduler.h"
+#include "ppl/nn/runtime/scheduler_common.h"
+using namespace std;
+using namespace ppl::common;
+
+namespace ppl { namespace nn {
+
+ParallelScheduler::ParallelScheduler(uint32_t thread_num)
+    : thread_num_(thread_num > 0 ? thread_num : 1), remaining_nodes_(0), status_(RC_SUCCESS), queued_tasks_(0) {}
+
+ParallelScheduler::~ParallelScheduler() {
+    {
+        lock_guard<mutex> lck(mtx_);
+        stop_ = true;
+    }
+    task_cond_.notify_all();
+    for (auto x = workers_.begin(); x != workers_.end(); ++x) {
+        x->join();
+    }
+}
+
+RetCode ParallelScheduler::Init(const ir::GraphTopo* topo, const RuntimeAuxInfo* aux_info, RuntimeGraphResource* g) {
+    graph_ = g;
+    topo_ = topo;
+    aux_info_ = aux_info;
+
+    const nodeid_t max_node_id = topo->GetCurrentNodeIdBound();
+
+    // only nodes in `sorted_nodes` will be executed
+    vector<bool> is_scheduled(max_node_id, false);
+    for (auto x = aux_info->sorted_nodes.begin(); x != aux_info->sorted_nodes.end(); ++x) {
+        is_scheduled[*x] = true;
+    }
+
+    predecessor_count_.assign(max_node_id, 0);
+    successors_.assign(max_node_id, vector<nodeid_t>());
+    start_nodes_.clear();
+
+    for (auto x = aux_info->sorted_nodes.begin(); x != aux_info->sorted_nodes.end(); ++x) {
+        auto prevs = topo->FindPredecessors(*x);
+        for (auto p = prevs.begin(); p != prevs.end(); ++p) {
+            if (is_scheduled[*p]) {
+                ++predecessor_count_[*x];
+                successors_[*p].push_back(*x);
+            }
+        }
+        if (predecessor_count_[*x] == 0) {
+            start_nodes_.push_back(*x);
+        }
+    }
+
+    pending_predecessors_ = vector<atomic<uint32_t>>(max_node_id);
+    edge_refcount_ = vector<atomic<uint32_t>>(aux_info->edge_refcount.size());
+
+    queues_.reserve(thread_num_);
+    for (uint32_t i = 0; i < thread_num_; ++i) {
+        queues_.emplace_back(unique_ptr<TaskQueue>(new TaskQueue()));
+    }
+    workers_.reserve(thread_num_);
+    for (uint32_t i = 0; i < thread_num_; ++i) {
+        workers_.emplace_back(&ParallelScheduler::WorkerMain, this, i);
+    }
+
+    return RC_SUCCESS;
+}
+
+EdgeObject* ParallelScheduler::AcquireObject(edgeid_t eid, uint32_t etype) {
+    if (eid >= graph_->edgeid2object.size()) {
+        return nullptr;
+    }
+
+    /*
+      an input object is created before its consumers are scheduled and an output object is only
+      created by its producer, so each slot of `edgeid2object` is accessed by one thread at a time.
+    */
+    auto object = graph_->edgeid2object[eid];
+    if (!object) {
+        auto edge = topo_->GetEdge(eid);
+
+        if (etype == EdgeObject::T_TENSOR) {
+            lock_guard<mutex> lck(pool_mtx_);
+            object = tensor_pool_.Alloc(edge, TENSORTYPE_NORMAL);
+        } else if (etype == EdgeObject::T_TENSOR_SEQUENCE) {
+            lock_guard<mutex> lck(pool_mtx_);
+            object = tensor_sequence_pool_.Alloc(edge);
+        } else if (etype == EdgeObject::T_EDGE_OBJECT) {
+            return nullptr;
+        } else {
+            LOG(ERROR) << "invalid object type[" << etype << "] of edge[" << edge->GetName() << "]";
+            return nullptr;
+        }
+
+        if (!object) {
+            LOG(ERROR) << "create output object[" << edge->GetName() << "] failed, oom";
+            return nullptr;
+        }
+        graph_->edgeid2object[eid] = object;
+    }
+    return object;
+}
+
+RetCode ParallelScheduler::ReleaseObject(EdgeObject* object, nodeid_t) {
+    auto eid = object->GetEdge()->GetId();
+    if (edge_refcount_[eid].fetch_sub(1, memory_order_acq_rel) != 1) {
+        return RC_SUCCESS;
+    }
+
+    auto obj = graph_->edgeid2object[eid];
+    graph_->edgeid2object[eid] = nullptr;
+
+    lock_guard<mutex> lck(pool_mtx_);
+    if (obj->GetObjectType() == EdgeObject::T_TENSOR) {
+        tensor_pool_.Free(static_cast<TensorImpl*>(obj));
+    } else if (obj->GetObjectType() == EdgeObject::T_TENSOR_SEQUENCE) {
+        tensor_sequence_pool_.Free(static_cast<TensorSequence*>(obj));
+    } else {
+        LOG(ERROR) << "invalid edge object type[" << obj->GetObjectType() << "]";
+        return RC_INVALID_VALUE;
+    }
+    return RC_SUCCESS;
+}
+
+void ParallelScheduler::PushTask(uint32_t wid, nodeid_t nid) {
+    {
+        auto q = queues_[wid].get();
+        lock_guard<mutex> lck(q->mtx);
+        q->tasks.push_back(nid);
+    }
+    {
+        lock_guard<mutex> lck(mtx_);
+        queued_tasks_.fetch_add(1, memory_order_relaxed);
+    }
+    task_cond_.notify_one();
+}
+
+bool ParallelScheduler::PopTask(uint32_t wid, nodeid_t* nid) {
+    // takes the most recently pushed task of its own queue to keep producer's outputs hot in cache
+    {
+        auto q = queues_[wid].get();
+        lock_guard<mutex> lck(q->mtx);
+        if (!q->tasks.empty()) {
+            *nid = q->tasks.back();
+            q->tasks.pop_back();
+            queued_tasks_.fetch_sub(1, memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // steals the oldest task from other workers
+    for (uint32_t i = 1; i < thread_num_; ++i) {
+        auto q = queues_[(wid + i) % thread_num_].get();
+        lock_guard<mutex> lck(q->mtx);
+        if (!q->tasks.empty()) {
+            *nid = q->tasks.front();
+            q->tasks.pop_front();
+            queued_tasks_.fetch_sub(1, memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ParallelScheduler::SetFailed(RetCode status) {
+    RetCode expected = RC_SUCCESS;
+    status_.compare_exchange_strong(expected, status);
+}
+
+void ParallelScheduler::ProcessNode(nodeid_t nid, uint32_t wid, KernelExecContext* ctx) {
+    // remaining nodes are skipped(but still counted) after a failure so that Run() can return
+    if (status_.load(memory_order_acquire) == RC_SUCCESS) {
+        auto kernel = graph_->nodeid2kernel[nid].get();
+        ctx->SetNode(kernel->GetNode());
+        ctx->SetProfilingFlag(profiler_->IsProfilingEnabled());
+
+        auto status = utils::ExecuteKernel(
+            kernel, ctx,
+            [this](EdgeObject* object, nodeid_t user) -> RetCode {
+                return ReleaseObject(object, user);
+            },
+            profiler_);
+        if (status != RC_SUCCESS) {
+            LOG(ERROR) << "execute kernel[" << kernel->GetName() << "] failed: " << GetRetCodeStr(status);
+            SetFailed(status);
+        }
+    }
+
+    auto& nexts = successors_[nid];
+    for (auto x = nexts.begin(); x != nexts.end(); ++x) {
+        if (pending_predecessors_[*x].fetch_sub(1, memory_order_acq_rel) == 1) {
+            PushTask(wid, *x);
+        }
+    }
+
+    if (remaining_nodes_.fetch_sub(1, memory_order_acq_rel) == 1) {
+        lock_guard<mutex> lck(mtx_);
+        done_cond_.notify_all();
+    }
+}
+
+void ParallelScheduler::WorkerMain(uint32_t wid) {
+    KernelExecContext ctx;
+    ctx.SetAcquireFunc([this](edgeid_t eid, uint32_t etype) -> EdgeObject* {
+        return AcquireObject(eid, etype);
+    });
+    ctx.SetEdgeLastConsumerList(&aux_info_->edge_last_consumer);
+    ctx.SetEdgeRefcountList(&edge_refcount_);
+
+    while (true) {
+        nodeid_t nid;
+        if (PopTask(wid, &nid)) {
+            ProcessNode(nid, wid, &ctx);
+            continue;
+        }
+
+        unique_lock<mutex> lck(mtx_);
+        task_cond_.wait(lck, [this]() -> bool {
+            return (stop_ || queued_tasks_.load(memory_order_relaxed) > 0);
+        });
+        if (stop_) {
+            break;
+        }
+    }
+}
+
+RetCode ParallelScheduler::Run(Profiler* profiler) {
+    if (aux_info_->sorted_nodes.empty()) {
+        return RC_SUCCESS;
+    }
+
+    profiler_ = profiler;
+    status_.store(RC_SUCCESS, memory_order_relaxed);
+    for (auto x = aux_info_->sorted_nodes.begin(); x != aux_info_->sorted_nodes.end(); ++x) {
+        pending_predecessors_[*x].store(predecessor_count_[*x], memory_order_relaxed);
+    }
+    for (uint32_t i = 0; i < aux_info_->edge_refcount.size(); ++i) {
+        edge_refcount_[i].store(aux_info_->edge_refcount[i], memory_order_relaxed);
+    }
+    remaining_nodes_.store(aux_info_->sorted_nodes.size(), memory_order_release);
+
+    for (uint32_t i = 0; i < start_nodes_.size(); ++i) {
+        PushTask(i % thread_num_, start_nodes_[i]);
+    }
+
+    {
+        unique_lock<mutex> lck(mtx_);
+        done_cond_.wait(lck, [this]() -> bool {
+            return (remaining_nodes_.load(memory_order_acquire) == 0);
+        });
+    }
+
+    return status_.load(memory_order_acquire);
+}
+
+}} // namespace ppl::nn
@@ -0,0 +1,110 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef _ST_HPC_PPL_NN_RUNTIME_PARALLEL_SCHEDULER_H_
+#define _ST_HPC_PPL_NN_RUNTIME_PARALLEL_SCHEDULER_H_
+
+#include "ppl/nn/runtime/scheduler.h"
+#include "ppl/common/object_pool.h"
+#include "ppl/nn/runtime/tensor_sequence.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace ppl { namespace nn {
+
+/**
+   @class ParallelScheduler
+   @brief a dataflow scheduler which executes kernels as soon as all their predecessors finish.
+   ready kernels are dispatched to a group of worker threads. each worker has its own task queue
+   and steals tasks from others when its queue is empty.
+*/
+class ParallelScheduler final : public Scheduler {
+public:
+    ParallelScheduler(uint32_t thread_num);
+    ~ParallelScheduler();
+
+    ppl::common::RetCode Init(const ir::GraphTopo* topo, const RuntimeAuxInfo* aux_info,
+                              RuntimeGraphResource* g) override;
+    ppl::common::RetCode Run(Profiler*) override;
+
+    uint32_t GetThreadNum() const {
+        return thread_num_;
+    }
+
+private:
+    struct TaskQueue final {
+        std::mutex mtx;
+        std::deque<nodeid_t> tasks;
+    };
+
+    void WorkerMain(uint32_t wid);
+    void PushTask(uint32_t wid, nodeid_t nid);
+    bool PopTask(uint32_t wid, nodeid_t* nid);
+    void ProcessNode(nodeid_t nid, uint32_t wid, KernelExecContext* ctx);
+    void SetFailed(ppl::common::RetCode status);
+
+    EdgeObject* AcquireObject(edgeid_t eid, uint32_t etype);
+    ppl::common::RetCode ReleaseObject(EdgeObject* object, nodeid_t user);
+
+private:
+    const uint32_t thread_num_;
+
+    const ir::GraphTopo* topo_ = nullptr;
+    const RuntimeAuxInfo* aux_info_ = nullptr;
+    RuntimeGraphResource* graph_ = nullptr;
+
+    /** number of predecessors of each node in `sorted_nodes` */
+    std::vector<uint32_t> predecessor_count_;
+    std::vector<std::vector<nodeid_t>> successors_;
+    std::vector<nodeid_t> start_nodes_;
+
+    // ----- states of the current Run() ----- //
+
+    Profiler* profiler_ = nullptr;
+    std::vector<std::atomic<uint32_t>> pending_predecessors_;
+    std::vector<std::atomic<uint32_t>> edge_refcount_;
+    std::atomic<uint32_t> remaining_nodes_;
+    std::atomic<ppl::common::RetCode> status_;
+
+    // ----- workers ----- //
+
+    std::vector<std::unique_ptr<TaskQueue>> queues_;
+    std::vector<std::thread> workers_;
+
+    /** protects `queued_tasks_` and `stop_` */
+    std::mutex mtx_;
+    std::condition_variable task_cond_;
+    std::condition_variable done_cond_;
+    std::atomic<uint32_t> queued_tasks_;
+    bool stop_ = false;
+
+    /** object pools are shared by all workers */
+    std::mutex pool_mtx_;
+    ppl::common::ObjectPool<TensorImpl> tensor_pool_;
+    ppl::common::ObjectPool<TensorSequence> tensor_sequence_pool_;
+
+private:
+    ParallelScheduler(const ParallelScheduler&) = delete;
+    ParallelScheduler& operator=(const ParallelScheduler&) = delete;
+};
+
+}} // namespace ppl::nn
+
+#endif
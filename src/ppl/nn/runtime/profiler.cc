@@ -17,6 +17,7 @@
 
 #include "ppl/nn/runtime/profiler.h"
 #include "ppl/nn/common/logger.h"
+#include "ppl/nn/utils/trace_recorder.h"
 using namespace std;
 using namespace ppl::common;
 
@@ -35,6 +36,22 @@ void Profiler::CollectStatistics(KernelImpl* kernel) {
         auto info = &nodeid2info_[kernel->GetNode()->GetId()];
         info->exec_microseconds += kernel->GetExecutionTime();
         ++info->exec_count;
+        if (kernel->IsReshapeCacheHit()) {
+            ++info->reshape_cache_hit_count;
+        }
+
+        auto recorder = utils::TraceRecorder::GetInstance();
+        if (recorder->IsEnabled()) {
+            auto dur = kernel->GetExecutionTime();
+            auto begin_ts = kernel->GetExecutionBeginTime();
+            if (begin_ts == 0) {
+                // asynchronous kernels. the execution is considered to be finished just now.
+                begin_ts = utils::TraceRecorder::Now() - dur;
+            }
+            auto& type = kernel->GetType();
+            recorder->AddCompleteEvent("kernel", kernel->GetName(), begin_ts, begin_ts + dur,
+                                       type.domain.empty() ? type.name : type.domain + "." + type.name);
+        }
     }
 }
 
@@ -61,6 +78,7 @@ RetCode Profiler::GetProfilingStatistics(ProfilingStatistics* stat) const {
         kernel_prof_info.type = op_type.name;
         kernel_prof_info.exec_microseconds = info.exec_microseconds;
         kernel_prof_info.exec_count = info.exec_count;
+        kernel_prof_info.reshape_cache_hit_count = info.reshape_cache_hit_count;
         stat->prof_info.emplace_back(std::move(kernel_prof_info));
     }
 
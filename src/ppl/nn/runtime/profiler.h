@@ -54,6 +54,7 @@ private:
     struct KernelExecInfo {
         uint32_t exec_count = 0;
         uint64_t exec_microseconds = 0;
+        uint32_t reshape_cache_hit_count = 0;
     };
 
     std::vector<KernelExecInfo> nodeid2info_;
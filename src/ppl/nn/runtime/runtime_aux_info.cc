@@ -85,11 +85,9 @@ static vector<uint32_t> CalcEdgeRefcount(const ir::GraphTopo* topo, const set<ed
 }
 
 static RetCode InitEdgeLastConsumer(const ir::GraphTopo* topo, const vector<nodeid_t>& sorted_nodes,
-                                    const set<edgeid_t>& reserved_edgeids, vector<nodeid_t>* edge_last_consumer) {
+                                    vector<uint32_t> edge_refcount, vector<nodeid_t>* edge_last_consumer) {
     edge_last_consumer->resize(topo->GetCurrentEdgeIdBound(), INVALID_NODEID);
 
-    auto edge_refcount = CalcEdgeRefcount(topo, reserved_edgeids);
-
     for (auto x = sorted_nodes.begin(); x != sorted_nodes.end(); ++x) {
         auto node = topo->GetNode(*x);
 
@@ -152,7 +150,9 @@ RetCode RuntimeAuxInfo::Init(const ir::GraphTopo* topo, const set<edgeid_t>& res
         this->sorted_nodes.push_back(nid);
     });
 
-    auto status = InitEdgeLastConsumer(topo, sorted_nodes, reserved_edgeids, &edge_last_consumer);
+    edge_refcount = CalcEdgeRefcount(topo, reserved_edgeids);
+
+    auto status = InitEdgeLastConsumer(topo, sorted_nodes, edge_refcount, &edge_last_consumer);
     if (status != RC_SUCCESS) {
         LOG(ERROR) << "InitEdgeLastConsumer failed: " << GetRetCodeStr(status);
         return status;
@@ -38,6 +38,13 @@ struct RuntimeAuxInfo final {
 
     /** an `EdgeObject` can be released right after the last consumer finish executing in `sorted_nodes` */
     std::vector<nodeid_t> edge_last_consumer;
+
+    /**
+       number of releases(one for the producer and one for each input slot of consumers) before an `EdgeObject`
+       can be freed. inputs/extra_inputs/constants/outputs/reserved edges never reach 0. used by schedulers that
+       don't execute kernels in the order of `sorted_nodes`.
+    */
+    std::vector<uint32_t> edge_refcount;
 };
 
 }} // namespace ppl::nn
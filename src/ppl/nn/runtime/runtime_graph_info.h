@@ -22,6 +22,7 @@
 #include "ppl/nn/common/buffer_info.h"
 #include "ppl/nn/runtime/opt_kernel.h"
 #include <vector>
+#include <memory>
 #include <map>
 
 namespace ppl { namespace nn {
@@ -47,6 +48,12 @@ struct RuntimeGraphInfo final {
         partitions.clear();
     }
 
+    /**
+       keeps memory that constants may refer to(the mapped model file, for example) alive.
+       declared before `partitions` so that it is released after all constants.
+    */
+    std::shared_ptr<void> constant_data_holder;
+
     std::map<edgeid_t, TensorShape> shapes;
     std::vector<Partition> partitions;
 };
@@ -19,8 +19,10 @@
 #include "ppl/nn/engines/engine_impl.h"
 #include "ppl/nn/runtime/runtime_impl.h"
 #include "ppl/nn/runtime/sequential_scheduler.h"
+#include "ppl/nn/runtime/parallel_scheduler.h"
 #include "ppl/nn/runtime/runtime_internal_conf.h"
 #include "ppl/nn/utils/utils.h"
+#include "ppl/nn/utils/trace_recorder.h"
 #include <stdarg.h>
 using namespace std;
 using namespace ppl::common;
@@ -319,8 +321,48 @@ RetCode RuntimeImpl::Sync() {
     return RC_SUCCESS;
 }
 
+RetCode RuntimeImpl::UpdateStates() {
+    for (auto x = state_bindings_.begin(); x != state_bindings_.end(); ++x) {
+        if (!x->pending) {
+            continue;
+        }
+
+        auto output = x->output;
+        auto input = x->input;
+        auto output_shape = output->GetShape();
+        auto input_shape = input->GetShape();
+        if (output_shape->GetDataType() != input_shape->GetDataType() ||
+            output_shape->GetDataFormat() != input_shape->GetDataFormat()) {
+            LOG(ERROR) << "data type or format of state output[" << output->GetName() << "] mismatches input["
+                       << input->GetName() << "]";
+            return RC_INVALID_VALUE;
+        }
+
+        // swaps buffers so that the next Run() writes the new state into the buffer of the old one
+        const BufferDesc input_buffer = input->GetBufferDesc();
+        const bool is_input_buffer_owner = input->IsBufferOwner();
+        input->DetachBuffer();
+        input->TransferBufferFrom(output);
+        output->SetBuffer(input_buffer, nullptr, is_input_buffer_owner);
+        *input_shape = *output_shape;
+
+        x->pending = false;
+    }
+
+    return RC_SUCCESS;
+}
+
 RetCode RuntimeImpl::Run() {
-    RetCode status;
+#ifdef PPLNN_ENABLE_KERNEL_PROFILING
+    auto recorder = utils::TraceRecorder::GetInstance();
+    const uint64_t begin_ts = recorder->IsEnabled() ? utils::TraceRecorder::Now() : 0;
+#endif
+
+    auto status = UpdateStates();
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "UpdateStates() failed: " << GetRetCodeStr(status);
+        return status;
+    }
 
     for (auto x = engctx_.begin(); x != engctx_.end(); ++x) {
         status = x->get()->BeforeRun(topo_.get(), &graph_);
@@ -337,7 +379,22 @@ RetCode RuntimeImpl::Run() {
         return status;
     }
 
-    return Sync();
+    status = Sync();
+    if (status != RC_SUCCESS) {
+        return status;
+    }
+
+    for (auto x = state_bindings_.begin(); x != state_bindings_.end(); ++x) {
+        x->pending = true;
+    }
+
+#ifdef PPLNN_ENABLE_KERNEL_PROFILING
+    if (recorder->IsEnabled() && begin_ts > 0) {
+        recorder->AddCompleteEvent("runtime", "Run", begin_ts, utils::TraceRecorder::Now());
+    }
+#endif
+
+    return RC_SUCCESS;
 }
 
 RetCode RuntimeImpl::GetProfilingStatistics(ProfilingStatistics* stat) const {
@@ -359,6 +416,61 @@ Tensor* RuntimeImpl::GetTensorByName(const char* name) const {
     return nullptr;
 }
 
+dataformat_t RuntimeImpl::GetInputPreferredDataFormat(uint32_t idx) const {
+    auto eid = topo_->GetInput(idx);
+    auto edge = topo_->GetEdge(eid);
+    auto tensor = static_cast<TensorImpl*>(graph_.edgeid2object[eid]);
+    const dataformat_t cur_format = tensor->GetShape()->GetDataFormat();
+
+    dataformat_t preferred = DATAFORMAT_UNKNOWN;
+    for (auto it = edge->CreateConsumerIter(); it.IsValid(); it.Forward()) {
+        auto kernel = graph_.nodeid2kernel[it.Get()].get();
+        if (!kernel) {
+            continue; // not in this runtime
+        }
+
+        auto node = kernel->GetNode();
+        for (uint32_t i = 0; i < node->GetInputCount(); ++i) {
+            if (node->GetInput(i) != eid) {
+                continue;
+            }
+
+            auto format = kernel->GetPreferredInputDataFormat(i);
+            if (format == DATAFORMAT_UNKNOWN) {
+                format = cur_format;
+            }
+            if (preferred != DATAFORMAT_UNKNOWN && preferred != format) {
+                return cur_format;
+            }
+            preferred = format;
+        }
+    }
+
+    return (preferred == DATAFORMAT_UNKNOWN) ? cur_format : preferred;
+}
+
+TensorImpl* RuntimeImpl::FindInputTensorImpl(const char* name) const {
+    const string name_s(name);
+    for (uint32_t i = 0; i < GetInputCount(); ++i) {
+        auto tensor = GetInputTensorImpl(i);
+        if (tensor->GetEdge()->GetName() == name_s) {
+            return tensor;
+        }
+    }
+    return nullptr;
+}
+
+TensorImpl* RuntimeImpl::FindOutputTensorImpl(const char* name) const {
+    const string name_s(name);
+    for (uint32_t i = 0; i < GetOutputCount(); ++i) {
+        auto tensor = GetOutputTensorImpl(i);
+        if (tensor->GetEdge()->GetName() == name_s) {
+            return tensor;
+        }
+    }
+    return nullptr;
+}
+
 /* -------------------------------------------------------------------------- */
 
 RetCode RuntimeImpl::SetProfilingFlag(RuntimeImpl* rt, va_list args) {
@@ -380,8 +492,164 @@ RetCode RuntimeImpl::SetProfilingFlag(RuntimeImpl* rt, va_list args) {
 #endif
 }
 
+RetCode RuntimeImpl::SetParallelScheduling(RuntimeImpl* rt, va_list args) {
+    auto thread_num = va_arg(args, uint32_t);
+    auto max_concurrent_kernels = (thread_num > 1) ? thread_num : 1;
+
+    for (auto x = rt->engctx_.begin(); x != rt->engctx_.end(); ++x) {
+        auto status = x->get()->SetMaxConcurrentKernels(max_concurrent_kernels);
+        if (status != RC_SUCCESS) {
+            LOG(ERROR) << "EngineContext[" << x->get()->GetName() << "] does not support running ["
+                       << max_concurrent_kernels << "] kernels concurrently: " << GetRetCodeStr(status);
+            for (auto y = rt->engctx_.begin(); y != x; ++y) {
+                y->get()->SetMaxConcurrentKernels(1);
+            }
+            return status;
+        }
+    }
+
+    unique_ptr<Scheduler> sched;
+    if (max_concurrent_kernels > 1) {
+        sched.reset(new ParallelScheduler(max_concurrent_kernels));
+    } else {
+        sched.reset(new SequentialScheduler());
+    }
+
+    auto status = sched->Init(rt->topo_.get(), rt->aux_info_.get(), &rt->graph_);
+    if (status != RC_SUCCESS) {
+        LOG(ERROR) << "init scheduler failed: " << GetRetCodeStr(status);
+        return status;
+    }
+
+    rt->sched_ = std::move(sched);
+    return RC_SUCCESS;
+}
+
+RetCode RuntimeImpl::BindState(RuntimeImpl* rt, va_list args) {
+    auto output_name = va_arg(args, const char*);
+    auto input_name = va_arg(args, const char*);
+
+    auto output = rt->FindOutputTensorImpl(output_name);
+    if (!output) {
+        LOG(ERROR) << "cannot find output[" << output_name << "]";
+        return RC_NOT_FOUND;
+    }
+    auto input = rt->FindInputTensorImpl(input_name);
+    if (!input) {
+        LOG(ERROR) << "cannot find input[" << input_name << "]";
+        return RC_NOT_FOUND;
+    }
+
+    // buffers are exchanged between the two tensors, so they must be managed by the same device
+    if (!input->GetDevice() || input->GetDevice() != output->GetDevice()) {
+        LOG(ERROR) << "state output[" << output_name << "] and input[" << input_name
+                   << "] are not on the same device";
+        return RC_UNSUPPORTED;
+    }
+
+    for (auto x = rt->state_bindings_.begin(); x != rt->state_bindings_.end(); ++x) {
+        if (x->input == input || x->output == output) {
+            LOG(ERROR) << "output[" << output_name << "] or input[" << input_name << "] is already bound";
+            return RC_EXISTS;
+        }
+    }
+
+    StateBinding binding;
+    binding.output = output;
+    binding.input = input;
+    binding.pending = false;
+    rt->state_bindings_.push_back(binding);
+    return RC_SUCCESS;
+}
+
+static RetCode FillZeros(TensorImpl* tensor) {
+    const uint64_t bytes = tensor->GetShape()->GetBytesIncludingPadding();
+    if (bytes == 0) {
+        // shape is unknown before the first Run(). the input will be filled by users.
+        return RC_SUCCESS;
+    }
+
+    if (!tensor->GetBufferPtr()) {
+        auto status = tensor->ReallocBuffer();
+        if (status != RC_SUCCESS) {
+            LOG(ERROR) << "ReallocBuffer for tensor[" << tensor->GetName() << "] failed: " << GetRetCodeStr(status);
+            return status;
+        }
+    }
+
+    vector<char> zeros(bytes, 0);
+    return tensor->GetDevice()->CopyFromHost(&tensor->GetBufferDesc(), zeros.data(), bytes);
+}
+
+RetCode RuntimeImpl::ResetState(RuntimeImpl* rt, va_list args) {
+    auto input_name = va_arg(args, const char*);
+
+    bool found = false;
+    for (auto x = rt->state_bindings_.begin(); x != rt->state_bindings_.end(); ++x) {
+        if (input_name && x->input->GetEdge()->GetName() != input_name) {
+            continue;
+        }
+
+        found = true;
+        x->pending = false;
+        auto status = FillZeros(x->input);
+        if (status != RC_SUCCESS) {
+            LOG(ERROR) << "reset state[" << x->input->GetName() << "] failed: " << GetRetCodeStr(status);
+            return status;
+        }
+    }
+
+    if (input_name && !found) {
+        LOG(ERROR) << "input[" << input_name << "] is not bound to any output";
+        return RC_NOT_FOUND;
+    }
+    return RC_SUCCESS;
+}
+
+RetCode RuntimeImpl::SetReshapeCache(RuntimeImpl* rt, va_list args) {
+    auto flag = va_arg(args, uint32_t);
+    for (auto x = rt->graph_.nodeid2kernel.begin(); x != rt->graph_.nodeid2kernel.end(); ++x) {
+        if (x->get()) {
+            x->get()->SetReshapeCacheFlag(flag > 0);
+        }
+    }
+    return RC_SUCCESS;
+}
+
+RetCode RuntimeImpl::SetTracing(RuntimeImpl*, va_list args) {
+#ifdef PPLNN_ENABLE_KERNEL_PROFILING
+    auto max_events = va_arg(args, uint32_t);
+    auto recorder = utils::TraceRecorder::GetInstance();
+    if (max_events > 0) {
+        recorder->Start(max_events);
+    } else {
+        recorder->Stop();
+    }
+    return RC_SUCCESS;
+#else
+    LOG(ERROR) << "this version does not support profiling.";
+    return RC_UNSUPPORTED;
+#endif
+}
+
+RetCode RuntimeImpl::SaveTrace(RuntimeImpl*, va_list args) {
+#ifdef PPLNN_ENABLE_KERNEL_PROFILING
+    auto filename = va_arg(args, const char*);
+    return utils::TraceRecorder::GetInstance()->SaveAsChromeTrace(filename);
+#else
+    LOG(ERROR) << "this version does not support profiling.";
+    return RC_UNSUPPORTED;
+#endif
+}
+
 RuntimeImpl::ConfHandlerFunc RuntimeImpl::conf_handlers_[] = {
-    RuntimeImpl::SetProfilingFlag,
+    RuntimeImpl::SetProfilingFlag, // RUNTIME_CONF_SET_KERNEL_PROFILING_FLAG
+    RuntimeImpl::SetParallelScheduling, // RUNTIME_CONF_SET_PARALLEL_SCHEDULING
+    RuntimeImpl::BindState, // RUNTIME_CONF_BIND_STATE
+    RuntimeImpl::ResetState, // RUNTIME_CONF_RESET_STATE
+    RuntimeImpl::SetReshapeCache, // RUNTIME_CONF_SET_RESHAPE_CACHE
+    RuntimeImpl::SetTracing, // RUNTIME_CONF_SET_TRACING
+    RuntimeImpl::SaveTrace, // RUNTIME_CONF_SAVE_TRACE
 };
 
 RetCode RuntimeImpl::Configure(uint32_t option, ...) {
@@ -69,6 +69,8 @@ public:
         return static_cast<TensorImpl*>(graph_.edgeid2object[eid]);
     }
 
+    ppl::common::dataformat_t GetInputPreferredDataFormat(uint32_t idx) const override;
+
     uint32_t GetOutputCount() const override {
         return topo_->GetOutputCount();
     }
@@ -97,6 +99,12 @@ private:
     */
     ppl::common::RetCode Sync();
 
+    /** @brief moves states produced by the last Run() to their bound inputs */
+    ppl::common::RetCode UpdateStates();
+
+    TensorImpl* FindInputTensorImpl(const char* name) const;
+    TensorImpl* FindOutputTensorImpl(const char* name) const;
+
 private:
     RuntimeGraphResource graph_;
     std::unique_ptr<Scheduler> sched_;
@@ -104,6 +112,13 @@ private:
     RuntimeInternalConf conf_;
     Profiler profiler_;
 
+    struct StateBinding final {
+        TensorImpl* output;
+        TensorImpl* input;
+        bool pending; // `output` holds a state which is not moved to `input` yet
+    };
+    std::vector<StateBinding> state_bindings_;
+
     // ----- shared data ----- //
 
     std::shared_ptr<ir::GraphTopo> topo_;
@@ -116,6 +131,12 @@ private:
       defined as member functions can avoid exporting unnecessary APIs
     */
     static ppl::common::RetCode SetProfilingFlag(RuntimeImpl*, va_list);
+    static ppl::common::RetCode SetParallelScheduling(RuntimeImpl*, va_list);
+    static ppl::common::RetCode BindState(RuntimeImpl*, va_list);
+    static ppl::common::RetCode ResetState(RuntimeImpl*, va_list);
+    static ppl::common::RetCode SetReshapeCache(RuntimeImpl*, va_list);
+    static ppl::common::RetCode SetTracing(RuntimeImpl*, va_list);
+    static ppl::common::RetCode SaveTrace(RuntimeImpl*, va_list);
 
     typedef ppl::common::RetCode (*ConfHandlerFunc)(RuntimeImpl*, va_list);
     static ConfHandlerFunc conf_handlers_[RUNTIME_CONF_MAX];
@@ -54,6 +54,10 @@ static RetCode AfterExecuteKernel(KernelImpl* kernel, KernelExecContext* ctx,
 
     for (uint32_t i = 0; i < ctx->GetOutputCount(); ++i) {
         auto object = ctx->GetOutput<EdgeObject>(i);
+        if (!object) { // not created by the kernel
+            continue;
+        }
+
         auto status = release_func(object, nid);
         if (status != RC_SUCCESS) {
             LOG(ERROR) << "release edge[" << object->GetEdge()->GetName() << "] failed: " << GetRetCodeStr(status);
@@ -17,12 +17,22 @@
 
 #include "ppl/nn/runtime/tensor_impl.h"
 #include "ppl/nn/common/logger.h"
+#include "ppl/nn/utils/trace_recorder.h"
 using namespace std;
 using namespace ppl::common;
 
 namespace ppl { namespace nn {
 
 RetCode TensorImpl::ReallocBuffer() {
+    if (view_bytes_ > 0) {
+        if (buffer_info_.GetShape()->GetBytesIncludingPadding() <= view_bytes_) {
+            return RC_SUCCESS;
+        }
+        // does not fit in the view. buffer_info_ allocates a new buffer for a non-owner.
+        view_bytes_ = 0;
+        return buffer_info_.ReallocBuffer();
+    }
+
     if (!buffer_info_.IsBufferOwner() && buffer_info_.GetBufferPtr()) {
         LOG(WARNING) << "tensor[" << GetName() << "] is not the buffer owner. ReallocBuffer() does nothing.";
         return RC_SUCCESS;
@@ -39,14 +49,51 @@ RetCode TensorImpl::CopyFromHost(const void* src) {
     return buffer_info_.GetDevice()->CopyFromHost(&buffer_info_.GetBufferDesc(), src, *buffer_info_.GetShape());
 }
 
+#ifdef PPLNN_ENABLE_KERNEL_PROFILING
+namespace {
+/** records a conversion as a trace event when it is destroyed */
+class ConversionTraceGuard final {
+public:
+    ConversionTraceGuard(const char* func, const TensorImpl* tensor) : func_(func), tensor_(tensor) {
+        if (utils::TraceRecorder::GetInstance()->IsEnabled()) {
+            begin_ts_ = utils::TraceRecorder::Now();
+        }
+    }
+    ~ConversionTraceGuard() {
+        auto recorder = utils::TraceRecorder::GetInstance();
+        if (begin_ts_ > 0 && recorder->IsEnabled()) {
+            recorder->AddCompleteEvent("converter", func_, begin_ts_, utils::TraceRecorder::Now(), tensor_->GetName());
+        }
+    }
+
+private:
+    const char* func_;
+    const TensorImpl* tensor_;
+    uint64_t begin_ts_ = 0;
+};
+} // namespace
+
+#define PPLNN_TRACE_CONVERSION(func) ConversionTraceGuard __trace_guard__(func, this)
+#else
+#define PPLNN_TRACE_CONVERSION(func)
+#endif
+
 RetCode TensorImpl::ConvertToHost(void* dst, const TensorShape& dst_desc) const {
+    PPLNN_TRACE_CONVERSION("ConvertToHost");
     auto converter = buffer_info_.GetDevice()->GetDataConverter();
     return converter->ConvertToHost(dst, dst_desc, buffer_info_.GetBufferDesc(), *buffer_info_.GetShape());
 }
 
 RetCode TensorImpl::ConvertFromHost(const void* src, const TensorShape& src_desc) {
+    PPLNN_TRACE_CONVERSION("ConvertFromHost");
     auto converter = buffer_info_.GetDevice()->GetDataConverter();
     return converter->ConvertFromHost(&buffer_info_.GetBufferDesc(), *buffer_info_.GetShape(), src, src_desc);
 }
 
+RetCode TensorImpl::ConvertFromHostImage(const uint8_t* src, const float* mean, const float* scale) {
+    PPLNN_TRACE_CONVERSION("ConvertFromHostImage");
+    auto converter = buffer_info_.GetDevice()->GetDataConverter();
+    return converter->ConvertFromHostImage(&buffer_info_.GetBufferDesc(), *buffer_info_.GetShape(), src, mean, scale);
+}
+
 }} // namespace ppl::nn
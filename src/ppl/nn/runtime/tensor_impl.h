@@ -65,6 +65,16 @@ public:
 
     void SetBuffer(const BufferDesc& buf, Device* device = nullptr, bool is_buffer_owner = false) {
         buffer_info_.SetBuffer(buf, device, is_buffer_owner);
+        view_bytes_ = 0;
+    }
+
+    /**
+       @brief uses `bytes` bytes of `buf` owned by others. unlike `SetBuffer()`, `ReallocBuffer()` keeps the view
+       if the shape fits in it, otherwise replaces it with a new buffer owned by this tensor.
+    */
+    void SetBufferView(const BufferDesc& buf, Device* device, uint64_t bytes) {
+        buffer_info_.SetBuffer(buf, device, false);
+        view_bytes_ = bytes;
     }
 
     /**
@@ -73,21 +83,25 @@ public:
     */
     void TransferBufferFrom(TensorImpl* another) {
         buffer_info_.SetBuffer(another->GetBufferDesc(), another->GetDevice(), another->IsBufferOwner());
+        view_bytes_ = another->view_bytes_;
         another->DetachBuffer();
     }
 
     BufferDesc DetachBuffer() {
+        view_bytes_ = 0;
         return buffer_info_.DetachBuffer();
     }
 
     void FreeBuffer() override {
         buffer_info_.FreeBuffer();
+        view_bytes_ = 0;
     }
 
     ppl::common::RetCode ReallocBuffer() override;
 
     void SetBufferPtr(void* ptr) override {
         buffer_info_.SetBuffer(BufferDesc(ptr));
+        view_bytes_ = 0;
     }
 
     void* GetBufferPtr() const override {
@@ -115,10 +129,12 @@ public:
 
     ppl::common::RetCode ConvertToHost(void* dst, const TensorShape& dst_desc) const override;
     ppl::common::RetCode ConvertFromHost(const void* src, const TensorShape& src_desc) override;
+    ppl::common::RetCode ConvertFromHostImage(const uint8_t* src, const float* mean, const float* scale) override;
 
 private:
     tensortype_t type_;
     TensorBufferInfo buffer_info_;
+    uint64_t view_bytes_ = 0; // size of the view set by `SetBufferView()`, 0 if there is no view
 
 private:
     TensorImpl(const TensorImpl&) = delete;
@@ -0,0 +1,328 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/nn/utils/planned_buffer_manager.h"
+#include "ppl/nn/common/logger.h"
+#include <algorithm>
+#include <limits>
+using namespace std;
+using namespace ppl::common;
+
+namespace ppl { namespace nn { namespace utils {
+
+static const uint32_t INVALID_EVENT_IDX = numeric_limits<uint32_t>::max();
+
+static inline uint64_t Align(uint64_t x, uint64_t n) {
+    return (x + n - 1) & (~(n - 1));
+}
+
+PlannedBufferManager::PlannedBufferManager(BufferManager* fallback, uint64_t alignment)
+    : BufferManager("PlannedBufferManager"), alignment_(alignment), fallback_(fallback) {}
+
+PlannedBufferManager::~PlannedBufferManager() {
+    if (arena_.addr) {
+        fallback_->Free(&arena_);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+void PlannedBufferManager::RecordAlloc(void* addr, uint64_t bytes) {
+    Block blk;
+    blk.bytes = bytes;
+    blk.offset = 0;
+    blk.begin = events_.size();
+    blk.end = INVALID_EVENT_IDX;
+    blk.persistent = false;
+
+    Event evt;
+    evt.block_idx = blocks_.size();
+    evt.is_alloc = true;
+
+    live_blocks_[addr] = blocks_.size();
+    blocks_.push_back(blk);
+    events_.push_back(evt);
+}
+
+void PlannedBufferManager::RecordFree(void* addr) {
+    auto ref = live_blocks_.find(addr);
+    if (ref == live_blocks_.end()) {
+        return;
+    }
+
+    Event evt;
+    evt.block_idx = ref->second;
+    evt.is_alloc = false;
+
+    blocks_[ref->second].end = events_.size();
+    events_.push_back(evt);
+    live_blocks_.erase(ref);
+}
+
+static inline bool IsOverlapped(uint32_t b1, uint32_t e1, uint32_t b2, uint32_t e2) {
+    return (b1 < e2 && b2 < e1);
+}
+
+RetCode PlannedBufferManager::BuildPlan() {
+    // buffers which are still alive will be used in the next run. they cannot be placed in the arena.
+    for (auto it = live_blocks_.begin(); it != live_blocks_.end(); ++it) {
+        blocks_[it->second].persistent = true;
+    }
+    live_blocks_.clear();
+
+    vector<uint32_t> sorted_blocks;
+    sorted_blocks.reserve(blocks_.size());
+    for (uint32_t i = 0; i < blocks_.size(); ++i) {
+        if (!blocks_[i].persistent) {
+            sorted_blocks.push_back(i);
+        }
+    }
+    std::sort(sorted_blocks.begin(), sorted_blocks.end(), [this](uint32_t a, uint32_t b) -> bool {
+        if (blocks_[a].bytes == blocks_[b].bytes) {
+            return (blocks_[a].begin < blocks_[b].begin);
+        }
+        return (blocks_[a].bytes > blocks_[b].bytes);
+    });
+
+    // greedy by size: places larger blocks first, in the smallest gap between blocks whose lifetimes overlap
+    uint64_t arena_bytes = 0;
+    vector<const Block*> conflicts;
+    for (uint32_t i = 0; i < sorted_blocks.size(); ++i) {
+        auto& blk = blocks_[sorted_blocks[i]];
+
+        conflicts.clear();
+        for (uint32_t j = 0; j < i; ++j) {
+            auto placed = &blocks_[sorted_blocks[j]];
+            if (IsOverlapped(blk.begin, blk.end, placed->begin, placed->end)) {
+                conflicts.push_back(placed);
+            }
+        }
+        std::sort(conflicts.begin(), conflicts.end(), [](const Block* a, const Block* b) -> bool {
+            return (a->offset < b->offset);
+        });
+
+        uint64_t prev_end = 0;
+        uint64_t best_offset = 0, best_gap = UINT64_MAX;
+        for (auto c = conflicts.begin(); c != conflicts.end(); ++c) {
+            if ((*c)->offset > prev_end) {
+                auto gap = (*c)->offset - prev_end;
+                if (gap >= blk.bytes && gap < best_gap) {
+                    best_gap = gap;
+                    best_offset = prev_end;
+                }
+            }
+            prev_end = std::max(prev_end, (*c)->offset + (*c)->bytes);
+        }
+
+        blk.offset = (best_gap == UINT64_MAX) ? prev_end : best_offset;
+        arena_bytes = std::max(arena_bytes, blk.offset + blk.bytes);
+    }
+
+    uint64_t live_bytes = 0;
+    for (auto e = events_.begin(); e != events_.end(); ++e) {
+        auto& blk = blocks_[e->block_idx];
+        if (blk.persistent) {
+            continue;
+        }
+        if (e->is_alloc) {
+            live_bytes += blk.bytes;
+            max_live_bytes_ = std::max(max_live_bytes_, live_bytes);
+        } else {
+            live_bytes -= blk.bytes;
+        }
+    }
+
+    if (arena_bytes > 0) {
+        arena_.addr = nullptr;
+        auto status = fallback_->Realloc(arena_bytes, &arena_);
+        if (status != RC_SUCCESS) {
+            LOG(ERROR) << "alloc arena of [" << arena_bytes << "] bytes failed: " << GetRetCodeStr(status);
+            return status;
+        }
+    }
+    arena_bytes_ = arena_bytes;
+
+    LOG(INFO) << "memory plan: [" << sorted_blocks.size() << "] buffers in arena, ["
+              << blocks_.size() - sorted_blocks.size() << "] buffers allocated dynamically, planned bytes ["
+              << arena_bytes_ << "], max live bytes [" << max_live_bytes_ << "]";
+
+    return RC_SUCCESS;
+}
+
+void PlannedBufferManager::Diverge(const char* reason) {
+    LOG(WARNING) << "memory plan is abandoned: " << reason;
+    Disable();
+}
+
+void PlannedBufferManager::Disable() {
+    // `arena_` is kept because some buffers in it may still be in use
+    state_ = STATE_DISABLED;
+    live_blocks_.clear();
+    blocks_.clear();
+    events_.clear();
+}
+
+void PlannedBufferManager::RestartRecording() {
+    if (state_ != STATE_RECORDING) {
+        return;
+    }
+    // buffers allocated in the current run are still valid. frees of them are ignored because they are not recorded.
+    state_ = STATE_IDLE;
+    live_blocks_.clear();
+    blocks_.clear();
+    events_.clear();
+}
+
+RetCode PlannedBufferManager::BeginRun() {
+    if (state_ == STATE_IDLE) {
+        state_ = STATE_RECORDING;
+    } else if (state_ == STATE_RECORDING) {
+        auto status = BuildPlan();
+        if (status != RC_SUCCESS) {
+            Diverge("building plan failed");
+            return RC_SUCCESS;
+        }
+        state_ = STATE_REPLAYING;
+    } else if (state_ == STATE_REPLAYING) {
+        if (cursor_ != events_.size()) {
+            Diverge("last run is incomplete");
+            return RC_SUCCESS;
+        }
+    }
+
+    cursor_ = 0;
+    live_blocks_.clear();
+    return RC_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+
+RetCode PlannedBufferManager::FallbackRealloc(uint64_t bytes, BufferDesc* buffer) {
+    if (IsInArena(buffer->addr)) {
+        buffer->addr = nullptr;
+    }
+    return fallback_->Realloc(bytes, buffer);
+}
+
+void PlannedBufferManager::FallbackFree(BufferDesc* buffer) {
+    if (IsInArena(buffer->addr)) {
+        buffer->addr = nullptr;
+        return;
+    }
+    fallback_->Free(buffer);
+}
+
+bool PlannedBufferManager::ReplayFree(void* addr) {
+    auto ref = live_blocks_.find(addr);
+    if (cursor_ >= events_.size()) {
+        return false;
+    }
+
+    auto& evt = events_[cursor_];
+    if (evt.is_alloc || evt.block_idx != ref->second) {
+        return false;
+    }
+
+    ++cursor_;
+    live_blocks_.erase(ref);
+    return true;
+}
+
+RetCode PlannedBufferManager::ReplayAlloc(uint64_t bytes, BufferDesc* buffer) {
+    if (cursor_ >= events_.size() || !events_[cursor_].is_alloc) {
+        Diverge("unexpected allocation");
+        return FallbackRealloc(bytes, buffer);
+    }
+
+    auto block_idx = events_[cursor_].block_idx;
+    auto& blk = blocks_[block_idx];
+    if (Align(bytes, alignment_) > blk.bytes) {
+        Diverge("buffer size changed");
+        return FallbackRealloc(bytes, buffer);
+    }
+
+    if (blk.persistent) {
+        auto status = fallback_->Realloc(bytes, buffer);
+        if (status != RC_SUCCESS) {
+            return status;
+        }
+    } else {
+        if (buffer->addr) {
+            fallback_->Free(buffer);
+        }
+        buffer->addr = (char*)arena_.addr + blk.offset;
+        buffer->desc = blk.bytes;
+    }
+
+    live_blocks_[buffer->addr] = block_idx;
+    ++cursor_;
+    return RC_SUCCESS;
+}
+
+RetCode PlannedBufferManager::Realloc(uint64_t bytes, BufferDesc* buffer) {
+    if (state_ == STATE_RECORDING) {
+        if (buffer->addr) {
+            RecordFree(buffer->addr);
+        }
+        auto status = fallback_->Realloc(bytes, buffer);
+        if (status == RC_SUCCESS && buffer->addr) {
+            RecordAlloc(buffer->addr, Align(bytes, alignment_));
+        }
+        return status;
+    }
+
+    if (state_ == STATE_REPLAYING) {
+        if (buffer->addr) {
+            if (live_blocks_.find(buffer->addr) != live_blocks_.end()) {
+                if (!ReplayFree(buffer->addr)) {
+                    Diverge("unexpected free");
+                    return FallbackRealloc(bytes, buffer);
+                }
+            }
+            if (IsInArena(buffer->addr)) {
+                buffer->addr = nullptr;
+            }
+        }
+
+        if (bytes == 0) {
+            return FallbackRealloc(bytes, buffer);
+        }
+        return ReplayAlloc(bytes, buffer);
+    }
+
+    return FallbackRealloc(bytes, buffer);
+}
+
+void PlannedBufferManager::Free(BufferDesc* buffer) {
+    if (!buffer->addr) {
+        return;
+    }
+
+    if (state_ == STATE_RECORDING) {
+        RecordFree(buffer->addr);
+    } else if (state_ == STATE_REPLAYING) {
+        if (live_blocks_.find(buffer->addr) != live_blocks_.end()) {
+            if (!ReplayFree(buffer->addr)) {
+                Diverge("unexpected free");
+            }
+        }
+    }
+
+    FallbackFree(buffer);
+}
+
+}}} // namespace ppl::nn::utils
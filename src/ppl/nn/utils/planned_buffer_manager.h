@@ -0,0 +1,148 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef _ST_HPC_PPL_NN_UTILS_PLANNED_BUFFER_MANAGER_H_
+#define _ST_HPC_PPL_NN_UTILS_PLANNED_BUFFER_MANAGER_H_
+
+#include "ppl/nn/utils/buffer_manager.h"
+#include <memory>
+#include <vector>
+#include <map>
+
+namespace ppl { namespace nn { namespace utils {
+
+/**
+   @class PlannedBufferManager
+   @brief a buffer manager for runtimes whose input shapes never change.
+
+   the sequence of Realloc()/Free() calls between two BeginRun()s is recorded during the first run.
+   lifetimes of buffers are derived from the sequence and offsets of buffers are assigned in a single
+   arena(greedy by size). following runs are served from the arena without calling any allocator as long
+   as the sequence is exactly the same as the recorded one. buffers that are not freed before the next
+   BeginRun()(inputs/outputs for example) are always allocated by `fallback`.
+
+   if a different sequence is detected(shapes changed, for example), the plan is abandoned and all
+   requests are forwarded to `fallback`.
+*/
+class PlannedBufferManager final : public BufferManager {
+public:
+    /** @param fallback will be destroyed by this manager */
+    PlannedBufferManager(BufferManager* fallback, uint64_t alignment);
+    ~PlannedBufferManager();
+
+    /** @brief marks the beginning of a run. the plan is built when it is called the second time. */
+    ppl::common::RetCode BeginRun();
+
+    /** @brief abandons the plan and forwards all requests to `fallback`. */
+    void Disable();
+
+    /**
+       @brief discards events recorded in the current run so that recording starts again from the next BeginRun().
+       used when the allocation sequence of the following runs is known to be different from the current one.
+       does nothing if the plan is not being recorded.
+    */
+    void RestartRecording();
+
+    bool IsPlanned() const {
+        return (state_ == STATE_REPLAYING);
+    }
+
+    /** @brief size of the arena. 0 if the plan is not built yet. */
+    uint64_t GetPlannedBytes() const {
+        return arena_bytes_;
+    }
+
+    /** @brief max bytes of buffers alive at the same time, which is the lower bound of `GetPlannedBytes()`. */
+    uint64_t GetMaxLiveBytes() const {
+        return max_live_bytes_;
+    }
+
+    /** @brief (planned_bytes - max_live_bytes) / planned_bytes */
+    float GetFragmentationRatio() const {
+        return (arena_bytes_ == 0) ? 0.0f : (float)(arena_bytes_ - max_live_bytes_) / (float)arena_bytes_;
+    }
+
+    ppl::common::RetCode Realloc(uint64_t bytes, BufferDesc* buffer) override;
+    void Free(BufferDesc* buffer) override;
+    uint64_t GetAllocatedBytes() const override {
+        return fallback_->GetAllocatedBytes();
+    }
+
+private:
+    enum {
+        STATE_IDLE, // before the first BeginRun()
+        STATE_RECORDING,
+        STATE_REPLAYING,
+        STATE_DISABLED,
+    };
+
+    struct Block final {
+        uint64_t bytes;
+        uint64_t offset;
+        uint32_t begin; // index of alloc event
+        uint32_t end; // index of free event
+        bool persistent; // not freed before the next BeginRun()
+    };
+
+    struct Event final {
+        uint32_t block_idx;
+        bool is_alloc;
+    };
+
+    bool IsInArena(const void* addr) const {
+        return (addr >= arena_.addr && addr < (const char*)arena_.addr + arena_bytes_);
+    }
+
+    ppl::common::RetCode BuildPlan();
+    void Diverge(const char* reason);
+
+    void RecordAlloc(void* addr, uint64_t bytes);
+    void RecordFree(void* addr);
+
+    /** @return false if the free event mismatches */
+    bool ReplayFree(void* addr);
+    ppl::common::RetCode ReplayAlloc(uint64_t bytes, BufferDesc* buffer);
+
+    ppl::common::RetCode FallbackRealloc(uint64_t bytes, BufferDesc* buffer);
+    void FallbackFree(BufferDesc* buffer);
+
+private:
+    uint32_t state_ = STATE_IDLE;
+    const uint64_t alignment_;
+    std::unique_ptr<BufferManager> fallback_;
+
+    std::vector<Block> blocks_;
+    std::vector<Event> events_;
+
+    /** index of the next event to be replayed */
+    uint32_t cursor_ = 0;
+
+    /** addr => block index of buffers allocated in the current run */
+    std::map<const void*, uint32_t> live_blocks_;
+
+    BufferDesc arena_;
+    uint64_t arena_bytes_ = 0;
+    uint64_t max_live_bytes_ = 0;
+
+private:
+    PlannedBufferManager(const PlannedBufferManager&) = delete;
+    PlannedBufferManager& operator=(const PlannedBufferManager&) = delete;
+};
+
+}}} // namespace ppl::nn::utils
+
+#endif
@@ -77,6 +77,19 @@ RetCode StackBufferManager::Realloc(uint64_t bytes, BufferDesc* buffer) {
     return RC_SUCCESS;
 }
 
+void StackBufferManager::Defragment() {
+    // ids are kept because `BufferDesc::desc` of buffers in use refers to them
+    for (auto id : buffer_stack_) {
+        auto& managed_buffer = buffer_list_[id];
+        if (managed_buffer.addr) {
+            allocator_->Free(managed_buffer.addr);
+            allocated_bytes_ -= managed_buffer.size;
+            managed_buffer.addr = nullptr;
+            managed_buffer.size = 0;
+        }
+    }
+}
+
 void StackBufferManager::Free(BufferDesc* buffer) {
     if (buffer->addr == nullptr || buffer->desc > buffer_list_.size()) {
         return;
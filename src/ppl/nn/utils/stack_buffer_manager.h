@@ -39,6 +39,12 @@ public:
         return allocated_bytes_;
     }
 
+    /**
+       @brief frees memory of buffers which are not in use. buffers in use are not affected.
+       @note make sure that this manager is not used when calling Defragment().
+    */
+    void Defragment();
+
 private:
     struct BufferAddrAndSize {
         void* addr;
@@ -57,7 +63,9 @@ private:
 
     inline void ReallocManagedBuffer(uint64_t bytes, BufferAddrAndSize* managed_buffer) {
         if (bytes > managed_buffer->size) {
-            allocator_->Free(managed_buffer->addr);
+            if (managed_buffer->addr) {
+                allocator_->Free(managed_buffer->addr);
+            }
             allocated_bytes_ -= managed_buffer->size;
             AllocManagedBuffer(bytes, managed_buffer);
         }
@@ -0,0 +1,180 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "ppl/nn/utils/trace_recorder.h"
+#include "ppl/nn/common/logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+using namespace std;
+using namespace ppl::common;
+
+namespace ppl { namespace nn { namespace utils {
+
+uint64_t TraceRecorder::Now() {
+    auto ts = chrono::system_clock::now().time_since_epoch();
+    return chrono::duration_cast<chrono::microseconds>(ts).count();
+}
+
+static atomic<uint32_t> g_thread_seq(0);
+
+/** small sequential ids are easier to read than `std::thread::id` in trace viewers */
+static uint32_t GetThreadSeq() {
+    static thread_local uint32_t seq = g_thread_seq.fetch_add(1, memory_order_relaxed);
+    return seq;
+}
+
+void TraceRecorder::Start(uint32_t max_events) {
+    lock_guard<mutex> lck(mtx_);
+    events_.clear();
+    events_.resize(max_events);
+    event_count_ = 0;
+    enabled_.store(max_events > 0, memory_order_relaxed);
+}
+
+void TraceRecorder::Stop() {
+    enabled_.store(false, memory_order_relaxed);
+}
+
+uint64_t TraceRecorder::GetDroppedEventCount() const {
+    lock_guard<mutex> lck(mtx_);
+    return (event_count_ > events_.size()) ? (event_count_ - events_.size()) : 0;
+}
+
+void TraceRecorder::AddEvent(Event&& evt) {
+    evt.tid = GetThreadSeq();
+
+    lock_guard<mutex> lck(mtx_);
+    if (!IsEnabled() || events_.empty()) {
+        return;
+    }
+    events_[event_count_ % events_.size()] = std::move(evt);
+    ++event_count_;
+}
+
+void TraceRecorder::AddCompleteEvent(const char* category, const string& name, uint64_t begin_us, uint64_t end_us,
+                                     const string& detail) {
+    Event evt;
+    evt.type = EVENT_COMPLETE;
+    evt.category = category;
+    evt.name = name;
+    evt.detail = detail;
+    evt.ts = begin_us;
+    evt.dur = (end_us > begin_us) ? (end_us - begin_us) : 0;
+    evt.value = 0;
+    AddEvent(std::move(evt));
+}
+
+void TraceRecorder::AddInstantEvent(const char* category, const string& name, uint64_t bytes) {
+    Event evt;
+    evt.type = EVENT_INSTANT;
+    evt.category = category;
+    evt.name = name;
+    evt.ts = Now();
+    evt.dur = 0;
+    evt.value = bytes;
+    AddEvent(std::move(evt));
+}
+
+void TraceRecorder::AddCounterEvent(const char* category, const string& name, uint64_t value) {
+    Event evt;
+    evt.type = EVENT_COUNTER;
+    evt.category = category;
+    evt.name = name;
+    evt.ts = Now();
+    evt.dur = 0;
+    evt.value = value;
+    AddEvent(std::move(evt));
+}
+
+static void WriteJsonString(const string& s, ofstream* ofs) {
+    ofs->put('"');
+    for (auto c = s.begin(); c != s.end(); ++c) {
+        if (*c == '"' || *c == '\\') {
+            ofs->put('\\');
+            ofs->put(*c);
+        } else if ((unsigned char)(*c) < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", (unsigned char)(*c));
+            ofs->write(buf, 6);
+        } else {
+            ofs->put(*c);
+        }
+    }
+    ofs->put('"');
+}
+
+RetCode TraceRecorder::SaveAsChromeTrace(const char* filename) const {
+    ofstream ofs(filename, ios_base::out | ios_base::trunc);
+    if (!ofs.is_open()) {
+        LOG(ERROR) << "open file[" << filename << "] failed.";
+        return RC_OTHER_ERROR;
+    }
+
+    lock_guard<mutex> lck(mtx_);
+
+    uint64_t first = 0, count = event_count_;
+    if (event_count_ > events_.size()) {
+        first = event_count_ % events_.size();
+        count = events_.size();
+    }
+
+    // timestamps start from the earliest event
+    uint64_t base_ts = numeric_limits<uint64_t>::max();
+    for (uint64_t i = 0; i < count; ++i) {
+        base_ts = std::min(base_ts, events_[(first + i) % events_.size()].ts);
+    }
+
+    ofs << "{\"traceEvents\":[";
+    for (uint64_t i = 0; i < count; ++i) {
+        auto& evt = events_[(first + i) % events_.size()];
+        if (i > 0) {
+            ofs << ",";
+        }
+        ofs << "\n{\"name\":";
+        WriteJsonString(evt.name, &ofs);
+        ofs << ",\"cat\":\"" << evt.category << "\",\"pid\":0,\"tid\":" << evt.tid << ",\"ts\":" << evt.ts - base_ts;
+        if (evt.type == EVENT_COMPLETE) {
+            ofs << ",\"ph\":\"X\",\"dur\":" << evt.dur;
+            if (!evt.detail.empty()) {
+                ofs << ",\"args\":{\"detail\":";
+                WriteJsonString(evt.detail, &ofs);
+                ofs << "}";
+            }
+        } else if (evt.type == EVENT_INSTANT) {
+            ofs << ",\"ph\":\"i\",\"s\":\"t\",\"args\":{\"bytes\":" << evt.value << "}";
+        } else {
+            ofs << ",\"ph\":\"C\",\"args\":{\"value\":" << evt.value << "}";
+        }
+        ofs << "}";
+    }
+    ofs << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    if (!ofs.good()) {
+        LOG(ERROR) << "write trace to file[" << filename << "] failed.";
+        return RC_OTHER_ERROR;
+    }
+
+    LOG(INFO) << "[" << count << "] trace events are saved to [" << filename << "], ["
+              << event_count_ - count << "] events are dropped.";
+    return RC_SUCCESS;
+}
+
+}}} // namespace ppl::nn::utils
@@ -0,0 +1,101 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#ifndef _ST_HPC_PPL_NN_UTILS_TRACE_RECORDER_H_
+#define _ST_HPC_PPL_NN_UTILS_TRACE_RECORDER_H_
+
+#include "ppl/common/retcode.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ppl { namespace nn { namespace utils {
+
+/**
+   @class TraceRecorder
+   @brief records timeline events(kernel executions, memory operations, data conversions, etc.) of all runtimes
+   in a ring buffer, which can be saved in the chrome trace event format and viewed by chrome://tracing or perfetto.
+   oldest events are overwritten when the buffer is full.
+*/
+class TraceRecorder final {
+public:
+    static TraceRecorder* GetInstance() {
+        static TraceRecorder recorder;
+        return &recorder;
+    }
+
+    /** @brief microseconds since epoch of `std::chrono::system_clock`, which is also used by `CpuTimingGuard` */
+    static uint64_t Now();
+
+    /** @brief starts recording. at most `max_events` latest events are kept. */
+    void Start(uint32_t max_events);
+    /** @brief stops recording. recorded events are kept until the next Start(). */
+    void Stop();
+
+    bool IsEnabled() const {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /** @brief an event lasting from `begin_us` to `end_us`, with an optional string argument `detail` */
+    void AddCompleteEvent(const char* category, const std::string& name, uint64_t begin_us, uint64_t end_us,
+                          const std::string& detail = std::string());
+    /** @brief an event happening at present, with an optional argument `bytes` */
+    void AddInstantEvent(const char* category, const std::string& name, uint64_t bytes = 0);
+    /** @brief value of counter `name` at present, which is displayed as a track */
+    void AddCounterEvent(const char* category, const std::string& name, uint64_t value);
+
+    /** @brief number of events overwritten since the last Start() */
+    uint64_t GetDroppedEventCount() const;
+
+    ppl::common::RetCode SaveAsChromeTrace(const char* filename) const;
+
+private:
+    enum {
+        EVENT_COMPLETE,
+        EVENT_INSTANT,
+        EVENT_COUNTER,
+    };
+
+    struct Event final {
+        uint32_t type;
+        uint32_t tid;
+        const char* category;
+        std::string name;
+        std::string detail;
+        uint64_t ts;
+        uint64_t dur;
+        uint64_t value;
+    };
+
+    void AddEvent(Event&&);
+
+private:
+    TraceRecorder() : enabled_(false) {}
+
+private:
+    std::atomic<bool> enabled_;
+    mutable std::mutex mtx_;
+    std::vector<Event> events_;
+    /** number of events added since the last Start(). the next event is placed at `event_count_ % events_.size()` */
+    uint64_t event_count_ = 0;
+};
+
+}}} // namespace ppl::nn::utils
+
+#endif
@@ -28,6 +28,9 @@ public:
     const char* GetName() const override {
         return "tmp";
     }
+    ppl::common::RetCode SetMaxConcurrentKernels(uint32_t) override {
+        return ppl::common::RC_SUCCESS;
+    }
 
 private:
     utils::GenericCpuDevice device_;
@@ -0,0 +1,315 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#if defined(PPLNN_USE_X86) && defined(PPLNN_ENABLE_ONNX_MODEL)
+
+#include "ppl/nn/engines/x86/algo_tuning_cache.h"
+#include "ppl/nn/engines/x86/engine_factory.h"
+#include "ppl/nn/engines/x86/ops.h"
+#include "ppl/nn/engines/x86/optimizer/ops/onnx/conv_op.h"
+#include "ppl/nn/models/onnx/model_parser.h"
+#include "ppl/nn/optimizers/utils.h"
+#include "ppl/nn/optimizers/engine_graph_partitioner.h"
+#include "ppl/kernel/x86/common/threading_tools.h"
+#include "tests/models/onnx/onnx_model_builder.h"
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+using namespace std;
+using namespace ppl::nn;
+using namespace ppl::common;
+using namespace ppl::kernel::x86;
+using namespace ppl::nn::test;
+
+/*
+  algorithms exported by one engine are imported by another one, which selects them without tuning if the isa,
+  conv param, input shape and number of threads are the same. invalid files are rejected as a whole.
+*/
+class X86AlgoTuningCacheTest : public testing::Test {
+protected:
+    static void SetUpTestCase() {
+        x86::RegisterBuiltinOpImpls();
+    }
+    void SetUp() override {
+        algo_file_ = testing::TempDir() + "x86_algo_tuning_cache_test.algo";
+    }
+    void TearDown() override {
+        remove(algo_file_.c_str());
+    }
+
+    static void WriteFile(const string& file, const string& content) {
+        ofstream ofs(file, ios_base::out | ios_base::binary | ios_base::trunc);
+        ofs.write(content.data(), content.size());
+    }
+
+    static string ReadFile(const string& file) {
+        ifstream ifs(file, ios_base::in | ios_base::binary);
+        return string(istreambuf_iterator<char>(ifs), istreambuf_iterator<char>());
+    }
+
+    static bool IsSameAlgo(const conv2d_fp32_algo_info& a, const conv2d_fp32_algo_info& b) {
+        return a.algo_type == b.algo_type && a.isa == b.isa && a.input_format == b.input_format &&
+            a.output_format == b.output_format;
+    }
+
+    static vector<float> RandomData(uint64_t size, uint32_t seed) {
+        mt19937 gen(seed);
+        uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        vector<float> data(size);
+        for (uint64_t i = 0; i < size; ++i) {
+            data[i] = dist(gen);
+        }
+        return data;
+    }
+
+    // the conv in the model created by CreateConvModel()
+    static conv2d_fp32_param GetConvParam() {
+        conv2d_fp32_param param;
+        param.kernel_h = 3;
+        param.kernel_w = 3;
+        param.stride_h = 1;
+        param.stride_w = 1;
+        param.pad_h = 1;
+        param.pad_w = 1;
+        param.dilation_h = 1;
+        param.dilation_w = 1;
+        param.group = 1;
+        param.num_output = 32;
+        param.channels = 32;
+        param.fuse_flag = 0;
+        return param;
+    }
+
+    static TensorShape GetSrcShape() {
+        TensorShape shape;
+        shape.Reshape({1, 32, 28, 28});
+        shape.SetDataType(DATATYPE_FLOAT32);
+        shape.SetDataFormat(DATAFORMAT_NDARRAY);
+        return shape;
+    }
+
+    static string CreateConvModel() {
+        OnnxModelBuilder builder;
+        auto graph = builder.GetGraph();
+        OnnxModelBuilder::AddInput(graph, "x", {1, 32, 28, 28});
+        OnnxModelBuilder::AddInitializer(graph, "w", {32, 32, 3, 3}, RandomData(32 * 32 * 3 * 3, 1));
+        OnnxModelBuilder::AddInitializer(graph, "b", {32}, RandomData(32, 2));
+        auto conv = OnnxModelBuilder::AddNode(graph, "Conv", {"x", "w", "b"}, {"y"});
+        OnnxModelBuilder::SetAttr(conv, "kernel_shape", vector<int64_t>{3, 3});
+        OnnxModelBuilder::SetAttr(conv, "pads", vector<int64_t>{1, 1, 1, 1});
+        OnnxModelBuilder::AddOutput(graph, "y");
+        return builder.Serialize();
+    }
+
+    // optimizes the conv model with `engine` and returns the algorithm selected for the float32 conv
+    static bool SelectConvAlgo(Engine* engine, conv2d_fp32_algo_info* algo_info) {
+        auto buf = CreateConvModel();
+        ir::Graph graph;
+        if (ppl::nn::onnx::ModelParser::Parse(buf.data(), buf.size(), ".", &graph) != RC_SUCCESS) {
+            ADD_FAILURE() << "parse model failed";
+            return false;
+        }
+
+        utils::SharedResource resource;
+        resource.engines.push_back(static_cast<EngineImpl*>(engine));
+        resource.graph_partitioner = make_shared<EngineGraphPartitioner>();
+        RuntimeGraphInfo info;
+        if (utils::ProcessGraph(resource, &graph, &info) != RC_SUCCESS) {
+            ADD_FAILURE() << "process graph failed";
+            return false;
+        }
+
+        for (auto p = info.partitions.begin(); p != info.partitions.end(); ++p) {
+            for (auto op = p->ops.begin(); op != p->ops.end(); ++op) {
+                auto conv_op = dynamic_cast<const x86::ConvOp*>(op->get());
+                if (conv_op && conv_op->GetConv2dParam()) {
+                    *algo_info = conv_op->GetConv2dParam()->algo_info;
+                    return true;
+                }
+            }
+        }
+        ADD_FAILURE() << "float32 conv not found";
+        return false;
+    }
+
+protected:
+    string algo_file_;
+};
+
+TEST_F(X86AlgoTuningCacheTest, export_import) {
+    const conv2d_fp32_algo_info infos[] = {
+        {conv2d_fp32_algo::DIRECT, ISA_X86_AVX512, DATAFORMAT_N16CX, DATAFORMAT_N16CX},
+        {conv2d_fp32_algo::IM2COL_GEMM, ISA_X86_FMA, DATAFORMAT_NDARRAY, DATAFORMAT_NDARRAY},
+        {conv2d_fp32_algo::WINOGRAD_B4F3, ISA_X86_FMA, DATAFORMAT_N16CX, DATAFORMAT_N16CX},
+    };
+    const string keys[] = {"a", "b", "c"};
+
+    x86::AlgoTuningCache exported;
+    for (uint32_t i = 0; i < 3; ++i) {
+        exported.InsertConv2dAlgo(keys[i], infos[i]);
+    }
+    ASSERT_EQ(RC_SUCCESS, exported.Export(algo_file_.c_str()));
+
+    // entries in the file are merged and overwrite existing ones
+    x86::AlgoTuningCache imported;
+    imported.InsertConv2dAlgo("a", infos[2]);
+    imported.InsertConv2dAlgo("d", infos[1]);
+    ASSERT_EQ(RC_SUCCESS, imported.Import(algo_file_.c_str()));
+
+    conv2d_fp32_algo_info info;
+    for (uint32_t i = 0; i < 3; ++i) {
+        ASSERT_TRUE(imported.FindConv2dAlgo(keys[i], &info)) << "key " << keys[i];
+        EXPECT_TRUE(IsSameAlgo(infos[i], info)) << "key " << keys[i];
+    }
+    ASSERT_TRUE(imported.FindConv2dAlgo("d", &info));
+    EXPECT_TRUE(IsSameAlgo(infos[1], info));
+    EXPECT_FALSE(imported.FindConv2dAlgo("e", &info));
+}
+
+TEST_F(X86AlgoTuningCacheTest, reject_invalid_file) {
+    const conv2d_fp32_algo_info algo_info = {conv2d_fp32_algo::DIRECT, ISA_X86_FMA, DATAFORMAT_N16CX,
+                                             DATAFORMAT_N16CX};
+    x86::AlgoTuningCache exported;
+    exported.InsertConv2dAlgo("first", algo_info);
+    exported.InsertConv2dAlgo("second", algo_info);
+    ASSERT_EQ(RC_SUCCESS, exported.Export(algo_file_.c_str()));
+    const string content = ReadFile(algo_file_);
+    ASSERT_GT(content.size(), sizeof(uint32_t) + sizeof(uint64_t));
+
+    x86::AlgoTuningCache imported;
+    conv2d_fp32_algo_info info;
+
+    string bad_version = content;
+    const uint32_t version = 2;
+    bad_version.replace(0, sizeof(version), (const char*)&version, sizeof(version));
+    WriteFile(algo_file_, bad_version);
+    EXPECT_EQ(RC_UNSUPPORTED, imported.Import(algo_file_.c_str()));
+
+    // the first entry is complete but nothing is imported if the last one is truncated
+    const uint64_t sizes[] = {0, sizeof(uint32_t), content.size() - 1, content.size() - sizeof(algo_info) - 1};
+    for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        WriteFile(algo_file_, content.substr(0, sizes[i]));
+        EXPECT_EQ(RC_INVALID_VALUE, imported.Import(algo_file_.c_str())) << "size " << sizes[i];
+    }
+    EXPECT_FALSE(imported.FindConv2dAlgo("first", &info));
+    EXPECT_FALSE(imported.FindConv2dAlgo("second", &info));
+
+    remove(algo_file_.c_str());
+    EXPECT_NE(RC_SUCCESS, imported.Import(algo_file_.c_str()));
+}
+
+TEST_F(X86AlgoTuningCacheTest, select_imported_algo) {
+    const isa_t isa = GetCpuISA();
+    const auto param = GetConvParam();
+    const auto src_shape = GetSrcShape();
+
+    // the first candidate is what heuristics select, so import another one
+    auto candidates = conv2d_algo_selector::get_supported_algos(DATAFORMAT_NDARRAY, param, isa);
+    ASSERT_FALSE(candidates.empty());
+    conv2d_fp32_algo_info default_info;
+    {
+        unique_ptr<Engine> engine(x86::EngineFactory::Create(x86::EngineOptions()));
+        ASSERT_TRUE(SelectConvAlgo(engine.get(), &default_info));
+        EXPECT_TRUE(IsSameAlgo(candidates[0], default_info));
+    }
+    ASSERT_GE(candidates.size(), 2u);
+    const conv2d_fp32_algo_info expected = candidates.back();
+    ASSERT_FALSE(IsSameAlgo(default_info, expected));
+
+    x86::AlgoTuningCache cache;
+    cache.InsertConv2dAlgo(x86::AlgoTuningCache::GenConv2dKey(isa, param, src_shape, get_omp_max_threads()),
+                           expected);
+    ASSERT_EQ(RC_SUCCESS, cache.Export(algo_file_.c_str()));
+
+    // imported algorithms are used even if tuning is off
+    unique_ptr<Engine> engine(x86::EngineFactory::Create(x86::EngineOptions()));
+    ASSERT_EQ(RC_SUCCESS, engine->Configure(x86::ENGINE_CONF_IMPORT_ALGORITHMS, algo_file_.c_str()));
+    conv2d_fp32_algo_info info;
+    ASSERT_TRUE(SelectConvAlgo(engine.get(), &info));
+    EXPECT_TRUE(IsSameAlgo(expected, info));
+
+    // keys with another number of threads or input shape do not match
+    x86::AlgoTuningCache mismatched_cache;
+    auto other_shape = src_shape;
+    other_shape.SetDim(2, 27);
+    mismatched_cache.InsertConv2dAlgo(
+        x86::AlgoTuningCache::GenConv2dKey(isa, param, src_shape, get_omp_max_threads() + 1), expected);
+    mismatched_cache.InsertConv2dAlgo(
+        x86::AlgoTuningCache::GenConv2dKey(isa, param, other_shape, get_omp_max_threads()), expected);
+    ASSERT_EQ(RC_SUCCESS, mismatched_cache.Export(algo_file_.c_str()));
+
+    unique_ptr<Engine> mismatched_engine(x86::EngineFactory::Create(x86::EngineOptions()));
+    ASSERT_EQ(RC_SUCCESS, mismatched_engine->Configure(x86::ENGINE_CONF_IMPORT_ALGORITHMS, algo_file_.c_str()));
+    ASSERT_TRUE(SelectConvAlgo(mismatched_engine.get(), &info));
+    EXPECT_TRUE(IsSameAlgo(default_info, info));
+}
+
+TEST_F(X86AlgoTuningCacheTest, ignore_unsupported_isa) {
+    if (!(GetCpuISA() & ISA_X86_FMA)) {
+        return;
+    }
+
+    // the key is generated with the isa of the sse-only engine, but the algorithm requires fma
+    unique_ptr<Engine> engine(x86::EngineFactory::Create(x86::EngineOptions()));
+    ASSERT_EQ(RC_SUCCESS, engine->Configure(x86::ENGINE_CONF_DISABLE_AVX_FMA3));
+    const isa_t isa = GetCpuISA() & (~(ISA_X86_AVX512 | ISA_X86_FMA | ISA_X86_AVX2 | ISA_X86_AVX));
+    const auto param = GetConvParam();
+    const auto default_info = conv2d_algo_selector::select_algo(DATAFORMAT_NDARRAY, param, isa);
+
+    auto fma_candidates =
+        conv2d_algo_selector::get_supported_algos(DATAFORMAT_NDARRAY, param, GetCpuISA() & (~ISA_X86_AVX512));
+    ASSERT_FALSE(fma_candidates.empty());
+    ASSERT_EQ(ISA_X86_FMA, fma_candidates[0].isa & ISA_X86_FMA);
+
+    x86::AlgoTuningCache cache;
+    cache.InsertConv2dAlgo(x86::AlgoTuningCache::GenConv2dKey(isa, param, GetSrcShape(), get_omp_max_threads()),
+                           fma_candidates[0]);
+    ASSERT_EQ(RC_SUCCESS, cache.Export(algo_file_.c_str()));
+    ASSERT_EQ(RC_SUCCESS, engine->Configure(x86::ENGINE_CONF_IMPORT_ALGORITHMS, algo_file_.c_str()));
+
+    conv2d_fp32_algo_info info;
+    ASSERT_TRUE(SelectConvAlgo(engine.get(), &info));
+    EXPECT_TRUE(IsSameAlgo(default_info, info));
+    EXPECT_EQ(0, info.isa & ISA_X86_FMA);
+}
+
+TEST_F(X86AlgoTuningCacheTest, export_tuned_algo) {
+    // algorithms tuned by one engine are selected by another one which imports them without tuning
+    x86::EngineOptions tuning_options;
+    tuning_options.dynamic_tuning_level = x86::TUNING_SELECT_ALGO;
+    unique_ptr<Engine> tuning_engine(x86::EngineFactory::Create(tuning_options));
+    ASSERT_EQ(RC_SUCCESS, tuning_engine->Configure(x86::ENGINE_CONF_EXPORT_ALGORITHMS, algo_file_.c_str()));
+    conv2d_fp32_algo_info tuned_info;
+    ASSERT_TRUE(SelectConvAlgo(tuning_engine.get(), &tuned_info));
+
+    x86::AlgoTuningCache cache;
+    ASSERT_EQ(RC_SUCCESS, cache.Import(algo_file_.c_str()));
+    conv2d_fp32_algo_info info;
+    ASSERT_TRUE(cache.FindConv2dAlgo(
+        x86::AlgoTuningCache::GenConv2dKey(GetCpuISA(), GetConvParam(), GetSrcShape(), get_omp_max_threads()), &info));
+    EXPECT_TRUE(IsSameAlgo(tuned_info, info));
+
+    unique_ptr<Engine> engine(x86::EngineFactory::Create(x86::EngineOptions()));
+    ASSERT_EQ(RC_SUCCESS, engine->Configure(x86::ENGINE_CONF_IMPORT_ALGORITHMS, algo_file_.c_str()));
+    ASSERT_TRUE(SelectConvAlgo(engine.get(), &info));
+    EXPECT_TRUE(IsSameAlgo(tuned_info, info));
+}
+
+#endif
@@ -0,0 +1,393 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/kernel/x86/bf16/conv2d.h"
+#include "ppl/kernel/x86/bf16/cvt.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+using namespace std;
+using namespace ppl::common;
+using namespace ppl::kernel::x86;
+
+/*
+  bf16 kernels are checked against float32 references computed with bf16 operands. products of bf16 are exact in
+  float32, so that results only differ in the order of accumulation, and in rounding if the output is bf16.
+*/
+class Bf16KernelTest : public testing::Test {
+protected:
+    static vector<float> RandomData(uint64_t size, float lo, float hi, uint32_t seed) {
+        mt19937 gen(seed);
+        uniform_real_distribution<float> dist(lo, hi);
+        vector<float> data(size);
+        for (uint64_t i = 0; i < size; ++i) {
+            data[i] = dist(gen);
+        }
+        return data;
+    }
+
+    static uint16_t ToBf16(float x) {
+        uint32_t u;
+        memcpy(&u, &x, sizeof(u));
+        u += 0x7fff + ((u >> 16) & 1);
+        return (uint16_t)(u >> 16);
+    }
+
+    static float ToFp32(uint16_t x) {
+        const uint32_t u = (uint32_t)x << 16;
+        float f;
+        memcpy(&f, &u, sizeof(f));
+        return f;
+    }
+
+    static vector<uint16_t> ToBf16(const vector<float>& src) {
+        vector<uint16_t> dst(src.size());
+        for (uint64_t i = 0; i < src.size(); ++i) {
+            dst[i] = ToBf16(src[i]);
+        }
+        return dst;
+    }
+
+    // reference, avx512 and avx512-bf16 implementations if they are supported by this cpu
+    static vector<isa_t> GetTestIsas() {
+        vector<isa_t> isas = {ISA_X86_SSE};
+        if (GetCpuISA() & ISA_X86_AVX512) {
+            isas.push_back(GetCpuISA());
+        }
+        return isas;
+    }
+
+    static float ApplyPost(float y, gemm_post_t post) {
+        if (post & (gemm_post::RELU | gemm_post::RELU6)) y = std::max(y, 0.0f);
+        if (post & gemm_post::RELU6) y = std::min(y, 6.0f);
+        return y;
+    }
+
+    // `abs_sum` is the sum of absolute values of products
+    static float GetBound(float expected, float abs_sum, datatype_t dst_type) {
+        float bound = abs_sum * 1e-5f + 1e-5f;
+        if (dst_type == DATATYPE_BFLOAT16) {
+            bound += fabsf(expected) / 256.0f;
+        }
+        return bound;
+    }
+
+    static float GetResult(const void* dst, uint64_t idx, datatype_t dst_type) {
+        if (dst_type == DATATYPE_BFLOAT16) {
+            return ToFp32(((const uint16_t*)dst)[idx]);
+        }
+        return ((const float*)dst)[idx];
+    }
+};
+
+TEST_F(Bf16KernelTest, cvt) {
+    const float nan = numeric_limits<float>::quiet_NaN();
+    // 1 + 2^-8 is a tie which rounds to even, 1 + 3 * 2^-8 rounds up
+    vector<float> src = {1.0f, -2.5f, 1.0f + 1.0f / 256.0f, 1.0f + 3.0f / 256.0f, 0.0f, nan, 65504.0f};
+    auto random_src = RandomData(133, -100.0f, 100.0f, 1);
+    src.insert(src.end(), random_src.begin(), random_src.end());
+
+    ppl::nn::TensorShape shape;
+    shape.Reshape({(int64_t)src.size()});
+    shape.SetDataType(DATATYPE_FLOAT32);
+    shape.SetDataFormat(DATAFORMAT_NDARRAY);
+
+    auto isas = GetTestIsas();
+    for (auto isa = isas.begin(); isa != isas.end(); ++isa) {
+        vector<uint16_t> bf16(src.size());
+        EXPECT_EQ(RC_SUCCESS, cvt_fp32_bf16(*isa, &shape, src.data(), bf16.data()));
+        EXPECT_EQ(0x3f80, bf16[0]);
+        EXPECT_EQ(0xc020, bf16[1]);
+        EXPECT_EQ(0x3f80, bf16[2]);
+        EXPECT_EQ(0x3f82, bf16[3]);
+        EXPECT_EQ(0x0000, bf16[4]);
+
+        vector<float> dst(src.size());
+        EXPECT_EQ(RC_SUCCESS, cvt_bf16_fp32(*isa, &shape, bf16.data(), dst.data()));
+        EXPECT_TRUE(std::isnan(dst[5]));
+        for (uint64_t i = 0; i < src.size(); ++i) {
+            if (i == 5) {
+                continue;
+            }
+            EXPECT_NEAR(src[i], dst[i], fabsf(src[i]) / 256.0f) << "index " << i;
+            EXPECT_EQ(ToBf16(src[i]), bf16[i]) << "index " << i;
+        }
+    }
+}
+
+TEST_F(Bf16KernelTest, gemm) {
+    const int64_t M = 37, N = 45, K = 67; // K is odd so that the last pair of k is padded
+    auto A = RandomData(M * K, -1.0f, 1.0f, 2);
+    auto B = RandomData(N * K, -1.0f, 1.0f, 3); // [N][K]
+    auto bias = RandomData(max(M, N), -1.0f, 1.0f, 4);
+    auto B_bf16 = ToBf16(B);
+
+    const gemm_bf16_layout_t layouts[] = {gemm_bf16_layout::ROW_A, gemm_bf16_layout::LANE_A};
+    const datatype_t dst_types[] = {DATATYPE_FLOAT32, DATATYPE_BFLOAT16};
+    auto isas = GetTestIsas();
+    for (auto isa = isas.begin(); isa != isas.end(); ++isa) {
+        for (auto layout : layouts) {
+            for (auto dst_type : dst_types) {
+                // C is [M][N] for ROW_A and [N][M] for LANE_A. bias is applied per m for both layouts.
+                vector<uint16_t> packed_a(gemm_bf16_get_packed_a_bytes(layout, M, K) / sizeof(uint16_t));
+                EXPECT_EQ(RC_SUCCESS, gemm_bf16_pack_a(layout, A.data(), M, K, K, packed_a.data()));
+
+                gemm_bf16_param param;
+                vector<uint16_t> packed_b(gemm_bf16_get_packed_b_bytes(layout, N, K) / sizeof(uint16_t));
+                EXPECT_EQ(RC_SUCCESS,
+                          gemm_bf16_pack_b_trans(layout, B_bf16.data(), N, K, K, packed_b.data(), &param.ldb));
+
+                const bool row_a = layout == gemm_bf16_layout::ROW_A;
+                vector<float> C(M * N * 2);
+                param.layout = layout;
+                param.packed_a = packed_a.data();
+                param.packed_b = packed_b.data();
+                param.bias = bias.data();
+                param.M = M;
+                param.N = N;
+                param.K = K;
+                param.ldc = row_a ? N : M;
+                param.post = gemm_post::RELU6;
+                param.c_type = dst_type;
+                param.C = C.data();
+                EXPECT_EQ(RC_SUCCESS, gemm_bf16(*isa, param));
+
+                for (int64_t m = 0; m < M; ++m) {
+                    for (int64_t n = 0; n < N; ++n) {
+                        float sum = 0.0f, abs_sum = 0.0f;
+                        for (int64_t k = 0; k < K; ++k) {
+                            const float p = ToFp32(ToBf16(A[m * K + k])) * ToFp32(B_bf16[n * K + k]);
+                            sum += p;
+                            abs_sum += fabsf(p);
+                        }
+                        const float expected = ApplyPost(sum + bias[m], gemm_post::RELU6);
+                        const uint64_t idx = row_a ? m * N + n : n * M + m;
+                        ASSERT_NEAR(expected, GetResult(C.data(), idx, dst_type),
+                                    GetBound(expected, abs_sum, dst_type))
+                            << "layout " << layout << " m " << m << " n " << n;
+                    }
+                }
+            }
+        }
+    }
+}
+
+struct Bf16ConvCase {
+    int64_t batch, channels, num_output, group;
+    int64_t src_h, src_w, kernel_h, kernel_w;
+    int64_t stride, pad, dilation;
+    gemm_post_t post;
+};
+
+static conv2d_bf16_param ToParam(const Bf16ConvCase& c) {
+    conv2d_bf16_param param;
+    param.kernel_h = c.kernel_h;
+    param.kernel_w = c.kernel_w;
+    param.stride_h = param.stride_w = c.stride;
+    param.pad_h = param.pad_w = c.pad;
+    param.dilation_h = param.dilation_w = c.dilation;
+    param.group = c.group;
+    param.channels = c.channels;
+    param.num_output = c.num_output;
+    param.post = c.post;
+    return param;
+}
+
+/*
+  reference conv2d in ndarray, whose `src` and `weight` are rounded to bf16 already. `abs_sum` gets the sums of
+  absolute values of products.
+*/
+static void RefConv2d(const Bf16ConvCase& c, int64_t dst_h, int64_t dst_w, const vector<float>& src,
+                      const vector<float>& weight, const vector<float>& bias, vector<float>* dst,
+                      vector<float>* abs_sum) {
+    const int64_t ic_per_gp = c.channels / c.group, oc_per_gp = c.num_output / c.group;
+    dst->resize(c.batch * c.num_output * dst_h * dst_w);
+    abs_sum->resize(dst->size());
+    for (int64_t b = 0; b < c.batch; ++b) {
+        for (int64_t oc = 0; oc < c.num_output; ++oc) {
+            const int64_t g = oc / oc_per_gp;
+            for (int64_t oh = 0; oh < dst_h; ++oh) {
+                for (int64_t ow = 0; ow < dst_w; ++ow) {
+                    float sum = 0.0f, a_sum = 0.0f;
+                    for (int64_t ic = 0; ic < ic_per_gp; ++ic) {
+                        for (int64_t kh = 0; kh < c.kernel_h; ++kh) {
+                            for (int64_t kw = 0; kw < c.kernel_w; ++kw) {
+                                const int64_t ih = oh * c.stride - c.pad + kh * c.dilation;
+                                const int64_t iw = ow * c.stride - c.pad + kw * c.dilation;
+                                if (ih < 0 || ih >= c.src_h || iw < 0 || iw >= c.src_w) {
+                                    continue;
+                                }
+                                const float w = weight[((oc * ic_per_gp + ic) * c.kernel_h + kh) * c.kernel_w + kw];
+                                const float x =
+                                    src[((b * c.channels + g * ic_per_gp + ic) * c.src_h + ih) * c.src_w + iw];
+                                const float p = x * w;
+                                sum += p;
+                                a_sum += fabsf(p);
+                            }
+                        }
+                    }
+                    const int64_t idx = ((b * c.num_output + oc) * dst_h + oh) * dst_w + ow;
+                    (*dst)[idx] = sum + bias[oc];
+                    (*abs_sum)[idx] = a_sum;
+                }
+            }
+        }
+    }
+}
+
+TEST_F(Bf16KernelTest, conv2d_ndarray) {
+    const Bf16ConvCase c = {2, 12, 20, 2, 9, 11, 3, 3, 2, 1, 1, gemm_post::RELU};
+    const int64_t dst_h = (c.src_h + 2 * c.pad - c.dilation * (c.kernel_h - 1) - 1) / c.stride + 1;
+    const int64_t dst_w = (c.src_w + 2 * c.pad - c.dilation * (c.kernel_w - 1) - 1) / c.stride + 1;
+
+    auto src = ToBf16(RandomData(c.batch * c.channels * c.src_h * c.src_w, -1.0f, 1.0f, 5));
+    auto weight = RandomData(c.num_output * c.channels / c.group * c.kernel_h * c.kernel_w, -1.0f, 1.0f, 6);
+    auto bias = RandomData(c.num_output, -1.0f, 1.0f, 7);
+
+    vector<float> src_r(src.size()), weight_r(weight.size());
+    for (uint64_t i = 0; i < src.size(); ++i) {
+        src_r[i] = ToFp32(src[i]);
+    }
+    for (uint64_t i = 0; i < weight.size(); ++i) {
+        weight_r[i] = ToFp32(ToBf16(weight[i]));
+    }
+    vector<float> expected, abs_sum;
+    RefConv2d(c, dst_h, dst_w, src_r, weight_r, bias, &expected, &abs_sum);
+
+    const auto param = ToParam(c);
+    vector<uint16_t> packed_weight(conv2d_bf16_get_packed_weight_bytes(param) / sizeof(uint16_t));
+    EXPECT_EQ(RC_SUCCESS, conv2d_bf16_pack_weight(param, weight.data(), packed_weight.data()));
+
+    ppl::nn::TensorShape src_shape, dst_shape;
+    src_shape.Reshape({c.batch, c.channels, c.src_h, c.src_w});
+    src_shape.SetDataType(DATATYPE_BFLOAT16);
+    src_shape.SetDataFormat(DATAFORMAT_NDARRAY);
+    dst_shape.Reshape({c.batch, c.num_output, dst_h, dst_w});
+    dst_shape.SetDataFormat(DATAFORMAT_NDARRAY);
+
+    const datatype_t dst_types[] = {DATATYPE_FLOAT32, DATATYPE_BFLOAT16};
+    auto isas = GetTestIsas();
+    for (auto isa = isas.begin(); isa != isas.end(); ++isa) {
+        for (auto dst_type : dst_types) {
+            dst_shape.SetDataType(dst_type);
+            vector<uint8_t> temp_buffer(conv2d_bf16_get_temp_buffer_bytes(param, &dst_shape));
+            vector<float> dst(expected.size());
+            EXPECT_EQ(RC_SUCCESS,
+                      conv2d_bf16(*isa, param, &src_shape, src.data(), packed_weight.data(), bias.data(),
+                                  &dst_shape, temp_buffer.data(), dst.data()));
+            for (uint64_t i = 0; i < expected.size(); ++i) {
+                const float y = ApplyPost(expected[i], c.post);
+                ASSERT_NEAR(y, GetResult(dst.data(), i, dst_type), GetBound(y, abs_sum[i], dst_type))
+                    << "index " << i;
+            }
+        }
+    }
+}
+
+/*
+  n16cx cases cover odd channels(the last ic pair is padded), oc blocks which are not multiple of the microkernel,
+  left and right borders of rows, strides, dilations and 1x1 kernels.
+*/
+TEST_F(Bf16KernelTest, conv2d_n16cx) {
+    const Bf16ConvCase cases[] = {
+        {2, 19, 40, 1, 9, 30, 3, 3, 1, 1, 1, gemm_post::RELU},
+        {1, 32, 16, 1, 17, 15, 3, 3, 2, 1, 1, gemm_post::NONE},
+        {1, 7, 33, 1, 12, 13, 3, 3, 1, 2, 2, gemm_post::RELU6},
+        {3, 48, 64, 1, 7, 26, 1, 1, 1, 0, 1, gemm_post::NONE},
+        {1, 5, 3, 1, 5, 4, 5, 5, 1, 1, 1, gemm_post::RELU},
+    };
+    const int64_t ch_blk = 16;
+    const datatype_t dst_types[] = {DATATYPE_FLOAT32, DATATYPE_BFLOAT16};
+    auto isas = GetTestIsas();
+
+    uint32_t seed = 8;
+    for (auto c = begin(cases); c != end(cases); ++c) {
+        const int64_t dst_h = (c->src_h + 2 * c->pad - c->dilation * (c->kernel_h - 1) - 1) / c->stride + 1;
+        const int64_t dst_w = (c->src_w + 2 * c->pad - c->dilation * (c->kernel_w - 1) - 1) / c->stride + 1;
+        const int64_t ic_pad = (c->channels + ch_blk - 1) / ch_blk * ch_blk;
+        const int64_t oc_pad = (c->num_output + ch_blk - 1) / ch_blk * ch_blk;
+
+        auto src = ToBf16(RandomData(c->batch * c->channels * c->src_h * c->src_w, -1.0f, 1.0f, seed++));
+        auto weight = RandomData(c->num_output * c->channels * c->kernel_h * c->kernel_w, -1.0f, 1.0f, seed++);
+        auto bias = RandomData(c->num_output, -1.0f, 1.0f, seed++);
+
+        vector<float> src_r(src.size()), weight_r(weight.size());
+        for (uint64_t i = 0; i < src.size(); ++i) {
+            src_r[i] = ToFp32(src[i]);
+        }
+        for (uint64_t i = 0; i < weight.size(); ++i) {
+            weight_r[i] = ToFp32(ToBf16(weight[i]));
+        }
+        vector<float> expected, abs_sum;
+        RefConv2d(*c, dst_h, dst_w, src_r, weight_r, bias, &expected, &abs_sum);
+
+        // padded channels are nan, which should not be read
+        const uint16_t bf16_nan = 0x7fc0;
+        vector<uint16_t> src_n16cx(c->batch * ic_pad * c->src_h * c->src_w, bf16_nan);
+        for (int64_t b = 0; b < c->batch; ++b) {
+            for (int64_t ic = 0; ic < c->channels; ++ic) {
+                for (int64_t hw = 0; hw < c->src_h * c->src_w; ++hw) {
+                    src_n16cx[(b * ic_pad + ic / ch_blk * ch_blk) * c->src_h * c->src_w + hw * ch_blk + ic % ch_blk] =
+                        src[(b * c->channels + ic) * c->src_h * c->src_w + hw];
+                }
+            }
+        }
+
+        const auto param = ToParam(*c);
+        ASSERT_TRUE(conv2d_n16cx_bf16_is_supported(param));
+        vector<uint16_t> packed_weight(conv2d_n16cx_bf16_get_packed_weight_bytes(param) / sizeof(uint16_t));
+        EXPECT_EQ(RC_SUCCESS, conv2d_n16cx_bf16_pack_weight(param, weight.data(), packed_weight.data()));
+
+        ppl::nn::TensorShape src_shape, dst_shape;
+        src_shape.Reshape({c->batch, c->channels, c->src_h, c->src_w});
+        src_shape.SetDataType(DATATYPE_BFLOAT16);
+        src_shape.SetDataFormat(DATAFORMAT_N16CX);
+        dst_shape.Reshape({c->batch, c->num_output, dst_h, dst_w});
+        dst_shape.SetDataFormat(DATAFORMAT_N16CX);
+
+        for (auto isa = isas.begin(); isa != isas.end(); ++isa) {
+            for (auto dst_type : dst_types) {
+                dst_shape.SetDataType(dst_type);
+                vector<float> dst(c->batch * oc_pad * dst_h * dst_w, -1.0f);
+                EXPECT_EQ(RC_SUCCESS,
+                          conv2d_n16cx_bf16(*isa, param, &src_shape, src_n16cx.data(), packed_weight.data(),
+                                            bias.data(), &dst_shape, dst.data()));
+                for (int64_t b = 0; b < c->batch; ++b) {
+                    for (int64_t oc = 0; oc < oc_pad; ++oc) {
+                        for (int64_t hw = 0; hw < dst_h * dst_w; ++hw) {
+                            const uint64_t idx =
+                                (b * oc_pad + oc / ch_blk * ch_blk) * dst_h * dst_w + hw * ch_blk + oc % ch_blk;
+                            const float result = GetResult(dst.data(), idx, dst_type);
+                            if (oc >= c->num_output) {
+                                ASSERT_EQ(0.0f, result) << "padded oc " << oc;
+                                continue;
+                            }
+                            const uint64_t ref_idx = (b * c->num_output + oc) * dst_h * dst_w + hw;
+                            const float y = ApplyPost(expected[ref_idx], c->post);
+                            ASSERT_NEAR(y, result, GetBound(y, abs_sum[ref_idx], dst_type))
+                                << "case " << (c - begin(cases)) << " isa " << *isa << " oc " << oc << " hw " << hw;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
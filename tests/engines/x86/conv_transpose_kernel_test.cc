@@ -0,0 +1,206 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/kernel/x86/fp32/conv_transpose.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+using namespace std;
+using namespace ppl::common;
+using namespace ppl::kernel::x86;
+
+/*
+  conv_transpose_n16cx_fp32 is checked against conv_transpose_ndarray_fp32, which is a gemm followed by col2im, of
+  the same isa. activations are applied to outputs of the ndarray kernel on host.
+*/
+class ConvTransposeKernelTest : public testing::Test {
+protected:
+    static vector<float> RandomData(uint64_t size, float lo, float hi, uint32_t seed) {
+        mt19937 gen(seed);
+        uniform_real_distribution<float> dist(lo, hi);
+        vector<float> data(size);
+        for (uint64_t i = 0; i < size; ++i) {
+            data[i] = dist(gen);
+        }
+        return data;
+    }
+
+    // fma and avx512 implementations if they are supported by this cpu
+    static vector<isa_t> GetTestIsas() {
+        vector<isa_t> isas;
+        const isa_t cpu_isa = GetCpuISA();
+        const isa_t fma_isa = ISA_X86_AVX | ISA_X86_FMA;
+        if ((cpu_isa & fma_isa) == fma_isa) {
+            isas.push_back(cpu_isa & (~ISA_X86_AVX512));
+        }
+#ifdef PPL_USE_X86_AVX512
+        if (cpu_isa & ISA_X86_AVX512) {
+            isas.push_back(cpu_isa);
+        }
+#endif
+        return isas;
+    }
+
+    // [batch, channels, height, width] to [batch, channels / 16, height, width, 16], padded channels are filled
+    static vector<float> ToN16cx(const vector<float>& src, int64_t batch, int64_t channels, int64_t hw, float pad) {
+        const int64_t padded_c = (channels + 15) / 16 * 16;
+        vector<float> dst(batch * padded_c * hw, pad);
+        for (int64_t b = 0; b < batch; ++b) {
+            for (int64_t c = 0; c < channels; ++c) {
+                for (int64_t i = 0; i < hw; ++i) {
+                    dst[((b * padded_c + c / 16 * 16) * hw + i * 16) + c % 16] = src[(b * channels + c) * hw + i];
+                }
+            }
+        }
+        return dst;
+    }
+};
+
+struct ConvTransposeCase {
+    int64_t channels;
+    int64_t num_output;
+    int64_t src_h;
+    int64_t src_w;
+    int64_t kernel_h;
+    int64_t kernel_w;
+    int64_t stride_h;
+    int64_t stride_w;
+    int64_t pad_h;
+    int64_t pad_w;
+};
+
+static RetCode ConvTransposeNdarray(isa_t isa, const ConvTransposeCase& c, int64_t batch, int64_t dst_h,
+                                   int64_t dst_w, const float* src, const float* weight, const float* bias,
+                                   float* dst) {
+#ifdef PPL_USE_X86_AVX512
+    if (isa & ISA_X86_AVX512) {
+        vector<uint8_t> temp_buffer(conv_transpose_ndarray_fp32_avx512_get_buffer_bytes(
+            batch, c.src_h, c.src_w, c.num_output, c.channels, c.kernel_h, c.kernel_w, c.stride_h, c.stride_w,
+            c.pad_h, c.pad_w));
+        return conv_transpose_ndarray_fp32_avx512(src, weight, bias, c.src_h, c.src_w, dst_h, dst_w, batch,
+                                                  c.channels, c.num_output, c.kernel_h, c.kernel_w, c.stride_h,
+                                                  c.stride_w, c.pad_h, c.pad_w, 1, 1, (float*)temp_buffer.data(),
+                                                  dst);
+    }
+#endif
+    vector<uint8_t> temp_buffer(conv_transpose_ndarray_fp32_fma_get_buffer_bytes(
+        batch, c.src_h, c.src_w, c.num_output, c.channels, c.kernel_h, c.kernel_w, c.stride_h, c.stride_w, c.pad_h,
+        c.pad_w));
+    return conv_transpose_ndarray_fp32_fma(src, weight, bias, c.src_h, c.src_w, dst_h, dst_w, batch, c.channels,
+                                           c.num_output, c.kernel_h, c.kernel_w, c.stride_h, c.stride_w, c.pad_h,
+                                           c.pad_w, 1, 1, (float*)temp_buffer.data(), dst);
+}
+
+static RetCode ConvTransposeN16cx(isa_t isa, const conv_transpose_n16cx_fp32_param& param,
+                                  const ppl::nn::TensorShape* src_shape, const float* src, const float* packed_weight,
+                                  const ppl::nn::TensorShape* dst_shape, void* temp_buffer, float* dst) {
+#ifdef PPL_USE_X86_AVX512
+    if (isa & ISA_X86_AVX512) {
+        return conv_transpose_n16cx_fp32_avx512(param, src_shape, src, packed_weight, dst_shape, temp_buffer, dst);
+    }
+#endif
+    return conv_transpose_n16cx_fp32_fma(param, src_shape, src, packed_weight, dst_shape, temp_buffer, dst);
+}
+
+TEST_F(ConvTransposeKernelTest, n16cx_vs_ndarray) {
+    /*
+      channels are not multiples of 16 except one case. kernel < stride leaves phases without taps, whose outputs
+      are bias only. stride 1 writes rows of dst directly and the others gather phase rows in the temp buffer.
+    */
+    const vector<ConvTransposeCase> cases = {
+        {5, 7, 6, 9, 3, 3, 2, 2, 1, 1},    {16, 16, 5, 5, 4, 4, 2, 2, 1, 1}, {21, 35, 7, 4, 3, 5, 1, 1, 1, 2},
+        {3, 18, 4, 7, 1, 1, 2, 3, 0, 0},   {33, 9, 3, 11, 5, 3, 3, 2, 2, 0}, {8, 40, 1, 1, 2, 2, 2, 2, 0, 0},
+        {17, 31, 13, 5, 2, 3, 2, 1, 0, 1},
+    };
+    const conv_fuse_flag_t fuse_flags[] = {conv_fuse_flag::NONE, conv_fuse_flag::RELU, conv_fuse_flag::RELU6};
+    const int64_t batch = 2;
+
+    uint32_t seed = 1;
+    auto isas = GetTestIsas();
+    for (auto c = cases.begin(); c != cases.end(); ++c) {
+        const int64_t dst_h = (c->src_h - 1) * c->stride_h - 2 * c->pad_h + c->kernel_h;
+        const int64_t dst_w = (c->src_w - 1) * c->stride_w - 2 * c->pad_w + c->kernel_w;
+        const int64_t padded_oc = (c->num_output + 15) / 16 * 16;
+        // values are scaled up so that relu6 clips some of them
+        auto src = RandomData(batch * c->channels * c->src_h * c->src_w, -2.0f, 2.0f, seed++);
+        auto weight = RandomData(c->channels * c->num_output * c->kernel_h * c->kernel_w, -1.0f, 1.0f, seed++);
+        auto bias = RandomData(c->num_output, -1.0f, 1.0f, seed++);
+        // garbage in padded channels of src must not leak into dst
+        auto src_n16cx = ToN16cx(src, batch, c->channels, c->src_h * c->src_w, NAN);
+
+        ppl::nn::TensorShape src_shape, dst_shape;
+        src_shape.Reshape({batch, c->channels, c->src_h, c->src_w});
+        src_shape.SetDataType(DATATYPE_FLOAT32);
+        src_shape.SetDataFormat(DATAFORMAT_N16CX);
+        dst_shape.Reshape({batch, c->num_output, dst_h, dst_w});
+        dst_shape.SetDataType(DATATYPE_FLOAT32);
+        dst_shape.SetDataFormat(DATAFORMAT_N16CX);
+
+        for (auto isa = isas.begin(); isa != isas.end(); ++isa) {
+            vector<float> ndarray_dst(batch * c->num_output * dst_h * dst_w);
+            ASSERT_EQ(RC_SUCCESS,
+                      ConvTransposeNdarray(*isa, *c, batch, dst_h, dst_w, src.data(), weight.data(), bias.data(),
+                                           ndarray_dst.data()));
+
+            for (uint32_t f = 0; f < sizeof(fuse_flags) / sizeof(fuse_flags[0]); ++f) {
+                conv_transpose_n16cx_fp32_param param;
+                param.kernel_h = c->kernel_h;
+                param.kernel_w = c->kernel_w;
+                param.stride_h = c->stride_h;
+                param.stride_w = c->stride_w;
+                param.pad_h = c->pad_h;
+                param.pad_w = c->pad_w;
+                param.channels = c->channels;
+                param.num_output = c->num_output;
+                param.fuse_flag = fuse_flags[f];
+                ASSERT_TRUE(conv_transpose_n16cx_fp32_is_supported(*isa, param));
+
+                vector<float> packed_weight(conv_transpose_n16cx_fp32_get_packed_weight_bytes(param) / sizeof(float));
+                ASSERT_EQ(RC_SUCCESS,
+                          conv_transpose_n16cx_fp32_pack_weight(param, weight.data(), bias.data(),
+                                                                packed_weight.data()));
+                vector<uint8_t> temp_buffer(conv_transpose_n16cx_fp32_get_buffer_bytes(param, &dst_shape));
+                vector<float> dst(batch * padded_oc * dst_h * dst_w, NAN);
+                ASSERT_EQ(RC_SUCCESS,
+                          ConvTransposeN16cx(*isa, param, &src_shape, src_n16cx.data(), packed_weight.data(),
+                                             &dst_shape, temp_buffer.data(), dst.data()));
+
+                vector<float> expected(ndarray_dst);
+                for (auto x = expected.begin(); x != expected.end(); ++x) {
+                    if (fuse_flags[f] & (conv_fuse_flag::RELU | conv_fuse_flag::RELU6)) {
+                        *x = std::max(*x, 0.0f);
+                    }
+                    if (fuse_flags[f] & conv_fuse_flag::RELU6) {
+                        *x = std::min(*x, 6.0f);
+                    }
+                }
+                // padded channels of dst are zeros
+                auto expected_n16cx = ToN16cx(expected, batch, c->num_output, dst_h * dst_w, 0.0f);
+
+                const string name = "isa " + to_string(*isa) + " case " + to_string(c - cases.begin()) +
+                    " fuse_flag " + to_string(fuse_flags[f]);
+                for (uint64_t i = 0; i < dst.size(); ++i) {
+                    ASSERT_NEAR(expected_n16cx[i], dst[i], 1e-4f * std::max(1.0f, fabsf(expected_n16cx[i])))
+                        << name << " index " << i;
+                }
+            }
+        }
+    }
+}
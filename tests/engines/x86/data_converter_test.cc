@@ -0,0 +1,184 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/nn/engines/x86/data_converter.h"
+#include "ppl/nn/utils/generic_cpu_data_converter.h"
+#include "gtest/gtest.h"
+#include <cmath>
+#include <string>
+#include <vector>
+using namespace std;
+using namespace ppl::nn;
+using namespace ppl::common;
+
+#if defined(PPLNN_USE_X86) && defined(PPLNN_ENABLE_ONNX_MODEL)
+#include "ppl/nn/engines/x86/engine_factory.h"
+#include "ppl/nn/engines/x86/ops.h"
+#include "ppl/nn/runtime/runtime.h"
+#include "tests/models/onnx/onnx_model_builder.h"
+#include <memory>
+using namespace ppl::nn::test;
+#endif
+
+/*
+  fused uint8 image converters of x86 are checked against the generic converter, which normalizes images into
+  ndarray. channels which are not multiples of 16 leave padded channels in n16cx.
+*/
+class X86DataConverterTest : public testing::Test {
+protected:
+    static vector<uint8_t> CreateImage(int64_t size) {
+        vector<uint8_t> img(size);
+        for (int64_t i = 0; i < size; ++i) {
+            img[i] = (i * 37 + 11) % 256;
+        }
+        return img;
+    }
+
+    static vector<isa_t> GetTestIsas() {
+        vector<isa_t> isas = {ISA_X86_SSE};
+        if (GetCpuISA() & ISA_X86_AVX) {
+            isas.push_back(GetCpuISA());
+        }
+        return isas;
+    }
+};
+
+TEST_F(X86DataConverterTest, convert_from_host_image) {
+    const int64_t n = 2, h = 3, w = 5;
+    const int64_t channels_list[] = {3, 16, 21, 35};
+
+    for (auto c = begin(channels_list); c != end(channels_list); ++c) {
+        auto img = CreateImage(n * h * w * (*c));
+        vector<float> mean(*c), scale(*c);
+        for (int64_t i = 0; i < *c; ++i) {
+            mean[i] = 100.0f + i * 3.7f;
+            scale[i] = 1.0f / (50.0f + i);
+        }
+
+        TensorShape ref_shape;
+        ref_shape.SetDataType(DATATYPE_FLOAT32);
+        ref_shape.SetDataFormat(DATAFORMAT_NDARRAY);
+        ref_shape.Reshape({n, *c, h, w});
+        vector<float> ref(ref_shape.GetElementsIncludingPadding()), ref_default(ref.size());
+        utils::GenericCpuDataConverter generic_converter;
+        BufferDesc ref_buf(ref.data()), ref_default_buf(ref_default.data());
+        ASSERT_EQ(RC_SUCCESS,
+                  generic_converter.ConvertFromHostImage(&ref_buf, ref_shape, img.data(), mean.data(), scale.data()));
+        ASSERT_EQ(RC_SUCCESS,
+                  generic_converter.ConvertFromHostImage(&ref_default_buf, ref_shape, img.data(), nullptr, nullptr));
+
+        const dataformat_t formats[] = {DATAFORMAT_NDARRAY, DATAFORMAT_N16CX};
+        auto isas = GetTestIsas();
+        for (auto isa = isas.begin(); isa != isas.end(); ++isa) {
+            x86::X86DataConverter converter(*isa);
+            for (auto format = begin(formats); format != end(formats); ++format) {
+                TensorShape shape(ref_shape);
+                shape.SetDataFormat(*format);
+                const int64_t padded_c = (*format == DATAFORMAT_N16CX) ? (*c + 15) / 16 * 16 : *c;
+
+                for (int use_default = 0; use_default < 2; ++use_default) {
+                    vector<float> dst(n * padded_c * h * w, NAN);
+                    BufferDesc buf(dst.data());
+                    ASSERT_EQ(RC_SUCCESS,
+                              converter.ConvertFromHostImage(&buf, shape, img.data(),
+                                                             use_default ? nullptr : mean.data(),
+                                                             use_default ? nullptr : scale.data()));
+
+                    const vector<float>& expected = use_default ? ref_default : ref;
+                    const string name = "isa " + to_string(*isa) + " channels " + to_string(*c) + " format " +
+                        GetDataFormatStr(*format) + " default " + to_string(use_default);
+                    for (int64_t b = 0; b < n; ++b) {
+                        for (int64_t ch = 0; ch < padded_c; ++ch) {
+                            for (int64_t x = 0; x < h * w; ++x) {
+                                const float value = (*format == DATAFORMAT_N16CX)
+                                    ? dst[(b * padded_c + ch / 16 * 16) * h * w + x * 16 + ch % 16]
+                                    : dst[(b * padded_c + ch) * h * w + x];
+                                if (ch < *c) {
+                                    ASSERT_FLOAT_EQ(expected[(b * (*c) + ch) * h * w + x], value)
+                                        << name << " at " << b << ", " << ch << ", " << x;
+                                } else {
+                                    ASSERT_EQ(0.0f, value) << name << " padded channel " << ch;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+#if defined(PPLNN_USE_X86) && defined(PPLNN_ENABLE_ONNX_MODEL)
+
+/*
+  y = Conv(x, w, b), whose input is reordered to n16cx since x has too many channels for convs taking ndarray. filling x in n16cx lets the Reorder kernel pass it through,
+  which must give the same result as filling it in ndarray.
+*/
+TEST_F(X86DataConverterTest, reorder_passes_through_preferred_format) {
+    x86::RegisterBuiltinOpImpls();
+    unique_ptr<Engine> engine(x86::EngineFactory::Create(x86::EngineOptions()));
+
+    const int64_t n = 1, c = 35, h = 6, w = 7, oc = 4;
+    vector<float> weight(oc * c * 3 * 3), bias(oc);
+    for (uint64_t i = 0; i < weight.size(); ++i) {
+        weight[i] = ((int64_t)(i * 7 % 13) - 6) * 0.05f;
+    }
+    for (uint64_t i = 0; i < bias.size(); ++i) {
+        bias[i] = i * 0.1f;
+    }
+
+    OnnxModelBuilder builder;
+    auto graph = builder.GetGraph();
+    OnnxModelBuilder::AddInput(graph, "x", {n, c, h, w});
+    OnnxModelBuilder::AddInitializer(graph, "w", {oc, c, 3, 3}, weight);
+    OnnxModelBuilder::AddInitializer(graph, "b", {oc}, bias);
+    auto conv = OnnxModelBuilder::AddNode(graph, "Conv", {"x", "w", "b"}, {"y"});
+    OnnxModelBuilder::SetAttr(conv, "kernel_shape", vector<int64_t>{3, 3});
+    OnnxModelBuilder::SetAttr(conv, "pads", vector<int64_t>{1, 1, 1, 1});
+    OnnxModelBuilder::AddOutput(graph, "y");
+
+    auto engine_ptr = engine.get();
+    unique_ptr<Runtime> runtime(builder.CreateRuntime(&engine_ptr, 1));
+    ASSERT_TRUE(runtime != nullptr);
+    ASSERT_EQ(DATAFORMAT_N16CX, runtime->GetInputPreferredDataFormat(0));
+
+    auto img = CreateImage(n * h * w * c);
+    vector<float> mean(c), scale(c);
+    for (int64_t i = 0; i < c; ++i) {
+        mean[i] = 120.0f - i;
+        scale[i] = 0.017f + i * 0.001f;
+    }
+
+    vector<vector<float>> results;
+    const dataformat_t formats[] = {DATAFORMAT_NDARRAY, DATAFORMAT_N16CX};
+    for (auto format = begin(formats); format != end(formats); ++format) {
+        auto x = runtime->GetInputTensor(0);
+        auto shape = x->GetShape();
+        shape->Reshape({n, c, h, w});
+        shape->SetDataType(DATATYPE_FLOAT32);
+        shape->SetDataFormat(*format);
+        ASSERT_EQ(RC_SUCCESS, x->ReallocBuffer());
+        ASSERT_EQ(RC_SUCCESS, x->ConvertFromHostImage(img.data(), mean.data(), scale.data()));
+        ASSERT_EQ(RC_SUCCESS, runtime->Run());
+        results.push_back(GetTensorData(runtime->GetOutputTensor(0)));
+    }
+
+    ASSERT_EQ((uint64_t)(n * oc * h * w), results[0].size());
+    EXPECT_EQ(results[0], results[1]);
+}
+
+#endif
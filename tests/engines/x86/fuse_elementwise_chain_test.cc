@@ -0,0 +1,307 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#if defined(PPLNN_USE_X86) && defined(PPLNN_ENABLE_ONNX_MODEL)
+
+#include "ppl/nn/engines/x86/engine_factory.h"
+#include "ppl/nn/engines/x86/ops.h"
+#include "ppl/nn/models/onnx/runtime_builder_factory.h"
+#include "ppl/nn/models/onnx/runtime_builder_options.h"
+#include "ppl/nn/runtime/runtime.h"
+#include "tests/models/onnx/onnx_model_builder.h"
+#include "gtest/gtest.h"
+#include <cmath>
+#include <memory>
+#include <random>
+using namespace std;
+using namespace ppl::nn;
+using namespace ppl::common;
+using namespace ppl::nn::test;
+
+/*
+  elementwise nodes are fused into a FusedElementwise node by FuseElementwiseChain. intermediate edges of a group
+  are removed from the graph, so that they cannot be reserved after the graph is optimized. outputs are checked
+  against the unfused expressions evaluated on host.
+*/
+class X86FuseElementwiseChainTest : public testing::Test {
+protected:
+    static void SetUpTestCase() {
+        x86::RegisterBuiltinOpImpls();
+    }
+
+    void SetUp() override {
+        engine_.reset(x86::EngineFactory::Create(x86::EngineOptions()));
+    }
+
+    ppl::nn::onnx::RuntimeBuilder* CreateBuilder(const OnnxModelBuilder& model, const vector<string>& reserved) {
+        unique_ptr<ppl::nn::onnx::RuntimeBuilder> builder(ppl::nn::onnx::RuntimeBuilderFactory::Create());
+        if (!builder) {
+            return nullptr;
+        }
+        auto buf = model.Serialize();
+        auto engine = engine_.get();
+        if (builder->Init(buf.data(), buf.size(), &engine, 1) != RC_SUCCESS) {
+            return nullptr;
+        }
+        for (auto x = reserved.begin(); x != reserved.end(); ++x) {
+            if (builder->Configure(ppl::nn::onnx::ORB_CONF_RESERVE_TENSOR, x->c_str()) != RC_SUCCESS) {
+                return nullptr;
+            }
+        }
+        if (builder->Preprocess() != RC_SUCCESS) {
+            return nullptr;
+        }
+        return builder.release();
+    }
+
+    /*
+      `reserved` are reserved before optimization. edges of `edges` which are still in the optimized graph are
+      returned in `remaining`. edges cannot be reserved after optimization, so that they are looked up with
+      another builder.
+    */
+    Runtime* CreateRuntime(const OnnxModelBuilder& model, const vector<string>& reserved, const vector<string>& edges,
+                           vector<string>* remaining) {
+        unique_ptr<ppl::nn::onnx::RuntimeBuilder> probe(CreateBuilder(model, reserved));
+        if (!probe) {
+            return nullptr;
+        }
+        for (auto x = edges.begin(); x != edges.end(); ++x) {
+            if (probe->Configure(ppl::nn::onnx::ORB_CONF_RESERVE_TENSOR, x->c_str()) == RC_SUCCESS) {
+                remaining->push_back(*x);
+            }
+        }
+
+        unique_ptr<ppl::nn::onnx::RuntimeBuilder> builder(CreateBuilder(model, reserved));
+        return builder ? builder->CreateRuntime() : nullptr;
+    }
+
+    static vector<float> RandomData(uint64_t size, float lo, float hi, uint32_t seed) {
+        mt19937 gen(seed);
+        uniform_real_distribution<float> dist(lo, hi);
+        vector<float> data(size);
+        for (uint64_t i = 0; i < size; ++i) {
+            data[i] = dist(gen);
+        }
+        return data;
+    }
+
+    static void Check(const vector<float>& expected, const vector<float>& result) {
+        ASSERT_EQ(expected.size(), result.size());
+        for (uint64_t i = 0; i < expected.size(); ++i) {
+            ASSERT_NEAR(expected[i], result[i], 1e-5f * std::max(1.0f, fabsf(expected[i]))) << "index " << i;
+        }
+    }
+
+protected:
+    unique_ptr<Engine> engine_;
+};
+
+static const vector<int64_t> g_dims = {2, 3, 7, 9};
+static const int64_t g_size = 2 * 3 * 7 * 9;
+
+static float Sigmoid(float x) {
+    return 1.0f / (1.0f + expf(-x));
+}
+
+// y = Relu(Sigmoid((x0 + x1) * s) - x0), where s is a scalar constant
+static void BuildChain(OnnxModelBuilder* builder) {
+    auto graph = builder->GetGraph();
+    OnnxModelBuilder::AddInput(graph, "x0", g_dims);
+    OnnxModelBuilder::AddInput(graph, "x1", g_dims);
+    OnnxModelBuilder::AddInitializer(graph, "s", {1}, vector<float>{0.5f});
+    OnnxModelBuilder::AddNode(graph, "Add", {"x0", "x1"}, {"a"});
+    OnnxModelBuilder::AddNode(graph, "Mul", {"a", "s"}, {"b"});
+    OnnxModelBuilder::AddNode(graph, "Sigmoid", {"b"}, {"c"});
+    OnnxModelBuilder::AddNode(graph, "Sub", {"c", "x0"}, {"d"});
+    OnnxModelBuilder::AddNode(graph, "Relu", {"d"}, {"y"});
+    OnnxModelBuilder::AddOutput(graph, "y");
+}
+
+static vector<float> CalcChain(const vector<float>& x0, const vector<float>& x1) {
+    vector<float> y(x0.size());
+    for (uint64_t i = 0; i < x0.size(); ++i) {
+        y[i] = std::max(Sigmoid((x0[i] + x1[i]) * 0.5f) - x0[i], 0.0f);
+    }
+    return y;
+}
+
+TEST_F(X86FuseElementwiseChainTest, chain) {
+    OnnxModelBuilder builder;
+    BuildChain(&builder);
+
+    vector<string> remaining;
+    unique_ptr<Runtime> runtime(CreateRuntime(builder, {}, {"a", "b", "c", "d"}, &remaining));
+    ASSERT_TRUE(runtime != nullptr);
+    EXPECT_EQ(vector<string>(), remaining);
+
+    auto x0 = RandomData(g_size, -2.0f, 2.0f, 1);
+    auto x1 = RandomData(g_size, -2.0f, 2.0f, 2);
+    SetTensorData(runtime->GetInputTensor(0), g_dims, x0);
+    SetTensorData(runtime->GetInputTensor(1), g_dims, x1);
+    ASSERT_EQ(RC_SUCCESS, runtime->Run());
+    Check(CalcChain(x0, x1), GetTensorData(runtime->GetOutputTensor(0)));
+}
+
+TEST_F(X86FuseElementwiseChainTest, reserved_intermediate) {
+    // b is reserved, so that the chain is split into two groups at b
+    OnnxModelBuilder builder;
+    BuildChain(&builder);
+
+    vector<string> remaining;
+    unique_ptr<Runtime> runtime(CreateRuntime(builder, {"b"}, {"a", "b", "c", "d"}, &remaining));
+    ASSERT_TRUE(runtime != nullptr);
+    EXPECT_EQ(vector<string>({"b"}), remaining);
+
+    auto x0 = RandomData(g_size, -2.0f, 2.0f, 3);
+    auto x1 = RandomData(g_size, -2.0f, 2.0f, 4);
+    SetTensorData(runtime->GetInputTensor(0), g_dims, x0);
+    SetTensorData(runtime->GetInputTensor(1), g_dims, x1);
+    ASSERT_EQ(RC_SUCCESS, runtime->Run());
+    Check(CalcChain(x0, x1), GetTensorData(runtime->GetOutputTensor(0)));
+
+    vector<float> expected_b(g_size);
+    for (int64_t i = 0; i < g_size; ++i) {
+        expected_b[i] = (x0[i] + x1[i]) * 0.5f;
+    }
+    Check(expected_b, GetTensorData(runtime->GetTensorByName("b")));
+}
+
+TEST_F(X86FuseElementwiseChainTest, tree) {
+    // y = (a * x0) * (a - x1) where a = x0 + x1, which is read by two nodes of the group
+    OnnxModelBuilder builder;
+    auto graph = builder.GetGraph();
+    OnnxModelBuilder::AddInput(graph, "x0", g_dims);
+    OnnxModelBuilder::AddInput(graph, "x1", g_dims);
+    OnnxModelBuilder::AddNode(graph, "Add", {"x0", "x1"}, {"a"});
+    OnnxModelBuilder::AddNode(graph, "Mul", {"a", "x0"}, {"b"});
+    OnnxModelBuilder::AddNode(graph, "Sub", {"a", "x1"}, {"c"});
+    OnnxModelBuilder::AddNode(graph, "Mul", {"b", "c"}, {"y"});
+    OnnxModelBuilder::AddOutput(graph, "y");
+
+    vector<string> remaining;
+    unique_ptr<Runtime> runtime(CreateRuntime(builder, {}, {"a", "b", "c"}, &remaining));
+    ASSERT_TRUE(runtime != nullptr);
+    EXPECT_EQ(vector<string>(), remaining);
+
+    auto x0 = RandomData(g_size, -2.0f, 2.0f, 5);
+    auto x1 = RandomData(g_size, -2.0f, 2.0f, 6);
+    SetTensorData(runtime->GetInputTensor(0), g_dims, x0);
+    SetTensorData(runtime->GetInputTensor(1), g_dims, x1);
+    ASSERT_EQ(RC_SUCCESS, runtime->Run());
+
+    vector<float> expected(g_size);
+    for (int64_t i = 0; i < g_size; ++i) {
+        const float a = x0[i] + x1[i];
+        expected[i] = (a * x0[i]) * (a - x1[i]);
+    }
+    Check(expected, GetTensorData(runtime->GetOutputTensor(0)));
+}
+
+TEST_F(X86FuseElementwiseChainTest, sibling_before_group) {
+    /*
+      y = (x0 + x1) * (x0 - x1). groups only grow through consumers, so that the sibling which runs first is
+      left out of the group of the other one.
+    */
+    OnnxModelBuilder builder;
+    auto graph = builder.GetGraph();
+    OnnxModelBuilder::AddInput(graph, "x0", g_dims);
+    OnnxModelBuilder::AddInput(graph, "x1", g_dims);
+    OnnxModelBuilder::AddNode(graph, "Add", {"x0", "x1"}, {"a"});
+    OnnxModelBuilder::AddNode(graph, "Sub", {"x0", "x1"}, {"b"});
+    OnnxModelBuilder::AddNode(graph, "Mul", {"a", "b"}, {"y"});
+    OnnxModelBuilder::AddOutput(graph, "y");
+
+    vector<string> remaining;
+    unique_ptr<Runtime> runtime(CreateRuntime(builder, {}, {"a", "b"}, &remaining));
+    ASSERT_TRUE(runtime != nullptr);
+    EXPECT_EQ(1u, remaining.size());
+
+    auto x0 = RandomData(g_size, -2.0f, 2.0f, 11);
+    auto x1 = RandomData(g_size, -2.0f, 2.0f, 12);
+    SetTensorData(runtime->GetInputTensor(0), g_dims, x0);
+    SetTensorData(runtime->GetInputTensor(1), g_dims, x1);
+    ASSERT_EQ(RC_SUCCESS, runtime->Run());
+
+    vector<float> expected(g_size);
+    for (int64_t i = 0; i < g_size; ++i) {
+        expected[i] = (x0[i] + x1[i]) * (x0[i] - x1[i]);
+    }
+    Check(expected, GetTensorData(runtime->GetOutputTensor(0)));
+}
+
+TEST_F(X86FuseElementwiseChainTest, escaping_intermediate) {
+    // b is also an output of the graph, so that it must be the output of a group
+    OnnxModelBuilder builder;
+    auto graph = builder.GetGraph();
+    OnnxModelBuilder::AddInput(graph, "x0", g_dims);
+    OnnxModelBuilder::AddInput(graph, "x1", g_dims);
+    OnnxModelBuilder::AddNode(graph, "Add", {"x0", "x1"}, {"a"});
+    OnnxModelBuilder::AddNode(graph, "Exp", {"a"}, {"b"});
+    OnnxModelBuilder::AddNode(graph, "Mul", {"b", "x0"}, {"c"});
+    OnnxModelBuilder::AddNode(graph, "Abs", {"c"}, {"y"});
+    OnnxModelBuilder::AddOutput(graph, "y");
+    OnnxModelBuilder::AddOutput(graph, "b");
+
+    vector<string> remaining;
+    unique_ptr<Runtime> runtime(CreateRuntime(builder, {}, {"a", "c"}, &remaining));
+    ASSERT_TRUE(runtime != nullptr);
+    EXPECT_EQ(vector<string>(), remaining);
+
+    auto x0 = RandomData(g_size, -1.0f, 1.0f, 7);
+    auto x1 = RandomData(g_size, -1.0f, 1.0f, 8);
+    SetTensorData(runtime->GetInputTensor(0), g_dims, x0);
+    SetTensorData(runtime->GetInputTensor(1), g_dims, x1);
+    ASSERT_EQ(RC_SUCCESS, runtime->Run());
+
+    vector<float> expected_y(g_size), expected_b(g_size);
+    for (int64_t i = 0; i < g_size; ++i) {
+        expected_b[i] = expf(x0[i] + x1[i]);
+        expected_y[i] = fabsf(expected_b[i] * x0[i]);
+    }
+    Check(expected_y, GetTensorData(runtime->GetOutputTensor(0)));
+    Check(expected_b, GetTensorData(runtime->GetOutputTensor(1)));
+}
+
+TEST_F(X86FuseElementwiseChainTest, broadcast_input) {
+    // bias is broadcasted along the last dim, so that the first Add cannot be fused
+    const auto bias = RandomData(g_dims.back(), -1.0f, 1.0f, 9);
+    OnnxModelBuilder builder;
+    auto graph = builder.GetGraph();
+    OnnxModelBuilder::AddInput(graph, "x0", g_dims);
+    OnnxModelBuilder::AddInitializer(graph, "bias", {g_dims.back()}, bias);
+    OnnxModelBuilder::AddNode(graph, "Add", {"x0", "bias"}, {"a"});
+    OnnxModelBuilder::AddNode(graph, "Abs", {"a"}, {"b"});
+    OnnxModelBuilder::AddNode(graph, "Sqrt", {"b"}, {"y"});
+    OnnxModelBuilder::AddOutput(graph, "y");
+
+    vector<string> remaining;
+    unique_ptr<Runtime> runtime(CreateRuntime(builder, {}, {"a", "b"}, &remaining));
+    ASSERT_TRUE(runtime != nullptr);
+    EXPECT_EQ(vector<string>({"a"}), remaining);
+
+    auto x0 = RandomData(g_size, -2.0f, 2.0f, 10);
+    SetTensorData(runtime->GetInputTensor(0), g_dims, x0);
+    ASSERT_EQ(RC_SUCCESS, runtime->Run());
+
+    vector<float> expected(g_size);
+    for (int64_t i = 0; i < g_size; ++i) {
+        expected[i] = sqrtf(fabsf(x0[i] + bias[i % g_dims.back()]));
+    }
+    Check(expected, GetTensorData(runtime->GetOutputTensor(0)));
+}
+
+#endif
@@ -0,0 +1,450 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#if defined(PPLNN_USE_X86) && defined(PPLNN_ENABLE_ONNX_MODEL)
+
+#include "ppl/nn/engines/x86/engine_factory.h"
+#include "ppl/nn/engines/x86/ops.h"
+#include "ppl/nn/models/onnx/runtime_builder_factory.h"
+#include "ppl/nn/models/onnx/runtime_builder_options.h"
+#include "ppl/nn/models/onnx/model_parser.h"
+#include "ppl/nn/optimizers/utils.h"
+#include "ppl/nn/optimizers/engine_graph_partitioner.h"
+#include "ppl/nn/runtime/runtime.h"
+#include "ppl/kernel/x86/fp32/multi_head_attention.h"
+#include "tests/models/onnx/onnx_model_builder.h"
+#include "gtest/gtest.h"
+#include <cmath>
+#include <memory>
+#include <random>
+using namespace std;
+using namespace ppl::nn;
+using namespace ppl::common;
+using namespace ppl::nn::test;
+
+/*
+  subgraphs exported from transformers are replaced by LayerNorm, GELU and MultiHeadAttention nodes. fused nodes are
+  counted in the optimized graph, since the same intermediates may also be fused by FuseElementwiseChain. outputs
+  are checked against the unfused expressions evaluated on host.
+*/
+class X86FuseTransformerTest : public testing::Test {
+protected:
+    static void SetUpTestCase() {
+        x86::RegisterBuiltinOpImpls();
+    }
+
+    void SetUp() override {
+        engine_.reset(x86::EngineFactory::Create(x86::EngineOptions()));
+    }
+
+    Runtime* CreateRuntime(const OnnxModelBuilder& model, const vector<string>& reserved) {
+        unique_ptr<ppl::nn::onnx::RuntimeBuilder> builder(ppl::nn::onnx::RuntimeBuilderFactory::Create());
+        if (!builder) {
+            return nullptr;
+        }
+        auto buf = model.Serialize();
+        auto engine = engine_.get();
+        if (builder->Init(buf.data(), buf.size(), &engine, 1) != RC_SUCCESS) {
+            return nullptr;
+        }
+        for (auto x = reserved.begin(); x != reserved.end(); ++x) {
+            if (builder->Configure(ppl::nn::onnx::ORB_CONF_RESERVE_TENSOR, x->c_str()) != RC_SUCCESS) {
+                return nullptr;
+            }
+        }
+        if (builder->Preprocess() != RC_SUCCESS) {
+            return nullptr;
+        }
+        return builder->CreateRuntime();
+    }
+
+    // optimizes `model` as RuntimeBuilder does and counts pmx nodes of `op_type` in the optimized graph
+    uint32_t CountFusedOps(const OnnxModelBuilder& model, const vector<string>& reserved, const string& op_type) {
+        auto buf = model.Serialize();
+        ir::Graph graph;
+        if (ppl::nn::onnx::ModelParser::Parse(buf.data(), buf.size(), ".", &graph) != RC_SUCCESS) {
+            ADD_FAILURE() << "parse model failed";
+            return 0;
+        }
+
+        utils::SharedResource resource;
+        resource.engines.push_back(static_cast<EngineImpl*>(engine_.get()));
+        resource.graph_partitioner = make_shared<EngineGraphPartitioner>();
+        for (auto x = reserved.begin(); x != reserved.end(); ++x) {
+            resource.reserved_edgeids.insert(graph.topo->GetEdge(*x)->GetId());
+        }
+        RuntimeGraphInfo info;
+        if (utils::ProcessGraph(resource, &graph, &info) != RC_SUCCESS) {
+            ADD_FAILURE() << "process graph failed";
+            return 0;
+        }
+
+        uint32_t count = 0;
+        for (auto it = graph.topo->CreateNodeIter(); it->IsValid(); it->Forward()) {
+            auto& type = it->Get()->GetType();
+            if (type.domain == "pmx" && type.name == op_type) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    static vector<float> RandomData(uint64_t size, float lo, float hi, uint32_t seed) {
+        mt19937 gen(seed);
+        uniform_real_distribution<float> dist(lo, hi);
+        vector<float> data(size);
+        for (uint64_t i = 0; i < size; ++i) {
+            data[i] = dist(gen);
+        }
+        return data;
+    }
+
+    static void Check(const vector<double>& expected, const vector<float>& result, double eps) {
+        ASSERT_EQ(expected.size(), result.size());
+        for (uint64_t i = 0; i < expected.size(); ++i) {
+            ASSERT_NEAR(expected[i], result[i], eps * std::max(1.0, fabs(expected[i]))) << "index " << i;
+        }
+    }
+
+protected:
+    unique_ptr<Engine> engine_;
+};
+
+/* -------------------------------------------------------------------------- */
+
+static const vector<int64_t> g_ln_dims = {2, 5, 37};
+static const int64_t g_ln_rows = 2 * 5, g_ln_cols = 37;
+
+// y = (x - mean(x)) / sqrt(mean((x - mean(x))^2) + eps) * gamma + beta, normalized along the last axis
+static void BuildLayerNorm(OnnxModelBuilder* builder, const vector<float>& gamma, const vector<float>& beta) {
+    auto graph = builder->GetGraph();
+    OnnxModelBuilder::AddInput(graph, "x", g_ln_dims);
+    OnnxModelBuilder::AddInitializer(graph, "two", {1}, vector<float>{2.0f});
+    OnnxModelBuilder::AddInitializer(graph, "eps", {1}, vector<float>{1e-5f});
+    OnnxModelBuilder::AddInitializer(graph, "gamma", {g_ln_cols}, gamma);
+    OnnxModelBuilder::AddInitializer(graph, "beta", {g_ln_cols}, beta);
+    auto mean_node = OnnxModelBuilder::AddNode(graph, "ReduceMean", {"x"}, {"mean"});
+    OnnxModelBuilder::SetAttr(mean_node, "axes", vector<int64_t>{-1});
+    OnnxModelBuilder::SetAttr(mean_node, "keepdims", (int64_t)1);
+    OnnxModelBuilder::AddNode(graph, "Sub", {"x", "mean"}, {"d"});
+    OnnxModelBuilder::AddNode(graph, "Pow", {"d", "two"}, {"sq"});
+    auto var_node = OnnxModelBuilder::AddNode(graph, "ReduceMean", {"sq"}, {"var"});
+    OnnxModelBuilder::SetAttr(var_node, "axes", vector<int64_t>{-1});
+    OnnxModelBuilder::SetAttr(var_node, "keepdims", (int64_t)1);
+    OnnxModelBuilder::AddNode(graph, "Add", {"var", "eps"}, {"var_eps"});
+    OnnxModelBuilder::AddNode(graph, "Sqrt", {"var_eps"}, {"std"});
+    OnnxModelBuilder::AddNode(graph, "Div", {"d", "std"}, {"norm"});
+    OnnxModelBuilder::AddNode(graph, "Mul", {"norm", "gamma"}, {"scaled"});
+    OnnxModelBuilder::AddNode(graph, "Add", {"scaled", "beta"}, {"y"});
+    OnnxModelBuilder::AddOutput(graph, "y");
+}
+
+static vector<double> CalcLayerNorm(const vector<float>& x, const vector<float>& gamma, const vector<float>& beta) {
+    vector<double> y(x.size());
+    for (int64_t i = 0; i < g_ln_rows; ++i) {
+        const float* row = x.data() + i * g_ln_cols;
+        double mean = 0.0, var = 0.0;
+        for (int64_t j = 0; j < g_ln_cols; ++j) {
+            mean += row[j];
+        }
+        mean /= g_ln_cols;
+        for (int64_t j = 0; j < g_ln_cols; ++j) {
+            var += (row[j] - mean) * (row[j] - mean);
+        }
+        var /= g_ln_cols;
+        for (int64_t j = 0; j < g_ln_cols; ++j) {
+            y[i * g_ln_cols + j] = (row[j] - mean) / sqrt(var + 1e-5) * gamma[j] + beta[j];
+        }
+    }
+    return y;
+}
+
+TEST_F(X86FuseTransformerTest, layer_norm) {
+    auto gamma = RandomData(g_ln_cols, 0.5f, 1.5f, 1);
+    auto beta = RandomData(g_ln_cols, -1.0f, 1.0f, 2);
+    OnnxModelBuilder builder(13);
+    BuildLayerNorm(&builder, gamma, beta);
+
+    EXPECT_EQ(1u, CountFusedOps(builder, {}, "LayerNorm"));
+    unique_ptr<Runtime> runtime(CreateRuntime(builder, {}));
+    ASSERT_TRUE(runtime != nullptr);
+
+    auto x = RandomData(g_ln_rows * g_ln_cols, -3.0f, 5.0f, 3);
+    SetTensorData(runtime->GetInputTensor(0), g_ln_dims, x);
+    ASSERT_EQ(RC_SUCCESS, runtime->Run());
+    Check(CalcLayerNorm(x, gamma, beta), GetTensorData(runtime->GetOutputTensor(0)), 1e-4);
+}
+
+TEST_F(X86FuseTransformerTest, layer_norm_reserved_intermediate) {
+    // d is reserved, so that the pattern is left unfused
+    auto gamma = RandomData(g_ln_cols, 0.5f, 1.5f, 4);
+    auto beta = RandomData(g_ln_cols, -1.0f, 1.0f, 5);
+    OnnxModelBuilder builder(13);
+    BuildLayerNorm(&builder, gamma, beta);
+
+    EXPECT_EQ(0u, CountFusedOps(builder, {"d"}, "LayerNorm"));
+    unique_ptr<Runtime> runtime(CreateRuntime(builder, {"d"}));
+    ASSERT_TRUE(runtime != nullptr);
+
+    auto x = RandomData(g_ln_rows * g_ln_cols, -3.0f, 5.0f, 6);
+    SetTensorData(runtime->GetInputTensor(0), g_ln_dims, x);
+    ASSERT_EQ(RC_SUCCESS, runtime->Run());
+    Check(CalcLayerNorm(x, gamma, beta), GetTensorData(runtime->GetOutputTensor(0)), 1e-4);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static const vector<int64_t> g_gelu_dims = {2, 3, 57};
+static const int64_t g_gelu_size = 2 * 3 * 57;
+
+TEST_F(X86FuseTransformerTest, gelu_erf) {
+    // y = ((1 + erf(x / sqrt(2))) * x) * 0.5
+    OnnxModelBuilder builder(13);
+    auto graph = builder.GetGraph();
+    OnnxModelBuilder::AddInput(graph, "x", g_gelu_dims);
+    OnnxModelBuilder::AddInitializer(graph, "sqrt2", {1}, vector<float>{(float)M_SQRT2});
+    OnnxModelBuilder::AddInitializer(graph, "one", {1}, vector<float>{1.0f});
+    OnnxModelBuilder::AddInitializer(graph, "half", {1}, vector<float>{0.5f});
+    OnnxModelBuilder::AddNode(graph, "Div", {"x", "sqrt2"}, {"a"});
+    OnnxModelBuilder::AddNode(graph, "Erf", {"a"}, {"e"});
+    OnnxModelBuilder::AddNode(graph, "Add", {"e", "one"}, {"f"});
+    OnnxModelBuilder::AddNode(graph, "Mul", {"f", "x"}, {"g"});
+    OnnxModelBuilder::AddNode(graph, "Mul", {"g", "half"}, {"y"});
+    OnnxModelBuilder::AddOutput(graph, "y");
+
+    EXPECT_EQ(1u, CountFusedOps(builder, {}, "GELU"));
+    unique_ptr<Runtime> runtime(CreateRuntime(builder, {}));
+    ASSERT_TRUE(runtime != nullptr);
+
+    auto x = RandomData(g_gelu_size, -6.0f, 6.0f, 7);
+    SetTensorData(runtime->GetInputTensor(0), g_gelu_dims, x);
+    ASSERT_EQ(RC_SUCCESS, runtime->Run());
+
+    vector<double> expected(g_gelu_size);
+    for (int64_t i = 0; i < g_gelu_size; ++i) {
+        expected[i] = 0.5 * x[i] * (1.0 + erf(x[i] / sqrt(2.0)));
+    }
+    Check(expected, GetTensorData(runtime->GetOutputTensor(0)), 1e-5);
+}
+
+TEST_F(X86FuseTransformerTest, gelu_tanh) {
+    // y = (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x * x * x))) * (x * 0.5)
+    OnnxModelBuilder builder(13);
+    auto graph = builder.GetGraph();
+    OnnxModelBuilder::AddInput(graph, "x", g_gelu_dims);
+    OnnxModelBuilder::AddInitializer(graph, "coeff", {1}, vector<float>{0.044715f});
+    OnnxModelBuilder::AddInitializer(graph, "sqrt_2_pi", {1}, vector<float>{(float)(M_2_SQRTPI * M_SQRT1_2)});
+    OnnxModelBuilder::AddInitializer(graph, "one", {1}, vector<float>{1.0f});
+    OnnxModelBuilder::AddInitializer(graph, "half", {1}, vector<float>{0.5f});
+    OnnxModelBuilder::AddNode(graph, "Mul", {"x", "x"}, {"sq"});
+    OnnxModelBuilder::AddNode(graph, "Mul", {"sq", "x"}, {"cube"});
+    OnnxModelBuilder::AddNode(graph, "Mul", {"cube", "coeff"}, {"c"});
+    OnnxModelBuilder::AddNode(graph, "Add", {"x", "c"}, {"inner"});
+    OnnxModelBuilder::AddNode(graph, "Mul", {"inner", "sqrt_2_pi"}, {"pre"});
+    OnnxModelBuilder::AddNode(graph, "Tanh", {"pre"}, {"t"});
+    OnnxModelBuilder::AddNode(graph, "Add", {"t", "one"}, {"f"});
+    OnnxModelBuilder::AddNode(graph, "Mul", {"x", "half"}, {"hx"});
+    OnnxModelBuilder::AddNode(graph, "Mul", {"f", "hx"}, {"y"});
+    OnnxModelBuilder::AddOutput(graph, "y");
+
+    EXPECT_EQ(1u, CountFusedOps(builder, {}, "GELU"));
+    unique_ptr<Runtime> runtime(CreateRuntime(builder, {}));
+    ASSERT_TRUE(runtime != nullptr);
+
+    auto x = RandomData(g_gelu_size, -6.0f, 6.0f, 8);
+    SetTensorData(runtime->GetInputTensor(0), g_gelu_dims, x);
+    ASSERT_EQ(RC_SUCCESS, runtime->Run());
+
+    vector<double> expected(g_gelu_size);
+    for (int64_t i = 0; i < g_gelu_size; ++i) {
+        const double v = x[i];
+        expected[i] = 0.5 * v * (1.0 + tanh(sqrt(2.0 / M_PI) * (v + 0.044715 * v * v * v)));
+    }
+    Check(expected, GetTensorData(runtime->GetOutputTensor(0)), 1e-5);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static const int64_t g_mha_batch = 2, g_mha_seqlen_kv = 40, g_mha_heads = 4, g_mha_head_dim = 16;
+static const int64_t g_mha_hidden = g_mha_heads * g_mha_head_dim;
+
+// attention block exported from BERT, whose scores are divided by sqrt(head_dim) and added by a mask of keys
+static void BuildMultiHeadAttention(OnnxModelBuilder* builder, int64_t seqlen_q, const vector<float>& mask) {
+    auto graph = builder->GetGraph();
+    OnnxModelBuilder::AddInput(graph, "query", {g_mha_batch, seqlen_q, g_mha_hidden});
+    OnnxModelBuilder::AddInput(graph, "key", {g_mha_batch, g_mha_seqlen_kv, g_mha_hidden});
+    OnnxModelBuilder::AddInput(graph, "value", {g_mha_batch, g_mha_seqlen_kv, g_mha_hidden});
+    OnnxModelBuilder::AddInitializer(graph, "q_shape", {4},
+                                     vector<int64_t>{g_mha_batch, seqlen_q, g_mha_heads, g_mha_head_dim});
+    OnnxModelBuilder::AddInitializer(graph, "k_shape", {4},
+                                     vector<int64_t>{g_mha_batch, g_mha_seqlen_kv, g_mha_heads, g_mha_head_dim});
+    OnnxModelBuilder::AddInitializer(graph, "v_shape", {4},
+                                     vector<int64_t>{g_mha_batch, g_mha_seqlen_kv, g_mha_heads, g_mha_head_dim});
+    OnnxModelBuilder::AddInitializer(graph, "o_shape", {3}, vector<int64_t>{g_mha_batch, seqlen_q, g_mha_hidden});
+    OnnxModelBuilder::AddInitializer(graph, "divisor", {1}, vector<float>{sqrtf((float)g_mha_head_dim)});
+    OnnxModelBuilder::AddInitializer(graph, "mask", {g_mha_batch, 1, 1, g_mha_seqlen_kv}, mask);
+
+    OnnxModelBuilder::AddNode(graph, "Reshape", {"query", "q_shape"}, {"q4"});
+    auto q_trans = OnnxModelBuilder::AddNode(graph, "Transpose", {"q4"}, {"q"});
+    OnnxModelBuilder::SetAttr(q_trans, "perm", vector<int64_t>{0, 2, 1, 3});
+    OnnxModelBuilder::AddNode(graph, "Reshape", {"key", "k_shape"}, {"k4"});
+    auto k_trans = OnnxModelBuilder::AddNode(graph, "Transpose", {"k4"}, {"k"});
+    OnnxModelBuilder::SetAttr(k_trans, "perm", vector<int64_t>{0, 2, 3, 1});
+    OnnxModelBuilder::AddNode(graph, "Reshape", {"value", "v_shape"}, {"v4"});
+    auto v_trans = OnnxModelBuilder::AddNode(graph, "Transpose", {"v4"}, {"v"});
+    OnnxModelBuilder::SetAttr(v_trans, "perm", vector<int64_t>{0, 2, 1, 3});
+    OnnxModelBuilder::AddNode(graph, "MatMul", {"q", "k"}, {"scores"});
+    OnnxModelBuilder::AddNode(graph, "Div", {"scores", "divisor"}, {"scaled"});
+    OnnxModelBuilder::AddNode(graph, "Add", {"scaled", "mask"}, {"masked"});
+    auto softmax = OnnxModelBuilder::AddNode(graph, "Softmax", {"masked"}, {"probs"});
+    OnnxModelBuilder::SetAttr(softmax, "axis", (int64_t)-1);
+    OnnxModelBuilder::AddNode(graph, "MatMul", {"probs", "v"}, {"context"});
+    auto o_trans = OnnxModelBuilder::AddNode(graph, "Transpose", {"context"}, {"merged"});
+    OnnxModelBuilder::SetAttr(o_trans, "perm", vector<int64_t>{0, 2, 1, 3});
+    OnnxModelBuilder::AddNode(graph, "Reshape", {"merged", "o_shape"}, {"y"});
+    OnnxModelBuilder::AddOutput(graph, "y");
+}
+
+static vector<double> CalcMultiHeadAttention(int64_t seqlen_q, const vector<float>& q, const vector<float>& k,
+                                             const vector<float>& v, const vector<float>& mask) {
+    const double scale = 1.0 / sqrt((double)g_mha_head_dim);
+    vector<double> y(g_mha_batch * seqlen_q * g_mha_hidden);
+    vector<double> probs(g_mha_seqlen_kv);
+    for (int64_t b = 0; b < g_mha_batch; ++b) {
+        for (int64_t h = 0; h < g_mha_heads; ++h) {
+            for (int64_t i = 0; i < seqlen_q; ++i) {
+                const float* q_row = q.data() + (b * seqlen_q + i) * g_mha_hidden + h * g_mha_head_dim;
+                double max_score = -INFINITY, sum = 0.0;
+                for (int64_t j = 0; j < g_mha_seqlen_kv; ++j) {
+                    const float* k_row = k.data() + (b * g_mha_seqlen_kv + j) * g_mha_hidden + h * g_mha_head_dim;
+                    double score = 0.0;
+                    for (int64_t d = 0; d < g_mha_head_dim; ++d) {
+                        score += (double)q_row[d] * k_row[d];
+                    }
+                    probs[j] = score * scale + mask[b * g_mha_seqlen_kv + j];
+                    max_score = std::max(max_score, probs[j]);
+                }
+                for (int64_t j = 0; j < g_mha_seqlen_kv; ++j) {
+                    probs[j] = exp(probs[j] - max_score);
+                    sum += probs[j];
+                }
+                double* y_row = y.data() + (b * seqlen_q + i) * g_mha_hidden + h * g_mha_head_dim;
+                for (int64_t j = 0; j < g_mha_seqlen_kv; ++j) {
+                    const float* v_row = v.data() + (b * g_mha_seqlen_kv + j) * g_mha_hidden + h * g_mha_head_dim;
+                    for (int64_t d = 0; d < g_mha_head_dim; ++d) {
+                        y_row[d] += probs[j] / sum * v_row[d];
+                    }
+                }
+            }
+        }
+    }
+    return y;
+}
+
+static void TestMultiHeadAttention(Runtime* runtime, int64_t seqlen_q, const vector<float>& mask, uint32_t seed,
+                                   double eps) {
+    mt19937 gen(seed);
+    uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    vector<float> q(g_mha_batch * seqlen_q * g_mha_hidden), k(g_mha_batch * g_mha_seqlen_kv * g_mha_hidden),
+        v(g_mha_batch * g_mha_seqlen_kv * g_mha_hidden);
+    for (auto x = q.begin(); x != q.end(); ++x) {
+        *x = dist(gen);
+    }
+    for (uint64_t i = 0; i < k.size(); ++i) {
+        k[i] = dist(gen);
+        v[i] = dist(gen);
+    }
+    SetTensorData(runtime->GetInputTensor(0), {g_mha_batch, seqlen_q, g_mha_hidden}, q);
+    SetTensorData(runtime->GetInputTensor(1), {g_mha_batch, g_mha_seqlen_kv, g_mha_hidden}, k);
+    SetTensorData(runtime->GetInputTensor(2), {g_mha_batch, g_mha_seqlen_kv, g_mha_hidden}, v);
+    ASSERT_EQ(RC_SUCCESS, runtime->Run());
+
+    auto expected = CalcMultiHeadAttention(seqlen_q, q, k, v, mask);
+    auto result = GetTensorData(runtime->GetOutputTensor(0));
+    ASSERT_EQ(expected.size(), result.size());
+    for (uint64_t i = 0; i < expected.size(); ++i) {
+        ASSERT_NEAR(expected[i], result[i], eps) << "index " << i;
+    }
+}
+
+static vector<float> CreateKeyMask() {
+    // the last keys of the second batch are masked as padding
+    vector<float> mask(g_mha_batch * g_mha_seqlen_kv, 0.0f);
+    for (int64_t j = 30; j < g_mha_seqlen_kv; ++j) {
+        mask[g_mha_seqlen_kv + j] = -10000.0f;
+    }
+    return mask;
+}
+
+/*
+  the fused kernel is only selected if unfused gemms are sse, so fma is disabled to test it on any cpu with avx.
+  multi_head_attention_cpu_isa checks the selection with the isa of this cpu.
+*/
+TEST_F(X86FuseTransformerTest, multi_head_attention) {
+    ASSERT_EQ(RC_SUCCESS, engine_->Configure(x86::ENGINE_CONF_DISABLE_AVX_FMA3));
+    const int64_t seqlen_q = 40;
+    auto mask = CreateKeyMask();
+    OnnxModelBuilder builder(13);
+    BuildMultiHeadAttention(&builder, seqlen_q, mask);
+
+    EXPECT_EQ(1u, CountFusedOps(builder, {}, "MultiHeadAttention"));
+    unique_ptr<Runtime> runtime(CreateRuntime(builder, {}));
+    ASSERT_TRUE(runtime != nullptr);
+    TestMultiHeadAttention(runtime.get(), seqlen_q, mask, 9, 1e-5);
+}
+
+TEST_F(X86FuseTransformerTest, multi_head_attention_short_query) {
+    ASSERT_EQ(RC_SUCCESS, engine_->Configure(x86::ENGINE_CONF_DISABLE_AVX_FMA3));
+    const int64_t seqlen_q = 8;
+    auto mask = CreateKeyMask();
+    OnnxModelBuilder builder(13);
+    BuildMultiHeadAttention(&builder, seqlen_q, mask);
+
+    EXPECT_EQ(1u, CountFusedOps(builder, {}, "MultiHeadAttention"));
+    unique_ptr<Runtime> runtime(CreateRuntime(builder, {}));
+    ASSERT_TRUE(runtime != nullptr);
+    TestMultiHeadAttention(runtime.get(), seqlen_q, mask, 10, 1e-5);
+}
+
+TEST_F(X86FuseTransformerTest, multi_head_attention_cpu_isa) {
+    const int64_t seqlen_q = 40;
+    auto mask = CreateKeyMask();
+    OnnxModelBuilder builder(13);
+    BuildMultiHeadAttention(&builder, seqlen_q, mask);
+
+    const bool profitable = ppl::kernel::x86::multi_head_attention_fp32_is_profitable(GetCpuISA());
+    EXPECT_EQ(profitable ? 1u : 0u, CountFusedOps(builder, {}, "MultiHeadAttention"));
+    unique_ptr<Runtime> runtime(CreateRuntime(builder, {}));
+    ASSERT_TRUE(runtime != nullptr);
+    TestMultiHeadAttention(runtime.get(), seqlen_q, mask, 12, 1e-5);
+}
+
+TEST_F(X86FuseTransformerTest, multi_head_attention_reserved_scores) {
+    // scores cannot be dropped if they are reserved
+    ASSERT_EQ(RC_SUCCESS, engine_->Configure(x86::ENGINE_CONF_DISABLE_AVX_FMA3));
+    const int64_t seqlen_q = 40;
+    auto mask = CreateKeyMask();
+    OnnxModelBuilder builder(13);
+    BuildMultiHeadAttention(&builder, seqlen_q, mask);
+
+    EXPECT_EQ(0u, CountFusedOps(builder, {"probs"}, "MultiHeadAttention"));
+    unique_ptr<Runtime> runtime(CreateRuntime(builder, {"probs"}));
+    ASSERT_TRUE(runtime != nullptr);
+    TestMultiHeadAttention(runtime.get(), seqlen_q, mask, 11, 1e-5);
+}
+
+#endif
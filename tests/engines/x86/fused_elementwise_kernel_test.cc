@@ -0,0 +1,221 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/kernel/x86/fp32/fused_elementwise.h"
+#include "ppl/kernel/x86/common/threading_tools.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+using namespace std;
+using namespace ppl::common;
+using namespace ppl::kernel::x86;
+
+typedef RetCode (*fused_elementwise_func_t)(const int64_t, const float**, const bool*, const int32_t,
+                                            const fused_elementwise_inst_t*, const int32_t, void*, float*);
+
+struct FusedElementwiseImpl {
+    const char* name;
+    isa_t isa;
+    fused_elementwise_func_t func;
+};
+
+/*
+  instruction lists are checked against a scalar evaluation in double. lengths cover several tiles of 512 floats
+  with tails which are not multiples of the simd width.
+*/
+class FusedElementwiseKernelTest : public testing::Test {
+protected:
+    static vector<float> RandomData(uint64_t size, float lo, float hi, uint32_t seed) {
+        mt19937 gen(seed);
+        uniform_real_distribution<float> dist(lo, hi);
+        vector<float> data(size);
+        for (uint64_t i = 0; i < size; ++i) {
+            data[i] = dist(gen);
+        }
+        return data;
+    }
+
+    static vector<FusedElementwiseImpl> GetTestImpls() {
+        vector<FusedElementwiseImpl> impls = {
+            {"ref", ISA_X86_SSE, fused_elementwise_fp32},
+            {"sse", ISA_X86_SSE, fused_elementwise_fp32_sse},
+            {"fma", ISA_X86_AVX | ISA_X86_FMA, fused_elementwise_fp32_fma},
+#ifdef PPL_USE_X86_AVX512
+            {"avx512", ISA_X86_AVX512, fused_elementwise_fp32_avx512},
+#endif
+        };
+        vector<FusedElementwiseImpl> supported;
+        for (auto it = impls.begin(); it != impls.end(); ++it) {
+            if ((GetCpuISA() & it->isa) == it->isa) {
+                supported.push_back(*it);
+            }
+        }
+        return supported;
+    }
+
+    static double Eval(int32_t opcode, double a, double b) {
+        switch (opcode) {
+            case FUSED_ELEMENTWISE_ADD: return a + b;
+            case FUSED_ELEMENTWISE_SUB: return a - b;
+            case FUSED_ELEMENTWISE_MUL: return a * b;
+            case FUSED_ELEMENTWISE_DIV: return a / b;
+            case FUSED_ELEMENTWISE_MAX: return std::max(a, b);
+            case FUSED_ELEMENTWISE_MIN: return std::min(a, b);
+            case FUSED_ELEMENTWISE_RELU: return std::max(a, 0.0);
+            case FUSED_ELEMENTWISE_SIGMOID: return 1.0 / (1.0 + exp(-a));
+            case FUSED_ELEMENTWISE_TANH: return tanh(a);
+            case FUSED_ELEMENTWISE_EXP: return exp(a);
+            case FUSED_ELEMENTWISE_ERF: return erf(a);
+            case FUSED_ELEMENTWISE_ABS: return fabs(a);
+            case FUSED_ELEMENTWISE_NEG: return -a;
+            case FUSED_ELEMENTWISE_SQRT: return sqrt(a);
+            default: return 0.0;
+        }
+    }
+
+    static vector<double> Reference(int64_t length, const vector<vector<float>>& src, const vector<bool>& is_scalar,
+                                    const vector<fused_elementwise_inst_t>& insts) {
+        const int32_t num_src = src.size();
+        vector<double> dst(length);
+        vector<double> values(num_src + insts.size());
+        for (int64_t i = 0; i < length; ++i) {
+            for (int32_t s = 0; s < num_src; ++s) {
+                values[s] = src[s][is_scalar[s] ? 0 : i];
+            }
+            for (uint32_t k = 0; k < insts.size(); ++k) {
+                const double b = fused_elementwise_is_binary(insts[k].opcode) ? values[insts[k].src1] : 0.0;
+                values[num_src + k] = Eval(insts[k].opcode, values[insts[k].src0], b);
+            }
+            dst[i] = values.back();
+        }
+        return dst;
+    }
+
+    static void Check(int64_t length, const vector<vector<float>>& src, const vector<bool>& is_scalar,
+                      const vector<fused_elementwise_inst_t>& insts) {
+        auto expected = Reference(length, src, is_scalar, insts);
+
+        vector<const float*> src_list(src.size());
+        unique_ptr<bool[]> src_is_scalar(new bool[src.size()]);
+        for (uint32_t s = 0; s < src.size(); ++s) {
+            src_list[s] = src[s].data();
+            src_is_scalar[s] = is_scalar[s];
+        }
+
+        auto impls = GetTestImpls();
+        for (auto impl = impls.begin(); impl != impls.end(); ++impl) {
+            vector<uint8_t> temp_buffer(
+                fused_elementwise_fp32_get_buffer_bytes(insts.data(), src.size(), insts.size()));
+            vector<float> dst(length, numeric_limits<float>::quiet_NaN());
+            EXPECT_EQ(RC_SUCCESS,
+                      impl->func(length, src_list.data(), src_is_scalar.get(), src.size(), insts.data(),
+                                 insts.size(), temp_buffer.data(), dst.data()))
+                << impl->name;
+            for (int64_t i = 0; i < length; ++i) {
+                ASSERT_NEAR(expected[i], dst[i], 1e-5 * std::max(1.0, fabs(expected[i])))
+                    << impl->name << " length " << length << " index " << i;
+            }
+        }
+    }
+
+    static uint64_t TileBufferBytes(int32_t num_slots) {
+        return (uint64_t)num_slots * 512 * sizeof(float) * get_omp_max_threads();
+    }
+};
+
+TEST_F(FusedElementwiseKernelTest, chain) {
+    // relu(sigmoid((x0 + x1) * 0.5) - tanh(x1)) / (abs(x0) + 1), where 0.5 and 1 are scalars
+    const vector<fused_elementwise_inst_t> insts = {
+        {FUSED_ELEMENTWISE_ADD, 0, 1}, {FUSED_ELEMENTWISE_MUL, 4, 2},     {FUSED_ELEMENTWISE_SIGMOID, 5, -1},
+        {FUSED_ELEMENTWISE_TANH, 1, -1}, {FUSED_ELEMENTWISE_SUB, 6, 7},   {FUSED_ELEMENTWISE_RELU, 8, -1},
+        {FUSED_ELEMENTWISE_ABS, 0, -1},  {FUSED_ELEMENTWISE_ADD, 10, 3},  {FUSED_ELEMENTWISE_DIV, 9, 11},
+    };
+    const int64_t lengths[] = {1, 13, 512, 1543};
+    for (uint32_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); ++l) {
+        const int64_t length = lengths[l];
+        const vector<vector<float>> src = {RandomData(length, -2.0f, 2.0f, 1), RandomData(length, -2.0f, 2.0f, 2),
+                                           {0.5f}, {1.0f}};
+        Check(length, src, {false, false, true, true}, insts);
+    }
+}
+
+TEST_F(FusedElementwiseKernelTest, unary_and_binary_ops) {
+    // every opcode, with a duplicated operand(x * x) and a scalar on the left(1 - x)
+    const vector<fused_elementwise_inst_t> insts = {
+        {FUSED_ELEMENTWISE_MAX, 0, 1},       {FUSED_ELEMENTWISE_MIN, 0, 1},  {FUSED_ELEMENTWISE_SUB, 3, 4},
+        {FUSED_ELEMENTWISE_MUL, 5, 5},       {FUSED_ELEMENTWISE_SQRT, 6, -1}, {FUSED_ELEMENTWISE_NEG, 7, -1},
+        {FUSED_ELEMENTWISE_EXP, 8, -1},      {FUSED_ELEMENTWISE_ERF, 0, -1}, {FUSED_ELEMENTWISE_SUB, 2, 10},
+        {FUSED_ELEMENTWISE_ADD, 9, 11},
+    };
+    const int64_t length = 1029;
+    const vector<vector<float>> src = {RandomData(length, -2.0f, 2.0f, 3), RandomData(length, -2.0f, 2.0f, 4),
+                                       {1.0f}};
+    Check(length, src, {false, false, true}, insts);
+}
+
+TEST_F(FusedElementwiseKernelTest, live_results) {
+    // (x0 + x1) * (x0 - x1) + (x0 * x1 - x0 / x1) * (max(x0, x1) + min(x0, x1)) keeps up to 4 live results
+    const vector<fused_elementwise_inst_t> insts = {
+        {FUSED_ELEMENTWISE_ADD, 0, 1}, {FUSED_ELEMENTWISE_SUB, 0, 1}, {FUSED_ELEMENTWISE_MUL, 0, 1},
+        {FUSED_ELEMENTWISE_DIV, 0, 1}, {FUSED_ELEMENTWISE_MAX, 0, 1}, {FUSED_ELEMENTWISE_MIN, 0, 1},
+        {FUSED_ELEMENTWISE_MUL, 2, 3}, {FUSED_ELEMENTWISE_SUB, 4, 5}, {FUSED_ELEMENTWISE_ADD, 6, 7},
+        {FUSED_ELEMENTWISE_MUL, 9, 10}, {FUSED_ELEMENTWISE_ADD, 8, 11},
+    };
+    const int64_t length = 2000;
+    const vector<vector<float>> src = {RandomData(length, 0.5f, 2.0f, 5), RandomData(length, 0.5f, 2.0f, 6)};
+    Check(length, src, {false, false}, insts);
+    EXPECT_EQ(TileBufferBytes(6), fused_elementwise_fp32_get_buffer_bytes(insts.data(), 2, insts.size()));
+}
+
+TEST_F(FusedElementwiseKernelTest, tile_slots_are_reused) {
+    // a chain of 15 instructions only needs one slot
+    vector<fused_elementwise_inst_t> insts = {{FUSED_ELEMENTWISE_ADD, 0, 1}};
+    for (int32_t k = 1; k < 15; ++k) {
+        const int32_t prev = 2 + k - 1;
+        insts.push_back({(k % 2) ? FUSED_ELEMENTWISE_MUL : FUSED_ELEMENTWISE_SUB, prev, k % 3 == 0 ? prev : 1});
+    }
+    EXPECT_EQ(TileBufferBytes(1), fused_elementwise_fp32_get_buffer_bytes(insts.data(), 2, insts.size()));
+
+    const int64_t length = 777;
+    const vector<vector<float>> src = {RandomData(length, -1.0f, 1.0f, 7), RandomData(length, 0.9f, 1.1f, 8)};
+    Check(length, src, {false, false}, insts);
+
+    // results which are never read do not keep their slots
+    const vector<fused_elementwise_inst_t> dead = {
+        {FUSED_ELEMENTWISE_EXP, 0, -1}, {FUSED_ELEMENTWISE_ABS, 0, -1}, {FUSED_ELEMENTWISE_NEG, 1, -1},
+        {FUSED_ELEMENTWISE_ADD, 0, 4},
+    };
+    EXPECT_EQ(TileBufferBytes(1), fused_elementwise_fp32_get_buffer_bytes(dead.data(), 2, dead.size()));
+    Check(length, src, {false, false}, dead);
+}
+
+TEST_F(FusedElementwiseKernelTest, invalid_instructions) {
+    const vector<fused_elementwise_inst_t> insts = {{FUSED_ELEMENTWISE_ADD, 0, 2}, {FUSED_ELEMENTWISE_RELU, 2, -1}};
+    const vector<float> x(16, 1.0f);
+    const float* src[] = {x.data()};
+    const bool is_scalar[] = {false};
+    vector<float> dst(16);
+    vector<uint8_t> temp_buffer(TileBufferBytes(1));
+    // instruction 0 reads its own result
+    EXPECT_NE(RC_SUCCESS,
+              fused_elementwise_fp32(16, src, is_scalar, 1, insts.data(), insts.size(), temp_buffer.data(),
+                                     dst.data()));
+}
@@ -0,0 +1,127 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/kernel/x86/fp32/gemm.h"
+#include "gtest/gtest.h"
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+using namespace std;
+using namespace ppl::common;
+using namespace ppl::kernel::x86;
+
+// places data at the end of pages followed by an inaccessible page, so that reading past the end faults
+class GuardedBuffer final {
+public:
+    GuardedBuffer(const vector<float>& data) {
+        const uint64_t page_size = sysconf(_SC_PAGESIZE);
+        const uint64_t data_bytes = data.size() * sizeof(float);
+        mapped_bytes_ = (data_bytes + page_size - 1) / page_size * page_size + page_size;
+        base_ = (uint8_t*)mmap(nullptr, mapped_bytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base_ == MAP_FAILED) {
+            base_ = nullptr;
+            return;
+        }
+        mprotect(base_ + mapped_bytes_ - page_size, page_size, PROT_NONE);
+        data_ = (float*)(base_ + mapped_bytes_ - page_size - data_bytes);
+        memcpy(data_, data.data(), data_bytes);
+    }
+    ~GuardedBuffer() {
+        if (base_) {
+            munmap(base_, mapped_bytes_);
+        }
+    }
+    const float* data() const {
+        return data_;
+    }
+
+private:
+    uint8_t* base_ = nullptr;
+    float* data_ = nullptr;
+    uint64_t mapped_bytes_ = 0;
+};
+
+class GemmFp32KernelTest : public testing::Test {
+protected:
+    static vector<float> RandomData(uint64_t size, float lo, float hi, uint32_t seed) {
+        mt19937 gen(seed);
+        uniform_real_distribution<float> dist(lo, hi);
+        vector<float> data(size);
+        for (uint64_t i = 0; i < size; ++i) {
+            data[i] = dist(gen);
+        }
+        return data;
+    }
+
+    // fma and avx512 implementations if they are supported by this cpu
+    static vector<isa_t> GetTestIsas() {
+        vector<isa_t> isas;
+        const isa_t cpu_isa = GetCpuISA();
+        const isa_t fma_isa = ISA_X86_AVX | ISA_X86_FMA;
+        if ((cpu_isa & fma_isa) == fma_isa) {
+            isas.push_back(cpu_isa & (~ISA_X86_AVX512));
+        }
+        if (cpu_isa & ISA_X86_AVX512) {
+            isas.push_back(cpu_isa);
+        }
+        return isas;
+    }
+};
+
+/*
+  fma and avx512 pack 24 and 48 columns of B in a block. a last block of N % 24 in (16, 24) or N % 48 in (32, 48)
+  needs as many registers as a full block but must still be packed by the tail routine, which only reads its own
+  columns.
+*/
+TEST_F(GemmFp32KernelTest, pack_b_partial_block) {
+    const int64_t M = 7, K = 29;
+    const int64_t Ns[] = {40, 47, 88, 33, 48, 16, 20, 23};
+    const gemm_m_type_t typeBs[] = {gemm_m_type::NOTRANS, gemm_m_type::TRANS};
+
+    auto isas = GetTestIsas();
+    for (auto isa = isas.begin(); isa != isas.end(); ++isa) {
+        for (uint32_t i = 0; i < sizeof(Ns) / sizeof(Ns[0]); ++i) {
+            for (uint32_t t = 0; t < sizeof(typeBs) / sizeof(typeBs[0]); ++t) {
+                const int64_t N = Ns[i];
+                const gemm_m_type_t typeB = typeBs[t];
+                const int64_t ldb = typeB == gemm_m_type::TRANS ? K : N;
+                auto A = RandomData(M * K, -1.0f, 1.0f, 1);
+                GuardedBuffer B(RandomData(N * K, -1.0f, 1.0f, 2 + i));
+                ASSERT_NE(nullptr, B.data());
+
+                vector<float> packed_B(gemm_fp32_get_packed_b_bytes(*isa, N, K) / sizeof(float));
+                ASSERT_EQ(RC_SUCCESS, gemm_pack_b_fp32(*isa, B.data(), typeB, N, K, ldb, packed_B.data()));
+
+                vector<float> C(M * N), expected(M * N);
+                EXPECT_EQ(RC_SUCCESS,
+                          gemm_fp32(*isa, A.data(), packed_B.data(), nullptr, nullptr, gemm_m_type::NOTRANS,
+                                    gemm_m_type::PACKED, gemm_v_type::EMPTY, gemm_m_type::EMPTY, M, N, K, K, N, N, 0,
+                                    1.0f, 0.0f, 0.0f, 0.0f, gemm_post::NONE, C.data()));
+                EXPECT_EQ(RC_SUCCESS,
+                          gemm_fp32_ref(A.data(), B.data(), nullptr, nullptr, gemm_m_type::NOTRANS, typeB,
+                                        gemm_v_type::EMPTY, gemm_m_type::EMPTY, M, N, K, K, ldb, N, 0, 1.0f, 0.0f,
+                                        0.0f, 0.0f, gemm_post::NONE, expected.data()));
+                for (int64_t j = 0; j < M * N; ++j) {
+                    ASSERT_NEAR(expected[j], C[j], 1e-4f) << "N " << N << " typeB " << typeB << " index " << j;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,239 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/kernel/x86/fp32/gru.h"
+#include "gtest/gtest.h"
+#include <cmath>
+#include <random>
+#include <vector>
+using namespace std;
+using namespace ppl::common;
+using namespace ppl::kernel::x86;
+
+struct GruCase {
+    int64_t seq_len;
+    int64_t batch;
+    int64_t input_size;
+    int64_t hidden_size;
+    rnn_direction_t direction;
+    bool linear_before_reset;
+    bool has_bias;
+    bool has_sequence_lens;
+    bool has_initial_h;
+    bool has_Y;
+    bool has_Y_h;
+};
+
+typedef uint64_t (*gru_get_buffer_bytes_func_t)(const ppl::nn::TensorShape*, const rnn_direction_t, const int64_t,
+                                                const bool, const bool);
+typedef RetCode (*gru_func_t)(const ppl::nn::TensorShape*, const float*, const float*, const float*, const float*,
+                              const int32_t*, const float*, const rnn_direction_t, const int64_t, const bool, void*,
+                              float*, float*);
+
+struct GruImpl {
+    const char* name;
+    isa_t isa;
+    gru_get_buffer_bytes_func_t get_buffer_bytes;
+    gru_func_t func;
+};
+
+/*
+  gru kernels are checked against a scalar implementation of the onnx definition in double. padded steps of
+  sequence_lens keep the hidden state and output zeros in Y. the reverse direction starts from the last valid step.
+*/
+class GruKernelTest : public testing::Test {
+protected:
+    static vector<float> RandomData(uint64_t size, float lo, float hi, uint32_t seed) {
+        mt19937 gen(seed);
+        uniform_real_distribution<float> dist(lo, hi);
+        vector<float> data(size);
+        for (uint64_t i = 0; i < size; ++i) {
+            data[i] = dist(gen);
+        }
+        return data;
+    }
+
+    static vector<GruImpl> GetTestImpls() {
+        vector<GruImpl> impls = {
+            {"ref", ISA_X86_SSE, gru_fp32_ref_get_buffer_bytes, gru_fp32_ref},
+            {"fma", ISA_X86_AVX | ISA_X86_FMA, gru_fp32_fma_get_buffer_bytes, gru_fp32_fma},
+#ifdef PPL_USE_X86_AVX512
+            {"avx512", ISA_X86_AVX512, gru_fp32_avx512_get_buffer_bytes, gru_fp32_avx512},
+#endif
+        };
+        vector<GruImpl> supported;
+        for (auto it = impls.begin(); it != impls.end(); ++it) {
+            if ((GetCpuISA() & it->isa) == it->isa) {
+                supported.push_back(*it);
+            }
+        }
+        return supported;
+    }
+
+    static double Sigmoid(double x) {
+        return 1.0 / (1.0 + exp(-x));
+    }
+
+    static void RefGru(const GruCase& c, const vector<float>& X, const vector<float>& W, const vector<float>& R,
+                       const float* B, const int32_t* sequence_lens, const float* initial_h, vector<float>* Y,
+                       vector<float>* Y_h) {
+        const int64_t num_direction = c.direction == rnn_direction::BIDIRECTIONAL ? 2 : 1;
+        const int64_t hs = c.hidden_size;
+        Y->assign(c.seq_len * num_direction * c.batch * hs, 0.0f);
+        Y_h->assign(num_direction * c.batch * hs, 0.0f);
+
+        for (int64_t nd = 0; nd < num_direction; ++nd) {
+            const bool is_reverse = nd || c.direction == rnn_direction::REVERSE;
+            const float* Wb = B ? B + nd * 6 * hs : nullptr;
+            const float* Rb = B ? Wb + 3 * hs : nullptr;
+            for (int64_t b = 0; b < c.batch; ++b) {
+                // xw: x * W^T + Wb, hr: h * R^T + Rb, in the order of z, r, h
+                vector<double> h(hs, 0.0), xw(3 * hs), hr(3 * hs), rh(hs);
+                const int64_t state_offset = (nd * c.batch + b) * hs;
+                for (int64_t i = 0; i < hs; ++i) {
+                    h[i] = initial_h ? initial_h[state_offset + i] : 0.0;
+                }
+                const int64_t valid_len = sequence_lens ? sequence_lens[b] : c.seq_len;
+                for (int64_t s = 0; s < valid_len; ++s) {
+                    const int64_t t = is_reverse ? valid_len - 1 - s : s;
+                    const float* x = X.data() + (t * c.batch + b) * c.input_size;
+                    for (int64_t g = 0; g < 3 * hs; ++g) {
+                        const float* w = W.data() + (nd * 3 * hs + g) * c.input_size;
+                        const float* r = R.data() + (nd * 3 * hs + g) * hs;
+                        double sx = Wb ? Wb[g] : 0.0;
+                        for (int64_t k = 0; k < c.input_size; ++k) {
+                            sx += (double)x[k] * w[k];
+                        }
+                        double sh = Rb ? Rb[g] : 0.0;
+                        for (int64_t k = 0; k < hs; ++k) {
+                            sh += h[k] * r[k];
+                        }
+                        xw[g] = sx;
+                        hr[g] = sh;
+                    }
+                    vector<double> z(hs), r(hs);
+                    for (int64_t i = 0; i < hs; ++i) {
+                        z[i] = Sigmoid(xw[i] + hr[i]);
+                        r[i] = Sigmoid(xw[hs + i] + hr[hs + i]);
+                        rh[i] = r[i] * h[i];
+                    }
+                    vector<double> ht(hs);
+                    for (int64_t i = 0; i < hs; ++i) {
+                        if (c.linear_before_reset) {
+                            ht[i] = tanh(xw[2 * hs + i] + r[i] * hr[2 * hs + i]);
+                        } else {
+                            const float* rw = R.data() + (nd * 3 * hs + 2 * hs + i) * hs;
+                            double sum = Rb ? Rb[2 * hs + i] : 0.0;
+                            for (int64_t k = 0; k < hs; ++k) {
+                                sum += rh[k] * rw[k];
+                            }
+                            ht[i] = tanh(xw[2 * hs + i] + sum);
+                        }
+                    }
+                    for (int64_t i = 0; i < hs; ++i) {
+                        h[i] = (1.0 - z[i]) * ht[i] + z[i] * h[i];
+                        (*Y)[((t * num_direction + nd) * c.batch + b) * hs + i] = h[i];
+                    }
+                }
+                for (int64_t i = 0; i < hs; ++i) {
+                    (*Y_h)[state_offset + i] = h[i];
+                }
+            }
+        }
+    }
+
+    static void Check(const vector<float>& expected, const vector<float>& result, const char* name) {
+        ASSERT_EQ(expected.size(), result.size());
+        for (uint64_t i = 0; i < expected.size(); ++i) {
+            ASSERT_NEAR(expected[i], result[i], 1e-4f) << name << " index " << i;
+        }
+    }
+
+    static void Run(const GruCase& c) {
+        const int64_t num_direction = c.direction == rnn_direction::BIDIRECTIONAL ? 2 : 1;
+        const int64_t hs = c.hidden_size;
+        const uint32_t seed = (uint32_t)(c.seq_len * 131 + c.hidden_size * 7 + c.direction);
+
+        auto X = RandomData(c.seq_len * c.batch * c.input_size, -1.0f, 1.0f, seed);
+        auto W = RandomData(num_direction * 3 * hs * c.input_size, -0.5f, 0.5f, seed + 1);
+        auto R = RandomData(num_direction * 3 * hs * hs, -0.5f, 0.5f, seed + 2);
+        auto B = RandomData(num_direction * 6 * hs, -0.5f, 0.5f, seed + 3);
+        auto initial_h = RandomData(num_direction * c.batch * hs, -1.0f, 1.0f, seed + 4);
+        vector<int32_t> sequence_lens(c.batch);
+        for (int64_t b = 0; b < c.batch; ++b) {
+            // includes full, partial and empty sequences
+            sequence_lens[b] = (int32_t)((c.seq_len - b * 2) > 0 ? (c.seq_len - b * 2) : 0);
+        }
+
+        const float* B_data = c.has_bias ? B.data() : nullptr;
+        const int32_t* lens_data = c.has_sequence_lens ? sequence_lens.data() : nullptr;
+        const float* init_h_data = c.has_initial_h ? initial_h.data() : nullptr;
+
+        vector<float> ref_Y, ref_Y_h;
+        RefGru(c, X, W, R, B_data, lens_data, init_h_data, &ref_Y, &ref_Y_h);
+
+        ppl::nn::TensorShape X_shape;
+        X_shape.Reshape({c.seq_len, c.batch, c.input_size});
+        X_shape.SetDataType(DATATYPE_FLOAT32);
+        X_shape.SetDataFormat(DATAFORMAT_NDARRAY);
+
+        auto impls = GetTestImpls();
+        for (auto impl = impls.begin(); impl != impls.end(); ++impl) {
+            vector<uint8_t> temp_buffer(impl->get_buffer_bytes(&X_shape, c.direction, hs, c.has_Y, c.has_Y_h));
+            // filled with garbage to check that every element of outputs is written
+            vector<float> Y(ref_Y.size(), NAN), Y_h(ref_Y_h.size(), NAN);
+            EXPECT_EQ(RC_SUCCESS,
+                      impl->func(&X_shape, X.data(), W.data(), R.data(), B_data, lens_data, init_h_data, c.direction,
+                                 hs, c.linear_before_reset, temp_buffer.data(), c.has_Y ? Y.data() : nullptr,
+                                 c.has_Y_h ? Y_h.data() : nullptr));
+            if (c.has_Y) {
+                Check(ref_Y, Y, impl->name);
+            }
+            if (c.has_Y_h) {
+                Check(ref_Y_h, Y_h, impl->name);
+            }
+        }
+    }
+};
+
+TEST_F(GruKernelTest, forward) {
+    Run({5, 3, 7, 19, rnn_direction::FORWARD, false, true, false, true, true, true});
+    Run({5, 3, 7, 19, rnn_direction::FORWARD, true, true, false, true, true, true});
+    // without bias or initial_h
+    Run({4, 2, 9, 16, rnn_direction::FORWARD, false, false, false, false, true, true});
+    Run({4, 2, 9, 16, rnn_direction::FORWARD, true, false, false, false, true, true});
+}
+
+TEST_F(GruKernelTest, reverse) {
+    Run({6, 2, 5, 21, rnn_direction::REVERSE, false, true, false, true, true, true});
+    Run({6, 2, 5, 21, rnn_direction::REVERSE, true, true, false, true, true, true});
+}
+
+TEST_F(GruKernelTest, bidirectional) {
+    Run({5, 3, 8, 35, rnn_direction::BIDIRECTIONAL, false, true, false, true, true, true});
+    Run({5, 3, 8, 35, rnn_direction::BIDIRECTIONAL, true, true, false, false, true, true});
+}
+
+TEST_F(GruKernelTest, sequence_lens) {
+    Run({7, 4, 5, 18, rnn_direction::FORWARD, false, true, true, true, true, true});
+    Run({7, 4, 5, 18, rnn_direction::BIDIRECTIONAL, true, true, true, true, true, true});
+}
+
+TEST_F(GruKernelTest, partial_outputs) {
+    Run({5, 2, 4, 20, rnn_direction::BIDIRECTIONAL, false, true, true, true, true, false});
+    Run({5, 2, 4, 20, rnn_direction::REVERSE, true, true, true, true, false, true});
+}
@@ -0,0 +1,208 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#if defined(PPLNN_USE_X86) && defined(PPLNN_ENABLE_ONNX_MODEL)
+
+#include "ppl/nn/engines/x86/engine_factory.h"
+#include "ppl/nn/engines/x86/ops.h"
+#include "ppl/nn/runtime/tensor_impl.h"
+#include "tests/models/onnx/onnx_model_builder.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <memory>
+#include <random>
+using namespace std;
+using namespace ppl::nn;
+using namespace ppl::common;
+using namespace ppl::nn::test;
+
+/*
+  in-place Concat/Split only take effect from the second run, so each case runs several times with different data.
+  shapes of slices([1, 4, 4, 4] fp32 is 256 bytes) are aligned to 64 bytes unless they are changed to be odd.
+*/
+class X86InplaceConcatSplitTest : public testing::Test {
+protected:
+    static void SetUpTestCase() {
+        x86::RegisterBuiltinOpImpls();
+    }
+
+    void SetUp() override {
+        engine_.reset(x86::EngineFactory::Create(x86::EngineOptions()));
+    }
+
+    Runtime* CreateRuntime(const OnnxModelBuilder& builder) {
+        auto engine = engine_.get();
+        return builder.CreateRuntime(&engine, 1);
+    }
+
+    static vector<float> RandomData(int64_t size, uint32_t seed) {
+        mt19937 gen(seed);
+        uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        vector<float> data(size);
+        for (int64_t i = 0; i < size; ++i) {
+            data[i] = dist(gen);
+        }
+        return data;
+    }
+
+    static vector<float> Relu(const vector<float>& data) {
+        vector<float> res(data.size());
+        for (uint64_t i = 0; i < data.size(); ++i) {
+            res[i] = std::max(data[i], 0.0f);
+        }
+        return res;
+    }
+
+    static void Check(const vector<float>& expected, const vector<float>& result) {
+        ASSERT_EQ(expected.size(), result.size());
+        for (uint64_t i = 0; i < expected.size(); ++i) {
+            ASSERT_EQ(expected[i], result[i]) << "index " << i;
+        }
+    }
+
+    /* y = Relu(Concat(Relu(a), Relu(b))), or Reshape(Concat(...), [1, -1]) if `reshape_output` is true */
+    Runtime* CreateConcatRuntime(bool reshape_output) {
+        OnnxModelBuilder builder;
+        auto graph = builder.GetGraph();
+        OnnxModelBuilder::AddInput(graph, "a", {1, 4, 4, 4});
+        OnnxModelBuilder::AddInput(graph, "b", {1, 4, 4, 4});
+        OnnxModelBuilder::AddNode(graph, "Relu", {"a"}, {"ra"});
+        OnnxModelBuilder::AddNode(graph, "Relu", {"b"}, {"rb"});
+        auto concat = OnnxModelBuilder::AddNode(graph, "Concat", {"ra", "rb"}, {"c"});
+        OnnxModelBuilder::SetAttr(concat, "axis", (int64_t)1);
+        if (reshape_output) {
+            OnnxModelBuilder::AddInitializer(graph, "shape", {2}, vector<int64_t>{1, -1});
+            OnnxModelBuilder::AddNode(graph, "Reshape", {"c", "shape"}, {"y"});
+        } else {
+            OnnxModelBuilder::AddNode(graph, "Relu", {"c"}, {"y"});
+        }
+        OnnxModelBuilder::AddOutput(graph, "y");
+        return CreateRuntime(builder);
+    }
+
+    static void RunConcat(Runtime* runtime, int64_t a_channels, int64_t b_channels, int64_t hw, uint32_t seed) {
+        SCOPED_TRACE("seed " + std::to_string(seed));
+        auto a = RandomData(a_channels * hw * hw, seed);
+        auto b = RandomData(b_channels * hw * hw, seed + 1);
+        SetTensorData(runtime->GetInputTensor(0), {1, a_channels, hw, hw}, a);
+        SetTensorData(runtime->GetInputTensor(1), {1, b_channels, hw, hw}, b);
+        ASSERT_EQ(RC_SUCCESS, runtime->Run());
+
+        vector<float> expected = Relu(a);
+        auto rb = Relu(b);
+        expected.insert(expected.end(), rb.begin(), rb.end());
+        Check(expected, GetTensorData(runtime->GetOutputTensor(0)));
+    }
+
+    /* y0, y1 = Relu(Split(Relu(x))), or Reshape(Split(...), [1, -1]) if `reshape_output` is true */
+    Runtime* CreateSplitRuntime(bool reshape_output) {
+        OnnxModelBuilder builder;
+        auto graph = builder.GetGraph();
+        OnnxModelBuilder::AddInput(graph, "x", {1, 8, 4, 4});
+        OnnxModelBuilder::AddNode(graph, "Relu", {"x"}, {"rx"});
+        auto split = OnnxModelBuilder::AddNode(graph, "Split", {"rx"}, {"s0", "s1"});
+        OnnxModelBuilder::SetAttr(split, "axis", (int64_t)1);
+        if (reshape_output) {
+            OnnxModelBuilder::AddInitializer(graph, "shape", {2}, vector<int64_t>{1, -1});
+            OnnxModelBuilder::AddNode(graph, "Reshape", {"s0", "shape"}, {"y0"});
+            OnnxModelBuilder::AddNode(graph, "Reshape", {"s1", "shape"}, {"y1"});
+        } else {
+            OnnxModelBuilder::AddNode(graph, "Relu", {"s0"}, {"y0"});
+            OnnxModelBuilder::AddNode(graph, "Relu", {"s1"}, {"y1"});
+        }
+        OnnxModelBuilder::AddOutput(graph, "y0");
+        OnnxModelBuilder::AddOutput(graph, "y1");
+        return CreateRuntime(builder);
+    }
+
+    static void RunSplit(Runtime* runtime, int64_t channels, int64_t hw, uint32_t seed) {
+        SCOPED_TRACE("seed " + std::to_string(seed));
+        auto x = RandomData(channels * hw * hw, seed);
+        SetTensorData(runtime->GetInputTensor(0), {1, channels, hw, hw}, x);
+        ASSERT_EQ(RC_SUCCESS, runtime->Run());
+
+        auto rx = Relu(x);
+        const uint64_t half = rx.size() / 2;
+        Check(vector<float>(rx.begin(), rx.begin() + half), GetTensorData(runtime->GetOutputTensor(0)));
+        Check(vector<float>(rx.begin() + half, rx.end()), GetTensorData(runtime->GetOutputTensor(1)));
+    }
+
+protected:
+    unique_ptr<Engine> engine_;
+};
+
+TEST_F(X86InplaceConcatSplitTest, concat) {
+    unique_ptr<Runtime> runtime(CreateConcatRuntime(false));
+    ASSERT_TRUE(runtime != nullptr);
+    for (uint32_t i = 0; i < 3; ++i) {
+        RunConcat(runtime.get(), 4, 4, 4, 10 * i);
+    }
+}
+
+TEST_F(X86InplaceConcatSplitTest, concat_slice_shape_changes) {
+    unique_ptr<Runtime> runtime(CreateConcatRuntime(false));
+    ASSERT_TRUE(runtime != nullptr);
+    RunConcat(runtime.get(), 4, 4, 4, 1);
+    RunConcat(runtime.get(), 4, 4, 4, 2);
+    // slices are moved and the buffer is reallocated
+    RunConcat(runtime.get(), 4, 12, 4, 3);
+    RunConcat(runtime.get(), 4, 12, 4, 4);
+    RunConcat(runtime.get(), 12, 4, 4, 5);
+    RunConcat(runtime.get(), 12, 4, 4, 6);
+    // slices are not aligned and inputs are copied
+    RunConcat(runtime.get(), 3, 5, 3, 7);
+    RunConcat(runtime.get(), 4, 4, 4, 8);
+    RunConcat(runtime.get(), 4, 4, 4, 9);
+}
+
+TEST_F(X86InplaceConcatSplitTest, concat_forwarded_to_output) {
+    // Reshape takes over the buffer of the Concat output, which must not be kept by the device
+    unique_ptr<Runtime> runtime(CreateConcatRuntime(true));
+    ASSERT_TRUE(runtime != nullptr);
+    for (uint32_t i = 0; i < 3; ++i) {
+        RunConcat(runtime.get(), 4, 4, 4, 10 * i);
+        EXPECT_TRUE(static_cast<TensorImpl*>(runtime->GetOutputTensor(0))->IsBufferOwner());
+    }
+}
+
+TEST_F(X86InplaceConcatSplitTest, split) {
+    unique_ptr<Runtime> runtime(CreateSplitRuntime(false));
+    ASSERT_TRUE(runtime != nullptr);
+    for (uint32_t i = 0; i < 3; ++i) {
+        RunSplit(runtime.get(), 8, 4, 10 * i);
+    }
+}
+
+TEST_F(X86InplaceConcatSplitTest, split_slice_shape_changes) {
+    unique_ptr<Runtime> runtime(CreateSplitRuntime(false));
+    ASSERT_TRUE(runtime != nullptr);
+    RunSplit(runtime.get(), 8, 4, 1);
+    RunSplit(runtime.get(), 16, 4, 2);
+    // slices are not aligned and outputs are copied
+    RunSplit(runtime.get(), 6, 3, 3);
+    RunSplit(runtime.get(), 8, 4, 4);
+}
+
+TEST_F(X86InplaceConcatSplitTest, split_forwarded_to_output) {
+    unique_ptr<Runtime> runtime(CreateSplitRuntime(true));
+    ASSERT_TRUE(runtime != nullptr);
+    for (uint32_t i = 0; i < 3; ++i) {
+        RunSplit(runtime.get(), 8, 4, 10 * i);
+    }
+}
+
+#endif
@@ -0,0 +1,245 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/kernel/x86/int8/conv2d.h"
+#include "ppl/kernel/x86/int8/quantize.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+using namespace std;
+using namespace ppl::common;
+using namespace ppl::kernel::x86;
+
+/*
+  int8 conv2d/fc are checked against float32 references computed with unquantized data. the error of each
+  output is bounded by the rounding errors of both operands: sum_k(|w| * src_scale / 2 + |x| * w_scale / 2 +
+  src_scale * w_scale / 4).
+*/
+class Int8KernelTest : public testing::Test {
+protected:
+    static vector<float> RandomData(uint64_t size, float lo, float hi, uint32_t seed) {
+        mt19937 gen(seed);
+        uniform_real_distribution<float> dist(lo, hi);
+        vector<float> data(size);
+        for (uint64_t i = 0; i < size; ++i) {
+            data[i] = dist(gen);
+        }
+        return data;
+    }
+
+    // reference, avx2 and avx512-vnni implementations if they are supported by this cpu
+    static vector<isa_t> GetTestIsas() {
+        vector<isa_t> isas = {ISA_X86_SSE};
+        const isa_t cpu_isa = GetCpuISA();
+        const isa_t avx2_isa = ISA_X86_AVX | ISA_X86_AVX2 | ISA_X86_FMA;
+        if ((cpu_isa & avx2_isa) == avx2_isa) {
+            isas.push_back(cpu_isa & (~(ISA_X86_AVX512 | ISA_X86_AVX512VNNI)));
+        }
+        if (cpu_isa & ISA_X86_AVX512VNNI) {
+            isas.push_back(cpu_isa);
+        }
+        return isas;
+    }
+
+    // quantizes `src` asymmetrically with the range of its values
+    static void QuantizeSrc(isa_t isa, const vector<int64_t>& dims, const vector<float>& src, vector<uint8_t>* dst,
+                            float* scale, int32_t* zero_point) {
+        const float min_val = std::min(0.0f, *min_element(src.begin(), src.end()));
+        const float max_val = std::max(0.0f, *max_element(src.begin(), src.end()));
+        *scale = (max_val - min_val) / 255.0f;
+        *zero_point = (int32_t)roundf(-min_val / *scale);
+
+        ppl::nn::TensorShape shape;
+        shape.Reshape(dims);
+        shape.SetDataType(DATATYPE_FLOAT32);
+        shape.SetDataFormat(DATAFORMAT_NDARRAY);
+        dst->resize(src.size());
+        EXPECT_EQ(RC_SUCCESS, quantize_fp32_u8(isa, &shape, src.data(), *scale, *zero_point, dst->data()));
+    }
+
+    static void Check(const vector<float>& expected, const vector<float>& bound, const vector<float>& result) {
+        ASSERT_EQ(expected.size(), result.size());
+        for (uint64_t i = 0; i < expected.size(); ++i) {
+            ASSERT_NEAR(expected[i], result[i], bound[i]) << "index " << i;
+        }
+    }
+};
+
+TEST_F(Int8KernelTest, conv2d) {
+    const int64_t batch = 2, channels = 12, num_output = 20, group = 2;
+    const int64_t src_h = 9, src_w = 11, kernel_h = 3, kernel_w = 3;
+    const int64_t stride = 2, pad = 1, dilation = 1;
+    const int64_t dst_h = (src_h + 2 * pad - dilation * (kernel_h - 1) - 1) / stride + 1;
+    const int64_t dst_w = (src_w + 2 * pad - dilation * (kernel_w - 1) - 1) / stride + 1;
+    const int64_t ic_per_gp = channels / group, oc_per_gp = num_output / group;
+
+    auto src = RandomData(batch * channels * src_h * src_w, -0.5f, 2.0f, 1);
+    auto weight = RandomData(num_output * ic_per_gp * kernel_h * kernel_w, -1.0f, 1.0f, 2);
+    auto bias = RandomData(num_output, -1.0f, 1.0f, 3);
+
+    conv2d_int8_param param;
+    param.kernel_h = kernel_h;
+    param.kernel_w = kernel_w;
+    param.stride_h = param.stride_w = stride;
+    param.pad_h = param.pad_w = pad;
+    param.dilation_h = param.dilation_w = dilation;
+    param.group = group;
+    param.channels = channels;
+    param.num_output = num_output;
+    param.post = gemm_post::RELU;
+
+    ppl::nn::TensorShape src_shape, dst_shape;
+    src_shape.Reshape({batch, channels, src_h, src_w});
+    src_shape.SetDataType(DATATYPE_UINT8);
+    src_shape.SetDataFormat(DATAFORMAT_NDARRAY);
+    dst_shape.Reshape({batch, num_output, dst_h, dst_w});
+    dst_shape.SetDataType(DATATYPE_FLOAT32);
+    dst_shape.SetDataFormat(DATAFORMAT_NDARRAY);
+
+    auto isas = GetTestIsas();
+    for (auto isa = isas.begin(); isa != isas.end(); ++isa) {
+        vector<uint8_t> q_src;
+        float src_scale;
+        int32_t src_zero_point;
+        QuantizeSrc(*isa, {batch, channels, src_h, src_w}, src, &q_src, &src_scale, &src_zero_point);
+
+        vector<int8_t> packed_weight(conv2d_int8_get_packed_weight_bytes(param));
+        vector<float> w_scale(num_output);
+        vector<int32_t> w_sum(num_output);
+        EXPECT_EQ(RC_SUCCESS,
+                  conv2d_int8_quantize_pack_weight(*isa, param, weight.data(), packed_weight.data(), w_scale.data(),
+                                                   w_sum.data()));
+        vector<float> scale(num_output);
+        for (int64_t oc = 0; oc < num_output; ++oc) {
+            scale[oc] = w_scale[oc] * src_scale;
+        }
+
+        vector<uint8_t> temp_buffer(conv2d_int8_get_temp_buffer_bytes(param, &dst_shape));
+        vector<float> dst(batch * num_output * dst_h * dst_w);
+        EXPECT_EQ(RC_SUCCESS,
+                  conv2d_int8(*isa, param, &src_shape, q_src.data(), src_zero_point, packed_weight.data(),
+                              w_sum.data(), scale.data(), bias.data(), &dst_shape, 0.0f, 0, temp_buffer.data(),
+                              dst.data()));
+
+        vector<float> expected(dst.size()), bound(dst.size());
+        for (int64_t b = 0; b < batch; ++b) {
+            for (int64_t oc = 0; oc < num_output; ++oc) {
+                const int64_t g = oc / oc_per_gp;
+                const float w_err = w_scale[oc] * 0.5f;
+                const float x_err = src_scale * 0.5f;
+                for (int64_t oh = 0; oh < dst_h; ++oh) {
+                    for (int64_t ow = 0; ow < dst_w; ++ow) {
+                        float sum = bias[oc];
+                        float err = 1e-4f;
+                        for (int64_t ic = 0; ic < ic_per_gp; ++ic) {
+                            for (int64_t kh = 0; kh < kernel_h; ++kh) {
+                                for (int64_t kw = 0; kw < kernel_w; ++kw) {
+                                    const int64_t ih = oh * stride - pad + kh * dilation;
+                                    const int64_t iw = ow * stride - pad + kw * dilation;
+                                    const float w = weight[((oc * ic_per_gp + ic) * kernel_h + kh) * kernel_w + kw];
+                                    float x = 0.0f;
+                                    if (ih >= 0 && ih < src_h && iw >= 0 && iw < src_w) {
+                                        x = src[((b * channels + g * ic_per_gp + ic) * src_h + ih) * src_w + iw];
+                                    }
+                                    sum += w * x;
+                                    err += fabsf(w) * x_err + fabsf(x) * w_err + x_err * w_err;
+                                }
+                            }
+                        }
+                        const int64_t idx = ((b * num_output + oc) * dst_h + oh) * dst_w + ow;
+                        expected[idx] = std::max(sum, 0.0f);
+                        bound[idx] = err;
+                    }
+                }
+            }
+        }
+        Check(expected, bound, dst);
+    }
+}
+
+TEST_F(Int8KernelTest, fc) {
+    // channels is not aligned to GEMM_S8U8_K_ALIGN, so that the input is packed
+    const int64_t batch = 5, channels = 70, num_output = 37;
+    auto src = RandomData(batch * channels, -2.0f, 1.0f, 4);
+    auto weight = RandomData(num_output * channels, -0.5f, 0.5f, 5);
+    auto bias = RandomData(num_output, -1.0f, 1.0f, 6);
+
+    const auto layout = gemm_s8u8_layout::LANE_A;
+    auto isas = GetTestIsas();
+    for (auto isa = isas.begin(); isa != isas.end(); ++isa) {
+        vector<uint8_t> q_src;
+        float src_scale;
+        int32_t src_zero_point;
+        QuantizeSrc(*isa, {batch, channels}, src, &q_src, &src_scale, &src_zero_point);
+
+        vector<int8_t> packed_weight(gemm_s8u8_get_packed_a_bytes(layout, num_output, channels));
+        vector<float> w_scale(num_output);
+        vector<int32_t> w_sum(num_output);
+        EXPECT_EQ(RC_SUCCESS,
+                  gemm_s8u8_quantize_pack_a(*isa, layout, weight.data(), num_output, channels, channels,
+                                            packed_weight.data(), w_scale.data(), w_sum.data()));
+        vector<float> scale(num_output);
+        for (int64_t oc = 0; oc < num_output; ++oc) {
+            scale[oc] = w_scale[oc] * src_scale;
+        }
+
+        gemm_s8u8_param param;
+        vector<uint8_t> packed_src(gemm_s8u8_get_packed_b_bytes(layout, batch, channels));
+        EXPECT_EQ(RC_SUCCESS,
+                  gemm_s8u8_pack_b_trans(layout, q_src.data(), batch, channels, channels, packed_src.data(),
+                                         &param.ldb));
+
+        vector<float> dst(batch * num_output);
+        param.layout = layout;
+        param.packed_a = packed_weight.data();
+        param.packed_b = packed_src.data();
+        param.scale = scale.data();
+        param.bias = bias.data();
+        param.a_sum = w_sum.data();
+        param.M = num_output;
+        param.N = batch;
+        param.K = channels;
+        param.ldc = num_output;
+        param.b_zero_point = src_zero_point;
+        param.post = gemm_post::NONE;
+        param.c_type = DATATYPE_FLOAT32;
+        param.c_scale = 1.0f;
+        param.c_zero_point = 0;
+        param.C = dst.data();
+        EXPECT_EQ(RC_SUCCESS, gemm_s8u8(*isa, param));
+
+        vector<float> expected(dst.size()), bound(dst.size());
+        for (int64_t n = 0; n < batch; ++n) {
+            for (int64_t oc = 0; oc < num_output; ++oc) {
+                float sum = bias[oc];
+                float err = 1e-4f;
+                for (int64_t k = 0; k < channels; ++k) {
+                    const float w = weight[oc * channels + k];
+                    const float x = src[n * channels + k];
+                    sum += w * x;
+                    err += fabsf(w) * src_scale * 0.5f + fabsf(x) * w_scale[oc] * 0.5f +
+                        src_scale * w_scale[oc] * 0.25f;
+                }
+                expected[n * num_output + oc] = sum;
+                bound[n * num_output + oc] = err;
+            }
+        }
+        Check(expected, bound, dst);
+    }
+}
@@ -0,0 +1,159 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#if defined(PPLNN_USE_X86) && defined(PPLNN_ENABLE_ONNX_MODEL)
+
+#include "ppl/nn/engines/x86/engine_factory.h"
+#include "ppl/nn/engines/x86/ops.h"
+#include "tests/models/onnx/onnx_model_builder.h"
+#include "gtest/gtest.h"
+#include <memory>
+using namespace std;
+using namespace ppl::nn;
+using namespace ppl::common;
+using namespace ppl::nn::test;
+
+class X86LoopTest : public testing::Test {
+protected:
+    static void SetUpTestCase() {
+        x86::RegisterBuiltinOpImpls();
+    }
+
+    void SetUp() override {
+        engine_.reset(x86::EngineFactory::Create(x86::EngineOptions()));
+    }
+
+    /*
+      for i in range(M):
+          x = loop_body(x)          # loop-carried
+          scan_y.append(x * 2)      # produced in the body, written into the scan buffer in place
+          scan_x.append(x_in)       # input of the body, copied
+      loop_body is `x + 1`, or `concat(x, [1])` if `grow` is true, whose scan output changes its shape.
+    */
+    Runtime* CreateRuntime(bool grow) {
+        OnnxModelBuilder builder;
+        auto graph = builder.GetGraph();
+        OnnxModelBuilder::AddInput(graph, "M", {}, ::onnx::TensorProto_DataType_INT64);
+        OnnxModelBuilder::AddInput(graph, "x0", {2, 3});
+        OnnxModelBuilder::AddInitializer(graph, "cond", {}, vector<uint8_t>{1}, ::onnx::TensorProto_DataType_BOOL);
+
+        ::onnx::GraphProto body;
+        body.set_name("body");
+        OnnxModelBuilder::AddInput(&body, "iter", {}, ::onnx::TensorProto_DataType_INT64);
+        OnnxModelBuilder::AddInput(&body, "cond_in", {}, ::onnx::TensorProto_DataType_BOOL);
+        OnnxModelBuilder::AddInput(&body, "x_in", {});
+        OnnxModelBuilder::AddInitializer(&body, "one", {1}, vector<float>{1.0f});
+        OnnxModelBuilder::AddInitializer(&body, "two", {1}, vector<float>{2.0f});
+        if (grow) {
+            OnnxModelBuilder::AddInitializer(&body, "row", {1, 3}, vector<float>{1.0f, 1.0f, 1.0f});
+            auto concat = OnnxModelBuilder::AddNode(&body, "Concat", {"x_in", "row"}, {"x_out"});
+            OnnxModelBuilder::SetAttr(concat, "axis", (int64_t)0);
+        } else {
+            OnnxModelBuilder::AddNode(&body, "Add", {"x_in", "one"}, {"x_out"});
+        }
+        OnnxModelBuilder::AddNode(&body, "Mul", {"x_out", "two"}, {"y_out"});
+        OnnxModelBuilder::AddNode(&body, "Identity", {"cond_in"}, {"cond_out"});
+        OnnxModelBuilder::AddOutput(&body, "cond_out", ::onnx::TensorProto_DataType_BOOL);
+        OnnxModelBuilder::AddOutput(&body, "x_out");
+        OnnxModelBuilder::AddOutput(&body, "y_out");
+        OnnxModelBuilder::AddOutput(&body, "x_in");
+
+        auto loop = OnnxModelBuilder::AddNode(graph, "Loop", {"M", "cond", "x0"}, {"x", "scan_y", "scan_x"});
+        OnnxModelBuilder::SetAttr(loop, "body", body);
+        OnnxModelBuilder::AddOutput(graph, "x");
+        OnnxModelBuilder::AddOutput(graph, "scan_y");
+        OnnxModelBuilder::AddOutput(graph, "scan_x");
+
+        auto engine = engine_.get();
+        return builder.CreateRuntime(&engine, 1);
+    }
+
+    static void SetTripCount(Tensor* tensor, int64_t trip_count) {
+        auto shape = tensor->GetShape();
+        shape->Reshape({});
+        shape->SetDataType(DATATYPE_INT64);
+        shape->SetDataFormat(DATAFORMAT_NDARRAY);
+        EXPECT_EQ(RC_SUCCESS, tensor->ReallocBuffer());
+        EXPECT_EQ(RC_SUCCESS, tensor->CopyFromHost(&trip_count));
+    }
+
+    static vector<int64_t> GetDims(const Tensor* tensor) {
+        auto shape = tensor->GetShape();
+        vector<int64_t> dims(shape->GetDimCount());
+        for (uint32_t i = 0; i < shape->GetDimCount(); ++i) {
+            dims[i] = shape->GetDim(i);
+        }
+        return dims;
+    }
+
+    static void RunAndCheck(Runtime* runtime, int64_t trip_count) {
+        const vector<float> x0 = {0.5f, -1.0f, 2.0f, 3.5f, 0.0f, -2.5f};
+        SetTripCount(runtime->GetInputTensor(0), trip_count);
+        SetTensorData(runtime->GetInputTensor(1), {2, 3}, x0);
+        ASSERT_EQ(RC_SUCCESS, runtime->Run());
+
+        auto x = GetTensorData(runtime->GetOutputTensor(0));
+        auto scan_y = GetTensorData(runtime->GetOutputTensor(1));
+        auto scan_x = GetTensorData(runtime->GetOutputTensor(2));
+        EXPECT_EQ((vector<int64_t>{trip_count, 2, 3}), GetDims(runtime->GetOutputTensor(1)));
+        EXPECT_EQ((vector<int64_t>{trip_count, 2, 3}), GetDims(runtime->GetOutputTensor(2)));
+        ASSERT_EQ(x0.size(), x.size());
+        ASSERT_EQ(trip_count * x0.size(), scan_y.size());
+        ASSERT_EQ(trip_count * x0.size(), scan_x.size());
+
+        for (uint32_t j = 0; j < x0.size(); ++j) {
+            EXPECT_FLOAT_EQ(x0[j] + trip_count, x[j]) << "index " << j;
+        }
+        for (int64_t i = 0; i < trip_count; ++i) {
+            for (uint32_t j = 0; j < x0.size(); ++j) {
+                EXPECT_FLOAT_EQ((x0[j] + i + 1) * 2.0f, scan_y[i * x0.size() + j]) << "iter " << i << " index " << j;
+                EXPECT_FLOAT_EQ(x0[j] + i, scan_x[i * x0.size() + j]) << "iter " << i << " index " << j;
+            }
+        }
+    }
+
+protected:
+    unique_ptr<Engine> engine_;
+};
+
+TEST_F(X86LoopTest, scan_outputs) {
+    unique_ptr<Runtime> runtime(CreateRuntime(false));
+    ASSERT_TRUE(runtime != nullptr);
+    // buffers of scan outputs grow from 4 to 16 iterations
+    RunAndCheck(runtime.get(), 11);
+    // reuses the subgraph whose outputs were bound to buffers of the last run
+    RunAndCheck(runtime.get(), 3);
+    RunAndCheck(runtime.get(), 1);
+}
+
+TEST_F(X86LoopTest, reject_changing_scan_shape) {
+    unique_ptr<Runtime> runtime(CreateRuntime(true));
+    ASSERT_TRUE(runtime != nullptr);
+
+    // one iteration has nothing to compare with
+    SetTripCount(runtime->GetInputTensor(0), 1);
+    SetTensorData(runtime->GetInputTensor(1), {2, 3}, vector<float>(6, 1.0f));
+    EXPECT_EQ(RC_SUCCESS, runtime->Run());
+    EXPECT_EQ((vector<int64_t>{1, 3, 3}), GetDims(runtime->GetOutputTensor(1)));
+
+    // outputs of the second iteration are larger than the slots of the first one
+    SetTripCount(runtime->GetInputTensor(0), 6);
+    SetTensorData(runtime->GetInputTensor(1), {2, 3}, vector<float>(6, 1.0f));
+    EXPECT_NE(RC_SUCCESS, runtime->Run());
+}
+
+#endif
@@ -0,0 +1,237 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/kernel/x86/fp32/lstm.h"
+#include "gtest/gtest.h"
+#include <cmath>
+#include <random>
+#include <vector>
+using namespace std;
+using namespace ppl::common;
+using namespace ppl::kernel::x86;
+
+struct LstmCase {
+    int64_t seq_len;
+    int64_t batch;
+    int64_t input_size;
+    int64_t hidden_size;
+    rnn_direction_t direction;
+    bool has_bias;
+    bool has_peephole;
+    bool has_sequence_lens;
+    bool has_initial_state;
+    bool has_Y;
+    bool has_Y_h;
+    bool has_Y_c;
+};
+
+typedef uint64_t (*lstm_get_buffer_bytes_func_t)(const ppl::nn::TensorShape*, const rnn_direction_t, const int64_t,
+                                                 const bool, const bool, const bool);
+typedef RetCode (*lstm_func_t)(const ppl::nn::TensorShape*, const float*, const float*, const float*, const float*,
+                               const float*, const int32_t*, const float*, const float*, const rnn_direction_t,
+                               const int64_t, void*, float*, float*, float*);
+
+struct LstmImpl {
+    const char* name;
+    isa_t isa;
+    lstm_get_buffer_bytes_func_t get_buffer_bytes;
+    lstm_func_t func;
+};
+
+/*
+  lstm kernels are checked against a scalar implementation of the onnx definition in double. padded steps of
+  sequence_lens keep the states and output zeros in Y. the reverse direction starts from the last valid step.
+*/
+class LstmKernelTest : public testing::Test {
+protected:
+    static vector<float> RandomData(uint64_t size, float lo, float hi, uint32_t seed) {
+        mt19937 gen(seed);
+        uniform_real_distribution<float> dist(lo, hi);
+        vector<float> data(size);
+        for (uint64_t i = 0; i < size; ++i) {
+            data[i] = dist(gen);
+        }
+        return data;
+    }
+
+    static vector<LstmImpl> GetTestImpls() {
+        vector<LstmImpl> impls = {
+            {"ref", ISA_X86_SSE, lstm_fp32_ref_get_buffer_bytes, lstm_fp32_ref},
+            {"fma", ISA_X86_AVX | ISA_X86_FMA, lstm_fp32_fma_get_buffer_bytes, lstm_fp32_fma},
+#ifdef PPL_USE_X86_AVX512
+            {"avx512", ISA_X86_AVX512, lstm_fp32_avx512_get_buffer_bytes, lstm_fp32_avx512},
+#endif
+        };
+        vector<LstmImpl> supported;
+        for (auto it = impls.begin(); it != impls.end(); ++it) {
+            if ((GetCpuISA() & it->isa) == it->isa) {
+                supported.push_back(*it);
+            }
+        }
+        return supported;
+    }
+
+    static double Sigmoid(double x) {
+        return 1.0 / (1.0 + exp(-x));
+    }
+
+    static void RefLstm(const LstmCase& c, const vector<float>& X, const vector<float>& W, const vector<float>& R,
+                        const float* B, const float* P, const int32_t* sequence_lens, const float* initial_h,
+                        const float* initial_c, vector<float>* Y, vector<float>* Y_h, vector<float>* Y_c) {
+        const int64_t num_direction = c.direction == rnn_direction::BIDIRECTIONAL ? 2 : 1;
+        const int64_t hs = c.hidden_size;
+        Y->assign(c.seq_len * num_direction * c.batch * hs, 0.0f);
+        Y_h->assign(num_direction * c.batch * hs, 0.0f);
+        Y_c->assign(num_direction * c.batch * hs, 0.0f);
+
+        for (int64_t nd = 0; nd < num_direction; ++nd) {
+            const bool is_reverse = nd || c.direction == rnn_direction::REVERSE;
+            for (int64_t b = 0; b < c.batch; ++b) {
+                vector<double> h(hs, 0.0), cell(hs, 0.0), gates(4 * hs);
+                const int64_t state_offset = (nd * c.batch + b) * hs;
+                for (int64_t i = 0; i < hs; ++i) {
+                    h[i] = initial_h ? initial_h[state_offset + i] : 0.0;
+                    cell[i] = initial_c ? initial_c[state_offset + i] : 0.0;
+                }
+                const int64_t valid_len = sequence_lens ? sequence_lens[b] : c.seq_len;
+                for (int64_t s = 0; s < valid_len; ++s) {
+                    const int64_t t = is_reverse ? valid_len - 1 - s : s;
+                    const float* x = X.data() + (t * c.batch + b) * c.input_size;
+                    // gates in the order of i, o, f, c
+                    for (int64_t g = 0; g < 4 * hs; ++g) {
+                        const float* w = W.data() + (nd * 4 * hs + g) * c.input_size;
+                        const float* r = R.data() + (nd * 4 * hs + g) * hs;
+                        double sum = B ? (double)B[nd * 8 * hs + g] + B[nd * 8 * hs + 4 * hs + g] : 0.0;
+                        for (int64_t k = 0; k < c.input_size; ++k) {
+                            sum += (double)x[k] * w[k];
+                        }
+                        for (int64_t k = 0; k < hs; ++k) {
+                            sum += h[k] * r[k];
+                        }
+                        gates[g] = sum;
+                    }
+                    const float* p = P ? P + nd * 3 * hs : nullptr;
+                    for (int64_t i = 0; i < hs; ++i) {
+                        const double it = Sigmoid(gates[i] + (p ? p[i] * cell[i] : 0.0));
+                        const double ft = Sigmoid(gates[2 * hs + i] + (p ? p[2 * hs + i] * cell[i] : 0.0));
+                        const double ct = tanh(gates[3 * hs + i]);
+                        cell[i] = ft * cell[i] + it * ct;
+                        const double ot = Sigmoid(gates[hs + i] + (p ? p[hs + i] * cell[i] : 0.0));
+                        h[i] = ot * tanh(cell[i]);
+                        (*Y)[((t * num_direction + nd) * c.batch + b) * hs + i] = h[i];
+                    }
+                }
+                for (int64_t i = 0; i < hs; ++i) {
+                    (*Y_h)[state_offset + i] = h[i];
+                    (*Y_c)[state_offset + i] = cell[i];
+                }
+            }
+        }
+    }
+
+    static void Check(const vector<float>& expected, const vector<float>& result, const char* name) {
+        ASSERT_EQ(expected.size(), result.size());
+        for (uint64_t i = 0; i < expected.size(); ++i) {
+            ASSERT_NEAR(expected[i], result[i], 1e-4f) << name << " index " << i;
+        }
+    }
+
+    static void Run(const LstmCase& c) {
+        const int64_t num_direction = c.direction == rnn_direction::BIDIRECTIONAL ? 2 : 1;
+        const int64_t hs = c.hidden_size;
+        const uint32_t seed = (uint32_t)(c.seq_len * 131 + c.hidden_size * 7 + c.direction);
+
+        auto X = RandomData(c.seq_len * c.batch * c.input_size, -1.0f, 1.0f, seed);
+        auto W = RandomData(num_direction * 4 * hs * c.input_size, -0.5f, 0.5f, seed + 1);
+        auto R = RandomData(num_direction * 4 * hs * hs, -0.5f, 0.5f, seed + 2);
+        auto B = RandomData(num_direction * 8 * hs, -0.5f, 0.5f, seed + 3);
+        auto P = RandomData(num_direction * 3 * hs, -0.5f, 0.5f, seed + 4);
+        auto initial_h = RandomData(num_direction * c.batch * hs, -1.0f, 1.0f, seed + 5);
+        auto initial_c = RandomData(num_direction * c.batch * hs, -1.0f, 1.0f, seed + 6);
+        vector<int32_t> sequence_lens(c.batch);
+        for (int64_t b = 0; b < c.batch; ++b) {
+            // includes full, partial and empty sequences
+            sequence_lens[b] = (int32_t)((c.seq_len - b * 2) > 0 ? (c.seq_len - b * 2) : 0);
+        }
+
+        const float* B_data = c.has_bias ? B.data() : nullptr;
+        const float* P_data = c.has_peephole ? P.data() : nullptr;
+        const int32_t* lens_data = c.has_sequence_lens ? sequence_lens.data() : nullptr;
+        const float* init_h_data = c.has_initial_state ? initial_h.data() : nullptr;
+        const float* init_c_data = c.has_initial_state ? initial_c.data() : nullptr;
+
+        vector<float> ref_Y, ref_Y_h, ref_Y_c;
+        RefLstm(c, X, W, R, B_data, P_data, lens_data, init_h_data, init_c_data, &ref_Y, &ref_Y_h, &ref_Y_c);
+
+        ppl::nn::TensorShape X_shape;
+        X_shape.Reshape({c.seq_len, c.batch, c.input_size});
+        X_shape.SetDataType(DATATYPE_FLOAT32);
+        X_shape.SetDataFormat(DATAFORMAT_NDARRAY);
+
+        auto impls = GetTestImpls();
+        for (auto impl = impls.begin(); impl != impls.end(); ++impl) {
+            vector<uint8_t> temp_buffer(
+                impl->get_buffer_bytes(&X_shape, c.direction, hs, c.has_Y, c.has_Y_h, c.has_Y_c));
+            // filled with garbage to check that every element of outputs is written
+            vector<float> Y(ref_Y.size(), NAN), Y_h(ref_Y_h.size(), NAN), Y_c(ref_Y_c.size(), NAN);
+            EXPECT_EQ(RC_SUCCESS,
+                      impl->func(&X_shape, X.data(), W.data(), R.data(), P_data, B_data, lens_data, init_h_data,
+                                 init_c_data, c.direction, hs, temp_buffer.data(), c.has_Y ? Y.data() : nullptr,
+                                 c.has_Y_h ? Y_h.data() : nullptr, c.has_Y_c ? Y_c.data() : nullptr));
+            if (c.has_Y) {
+                Check(ref_Y, Y, impl->name);
+            }
+            if (c.has_Y_h) {
+                Check(ref_Y_h, Y_h, impl->name);
+            }
+            if (c.has_Y_c) {
+                Check(ref_Y_c, Y_c, impl->name);
+            }
+        }
+    }
+};
+
+TEST_F(LstmKernelTest, forward) {
+    Run({5, 3, 7, 19, rnn_direction::FORWARD, true, false, false, true, true, true, true});
+    // without bias or initial states
+    Run({4, 2, 9, 16, rnn_direction::FORWARD, false, false, false, false, true, true, true});
+}
+
+TEST_F(LstmKernelTest, reverse) {
+    Run({6, 2, 5, 21, rnn_direction::REVERSE, true, false, false, true, true, true, true});
+}
+
+TEST_F(LstmKernelTest, bidirectional) {
+    Run({5, 3, 8, 35, rnn_direction::BIDIRECTIONAL, true, false, false, true, true, true, true});
+}
+
+TEST_F(LstmKernelTest, peephole) {
+    Run({4, 3, 6, 17, rnn_direction::FORWARD, true, true, false, true, true, true, true});
+    Run({4, 2, 6, 33, rnn_direction::BIDIRECTIONAL, true, true, false, false, true, true, true});
+}
+
+TEST_F(LstmKernelTest, sequence_lens) {
+    Run({7, 4, 5, 18, rnn_direction::FORWARD, true, false, true, true, true, true, true});
+    Run({7, 4, 5, 18, rnn_direction::BIDIRECTIONAL, true, true, true, true, true, true, true});
+}
+
+TEST_F(LstmKernelTest, partial_outputs) {
+    // internal states are kept in the temp buffer if Y_h or Y_c is omitted
+    Run({5, 2, 4, 20, rnn_direction::BIDIRECTIONAL, true, true, false, true, true, false, false});
+    Run({5, 2, 4, 20, rnn_direction::FORWARD, true, false, true, true, false, true, false});
+    Run({5, 2, 4, 20, rnn_direction::REVERSE, true, false, true, true, false, false, true});
+}
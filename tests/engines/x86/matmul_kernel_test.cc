@@ -0,0 +1,139 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/kernel/x86/fp32/matmul.h"
+#include "gtest/gtest.h"
+#include <cmath>
+#include <string>
+#include <vector>
+#include <random>
+using namespace std;
+using namespace ppl::common;
+using namespace ppl::kernel::x86;
+
+/*
+  matmul_ndarray_packed_b_fp32 is checked against matmul_ndarray_fp32 of the same isa. B is packed the way
+  MatMulOp::TryPackConstantB does, including the sse fallback used by devices without fma.
+*/
+class MatMulKernelTest : public testing::Test {
+protected:
+    static vector<float> RandomData(uint64_t size, float lo, float hi, uint32_t seed) {
+        mt19937 gen(seed);
+        uniform_real_distribution<float> dist(lo, hi);
+        vector<float> data(size);
+        for (uint64_t i = 0; i < size; ++i) {
+            data[i] = dist(gen);
+        }
+        return data;
+    }
+
+    // sse, fma and avx512 implementations if they are supported by this cpu
+    static vector<isa_t> GetTestIsas() {
+        vector<isa_t> isas;
+        const isa_t cpu_isa = GetCpuISA();
+        isas.push_back(cpu_isa & (~(ISA_X86_AVX512 | ISA_X86_FMA | ISA_X86_AVX)));
+        const isa_t fma_isa = ISA_X86_AVX | ISA_X86_FMA;
+        if ((cpu_isa & fma_isa) == fma_isa) {
+            isas.push_back(cpu_isa & (~ISA_X86_AVX512));
+        }
+#ifdef PPL_USE_X86_AVX512
+        if (cpu_isa & ISA_X86_AVX512) {
+            isas.push_back(cpu_isa);
+        }
+#endif
+        return isas;
+    }
+
+    static ppl::nn::TensorShape MakeShape(const vector<int64_t>& dims) {
+        ppl::nn::TensorShape shape;
+        shape.Reshape(dims);
+        shape.SetDataType(DATATYPE_FLOAT32);
+        shape.SetDataFormat(DATAFORMAT_NDARRAY);
+        return shape;
+    }
+};
+
+struct MatMulCase {
+    vector<int64_t> a_dims;
+    vector<int64_t> b_dims;
+    vector<int64_t> y_dims;
+};
+
+TEST_F(MatMulKernelTest, packed_b_vs_ndarray) {
+    /*
+      fma and avx512 pack 24 and 48 columns of B in a block, so N = 19, 40 and 53 leave partial blocks. batch
+      dims of A are folded into M by the packed path while matmul_ndarray_fp32 broadcasts B over them.
+    */
+    const vector<MatMulCase> cases = {
+        {{5, 29}, {29}, {5}},
+        {{2, 3, 7, 29}, {29}, {2, 3, 7}},
+        {{17}, {17, 5}, {5}},
+        {{4, 29}, {1, 1, 29, 19}, {1, 1, 4, 19}},
+        {{2, 3, 7, 29}, {1, 29, 40}, {2, 3, 7, 40}},
+        {{3, 5, 17}, {17, 53}, {3, 5, 53}},
+        {{6, 64}, {64, 48}, {6, 48}},
+    };
+
+    uint32_t seed = 1;
+    auto isas = GetTestIsas();
+    for (auto c = cases.begin(); c != cases.end(); ++c) {
+        auto a_shape = MakeShape(c->a_dims);
+        auto b_shape = MakeShape(c->b_dims);
+        auto y_shape = MakeShape(c->y_dims);
+        const int64_t K = c->a_dims.back();
+        const int64_t N = c->b_dims.size() == 1 ? 1 : c->b_dims.back();
+        ASSERT_EQ(K * N, (int64_t)b_shape.GetElementsExcludingPadding());
+
+        auto A = RandomData(a_shape.GetElementsExcludingPadding(), -1.0f, 1.0f, seed++);
+        auto B = RandomData(b_shape.GetElementsExcludingPadding(), -1.0f, 1.0f, seed++);
+
+        for (auto isa = isas.begin(); isa != isas.end(); ++isa) {
+            const string name = "isa " + to_string(*isa) + " case " + to_string(c - cases.begin());
+
+            vector<uint8_t> temp_buffer(matmul_ndarray_fp32_get_buffer_bytes(&a_shape, &b_shape, *isa));
+            vector<float> expected(y_shape.GetElementsExcludingPadding());
+            ASSERT_EQ(RC_SUCCESS,
+                      matmul_ndarray_fp32(&a_shape, &b_shape, &y_shape, A.data(), B.data(), *isa,
+                                          temp_buffer.data(), expected.data()))
+                << name;
+
+            vector<float> packed_B(matmul_ndarray_fp32_get_packed_b_bytes(*isa, N, K) / sizeof(float));
+            ASSERT_EQ(RC_SUCCESS, matmul_ndarray_fp32_pack_b(*isa, B.data(), N, K, packed_B.data())) << name;
+            vector<float> Y(expected.size(), NAN);
+            ASSERT_EQ(RC_SUCCESS,
+                      matmul_ndarray_packed_b_fp32(&a_shape, A.data(), packed_B.data(), N, K, *isa, Y.data()))
+                << name;
+
+            for (uint64_t i = 0; i < Y.size(); ++i) {
+                ASSERT_NEAR(expected[i], Y[i], 1e-4f) << name << " index " << i;
+            }
+        }
+    }
+}
+
+TEST_F(MatMulKernelTest, packed_b_rejects_mismatched_k) {
+    const int64_t N = 7, K = 13;
+    auto a_shape = MakeShape({3, K + 1});
+    auto A = RandomData(3 * (K + 1), -1.0f, 1.0f, 1);
+    auto B = RandomData(K * N, -1.0f, 1.0f, 2);
+
+    const isa_t isa = GetCpuISA();
+    vector<float> packed_B(matmul_ndarray_fp32_get_packed_b_bytes(isa, N, K) / sizeof(float));
+    ASSERT_EQ(RC_SUCCESS, matmul_ndarray_fp32_pack_b(isa, B.data(), N, K, packed_B.data()));
+    vector<float> Y(3 * N);
+    EXPECT_EQ(RC_INVALID_VALUE, matmul_ndarray_packed_b_fp32(&a_shape, A.data(), packed_B.data(), N, K, isa, Y.data()));
+}
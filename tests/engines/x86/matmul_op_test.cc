@@ -0,0 +1,137 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#if defined(PPLNN_USE_X86) && defined(PPLNN_ENABLE_ONNX_MODEL)
+
+#include "ppl/nn/engines/x86/engine_factory.h"
+#include "ppl/nn/engines/x86/ops.h"
+#include "ppl/nn/models/onnx/runtime_builder_factory.h"
+#include "ppl/nn/runtime/runtime.h"
+#include "tests/models/onnx/onnx_model_builder.h"
+#include "gtest/gtest.h"
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+using namespace std;
+using namespace ppl::nn;
+using namespace ppl::common;
+using namespace ppl::nn::test;
+
+/*
+  constant B of MatMul is packed by MatMulOp and multiplied with all rows of A at once. outputs are checked against
+  a matmul evaluated on host, with B broadcast over the batch dims of A.
+*/
+class X86MatMulOpTest : public testing::Test {
+protected:
+    static void SetUpTestCase() {
+        x86::RegisterBuiltinOpImpls();
+    }
+
+    static vector<float> RandomData(uint64_t size, uint32_t seed) {
+        mt19937 gen(seed);
+        uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        vector<float> data(size);
+        for (uint64_t i = 0; i < size; ++i) {
+            data[i] = dist(gen);
+        }
+        return data;
+    }
+
+    static uint64_t CountElements(const vector<int64_t>& dims) {
+        uint64_t count = 1;
+        for (auto d = dims.begin(); d != dims.end(); ++d) {
+            count *= *d;
+        }
+        return count;
+    }
+
+    // runs MatMul(a, b) where b is an initializer, returns outputs of the runtime
+    static vector<float> Run(Engine* engine, const vector<int64_t>& a_dims, const vector<float>& a,
+                             const vector<int64_t>& b_dims, const vector<float>& b) {
+        OnnxModelBuilder model;
+        auto graph = model.GetGraph();
+        OnnxModelBuilder::AddInput(graph, "a", a_dims);
+        OnnxModelBuilder::AddInitializer(graph, "b", b_dims, b);
+        OnnxModelBuilder::AddNode(graph, "MatMul", {"a", "b"}, {"y"});
+        OnnxModelBuilder::AddOutput(graph, "y");
+
+        unique_ptr<ppl::nn::onnx::RuntimeBuilder> builder(ppl::nn::onnx::RuntimeBuilderFactory::Create());
+        auto buf = model.Serialize();
+        EXPECT_EQ(RC_SUCCESS, builder->Init(buf.data(), buf.size(), &engine, 1));
+        EXPECT_EQ(RC_SUCCESS, builder->Preprocess());
+        unique_ptr<Runtime> runtime(builder->CreateRuntime());
+        if (!runtime) {
+            ADD_FAILURE() << "create runtime failed";
+            return vector<float>();
+        }
+
+        SetTensorData(runtime->GetInputTensor(0), a_dims, a);
+        EXPECT_EQ(RC_SUCCESS, runtime->Run());
+        return GetTensorData(runtime->GetOutputTensor(0));
+    }
+};
+
+TEST_F(X86MatMulOpTest, constant_b) {
+    struct Case {
+        vector<int64_t> a_dims;
+        vector<int64_t> b_dims;
+    };
+    // 1-D B, B with leading 1s, and N that is not a multiple of 24 or 48
+    const vector<Case> cases = {
+        {{5, 29}, {29}},
+        {{2, 3, 7, 29}, {1, 29, 40}},
+        {{4, 29}, {1, 1, 29, 19}},
+        {{3, 5, 17}, {17, 53}},
+    };
+    const bool disable_avx_fma3[] = {false, true};
+
+    uint32_t seed = 1;
+    for (auto c = cases.begin(); c != cases.end(); ++c) {
+        const int64_t K = c->a_dims.back();
+        const int64_t N = c->b_dims.size() == 1 ? 1 : c->b_dims.back();
+        const int64_t M = CountElements(c->a_dims) / K;
+        auto a = RandomData(M * K, seed++);
+        auto b = RandomData(K * N, seed++);
+
+        vector<double> expected(M * N, 0.0);
+        for (int64_t m = 0; m < M; ++m) {
+            for (int64_t n = 0; n < N; ++n) {
+                for (int64_t k = 0; k < K; ++k) {
+                    expected[m * N + n] += (double)a[m * K + k] * b[k * N + n];
+                }
+            }
+        }
+
+        for (uint32_t d = 0; d < sizeof(disable_avx_fma3) / sizeof(disable_avx_fma3[0]); ++d) {
+            unique_ptr<Engine> engine(x86::EngineFactory::Create(x86::EngineOptions()));
+            if (disable_avx_fma3[d]) {
+                ASSERT_EQ(RC_SUCCESS, engine->Configure(x86::ENGINE_CONF_DISABLE_AVX_FMA3));
+            }
+            auto result = Run(engine.get(), c->a_dims, a, c->b_dims, b);
+
+            const string name = "case " + to_string(c - cases.begin()) + " disable_avx_fma3 " +
+                to_string(disable_avx_fma3[d]);
+            ASSERT_EQ(expected.size(), result.size()) << name;
+            for (uint64_t i = 0; i < expected.size(); ++i) {
+                ASSERT_NEAR(expected[i], result[i], 1e-4) << name << " index " << i;
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,212 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/kernel/x86/fp32/nms.h"
+#include "ppl/kernel/x86/fp32/mmcv_nms.h"
+#include "gtest/gtest.h"
+#include <random>
+#include <string>
+#include <vector>
+using namespace std;
+using namespace ppl::common;
+using namespace ppl::kernel::x86;
+
+/*
+  the greedy and the bitmask paths of the parallel nms kernels are checked against the scalar kernels, which are
+  the references of results. number of boxes covers tails of fewer than 8 or 16 boxes of simd iou kernels.
+*/
+class NmsKernelTest : public testing::Test {
+protected:
+    // overlapping boxes around a few centers so that some of them are suppressed
+    static vector<float> RandomBoxes(int64_t batch, int64_t num_boxes, bool center_point_box, bool mmcv,
+                                     uint32_t seed) {
+        mt19937 gen(seed);
+        uniform_real_distribution<float> center(0.0f, 40.0f);
+        uniform_real_distribution<float> size(2.0f, 16.0f);
+        uniform_real_distribution<float> jitter(-3.0f, 3.0f);
+        vector<float> boxes(batch * num_boxes * 4);
+        float cx = 0.0f, cy = 0.0f;
+        for (int64_t i = 0; i < batch * num_boxes; ++i) {
+            if (i % 5 == 0) {
+                cx = center(gen);
+                cy = center(gen);
+            }
+            const float x = cx + jitter(gen), y = cy + jitter(gen);
+            const float w = size(gen), h = size(gen);
+            float* b = boxes.data() + i * 4;
+            if (center_point_box) {
+                b[0] = x;
+                b[1] = y;
+                b[2] = w;
+                b[3] = h;
+            } else if (mmcv) {
+                b[0] = x - w / 2;
+                b[1] = y - h / 2;
+                b[2] = x + w / 2;
+                b[3] = y + h / 2;
+            } else {
+                // corners of onnx boxes may be flipped
+                const bool flip = (i % 3 == 0);
+                b[0] = flip ? y + h / 2 : y - h / 2;
+                b[1] = flip ? x + w / 2 : x - w / 2;
+                b[2] = flip ? y - h / 2 : y + h / 2;
+                b[3] = flip ? x - w / 2 : x + w / 2;
+            }
+        }
+        return boxes;
+    }
+
+    static vector<float> RandomScores(uint64_t size, uint32_t seed) {
+        mt19937 gen(seed);
+        uniform_real_distribution<float> dist(0.0f, 1.0f);
+        vector<float> data(size);
+        for (uint64_t i = 0; i < size; ++i) {
+            data[i] = dist(gen);
+        }
+        return data;
+    }
+
+    // avx and avx512 implementations if they are supported by this cpu
+    static vector<isa_t> GetTestIsas() {
+        vector<isa_t> isas;
+        const isa_t cpu_isa = GetCpuISA();
+        if (cpu_isa & ISA_X86_AVX) {
+            isas.push_back(cpu_isa & (~ISA_X86_AVX512));
+        }
+#ifdef PPL_USE_X86_AVX512
+        if (cpu_isa & ISA_X86_AVX512) {
+            isas.push_back(cpu_isa);
+        }
+#endif
+        return isas;
+    }
+};
+
+static RetCode NmsParallel(isa_t isa, const float* boxes, const float* scores, uint32_t num_boxes, uint32_t batch,
+                           uint32_t num_classes, bool center_point_box, int64_t max_output, float iou_threshold,
+                           float score_threshold, bool use_bitmask, void* temp_buffer, int64_t* dst,
+                           int64_t* num_boxes_out) {
+#ifdef PPL_USE_X86_AVX512
+    if (isa & ISA_X86_AVX512) {
+        return nms_ndarray_fp32_avx512(boxes, scores, num_boxes, batch, num_classes, center_point_box, max_output,
+                                       iou_threshold, score_threshold, 0, use_bitmask, temp_buffer, dst,
+                                       num_boxes_out);
+    }
+#endif
+    return nms_ndarray_fp32_avx(boxes, scores, num_boxes, batch, num_classes, center_point_box, max_output,
+                                iou_threshold, score_threshold, 0, use_bitmask, temp_buffer, dst, num_boxes_out);
+}
+
+static RetCode MmcvNmsParallel(isa_t isa, const float* boxes, const float* scores, uint32_t num_boxes,
+                               float iou_threshold, int64_t offset, bool use_bitmask, void* temp_buffer, int64_t* dst,
+                               int64_t* num_boxes_out) {
+#ifdef PPL_USE_X86_AVX512
+    if (isa & ISA_X86_AVX512) {
+        return mmcv_nms_ndarray_fp32_avx512(boxes, scores, num_boxes, iou_threshold, offset, use_bitmask,
+                                            temp_buffer, dst, num_boxes_out);
+    }
+#endif
+    return mmcv_nms_ndarray_fp32_avx(boxes, scores, num_boxes, iou_threshold, offset, use_bitmask, temp_buffer, dst,
+                                     num_boxes_out);
+}
+
+TEST_F(NmsKernelTest, onnx_vs_scalar) {
+    struct Case {
+        uint32_t batch;
+        uint32_t num_classes;
+        uint32_t num_boxes;
+    };
+    const Case cases[] = {{1, 1, 5}, {2, 3, 13}, {1, 2, 77}, {3, 1, 200}};
+    const int64_t max_outputs[] = {1000, 7, 0};
+    const float iou_threshold = 0.3f;
+    const float score_threshold = 0.2f;
+
+    uint32_t seed = 1;
+    auto isas = GetTestIsas();
+    for (auto c = begin(cases); c != end(cases); ++c) {
+        for (int center_point_box = 0; center_point_box < 2; ++center_point_box) {
+            auto boxes = RandomBoxes(c->batch, c->num_boxes, center_point_box, false, seed++);
+            auto scores = RandomScores(c->batch * c->num_classes * c->num_boxes, seed++);
+            const uint64_t max_dst = c->batch * c->num_classes * c->num_boxes * 3;
+
+            for (auto isa = isas.begin(); isa != isas.end(); ++isa) {
+                for (int use_bitmask = 0; use_bitmask < 2; ++use_bitmask) {
+                    // one buffer is shared by all max_outputs, as the engine caches its size by shapes
+                    vector<uint8_t> temp_buffer(
+                        nms_ndarray_fp32_get_buffer_bytes(c->num_boxes, c->batch, c->num_classes, 0, use_bitmask));
+                    for (auto max_output = begin(max_outputs); max_output != end(max_outputs); ++max_output) {
+                        vector<int64_t> ref_dst(max_dst), dst(max_dst);
+                        int64_t ref_num = 0, num = -1;
+                        ASSERT_EQ(RC_SUCCESS,
+                                  nms_ndarray_fp32(boxes.data(), scores.data(), c->num_boxes, c->batch,
+                                                   c->num_classes, center_point_box, *max_output, iou_threshold,
+                                                   score_threshold, ref_dst.data(), &ref_num));
+                        ASSERT_EQ(RC_SUCCESS,
+                                  NmsParallel(*isa, boxes.data(), scores.data(), c->num_boxes, c->batch,
+                                              c->num_classes, center_point_box, *max_output, iou_threshold,
+                                              score_threshold, use_bitmask, temp_buffer.data(), dst.data(), &num));
+
+                        const string name = "isa " + to_string(*isa) + " boxes " + to_string(c->num_boxes) +
+                            " center_point_box " + to_string(center_point_box) + " bitmask " +
+                            to_string(use_bitmask) + " max_output " + to_string(*max_output);
+                        ASSERT_EQ(ref_num, num) << name;
+                        ref_dst.resize(ref_num * 3);
+                        dst.resize(num * 3);
+                        EXPECT_EQ(ref_dst, dst) << name;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_F(NmsKernelTest, mmcv_vs_scalar) {
+    const uint32_t num_boxes_list[] = {3, 9, 64, 141};
+    const float iou_threshold = 0.3f;
+
+    uint32_t seed = 100;
+    auto isas = GetTestIsas();
+    for (auto n = begin(num_boxes_list); n != end(num_boxes_list); ++n) {
+        auto boxes = RandomBoxes(1, *n, false, true, seed++);
+        auto scores = RandomScores(*n, seed++);
+        for (int64_t offset = 0; offset < 2; ++offset) {
+            vector<int64_t> ref_dst(*n);
+            int64_t ref_num = 0;
+            ASSERT_EQ(RC_SUCCESS,
+                      mmcv_nms_ndarray_fp32(boxes.data(), scores.data(), *n, iou_threshold, offset, ref_dst.data(),
+                                            &ref_num));
+            ref_dst.resize(ref_num);
+
+            for (auto isa = isas.begin(); isa != isas.end(); ++isa) {
+                for (int use_bitmask = 0; use_bitmask < 2; ++use_bitmask) {
+                    vector<uint8_t> temp_buffer(mmcv_nms_ndarray_fp32_get_buffer_bytes(*n, use_bitmask));
+                    vector<int64_t> dst(*n);
+                    int64_t num = -1;
+                    ASSERT_EQ(RC_SUCCESS,
+                              MmcvNmsParallel(*isa, boxes.data(), scores.data(), *n, iou_threshold, offset,
+                                              use_bitmask, temp_buffer.data(), dst.data(), &num));
+
+                    const string name = "isa " + to_string(*isa) + " boxes " + to_string(*n) + " offset " +
+                        to_string(offset) + " bitmask " + to_string(use_bitmask);
+                    ASSERT_EQ(ref_num, num) << name;
+                    dst.resize(num);
+                    EXPECT_EQ(ref_dst, dst) << name;
+                }
+            }
+        }
+    }
+}
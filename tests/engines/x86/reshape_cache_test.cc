@@ -0,0 +1,123 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#if defined(PPLNN_USE_X86) && defined(PPLNN_ENABLE_ONNX_MODEL)
+
+#include "ppl/nn/engines/x86/engine_factory.h"
+#include "ppl/nn/engines/x86/ops.h"
+#include "ppl/nn/runtime/runtime.h"
+#include "tests/models/onnx/onnx_model_builder.h"
+#include "gtest/gtest.h"
+#include <memory>
+using namespace std;
+using namespace ppl::nn;
+using namespace ppl::common;
+using namespace ppl::nn::test;
+
+class X86ReshapeCacheTest : public testing::Test {
+protected:
+    static void SetUpTestCase() {
+        x86::RegisterBuiltinOpImpls();
+    }
+
+    void SetUp() override {
+        engine_.reset(x86::EngineFactory::Create(x86::EngineOptions()));
+    }
+
+    /*
+      y = Reshape(x, shape)
+      nz = NonZero(x)
+      the output shape of Reshape depends on the value of `shape`, and that of NonZero on the value of `x`.
+    */
+    Runtime* CreateRuntime() {
+        OnnxModelBuilder builder;
+        auto graph = builder.GetGraph();
+        OnnxModelBuilder::AddInput(graph, "x", {12});
+        OnnxModelBuilder::AddInput(graph, "shape", {2}, ::onnx::TensorProto_DataType_INT64);
+        OnnxModelBuilder::AddNode(graph, "Reshape", {"x", "shape"}, {"y"});
+        OnnxModelBuilder::AddNode(graph, "NonZero", {"x"}, {"nz"});
+        OnnxModelBuilder::AddOutput(graph, "y");
+        OnnxModelBuilder::AddOutput(graph, "nz", ::onnx::TensorProto_DataType_INT64);
+
+        auto engine = engine_.get();
+        auto runtime = builder.CreateRuntime(&engine, 1);
+        if (runtime) {
+            EXPECT_EQ(RC_SUCCESS, runtime->Configure(RUNTIME_CONF_SET_RESHAPE_CACHE, true));
+        }
+        return runtime;
+    }
+
+    static void SetShape(Tensor* tensor, const vector<int64_t>& value) {
+        auto shape = tensor->GetShape();
+        shape->Reshape({(int64_t)value.size()});
+        shape->SetDataType(DATATYPE_INT64);
+        shape->SetDataFormat(DATAFORMAT_NDARRAY);
+        EXPECT_EQ(RC_SUCCESS, tensor->ReallocBuffer());
+        EXPECT_EQ(RC_SUCCESS, tensor->CopyFromHost(value.data()));
+    }
+
+    static vector<int64_t> GetDims(const Tensor* tensor) {
+        auto shape = tensor->GetShape();
+        vector<int64_t> dims(shape->GetDimCount());
+        for (uint32_t i = 0; i < shape->GetDimCount(); ++i) {
+            dims[i] = shape->GetDim(i);
+        }
+        return dims;
+    }
+
+    static void RunAndCheck(Runtime* runtime, const vector<float>& x, const vector<int64_t>& shape) {
+        SetTensorData(runtime->GetInputTensor(0), {(int64_t)x.size()}, x);
+        SetShape(runtime->GetInputTensor(1), shape);
+        ASSERT_EQ(RC_SUCCESS, runtime->Run());
+
+        EXPECT_EQ(shape, GetDims(runtime->GetOutputTensor(0)));
+        EXPECT_EQ(x, GetTensorData(runtime->GetOutputTensor(0)));
+
+        int64_t nonzero_count = 0;
+        for (auto v = x.begin(); v != x.end(); ++v) {
+            nonzero_count += (*v != 0.0f);
+        }
+        EXPECT_EQ((vector<int64_t>{1, nonzero_count}), GetDims(runtime->GetOutputTensor(1)));
+    }
+
+protected:
+    unique_ptr<Engine> engine_;
+};
+
+TEST_F(X86ReshapeCacheTest, shape_data_changes) {
+    unique_ptr<Runtime> runtime(CreateRuntime());
+    ASSERT_TRUE(runtime != nullptr);
+
+    const vector<float> x = {1, 0, 2, 3, 0, 4, 5, 6, 0, 7, 8, 9};
+    RunAndCheck(runtime.get(), x, {3, 4});
+    RunAndCheck(runtime.get(), x, {3, 4});
+    // shapes of inputs are the same while the value of `shape` is changed
+    RunAndCheck(runtime.get(), x, {4, 3});
+    RunAndCheck(runtime.get(), x, {2, 6});
+}
+
+TEST_F(X86ReshapeCacheTest, data_dependent_kernel) {
+    unique_ptr<Runtime> runtime(CreateRuntime());
+    ASSERT_TRUE(runtime != nullptr);
+
+    // NonZero is never cached, while Reshape hits with the same `shape`
+    RunAndCheck(runtime.get(), {1, 0, 2, 3, 0, 4, 5, 6, 0, 7, 8, 9}, {3, 4});
+    RunAndCheck(runtime.get(), {1, 1, 2, 3, 1, 4, 5, 6, 1, 7, 8, 9}, {3, 4});
+    RunAndCheck(runtime.get(), {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1}, {3, 4});
+}
+
+#endif
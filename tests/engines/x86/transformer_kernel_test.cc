@@ -0,0 +1,288 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/kernel/x86/fp32/layernorm.h"
+#include "ppl/kernel/x86/fp32/gelu.h"
+#include "ppl/kernel/x86/fp32/multi_head_attention.h"
+#include "gtest/gtest.h"
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+using namespace std;
+using namespace ppl::common;
+using namespace ppl::kernel::x86;
+
+/*
+  every implementation of layernorm, gelu and multi_head_attention which is supported by this cpu is checked against
+  references computed in double.
+*/
+class TransformerKernelTest : public testing::Test {
+protected:
+    static vector<float> RandomData(uint64_t size, float lo, float hi, uint32_t seed) {
+        mt19937 gen(seed);
+        uniform_real_distribution<float> dist(lo, hi);
+        vector<float> data(size);
+        for (uint64_t i = 0; i < size; ++i) {
+            data[i] = dist(gen);
+        }
+        return data;
+    }
+
+    static bool HasFma() {
+        const isa_t fma_isa = ISA_X86_AVX | ISA_X86_FMA;
+        return ((GetCpuISA() & fma_isa) == fma_isa);
+    }
+
+    static bool HasAvx512() {
+        return (GetCpuISA() & ISA_X86_AVX512) != 0;
+    }
+
+    static void Check(const vector<double>& expected, const vector<float>& result, double eps, const string& name) {
+        ASSERT_EQ(expected.size(), result.size());
+        for (uint64_t i = 0; i < expected.size(); ++i) {
+            ASSERT_NEAR(expected[i], result[i], eps * std::max(1.0, fabs(expected[i]))) << name << " index " << i;
+        }
+    }
+};
+
+/* -------------------------------------------------------------------------- */
+
+typedef RetCode (*layernorm_func_t)(const ppl::nn::TensorShape*, const float*, const float*, const float*,
+                                    const int64_t, const float, float*);
+
+static vector<pair<string, layernorm_func_t>> GetLayerNormFuncs(bool has_fma, bool has_avx512) {
+    vector<pair<string, layernorm_func_t>> funcs = {{"ref", layernorm_ndarray_fp32},
+                                                    {"sse", layernorm_ndarray_fp32_sse}};
+    if (has_fma) {
+        funcs.push_back({"fma", layernorm_ndarray_fp32_fma});
+    }
+#ifdef PPL_USE_X86_AVX512
+    if (has_avx512) {
+        funcs.push_back({"avx512", layernorm_ndarray_fp32_avx512});
+    }
+#endif
+    return funcs;
+}
+
+TEST_F(TransformerKernelTest, layernorm) {
+    // rows are far from zero to check that statistics are stable. 37 and 5 * 37 are not multiples of any simd width.
+    const vector<int64_t> dims = {3, 5, 37};
+    auto src = RandomData(3 * 5 * 37, 99.0f, 101.0f, 1);
+    const float eps = 1e-5f;
+
+    for (int64_t axis = -2; axis <= -1; ++axis) {
+        const int64_t inner = (axis == -1) ? 37 : 5 * 37;
+        const int64_t outer = src.size() / inner;
+        auto scale = RandomData(inner, 0.5f, 1.5f, 2);
+        auto shift = RandomData(inner, -1.0f, 1.0f, 3);
+
+        for (int32_t affine = 0; affine < 2; ++affine) {
+            vector<double> expected(src.size());
+            for (int64_t i = 0; i < outer; ++i) {
+                const float* row = src.data() + i * inner;
+                double mean = 0.0, var = 0.0;
+                for (int64_t j = 0; j < inner; ++j) {
+                    mean += row[j];
+                }
+                mean /= inner;
+                for (int64_t j = 0; j < inner; ++j) {
+                    var += (row[j] - mean) * (row[j] - mean);
+                }
+                var /= inner;
+                for (int64_t j = 0; j < inner; ++j) {
+                    double y = (row[j] - mean) / sqrt(var + eps);
+                    if (affine) {
+                        y = y * scale[j] + shift[j];
+                    }
+                    expected[i * inner + j] = y;
+                }
+            }
+
+            ppl::nn::TensorShape shape;
+            shape.Reshape(dims);
+            shape.SetDataType(DATATYPE_FLOAT32);
+            shape.SetDataFormat(DATAFORMAT_NDARRAY);
+            auto funcs = GetLayerNormFuncs(HasFma(), HasAvx512());
+            for (auto f = funcs.begin(); f != funcs.end(); ++f) {
+                vector<float> dst(src.size());
+                EXPECT_EQ(RC_SUCCESS,
+                          f->second(&shape, src.data(), affine ? scale.data() : nullptr,
+                                    affine ? shift.data() : nullptr, axis, eps, dst.data()));
+                Check(expected, dst, 1e-3, f->first + " axis " + to_string(axis) + " affine " + to_string(affine));
+            }
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+typedef RetCode (*gelu_func_t)(const ppl::nn::TensorShape*, const float*, const bool, float*);
+
+static vector<pair<string, gelu_func_t>> GetGELUFuncs(bool has_fma, bool has_avx512) {
+    vector<pair<string, gelu_func_t>> funcs = {{"ref", gelu_fp32}, {"sse", gelu_fp32_sse}};
+    if (has_fma) {
+        funcs.push_back({"fma", gelu_fp32_fma});
+    }
+#ifdef PPL_USE_X86_AVX512
+    if (has_avx512) {
+        funcs.push_back({"avx512", gelu_fp32_avx512});
+    }
+#endif
+    return funcs;
+}
+
+TEST_F(TransformerKernelTest, gelu) {
+    // odd size to cover tails of all simd widths
+    const int64_t size = 1021;
+    auto x = RandomData(size, -8.0f, 8.0f, 4);
+
+    ppl::nn::TensorShape shape;
+    shape.Reshape({size});
+    shape.SetDataType(DATATYPE_FLOAT32);
+    shape.SetDataFormat(DATAFORMAT_NDARRAY);
+
+    for (int32_t approximate = 0; approximate < 2; ++approximate) {
+        vector<double> expected(size);
+        for (int64_t i = 0; i < size; ++i) {
+            const double v = x[i];
+            const double t = approximate ? tanh(sqrt(2.0 / M_PI) * (v + 0.044715 * v * v * v)) : erf(v / sqrt(2.0));
+            expected[i] = 0.5 * v * (1.0 + t);
+        }
+
+        auto funcs = GetGELUFuncs(HasFma(), HasAvx512());
+        for (auto f = funcs.begin(); f != funcs.end(); ++f) {
+            vector<float> y(size);
+            EXPECT_EQ(RC_SUCCESS, f->second(&shape, x.data(), approximate, y.data()));
+            Check(expected, y, 1e-5, f->first + " approximate " + to_string(approximate));
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+typedef RetCode (*mha_func_t)(const float*, const float*, const float*, const float*, const int64_t, const int64_t,
+                              const int64_t, const int64_t, const int64_t, const int64_t, const float, void*, float*);
+
+static vector<pair<string, mha_func_t>> GetMultiHeadAttentionFuncs(bool has_fma, bool has_avx512) {
+    vector<pair<string, mha_func_t>> funcs = {{"ref", multi_head_attention_fp32},
+                                              {"sse", multi_head_attention_fp32_sse}};
+    if (has_fma) {
+        funcs.push_back({"fma", multi_head_attention_fp32_fma});
+    }
+#ifdef PPL_USE_X86_AVX512
+    if (has_avx512) {
+        funcs.push_back({"avx512", multi_head_attention_fp32_avx512});
+    }
+#endif
+    return funcs;
+}
+
+struct MultiHeadAttentionCase {
+    int64_t batch;
+    int64_t seqlen_q;
+    int64_t seqlen_kv;
+    int64_t num_heads;
+    int64_t head_dim;
+    // 0: no mask, 1: one mask shared by all batches, 2: one mask for each batch
+    int32_t mask_type;
+};
+
+static vector<double> CalcMultiHeadAttention(const MultiHeadAttentionCase& c, const vector<float>& q,
+                                             const vector<float>& k, const vector<float>& v,
+                                             const vector<float>& mask, int64_t mask_batch_stride, float scale) {
+    const int64_t hidden = c.num_heads * c.head_dim;
+    vector<double> dst(c.batch * c.seqlen_q * hidden);
+    vector<double> probs(c.seqlen_kv);
+    for (int64_t b = 0; b < c.batch; ++b) {
+        for (int64_t h = 0; h < c.num_heads; ++h) {
+            for (int64_t i = 0; i < c.seqlen_q; ++i) {
+                const float* q_row = q.data() + (b * c.seqlen_q + i) * hidden + h * c.head_dim;
+                double max_score = -INFINITY;
+                for (int64_t j = 0; j < c.seqlen_kv; ++j) {
+                    const float* k_row = k.data() + (b * c.seqlen_kv + j) * hidden + h * c.head_dim;
+                    double score = 0.0;
+                    for (int64_t d = 0; d < c.head_dim; ++d) {
+                        score += (double)q_row[d] * k_row[d];
+                    }
+                    score *= scale;
+                    if (c.mask_type) {
+                        score += mask[b * mask_batch_stride + j];
+                    }
+                    probs[j] = score;
+                    max_score = std::max(max_score, score);
+                }
+                double sum = 0.0;
+                for (int64_t j = 0; j < c.seqlen_kv; ++j) {
+                    probs[j] = exp(probs[j] - max_score);
+                    sum += probs[j];
+                }
+                double* dst_row = dst.data() + (b * c.seqlen_q + i) * hidden + h * c.head_dim;
+                for (int64_t j = 0; j < c.seqlen_kv; ++j) {
+                    const float* v_row = v.data() + (b * c.seqlen_kv + j) * hidden + h * c.head_dim;
+                    for (int64_t d = 0; d < c.head_dim; ++d) {
+                        dst_row[d] += probs[j] / sum * v_row[d];
+                    }
+                }
+            }
+        }
+    }
+    return dst;
+}
+
+TEST_F(TransformerKernelTest, multi_head_attention) {
+    /*
+      seqlen_q covers tails of query blocks and of register tiles, seqlen_kv covers tails of key tiles and
+      head_dim covers vector and scalar tails of all simd widths.
+    */
+    const vector<MultiHeadAttentionCase> cases = {
+        {2, 19, 70, 3, 40, 2}, {1, 33, 129, 2, 7, 1}, {2, 5, 64, 2, 16, 0}, {1, 1, 3, 4, 64, 2}, {3, 16, 17, 1, 48, 1},
+    };
+
+    uint32_t seed = 5;
+    for (auto c = cases.begin(); c != cases.end(); ++c) {
+        const int64_t hidden = c->num_heads * c->head_dim;
+        auto q = RandomData(c->batch * c->seqlen_q * hidden, -1.0f, 1.0f, seed++);
+        auto k = RandomData(c->batch * c->seqlen_kv * hidden, -1.0f, 1.0f, seed++);
+        auto v = RandomData(c->batch * c->seqlen_kv * hidden, -1.0f, 1.0f, seed++);
+        const int64_t mask_batch_stride = (c->mask_type == 2) ? c->seqlen_kv : 0;
+        auto mask = RandomData((c->mask_type == 2 ? c->batch : 1) * c->seqlen_kv, -2.0f, 0.0f, seed++);
+        // masked keys as exported by BERT, but at least one key is kept
+        for (uint64_t j = 0; j < mask.size(); ++j) {
+            if (j % c->seqlen_kv != 0 && j % 5 == 0) {
+                mask[j] = -10000.0f;
+            }
+        }
+        const float scale = 1.0f / sqrtf((float)c->head_dim);
+        auto expected = CalcMultiHeadAttention(*c, q, k, v, mask, mask_batch_stride, scale);
+
+        const string case_name = "b" + to_string(c->batch) + "q" + to_string(c->seqlen_q) + "kv" +
+            to_string(c->seqlen_kv) + "h" + to_string(c->num_heads) + "d" + to_string(c->head_dim) + "m" +
+            to_string(c->mask_type);
+        vector<uint8_t> temp_buffer(
+            multi_head_attention_fp32_get_buffer_bytes(c->batch, c->seqlen_kv, c->num_heads, c->head_dim));
+        auto funcs = GetMultiHeadAttentionFuncs(HasFma(), HasAvx512());
+        for (auto f = funcs.begin(); f != funcs.end(); ++f) {
+            vector<float> dst(expected.size());
+            EXPECT_EQ(RC_SUCCESS,
+                      f->second(q.data(), k.data(), v.data(), c->mask_type ? mask.data() : nullptr, c->batch,
+                                c->seqlen_q, c->seqlen_kv, c->num_heads, c->head_dim, mask_batch_stride, scale,
+                                temp_buffer.data(), dst.data()));
+            Check(expected, dst, 1e-5, f->first + " " + case_name);
+        }
+    }
+}
@@ -0,0 +1,173 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/nn/engines/x86/kernel.h"
+#include "ppl/kernel/x86/common/threading_tools.h"
+#include "tests/ir/graph_builder.h"
+#include "gtest/gtest.h"
+#include <memory>
+#include <vector>
+using namespace std;
+using namespace ppl::nn;
+using namespace ppl::common;
+using namespace ppl::nn::test;
+
+namespace {
+
+/*
+  tmp buffer size is the number of elements of the output, and calls of `CalcTmpBufferSize()` are counted. the number
+  of threads seen by `DoExecute()` is recorded.
+*/
+// device of a runtime with a thread budget per kernel
+class ThreadBudgetDevice final : public x86::X86Device {
+public:
+    ThreadBudgetDevice(uint32_t omp_threads) : X86Device(64, GetCpuISA()), omp_threads_(omp_threads) {}
+    uint32_t GetOmpThreadsPerKernel() const override {
+        return omp_threads_;
+    }
+
+private:
+    uint32_t omp_threads_;
+};
+
+class TmpBufferSizeKernel final : public x86::X86Kernel {
+public:
+    TmpBufferSizeKernel(const ir::Node* node) : X86Kernel(node) {}
+
+    uint64_t GetTmpBufferSize(const KernelExecContext& ctx) {
+        return X86Kernel::GetTmpBufferSize(ctx);
+    }
+    uint32_t GetCalcCount() const {
+        return calc_count_;
+    }
+    void SetExecuteStatus(RetCode status) {
+        execute_status_ = status;
+    }
+    int32_t GetOmpThreadsInExecution() const {
+        return omp_threads_in_execution_;
+    }
+
+protected:
+    ppl::common::RetCode DoExecute(KernelExecContext*) override {
+        omp_threads_in_execution_ = ppl::kernel::x86::get_omp_max_threads();
+        return execute_status_;
+    }
+    uint64_t CalcTmpBufferSize(const KernelExecContext& ctx) const override {
+        ++calc_count_;
+        return ctx.GetOutput<TensorImpl>(0)->GetShape()->GetElementsIncludingPadding();
+    }
+
+private:
+    mutable uint32_t calc_count_ = 0;
+    RetCode execute_status_ = RC_SUCCESS;
+    int32_t omp_threads_in_execution_ = 0;
+};
+
+} // namespace
+
+class X86KernelTest : public testing::Test {
+protected:
+    void SetUp() override {
+        builder_.AddNode("a", ir::Node::Type("", "Test", 1), {"x"}, {"y"});
+        builder_.Finalize();
+
+        auto topo = builder_.GetGraph()->topo.get();
+        x_.reset(new TensorImpl(topo->GetEdge("x"), TENSORTYPE_NORMAL));
+        y_.reset(new TensorImpl(topo->GetEdge("y"), TENSORTYPE_NORMAL));
+        SetShape(x_.get(), {2, 3});
+        SetShape(y_.get(), {2, 3});
+
+        ctx_.SetNode(topo->GetNode(0));
+        ctx_.SetAcquireFunc([this](edgeid_t eid, uint32_t) -> EdgeObject* {
+            return (eid == x_->GetEdge()->GetId()) ? x_.get() : y_.get();
+        });
+    }
+
+    static void SetShape(TensorImpl* tensor, const vector<int64_t>& dims) {
+        auto shape = tensor->GetShape();
+        shape->Reshape(dims);
+        shape->SetDataType(DATATYPE_FLOAT32);
+        shape->SetDataFormat(DATAFORMAT_NDARRAY);
+    }
+
+protected:
+    GraphBuilder builder_;
+    unique_ptr<TensorImpl> x_;
+    unique_ptr<TensorImpl> y_;
+    KernelExecContext ctx_;
+};
+
+TEST_F(X86KernelTest, tmp_buffer_size_cache) {
+    TmpBufferSizeKernel kernel(builder_.GetGraph()->topo->GetNode(0));
+    const int32_t saved_threads = ppl::kernel::x86::get_omp_max_threads();
+
+    EXPECT_EQ(6, kernel.GetTmpBufferSize(ctx_));
+    EXPECT_EQ(6, kernel.GetTmpBufferSize(ctx_));
+    EXPECT_EQ(1, kernel.GetCalcCount());
+
+    // shape changes
+    SetShape(y_.get(), {3, 3});
+    EXPECT_EQ(9, kernel.GetTmpBufferSize(ctx_));
+    EXPECT_EQ(2, kernel.GetCalcCount());
+    SetShape(x_.get(), {3, 3});
+    EXPECT_EQ(9, kernel.GetTmpBufferSize(ctx_));
+    EXPECT_EQ(3, kernel.GetCalcCount());
+    EXPECT_EQ(9, kernel.GetTmpBufferSize(ctx_));
+    EXPECT_EQ(3, kernel.GetCalcCount());
+
+    // dims are the same while the data type or the padding changes
+    x_->GetShape()->SetDataType(DATATYPE_FLOAT16);
+    kernel.GetTmpBufferSize(ctx_);
+    EXPECT_EQ(4, kernel.GetCalcCount());
+    y_->GetShape()->SetPadding1(1, 1);
+    EXPECT_EQ(12, kernel.GetTmpBufferSize(ctx_));
+    EXPECT_EQ(5, kernel.GetCalcCount());
+
+    // number of threads changes
+    ppl::kernel::x86::set_omp_max_threads(saved_threads + 1);
+    kernel.GetTmpBufferSize(ctx_);
+    EXPECT_EQ(6, kernel.GetCalcCount());
+    kernel.GetTmpBufferSize(ctx_);
+    EXPECT_EQ(6, kernel.GetCalcCount());
+    ppl::kernel::x86::set_omp_max_threads(saved_threads);
+    kernel.GetTmpBufferSize(ctx_);
+    EXPECT_EQ(7, kernel.GetCalcCount());
+}
+
+TEST_F(X86KernelTest, restore_omp_max_threads) {
+    const int32_t saved_threads = ppl::kernel::x86::get_omp_max_threads();
+    ThreadBudgetDevice device(saved_threads + 2);
+    TmpBufferSizeKernel kernel(builder_.GetGraph()->topo->GetNode(0));
+    kernel.SetDevice(&device);
+    kernel.SetReshapeFunc([](InputOutputInfo*) -> RetCode {
+        return RC_SUCCESS;
+    });
+
+    EXPECT_EQ(RC_SUCCESS, kernel.Execute(&ctx_));
+    EXPECT_EQ(saved_threads + 2, kernel.GetOmpThreadsInExecution());
+    EXPECT_EQ(saved_threads, ppl::kernel::x86::get_omp_max_threads());
+
+    kernel.SetExecuteStatus(RC_INVALID_VALUE);
+    EXPECT_EQ(RC_INVALID_VALUE, kernel.Execute(&ctx_));
+    EXPECT_EQ(saved_threads, ppl::kernel::x86::get_omp_max_threads());
+
+    kernel.SetReshapeFunc([](InputOutputInfo*) -> RetCode {
+        return RC_INVALID_VALUE;
+    });
+    EXPECT_EQ(RC_INVALID_VALUE, kernel.Execute(&ctx_));
+    EXPECT_EQ(saved_threads, ppl::kernel::x86::get_omp_max_threads());
+}
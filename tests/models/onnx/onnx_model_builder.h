@@ -0,0 +1,190 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef _ST_HPC_PPL_NN_TESTS_MODELS_ONNX_ONNX_MODEL_BUILDER_H_
+#define _ST_HPC_PPL_NN_TESTS_MODELS_ONNX_ONNX_MODEL_BUILDER_H_
+
+#include "ppl/nn/models/onnx/generated/onnx.pb.h"
+#include "ppl/nn/models/onnx/runtime_builder_factory.h"
+#include "ppl/nn/runtime/runtime.h"
+#include "gtest/gtest.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ppl { namespace nn { namespace test {
+
+/** @brief builds onnx models in memory for tests */
+class OnnxModelBuilder final {
+public:
+    OnnxModelBuilder(int64_t opset_version = 11) {
+        model_.set_ir_version(7);
+        auto opset = model_.add_opset_import();
+        opset->set_domain("");
+        opset->set_version(opset_version);
+        model_.mutable_graph()->set_name("test");
+    }
+
+    ::onnx::GraphProto* GetGraph() {
+        return model_.mutable_graph();
+    }
+
+    /** @brief adds an input with fixed dims to `graph`. inputs of subgraphs may have no dims. */
+    static void AddInput(::onnx::GraphProto* graph, const std::string& name, const std::vector<int64_t>& dims,
+                         int32_t data_type = ::onnx::TensorProto_DataType_FLOAT) {
+        SetValueInfo(graph->add_input(), name, dims, data_type);
+    }
+    static void AddOutput(::onnx::GraphProto* graph, const std::string& name,
+                          int32_t data_type = ::onnx::TensorProto_DataType_FLOAT) {
+        auto output = graph->add_output();
+        output->set_name(name);
+        output->mutable_type()->mutable_tensor_type()->set_elem_type(data_type);
+    }
+
+    template <typename T>
+    static void AddInitializer(::onnx::GraphProto* graph, const std::string& name, const std::vector<int64_t>& dims,
+                               const std::vector<T>& data, int32_t data_type) {
+        auto tensor = graph->add_initializer();
+        tensor->set_name(name);
+        tensor->set_data_type(data_type);
+        for (auto x = dims.begin(); x != dims.end(); ++x) {
+            tensor->add_dims(*x);
+        }
+        tensor->set_raw_data(std::string((const char*)data.data(), data.size() * sizeof(T)));
+    }
+    static void AddInitializer(::onnx::GraphProto* graph, const std::string& name, const std::vector<int64_t>& dims,
+                               const std::vector<float>& data) {
+        AddInitializer(graph, name, dims, data, ::onnx::TensorProto_DataType_FLOAT);
+    }
+    static void AddInitializer(::onnx::GraphProto* graph, const std::string& name, const std::vector<int64_t>& dims,
+                               const std::vector<int64_t>& data) {
+        AddInitializer(graph, name, dims, data, ::onnx::TensorProto_DataType_INT64);
+    }
+
+    static ::onnx::NodeProto* AddNode(::onnx::GraphProto* graph, const std::string& op_type,
+                                      const std::vector<std::string>& inputs, const std::vector<std::string>& outputs) {
+        auto node = graph->add_node();
+        node->set_op_type(op_type);
+        node->set_name(op_type + "_" + std::to_string(graph->node_size()));
+        for (auto x = inputs.begin(); x != inputs.end(); ++x) {
+            node->add_input(*x);
+        }
+        for (auto x = outputs.begin(); x != outputs.end(); ++x) {
+            node->add_output(*x);
+        }
+        return node;
+    }
+
+    static void SetAttr(::onnx::NodeProto* node, const std::string& name, int64_t value) {
+        auto attr = AddAttr(node, name, ::onnx::AttributeProto_AttributeType_INT);
+        attr->set_i(value);
+    }
+    static void SetAttr(::onnx::NodeProto* node, const std::string& name, float value) {
+        auto attr = AddAttr(node, name, ::onnx::AttributeProto_AttributeType_FLOAT);
+        attr->set_f(value);
+    }
+    static void SetAttr(::onnx::NodeProto* node, const std::string& name, const std::string& value) {
+        auto attr = AddAttr(node, name, ::onnx::AttributeProto_AttributeType_STRING);
+        attr->set_s(value);
+    }
+    static void SetAttr(::onnx::NodeProto* node, const std::string& name, const std::vector<int64_t>& values) {
+        auto attr = AddAttr(node, name, ::onnx::AttributeProto_AttributeType_INTS);
+        for (auto x = values.begin(); x != values.end(); ++x) {
+            attr->add_ints(*x);
+        }
+    }
+    static void SetAttr(::onnx::NodeProto* node, const std::string& name, const std::vector<float>& values) {
+        auto attr = AddAttr(node, name, ::onnx::AttributeProto_AttributeType_FLOATS);
+        for (auto x = values.begin(); x != values.end(); ++x) {
+            attr->add_floats(*x);
+        }
+    }
+    static void SetAttr(::onnx::NodeProto* node, const std::string& name, const ::onnx::GraphProto& graph) {
+        auto attr = AddAttr(node, name, ::onnx::AttributeProto_AttributeType_GRAPH);
+        *attr->mutable_g() = graph;
+    }
+
+    std::string Serialize() const {
+        std::string buf;
+        EXPECT_TRUE(model_.SerializeToString(&buf));
+        return buf;
+    }
+
+    /** @brief creates a runtime of this model with `engines` */
+    Runtime* CreateRuntime(Engine** engines, uint32_t engine_num) const {
+        auto buf = Serialize();
+        std::unique_ptr<onnx::RuntimeBuilder> builder(onnx::RuntimeBuilderFactory::Create());
+        if (!builder) {
+            return nullptr;
+        }
+        if (builder->Init(buf.data(), buf.size(), engines, engine_num) != ppl::common::RC_SUCCESS) {
+            return nullptr;
+        }
+        if (builder->Preprocess() != ppl::common::RC_SUCCESS) {
+            return nullptr;
+        }
+        return builder->CreateRuntime();
+    }
+
+private:
+    static void SetValueInfo(::onnx::ValueInfoProto* info, const std::string& name, const std::vector<int64_t>& dims,
+                             int32_t data_type) {
+        info->set_name(name);
+        auto tensor_type = info->mutable_type()->mutable_tensor_type();
+        tensor_type->set_elem_type(data_type);
+        auto shape = tensor_type->mutable_shape();
+        for (auto x = dims.begin(); x != dims.end(); ++x) {
+            shape->add_dim()->set_dim_value(*x);
+        }
+    }
+    static ::onnx::AttributeProto* AddAttr(::onnx::NodeProto* node, const std::string& name,
+                                           ::onnx::AttributeProto_AttributeType type) {
+        auto attr = node->add_attribute();
+        attr->set_name(name);
+        attr->set_type(type);
+        return attr;
+    }
+
+private:
+    ::onnx::ModelProto model_;
+};
+
+/** @brief sets an ndarray float32 input from host memory */
+static inline void SetTensorData(Tensor* tensor, const std::vector<int64_t>& dims, const std::vector<float>& data) {
+    auto shape = tensor->GetShape();
+    shape->Reshape(dims);
+    shape->SetDataType(ppl::common::DATATYPE_FLOAT32);
+    shape->SetDataFormat(ppl::common::DATAFORMAT_NDARRAY);
+    EXPECT_EQ(ppl::common::RC_SUCCESS, tensor->ReallocBuffer());
+
+    TensorShape src_desc = *shape;
+    EXPECT_EQ(ppl::common::RC_SUCCESS, tensor->ConvertFromHost(data.data(), src_desc));
+}
+
+/** @brief gets data of a float32 output as ndarray */
+static inline std::vector<float> GetTensorData(const Tensor* tensor) {
+    TensorShape dst_desc = *tensor->GetShape();
+    dst_desc.SetDataType(ppl::common::DATATYPE_FLOAT32);
+    dst_desc.SetDataFormat(ppl::common::DATAFORMAT_NDARRAY);
+    std::vector<float> data(dst_desc.GetElementsExcludingPadding());
+    EXPECT_EQ(ppl::common::RC_SUCCESS, tensor->ConvertToHost(data.data(), dst_desc));
+    return data;
+}
+
+}}} // namespace ppl::nn::test
+
+#endif
@@ -0,0 +1,275 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#if defined(PPLNN_USE_X86) && defined(PPLNN_ENABLE_ONNX_MODEL)
+
+#include "ppl/nn/engines/x86/engine_factory.h"
+#include "ppl/nn/engines/x86/ops.h"
+#include "ppl/nn/engines/x86/engine.h"
+#include "ppl/nn/engines/x86/pmx/kernel_param_serializer.h"
+#include "ppl/nn/utils/buffer_data_stream.h"
+#include "ppl/nn/models/pmx/runtime_builder_factory.h"
+#include "tests/models/onnx/onnx_model_builder.h"
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+using namespace std;
+using namespace ppl::nn;
+using namespace ppl::common;
+using namespace ppl::nn::test;
+
+class X86PmxRoundTripTest : public testing::Test {
+protected:
+    static void SetUpTestCase() {
+        x86::RegisterBuiltinOpImpls();
+    }
+    void SetUp() override {
+        pmx_file_ = testing::TempDir() + "x86_pmx_round_trip_test.pmx";
+    }
+    void TearDown() override {
+        remove(pmx_file_.c_str());
+    }
+
+    static vector<float> RandomData(uint64_t size, uint32_t seed) {
+        mt19937 gen(seed);
+        uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        vector<float> data(size);
+        for (uint64_t i = 0; i < size; ++i) {
+            data[i] = dist(gen);
+        }
+        return data;
+    }
+
+    // conv -> relu -> flatten -> gemm -> matmul. weights of conv and gemm are packed by the x86 engine.
+    static string CreateModel() {
+        OnnxModelBuilder builder;
+        auto graph = builder.GetGraph();
+        OnnxModelBuilder::AddInput(graph, "x", {1, 3, 10, 10});
+        OnnxModelBuilder::AddInitializer(graph, "conv_w", {8, 3, 3, 3}, RandomData(8 * 3 * 3 * 3, 1));
+        OnnxModelBuilder::AddInitializer(graph, "conv_b", {8}, RandomData(8, 2));
+        OnnxModelBuilder::AddInitializer(graph, "fc_w", {16, 8 * 10 * 10}, RandomData(16 * 8 * 10 * 10, 3));
+        OnnxModelBuilder::AddInitializer(graph, "fc_b", {16}, RandomData(16, 4));
+        OnnxModelBuilder::AddInitializer(graph, "mm_b", {16, 5}, RandomData(16 * 5, 5));
+
+        auto conv = OnnxModelBuilder::AddNode(graph, "Conv", {"x", "conv_w", "conv_b"}, {"conv_y"});
+        OnnxModelBuilder::SetAttr(conv, "kernel_shape", vector<int64_t>{3, 3});
+        OnnxModelBuilder::SetAttr(conv, "pads", vector<int64_t>{1, 1, 1, 1});
+        OnnxModelBuilder::AddNode(graph, "Relu", {"conv_y"}, {"relu_y"});
+        OnnxModelBuilder::AddNode(graph, "Flatten", {"relu_y"}, {"flatten_y"});
+        auto gemm = OnnxModelBuilder::AddNode(graph, "Gemm", {"flatten_y", "fc_w", "fc_b"}, {"fc_y"});
+        OnnxModelBuilder::SetAttr(gemm, "transB", (int64_t)1);
+        OnnxModelBuilder::AddNode(graph, "MatMul", {"fc_y", "mm_b"}, {"y"});
+        OnnxModelBuilder::AddOutput(graph, "y");
+
+        return builder.Serialize();
+    }
+
+    static vector<float> Run(Runtime* runtime) {
+        SetTensorData(runtime->GetInputTensor(0), {1, 3, 10, 10}, RandomData(3 * 10 * 10, 6));
+        EXPECT_EQ(RC_SUCCESS, runtime->Run());
+        return GetTensorData(runtime->GetOutputTensor(0));
+    }
+
+    // optimizes the model with `engine`, saves it as pmx and returns outputs of the onnx runtime
+    vector<float> SaveModel(Engine* engine) {
+        auto buf = CreateModel();
+        unique_ptr<ppl::nn::onnx::RuntimeBuilder> builder(ppl::nn::onnx::RuntimeBuilderFactory::Create());
+        EXPECT_EQ(RC_SUCCESS, builder->Init(buf.data(), buf.size(), &engine, 1));
+        EXPECT_EQ(RC_SUCCESS, builder->Preprocess());
+        EXPECT_EQ(RC_SUCCESS, builder->Serialize(pmx_file_.c_str(), "pmx"));
+
+        unique_ptr<Runtime> runtime(builder->CreateRuntime());
+        EXPECT_TRUE(runtime != nullptr);
+        return Run(runtime.get());
+    }
+
+    // matmul with a constant B of [1, K, N] and A of [2, 3, M, K], whose B is packed and saved with its isa
+    static string CreateMatMulModel() {
+        OnnxModelBuilder builder;
+        auto graph = builder.GetGraph();
+        OnnxModelBuilder::AddInput(graph, "a", {2, 3, 7, 29});
+        OnnxModelBuilder::AddInitializer(graph, "b", {1, 29, 19}, RandomData(29 * 19, 7));
+        OnnxModelBuilder::AddNode(graph, "MatMul", {"a", "b"}, {"y"});
+        OnnxModelBuilder::AddOutput(graph, "y");
+        return builder.Serialize();
+    }
+
+    static vector<float> RunMatMul(Runtime* runtime) {
+        SetTensorData(runtime->GetInputTensor(0), {2, 3, 7, 29}, RandomData(2 * 3 * 7 * 29, 8));
+        EXPECT_EQ(RC_SUCCESS, runtime->Run());
+        return GetTensorData(runtime->GetOutputTensor(0));
+    }
+
+    vector<float> SaveMatMulModel(Engine* engine) {
+        auto buf = CreateMatMulModel();
+        unique_ptr<ppl::nn::onnx::RuntimeBuilder> builder(ppl::nn::onnx::RuntimeBuilderFactory::Create());
+        EXPECT_EQ(RC_SUCCESS, builder->Init(buf.data(), buf.size(), &engine, 1));
+        EXPECT_EQ(RC_SUCCESS, builder->Preprocess());
+        EXPECT_EQ(RC_SUCCESS, builder->Serialize(pmx_file_.c_str(), "pmx"));
+
+        unique_ptr<Runtime> runtime(builder->CreateRuntime());
+        EXPECT_TRUE(runtime != nullptr);
+        return RunMatMul(runtime.get());
+    }
+
+protected:
+    string pmx_file_;
+};
+
+TEST_F(X86PmxRoundTripTest, conv_fc_matmul) {
+    unique_ptr<Engine> onnx_engine(x86::EngineFactory::Create(x86::EngineOptions()));
+    auto expected = SaveModel(onnx_engine.get());
+    EXPECT_EQ(5, expected.size());
+
+    auto engine = unique_ptr<Engine>(x86::EngineFactory::Create(x86::EngineOptions()));
+    auto engine_ptr = engine.get();
+    unique_ptr<pmx::RuntimeBuilder> builder(pmx::RuntimeBuilderFactory::Create());
+    EXPECT_EQ(RC_SUCCESS, builder->Init(pmx_file_.c_str(), &engine_ptr, 1));
+    EXPECT_EQ(RC_SUCCESS, builder->Preprocess());
+
+    unique_ptr<Runtime> runtime(builder->CreateRuntime());
+    ASSERT_TRUE(runtime != nullptr);
+
+    // algorithms and packed weights are restored, so results are the same as the onnx runtime
+    auto result = Run(runtime.get());
+    ASSERT_EQ(expected.size(), result.size());
+    for (uint32_t i = 0; i < expected.size(); ++i) {
+        EXPECT_NEAR(expected[i], result[i], 1e-5f) << "index " << i;
+    }
+
+    // the loaded model can be saved again
+    const string resaved_file = pmx_file_ + ".1";
+    EXPECT_EQ(RC_SUCCESS, builder->Serialize(resaved_file.c_str(), "pmx"));
+    remove(resaved_file.c_str());
+}
+
+TEST_F(X86PmxRoundTripTest, reject_unsupported_isa) {
+    unique_ptr<Engine> onnx_engine(x86::EngineFactory::Create(x86::EngineOptions()));
+    SaveModel(onnx_engine.get());
+
+    // packed weights of a model optimized with avx/fma cannot be used by an sse-only engine
+    auto engine = unique_ptr<Engine>(x86::EngineFactory::Create(x86::EngineOptions()));
+    EXPECT_EQ(RC_SUCCESS, engine->Configure(x86::ENGINE_CONF_DISABLE_AVX_FMA3));
+    auto engine_ptr = engine.get();
+    unique_ptr<pmx::RuntimeBuilder> builder(pmx::RuntimeBuilderFactory::Create());
+    if (GetCpuISA() & (ISA_X86_AVX | ISA_X86_FMA)) {
+        EXPECT_NE(RC_SUCCESS, builder->Init(pmx_file_.c_str(), &engine_ptr, 1));
+    }
+}
+
+TEST_F(X86PmxRoundTripTest, matmul_packed_b) {
+    unique_ptr<Engine> onnx_engine(x86::EngineFactory::Create(x86::EngineOptions()));
+    auto expected = SaveMatMulModel(onnx_engine.get());
+    EXPECT_EQ(2 * 3 * 7 * 19, expected.size());
+
+    auto engine = unique_ptr<Engine>(x86::EngineFactory::Create(x86::EngineOptions()));
+    auto engine_ptr = engine.get();
+    unique_ptr<pmx::RuntimeBuilder> builder(pmx::RuntimeBuilderFactory::Create());
+    EXPECT_EQ(RC_SUCCESS, builder->Init(pmx_file_.c_str(), &engine_ptr, 1));
+    EXPECT_EQ(RC_SUCCESS, builder->Preprocess());
+
+    // B is not saved as a constant, so the packed panel must be restored for the results to match
+    unique_ptr<Runtime> runtime(builder->CreateRuntime());
+    ASSERT_TRUE(runtime != nullptr);
+    auto result = RunMatMul(runtime.get());
+    ASSERT_EQ(expected.size(), result.size());
+    for (uint32_t i = 0; i < expected.size(); ++i) {
+        EXPECT_NEAR(expected[i], result[i], 1e-5f) << "index " << i;
+    }
+
+    // packed_isa is kept when the loaded model is saved again
+    const string resaved_file = pmx_file_ + ".1";
+    EXPECT_EQ(RC_SUCCESS, builder->Serialize(resaved_file.c_str(), "pmx"));
+    auto reloaded_engine = unique_ptr<Engine>(x86::EngineFactory::Create(x86::EngineOptions()));
+    auto reloaded_engine_ptr = reloaded_engine.get();
+    unique_ptr<pmx::RuntimeBuilder> reloaded_builder(pmx::RuntimeBuilderFactory::Create());
+    EXPECT_EQ(RC_SUCCESS, reloaded_builder->Init(resaved_file.c_str(), &reloaded_engine_ptr, 1));
+    EXPECT_EQ(RC_SUCCESS, reloaded_builder->Preprocess());
+    unique_ptr<Runtime> reloaded_runtime(reloaded_builder->CreateRuntime());
+    ASSERT_TRUE(reloaded_runtime != nullptr);
+    auto reloaded_result = RunMatMul(reloaded_runtime.get());
+    ASSERT_EQ(expected.size(), reloaded_result.size());
+    for (uint32_t i = 0; i < expected.size(); ++i) {
+        EXPECT_NEAR(expected[i], reloaded_result[i], 1e-5f) << "index " << i;
+    }
+    remove(resaved_file.c_str());
+}
+
+TEST_F(X86PmxRoundTripTest, matmul_packed_b_reject_unsupported_isa) {
+    unique_ptr<Engine> onnx_engine(x86::EngineFactory::Create(x86::EngineOptions()));
+    SaveMatMulModel(onnx_engine.get());
+
+    // B packed for fma or avx512 cannot be used by an sse-only engine
+    auto engine = unique_ptr<Engine>(x86::EngineFactory::Create(x86::EngineOptions()));
+    EXPECT_EQ(RC_SUCCESS, engine->Configure(x86::ENGINE_CONF_DISABLE_AVX_FMA3));
+    auto engine_ptr = engine.get();
+    unique_ptr<pmx::RuntimeBuilder> builder(pmx::RuntimeBuilderFactory::Create());
+    if (GetCpuISA() & ISA_X86_FMA) {
+        EXPECT_NE(RC_SUCCESS, builder->Init(pmx_file_.c_str(), &engine_ptr, 1));
+    }
+}
+
+TEST_F(X86PmxRoundTripTest, matmul_param) {
+    x86::MatMulParam param;
+    param.N = 19;
+    param.K = 29;
+    param.packed_isa = ISA_X86_AVX | ISA_X86_FMA;
+    param.packed_b = RandomData(77, 9);
+
+    utils::BufferDataStream ds;
+    ASSERT_EQ(RC_SUCCESS, x86::SerializeMatMulParam(param, &ds));
+
+    x86::MatMulParam loaded;
+    x86::DataReader reader(ds.GetData(), ds.GetSize());
+    EXPECT_EQ(RC_SUCCESS, x86::DeserializeMatMulParam(&reader, param.packed_isa | ISA_X86_AVX512, &loaded));
+    EXPECT_EQ(param.N, loaded.N);
+    EXPECT_EQ(param.K, loaded.K);
+    EXPECT_EQ(param.packed_isa, loaded.packed_isa);
+    EXPECT_EQ(param.packed_b, loaded.packed_b);
+    EXPECT_EQ(0, reader.GetRemainingBytes());
+
+    // the panel packed for fma has a different layout from the one of sse
+    x86::DataReader sse_reader(ds.GetData(), ds.GetSize());
+    EXPECT_EQ(RC_UNSUPPORTED, x86::DeserializeMatMulParam(&sse_reader, ISA_X86_SSE, &loaded));
+
+    x86::DataReader truncated_reader(ds.GetData(), ds.GetSize() - 1);
+    EXPECT_NE(RC_SUCCESS, x86::DeserializeMatMulParam(&truncated_reader, param.packed_isa, &loaded));
+}
+
+TEST_F(X86PmxRoundTripTest, engine_data) {
+    const uint32_t version = 2;
+    const isa_t isa = ~(isa_t)0;
+    char buf[sizeof(version) + sizeof(isa)];
+    memcpy(buf, &version, sizeof(version));
+    memcpy(buf + sizeof(version), &isa, sizeof(isa));
+
+    x86::X86Engine engine;
+    EXPECT_EQ(RC_SUCCESS, engine.Init(x86::EngineOptions()));
+    EXPECT_EQ(RC_UNSUPPORTED, engine.DeserializeData(buf, sizeof(buf)));
+    EXPECT_NE(RC_SUCCESS, engine.DeserializeData(buf, sizeof(version)));
+
+    // op data of version 1 has different layouts
+    const uint32_t bad_versions[] = {1, 3};
+    for (uint32_t i = 0; i < 2; ++i) {
+        memcpy(buf, &bad_versions[i], sizeof(bad_versions[i]));
+        EXPECT_EQ(RC_UNSUPPORTED, engine.DeserializeData(buf, sizeof(buf))) << "version " << bad_versions[i];
+    }
+}
+
+#endif
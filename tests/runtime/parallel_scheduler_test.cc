@@ -0,0 +1,400 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/nn/runtime/partial_runtime_creator.h"
+#include "ppl/nn/runtime/runtime_aux_info.h"
+#include "ppl/nn/utils/generic_cpu_device.h"
+#include "tests/runtime/create_runtime_graph_info.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <mutex>
+#include <string>
+using namespace std;
+using namespace ppl::nn;
+using namespace ppl::common;
+using namespace ppl::nn::test;
+
+class ParallelSchedulerTest : public testing::Test {
+protected:
+    void SetUp() override {
+        graph_info_ = CreateRuntimeGraphInfoForTest(&builder_, &engines_);
+        auto status = init_info_.Init(builder_.GetGraph()->topo.get());
+        EXPECT_EQ(RC_SUCCESS, status);
+    }
+
+protected:
+    shared_ptr<RuntimeGraphInfo> graph_info_;
+    vector<unique_ptr<EngineImpl>> engines_;
+    RuntimeInitInfo init_info_;
+    GraphBuilder builder_;
+};
+
+TEST_F(ParallelSchedulerTest, edge_refcount) {
+    auto topo = builder_.GetGraph()->topo.get();
+
+    RuntimeAuxInfo aux_info;
+    auto status = aux_info.Init(topo, {});
+    EXPECT_EQ(RC_SUCCESS, status);
+    EXPECT_EQ(topo->GetCurrentEdgeIdBound(), aux_info.edge_refcount.size());
+
+    for (uint32_t i = 0; i < topo->GetOutputCount(); ++i) {
+        auto eid = topo->GetOutput(i);
+        auto edge = topo->GetEdge(eid);
+        // outputs are never freed
+        EXPECT_LT(edge->CalcConsumerCount() + 1, aux_info.edge_refcount[eid]);
+    }
+}
+
+TEST_F(ParallelSchedulerTest, run) {
+    auto topo = builder_.GetGraph()->topo.get();
+
+    PartialRuntimeCreator creator;
+    creator.Init(topo, graph_info_, &init_info_.name2nodeid);
+
+    const char* begin_ops[] = {"c", "d", "h"};
+    const char* end_ops[] = {"i"};
+
+    auto runtime = unique_ptr<RuntimeImpl>(creator.Create(begin_ops, 3, end_ops, 1, {}));
+    EXPECT_TRUE(runtime != nullptr);
+
+    auto status = runtime->Configure(RUNTIME_CONF_SET_PARALLEL_SCHEDULING, (uint32_t)4);
+    EXPECT_EQ(RC_SUCCESS, status);
+
+    for (uint32_t i = 0; i < 3; ++i) {
+        status = runtime->Run();
+        EXPECT_EQ(RC_SUCCESS, status);
+    }
+
+    // switches back to the sequential scheduler
+    status = runtime->Configure(RUNTIME_CONF_SET_PARALLEL_SCHEDULING, (uint32_t)0);
+    EXPECT_EQ(RC_SUCCESS, status);
+    status = runtime->Run();
+    EXPECT_EQ(RC_SUCCESS, status);
+}
+
+/* -------------------------------------------------------------------------- */
+
+namespace {
+
+// counts buffers alive on this device
+class CountingDevice final : public Device {
+public:
+    RetCode Realloc(uint64_t bytes, BufferDesc* buffer) override {
+        lock_guard<mutex> lck(mtx_);
+        if (buffer->addr) {
+            --live_buffers_;
+        }
+        auto status = device_.Realloc(bytes, buffer);
+        if (buffer->addr) {
+            ++live_buffers_;
+            peak_buffers_ = std::max(peak_buffers_, live_buffers_);
+        }
+        return status;
+    }
+    RetCode Realloc(const TensorShape& shape, BufferDesc* buffer) override {
+        return Realloc(shape.GetBytesIncludingPadding(), buffer);
+    }
+    void Free(BufferDesc* buffer) override {
+        lock_guard<mutex> lck(mtx_);
+        if (buffer->addr) {
+            --live_buffers_;
+        }
+        device_.Free(buffer);
+    }
+
+    RetCode CopyFromHost(BufferDesc* dst, const void* src, uint64_t bytes) const override {
+        return device_.CopyFromHost(dst, src, bytes);
+    }
+    RetCode CopyFromHost(BufferDesc* dst, const void* src, const TensorShape& shape) const override {
+        return device_.CopyFromHost(dst, src, shape);
+    }
+    RetCode CopyToHost(void* dst, const BufferDesc& src, uint64_t bytes) const override {
+        return device_.CopyToHost(dst, src, bytes);
+    }
+    RetCode CopyToHost(void* dst, const BufferDesc& src, const TensorShape& shape) const override {
+        return device_.CopyToHost(dst, src, shape);
+    }
+    RetCode Copy(BufferDesc* dst, const BufferDesc& src, uint64_t bytes) const override {
+        return device_.Copy(dst, src, bytes);
+    }
+    RetCode Copy(BufferDesc* dst, const BufferDesc& src, const TensorShape& shape) const override {
+        return device_.Copy(dst, src, shape);
+    }
+    const DataConverter* GetDataConverter() const override {
+        return device_.GetDataConverter();
+    }
+    const char* GetType() const override {
+        return "cpu";
+    }
+    RetCode Configure(uint32_t, ...) override {
+        return RC_UNSUPPORTED;
+    }
+
+    uint32_t GetLiveBuffers() const {
+        lock_guard<mutex> lck(mtx_);
+        return live_buffers_;
+    }
+    uint32_t GetPeakBuffers() const {
+        lock_guard<mutex> lck(mtx_);
+        return peak_buffers_;
+    }
+    void ResetPeakBuffers() {
+        lock_guard<mutex> lck(mtx_);
+        peak_buffers_ = live_buffers_;
+    }
+
+private:
+    utils::GenericCpuDevice device_;
+    mutable mutex mtx_;
+    uint32_t live_buffers_ = 0;
+    uint32_t peak_buffers_ = 0;
+};
+
+// output[i] = sum(inputs[i]) + (node id + 1), so that every node leaves its own mark on the result
+class AccKernel final : public KernelImpl {
+public:
+    AccKernel(const ir::Node* node) : KernelImpl(node) {}
+    RetCode Execute(KernelExecContext* ctx) override {
+        auto input0 = ctx->GetInput<TensorImpl>(0);
+        auto output = ctx->GetOutput<TensorImpl>(0);
+        const uint32_t len = input0->GetShape()->GetElementsIncludingPadding();
+
+        output->SetDevice(GetDevice());
+        *output->GetShape() = *input0->GetShape();
+        auto status = output->ReallocBuffer();
+        if (status != RC_SUCCESS) {
+            return status;
+        }
+
+        auto dst = output->GetBufferPtr<float>();
+        const float bias = GetNode()->GetId() + 1;
+        for (uint32_t i = 0; i < len; ++i) {
+            dst[i] = bias;
+        }
+        for (uint32_t j = 0; j < ctx->GetInputCount(); ++j) {
+            auto src = ctx->GetInput<TensorImpl>(j)->GetBufferPtr<float>();
+            for (uint32_t i = 0; i < len; ++i) {
+                dst[i] += src[i];
+            }
+        }
+        return RC_SUCCESS;
+    }
+};
+
+class AccOptKernel final : public OptKernel {
+public:
+    AccOptKernel(const ir::Node* node) : OptKernel(node) {}
+    KernelImpl* CreateKernelImpl() const override {
+        return new AccKernel(GetNode());
+    }
+#ifdef PPLNN_ENABLE_PMX_MODEL
+    RetCode SerializeData(const pmx::SerializationContext&, utils::DataStream*) const override {
+        return RC_UNSUPPORTED;
+    }
+    RetCode DeserializeData(const pmx::DeserializationContext&, const void*, uint64_t) override {
+        return RC_UNSUPPORTED;
+    }
+#endif
+};
+
+class AccEngineContext final : public EngineContext {
+public:
+    AccEngineContext(CountingDevice* device) : device_(device) {}
+    Device* GetDevice() override {
+        return device_;
+    }
+    const char* GetName() const override {
+        return "acc";
+    }
+    RetCode SetMaxConcurrentKernels(uint32_t) override {
+        return RC_SUCCESS;
+    }
+
+private:
+    CountingDevice* device_;
+};
+
+class AccEngine final : public EngineImpl {
+public:
+    AccEngine() : EngineImpl("AccEngine") {}
+    RetCode Configure(uint32_t, ...) override {
+        return RC_UNSUPPORTED;
+    }
+    EngineContext* CreateEngineContext() override {
+        return new AccEngineContext(&device_);
+    }
+    bool Supports(const ir::Node* node) const override {
+        return (node->GetType().name == "acc");
+    }
+    RetCode ProcessGraph(const utils::SharedResource&, ir::Graph* graph, RuntimePartitionInfo* info) override {
+        auto topo = graph->topo.get();
+        for (auto it = topo->CreateNodeIter(); it->IsValid(); it->Forward()) {
+            auto node = it->Get();
+            info->kernels.emplace(node->GetId(), unique_ptr<OptKernel>(new AccOptKernel(node)));
+        }
+        return RC_SUCCESS;
+    }
+    EngineImpl* Create() override {
+        return new AccEngine();
+    }
+#ifdef PPLNN_ENABLE_PMX_MODEL
+    RetCode LoadConstants(const ConstantVisitor&, map<edgeid_t, BufferInfo>*) override {
+        return RC_SUCCESS;
+    }
+    OptKernel* CreateOptKernel(const ir::Node* node) const override {
+        return new AccOptKernel(node);
+    }
+    RetCode SerializeData(const pmx::SerializationContext&, utils::DataStream*) const override {
+        return RC_UNSUPPORTED;
+    }
+    RetCode DeserializeData(const void*, uint64_t) override {
+        return RC_UNSUPPORTED;
+    }
+#endif
+
+    CountingDevice* GetCountingDevice() {
+        return &device_;
+    }
+
+private:
+    CountingDevice device_;
+};
+
+} // namespace
+
+class ParallelSchedulerAccTest : public testing::Test {
+protected:
+    RuntimeImpl* CreateRuntime() {
+        auto graph = builder_.GetGraph();
+
+        utils::SharedResource resource;
+        resource.engines.push_back(&engine_);
+        resource.graph_partitioner = make_shared<EngineGraphPartitioner>();
+
+        auto graph_info = make_shared<RuntimeGraphInfo>();
+        auto status = utils::ProcessGraph(resource, graph, graph_info.get());
+        EXPECT_EQ(RC_SUCCESS, status);
+
+        auto aux_info = make_shared<RuntimeAuxInfo>();
+        status = aux_info->Init(graph->topo.get(), {});
+        EXPECT_EQ(RC_SUCCESS, status);
+
+        RuntimeInitInfo init_info;
+        status = init_info.Init(graph->topo.get());
+        EXPECT_EQ(RC_SUCCESS, status);
+
+        auto runtime = new RuntimeImpl();
+        status = runtime->Init(graph->topo, graph_info, aux_info, init_info);
+        EXPECT_EQ(RC_SUCCESS, status);
+        return runtime;
+    }
+
+    static void SetData(Tensor* tensor, const vector<float>& data) {
+        auto shape = tensor->GetShape();
+        shape->Reshape({(int64_t)data.size()});
+        shape->SetDataType(DATATYPE_FLOAT32);
+        shape->SetDataFormat(DATAFORMAT_NDARRAY);
+        EXPECT_EQ(RC_SUCCESS, tensor->ReallocBuffer());
+        EXPECT_EQ(RC_SUCCESS, tensor->CopyFromHost(data.data()));
+    }
+
+    static vector<float> GetData(const Tensor* tensor) {
+        vector<float> data(tensor->GetShape()->GetElementsIncludingPadding());
+        EXPECT_EQ(RC_SUCCESS, tensor->CopyToHost(data.data()));
+        return data;
+    }
+
+    static vector<vector<float>> RunAndGetOutputs(RuntimeImpl* runtime, uint32_t thread_num) {
+        EXPECT_EQ(RC_SUCCESS, runtime->Configure(RUNTIME_CONF_SET_PARALLEL_SCHEDULING, thread_num));
+        for (uint32_t i = 0; i < runtime->GetInputCount(); ++i) {
+            SetData(runtime->GetInputTensor(i), {1.0f * i, 2.0f * i, 3.0f * i, 4.0f * i});
+        }
+        EXPECT_EQ(RC_SUCCESS, runtime->Run());
+
+        vector<vector<float>> outputs(runtime->GetOutputCount());
+        for (uint32_t i = 0; i < runtime->GetOutputCount(); ++i) {
+            outputs[i] = GetData(runtime->GetOutputTensor(i));
+        }
+        return outputs;
+    }
+
+protected:
+    AccEngine engine_;
+    GraphBuilder builder_;
+};
+
+TEST_F(ParallelSchedulerAccTest, same_outputs_as_sequential) {
+    // four independent branches of different depths joined by `j`, and an extra output from `b1`
+    const ir::Node::Type type("test", "acc", 1);
+    builder_.AddNode("a0", type, {"in0"}, {"a0_out"});
+    builder_.AddNode("a1", type, {"a0_out"}, {"a1_out"});
+    builder_.AddNode("a2", type, {"a1_out"}, {"a2_out"});
+    builder_.AddNode("b0", type, {"in1"}, {"b0_out"});
+    builder_.AddNode("b1", type, {"b0_out", "in0"}, {"b1_out"});
+    builder_.AddNode("b2", type, {"b1_out"}, {"b2_out"});
+    builder_.AddNode("b3", type, {"b1_out"}, {"b3_out"});
+    builder_.AddNode("c0", type, {"in0", "in1"}, {"c0_out"});
+    builder_.AddNode("c1", type, {"c0_out", "c0_out"}, {"c1_out"});
+    builder_.AddNode("d0", type, {"in1"}, {"d0_out"});
+    builder_.AddNode("j", type, {"a2_out", "b2_out", "c1_out", "d0_out"}, {"out"});
+    builder_.Finalize();
+
+    auto runtime = unique_ptr<RuntimeImpl>(CreateRuntime());
+    ASSERT_TRUE(runtime != nullptr);
+    EXPECT_EQ(2, runtime->GetOutputCount());
+
+    auto expected = RunAndGetOutputs(runtime.get(), 0);
+    for (uint32_t thread_num = 2; thread_num <= 4; ++thread_num) {
+        // runs several times to catch outputs depending on the execution order
+        for (uint32_t i = 0; i < 8; ++i) {
+            EXPECT_EQ(expected, RunAndGetOutputs(runtime.get(), thread_num));
+        }
+    }
+}
+
+TEST_F(ParallelSchedulerAccTest, release_intermediate_buffers) {
+    const ir::Node::Type type("test", "acc", 1);
+    const uint32_t chain_len = 16;
+    for (uint32_t i = 0; i < chain_len; ++i) {
+        const string input = (i == 0) ? string("in") : "e" + std::to_string(i - 1);
+        const string output = (i == chain_len - 1) ? string("out") : "e" + std::to_string(i);
+        builder_.AddNode("n" + std::to_string(i), type, {input}, {output});
+    }
+    builder_.Finalize();
+
+    auto runtime = unique_ptr<RuntimeImpl>(CreateRuntime());
+    ASSERT_TRUE(runtime != nullptr);
+
+    auto device = engine_.GetCountingDevice();
+    const uint32_t thread_nums[] = {0, 4};
+    for (uint32_t t = 0; t < 2; ++t) {
+        EXPECT_EQ(RC_SUCCESS, runtime->Configure(RUNTIME_CONF_SET_PARALLEL_SCHEDULING, thread_nums[t]));
+        SetData(runtime->GetInputTensor(0), {1, 2, 3, 4});
+        device->ResetPeakBuffers();
+
+        EXPECT_EQ(RC_SUCCESS, runtime->Run());
+
+        // only the input and the output are kept after Run()
+        EXPECT_EQ(2, device->GetLiveBuffers());
+        /*
+          an intermediate buffer is freed right after its only consumer finishes, so at most the input, the
+          output, and the input and output of the running kernel are alive at the same time.
+        */
+        EXPECT_GE(4, device->GetPeakBuffers());
+        EXPECT_EQ(vector<float>({137, 138, 139, 140}), GetData(runtime->GetOutputTensor(0)));
+    }
+}
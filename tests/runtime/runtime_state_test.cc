@@ -0,0 +1,110 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "ppl/nn/runtime/partial_runtime_creator.h"
+#include "tests/runtime/create_runtime_graph_info.h"
+#include "gtest/gtest.h"
+#include <vector>
+using namespace std;
+using namespace ppl::nn;
+using namespace ppl::common;
+using namespace ppl::nn::test;
+
+class RuntimeStateTest : public testing::Test {
+protected:
+    void SetUp() override {
+        graph_info_ = CreateRuntimeGraphInfoForTest(&builder_, &engines_);
+        auto topo = builder_.GetGraph()->topo.get();
+        auto status = init_info_.Init(topo);
+        EXPECT_EQ(RC_SUCCESS, status);
+
+        creator_.Init(topo, graph_info_, &init_info_.name2nodeid);
+    }
+
+    RuntimeImpl* CreateRuntime() {
+        const char* begin_ops[] = {"c", "d", "h"};
+        const char* end_ops[] = {"i"};
+        return creator_.Create(begin_ops, 3, end_ops, 1, {});
+    }
+
+    static void SetData(Tensor* tensor, const vector<float>& data) {
+        auto shape = tensor->GetShape();
+        shape->Reshape({(int64_t)data.size()});
+        shape->SetDataType(DATATYPE_FLOAT32);
+        shape->SetDataFormat(DATAFORMAT_NDARRAY);
+        EXPECT_EQ(RC_SUCCESS, tensor->ReallocBuffer());
+        EXPECT_EQ(RC_SUCCESS, tensor->CopyFromHost(data.data()));
+    }
+
+    static vector<float> GetData(const Tensor* tensor) {
+        vector<float> data(tensor->GetShape()->GetElementsIncludingPadding());
+        EXPECT_EQ(RC_SUCCESS, tensor->CopyToHost(data.data()));
+        return data;
+    }
+
+protected:
+    shared_ptr<RuntimeGraphInfo> graph_info_;
+    vector<unique_ptr<EngineImpl>> engines_;
+    RuntimeInitInfo init_info_;
+    GraphBuilder builder_;
+    PartialRuntimeCreator creator_;
+};
+
+TEST_F(RuntimeStateTest, bind) {
+    auto runtime = unique_ptr<RuntimeImpl>(CreateRuntime());
+    EXPECT_TRUE(runtime != nullptr);
+
+    EXPECT_EQ(RC_NOT_FOUND, runtime->Configure(RUNTIME_CONF_BIND_STATE, "out11", "in1"));
+    EXPECT_EQ(RC_NOT_FOUND, runtime->Configure(RUNTIME_CONF_BIND_STATE, "in2", "out11"));
+    EXPECT_EQ(RC_SUCCESS, runtime->Configure(RUNTIME_CONF_BIND_STATE, "out11", "in2"));
+    EXPECT_EQ(RC_EXISTS, runtime->Configure(RUNTIME_CONF_BIND_STATE, "out9", "in2"));
+    EXPECT_EQ(RC_NOT_FOUND, runtime->Configure(RUNTIME_CONF_RESET_STATE, "out1"));
+}
+
+TEST_F(RuntimeStateTest, swap_and_reset) {
+    auto runtime = unique_ptr<RuntimeImpl>(CreateRuntime());
+    EXPECT_TRUE(runtime != nullptr);
+    EXPECT_EQ(RC_SUCCESS, runtime->Configure(RUNTIME_CONF_BIND_STATE, "out11", "in2"));
+
+    auto state_in = runtime->GetTensorByName("in2");
+    auto state_out = runtime->GetTensorByName("out11");
+    EXPECT_TRUE(state_in != nullptr);
+    EXPECT_TRUE(state_out != nullptr);
+
+    // kernels of the test engine do nothing, so the output is filled manually as if it was computed
+    SetData(state_in, {1, 2, 3});
+    SetData(state_out, {4, 5, 6});
+    EXPECT_EQ(RC_SUCCESS, runtime->Run());
+    // outputs are still readable after Run()
+    EXPECT_EQ(vector<float>({1, 2, 3}), GetData(state_in));
+    EXPECT_EQ(vector<float>({4, 5, 6}), GetData(state_out));
+
+    auto out_buffer = state_out->GetBufferPtr();
+    EXPECT_EQ(RC_SUCCESS, runtime->Run());
+    EXPECT_EQ(out_buffer, state_in->GetBufferPtr()); // moved without copying
+    EXPECT_EQ(vector<float>({4, 5, 6}), GetData(state_in));
+
+    EXPECT_EQ(RC_SUCCESS, runtime->Configure(RUNTIME_CONF_RESET_STATE, "in2"));
+    EXPECT_EQ(vector<float>({0, 0, 0}), GetData(state_in));
+    EXPECT_EQ(RC_SUCCESS, runtime->Run());
+    EXPECT_EQ(vector<float>({0, 0, 0}), GetData(state_in));
+
+    EXPECT_EQ(RC_SUCCESS, runtime->Run());
+    EXPECT_EQ(RC_SUCCESS, runtime->Configure(RUNTIME_CONF_RESET_STATE, nullptr));
+    EXPECT_EQ(vector<float>({0, 0, 0}), GetData(state_in));
+}
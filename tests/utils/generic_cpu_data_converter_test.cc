@@ -0,0 +1,60 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "ppl/nn/utils/generic_cpu_data_converter.h"
+#include "gtest/gtest.h"
+#include <vector>
+using namespace std;
+using namespace ppl::nn;
+using namespace ppl::common;
+
+TEST(GenericCpuDataConverterTest, convert_from_host_image) {
+    const int64_t n = 2, c = 3, h = 2, w = 4;
+    vector<uint8_t> img(n * h * w * c);
+    for (uint32_t i = 0; i < img.size(); ++i) {
+        img[i] = i % 256;
+    }
+    const float mean[] = {1.0f, 2.0f, 3.0f};
+    const float scale[] = {0.5f, 0.25f, 2.0f};
+
+    TensorShape shape;
+    shape.SetDataType(DATATYPE_FLOAT32);
+    shape.SetDataFormat(DATAFORMAT_NDARRAY);
+    shape.Reshape({n, c, h, w});
+
+    vector<float> data(shape.GetElementsIncludingPadding());
+    BufferDesc buf(data.data());
+    utils::GenericCpuDataConverter converter;
+    EXPECT_EQ(RC_SUCCESS, converter.ConvertFromHostImage(&buf, shape, img.data(), mean, scale));
+
+    for (int64_t b = 0; b < n; ++b) {
+        for (int64_t ch = 0; ch < c; ++ch) {
+            for (int64_t x = 0; x < h * w; ++x) {
+                const float expected = ((float)img[(b * h * w + x) * c + ch] - mean[ch]) * scale[ch];
+                EXPECT_FLOAT_EQ(expected, data[(b * c + ch) * h * w + x]);
+            }
+        }
+    }
+
+    // nullptr means zero mean and unit scale
+    EXPECT_EQ(RC_SUCCESS, converter.ConvertFromHostImage(&buf, shape, img.data(), nullptr, nullptr));
+    EXPECT_FLOAT_EQ((float)img[c + 1], data[1 * h * w + 1]);
+
+    shape.SetDataType(DATATYPE_INT64);
+    EXPECT_EQ(RC_UNSUPPORTED, converter.ConvertFromHostImage(&buf, shape, img.data(), mean, scale));
+}
@@ -0,0 +1,93 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ppl/nn/utils/planned_buffer_manager.h"
+#include "ppl/nn/utils/stack_buffer_manager.h"
+#include "ppl/common/generic_cpu_allocator.h"
+#include "gtest/gtest.h"
+using namespace ppl::nn;
+using namespace ppl::common;
+
+class PlannedBufferManagerTest : public testing::Test {
+protected:
+    PlannedBufferManagerTest() : ar_(alignment_), mgr_(new utils::StackBufferManager(&ar_), alignment_) {}
+
+    // a: [0, 2), b: [1, 3), c: [2, 4), output: [3, ...)
+    void RunOnce() {
+        BufferDesc a, b, c;
+        EXPECT_EQ(RC_SUCCESS, mgr_.BeginRun());
+        EXPECT_EQ(RC_SUCCESS, mgr_.Realloc(1000, &a));
+        EXPECT_EQ(RC_SUCCESS, mgr_.Realloc(2000, &b));
+        mgr_.Free(&a);
+        EXPECT_EQ(RC_SUCCESS, mgr_.Realloc(1000, &c));
+        mgr_.Free(&b);
+        EXPECT_EQ(RC_SUCCESS, mgr_.Realloc(500, &output_));
+        mgr_.Free(&c);
+    }
+
+protected:
+    static const uint64_t alignment_ = 64;
+    GenericCpuAllocator ar_;
+    utils::PlannedBufferManager mgr_;
+    BufferDesc output_;
+};
+
+TEST_F(PlannedBufferManagerTest, replay) {
+    RunOnce();
+    EXPECT_FALSE(mgr_.IsPlanned());
+    EXPECT_EQ(0, mgr_.GetPlannedBytes());
+
+    RunOnce();
+    EXPECT_TRUE(mgr_.IsPlanned());
+    // `a` and `c` share the same region
+    EXPECT_EQ(3072, mgr_.GetPlannedBytes());
+    EXPECT_EQ(3072, mgr_.GetMaxLiveBytes());
+
+    RunOnce();
+    EXPECT_TRUE(mgr_.IsPlanned());
+    mgr_.Free(&output_);
+}
+
+TEST_F(PlannedBufferManagerTest, diverge) {
+    RunOnce();
+    RunOnce();
+    EXPECT_TRUE(mgr_.IsPlanned());
+
+    BufferDesc a;
+    EXPECT_EQ(RC_SUCCESS, mgr_.BeginRun());
+    EXPECT_EQ(RC_SUCCESS, mgr_.Realloc(4000, &a));
+    EXPECT_FALSE(mgr_.IsPlanned());
+    EXPECT_NE(nullptr, a.addr);
+    mgr_.Free(&a);
+    mgr_.Free(&output_);
+}
+
+TEST_F(PlannedBufferManagerTest, restart_recording) {
+    RunOnce();
+    mgr_.RestartRecording();
+    mgr_.Free(&output_);
+
+    // the next run is recorded again instead of being replayed
+    RunOnce();
+    EXPECT_FALSE(mgr_.IsPlanned());
+    EXPECT_EQ(0, mgr_.GetPlannedBytes());
+
+    RunOnce();
+    EXPECT_TRUE(mgr_.IsPlanned());
+    EXPECT_EQ(3072, mgr_.GetPlannedBytes());
+    mgr_.Free(&output_);
+}
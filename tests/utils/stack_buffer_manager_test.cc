@@ -36,3 +36,26 @@ TEST(StackBufferManagerTest, all_and_free) {
 
     EXPECT_LE(bytes_needed, mgr.GetAllocatedBytes());
 }
+
+TEST(StackBufferManagerTest, defragment) {
+    const uint64_t alignment = 128;
+
+    GenericCpuAllocator ar(alignment);
+    utils::StackBufferManager mgr(&ar);
+
+    BufferDesc in_use, unused;
+    EXPECT_EQ(RC_SUCCESS, mgr.Realloc(1000, &in_use));
+    EXPECT_EQ(RC_SUCCESS, mgr.Realloc(2000, &unused));
+    mgr.Free(&unused);
+    EXPECT_EQ(3000, mgr.GetAllocatedBytes());
+
+    mgr.Defragment();
+    EXPECT_EQ(1000, mgr.GetAllocatedBytes());
+
+    // released buffers can be reused
+    EXPECT_EQ(RC_SUCCESS, mgr.Realloc(500, &unused));
+    EXPECT_NE(nullptr, unused.addr);
+    EXPECT_EQ(1500, mgr.GetAllocatedBytes());
+    mgr.Free(&unused);
+    mgr.Free(&in_use);
+}
@@ -0,0 +1,63 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "ppl/nn/utils/trace_recorder.h"
+#include "gtest/gtest.h"
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+using namespace std;
+using namespace ppl::nn;
+using namespace ppl::common;
+
+static string ReadFile(const char* fname) {
+    ifstream ifs(fname);
+    stringstream ss;
+    ss << ifs.rdbuf();
+    return ss.str();
+}
+
+TEST(TraceRecorderTest, ring_buffer) {
+    auto recorder = utils::TraceRecorder::GetInstance();
+    recorder->Start(2);
+    EXPECT_TRUE(recorder->IsEnabled());
+
+    auto ts = utils::TraceRecorder::Now();
+    recorder->AddCompleteEvent("kernel", "conv_0", ts, ts + 10, "Conv");
+    recorder->AddInstantEvent("memory", "Realloc", 1024);
+    recorder->AddCounterEvent("memory", "allocated \"bytes\"", 4096);
+    EXPECT_EQ(1, recorder->GetDroppedEventCount());
+
+    recorder->Stop();
+    EXPECT_FALSE(recorder->IsEnabled());
+    // ignored after Stop()
+    recorder->AddInstantEvent("memory", "Free");
+    EXPECT_EQ(1, recorder->GetDroppedEventCount());
+
+    const char* fname = "trace_recorder_test.json";
+    EXPECT_EQ(RC_SUCCESS, recorder->SaveAsChromeTrace(fname));
+    auto content = ReadFile(fname);
+    remove(fname);
+
+    EXPECT_EQ(string::npos, content.find("conv_0"));
+    EXPECT_NE(string::npos, content.find("\"name\":\"Realloc\""));
+    EXPECT_NE(string::npos, content.find("\"bytes\":1024"));
+    EXPECT_NE(string::npos, content.find("\"name\":\"allocated \\\"bytes\\\"\""));
+    EXPECT_NE(string::npos, content.find("\"ph\":\"C\""));
+    EXPECT_EQ(string::npos, content.find("\"name\":\"Free\""));
+}
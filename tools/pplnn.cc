@@ -60,7 +60,8 @@ Define_string_opt("--save-pmx-model", g_flag_save_pmx_model, "", "dump model to
 #endif
 
 Define_string_opt("--mm-policy", g_flag_mm_policy, "mem",
-                  "\"perf\" => better performance, or \"mem\" => less memory usage");
+                  "\"perf\" => better performance, or \"mem\" => less memory usage, or \"static\" => "
+                  "plan memory after the first run for fixed input shapes(x86 only)");
 
 Define_bool_opt("--enable-profiling", g_flag_enable_profiling, false, "enable profiling and print profiling info");
 Define_float_opt("--min-profiling-seconds", g_flag_min_profiling_seconds, 1.0f,
@@ -85,6 +86,14 @@ Define_bool_opt("--save-outputs", g_flag_save_outputs, false, "save separated ou
 Define_string_opt("--save-data-dir", g_flag_save_data_dir, ".",
                   "directory to save input/output data if '--save-*' options are enabled.");
 Define_bool_opt("--perf-with-io", g_flag_perf_with_io, false, "profiling with io copy");
+Define_uint32_opt("--parallel-scheduling-threads", g_flag_parallel_scheduling_threads, 0,
+                  "run independent kernels concurrently with <n> threads. 0 or 1 means sequential execution");
+Define_string_opt("--save-trace", g_flag_save_trace, "",
+                  "save timeline of profiling to <filename> in chrome trace format(with --enable-profiling)");
+Define_uint32_opt("--trace-max-events", g_flag_trace_max_events, 262144,
+                  "max number of latest events kept by --save-trace");
+Define_bool_opt("--enable-reshape-cache", g_flag_enable_reshape_cache, false,
+                "skip shape inference of kernels whose inputs are not changed since the last run");
 
 /* -------------------------------------------------------------------------- */
 
@@ -180,6 +189,26 @@ static bool ParseInputShapes(const string& shape_str, vector<vector<int64_t>>* i
 
 /* -------------------------------------------------------------------------- */
 
+#if defined(PPLNN_USE_CUDA) || defined(PPLNN_USE_X86)
+static RetCode ReadFileContent(const char* fname, string* buf) {
+    ifstream ifile;
+
+    ifile.open(fname, ios_base::in);
+    if (!ifile.is_open()) {
+        LOG(ERROR) << "open file[" << fname << "] failed.";
+        return RC_NOT_FOUND;
+    }
+
+    stringstream ss;
+    ss << ifile.rdbuf();
+    *buf = ss.str();
+
+    ifile.close();
+    return RC_SUCCESS;
+}
+
+#endif
+
 #ifdef PPLNN_USE_CUDA
 
 Define_bool_opt("--use-cuda", g_flag_use_cuda, false, "use cuda engine");
@@ -201,23 +230,6 @@ Define_string_opt("--quant-file", g_flag_quant_file, "", "a json file containing
 #include "ppl/nn/engines/cuda/ops.h"
 #include "ppl/nn/utils/array.h"
 
-static RetCode ReadFileContent(const char* fname, string* buf) {
-    ifstream ifile;
-
-    ifile.open(fname, ios_base::in);
-    if (!ifile.is_open()) {
-        LOG(ERROR) << "open file[" << fname << "] failed.";
-        return RC_NOT_FOUND;
-    }
-
-    stringstream ss;
-    ss << ifile.rdbuf();
-    *buf = ss.str();
-
-    ifile.close();
-    return RC_SUCCESS;
-}
-
 static inline bool RegisterCudaEngine(vector<unique_ptr<Engine>>* engines) {
     cuda::EngineOptions options;
     options.device_id = g_flag_device_id;
@@ -315,6 +327,15 @@ Define_bool_opt("--use-x86", g_flag_use_x86, false, "use x86 engine");
 Define_bool_opt("--disable-avx512", g_flag_disable_avx512, false, "disable avx512 feature");
 Define_bool_opt("--disable-avx-fma3", g_flag_disable_avx_fma3, false, "disable avx, fma3 and avx512 feature");
 Define_bool_opt("--core-binding", g_flag_core_binding, false, "core binding");
+Define_bool_opt("--x86-tuning", g_flag_x86_tuning, false,
+                "select conv algorithms by timing. input shapes should be fixed");
+Define_string_opt("--x86-export-algo-file", g_flag_x86_export_algo_file, "",
+                  "export algorithms selected by timing to the file");
+Define_string_opt("--x86-import-algo-file", g_flag_x86_import_algo_file, "",
+                  "import algorithms from a file generated by `--x86-export-algo-file`");
+Define_string_opt("--x86-quant-file", g_flag_x86_quant_file, "",
+                  "a json file containing quantization information. convs and fcs run in int8 if possible");
+Define_bool_opt("--x86-bf16", g_flag_x86_bf16, false, "run convs and fcs in bfloat16 if avx512 is available");
 
 #include "ppl/nn/engines/x86/engine_factory.h"
 #include "ppl/nn/engines/x86/options.h"
@@ -327,6 +348,14 @@ static inline bool RegisterX86Engine(vector<unique_ptr<Engine>>* engines) {
         options.mm_policy = x86::MM_MRU;
     } else if (g_flag_mm_policy == "mem") {
         options.mm_policy = x86::MM_COMPACT;
+    } else if (g_flag_mm_policy == "static") {
+        options.mm_policy = x86::MM_STATIC_PLAN;
+    }
+    if (g_flag_x86_tuning) {
+        options.dynamic_tuning_level = x86::TUNING_SELECT_ALGO;
+    }
+    if (g_flag_x86_bf16) {
+        options.forward_precision = DATATYPE_BFLOAT16;
     }
 
     x86::RegisterBuiltinOpImpls();
@@ -341,6 +370,33 @@ static inline bool RegisterX86Engine(vector<unique_ptr<Engine>>* engines) {
     if (g_flag_core_binding) {
         ppl::kernel::x86::set_omp_core_binding(nullptr, 0, 1);
     }
+    if (!g_flag_x86_import_algo_file.empty()) {
+        auto status = x86_engine->Configure(x86::ENGINE_CONF_IMPORT_ALGORITHMS, g_flag_x86_import_algo_file.c_str());
+        if (status != RC_SUCCESS) {
+            LOG(ERROR) << "import algorithms from [" << g_flag_x86_import_algo_file
+                       << "] failed: " << GetRetCodeStr(status);
+            delete x86_engine;
+            return false;
+        }
+    }
+    if (!g_flag_x86_export_algo_file.empty()) {
+        x86_engine->Configure(x86::ENGINE_CONF_EXPORT_ALGORITHMS, g_flag_x86_export_algo_file.c_str());
+    }
+    if (!g_flag_x86_quant_file.empty()) {
+        string file_content;
+        auto status = ReadFileContent(g_flag_x86_quant_file.c_str(), &file_content);
+        if (status != RC_SUCCESS) {
+            LOG(ERROR) << "read file[" << g_flag_x86_quant_file << "] failed: " << GetRetCodeStr(status);
+            delete x86_engine;
+            return false;
+        }
+        status = x86_engine->Configure(x86::ENGINE_CONF_SET_QUANT_INFO, file_content.c_str());
+        if (status != RC_SUCCESS) {
+            LOG(ERROR) << "set quantization info failed: " << GetRetCodeStr(status);
+            delete x86_engine;
+            return false;
+        }
+    }
     // configure engine
     engines->emplace_back(unique_ptr<Engine>(x86_engine));
     LOG(INFO) << "***** register X86Engine *****";
@@ -907,8 +963,11 @@ static void PrintProfilingStatistics(const ProfilingStatistics& stat, double run
     std::map<std::string, int> type_count;
     char float_buf_0[128];
     char float_buf_1[128];
+    uint64_t tot_exec_count = 0, tot_reshape_cache_hit_count = 0;
     LOG(INFO) << "----- OP statistics by Node -----";
     for (auto x = stat.prof_info.begin(); x != stat.prof_info.end(); ++x) {
+        tot_exec_count += x->exec_count;
+        tot_reshape_cache_hit_count += x->reshape_cache_hit_count;
         auto ext_type = (x->domain == "" ? "" : x->domain + ".") + x->type;
         double time = (double)x->exec_microseconds / 1000;
         double avg_time = time / x->exec_count;
@@ -926,7 +985,8 @@ static void PrintProfilingStatistics(const ProfilingStatistics& stat, double run
         temp.insert(temp.length(), temp.length() > 50 ? 0 : 50 - temp.length(), ' ');
         LOG(INFO) << "NAME: [" << temp << "], "
                   << "AVG_TIME: [" << float_buf_0 << "], "
-                  << "EXEC_COUNT: [" << x->exec_count << "]";
+                  << "EXEC_COUNT: [" << x->exec_count << "], "
+                  << "RESHAPE_CACHE_HITS: [" << x->reshape_cache_hit_count << "]";
     }
     LOG(INFO) << "----- OP statistics by OpType -----";
     double tot_kernel_time = 0;
@@ -954,6 +1014,10 @@ static void PrintProfilingStatistics(const ProfilingStatistics& stat, double run
     LOG(INFO) << "TOT_RUN_TIME: [" << float_buf_1 << "]";
     sprintf(float_buf_0, "%8.4f%%", (run_dur - tot_kernel_time) / run_dur * 100);
     LOG(INFO) << "SCHED_LOST: [" << float_buf_0 << "]";
+    if (g_flag_enable_reshape_cache && tot_exec_count > 0) {
+        sprintf(float_buf_0, "%8.4f%%", (double)tot_reshape_cache_hit_count / tot_exec_count * 100);
+        LOG(INFO) << "RESHAPE_CACHE_HIT_RATE: [" << float_buf_0 << "]";
+    }
 }
 #endif
 
@@ -1019,6 +1083,12 @@ static bool Profiling(const vector<string>& input_data, Runtime* runtime) {
     if (status != RC_SUCCESS) {
         LOG(WARNING) << "enable profiling failed: " << GetRetCodeStr(status);
     }
+    if (!g_flag_save_trace.empty()) {
+        status = runtime->Configure(RUNTIME_CONF_SET_TRACING, g_flag_trace_max_events);
+        if (status != RC_SUCCESS) {
+            LOG(WARNING) << "enable tracing failed: " << GetRetCodeStr(status);
+        }
+    }
 #endif
     LOG(INFO) << "Profiling start";
 
@@ -1046,6 +1116,14 @@ static bool Profiling(const vector<string>& input_data, Runtime* runtime) {
         LOG(WARNING) << "Get profiling statistics failed: " << GetRetCodeStr(status);
     }
     PrintProfilingStatistics(stat, run_dur, run_count);
+
+    if (!g_flag_save_trace.empty()) {
+        runtime->Configure(RUNTIME_CONF_SET_TRACING, 0u);
+        status = runtime->Configure(RUNTIME_CONF_SAVE_TRACE, g_flag_save_trace.c_str());
+        if (status != RC_SUCCESS) {
+            LOG(WARNING) << "save trace to [" << g_flag_save_trace << "] failed: " << GetRetCodeStr(status);
+        }
+    }
 #else
     LOG(INFO) << "Average run costs: " << (run_dur / run_count) << " ms.";
 #endif
@@ -1183,6 +1261,22 @@ int main(int argc, char* argv[]) {
         return -1;
     }
 
+    if (g_flag_parallel_scheduling_threads > 1) {
+        auto status = runtime->Configure(RUNTIME_CONF_SET_PARALLEL_SCHEDULING, g_flag_parallel_scheduling_threads);
+        if (status != RC_SUCCESS) {
+            LOG(ERROR) << "enable parallel scheduling failed: " << GetRetCodeStr(status);
+            return -1;
+        }
+    }
+
+    if (g_flag_enable_reshape_cache) {
+        auto status = runtime->Configure(RUNTIME_CONF_SET_RESHAPE_CACHE, true);
+        if (status != RC_SUCCESS) {
+            LOG(ERROR) << "enable reshape cache failed: " << GetRetCodeStr(status);
+            return -1;
+        }
+    }
+
     vector<vector<int64_t>> input_shapes;
     if (!g_flag_input_shapes.empty()) {
         if (!ParseInputShapes(g_flag_input_shapes, &input_shapes)) {
@@ -1263,6 +1357,31 @@ int main(int argc, char* argv[]) {
 
     LOG(INFO) << "Run ok";
 
+#ifdef PPLNN_USE_X86
+    if (g_flag_use_x86 && g_flag_mm_policy == "static") {
+        // the plan is built in the second run
+        status = runtime->Run();
+        if (status != RC_SUCCESS) {
+            LOG(ERROR) << "Run() failed: " << GetRetCodeStr(status);
+            return -1;
+        }
+        for (uint32_t i = 0; i < runtime->GetDeviceContextCount(); ++i) {
+            auto dev = runtime->GetDeviceContext(i);
+            if (string(dev->GetType()) != "x86") {
+                continue;
+            }
+            uint64_t planned_bytes = 0, allocated_bytes = 0;
+            float fragmentation_ratio = 0;
+            status = dev->Configure(x86::DEV_CONF_GET_MEM_PLAN_INFO, &planned_bytes, &fragmentation_ratio,
+                                    &allocated_bytes);
+            if (status == RC_SUCCESS) {
+                LOG(INFO) << "memory plan: planned bytes [" << planned_bytes << "], fragmentation ratio ["
+                          << fragmentation_ratio << "], allocated bytes [" << allocated_bytes << "]";
+            }
+        }
+    }
+#endif
+
     if (g_flag_enable_profiling) {
         if (!Profiling(input_data, runtime.get())) {
             LOG(ERROR) << "Profiling() failed.";
@@ -114,7 +114,8 @@ def ParseCommandLineArgs():
                         help = "dump model to <filename> in pmx format")
 
     parser.add_argument("--mm-policy", type = str, default = "perf", required = False,
-                        help = "\"perf\" => better performance, or \"mem\" => less memory usage")
+                        help = "\"perf\" => better performance, or \"mem\" => less memory usage, "
+                        "or \"static\" => plan memory after the first run for fixed input shapes(x86 only)")
 
     parser.add_argument("--in-shapes", type = str, dest = "in_shapes",
                         default = "", required = False, help = "shapes of input tensors."
@@ -160,6 +161,8 @@ def CreateX86Engine(args):
         x86_options.mm_policy = pplnn.x86.MM_MRU
     elif args.mm_policy == "mem":
         x86_options.mm_policy = pplnn.x86.MM_COMPACT
+    elif args.mm_policy == "static":
+        x86_options.mm_policy = pplnn.x86.MM_STATIC_PLAN
 
     x86_engine = pplnn.x86.EngineFactory.Create(x86_options)
     if not x86_engine: